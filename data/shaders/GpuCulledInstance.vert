@@ -0,0 +1,36 @@
+#version 430
+
+// Vertex shader for geometry drawn by GpuCuller.  Per instance model matrices
+// are fetched from the instance buffer using the index stored in the visible
+// instance list.
+
+layout (location = 0) in vec3 vertexPosition;
+layout (location = 1) in vec3 vertexNormal;
+layout (location = 2) in uint instanceIndex;
+
+struct Instance {
+    mat4 modelMatrix;
+    vec3 boundsMin;
+    uint batchIndex;
+    vec3 boundsMax;
+    float padding;
+};
+
+layout (std430, binding = 0) readonly buffer Instances { Instance instances[]; };
+
+out vec3 position;
+out vec3 normal;
+
+uniform mat4 ViewMatrix;
+uniform mat4 ProjectionMatrix;
+
+void main()
+{
+    mat4 modelView = ViewMatrix * instances[instanceIndex].modelMatrix;
+
+    // Transform vertex position and normal to eye coordinate space.
+    normal = normalize(transpose(inverse(mat3(modelView))) * vertexNormal);
+    position = vec3(modelView * vec4(vertexPosition, 1.0));
+
+    gl_Position = ProjectionMatrix * vec4(position, 1.0);
+}
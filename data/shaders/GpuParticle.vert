@@ -0,0 +1,25 @@
+#version 430
+
+// One point per particle, read from the buffer written by GpuParticleEmitter and
+// expanded to a quad by GpuParticle.geom.
+
+struct Particle {
+    vec4 positionLife;
+    vec3 velocity;
+    uint color;
+};
+
+layout (std430, binding = 0) readonly buffer Particles { Particle particles[]; };
+
+out vec4 vertexColor;
+
+uniform mat4 ModelViewMatrix;
+
+void main()
+{
+    Particle particle = particles[gl_VertexID];
+    vertexColor = unpackUnorm4x8(particle.color);
+
+    // Eye space, projected once expanded.
+    gl_Position = ModelViewMatrix * vec4(particle.positionLife.xyz, 1.0);
+}
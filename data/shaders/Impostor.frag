@@ -0,0 +1,62 @@
+#version 400
+
+in vec3 eyePosition;
+in vec2 frameUv[4];
+flat in vec2 frameCell[4];
+flat in vec4 frameWeights;
+flat in vec4 orientation;
+flat in float radius;
+
+layout (location = 0) out vec4 fragColor;
+
+uniform mat4 ViewMatrix;
+uniform mat4 ProjectionMatrix;
+uniform int framesPerSide;
+uniform float frameResolution;
+uniform sampler2D colorAtlas;
+uniform sampler2D normalDepthAtlas;
+
+uniform vec3 ambientIntensity; // Environmental ambient light intensity for each RGB component.
+uniform vec3 lightDirection;   // Eye space direction towards the light.
+
+vec3 quatRotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main() {
+    float n = float(framesPerSide);
+    float halfTexel = 0.5 / frameResolution;
+
+    // Atlas values are premultiplied by coverage, so blend then un-premultiply.
+    vec4 color = vec4(0.0);
+    vec4 normalDepth = vec4(0.0);
+    for (int k = 0; k < 4; ++k) {
+        vec2 uv = frameUv[k];
+        if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0)))) {
+            continue;
+        }
+        // Keep filtering inside the frame to avoid bleeding from neighbours.
+        vec2 atlasUv = (frameCell[k] + clamp(uv, halfTexel, 1.0 - halfTexel)) / n;
+        color += frameWeights[k] * texture(colorAtlas, atlasUv);
+        normalDepth += frameWeights[k] * texture(normalDepthAtlas, atlasUv);
+    }
+
+    if (color.a < 0.5) {
+        discard;
+    }
+
+    vec3 albedo = color.rgb / color.a;
+    vec3 objectNormal = normalDepth.xyz / color.a * 2.0 - 1.0;
+    float depth = normalDepth.w / color.a;
+
+    vec3 normal = normalize(mat3(ViewMatrix) * quatRotate(orientation, objectNormal));
+    float n_dot_l = max(dot(normal, normalize(lightDirection)), 0.0);
+    fragColor = vec4(albedo * (ambientIntensity + n_dot_l), 1.0);
+
+    // Offset the quad towards or away from the viewer by the baked depth, which
+    // spans the bounding sphere diameter.
+    vec3 toCamera = normalize(-eyePosition);
+    vec3 surface = eyePosition + toCamera * radius * (1.0 - 2.0 * depth);
+    vec4 clip = ProjectionMatrix * vec4(surface, 1.0);
+    gl_FragDepth = (clip.z / clip.w) * 0.5 + 0.5;
+}
@@ -0,0 +1,90 @@
+#version 400
+
+// Per instance attributes.
+layout (location = 0) in vec4 instancePositionScale; // xyz = world position, w = scale.
+layout (location = 1) in vec4 instanceOrientation;   // Unit quaternion (x, y, z, w).
+
+out vec3 eyePosition;         // Eye space position on the quad.
+out vec2 frameUv[4];          // Quad position mapped into each blended frame.
+flat out vec2 frameCell[4];   // Atlas cell of each blended frame.
+flat out vec4 frameWeights;
+flat out vec4 orientation;
+flat out float radius;
+
+uniform mat4 ViewMatrix;
+uniform mat4 ProjectionMatrix;
+uniform int framesPerSide;
+uniform vec3 boundsCenter;    // Object space bounding sphere.
+uniform float boundsRadius;
+
+vec3 quatRotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+vec2 octahedralEncode(vec3 d) {
+    vec2 p = d.xy / (abs(d.x) + abs(d.y) + abs(d.z));
+    if (d.z < 0.0) {
+        vec2 s = vec2(p.x >= 0.0 ? 1.0 : -1.0, p.y >= 0.0 ? 1.0 : -1.0);
+        p = (1.0 - abs(p.yx)) * s;
+    }
+    return p * 0.5 + 0.5;
+}
+
+vec3 octahedralDecode(vec2 uv) {
+    vec2 p = uv * 2.0 - 1.0;
+    vec3 d = vec3(p, 1.0 - abs(p.x) - abs(p.y));
+    if (d.z < 0.0) {
+        vec2 s = vec2(p.x >= 0.0 ? 1.0 : -1.0, p.y >= 0.0 ? 1.0 : -1.0);
+        d.xy = (1.0 - abs(p.yx)) * s;
+    }
+    return normalize(d);
+}
+
+// Must match ImpostorAtlas::getFrameBasis().
+void frameBasis(vec3 direction, out vec3 right, out vec3 up) {
+    vec3 worldUp = abs(direction.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(0.0, 0.0, 1.0);
+    right = normalize(cross(worldUp, direction));
+    up = cross(direction, right);
+}
+
+void main()
+{
+    // Triangle strip corners (-1,-1), (1,-1), (-1,1), (1,1).
+    vec2 corner = vec2((gl_VertexID & 1) != 0 ? 1.0 : -1.0,
+                       (gl_VertexID & 2) != 0 ? 1.0 : -1.0);
+
+    float scale = instancePositionScale.w;
+    vec4 q = instanceOrientation;
+    vec4 qInverse = vec4(-q.xyz, q.w);
+
+    vec3 worldCenter = instancePositionScale.xyz + quatRotate(q, boundsCenter * scale);
+    vec3 eyeCenter = (ViewMatrix * vec4(worldCenter, 1.0)).xyz;
+    radius = boundsRadius * scale;
+
+    eyePosition = eyeCenter + vec3(corner * radius, 0.0);
+    gl_Position = ProjectionMatrix * vec4(eyePosition, 1.0);
+
+    // Object space view direction and quad corner.
+    mat3 inverseViewRotation = transpose(mat3(ViewMatrix));
+    vec3 toCamera = normalize(quatRotate(qInverse, inverseViewRotation * -eyeCenter));
+    vec3 cornerOffset = quatRotate(qInverse, inverseViewRotation * vec3(corner, 0.0));
+
+    // Bilinearly blend the four frames surrounding the view direction.
+    float n = float(framesPerSide);
+    vec2 grid = octahedralEncode(toCamera) * n - 0.5;
+    vec2 baseCell = floor(grid);
+    vec2 f = grid - baseCell;
+    frameWeights = vec4((1.0 - f.x) * (1.0 - f.y), f.x * (1.0 - f.y),
+                        (1.0 - f.x) * f.y, f.x * f.y);
+
+    for (int k = 0; k < 4; ++k) {
+        vec2 cell = clamp(baseCell + vec2(k & 1, k >> 1), vec2(0.0), vec2(n - 1.0));
+        vec3 right, up;
+        frameBasis(octahedralDecode((cell + 0.5) / n), right, up);
+
+        frameCell[k] = cell;
+        frameUv[k] = vec2(dot(cornerOffset, right), dot(cornerOffset, up)) * 0.5 + 0.5;
+    }
+
+    orientation = q;
+}
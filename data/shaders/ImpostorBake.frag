@@ -0,0 +1,15 @@
+#version 400
+
+in vec3 normal;
+
+layout (location = 0) out vec4 color;
+layout (location = 1) out vec4 normalDepth;
+
+uniform vec3 diffuseColor;
+
+void main() {
+    color = vec4(diffuseColor, 1.0);
+
+    // Orthographic depth is linear across the frame's bounding sphere.
+    normalDepth = vec4(normalize(normal) * 0.5 + 0.5, gl_FragCoord.z);
+}
@@ -0,0 +1,17 @@
+#version 400
+
+layout (location = 0) in vec3 vertexPosition;
+layout (location = 1) in vec3 vertexNormal;
+
+out vec3 normal;
+
+uniform mat4 ViewMatrix;
+uniform mat4 ProjectionMatrix;
+
+void main()
+{
+    // Normals stay in object space so impostors can be lit under any orientation.
+    normal = vertexNormal;
+
+    gl_Position = ProjectionMatrix * ViewMatrix * vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,76 @@
+// MaterialBatched.frag
+#version 430
+#extension GL_ARB_bindless_texture : enable
+
+// ADS shading with materials fetched from a MaterialLibrary.  Textures come from
+// bindless handles when the library uses them, otherwise from texture arrays.
+
+in vec3 position;
+in vec3 normal;
+in vec2 textureCoord;
+flat in uint material;
+
+layout (location = 0) out vec4 fragColor;
+
+uniform vec3 ambientIntensity; // Environmental ambient light intensity for each RGB component.
+
+struct LightProperties {
+    vec3 position;      // Light position in eye coordinate space.
+    vec3 rgbIntensity;  // Light intensity for each RGB component.
+};
+uniform LightProperties lightSource;
+
+struct Material {
+    vec4 emission;      // w holds the shininess factor.
+    vec4 ambient;       // w holds the specular coefficient Ks.
+    vec4 diffuse;
+    uint arraySlot;     // 0xFFFFFFFF if untextured.
+    uint layer;
+    uvec2 handle;       // Bindless texture handle, zero when texture arrays are used.
+};
+
+layout (std430, binding = 1) readonly buffer Materials { Material materials[]; };
+
+// Must match MaterialLibrary::MaxTextureArrays and FirstTextureUnit.
+layout (binding = 0) uniform sampler2DArray textureArrays[4];
+
+vec4 textureColor(in Material m) {
+#ifdef GL_ARB_bindless_texture
+    if (m.handle != uvec2(0)) {
+        return texture(sampler2D(m.handle), textureCoord);
+    }
+#endif
+    // Constant indices, since the slot is not guaranteed to be dynamically uniform.
+    vec3 coord = vec3(textureCoord, float(m.layer));
+    switch (m.arraySlot) {
+        case 0u: return texture(textureArrays[0], coord);
+        case 1u: return texture(textureArrays[1], coord);
+        case 2u: return texture(textureArrays[2], coord);
+        case 3u: return texture(textureArrays[3], coord);
+    }
+    return vec4(1.0);
+}
+
+void main() {
+    Material m = materials[material];
+    vec3 n = normalize(normal);
+
+    vec3 l = normalize(lightSource.position - position); // Direction from fragment to light source.
+    vec3 v = normalize(-position); // Direction from fragment to viewer.
+    vec3 h = normalize(v + l); // Halfway vector.
+
+    vec3 ambient = ambientIntensity * m.ambient.rgb;
+
+    float n_dot_l = max(dot(n, l), 0.0);
+    vec3 diffuse = m.diffuse.rgb * n_dot_l;
+
+    vec3 ambientDiffuse = lightSource.rgbIntensity * (ambient + diffuse);
+
+    vec3 specular = vec3(0.0);
+    if (n_dot_l > 0.0) {
+        float n_dot_h = max(dot(n, h), 0.0);
+        specular = vec3(m.ambient.w * pow(n_dot_h, m.emission.w));
+    }
+
+    fragColor = vec4(m.emission.rgb + ambientDiffuse, 1.0) * textureColor(m) + vec4(specular, 1.0);
+}
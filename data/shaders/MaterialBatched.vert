@@ -0,0 +1,38 @@
+// MaterialBatched.vert
+#version 430
+
+// Vertex shader for geometry drawn by MultiDrawBatch.  The draw index, selected
+// by each indirect command's baseInstance, locates the draw's model matrix and
+// material within the draw buffer.
+
+layout (location = 0) in vec3 v_Position;
+layout (location = 1) in vec3 v_Normal;
+layout (location = 2) in vec2 v_TextureCoord;
+layout (location = 3) in uint v_DrawId;
+
+struct Draw {
+    mat4 modelMatrix;
+    uint material;
+};
+
+layout (std430, binding = 2) readonly buffer Draws { Draw draws[]; };
+
+out vec3 position;
+out vec3 normal;
+out vec2 textureCoord;
+flat out uint material;
+
+uniform mat4 ViewMatrix;
+uniform mat4 ProjectionMatrix;
+
+void main() {
+    mat4 modelView = ViewMatrix * draws[v_DrawId].modelMatrix;
+
+    // Transform vertex position and normal to eye coordinate space.
+    normal = normalize(transpose(inverse(mat3(modelView))) * v_Normal);
+    position = vec3(modelView * vec4(v_Position, 1.0));
+    textureCoord = v_TextureCoord;
+    material = draws[v_DrawId].material;
+
+    gl_Position = ProjectionMatrix * vec4(position, 1.0);
+}
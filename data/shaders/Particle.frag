@@ -0,0 +1,17 @@
+#version 400
+
+in vec2 corner;
+in vec4 color;
+
+layout (location = 0) out vec4 fragColor;
+
+void main()
+{
+    // Round sprite, fading towards its edge.
+    float falloff = 1.0 - dot(corner, corner);
+    if (falloff <= 0.0) {
+        discard;
+    }
+
+    fragColor = vec4(color.rgb, color.a * falloff);
+}
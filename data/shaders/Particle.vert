@@ -0,0 +1,25 @@
+#version 400
+
+// Per instance, streamed by ParticleRenderer.
+layout (location = 0) in vec3 instancePosition;
+layout (location = 1) in vec4 instanceColor;
+
+out vec2 corner;
+out vec4 color;
+
+uniform mat4 ModelViewMatrix;
+uniform mat4 ProjectionMatrix;
+uniform float particleSize;
+
+void main()
+{
+    // Triangle strip over the quad corners (-1,-1), (1,-1), (-1,1), (1,1).
+    corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+    color = instanceColor;
+
+    // Expand in eye space so the quad faces the camera.
+    vec4 eyePosition = ModelViewMatrix * vec4(instancePosition, 1.0);
+    eyePosition.xy += corner * particleSize;
+
+    gl_Position = ProjectionMatrix * eyePosition;
+}
@@ -0,0 +1,11 @@
+#version 400
+
+in vec3 worldPosition;
+
+uniform vec3 lightPosition;
+uniform float lightRadius;
+
+void main() {
+    // Store normalized distance so lookups use the same metric from any face.
+    gl_FragDepth = length(worldPosition - lightPosition) / lightRadius;
+}
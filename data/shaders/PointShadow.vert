@@ -0,0 +1,11 @@
+#version 400
+
+layout (location = 0) in vec3 vertexPosition;
+
+uniform mat4 ModelMatrix;
+
+void main()
+{
+    // World space position, projected per cube face in the geometry shader.
+    gl_Position = ModelMatrix * vec4(vertexPosition, 1.0);
+}
@@ -0,0 +1,36 @@
+#version 400
+
+layout (location = 0) in vec3 vertexPosition;
+layout (location = 1) in vec3 vertexNormal;
+layout (location = 2) in uvec4 boneIndices;
+layout (location = 3) in vec4 boneWeights;
+
+out vec3 position;
+out vec3 normal;
+
+uniform mat4 ModelViewMatrix;
+uniform mat3 NormalMatrix;
+uniform mat4 ProjectionMatrix;
+
+// Skinning matrices of one character, bound by SkinningPalette::bind.
+layout (std140) uniform JointPalette {
+    mat4 joints[128];
+};
+
+void main()
+{
+    mat4 skin = joints[boneIndices.x] * boneWeights.x +
+                joints[boneIndices.y] * boneWeights.y +
+                joints[boneIndices.z] * boneWeights.z +
+                joints[boneIndices.w] * boneWeights.w;
+
+    vec4 skinnedPosition = skin * vec4(vertexPosition, 1.0);
+    vec3 skinnedNormal = mat3(skin) * vertexNormal;
+
+    // Transform vertex position and normal to eye coordinate space.
+    normal = normalize(NormalMatrix * skinnedNormal);
+    position = vec3( ModelViewMatrix * skinnedPosition );
+
+    // Transform position to normalized device coordinate space.
+    gl_Position = ProjectionMatrix * vec4(position, 1.0);
+}
@@ -0,0 +1,15 @@
+#version 400
+
+in vec2 glyphTexCoord;
+in vec4 glyphColor;
+
+layout (location = 0) out vec4 fragColor;
+
+// Glyph coverage in the red channel.
+uniform sampler2D glyphAtlas;
+
+void main()
+{
+    float coverage = texture(glyphAtlas, glyphTexCoord).r;
+    fragColor = vec4(glyphColor.rgb, glyphColor.a * coverage);
+}
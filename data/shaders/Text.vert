@@ -0,0 +1,20 @@
+#version 400
+
+// Glyph quad corners, laid out by TextRenderer.
+layout (location = 0) in vec2 position;     // Pixels, origin at the top left.
+layout (location = 1) in vec2 texCoord;
+layout (location = 2) in vec4 color;
+
+out vec2 glyphTexCoord;
+out vec4 glyphColor;
+
+uniform vec2 viewportSize;
+
+void main()
+{
+    glyphTexCoord = texCoord;
+    glyphColor = color;
+
+    vec2 ndc = position / viewportSize * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+}
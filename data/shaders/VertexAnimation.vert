@@ -0,0 +1,49 @@
+#version 400
+
+layout (location = 0) in vec3 vertexPosition;   // Base pose.
+
+out vec3 position;
+out vec3 normal;
+
+uniform mat4 ModelViewMatrix;
+uniform mat3 NormalMatrix;
+uniform mat4 ProjectionMatrix;
+
+// numVertices texels per frame.  xyz is the quantized offset from the base pose,
+// w the octahedral normal with x in the low byte.
+uniform isamplerBuffer keyframes;
+uniform int numVertices;
+uniform int frameA;
+uniform int frameB;
+uniform float blend;
+uniform vec3 positionScale;
+
+vec2 signNotZero(vec2 v) {
+    return vec2((v.x >= 0.0) ? 1.0 : -1.0, (v.y >= 0.0) ? 1.0 : -1.0);
+}
+
+vec3 decodeNormal(int packedNormal) {
+    int bits = packedNormal & 0xFFFF;
+    vec2 p = vec2(bits & 0xFF, bits >> 8) * (2.0 / 255.0) - 1.0;
+    vec3 n = vec3(p, 1.0 - abs(p.x) - abs(p.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(p.yx)) * signNotZero(p);
+    }
+    return normalize(n);
+}
+
+void main()
+{
+    ivec4 a = texelFetch(keyframes, frameA * numVertices + gl_VertexID);
+    ivec4 b = texelFetch(keyframes, frameB * numVertices + gl_VertexID);
+
+    vec3 objectPosition = vertexPosition + mix(vec3(a.xyz), vec3(b.xyz), blend) * positionScale;
+    vec3 objectNormal = mix(decodeNormal(a.w), decodeNormal(b.w), blend);
+
+    // Transform vertex position and normal to eye coordinate space.
+    normal = normalize(NormalMatrix * objectNormal);
+    position = vec3( ModelViewMatrix * vec4(objectPosition, 1.0) );
+
+    // Transform position to normalized device coordinate space.
+    gl_Position = ProjectionMatrix * vec4(position, 1.0);
+}
@@ -0,0 +1,214 @@
+#include "DynamicResolutionDemo.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+namespace {
+    const unsigned int maxLayers = 16;
+    const int gridColumns = 6;
+    const int gridRows = 4;
+}
+
+//---------------------------------------------------------------------------------------
+int main() {
+    shared_ptr<GlfwOpenGlWindow> demo = DynamicResolutionDemo::getInstance();
+    demo->create(1024, 768, "Dynamic Resolution Demo");
+
+    return 0;
+}
+
+//---------------------------------------------------------------------------------------
+shared_ptr<GlfwOpenGlWindow> DynamicResolutionDemo::getInstance() {
+    static GlfwOpenGlWindow * instance = new DynamicResolutionDemo();
+    if (p_instance == nullptr) {
+        p_instance = shared_ptr<GlfwOpenGlWindow>(instance);
+    }
+
+    return p_instance;
+}
+
+//---------------------------------------------------------------------------------------
+void DynamicResolutionDemo::init() {
+    meshConsolidator =  {
+            {"sphere", "../data/meshes/sphere_smooth.obj"},
+    };
+
+    meshConsolidator.getBatchInfo(batchInfoMap);
+
+    glGenVertexArrays(1, &vao);
+
+    numLayers = 4;
+    frameCount = 0;
+
+    camera.lookAt(vec3(0.0f, 0.0f, 0.0f),   // position
+                  vec3(0.0f, 0.0f, -10.0f), // center
+                  vec3(0.0f, 1.0f, 0.0f));  // up vector
+
+    setupShaders();
+    setupVertexBuffers();
+    setupRenderables();
+
+    // Keep the main pass within 8 ms of GPU time, never below half resolution.
+    DynamicResolutionSettings settings;
+    settings.targetMilliseconds = 8.0;
+    settings.minScale = 0.5f;
+    settings.maxScale = 1.0f;
+    dynamicResolution.reset(new DynamicResolution(getRenderTargetPool(), settings));
+
+    // resizeGl() was called before init(), so size the offscreen target to match.
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    dynamicResolution->resize(viewport[2], viewport[3]);
+
+    glClearColor(0.2, 0.2, 0.2, 1.0);
+}
+
+//---------------------------------------------------------------------------------------
+void DynamicResolutionDemo::setupShaders() {
+    shader.generateProgramObject();
+    shader.attachVertexShader("../data/shaders/Pos-Norm-Tex-Color.vert");
+    shader.attachFragmentShader("../data/shaders/PerFragLighting.frag");
+    shader.link();
+
+    light.position = vec3(0.0f, 5.0f, 2.0f);
+    light.rgbIntensity = vec3(0.9f);
+
+    shader.setUniform("ambientIntensity", vec3(0.1f, 0.1f, 0.1f));
+    shader.setUniform("lightSource.position", light.position);
+    shader.setUniform("lightSource.rgbIntensity", light.rgbIntensity);
+
+    glBindVertexArray(vao);
+
+    GLint position_Location = shader.getAttribLocation("vertexPosition");
+    glEnableVertexAttribArray(position_Location);
+    GLint normal_Location = shader.getAttribLocation("vertexNormal");
+    glEnableVertexAttribArray(normal_Location);
+
+    glBindVertexArray(0);
+
+    checkGLErrors(__FILE__, __LINE__);
+}
+
+//---------------------------------------------------------------------------------------
+void DynamicResolutionDemo::setupVertexBuffers() {
+    glBindVertexArray(vao);
+
+    // Copy position data to OpenGL buffer.
+    glGenBuffers(1, &vbo_vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices);
+    glBufferData(GL_ARRAY_BUFFER, meshConsolidator.getNumVertexPositionBytes(),
+            meshConsolidator.getVertexPositionDataPtr(), GL_STATIC_DRAW);
+    glVertexAttribPointer(shader.getAttribLocation("vertexPosition"), 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+    // Copy normal data to OpenGL buffer.
+    glGenBuffers(1, &vbo_normals);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_normals);
+    glBufferData(GL_ARRAY_BUFFER, meshConsolidator.getNumVertexNormalBytes(),
+            meshConsolidator.getVertexNormalDataPtr(), GL_STATIC_DRAW);
+    glVertexAttribPointer(shader.getAttribLocation("vertexNormal"), 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    checkGLErrors(__FILE__, __LINE__);
+}
+
+//---------------------------------------------------------------------------------------
+// Each layer is a grid of large spheres covering the screen.  Layers are ordered far
+// to near and drawn in that order, so depth testing rejects nothing and every layer
+// adds a screen's worth of per fragment lighting.
+void DynamicResolutionDemo::setupRenderables() {
+    spheres.reserve(maxLayers * gridColumns * gridRows);
+
+    for (unsigned int layer = 0; layer < maxLayers; ++layer) {
+        const float z = -6.0f - 0.5f * (maxLayers - 1 - layer);
+        for (int row = 0; row < gridRows; ++row) {
+            for (int column = 0; column < gridColumns; ++column) {
+                Renderable sphere(&vao, &shader, &batchInfoMap.at("sphere"));
+                sphere.setPosition(vec3((column - 0.5f * (gridColumns - 1)) * 1.6f,
+                                        (row - 0.5f * (gridRows - 1)) * 1.6f,
+                                        z));
+                sphere.setScale(vec3(1.2f));
+                sphere.setEmissionLevels(vec3(0.0f));
+                sphere.setAmbientLevels(vec3(1.0f, 1.0f, 1.0f));
+                sphere.setDiffuseLevels(vec3(0.2f + 0.05f * layer, 0.4f, 0.9f - 0.05f * layer));
+                sphere.setSpecularIntensity(0.5f);
+                sphere.setShininessFactor(50.0f);
+                spheres.push_back(sphere);
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DynamicResolutionDemo::logic() {
+   renderContext.projectionMatrix = camera.getProjectionMatrix();
+   renderContext.viewMatrix= camera.getViewMatrix();
+}
+
+//---------------------------------------------------------------------------------------
+void DynamicResolutionDemo::draw() {
+    dynamicResolution->beginFrame();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Only the nearest 'numLayers' layers are drawn, farthest first.
+    const size_t spheresPerLayer = gridColumns * gridRows;
+    for (size_t i = (maxLayers - numLayers) * spheresPerLayer; i < spheres.size(); ++i) {
+        spheres[i].render(renderContext);
+    }
+
+    dynamicResolution->endFrame();
+
+    if (++frameCount % 60 == 0) {
+        printStats();
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DynamicResolutionDemo::printStats() const {
+    cout << "layers: " << numLayers
+         << ", scale: " << dynamicResolution->getScale()
+         << ", render size: " << dynamicResolution->getRenderWidth() << "x"
+         << dynamicResolution->getRenderHeight()
+         << ", gpu: " << dynamicResolution->getGpuMilliseconds() << " ms"
+         << " (target " << dynamicResolution->getSettings().targetMilliseconds << " ms)"
+         << endl;
+}
+
+//---------------------------------------------------------------------------------------
+void DynamicResolutionDemo::keyInput(int key, int action, int mods) {
+    if (action != GLFW_PRESS && action != GLFW_REPEAT) {
+        return;
+    }
+
+    if (key == GLFW_KEY_UP) {
+        numLayers = std::min(numLayers + 1, maxLayers);
+    } else if (key == GLFW_KEY_DOWN) {
+        numLayers = std::max(numLayers - 1, 1u);
+    } else if (key == GLFW_KEY_EQUAL || key == GLFW_KEY_MINUS) {
+        DynamicResolutionSettings settings = dynamicResolution->getSettings();
+        const double step = (key == GLFW_KEY_EQUAL) ? 1.0 : -1.0;
+        settings.targetMilliseconds = std::max(settings.targetMilliseconds + step, 1.0);
+        dynamicResolution->setSettings(settings);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DynamicResolutionDemo::resizeGl(int width, int height) {
+    if (dynamicResolution) {
+        dynamicResolution->resize(width, height);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void DynamicResolutionDemo::cleanup() {
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glDeleteBuffers(1, &vbo_vertices);
+    glDeleteBuffers(1, &vbo_normals);
+    glDeleteVertexArrays(1, &vao);
+    dynamicResolution.reset();
+    checkGLErrors(__FILE__, __LINE__);
+}
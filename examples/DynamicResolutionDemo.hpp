@@ -0,0 +1,71 @@
+#ifndef DYNAMIC_RESOLUTION_DEMO_HPP_
+#define DYNAMIC_RESOLUTION_DEMO_HPP_
+
+#include <Utils/GlfwOpenGlWindow.hpp>
+#include <Rigid3D/Rigid3D.hpp>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+using namespace Rigid3D;
+using std::shared_ptr;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+/**
+ * @brief Demo Instructions
+ *
+ * Scene Load:
+ * Press up and down to add or remove layers of per fragment lit spheres.
+ *
+ * Frame Budget:
+ * Press + and - to raise or lower the target GPU time of the main pass.
+ *
+ * The render scale, render size and measured GPU time are printed once a second.
+ */
+class DynamicResolutionDemo : public GlfwOpenGlWindow {
+public:
+    static shared_ptr<GlfwOpenGlWindow> getInstance();
+
+private:
+    vector<Renderable> spheres;
+    RenderContext renderContext;
+
+    ShaderProgram shader;
+
+    // Mesh and Batch Containers
+    MeshConsolidator meshConsolidator;
+    unordered_map<const char *, BatchInfo> batchInfoMap;
+
+    struct LightSource {
+        vec3 position;      // Light position in world space.
+        vec3 rgbIntensity;  // Light intensity for each RGB component.
+    };
+    LightSource light;
+
+    GLuint vao;
+    GLuint vbo_vertices;
+    GLuint vbo_normals;
+
+    unique_ptr<DynamicResolution> dynamicResolution;
+    unsigned int numLayers;     // Overlapping layers of spheres, each fills the screen.
+    unsigned int frameCount;
+
+    void init();
+
+    void setupShaders();
+    void setupVertexBuffers();
+    void setupRenderables();
+
+    void logic();
+    void draw();
+    void cleanup();
+    void keyInput(int key, int action, int mods);
+    void resizeGl(int width, int height);
+
+    void printStats() const;
+};
+
+#endif /* DYNAMIC_RESOLUTION_DEMO_HPP_ */
@@ -16,26 +16,21 @@ public:
     static std::shared_ptr<GlfwOpenGlWindow> getInstance();
 
 private:
-    mat4 modelMatrixA;
-    mat4 modelMatrixB;
     mat4 viewMatrix;
     mat4 projectionMatrix;
-    mat3 normalMatrix;
 
     GLuint vao;
     GLuint vbo_vertices;
     GLuint vbo_normals;
     GLuint vbo_textureCoords;
-    GLuint vbo_indices;
-    GLuint numIndices;
 
-    GLuint textureId;
+    Mesh texturedCube;
 
-    Mesh texturedCubeA;
-    Mesh texturedCubeB;
+    // Material textures and properties, selected per draw by the shader.
+    std::unique_ptr<MaterialLibrary> materials;
 
-    // World space vertex positions for the 2 Cubes.
-    std::unique_ptr<float32[]> positionDataPtr;
+    // Every cube, drawn with one multi-draw call.
+    std::unique_ptr<MultiDrawBatch> cubeBatch;
 
     ShaderProgram shader;
 
@@ -52,6 +47,5 @@ private:
     void setupUniformData();
     void setupVboData();
     void setupVertexAttributeMapping();
-    void setupTextureData();
-    void transformVertexDataToWorldSpace();
+    void setupMaterials();
 };
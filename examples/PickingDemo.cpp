@@ -1,6 +1,10 @@
 #include "PickingDemo.hpp"
 
+#include <iostream>
+
 using glm::angleAxis;
+using std::cout;
+using std::endl;
 
 
 //---------------------------------------------------------------------------------------
@@ -34,6 +38,12 @@ void PickingDemo::init() {
 
     glGenVertexArrays(1, &vao);
 
+    sceneTarget = RenderTarget();
+    selected = nullptr;
+    cursorX = 0.0;
+    cursorY = 0.0;
+    pickRequested = false;
+
     camera.lookAt(vec3(0.0f, 1.0f, 0.0f),   // position
                   vec3(0.0f, 0.0f, -10.0f), // center
                   vec3(0.0f, 1.0f, 0.0f));  // up vector
@@ -42,13 +52,21 @@ void PickingDemo::init() {
     setupVertexBuffers();
     setupRenderables();
 
+    // resizeGl() was called before init(), so size the scene framebuffer to match.
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    picker.reset(new ObjectIdPicker());
+    setupSceneFramebuffer(viewport[2], viewport[3]);
+
     glClearColor(0.2, 0.2, 0.2, 1.0);
 }
 
 //---------------------------------------------------------------------------------------
 void PickingDemo::setupShaders() {
-    shader.loadFromFile("../data/shaders/Pos-Norm-Tex-Color.vert",
-                        "../data/shaders/PerFragLighting_withWorldLight.frag");
+    shader.generateProgramObject();
+    shader.attachVertexShader("../data/shaders/Pos-Norm-Tex-Color.vert");
+    shader.attachFragmentShader("../data/shaders/PerFragLighting_withObjectId.frag");
+    shader.link();
 
     light.position = vec3(0.0f, 5.0f, 10.0f);
     light.rgbIntensity = vec3(1.0f);
@@ -120,6 +138,28 @@ void PickingDemo::setupRenderables() {
     torus.setSpecularIntensity(0.3f);
     torus.setShininessFactor(10.0f);
 
+    pickables = { &cube, &sphere, &torus };
+}
+
+//---------------------------------------------------------------------------------------
+// Renders into an offscreen framebuffer so that object IDs are written alongside
+// color, then blitted to the window.  The framebuffer comes from the window's render
+// target pool, so resizing back to an earlier size reuses its attachments.
+void PickingDemo::setupSceneFramebuffer(int width, int height) {
+    RenderTargetPool & pool = getRenderTargetPool();
+    if (sceneTarget.framebuffer != 0) {
+        pool.releaseRenderTarget(sceneTarget, 1);
+    }
+
+    RenderTargetDesc color(width, height, GL_RGBA8);
+    RenderTargetDesc objectIds(width, height, GL_R32UI);
+    objectIds.filter = GL_NEAREST;
+    RenderTargetDesc depth(width, height, GL_DEPTH_COMPONENT24);
+    sceneTarget = pool.acquireRenderTarget({ color, objectIds }, depth);
+
+    picker->setSource(sceneTarget.framebuffer, GL_COLOR_ATTACHMENT1, width, height);
+
+    checkGLErrors(__FILE__, __LINE__);
 }
 
 //---------------------------------------------------------------------------------------
@@ -130,9 +170,87 @@ void PickingDemo::logic() {
 
 //---------------------------------------------------------------------------------------
 void PickingDemo::draw() {
-    cube.render(renderContext);
-    sphere.render(renderContext);
-    torus.render(renderContext);
+    // Resolve a pick requested on an earlier frame, if its readback has finished.
+    ObjectIdPicker::PickResult pick;
+    while (picker->getResult(pick)) {
+        select(pick.objectId, pick.x, pick.y);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, sceneTarget.framebuffer);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    picker->clear(1);
+
+    for (size_t i = 0; i < pickables.size(); ++i) {
+        shader.setUniform("objectId", (unsigned int)(i + 1));
+        pickables[i]->render(renderContext);
+    }
+
+    if (pickRequested) {
+        // Window y runs top-down, framebuffer y bottom-up.
+        picker->requestPick(int(cursorX), sceneTarget.height - 1 - int(cursorY));
+        pickRequested = false;
+    }
+
+    const GLsizei width = sceneTarget.width;
+    const GLsizei height = sceneTarget.height;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneTarget.framebuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT,
+            GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+//---------------------------------------------------------------------------------------
+// Highlights the picked object and reports the exact hit point, found by casting a
+// ray against only that object's triangles.
+void PickingDemo::select(uint32 objectId, int x, int y) {
+    if (selected != nullptr) {
+        selected->setEmissionLevels(selectedEmission);
+        selected = nullptr;
+    }
+
+    if (objectId == 0 || objectId > pickables.size()) {
+        return;
+    }
+
+    selected = pickables[objectId - 1];
+    selectedEmission = selected->getMaterial().emission;
+    selected->setEmissionLevels(vec3(0.3f, 0.3f, 0.0f));
+
+    vec2 ndcPosition((x + 0.5f) / sceneTarget.width * 2.0f - 1.0f,
+                     (y + 0.5f) / sceneTarget.height * 2.0f - 1.0f);
+    RayCastInput ray = computePickRay(renderContext.viewMatrix,
+            renderContext.projectionMatrix, ndcPosition);
+
+    RayCastOutput hit;
+    if (rayCastTriangles(meshConsolidator.getVertexPositionDataPtr(),
+            *selected->getBatchInfo(), selected->getModelMatrix(), ray, &hit)) {
+        cout << "Picked object " << objectId << " at " << hit.hitPoint << endl;
+    } else {
+        // The ID search radius can pick an object just beside the cursor.
+        cout << "Picked object " << objectId << endl;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void PickingDemo::cursorPosition(double xPos, double yPos) {
+    cursorX = xPos;
+    cursorY = yPos;
+}
+
+//---------------------------------------------------------------------------------------
+void PickingDemo::mouseButtonInput(int button , int actions, int mods) {
+    if (button == GLFW_MOUSE_BUTTON_LEFT && actions == GLFW_PRESS) {
+        pickRequested = true;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+void PickingDemo::resizeGl(int width, int height) {
+    if (picker) {
+        setupSceneFramebuffer(width, height);
+    }
 }
 
 //---------------------------------------------------------------------------------------
@@ -142,5 +260,7 @@ void PickingDemo::cleanup() {
     glDeleteBuffers(1, &vbo_vertices);
     glDeleteBuffers(1, &vbo_normals);
     glDeleteVertexArrays(1, &vao);
+    getRenderTargetPool().releaseRenderTarget(sceneTarget);
+    picker.reset();
     checkGLErrors(__FILE__, __LINE__);
 }
@@ -4,7 +4,15 @@
 #include <Utils/GlfwOpenGlWindow.hpp>
 #include <Rigid3D/Rigid3D.hpp>
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 using namespace Rigid3D;
+using std::shared_ptr;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
 
 class PickingDemo : public GlfwOpenGlWindow {
 public:
@@ -14,6 +22,7 @@ private:
     Renderable cube;
     Renderable sphere;
     Renderable torus;
+    vector<Renderable *> pickables;   // Object ID i + 1 is pickables[i].
     RenderContext renderContext;
 
     ShaderProgram shader;
@@ -32,18 +41,31 @@ private:
     GLuint vbo_vertices;
     GLuint vbo_normals;
 
+    // Scene framebuffer with color, object ID and depth attachments.
+    RenderTarget sceneTarget;
+
+    unique_ptr<ObjectIdPicker> picker;
+    Renderable * selected;
+    vec3 selectedEmission;
+    double cursorX;
+    double cursorY;
+    bool pickRequested;
+
     void init();
 
     void setupShaders();
     void setupVertexBuffers();
     void setupRenderables();
+    void setupSceneFramebuffer(int width, int height);
 
     void logic();
     void draw();
     void cleanup();
-//    void cursorPosition(double xPos, double yPos);
-//    void mouseButtonInput(int button , int actions, int mods);
-//    void keyInput(int key, int action, int mods);
+    void cursorPosition(double xPos, double yPos);
+    void mouseButtonInput(int button , int actions, int mods);
+    void resizeGl(int width, int height);
+
+    void select(uint32 objectId, int x, int y);
 
     void computeAABB(const Renderable & r, AABB *);
 };
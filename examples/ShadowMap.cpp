@@ -48,8 +48,10 @@ ShadowMap::ShadowMap()
         : vao(0),
           vbo_vertices(0),
           vbo_normals(0),
+          depthTexture(0),
           vao_shadowMap(0),
-          vbo_shadowMap_data(0) {
+          vbo_shadowMap_data(0),
+          frameGraph(getRenderTargetPool()) {
 
     spotLight.position = vec3(-2.0f, 6.0f, 2.0f);
     spotLight.rgbIntensity = vec3(1.0f, 1.0f, 1.0f);
@@ -59,13 +61,13 @@ ShadowMap::ShadowMap()
     spotLight.exponent = 5.0f;
     spotLight.conicAngle = 90.0f;
 }
-
+
 //---------------------------------------------------------------------------------------
 /*
  * Called after the window and OpenGL are initialized. Called exactly once,
  * before the main loop.
  */
-void ShadowMap::init()
+void ShadowMap::init()
 {
     meshConsolidator = {
           {"grid3d", "../data/meshes/grid3d.obj"},
@@ -82,7 +84,9 @@ void ShadowMap::init()
     setupShaders();
     setupGLBuffers();
     setupMatrices();
-    setupShadowFBO();
+
+    shadowMapWidth = 1024;
+    shadowMapHeight = 1024;
 
     // Release all data associated with Meshes.
     meshConsolidator.~MeshConsolidator();
@@ -112,7 +116,7 @@ void ShadowMap::setupShaders() {
     shaderProgram.setUniform("spotLight.conicAngle", spotLight.conicAngle);
 
     // Generate VAO and enable vertex attribute arrays for positions and normals.
-    glGenVertexArrays(1, &vao);
+    glGenVertexArrays(1, &vao);
     glBindVertexArray(vao);
     GLint position_Location = shaderProgram.getAttribLocation("vertexPosition");
     glEnableVertexAttribArray(position_Location);
@@ -123,20 +127,20 @@ void ShadowMap::setupShaders() {
 
     checkGLErrors(__FILE__, __LINE__);
 }
-
+
 //---------------------------------------------------------------------------------------
-void ShadowMap::setupGLBuffers()
+void ShadowMap::setupGLBuffers()
 {
-    // Register vertex positions with OpenGL within the context of the bound VAO.
-    glGenBuffers(1, &vbo_vertices);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices);
+    // Register vertex positions with OpenGL within the context of the bound VAO.
+    glGenBuffers(1, &vbo_vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_vertices);
     glBufferData(GL_ARRAY_BUFFER, meshConsolidator.getNumVertexPositionBytes(),
             meshConsolidator.getVertexPositionDataPtr(), GL_STATIC_DRAW);
     glVertexAttribPointer(shaderProgram.getAttribLocation("vertexPosition"), 3, GL_FLOAT, GL_FALSE, 0, 0);
 
-    // Register normals with OpenGL within the context of the bound VAO.
-    glGenBuffers(1, &vbo_normals);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_normals);
+    // Register normals with OpenGL within the context of the bound VAO.
+    glGenBuffers(1, &vbo_normals);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_normals);
     glBufferData(GL_ARRAY_BUFFER, meshConsolidator.getNumVertexNormalBytes(),
             meshConsolidator.getVertexNormalDataPtr(), GL_STATIC_DRAW);
     glVertexAttribPointer(shaderProgram.getAttribLocation("vertexNormal"), 3, GL_FLOAT, GL_FALSE, 0, 0);
@@ -144,7 +148,7 @@ void ShadowMap::setupGLBuffers()
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     Rigid3D::checkGLErrors(__FILE__, __LINE__);
-}
+}
 
 //---------------------------------------------------------------------------------------
 void ShadowMap::setupMatrices() {
@@ -167,96 +171,101 @@ void ShadowMap::setupMatrices() {
 }
 
 //---------------------------------------------------------------------------------------
-void ShadowMap::setupShadowFBO() {
-    shadowMapWidth = 1024;
-    shadowMapHeight = 1024;
-
-    glGenTextures(1, &depthTexture);
-    glBindTexture(GL_TEXTURE_2D, depthTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, shadowMapWidth, shadowMapHeight, 0,
-            GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-
-    GLfloat borderColor[] = {1.0f, 0.0f, 0.0f, 0.0f};
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LESS);
-
-    // Assign shadow map to texture channel 0.
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, depthTexture);
-
-    // Create and setup the FBO.
-    glGenFramebuffers(1, &shadowFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
-
-    GLenum drawBuffers[] = {GL_NONE};
-    glDrawBuffers(1, drawBuffers);
-
-    GLenum result = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if( result == GL_FRAMEBUFFER_COMPLETE) {
-        printf("Framebuffer is complete.\n");
-    } else {
-        printf("Framebuffer is not complete.\n");
-    }
+void ShadowMap::draw()
+{
+    buildFrameGraph();
+    frameGraph.execute();
 
-    // Revert to the default framebuffer for now.
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
     checkGLErrors(__FILE__, __LINE__);
 }
-
+
 //---------------------------------------------------------------------------------------
-void ShadowMap::draw()
-{
-    // Pass 1 (Save shadow map to FBO).
-    spotLight.viewMatrix = glm::lookAt(spotLight.position, spotLight.center, vec3(0.0f, 1.0f, 0.0f));
-    viewMatrix = spotLight.viewMatrix;
-    projectionMatrix = spotLight.frustum.getProjectionMatrix();
-    glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO);
-    glClear(GL_DEPTH_BUFFER_BIT);
-    glViewport(0, 0, shadowMapWidth, shadowMapHeight);
-    shaderProgram.setUniformSubroutine(GL_FRAGMENT_SHADER, "recordDepthValues");
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_FRONT);
-    drawScene();
-    glFlush();
-    glFinish();
+/*
+ * Describes this frame's passes.  The shadow map is a transient target of the frame
+ * graph, allocated from the window's render target pool only while the passes using
+ * it run.
+ */
+void ShadowMap::buildFrameGraph() {
+    frameGraph.reset();
+
+    FrameGraph::ResourceId backbuffer = frameGraph.importFramebuffer("backbuffer", 0,
+            windowWidth, windowHeight);
+    FrameGraph::ResourceId shadowMap;
+
+    // Pass 1 (Save shadow map).
+    frameGraph.addPass("shadowDepth",
+        [&](FrameGraph::PassBuilder & builder) {
+            RenderTargetDesc desc(shadowMapWidth, shadowMapHeight, GL_DEPTH_COMPONENT24);
+            desc.wrap = GL_CLAMP_TO_BORDER;
+            desc.compareMode = GL_COMPARE_REF_TO_TEXTURE;
+            shadowMap = builder.create("shadowMap", desc);
+        },
+        [this](const FrameGraph::PassResources &) {
+            spotLight.viewMatrix = glm::lookAt(spotLight.position, spotLight.center,
+                    vec3(0.0f, 1.0f, 0.0f));
+            viewMatrix = spotLight.viewMatrix;
+            projectionMatrix = spotLight.frustum.getProjectionMatrix();
+            glClear(GL_DEPTH_BUFFER_BIT);
+            shaderProgram.setUniformSubroutine(GL_FRAGMENT_SHADER, "recordDepthValues");
+            glEnable(GL_CULL_FACE);
+            glCullFace(GL_FRONT);
+            drawScene();
+        });
 
     if (!render_shadow_map) {
-        //  Pass 2 (Shade scene with shadows)
-        viewMatrix = camera.getViewMatrix();
-        projectionMatrix = camera.getProjectionMatrix();
-        shaderProgram.setUniform("spotLight.position", vec3(viewMatrix * vec4(spotLight.position, 1.0)));
-        shaderProgram.setUniform("spotLight.center", vec3(viewMatrix * vec4(spotLight.center, 1.0)));
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glViewport(0, 0, windowWidth, windowHeight);
-        shaderProgram.setUniformSubroutine(GL_FRAGMENT_SHADER, "shadeWithShadow");
-        glCullFace(GL_BACK);
-        drawScene();
+        // Pass 2 (Shade scene with shadows).
+        frameGraph.addPass("main",
+            [&](FrameGraph::PassBuilder & builder) {
+                builder.read(shadowMap);
+                backbuffer = builder.write(backbuffer);
+            },
+            [this, shadowMap](const FrameGraph::PassResources & resources) {
+                // Assign shadow map to texture channel 0.
+                depthTexture = resources.getTexture(shadowMap);
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, depthTexture);
+                GLfloat borderColor[] = {1.0f, 0.0f, 0.0f, 0.0f};
+                glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+                viewMatrix = camera.getViewMatrix();
+                projectionMatrix = camera.getProjectionMatrix();
+                shaderProgram.setUniform("spotLight.position", vec3(viewMatrix * vec4(spotLight.position, 1.0)));
+                shaderProgram.setUniform("spotLight.center", vec3(viewMatrix * vec4(spotLight.center, 1.0)));
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                shaderProgram.setUniformSubroutine(GL_FRAGMENT_SHADER, "shadeWithShadow");
+                glCullFace(GL_BACK);
+                drawScene();
+            });
 
         if (render_light_frustum) {
-            drawLightFrustum();
+            frameGraph.addPass("lightFrustum",
+                [&](FrameGraph::PassBuilder & builder) {
+                    backbuffer = builder.write(backbuffer);
+                },
+                [this](const FrameGraph::PassResources &) {
+                    drawLightFrustum();
+                });
         }
 
     } else {
         // Render shadow map
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glViewport(0, 0, shadowMapWidth, shadowMapHeight);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
-        drawShadowMap();
+        frameGraph.addPass("shadowMapDebug",
+            [&](FrameGraph::PassBuilder & builder) {
+                builder.read(shadowMap);
+                backbuffer = builder.write(backbuffer);
+            },
+            [this, shadowMap](const FrameGraph::PassResources & resources) {
+                depthTexture = resources.getTexture(shadowMap);
+                glActiveTexture(GL_TEXTURE0);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                glViewport(0, 0, shadowMapWidth, shadowMapHeight);
+                glEnable(GL_CULL_FACE);
+                glCullFace(GL_BACK);
+                drawShadowMap();
+            });
     }
-
-    checkGLErrors(__FILE__, __LINE__);
 }
-
+
 //---------------------------------------------------------------------------------------
 void ShadowMap::drawScene() {
     glBindVertexArray(vao);
@@ -452,7 +461,7 @@ void ShadowMap::drawShadowMap() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LESS);
 }
-
+
 //---------------------------------------------------------------------------------------
 void ShadowMap::logic() {
     processKeyInput();
@@ -480,11 +489,10 @@ void ShadowMap::updateMaterialProperties(const MaterialProperties & m) {
     shaderProgram.setUniform("material.Ks", m.Ks);
     shaderProgram.setUniform("material.shininess", m.shininess);
 }
-
+
 //---------------------------------------------------------------------------------------
 void ShadowMap::cleanup() {
-    glDeleteTextures(1, &depthTexture);
-    glDeleteFramebuffers(1, &shadowFBO);
+    frameGraph.reset();
     glBindVertexArray(0);
 
     glDeleteBuffers(1, &vbo_normals);
@@ -48,8 +48,7 @@ private:
     GLuint vao;
     GLuint vbo_vertices;
     GLuint vbo_normals;
-    GLuint shadowFBO;
-    GLuint depthTexture;  // Shadow map texture.
+    GLuint depthTexture;  // Shadow map texture for the current frame, owned by the frame graph.
     GLuint vao_shadowMap;
     GLuint vbo_shadowMap_data;
 
@@ -64,6 +63,8 @@ private:
     };
     SpotLight spotLight;
 
+    FrameGraph frameGraph;
+
     struct MaterialProperties {
         vec3 emission;  // Emission light intensity from material for each RGB component.
         vec3 Ka;        // Coefficients of ambient reflectivity for each RGB component.
@@ -107,7 +108,7 @@ private:
     virtual void reloadShaderProgram();
 
     void setupShaders();
-    void setupShadowFBO();
+    void buildFrameGraph();
     void setupGLBuffers();
     void setupMatrices();
     void updateMatrices();
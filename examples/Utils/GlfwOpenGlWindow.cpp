@@ -1,6 +1,7 @@
 #include "GlfwOpenGlWindow.hpp"
 using Rigid3D::Camera;
 using Rigid3D::CameraController;
+using Rigid3D::FramePacket;
 using std::string;
 using std::shared_ptr;
 using std::chrono::seconds;
@@ -40,6 +41,14 @@ GlfwOpenGlWindow::GlfwOpenGlWindow()
    paused(false),
    fullScreen(false),
    destroyPrevWindow(false),
+   pipelinedRendering(false),
+   reloadShadersRequested(false),
+   viewportWidth(0),
+   viewportHeight(0),
+   renderViewportWidth(0),
+   renderViewportHeight(0),
+   asyncUploads(false),
+   uploadWindow(nullptr),
    camera(),
    cameraController() {
 
@@ -59,6 +68,12 @@ void GlfwOpenGlWindow::windowResizeCallBack(GLFWwindow * window, int width, int
 }
 
 //----------------------------------------------------------------------------------------
+/**
+ * Updates the camera's projection for the new window size.  Runs on the main
+ * thread, which does not own the OpenGL context when pipelined rendering is
+ * enabled, so overrides must not make OpenGL calls here.  Resize render targets
+ * in resizeGl() instead.
+ */
 void GlfwOpenGlWindow::resize(int width, int height) {
     float aspectRatio = float(width) / height;
     float frustumYScale = cotangent(degreesToRadians(camera.getFieldOfViewY() / 2));
@@ -82,7 +97,12 @@ void GlfwOpenGlWindow::resize(int width, int height) {
     camera.setProjectionMatrix(projectionMatrix);
 
     // Use entire window for rendering.
-    glViewport(0, 0, width, height);
+    viewportWidth = width;
+    viewportHeight = height;
+    if (!pipelinedRendering) {
+        glViewport(0, 0, width, height);
+        resizeGl(width, height);
+    }
 }
 
 //----------------------------------------------------------------------------------------
@@ -205,36 +225,240 @@ void GlfwOpenGlWindow::create(
 
         setupGl();
         setupCamera();
+        startUploadThread();
         init();
 
-        steady_clock::time_point frameStartTime;
+        viewportWidth = framebufferPixelWidth;
+        viewportHeight = framebufferPixelHeight;
+
+        if (pipelinedRendering) {
+            runPipelinedLoop(secondsPerFrame);
+        } else {
+            runSequentialLoop(secondsPerFrame);
+        }
+
+    } catch (const  std::exception & e) {
+        std::cerr << "Exception Thrown: ";
+        std::cerr << e.what() << endl;
+    } catch (...) {
+        std::cerr << "Uncaught exception thrown.  Terminating Program." << endl;
+    }
 
-        // Main Program Loop:
+    stopUploadThread();
+    cleanup();
+    renderTargetPool.clear();
+    glfwDestroyWindow(window);
+}
+
+//----------------------------------------------------------------------------------------
+void GlfwOpenGlWindow::runSequentialLoop(double secondsPerFrame) {
+    steady_clock::time_point frameStartTime;
+
+    // Main Program Loop:
+    while (!glfwWindowShouldClose(window)) {
+        frameStartTime = steady_clock::now();
+
+        glfwPollEvents();
+        if (!paused) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            cameraController.updateCamera();
+            logic();
+            if (asyncUploads) {
+                uploader.processCompleted();
+            }
+            draw();
+            glfwSwapBuffers(window);
+            renderTargetPool.nextFrame();
+        }
+        destroyPrevWindowCheck();
+
+        frameLimiter(secondsPerFrame, frameStartTime);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Main loop when pipelined rendering is enabled.  This thread polls events, runs
+ * logic() and fills a FramePacket for frame N+1 while the render thread, which
+ * owns the OpenGL context, draws frame N.
+ */
+void GlfwOpenGlWindow::runPipelinedLoop(double secondsPerFrame) {
+    steady_clock::time_point frameStartTime;
+
+    startRenderThread();
+
+    try {
         while (!glfwWindowShouldClose(window)) {
             frameStartTime = steady_clock::now();
 
             glfwPollEvents();
             if (!paused) {
-                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
                 cameraController.updateCamera();
                 logic();
-                draw();
-                glfwSwapBuffers(window);
+
+                FramePacket & packet = framePipeline.beginFrame();
+                packet.clear();
+                packet.setCamera(camera);
+                packet.viewportWidth = viewportWidth;
+                packet.viewportHeight = viewportHeight;
+                buildFramePacket(packet);
+
+                framePipeline.submitFrame();
             }
             destroyPrevWindowCheck();
 
             frameLimiter(secondsPerFrame, frameStartTime);
         }
-        
-    } catch (const  std::exception & e) {
-        std::cerr << "Exception Thrown: ";
-        std::cerr << e.what() << endl;
     } catch (...) {
-        std::cerr << "Uncaught exception thrown.  Terminating Program." << endl;
+        // Hand the context back before cleanup() runs on this thread.
+        try {
+            stopRenderThread();
+        } catch (...) {
+        }
+        throw;
     }
 
-    cleanup();
-    glfwDestroyWindow(window);
+    stopRenderThread();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Releases the OpenGL context from this thread and hands it to a new render
+ * thread.
+ */
+void GlfwOpenGlWindow::startRenderThread() {
+    renderViewportWidth = 0;
+    renderViewportHeight = 0;
+
+    glfwMakeContextCurrent(NULL);
+
+    GLFWwindow * renderWindow = window;
+    framePipeline.start(
+        [renderWindow]() { glfwMakeContextCurrent(renderWindow); },
+        [this](const FramePacket & packet) { renderPacket(packet); },
+        []() { glfwMakeContextCurrent(NULL); });
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Finishes drawing submitted frames, joins the render thread and makes the OpenGL
+ * context current on this thread again.
+ */
+void GlfwOpenGlWindow::stopRenderThread() {
+    try {
+        framePipeline.stop();
+    } catch (...) {
+        glfwMakeContextCurrent(window);
+        throw;
+    }
+    glfwMakeContextCurrent(window);
+}
+
+//----------------------------------------------------------------------------------------
+// Ran on the render thread.
+void GlfwOpenGlWindow::renderPacket(const FramePacket & packet) {
+    if (packet.viewportWidth != renderViewportWidth ||
+        packet.viewportHeight != renderViewportHeight) {
+        glViewport(0, 0, packet.viewportWidth, packet.viewportHeight);
+        renderViewportWidth = packet.viewportWidth;
+        renderViewportHeight = packet.viewportHeight;
+        resizeGl(renderViewportWidth, renderViewportHeight);
+    }
+
+    if (reloadShadersRequested.exchange(false)) {
+        reloadShaderProgram();
+    }
+
+    if (asyncUploads) {
+        uploader.processCompleted();
+    }
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    renderFramePacket(packet);
+    glfwSwapBuffers(window);
+    renderTargetPool.nextFrame();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Runs simulation and rendering on separate threads, overlapping the logic() of
+ * one frame with the rendering of the previous one.  Must be called before
+ * create(), typically from the derived class's constructor.
+ *
+ * When enabled, draw() is never called.  Instead buildFramePacket() copies the
+ * state to be rendered into a FramePacket after each logic(), and
+ * renderFramePacket() draws it on the render thread.  Only init(), setupGl(),
+ * cleanup(), reloadShaderProgram(), resizeGl() and renderFramePacket() may make
+ * OpenGL calls; resize() still runs on the main thread and must not.
+ */
+void GlfwOpenGlWindow::enablePipelinedRendering() {
+    pipelinedRendering = true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Creates a hidden window whose context shares objects with the rendering
+ * context, and a background thread that uploads buffer and texture data queued
+ * with getUploader() through it.  Must be called before create(), typically from
+ * the derived class's constructor.
+ *
+ * Uploads may be queued from init() onwards.  Completed uploads are retired once
+ * per frame just before draw(), or before renderFramePacket() when pipelined
+ * rendering is enabled.  Switching between full screen and windowed mode discards
+ * uploads still pending, since init() runs again on the new context, and those
+ * report AsyncUploader::Status::Cancelled.
+ */
+void GlfwOpenGlWindow::enableAsyncUploads() {
+    asyncUploads = true;
+}
+
+//----------------------------------------------------------------------------------------
+Rigid3D::AsyncUploader & GlfwOpenGlWindow::getUploader() {
+    return uploader;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Pool for offscreen render targets, advanced to the next frame after every buffer
+ * swap and emptied after cleanup().  Targets sized to the window are best acquired
+ * in resizeGl(), releasing the previous ones with a delay of a frame or two, so
+ * that returning to an earlier size reuses its textures and framebuffer.  Like
+ * every OpenGL call, pool calls must not be made from resize() when pipelined
+ * rendering is enabled.
+ */
+Rigid3D::RenderTargetPool & GlfwOpenGlWindow::getRenderTargetPool() {
+    return renderTargetPool;
+}
+
+//----------------------------------------------------------------------------------------
+void GlfwOpenGlWindow::startUploadThread() {
+    if (!asyncUploads) {
+        return;
+    }
+
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    uploadWindow = glfwCreateWindow(1, 1, "Upload Context", NULL, window);
+    glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
+    if (uploadWindow == NULL) {
+        throw GlfwException("Call to glfwCreateWindow failed for upload context.");
+    }
+
+    GLFWwindow * context = uploadWindow;
+    uploader.start(
+        [context]() { glfwMakeContextCurrent(context); },
+        []() { glfwMakeContextCurrent(NULL); });
+}
+
+//----------------------------------------------------------------------------------------
+// Must be called with the rendering context current on this thread.
+void GlfwOpenGlWindow::stopUploadThread() {
+    if (uploadWindow == nullptr) {
+        return;
+    }
+
+    uploader.stop();
+    glfwDestroyWindow(uploadWindow);
+    uploadWindow = nullptr;
 }
 
 //----------------------------------------------------------------------------------------
@@ -305,6 +529,7 @@ void GlfwOpenGlWindow::registerGlfwCallBacks() {
 //----------------------------------------------------------------------------------------
 void GlfwOpenGlWindow::initNewOpenGlContext() {
     cleanup();
+    renderTargetPool.clear();
     registerGlfwCallBacks();
     glfwMakeContextCurrent(window);
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
@@ -374,16 +599,31 @@ void GlfwOpenGlWindow::keyInputBase(int key, int action, int mods) {
         if (key == GLFW_KEY_ESCAPE) {
             glfwSetWindowShouldClose(window, GL_TRUE);
         } else if (key == GLFW_KEY_F1) {
+            // Switching windows creates a new context on this thread.
+            if (pipelinedRendering) {
+                stopRenderThread();
+            }
+            stopUploadThread();
+
             if (fullScreen == false) {
                 switchToFullScreen();
             } else {
                 switchToWindowedMode();
             }
             fullScreen = !fullScreen;
+
+            startUploadThread();
+            if (pipelinedRendering) {
+                startRenderThread();
+            }
         } else if (key == GLFW_KEY_F10) {
             paused = !paused;
         } else if (key == GLFW_KEY_F8) {
-            reloadShaderProgram();
+            if (pipelinedRendering) {
+                reloadShadersRequested = true;
+            } else {
+                reloadShaderProgram();
+            }
         }
     }
 
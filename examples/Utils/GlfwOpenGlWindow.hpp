@@ -12,14 +12,18 @@
 #define GLFW_INCLUDE_GLCOREARB
 #include <GLFW/glfw3.h>
 
+#include <Rigid3D/Graphics/AsyncUploader.hpp>
 #include <Rigid3D/Graphics/Camera.hpp>
 #include <Rigid3D/Graphics/CameraController.hpp>
+#include <Rigid3D/Graphics/FramePipeline.hpp>
+#include <Rigid3D/Graphics/RenderTargetPool.hpp>
 
 #include <glm/glm.hpp>
 
 #include <string>
 #include <memory>
 #include <chrono>
+#include <atomic>
 
 #include <boost/noncopyable.hpp>
 
@@ -84,6 +88,14 @@ protected:
 
     int defaultFramebufferHeight() const;
 
+    void enablePipelinedRendering();
+
+    void enableAsyncUploads();
+
+    Rigid3D::AsyncUploader & getUploader();
+
+    Rigid3D::RenderTargetPool & getRenderTargetPool();
+
     // Virtual methods.
     virtual void init() { }
     virtual void setupGl();
@@ -92,6 +104,17 @@ protected:
     virtual void draw() { }
     virtual void cleanup() { }
 
+    // Virtual methods used instead of logic() and draw() when pipelined rendering is
+    // enabled.  buildFramePacket() runs on the main thread after logic(), and
+    // renderFramePacket() runs on the render thread.
+    virtual void buildFramePacket(Rigid3D::FramePacket & packet) { }
+    virtual void renderFramePacket(const Rigid3D::FramePacket & packet) { packet.render(); }
+
+    // Called with the OpenGL context current after the viewport changes size: from
+    // resize() normally, or on the render thread before the first frame of the new
+    // size when pipelined rendering is enabled.
+    virtual void resizeGl(int width, int height) { }
+
     // Virtual Callback methods.
     virtual void cursorEnter(int entered);
     virtual void cursorPosition(double xPos, double yPos);
@@ -115,6 +138,28 @@ private:
     bool fullScreen;
     bool destroyPrevWindow;
 
+    bool pipelinedRendering;
+    Rigid3D::FramePipeline framePipeline;
+    std::atomic<bool> reloadShadersRequested;
+    int viewportWidth;          // Latest size from resize(), sent with each packet.
+    int viewportHeight;
+    int renderViewportWidth;    // Size last applied by the render thread.
+    int renderViewportHeight;
+
+    bool asyncUploads;
+    GLFWwindow * uploadWindow;  // Hidden, hosts the upload thread's shared context.
+    Rigid3D::AsyncUploader uploader;
+
+    Rigid3D::RenderTargetPool renderTargetPool;
+
+    void runSequentialLoop(double secondsPerFrame);
+    void runPipelinedLoop(double secondsPerFrame);
+    void startRenderThread();
+    void stopRenderThread();
+    void renderPacket(const Rigid3D::FramePacket & packet);
+    void startUploadThread();
+    void stopUploadThread();
+
     std::chrono::duration<double> frameLimiter(
             double desiredSecondsPerFrame,
             const std::chrono::steady_clock::time_point & startTime) const;
@@ -55,7 +55,7 @@ solution "Rigid3D"
         targetdir "lib"
         buildoptions{"-std=c++11"}
         includedirs(includeDirList)
-        files {"src/**.cpp"}
+        files {"src/**.cpp", "ext/LoadPNG/lodepng.cpp"}
 
     -- Function for creating the example programs.
     function CreateDemo(projName, ...)
@@ -72,9 +72,29 @@ solution "Rigid3D"
         files { ... }
     end
 
+    -- Function for creating command line tools, which only need the Rigid3D library.
+    function CreateTool(projName, ...)
+        project(projName)
+        kind "ConsoleApp"
+        language "C++"
+        location "build"
+        objdir "build/obj"
+        targetdir "bin"
+        buildoptions{"-std=c++11"}
+        includedirs(includeDirList)
+        libdirs(libDirectories)
+        links({"Rigid3D"})
+        files { ... }
+    end
+
 -- Build Tests
 dofile("tests/tests.lua")
 
+-- Create a project for each tool
+CreateTool("MeshCooker", "tools/MeshCooker.cpp")
+CreateTool("AssetPacker", "tools/AssetPacker.cpp")
+CreateTool("TextureCooker", "tools/TextureCooker.cpp")
+
 -- Create a project for each demo
 CreateDemo("Glfw-Example", "examples/Glfw-Example.cpp")
 CreateDemo("GlfwOpenGlWindowExample", "examples/GlfwOpenGlWindowExample.cpp", "examples/Utils/GlfwOpenGlWindow.cpp")
@@ -87,3 +107,5 @@ CreateDemo("CameraExample", "examples/CameraExample.cpp", "examples/Utils/GlfwOp
 CreateDemo("ShadowMap", "examples/ShadowMap.cpp", "examples/Utils/GlfwOpenGlWindow.cpp")
 CreateDemo("TexturedCubeDemo", "examples/TexturedCubeDemo.cpp", "examples/Utils/GlfwOpenGlWindow.cpp")
 CreateDemo("PickingDemo", "examples/PickingDemo.cpp", "examples/Utils/GlfwOpenGlWindow.cpp")
+CreateDemo("DynamicResolutionDemo", "examples/DynamicResolutionDemo.cpp", "examples/Utils/GlfwOpenGlWindow.cpp")
+CreateDemo("MultiTexturedCubesDemo", "examples/MultiTexturedCubesDemo.cpp", "examples/Utils/GlfwOpenGlWindow.cpp")
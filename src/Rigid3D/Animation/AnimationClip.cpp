@@ -0,0 +1,91 @@
+#include "AnimationClip.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * Creates a clip with every sample at the identity pose, to be filled in through
+ * \c getSample.
+ *
+ * @param sampleRate - samples per second.
+ */
+AnimationClip::AnimationClip(uint32 numJoints, uint32 numSamples, float sampleRate)
+    : numJoints(numJoints),
+      sampleRate(sampleRate),
+      samples(numSamples, LocalPose(numJoints)) {
+    if (numSamples == 0 || sampleRate <= 0.0f) {
+        std::stringstream errorMessage;
+        errorMessage << "An animation clip needs at least one sample and a positive"
+                     << " sample rate within method AnimationClip::AnimationClip";
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+uint32 AnimationClip::getNumJoints() const {
+    return numJoints;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 AnimationClip::getNumSamples() const {
+    return uint32(samples.size());
+}
+
+//----------------------------------------------------------------------------------------
+float AnimationClip::getSampleRate() const {
+    return sampleRate;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return time of the last sample in seconds.  A looping clip is expected to end
+ * on the same pose it starts with.
+ */
+float AnimationClip::getDuration() const {
+    return float(samples.size() - 1) / sampleRate;
+}
+
+//----------------------------------------------------------------------------------------
+LocalPose & AnimationClip::getSample(uint32 sample) {
+    return samples[sample];
+}
+
+//----------------------------------------------------------------------------------------
+const LocalPose & AnimationClip::getSample(uint32 sample) const {
+    return samples[sample];
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Blends the two samples surrounding 'time' into 'result'.
+ *
+ * @param loop - wrap around after the last sample, otherwise hold it.
+ */
+void AnimationClip::sample(float time, bool loop, LocalPose & result) const {
+    const uint32 lastSample = uint32(samples.size() - 1);
+    if (lastSample == 0) {
+        result = samples[0];
+        return;
+    }
+
+    float sampleTime = time * sampleRate;
+    if (loop) {
+        sampleTime = std::fmod(sampleTime, float(lastSample));
+        if (sampleTime < 0.0f) {
+            sampleTime += float(lastSample);
+        }
+    } else {
+        sampleTime = std::max(0.0f, std::min(sampleTime, float(lastSample)));
+    }
+
+    const uint32 a = std::min(uint32(sampleTime), lastSample - 1);
+    LocalPose::blend(samples[a], samples[a + 1], sampleTime - float(a), result);
+}
+
+} // end namespace Rigid3D
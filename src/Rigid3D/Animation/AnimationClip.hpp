@@ -0,0 +1,48 @@
+/**
+ * @brief AnimationClip
+ */
+
+#ifndef RIGID3D_ANIMATION_CLIP_HPP_
+#define RIGID3D_ANIMATION_CLIP_HPP_
+
+#include <Rigid3D/Animation/LocalPose.hpp>
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Skeletal animation stored as poses sampled at a fixed rate.
+     *
+     * Uniform sampling makes finding the two poses around a time a division rather
+     * than a search per joint, and keeps every sample in the structure of arrays
+     * layout that \c LocalPose::blend works on.
+     */
+    class AnimationClip {
+    public:
+        AnimationClip(uint32 numJoints, uint32 numSamples, float sampleRate);
+
+        uint32 getNumJoints() const;
+
+        uint32 getNumSamples() const;
+
+        float getSampleRate() const;
+
+        float getDuration() const;
+
+        LocalPose & getSample(uint32 sample);
+
+        const LocalPose & getSample(uint32 sample) const;
+
+        void sample(float time, bool loop, LocalPose & result) const;
+
+    private:
+        uint32 numJoints;
+        float sampleRate;
+        std::vector<LocalPose> samples;
+    };
+
+}
+
+#endif /* RIGID3D_ANIMATION_CLIP_HPP_ */
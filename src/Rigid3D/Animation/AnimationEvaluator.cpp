@@ -0,0 +1,92 @@
+#include "AnimationEvaluator.hpp"
+
+#include <Rigid3D/Animation/AnimationClip.hpp>
+#include <Rigid3D/Animation/LocalPose.hpp>
+#include <Rigid3D/Animation/Skeleton.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+
+#include <sstream>
+
+namespace Rigid3D {
+
+namespace {
+
+    // Characters per parallelFor chunk.  A chunk reuses its scratch poses, and a
+    // typical skeleton takes a few microseconds to evaluate.
+    const size_t grainSize = 16;
+
+    //------------------------------------------------------------------------------------
+    void checkClip(const AnimationClip * clip, const Skeleton & skeleton, size_t job) {
+        if (clip->getNumJoints() != skeleton.getNumJoints()) {
+            std::stringstream errorMessage;
+            errorMessage << "Job " << job << " animates a skeleton of "
+                         << skeleton.getNumJoints() << " joints with a clip of "
+                         << clip->getNumJoints()
+                         << " joints within method AnimationEvaluator::evaluate";
+            throw Rigid3DException(errorMessage.str());
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    void evaluateRange(const std::vector<AnimationEvaluator::Job> & jobs,
+                       size_t begin, size_t end) {
+        LocalPose pose;
+        LocalPose blendPose;
+        for (size_t i = begin; i < end; ++i) {
+            const AnimationEvaluator::Job & job = jobs[i];
+            job.clip->sample(job.time, job.loop, pose);
+            if (job.blendClip && job.blendWeight > 0.0f) {
+                job.blendClip->sample(job.blendTime, job.loop, blendPose);
+                LocalPose::blend(pose, blendPose, job.blendWeight, pose);
+            }
+            job.skeleton->computeSkinningMatrices(pose, job.palette);
+        }
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+AnimationEvaluator::Job::Job()
+    : skeleton(nullptr),
+      clip(nullptr),
+      time(0.0f),
+      blendClip(nullptr),
+      blendTime(0.0f),
+      blendWeight(0.0f),
+      loop(true),
+      palette(nullptr) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Runs every job in 'jobs', in parallel when 'threadPool' is given.
+ *
+ * Jobs are validated up front, so nothing is written if any of them is malformed.
+ */
+void AnimationEvaluator::evaluate(const std::vector<Job> & jobs, ThreadPool * threadPool) {
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const Job & job = jobs[i];
+        if (!job.skeleton || !job.clip || !job.palette) {
+            std::stringstream errorMessage;
+            errorMessage << "Job " << i << " needs a skeleton, a clip and a palette"
+                         << " within method AnimationEvaluator::evaluate";
+            throw Rigid3DException(errorMessage.str());
+        }
+        checkClip(job.clip, *job.skeleton, i);
+        if (job.blendClip) {
+            checkClip(job.blendClip, *job.skeleton, i);
+        }
+    }
+
+    if (threadPool) {
+        threadPool->parallelFor(jobs.size(), grainSize, [&](size_t begin, size_t end) {
+            evaluateRange(jobs, begin, end);
+        });
+    } else {
+        evaluateRange(jobs, 0, jobs.size());
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,67 @@
+/**
+ * @brief AnimationEvaluator
+ */
+
+#ifndef RIGID3D_ANIMATION_EVALUATOR_HPP_
+#define RIGID3D_ANIMATION_EVALUATOR_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class AnimationClip;
+    class Skeleton;
+    class ThreadPool;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Samples, blends and skins the animations of many characters at once.
+     *
+     * Each \c Job poses one character and writes its skinning matrices straight
+     * into the caller's palette, typically a range reserved in a
+     * \c SkinningPalette or the input of a \c CpuSkinningBatch.  Jobs are
+     * independent, so they are spread across a \c ThreadPool when one is given.
+     *
+     * \code{.cpp}
+     *  for (Character & character : characters) {
+     *      AnimationEvaluator::Job job;
+     *      job.skeleton = &character.skeleton;
+     *      job.clip = character.walk;
+     *      job.time = character.time;
+     *      job.palette = character.palette.data();
+     *      jobs.push_back(job);
+     *  }
+     *  AnimationEvaluator::evaluate(jobs, &threadPool);
+     * \endcode
+     */
+    class AnimationEvaluator {
+    public:
+        struct Job {
+            const Skeleton * skeleton;
+            const AnimationClip * clip;
+            float time;
+
+            // Optional second clip, cross faded in by 'blendWeight'.
+            const AnimationClip * blendClip;
+            float blendTime;
+            float blendWeight;
+
+            bool loop;
+
+            // Receives one matrix per joint of 'skeleton'.
+            mat4 * palette;
+
+            Job();
+        };
+
+        static void evaluate(const std::vector<Job> & jobs,
+                             ThreadPool * threadPool = nullptr);
+    };
+
+}
+
+#endif /* RIGID3D_ANIMATION_EVALUATOR_HPP_ */
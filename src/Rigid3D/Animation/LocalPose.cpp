@@ -0,0 +1,305 @@
+#include "LocalPose.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cmath>
+#include <sstream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * Creates a pose with every joint at the identity transform.
+ */
+LocalPose::LocalPose(uint32 numJoints)
+    : numJoints(0),
+      paddedNumJoints(0) {
+    resize(numJoints);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Resets every joint to the identity transform.
+ */
+void LocalPose::resize(uint32 numJoints) {
+    this->numJoints = numJoints;
+    paddedNumJoints = (numJoints + 3) & ~3u;
+
+    components.assign(size_t(NumComponents) * paddedNumJoints, 0.0f);
+    const Component ones[] = {RotationW, ScaleX, ScaleY, ScaleZ};
+    for (Component c : ones) {
+        float * values = component(c);
+        for (uint32 i = 0; i < paddedNumJoints; ++i) {
+            values[i] = 1.0f;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+uint32 LocalPose::getNumJoints() const {
+    return numJoints;
+}
+
+//----------------------------------------------------------------------------------------
+void LocalPose::setJoint(uint32 joint, const vec3 & translation, const quat & rotation,
+                         const vec3 & scale) {
+    component(TranslationX)[joint] = translation.x;
+    component(TranslationY)[joint] = translation.y;
+    component(TranslationZ)[joint] = translation.z;
+    component(RotationX)[joint] = rotation.x;
+    component(RotationY)[joint] = rotation.y;
+    component(RotationZ)[joint] = rotation.z;
+    component(RotationW)[joint] = rotation.w;
+    component(ScaleX)[joint] = scale.x;
+    component(ScaleY)[joint] = scale.y;
+    component(ScaleZ)[joint] = scale.z;
+}
+
+//----------------------------------------------------------------------------------------
+vec3 LocalPose::getTranslation(uint32 joint) const {
+    return vec3(component(TranslationX)[joint], component(TranslationY)[joint],
+                component(TranslationZ)[joint]);
+}
+
+//----------------------------------------------------------------------------------------
+quat LocalPose::getRotation(uint32 joint) const {
+    return quat(component(RotationW)[joint], component(RotationX)[joint],
+                component(RotationY)[joint], component(RotationZ)[joint]);
+}
+
+//----------------------------------------------------------------------------------------
+vec3 LocalPose::getScale(uint32 joint) const {
+    return vec3(component(ScaleX)[joint], component(ScaleY)[joint],
+                component(ScaleZ)[joint]);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Interpolates between poses 'a' and 'b'.  Translations and scales are blended
+ * linearly, rotations by normalized linear interpolation along the shorter arc,
+ * which is close to slerp for the small angles between keyframes and much cheaper.
+ *
+ * @param weight - weight of 'b', in [0, 1].
+ * @param result - may be 'a' or 'b'.
+ */
+void LocalPose::blend(const LocalPose & a, const LocalPose & b, float weight,
+                      LocalPose & result) {
+    if (a.numJoints != b.numJoints) {
+        std::stringstream errorMessage;
+        errorMessage << "Cannot blend poses of " << a.numJoints << " and " << b.numJoints
+                     << " joints within method LocalPose::blend";
+        throw Rigid3DException(errorMessage.str());
+    }
+    if (result.numJoints != a.numJoints) {
+        result.resize(a.numJoints);
+    }
+
+    const uint32 count = a.paddedNumJoints;
+    const Component linear[] = {
+        TranslationX, TranslationY, TranslationZ, ScaleX, ScaleY, ScaleZ
+    };
+
+    const float * ax = a.component(RotationX);
+    const float * ay = a.component(RotationY);
+    const float * az = a.component(RotationZ);
+    const float * aw = a.component(RotationW);
+    const float * bx = b.component(RotationX);
+    const float * by = b.component(RotationY);
+    const float * bz = b.component(RotationZ);
+    const float * bw = b.component(RotationW);
+    float * rx = result.component(RotationX);
+    float * ry = result.component(RotationY);
+    float * rz = result.component(RotationZ);
+    float * rw = result.component(RotationW);
+
+#if defined(__SSE2__)
+    const __m128 w = _mm_set1_ps(weight);
+    const __m128 oneMinusW = _mm_set1_ps(1.0f - weight);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    for (Component c : linear) {
+        const float * va = a.component(c);
+        const float * vb = b.component(c);
+        float * vr = result.component(c);
+        for (uint32 i = 0; i < count; i += 4) {
+            __m128 x = _mm_loadu_ps(va + i);
+            __m128 y = _mm_loadu_ps(vb + i);
+            _mm_storeu_ps(vr + i, _mm_add_ps(x, _mm_mul_ps(_mm_sub_ps(y, x), w)));
+        }
+    }
+
+    for (uint32 i = 0; i < count; i += 4) {
+        __m128 qax = _mm_loadu_ps(ax + i);
+        __m128 qay = _mm_loadu_ps(ay + i);
+        __m128 qaz = _mm_loadu_ps(az + i);
+        __m128 qaw = _mm_loadu_ps(aw + i);
+        __m128 qbx = _mm_loadu_ps(bx + i);
+        __m128 qby = _mm_loadu_ps(by + i);
+        __m128 qbz = _mm_loadu_ps(bz + i);
+        __m128 qbw = _mm_loadu_ps(bw + i);
+
+        // Negate the weight of 'b' where it lies in the opposite hemisphere.
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qax, qbx), _mm_mul_ps(qay, qby)),
+                                _mm_add_ps(_mm_mul_ps(qaz, qbz), _mm_mul_ps(qaw, qbw)));
+        __m128 wb = _mm_xor_ps(w, _mm_and_ps(_mm_cmplt_ps(dot, zero), signBit));
+
+        __m128 qx = _mm_add_ps(_mm_mul_ps(qax, oneMinusW), _mm_mul_ps(qbx, wb));
+        __m128 qy = _mm_add_ps(_mm_mul_ps(qay, oneMinusW), _mm_mul_ps(qby, wb));
+        __m128 qz = _mm_add_ps(_mm_mul_ps(qaz, oneMinusW), _mm_mul_ps(qbz, wb));
+        __m128 qw = _mm_add_ps(_mm_mul_ps(qaw, oneMinusW), _mm_mul_ps(qbw, wb));
+
+        __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)),
+                                          _mm_add_ps(_mm_mul_ps(qz, qz), _mm_mul_ps(qw, qw)));
+        __m128 inverseLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+
+        _mm_storeu_ps(rx + i, _mm_mul_ps(qx, inverseLength));
+        _mm_storeu_ps(ry + i, _mm_mul_ps(qy, inverseLength));
+        _mm_storeu_ps(rz + i, _mm_mul_ps(qz, inverseLength));
+        _mm_storeu_ps(rw + i, _mm_mul_ps(qw, inverseLength));
+    }
+#else
+    for (Component c : linear) {
+        const float * va = a.component(c);
+        const float * vb = b.component(c);
+        float * vr = result.component(c);
+        for (uint32 i = 0; i < count; ++i) {
+            vr[i] = va[i] + (vb[i] - va[i]) * weight;
+        }
+    }
+
+    for (uint32 i = 0; i < count; ++i) {
+        float dot = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i] + aw[i] * bw[i];
+        float wb = (dot < 0.0f) ? -weight : weight;
+        float qx = ax[i] * (1.0f - weight) + bx[i] * wb;
+        float qy = ay[i] * (1.0f - weight) + by[i] * wb;
+        float qz = az[i] * (1.0f - weight) + bz[i] * wb;
+        float qw = aw[i] * (1.0f - weight) + bw[i] * wb;
+        float inverseLength = 1.0f / std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+        rx[i] = qx * inverseLength;
+        ry[i] = qy * inverseLength;
+        rz[i] = qz * inverseLength;
+        rw[i] = qw * inverseLength;
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes the transform of each joint relative to its parent, translation *
+ * rotation * scale, to 'matrices', which must hold \c getNumJoints() matrices.
+ */
+void LocalPose::toMatrices(mat4 * matrices) const {
+    const float * tx = component(TranslationX);
+    const float * ty = component(TranslationY);
+    const float * tz = component(TranslationZ);
+    const float * qx = component(RotationX);
+    const float * qy = component(RotationY);
+    const float * qz = component(RotationZ);
+    const float * qw = component(RotationW);
+    const float * sx = component(ScaleX);
+    const float * sy = component(ScaleY);
+    const float * sz = component(ScaleZ);
+
+#if defined(__SSE2__)
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    for (uint32 i = 0; i < numJoints; i += 4) {
+        __m128 x = _mm_loadu_ps(qx + i);
+        __m128 y = _mm_loadu_ps(qy + i);
+        __m128 z = _mm_loadu_ps(qz + i);
+        __m128 w = _mm_loadu_ps(qw + i);
+
+        __m128 x2 = _mm_mul_ps(x, two);
+        __m128 y2 = _mm_mul_ps(y, two);
+        __m128 z2 = _mm_mul_ps(z, two);
+        __m128 xx = _mm_mul_ps(x, x2);
+        __m128 yy = _mm_mul_ps(y, y2);
+        __m128 zz = _mm_mul_ps(z, z2);
+        __m128 xy = _mm_mul_ps(x, y2);
+        __m128 xz = _mm_mul_ps(x, z2);
+        __m128 yz = _mm_mul_ps(y, z2);
+        __m128 wx = _mm_mul_ps(w, x2);
+        __m128 wy = _mm_mul_ps(w, y2);
+        __m128 wz = _mm_mul_ps(w, z2);
+
+        __m128 scaleX = _mm_loadu_ps(sx + i);
+        __m128 scaleY = _mm_loadu_ps(sy + i);
+        __m128 scaleZ = _mm_loadu_ps(sz + i);
+
+        // Rows of each column, four joints per register.
+        __m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), scaleX);
+        __m128 c0y = _mm_mul_ps(_mm_add_ps(xy, wz), scaleX);
+        __m128 c0z = _mm_mul_ps(_mm_sub_ps(xz, wy), scaleX);
+        __m128 c0w = _mm_setzero_ps();
+
+        __m128 c1x = _mm_mul_ps(_mm_sub_ps(xy, wz), scaleY);
+        __m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), scaleY);
+        __m128 c1z = _mm_mul_ps(_mm_add_ps(yz, wx), scaleY);
+        __m128 c1w = _mm_setzero_ps();
+
+        __m128 c2x = _mm_mul_ps(_mm_add_ps(xz, wy), scaleZ);
+        __m128 c2y = _mm_mul_ps(_mm_sub_ps(yz, wx), scaleZ);
+        __m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), scaleZ);
+        __m128 c2w = _mm_setzero_ps();
+
+        __m128 c3x = _mm_loadu_ps(tx + i);
+        __m128 c3y = _mm_loadu_ps(ty + i);
+        __m128 c3z = _mm_loadu_ps(tz + i);
+        __m128 c3w = one;
+
+        // Transpose so each register holds one column of one joint.
+        _MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+        _MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+        _MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+        _MM_TRANSPOSE4_PS(c3x, c3y, c3z, c3w);
+
+        const __m128 columns[4][4] = {
+            {c0x, c1x, c2x, c3x},
+            {c0y, c1y, c2y, c3y},
+            {c0z, c1z, c2z, c3z},
+            {c0w, c1w, c2w, c3w}
+        };
+        const uint32 numInGroup = (numJoints - i < 4) ? numJoints - i : 4;
+        for (uint32 j = 0; j < numInGroup; ++j) {
+            float * m = glm::value_ptr(matrices[i + j]);
+            _mm_storeu_ps(m, columns[j][0]);
+            _mm_storeu_ps(m + 4, columns[j][1]);
+            _mm_storeu_ps(m + 8, columns[j][2]);
+            _mm_storeu_ps(m + 12, columns[j][3]);
+        }
+    }
+#else
+    for (uint32 i = 0; i < numJoints; ++i) {
+        float xx = qx[i] * qx[i] * 2.0f, yy = qy[i] * qy[i] * 2.0f, zz = qz[i] * qz[i] * 2.0f;
+        float xy = qx[i] * qy[i] * 2.0f, xz = qx[i] * qz[i] * 2.0f, yz = qy[i] * qz[i] * 2.0f;
+        float wx = qw[i] * qx[i] * 2.0f, wy = qw[i] * qy[i] * 2.0f, wz = qw[i] * qz[i] * 2.0f;
+
+        mat4 & m = matrices[i];
+        m[0] = vec4((1.0f - (yy + zz)) * sx[i], (xy + wz) * sx[i], (xz - wy) * sx[i], 0.0f);
+        m[1] = vec4((xy - wz) * sy[i], (1.0f - (xx + zz)) * sy[i], (yz + wx) * sy[i], 0.0f);
+        m[2] = vec4((xz + wy) * sz[i], (yz - wx) * sz[i], (1.0f - (xx + yy)) * sz[i], 0.0f);
+        m[3] = vec4(tx[i], ty[i], tz[i], 1.0f);
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+float * LocalPose::component(Component c) {
+    return components.data() + size_t(c) * paddedNumJoints;
+}
+
+//----------------------------------------------------------------------------------------
+const float * LocalPose::component(Component c) const {
+    return components.data() + size_t(c) * paddedNumJoints;
+}
+
+} // end namespace Rigid3D
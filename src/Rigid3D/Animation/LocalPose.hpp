@@ -0,0 +1,64 @@
+/**
+ * @brief LocalPose
+ */
+
+#ifndef RIGID3D_LOCAL_POSE_HPP_
+#define RIGID3D_LOCAL_POSE_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Translation, rotation and scale of each joint of a skeleton relative
+     * to its parent.
+     *
+     * Joints are stored as structure of arrays, one array per component, padded to
+     * a multiple of four joints.  Blending and conversion to matrices then handle
+     * four joints per SSE instruction.
+     */
+    class LocalPose {
+    public:
+        explicit LocalPose(uint32 numJoints = 0);
+
+        void resize(uint32 numJoints);
+
+        uint32 getNumJoints() const;
+
+        void setJoint(uint32 joint, const vec3 & translation, const quat & rotation,
+                      const vec3 & scale = vec3(1.0f));
+
+        vec3 getTranslation(uint32 joint) const;
+
+        quat getRotation(uint32 joint) const;
+
+        vec3 getScale(uint32 joint) const;
+
+        static void blend(const LocalPose & a, const LocalPose & b, float weight,
+                          LocalPose & result);
+
+        void toMatrices(mat4 * matrices) const;
+
+    private:
+        enum Component {
+            TranslationX, TranslationY, TranslationZ,
+            RotationX, RotationY, RotationZ, RotationW,
+            ScaleX, ScaleY, ScaleZ,
+            NumComponents
+        };
+
+        float * component(Component c);
+        const float * component(Component c) const;
+
+        uint32 numJoints;
+        uint32 paddedNumJoints;
+
+        // NumComponents arrays of paddedNumJoints floats.
+        std::vector<float> components;
+    };
+
+}
+
+#endif /* RIGID3D_LOCAL_POSE_HPP_ */
@@ -0,0 +1,119 @@
+#include "Skeleton.hpp"
+
+#include <Rigid3D/Animation/LocalPose.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Math/SimdMatrix.hpp>
+
+#include <sstream>
+
+namespace Rigid3D {
+
+/**
+ * Size of the matrix palette in SkinnedMesh.vert.
+ */
+const uint32 Skeleton::MaxJoints = 128;
+
+const int32 Skeleton::NoParent = -1;
+
+//----------------------------------------------------------------------------------------
+Skeleton::Skeleton() {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Appends a joint to the hierarchy.
+ *
+ * @param parent - index of an earlier joint, or \c NoParent for a root.
+ * @param inverseBindMatrix - inverse of the joint's model space transform in the
+ * bind pose.
+ *
+ * @return index of the new joint.
+ */
+uint32 Skeleton::addJoint(const std::string & name, int32 parent,
+                          const mat4 & inverseBindMatrix) {
+    const uint32 joint = uint32(parents.size());
+    if (joint >= MaxJoints) {
+        std::stringstream errorMessage;
+        errorMessage << "Skeleton already has the maximum of " << MaxJoints
+                     << " joints within method Skeleton::addJoint";
+        throw Rigid3DException(errorMessage.str());
+    }
+    if (parent < NoParent || parent >= int32(joint)) {
+        std::stringstream errorMessage;
+        errorMessage << "Parent " << parent << " of joint '" << name
+                     << "' must be an earlier joint within method Skeleton::addJoint";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    names.push_back(name);
+    parents.push_back(parent);
+    inverseBindMatrices.push_back(inverseBindMatrix);
+
+    return joint;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 Skeleton::getNumJoints() const {
+    return uint32(parents.size());
+}
+
+//----------------------------------------------------------------------------------------
+int32 Skeleton::getParent(uint32 joint) const {
+    return parents[joint];
+}
+
+//----------------------------------------------------------------------------------------
+const std::string & Skeleton::getJointName(uint32 joint) const {
+    return names[joint];
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return index of the joint called 'name', or -1 if there is none.
+ */
+int32 Skeleton::findJoint(const std::string & name) const {
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) {
+            return int32(i);
+        }
+    }
+    return -1;
+}
+
+//----------------------------------------------------------------------------------------
+const mat4 & Skeleton::getInverseBindMatrix(uint32 joint) const {
+    return inverseBindMatrices[joint];
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Converts 'pose' to one skinning matrix per joint, global transform *
+ * inverse bind matrix.
+ *
+ * @param palette - receives \c getNumJoints() matrices.
+ */
+void Skeleton::computeSkinningMatrices(const LocalPose & pose, mat4 * palette) const {
+    const uint32 numJoints = getNumJoints();
+    if (pose.getNumJoints() != numJoints) {
+        std::stringstream errorMessage;
+        errorMessage << "Pose has " << pose.getNumJoints() << " joints, skeleton has "
+                     << numJoints << " within method Skeleton::computeSkinningMatrices";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    pose.toMatrices(palette);
+
+    // Parents precede children, so each parent is already global when it is read.
+    for (uint32 i = 0; i < numJoints; ++i) {
+        if (parents[i] != NoParent) {
+            multiplyMatrices(palette[parents[i]], palette[i], palette[i]);
+        }
+    }
+
+    for (uint32 i = 0; i < numJoints; ++i) {
+        multiplyMatrices(palette[i], inverseBindMatrices[i], palette[i]);
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,64 @@
+/**
+ * @brief Skeleton
+ */
+
+#ifndef RIGID3D_SKELETON_HPP_
+#define RIGID3D_SKELETON_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <string>
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class LocalPose;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Joint hierarchy of a skinned mesh.
+     *
+     * Joints are stored parents first, so that a single pass over the joints
+     * resolves every global transform.  Skinning matrices map a vertex from bind
+     * pose model space to the posed model space, and are laid out to be uploaded
+     * as a matrix palette unchanged.
+     *
+     * \code{.cpp}
+     *  clip.sample(time, true, pose);
+     *  skeleton.computeSkinningMatrices(pose, palette.data());
+     * \endcode
+     */
+    class Skeleton {
+    public:
+        Skeleton();
+
+        uint32 addJoint(const std::string & name, int32 parent,
+                        const mat4 & inverseBindMatrix);
+
+        uint32 getNumJoints() const;
+
+        int32 getParent(uint32 joint) const;
+
+        const std::string & getJointName(uint32 joint) const;
+
+        int32 findJoint(const std::string & name) const;
+
+        const mat4 & getInverseBindMatrix(uint32 joint) const;
+
+        void computeSkinningMatrices(const LocalPose & pose, mat4 * palette) const;
+
+        static const uint32 MaxJoints;
+
+        static const int32 NoParent;
+
+    private:
+        std::vector<std::string> names;
+        std::vector<int32> parents;
+        std::vector<mat4> inverseBindMatrices;
+    };
+
+}
+
+#endif /* RIGID3D_SKELETON_HPP_ */
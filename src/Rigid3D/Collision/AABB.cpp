@@ -78,4 +78,31 @@ vec3 AABB::getCenter() const {
     return (minBounds + maxBounds) * 0.5f;
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Computes the smallest AABB enclosing this box after it is transformed by the
+ * affine matrix 'transform'.
+ *
+ * @param transform - affine transformation, such as a model matrix.
+ * @return the transformed bounding box.
+ */
+AABB AABB::getTransformed(const mat4 & transform) const {
+    // Transform the center, then accumulate the extents of each transformed half axis.
+    vec3 center = getCenter();
+    vec3 halfExtents = (maxBounds - minBounds) * 0.5f;
+
+    vec3 newCenter = vec3(transform * vec4(center, 1.0f));
+    vec3 newHalfExtents(0.0f);
+    for (int col = 0; col < 3; ++col) {
+        for (int row = 0; row < 3; ++row) {
+            newHalfExtents[row] += fabs(transform[col][row]) * halfExtents[col];
+        }
+    }
+
+    AABB result;
+    result.minBounds = newCenter - newHalfExtents;
+    result.maxBounds = newCenter + newHalfExtents;
+    return result;
+}
+
 } // end namespace Rigid3D
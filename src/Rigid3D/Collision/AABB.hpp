@@ -21,6 +21,8 @@ namespace Rigid3D {
         bool rayCast(const RayCastInput & input, RayCastOutput * output) const;
 
         vec3 getCenter() const;
+
+        AABB getTransformed(const mat4 & transform) const;
     };
 
 }
@@ -0,0 +1,94 @@
+// FrustumPlanes.cpp
+#include "FrustumPlanes.hpp"
+#include "AABB.hpp"
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+FrustumPlanes::FrustumPlanes() {
+    // Default planes accept everything.
+    for (int i = 0; i < NumPlanes; ++i) {
+        planes[i] = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+FrustumPlanes::FrustumPlanes(const mat4 & viewProjectionMatrix) {
+    set(viewProjectionMatrix);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Extracts the clipping planes from 'viewProjectionMatrix'.  Planes are in world
+ * space when given projection * view, or in eye space when given only a
+ * projection matrix.
+ */
+void FrustumPlanes::set(const mat4 & viewProjectionMatrix) {
+    const mat4 & m = viewProjectionMatrix;
+
+    // Rows of the matrix, glm matrices being column major.
+    vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[Left]   = row3 + row0;
+    planes[Right]  = row3 - row0;
+    planes[Bottom] = row3 + row1;
+    planes[Top]    = row3 - row1;
+    planes[Near]   = row3 + row2;
+    planes[Far]    = row3 - row2;
+
+    for (int i = 0; i < NumPlanes; ++i) {
+        float length = glm::length(vec3(planes[i]));
+        if (length > 0.0f) {
+            planes[i] /= length;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+const vec4 & FrustumPlanes::getPlane(Plane plane) const {
+    return planes[plane];
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Conservative AABB test.  May return true for some boxes lying just outside a
+ * corner of the view volume, but never returns false for a visible box.
+ *
+ * @return false if 'box' is entirely outside one of the planes.
+ */
+bool FrustumPlanes::intersects(const AABB & box) const {
+    for (int i = 0; i < NumPlanes; ++i) {
+        const vec4 & p = planes[i];
+
+        // Box corner farthest along the plane normal.
+        vec3 positive(p.x >= 0.0f ? box.maxBounds.x : box.minBounds.x,
+                      p.y >= 0.0f ? box.maxBounds.y : box.minBounds.y,
+                      p.z >= 0.0f ? box.maxBounds.z : box.minBounds.z);
+
+        if (glm::dot(vec3(p), positive) + p.w < 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return false if the sphere is entirely outside one of the planes.
+ */
+bool FrustumPlanes::intersectsSphere(const vec3 & center, float radius) const {
+    for (int i = 0; i < NumPlanes; ++i) {
+        const vec4 & p = planes[i];
+        if (glm::dot(vec3(p), center) + p.w < -radius) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // end namespace Rigid3D
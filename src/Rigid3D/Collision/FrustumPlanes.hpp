@@ -0,0 +1,52 @@
+#ifndef RIGID3D_FRUSTUM_PLANES_HPP_
+#define RIGID3D_FRUSTUM_PLANES_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+//Forward Declarations.
+namespace Rigid3D {
+    struct AABB;
+}
+
+namespace Rigid3D {
+
+    /**
+     * The six clipping planes of a view volume, extracted from a combined
+     * projection * view matrix.  Used for culling bounding volumes before they are
+     * submitted for rendering.
+     *
+     * Each plane is stored as (a, b, c, d) with unit normal (a, b, c) pointing
+     * into the view volume, so a point p is inside when dot(n, p) + d >= 0 for
+     * every plane.
+     */
+    class FrustumPlanes {
+    public:
+        enum Plane {
+            Left = 0,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            NumPlanes
+        };
+
+        FrustumPlanes();
+
+        explicit FrustumPlanes(const mat4 & viewProjectionMatrix);
+
+        void set(const mat4 & viewProjectionMatrix);
+
+        const vec4 & getPlane(Plane plane) const;
+
+        bool intersects(const AABB & box) const;
+
+        bool intersectsSphere(const vec3 & center, float radius) const;
+
+    private:
+        vec4 planes[NumPlanes];
+    };
+
+}
+
+#endif /* RIGID3D_FRUSTUM_PLANES_HPP_ */
@@ -0,0 +1,349 @@
+#include "AssetPack.hpp"
+
+#include <Rigid3D/Common/Lz4.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <cstring>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Rigid3D {
+
+namespace {
+
+    const char magic[4] = {'R', '3', 'D', 'P'};
+
+    //------------------------------------------------------------------------------------
+    // Skips any leading "./" of a path.
+    const char * skipCurrentDirectory(const char * path) {
+        while (path[0] == '.' && (path[1] == '/' || path[1] == '\\')) {
+            path += 2;
+        }
+        return path;
+    }
+
+    //------------------------------------------------------------------------------------
+    inline char normalizeSeparator(char c) {
+        return (c == '\\') ? '/' : c;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Compares a path, normalized on the fly, with one stored in the string table.
+    bool pathEquals(const char * path, const char * storedPath, uint32 storedLength) {
+        path = skipCurrentDirectory(path);
+        for (uint32 i = 0; i < storedLength; ++i) {
+            if (path[i] == '\0' || normalizeSeparator(path[i]) != storedPath[i]) {
+                return false;
+            }
+        }
+        return path[storedLength] == '\0';
+    }
+
+} // end anonymous namespace
+
+const uint32 AssetPack::version;
+const uint32 AssetPack::Alignment;
+const uint32 AssetPack::CompressedFlag;
+
+//----------------------------------------------------------------------------------------
+AssetPack::Entry::Entry()
+    : data(NULL),
+      storedSize(0),
+      size(0),
+      compressed(false),
+      path(NULL),
+      pathLength(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+AssetPack::AssetPack()
+    : mapping(NULL),
+      mappingSize(0),
+      toc(NULL),
+      stringTable(NULL),
+      numEntries(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+AssetPack::AssetPack(const char * filePath)
+    : mapping(NULL),
+      mappingSize(0),
+      toc(NULL),
+      stringTable(NULL),
+      numEntries(0) {
+    open(filePath);
+}
+
+//----------------------------------------------------------------------------------------
+AssetPack::~AssetPack() {
+    close();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Maps the pack file at 'filePath' into memory, closing any pack already open.
+ *
+ * Only the header and table of contents are validated, so opening is independent
+ * of the amount of asset data.  Pages of asset data are read on first access.
+ */
+void AssetPack::open(const char * filePath) {
+    close();
+
+    int fileDescriptor = ::open(filePath, O_RDONLY);
+    if (fileDescriptor < 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to open asset pack " << filePath
+                     << " within method AssetPack::open";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size < off_t(sizeof(Header))) {
+        ::close(fileDescriptor);
+        std::stringstream errorMessage;
+        errorMessage << filePath << " is not a supported asset pack"
+                     << " within method AssetPack::open";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    void * address = mmap(NULL, size_t(fileStatus.st_size), PROT_READ, MAP_PRIVATE,
+            fileDescriptor, 0);
+    // The mapping keeps the file referenced.
+    ::close(fileDescriptor);
+    if (address == MAP_FAILED) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to map asset pack " << filePath
+                     << " within method AssetPack::open";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    this->filePath = filePath;
+    mapping = static_cast<const uint8 *>(address);
+    mappingSize = size_t(fileStatus.st_size);
+
+    try {
+        validate();
+    } catch (...) {
+        close();
+        throw;
+    }
+
+    const Header * header = reinterpret_cast<const Header *>(mapping);
+    numEntries = header->numEntries;
+    toc = reinterpret_cast<const TocEntry *>(mapping + header->tocOffset);
+    stringTable = reinterpret_cast<const char *>(mapping + header->stringTableOffset);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Unmaps the pack.  Pointers obtained from it become invalid.
+ */
+void AssetPack::close() {
+    if (mapping != NULL) {
+        munmap(const_cast<uint8 *>(mapping), mappingSize);
+    }
+    filePath.clear();
+    mapping = NULL;
+    mappingSize = 0;
+    toc = NULL;
+    stringTable = NULL;
+    numEntries = 0;
+}
+
+//----------------------------------------------------------------------------------------
+bool AssetPack::isOpen() const {
+    return mapping != NULL;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Looks up the asset at 'path' without copying or allocating.
+ *
+ * @return false if the pack has no such asset.
+ */
+bool AssetPack::find(const char * path, Entry & entry) const {
+    const uint64 hash = hashPath(path);
+
+    // Lower bound of 'hash' within the sorted table of contents.
+    uint32 first = 0;
+    uint32 count = numEntries;
+    while (count > 0) {
+        const uint32 step = count / 2;
+        if (toc[first + step].pathHash < hash) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+
+    // Paths sharing a hash are adjacent.
+    for (uint32 i = first; i < numEntries && toc[i].pathHash == hash; ++i) {
+        if (pathEquals(path, stringTable + toc[i].pathOffset, toc[i].pathLength)) {
+            entry = makeEntry(toc[i]);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------------------------------
+bool AssetPack::contains(const char * path) const {
+    Entry entry;
+    return find(path, entry);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies the asset at 'path' into 'data', decompressing it if needed.
+ *
+ * @throws Rigid3DException if the pack has no such asset.
+ */
+void AssetPack::read(const char * path, std::vector<uint8> & data) const {
+    Entry entry;
+    if (!find(path, entry)) {
+        std::stringstream errorMessage;
+        errorMessage << "Asset " << path << " not found in pack " << filePath
+                     << " within method AssetPack::read";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    data.resize(size_t(entry.size));
+    decompress(entry, data.data());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes the contents of 'entry' to 'output', which must hold \c entry.size bytes.
+ * Uncompressed entries are copied.
+ */
+void AssetPack::decompress(const Entry & entry, uint8 * output) const {
+    if (entry.compressed) {
+        Lz4::decompress(entry.data, size_t(entry.storedSize), output, size_t(entry.size));
+    } else if (entry.size > 0) {
+        std::memcpy(output, entry.data, size_t(entry.size));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Asks the kernel to start reading the pages of 'entry' into the page cache,
+ * without waiting for them.
+ */
+void AssetPack::prefetch(const Entry & entry) const {
+    if (entry.storedSize == 0) {
+        return;
+    }
+
+    // madvise requires a page aligned address, and pages may be larger than the
+    // alignment of entries.
+    const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+    const size_t offset = size_t(entry.data - mapping);
+    const size_t begin = offset - offset % pageSize;
+    const size_t end = offset + size_t(entry.storedSize);
+    madvise(const_cast<uint8 *>(mapping) + begin, end - begin, MADV_WILLNEED);
+}
+
+//----------------------------------------------------------------------------------------
+uint32 AssetPack::getNumEntries() const {
+    return numEntries;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the entry at 'index', entries being ordered by path hash.
+ */
+AssetPack::Entry AssetPack::getEntry(uint32 index) const {
+    if (index >= numEntries) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid entry index " << index
+                     << " within method AssetPack::getEntry";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    return makeEntry(toc[index]);
+}
+
+//----------------------------------------------------------------------------------------
+const std::string & AssetPack::getFilePath() const {
+    return filePath;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return 64-bit FNV-1a hash of the normalized form of 'path'.
+ */
+uint64 AssetPack::hashPath(const char * path) {
+    uint64 hash = 14695981039346656037ull;
+    for (const char * c = skipCurrentDirectory(path); *c != '\0'; ++c) {
+        hash ^= uint8(normalizeSeparator(*c));
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return 'path' with any leading "./" removed and backslashes replaced by forward
+ * slashes, as stored within packs.
+ */
+std::string AssetPack::normalizePath(const char * path) {
+    std::string normalized(skipCurrentDirectory(path));
+    for (char & c : normalized) {
+        c = normalizeSeparator(c);
+    }
+    return normalized;
+}
+
+//----------------------------------------------------------------------------------------
+void AssetPack::validate() const {
+    const Header * header = reinterpret_cast<const Header *>(mapping);
+
+    const uint64 tocBytes = uint64(header->numEntries) * sizeof(TocEntry);
+    bool valid = std::memcmp(header->magic, magic, 4) == 0 &&
+            header->version >= 1 && header->version <= version &&
+            header->tocOffset % 8 == 0 &&
+            header->tocOffset <= mappingSize &&
+            tocBytes <= mappingSize - header->tocOffset &&
+            header->stringTableOffset <= mappingSize &&
+            header->stringTableSize <= mappingSize - header->stringTableOffset;
+
+    const TocEntry * entries = reinterpret_cast<const TocEntry *>(mapping + header->tocOffset);
+    for (uint32 i = 0; valid && i < header->numEntries; ++i) {
+        const TocEntry & entry = entries[i];
+        valid = entry.offset <= mappingSize &&
+                entry.storedSize <= mappingSize - entry.offset &&
+                uint64(entry.pathOffset) + entry.pathLength <= header->stringTableSize &&
+                (i == 0 || entries[i - 1].pathHash <= entry.pathHash) &&
+                ((entry.flags & CompressedFlag) != 0 || entry.storedSize == entry.size);
+    }
+
+    if (!valid) {
+        std::stringstream errorMessage;
+        errorMessage << filePath << " is not a supported asset pack or is corrupt"
+                     << " within method AssetPack::open";
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+AssetPack::Entry AssetPack::makeEntry(const TocEntry & tocEntry) const {
+    Entry entry;
+    entry.data = mapping + tocEntry.offset;
+    entry.storedSize = tocEntry.storedSize;
+    entry.size = tocEntry.size;
+    entry.compressed = (tocEntry.flags & CompressedFlag) != 0;
+    entry.path = stringTable + tocEntry.pathOffset;
+    entry.pathLength = tocEntry.pathLength;
+
+    return entry;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,137 @@
+/**
+ * @brief AssetPack
+ */
+
+#ifndef RIGID3D_ASSET_PACK_HPP_
+#define RIGID3D_ASSET_PACK_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Read only view of a single file archive of assets, memory mapped so
+     * that uncompressed assets are used in place without copying.
+     *
+     * A pack file holds:
+     * # A 32 byte header: magic "R3DP", version, entry count, string table size,
+     *   and the offsets of the table of contents and string table.
+     * # The table of contents, one 48 byte record per asset sorted by the 64-bit
+     *   FNV-1a hash of its path, so lookups are a binary search.
+     * # A string table of asset paths, used to confirm lookups and for listing.
+     * # Asset data, each entry starting on a 4 KB boundary so that it is page
+     *   aligned within the mapping.  Entries are stored raw or as one LZ4 block.
+     *
+     * Paths are relative to the directory the pack was built from, use forward
+     * slashes, and are matched exactly apart from a leading "./" and backslashes,
+     * which are normalized.
+     *
+     * \code{.cpp}
+     *  AssetPack pack("data.pack");
+     *  AssetPack::Entry entry;
+     *  if (pack.find("shaders/PerFragLighting.frag", entry) && !entry.compressed) {
+     *      compile(reinterpret_cast<const char *>(entry.data), entry.size);
+     *  }
+     *
+     *  std::vector<uint8> texture;
+     *  pack.read("textures/uvgrid.png", texture);
+     * \endcode
+     *
+     * @see AssetPackWriter
+     */
+    class AssetPack {
+    public:
+        static const uint32 version = 1;
+        static const uint32 Alignment = 4096;
+        static const uint32 CompressedFlag = 1;
+
+        struct Entry {
+            const uint8 * data;     // Stored bytes, within the mapping.
+            uint64 storedSize;
+            uint64 size;            // Size once decompressed.
+            bool compressed;
+            const char * path;      // Not null terminated.
+            uint32 pathLength;
+
+            Entry();
+        };
+
+        AssetPack();
+
+        explicit AssetPack(const char * filePath);
+
+        ~AssetPack();
+
+        void open(const char * filePath);
+
+        void close();
+
+        bool isOpen() const;
+
+        bool find(const char * path, Entry & entry) const;
+
+        bool contains(const char * path) const;
+
+        void read(const char * path, std::vector<uint8> & data) const;
+
+        void decompress(const Entry & entry, uint8 * output) const;
+
+        void prefetch(const Entry & entry) const;
+
+        uint32 getNumEntries() const;
+
+        Entry getEntry(uint32 index) const;
+
+        const std::string & getFilePath() const;
+
+        static uint64 hashPath(const char * path);
+
+        static std::string normalizePath(const char * path);
+
+    private:
+        // Non-copyable, owns the file mapping.
+        AssetPack(const AssetPack &);
+        AssetPack & operator = (const AssetPack &);
+
+        // On disk layouts, see AssetPackWriter.
+        struct Header {
+            char magic[4];
+            uint32 version;
+            uint32 numEntries;
+            uint32 stringTableSize;
+            uint64 tocOffset;
+            uint64 stringTableOffset;
+        };
+
+        struct TocEntry {
+            uint64 pathHash;
+            uint64 offset;
+            uint64 storedSize;
+            uint64 size;
+            uint32 pathOffset;
+            uint32 pathLength;
+            uint32 flags;
+            uint32 padding;
+        };
+
+        friend class AssetPackWriter;
+
+        void validate() const;
+
+        Entry makeEntry(const TocEntry & tocEntry) const;
+
+        std::string filePath;
+        const uint8 * mapping;
+        size_t mappingSize;
+        const TocEntry * toc;
+        const char * stringTable;
+        uint32 numEntries;
+    };
+
+}
+
+#endif /* RIGID3D_ASSET_PACK_HPP_ */
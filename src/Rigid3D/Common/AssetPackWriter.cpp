@@ -0,0 +1,199 @@
+#include "AssetPackWriter.hpp"
+
+#include <Rigid3D/Common/AssetPack.hpp>
+#include <Rigid3D/Common/Lz4.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+AssetPackWriter::AssetPackWriter() {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies 'size' bytes of 'data' to be stored under 'path'.
+ *
+ * @param compress - try LZ4 compression for this asset.
+ *
+ * @return true if the asset is stored compressed.
+ */
+bool AssetPackWriter::add(const char * path, const void * data, size_t size, bool compress) {
+    PendingEntry entry;
+    entry.path = AssetPack::normalizePath(path);
+    entry.pathHash = AssetPack::hashPath(entry.path.c_str());
+    entry.size = size;
+    entry.compressed = false;
+
+    const uint8 * bytes = static_cast<const uint8 *>(data);
+    if (compress && size > 0) {
+        entry.data.resize(Lz4::compressBound(size));
+        const size_t compressedSize = Lz4::compress(bytes, size, entry.data.data(),
+                entry.data.size());
+        if (compressedSize > 0 && compressedSize <= size - size / 8) {
+            entry.data.resize(compressedSize);
+            entry.data.shrink_to_fit();
+            entry.compressed = true;
+        }
+    }
+    if (!entry.compressed) {
+        entry.data.assign(bytes, bytes + size);
+    }
+
+    entries.push_back(std::move(entry));
+
+    return entries.back().compressed;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reads the file at 'filePath' and adds its contents under 'path'.
+ *
+ * @return true if the asset is stored compressed.
+ */
+bool AssetPackWriter::addFile(const char * path, const char * filePath, bool compress) {
+    std::ifstream in(filePath, std::ios::in | std::ios::binary);
+    if (!in) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to open file " << filePath
+                     << " within method AssetPackWriter::addFile";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    std::vector<char> contents((std::istreambuf_iterator<char>(in)),
+            std::istreambuf_iterator<char>());
+
+    return add(path, contents.data(), contents.size(), compress);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes every added asset to a pack file at 'filePath'.
+ *
+ * @throws Rigid3DException if a path was added twice, or on I/O failure.
+ */
+void AssetPackWriter::write(const char * filePath) const {
+    std::vector<const PendingEntry *> sorted;
+    for (const PendingEntry & entry : entries) {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+            [](const PendingEntry * a, const PendingEntry * b) {
+                return (a->pathHash != b->pathHash) ? a->pathHash < b->pathHash
+                                                    : a->path < b->path;
+            });
+
+    // Equal paths are adjacent once sorted.
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        if (sorted[i]->path == sorted[i - 1]->path) {
+            std::stringstream errorMessage;
+            errorMessage << "Asset " << sorted[i]->path << " was added more than once"
+                         << " within method AssetPackWriter::write";
+            throw Rigid3DException(errorMessage.str());
+        }
+    }
+
+    std::string stringTable;
+    std::vector<AssetPack::TocEntry> toc(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        toc[i].pathHash = sorted[i]->pathHash;
+        toc[i].storedSize = sorted[i]->data.size();
+        toc[i].size = sorted[i]->size;
+        toc[i].pathOffset = uint32(stringTable.size());
+        toc[i].pathLength = uint32(sorted[i]->path.size());
+        toc[i].flags = sorted[i]->compressed ? AssetPack::CompressedFlag : 0;
+        toc[i].padding = 0;
+        stringTable += sorted[i]->path;
+    }
+
+    AssetPack::Header header;
+    std::memcpy(header.magic, "R3DP", 4);
+    header.version = AssetPack::version;
+    header.numEntries = uint32(toc.size());
+    header.stringTableSize = uint32(stringTable.size());
+    header.tocOffset = sizeof(AssetPack::Header);
+    header.stringTableOffset = header.tocOffset + toc.size() * sizeof(AssetPack::TocEntry);
+
+    // Entries follow on page boundaries, in table of contents order.  Empty entries
+    // are not aligned, so they never point past the end of the file.
+    uint64 offset = header.stringTableOffset + stringTable.size();
+    for (AssetPack::TocEntry & entry : toc) {
+        if (entry.storedSize > 0) {
+            offset = (offset + AssetPack::Alignment - 1) / AssetPack::Alignment *
+                    AssetPack::Alignment;
+        }
+        entry.offset = offset;
+        offset += entry.storedSize;
+    }
+
+    std::ofstream out(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to open file " << filePath
+                     << " for writing within method AssetPackWriter::write";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!toc.empty()) {
+        out.write(reinterpret_cast<const char *>(toc.data()),
+                toc.size() * sizeof(AssetPack::TocEntry));
+    }
+    out.write(stringTable.data(), stringTable.size());
+
+    uint64 position = header.stringTableOffset + stringTable.size();
+    const std::vector<char> padding(AssetPack::Alignment, 0);
+    for (size_t i = 0; i < toc.size(); ++i) {
+        out.write(padding.data(), std::streamsize(toc[i].offset - position));
+        if (!sorted[i]->data.empty()) {
+            out.write(reinterpret_cast<const char *>(sorted[i]->data.data()),
+                    std::streamsize(sorted[i]->data.size()));
+        }
+        position = toc[i].offset + toc[i].storedSize;
+    }
+
+    if (!out) {
+        std::stringstream errorMessage;
+        errorMessage << "Error writing asset pack " << filePath
+                     << " within method AssetPackWriter::write";
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+size_t AssetPackWriter::getNumEntries() const {
+    return entries.size();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return total bytes of asset data as stored, before alignment padding.
+ */
+uint64 AssetPackWriter::getStoredSize() const {
+    uint64 storedSize = 0;
+    for (const PendingEntry & entry : entries) {
+        storedSize += entry.data.size();
+    }
+    return storedSize;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return total bytes of asset data once decompressed.
+ */
+uint64 AssetPackWriter::getSize() const {
+    uint64 size = 0;
+    for (const PendingEntry & entry : entries) {
+        size += entry.size;
+    }
+    return size;
+}
+
+} // end namespace Rigid3D
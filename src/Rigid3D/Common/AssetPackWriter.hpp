@@ -0,0 +1,60 @@
+/**
+ * @brief AssetPackWriter
+ */
+
+#ifndef RIGID3D_ASSET_PACK_WRITER_HPP_
+#define RIGID3D_ASSET_PACK_WRITER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Collects assets in memory and writes them out as an \c AssetPack file.
+     *
+     * Compression is requested per asset, and is only kept for assets that shrink
+     * by at least an eighth, so already compressed formats such as PNG are stored
+     * raw and remain usable in place.
+     *
+     * \code{.cpp}
+     *  AssetPackWriter writer;
+     *  writer.addFile("shaders/PerFragLighting.frag", "data/shaders/PerFragLighting.frag", true);
+     *  writer.addFile("meshes/bunny.mesh", "cooked/bunny.mesh", true);
+     *  writer.write("data.pack");
+     * \endcode
+     */
+    class AssetPackWriter {
+    public:
+        AssetPackWriter();
+
+        bool add(const char * path, const void * data, size_t size, bool compress = false);
+
+        bool addFile(const char * path, const char * filePath, bool compress = false);
+
+        void write(const char * filePath) const;
+
+        size_t getNumEntries() const;
+
+        uint64 getStoredSize() const;
+
+        uint64 getSize() const;
+
+    private:
+        struct PendingEntry {
+            std::string path;
+            uint64 pathHash;
+            std::vector<uint8> data;
+            uint64 size;
+            bool compressed;
+        };
+
+        std::vector<PendingEntry> entries;
+    };
+
+}
+
+#endif /* RIGID3D_ASSET_PACK_WRITER_HPP_ */
@@ -0,0 +1,211 @@
+#include "BlockCompression.hpp"
+
+#include <Rigid3D/Common/Lz4.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace Rigid3D {
+
+namespace {
+
+    const char magic[4] = {'R', '3', 'B', 'Z'};
+
+    const uint32 rawBlockFlag = 0x80000000;
+
+    struct StreamHeader {
+        char magic[4];
+        uint32 blockSize;
+        uint64 size;
+        uint32 numBlocks;
+        uint32 padding;
+    };
+
+    //------------------------------------------------------------------------------------
+    void throwMalformed(const char * methodName) {
+        std::stringstream errorMessage;
+        errorMessage << "Malformed block compressed stream within method "
+                     << "BlockCompression::" << methodName;
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    //------------------------------------------------------------------------------------
+    // Validates the header and block table, returning the header.
+    StreamHeader readHeader(const uint8 * stream, size_t streamSize, const char * methodName) {
+        StreamHeader header;
+        if (streamSize < sizeof(header)) {
+            throwMalformed(methodName);
+        }
+        std::memcpy(&header, stream, sizeof(header));
+
+        const uint64 expectedBlocks = (header.blockSize == 0) ? 0 :
+                (header.size + header.blockSize - 1) / header.blockSize;
+        if (std::memcmp(header.magic, magic, 4) != 0 || header.blockSize == 0 ||
+                header.blockSize >= rawBlockFlag || header.numBlocks != expectedBlocks ||
+                uint64(header.numBlocks) * sizeof(uint32) > streamSize - sizeof(header)) {
+            throwMalformed(methodName);
+        }
+
+        return header;
+    }
+
+} // end anonymous namespace
+
+const uint32 BlockCompression::DefaultBlockSize;
+
+//----------------------------------------------------------------------------------------
+/**
+ * Compresses 'input' into a block compressed stream, replacing the contents of
+ * 'stream'.
+ *
+ * @param blockSize - bytes per block.  Smaller blocks decompress with more
+ * parallelism but compress less well.
+ * @param threadPool - compresses blocks in parallel if given.
+ */
+void BlockCompression::compress(const uint8 * input,
+                                size_t inputSize,
+                                std::vector<uint8> & stream,
+                                uint32 blockSize,
+                                ThreadPool * threadPool) {
+    if (blockSize == 0 || blockSize >= rawBlockFlag) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid block size " << blockSize
+                     << " within method BlockCompression::compress";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const size_t numBlocks = (inputSize + blockSize - 1) / blockSize;
+    std::vector<std::vector<uint8>> blocks(numBlocks);
+    std::vector<uint32> storedSizes(numBlocks);
+
+    auto compressBlocks = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint8 * block = input + i * blockSize;
+            const size_t size = std::min(size_t(blockSize), inputSize - i * blockSize);
+
+            blocks[i].resize(Lz4::compressBound(size));
+            const size_t compressedSize = Lz4::compress(block, size, blocks[i].data(),
+                    blocks[i].size());
+            if (compressedSize > 0 && compressedSize < size) {
+                blocks[i].resize(compressedSize);
+                storedSizes[i] = uint32(compressedSize);
+            } else {
+                blocks[i].assign(block, block + size);
+                storedSizes[i] = uint32(size) | rawBlockFlag;
+            }
+        }
+    };
+
+    if (threadPool != nullptr) {
+        threadPool->parallelFor(numBlocks, 1, compressBlocks);
+    } else {
+        compressBlocks(0, numBlocks);
+    }
+
+    StreamHeader header;
+    std::memcpy(header.magic, magic, 4);
+    header.blockSize = blockSize;
+    header.size = inputSize;
+    header.numBlocks = uint32(numBlocks);
+    header.padding = 0;
+
+    size_t streamSize = sizeof(header) + numBlocks * sizeof(uint32);
+    for (const std::vector<uint8> & block : blocks) {
+        streamSize += block.size();
+    }
+
+    stream.resize(streamSize);
+    uint8 * out = stream.data();
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    if (numBlocks > 0) {
+        std::memcpy(out, storedSizes.data(), numBlocks * sizeof(uint32));
+        out += numBlocks * sizeof(uint32);
+    }
+    for (const std::vector<uint8> & block : blocks) {
+        if (!block.empty()) {
+            std::memcpy(out, block.data(), block.size());
+            out += block.size();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if 'stream' starts with a block compressed stream header.
+ */
+bool BlockCompression::isCompressedStream(const uint8 * stream, size_t streamSize) {
+    return streamSize >= sizeof(StreamHeader) && std::memcmp(stream, magic, 4) == 0;
+}
+
+//----------------------------------------------------------------------------------------
+uint64 BlockCompression::getDecompressedSize(const uint8 * stream, size_t streamSize) {
+    return readHeader(stream, streamSize, "getDecompressedSize").size;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Decompresses every block of 'stream' directly into 'output', which must hold
+ * exactly the decompressed size.
+ *
+ * @param threadPool - decompresses blocks in parallel if given.
+ *
+ * @throws Rigid3DException if the stream is malformed or 'outputSize' is wrong.
+ */
+void BlockCompression::decompress(const uint8 * stream,
+                                  size_t streamSize,
+                                  uint8 * output,
+                                  size_t outputSize,
+                                  ThreadPool * threadPool) {
+    const StreamHeader header = readHeader(stream, streamSize, "decompress");
+    if (header.size != outputSize) {
+        throwMalformed("decompress");
+    }
+
+    // Block offsets within the stream, found before any thread starts.
+    std::vector<uint32> storedSizes(header.numBlocks);
+    if (header.numBlocks > 0) {
+        std::memcpy(storedSizes.data(), stream + sizeof(header),
+                header.numBlocks * sizeof(uint32));
+    }
+
+    std::vector<size_t> offsets(header.numBlocks);
+    size_t offset = sizeof(header) + header.numBlocks * sizeof(uint32);
+    for (uint32 i = 0; i < header.numBlocks; ++i) {
+        offsets[i] = offset;
+        offset += storedSizes[i] & ~rawBlockFlag;
+        if (offset > streamSize) {
+            throwMalformed("decompress");
+        }
+    }
+
+    auto decompressBlocks = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint8 * block = stream + offsets[i];
+            const size_t storedSize = storedSizes[i] & ~rawBlockFlag;
+            uint8 * destination = output + i * header.blockSize;
+            const size_t size = std::min(size_t(header.blockSize),
+                    outputSize - i * header.blockSize);
+
+            if ((storedSizes[i] & rawBlockFlag) != 0) {
+                if (storedSize != size) {
+                    throwMalformed("decompress");
+                }
+                std::memcpy(destination, block, size);
+            } else {
+                Lz4::decompress(block, storedSize, destination, size);
+            }
+        }
+    };
+
+    if (threadPool != nullptr) {
+        threadPool->parallelFor(header.numBlocks, 1, decompressBlocks);
+    } else {
+        decompressBlocks(0, header.numBlocks);
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,68 @@
+/**
+ * @brief BlockCompression
+ */
+
+#ifndef RIGID3D_BLOCK_COMPRESSION_HPP_
+#define RIGID3D_BLOCK_COMPRESSION_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class ThreadPool;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Splits data into independently LZ4 compressed blocks so that it can be
+     * compressed and decompressed on many threads at once.
+     *
+     * A block compressed stream is:
+     * # A 24 byte header: magic "R3BZ", block size, decompressed size and block
+     *   count.
+     * # One 32-bit stored size per block.  The top bit marks blocks stored raw
+     *   because they did not compress.
+     * # The stored blocks, back to back.
+     *
+     * Each block decompresses to exactly the block size, except the last, straight
+     * into its place within the destination.  The destination may therefore be
+     * any memory, such as a persistently mapped pixel unpack buffer.
+     *
+     * \code{.cpp}
+     *  std::vector<uint8> stream;
+     *  BlockCompression::compress(data.data(), data.size(), stream);
+     *  ...
+     *  uint64 size = BlockCompression::getDecompressedSize(stream.data(), stream.size());
+     *  void * destination = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT);
+     *  BlockCompression::decompress(stream.data(), stream.size(),
+     *          static_cast<uint8 *>(destination), size, &threadPool);
+     * \endcode
+     */
+    class BlockCompression {
+    public:
+        static const uint32 DefaultBlockSize = 256 * 1024;
+
+        static void compress(const uint8 * input,
+                             size_t inputSize,
+                             std::vector<uint8> & stream,
+                             uint32 blockSize = DefaultBlockSize,
+                             ThreadPool * threadPool = nullptr);
+
+        static bool isCompressedStream(const uint8 * stream, size_t streamSize);
+
+        static uint64 getDecompressedSize(const uint8 * stream, size_t streamSize);
+
+        static void decompress(const uint8 * stream,
+                               size_t streamSize,
+                               uint8 * output,
+                               size_t outputSize,
+                               ThreadPool * threadPool = nullptr);
+    };
+
+}
+
+#endif /* RIGID3D_BLOCK_COMPRESSION_HPP_ */
@@ -0,0 +1,51 @@
+#include "ContentHash.hpp"
+
+#include <cstring>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param seed - the hash of preceding data, to hash several arrays as one.
+ *
+ * @return hash of the 'size' bytes at 'data'.
+ */
+uint64 ContentHash::hash(const void * data, size_t size, uint64 seed) {
+    const uint64 m = 0xc6a4a7935bd1e995ull;
+    const int r = 47;
+
+    uint64 h = seed ^ (uint64(size) * m);
+
+    const uint8 * bytes = static_cast<const uint8 *>(data);
+    const uint8 * end = bytes + (size & ~size_t(7));
+    for (; bytes != end; bytes += 8) {
+        uint64 k;
+        std::memcpy(&k, bytes, 8);
+
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+
+        h ^= k;
+        h *= m;
+    }
+
+    // Remaining 0 to 7 bytes.
+    const size_t remainder = size & 7;
+    if (remainder > 0) {
+        uint64 k = 0;
+        for (size_t i = 0; i < remainder; ++i) {
+            k |= uint64(bytes[i]) << (8 * i);
+        }
+        h ^= k;
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+
+    return h;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,35 @@
+/**
+ * @brief ContentHash
+ */
+
+#ifndef RIGID3D_CONTENT_HASH_HPP_
+#define RIGID3D_CONTENT_HASH_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Fast 64-bit hash of asset contents, used to find identical meshes and
+     * textures loaded under different names.
+     *
+     * The hash is MurmurHash64A, which reads eight bytes per step.  It is not
+     * cryptographic.  Callers that share data on a hash match either compare the
+     * contents as well or, where only GPU copies remain, also compare sizes and
+     * formats.
+     *
+     * \code{.cpp}
+     *  uint64 hash = ContentHash::hash(positions.data(), positions.size() * sizeof(vec3));
+     *  hash = ContentHash::hash(normals.data(), normals.size() * sizeof(vec3), hash);
+     * \endcode
+     */
+    class ContentHash {
+    public:
+        static uint64 hash(const void * data, size_t size, uint64 seed = 0);
+    };
+
+}
+
+#endif /* RIGID3D_CONTENT_HASH_HPP_ */
@@ -0,0 +1,248 @@
+#include "Lz4.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace Rigid3D {
+
+namespace {
+
+    // Constraints of the LZ4 block format.
+    const size_t minMatch = 4;
+    const size_t lastLiterals = 5;     // The final bytes of a block are always literals.
+    const size_t matchFindLimit = 12;  // The last match starts at least this far from the end.
+    const size_t maxOffset = 65535;
+
+    const unsigned int hashLog = 16;
+
+    //------------------------------------------------------------------------------------
+    inline uint32 read32(const uint8 * p) {
+        uint32 value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    //------------------------------------------------------------------------------------
+    inline uint32 hashSequence(uint32 sequence) {
+        return (sequence * 2654435761u) >> (32 - hashLog);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Writes the bytes beyond 15 of a literal or match length.
+    inline uint8 * writeLength(uint8 * out, size_t length) {
+        while (length >= 255) {
+            *out++ = 255;
+            length -= 255;
+        }
+        *out++ = uint8(length);
+        return out;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Emits 'numLiterals' literals followed, if 'matchLength' is non zero, by a
+    // match.  Returns NULL if the output would overflow.
+    uint8 * writeSequence(uint8 * out, const uint8 * outEnd, const uint8 * literals,
+                          size_t numLiterals, size_t offset, size_t matchLength) {
+        const size_t maxBytes = 1 + numLiterals + numLiterals / 255 + 1 +
+                2 + matchLength / 255 + 1;
+        if (size_t(outEnd - out) < maxBytes) {
+            return NULL;
+        }
+
+        uint8 * token = out++;
+        if (numLiterals >= 15) {
+            *token = 15 << 4;
+            out = writeLength(out, numLiterals - 15);
+        } else {
+            *token = uint8(numLiterals << 4);
+        }
+        std::memcpy(out, literals, numLiterals);
+        out += numLiterals;
+
+        if (matchLength > 0) {
+            *out++ = uint8(offset & 0xFF);
+            *out++ = uint8(offset >> 8);
+
+            const size_t length = matchLength - minMatch;
+            if (length >= 15) {
+                *token |= 15;
+                out = writeLength(out, length - 15);
+            } else {
+                *token |= uint8(length);
+            }
+        }
+
+        return out;
+    }
+
+    //------------------------------------------------------------------------------------
+    void throwMalformed(const char * reason) {
+        std::stringstream errorMessage;
+        errorMessage << "Malformed LZ4 block, " << reason
+                     << " within method Lz4::decompress";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the largest possible compressed size of 'inputSize' bytes.
+ */
+size_t Lz4::compressBound(size_t inputSize) {
+    return inputSize + inputSize / 255 + 16;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Compresses 'input' into a single LZ4 block.
+ *
+ * @return number of bytes written to 'output', or 0 if they would exceed
+ * 'outputCapacity'.  A capacity of \c compressBound(inputSize) always suffices.
+ */
+size_t Lz4::compress(const uint8 * input, size_t inputSize,
+                     uint8 * output, size_t outputCapacity) {
+    uint8 * out = output;
+    const uint8 * outEnd = output + outputCapacity;
+    size_t anchor = 0;
+
+    if (inputSize > matchFindLimit) {
+        std::vector<int32> table(size_t(1) << hashLog, -1);
+        const size_t matchLimit = inputSize - lastLiterals;
+        const size_t searchLimit = inputSize - matchFindLimit;
+
+        size_t position = 0;
+        unsigned int numMisses = 0;
+        while (position <= searchLimit) {
+            const uint32 sequence = read32(input + position);
+            const uint32 hash = hashSequence(sequence);
+            const int32 candidate = table[hash];
+            table[hash] = int32(position);
+
+            if (candidate < 0 || position - size_t(candidate) > maxOffset ||
+                    read32(input + candidate) != sequence) {
+                // Step further through data that does not compress.
+                position += 1 + (numMisses++ >> 6);
+                continue;
+            }
+            numMisses = 0;
+
+            size_t matchLength = minMatch;
+            while (position + matchLength < matchLimit &&
+                    input[candidate + matchLength] == input[position + matchLength]) {
+                ++matchLength;
+            }
+
+            out = writeSequence(out, outEnd, input + anchor, position - anchor,
+                    position - size_t(candidate), matchLength);
+            if (out == NULL) {
+                return 0;
+            }
+
+            position += matchLength;
+            anchor = position;
+
+            // Index within the match so that the next repeat is found sooner.
+            if (position - 2 <= searchLimit) {
+                table[hashSequence(read32(input + position - 2))] = int32(position - 2);
+            }
+        }
+    }
+
+    out = writeSequence(out, outEnd, input + anchor, inputSize - anchor, 0, 0);
+    if (out == NULL) {
+        return 0;
+    }
+
+    return size_t(out - output);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Decompresses a single LZ4 block, which must expand to exactly 'outputSize' bytes.
+ *
+ * @throws Rigid3DException if the block is malformed, in which case 'output' holds
+ * partial data.  Reads and writes never leave the given ranges.
+ */
+void Lz4::decompress(const uint8 * input, size_t inputSize,
+                     uint8 * output, size_t outputSize) {
+    const uint8 * in = input;
+    const uint8 * inEnd = input + inputSize;
+    uint8 * out = output;
+    uint8 * outEnd = output + outputSize;
+
+    while (true) {
+        if (in == inEnd) {
+            throwMalformed("missing token");
+        }
+        const uint8 token = *in++;
+
+        size_t numLiterals = token >> 4;
+        if (numLiterals == 15) {
+            uint8 byte;
+            do {
+                if (in == inEnd) {
+                    throwMalformed("truncated literal length");
+                }
+                byte = *in++;
+                numLiterals += byte;
+            } while (byte == 255);
+        }
+        if (numLiterals > size_t(inEnd - in) || numLiterals > size_t(outEnd - out)) {
+            throwMalformed("literals out of range");
+        }
+        std::memcpy(out, in, numLiterals);
+        in += numLiterals;
+        out += numLiterals;
+
+        // The last sequence has no match.
+        if (in == inEnd) {
+            break;
+        }
+
+        if (inEnd - in < 2) {
+            throwMalformed("truncated offset");
+        }
+        const size_t offset = size_t(in[0]) | (size_t(in[1]) << 8);
+        in += 2;
+        if (offset == 0 || offset > size_t(out - output)) {
+            throwMalformed("offset out of range");
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            uint8 byte;
+            do {
+                if (in == inEnd) {
+                    throwMalformed("truncated match length");
+                }
+                byte = *in++;
+                matchLength += byte;
+            } while (byte == 255);
+        }
+        matchLength += minMatch;
+        if (matchLength > size_t(outEnd - out)) {
+            throwMalformed("match out of range");
+        }
+
+        const uint8 * match = out - offset;
+        if (offset >= matchLength) {
+            std::memcpy(out, match, matchLength);
+            out += matchLength;
+        } else {
+            // Overlapping copy repeats the last 'offset' bytes.
+            for (size_t i = 0; i < matchLength; ++i) {
+                *out++ = *match++;
+            }
+        }
+    }
+
+    if (out != outEnd) {
+        throwMalformed("decompressed size mismatch");
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,44 @@
+/**
+ * @brief Lz4
+ */
+
+#ifndef RIGID3D_LZ4_HPP_
+#define RIGID3D_LZ4_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Compresses and decompresses single blocks in the LZ4 block format.
+     *
+     * Output is readable by any LZ4 block decoder, and \c decompress() accepts
+     * blocks from any LZ4 block encoder.  The compressor is a greedy single-probe
+     * hash match finder, trading some ratio for speed, while decompression runs at
+     * memory bandwidth.  Blocks carry no header, so callers must store both the
+     * compressed and the uncompressed sizes.
+     *
+     * \code{.cpp}
+     *  std::vector<uint8> compressed(Lz4::compressBound(data.size()));
+     *  size_t numBytes = Lz4::compress(data.data(), data.size(),
+     *                                  compressed.data(), compressed.size());
+     *  ...
+     *  Lz4::decompress(compressed.data(), numBytes, data.data(), data.size());
+     * \endcode
+     */
+    class Lz4 {
+    public:
+        static size_t compressBound(size_t inputSize);
+
+        static size_t compress(const uint8 * input, size_t inputSize,
+                               uint8 * output, size_t outputCapacity);
+
+        static void decompress(const uint8 * input, size_t inputSize,
+                               uint8 * output, size_t outputSize);
+    };
+
+}
+
+#endif /* RIGID3D_LZ4_HPP_ */
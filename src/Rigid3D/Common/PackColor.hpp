@@ -0,0 +1,34 @@
+/**
+ * @brief PackColor.hpp
+ *
+ * Packing of floating point colors into 32 bit RGBA8 values, red in the lowest
+ * byte, as unpacked by unpackUnorm4x8 in GLSL or by a GL_UNSIGNED_BYTE vertex
+ * attribute with four normalized components.
+ */
+
+#ifndef RIGID3D_PACK_COLOR_HPP_
+#define RIGID3D_PACK_COLOR_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Rigid3D {
+
+    //-----------------------------------------------------------------------------------
+    /**
+     * Clamps each channel of 'color' to [0,1] and rounds it to 8 bits.
+     */
+    inline uint32 packColor(const vec4 & color) {
+        uint32 packed = 0;
+        for (int i = 0; i < 4; ++i) {
+            float channel = std::max(0.0f, std::min(color[i], 1.0f));
+            packed |= uint32(std::floor(channel * 255.0f + 0.5f)) << (8 * i);
+        }
+        return packed;
+    }
+
+}
+
+#endif /* RIGID3D_PACK_COLOR_HPP_ */
@@ -13,10 +13,12 @@ typedef unsigned char ubyte;
 typedef signed char	int8;
 typedef signed short int16;
 typedef signed int int32;
+typedef signed long long int64;
 
 typedef unsigned char uint8;
 typedef unsigned short uint16;
 typedef unsigned int uint32;
+typedef unsigned long long uint64;
 
 typedef float float32;
 typedef double float64;
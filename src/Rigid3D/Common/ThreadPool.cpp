@@ -0,0 +1,187 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace Rigid3D {
+
+namespace {
+
+    // State shared between the caller of parallelFor and helper tasks, which may
+    // start after the caller has already returned.
+    struct ParallelForState {
+        std::atomic<size_t> nextChunk;
+        size_t numChunks;
+        size_t count;
+        size_t grainSize;
+        ThreadPool::RangeTask body;
+
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        size_t numChunksDone;
+        std::exception_ptr exception;
+
+        ParallelForState()
+            : nextChunk(0), numChunks(0), count(0), grainSize(1), numChunksDone(0) { }
+
+        void work() {
+            for (;;) {
+                size_t chunk = nextChunk.fetch_add(1);
+                if (chunk >= numChunks) {
+                    return;
+                }
+
+                size_t begin = chunk * grainSize;
+                size_t end = std::min(begin + grainSize, count);
+                std::exception_ptr error;
+                try {
+                    body(begin, end);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (error && !exception) {
+                    exception = error;
+                }
+                if (++numChunksDone == numChunks) {
+                    doneCondition.notify_all();
+                }
+            }
+        }
+    };
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param numThreads - number of worker threads.  If zero, one less than the
+ * number of hardware threads is used, leaving a core for the calling thread.
+ */
+ThreadPool::ThreadPool(unsigned int numThreads)
+    : numPendingTasks(0),
+      shuttingDown(false) {
+
+    if (numThreads == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        numThreads = (hardwareThreads > 1) ? hardwareThreads - 1 : 1;
+    }
+
+    workers.reserve(numThreads);
+    for (unsigned int i = 0; i < numThreads; ++i) {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Finishes all submitted tasks, then joins the worker threads.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        shuttingDown = true;
+    }
+    taskAvailable.notify_all();
+
+    for (std::thread & worker : workers) {
+        worker.join();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ThreadPool::getNumThreads() const {
+    return (unsigned int)workers.size();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues 'task' to run on a worker thread.
+ */
+void ThreadPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push_back(std::move(task));
+        ++numPendingTasks;
+    }
+    taskAvailable.notify_one();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Blocks until every task submitted so far has finished.
+ */
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    tasksFinished.wait(lock, [this] { return numPendingTasks == 0; });
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Calls 'body' on consecutive sub-ranges of [0, count), each at most 'grainSize'
+ * long, spread across the worker threads and the calling thread.  Returns once all
+ * sub-ranges are done.  If any call throws, the first exception is rethrown here.
+ */
+void ThreadPool::parallelFor(size_t count, size_t grainSize, const RangeTask & body) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = std::max<size_t>(grainSize, 1);
+    size_t numChunks = (count + grainSize - 1) / grainSize;
+
+    if (numChunks == 1 || workers.empty()) {
+        body(0, count);
+        return;
+    }
+
+    std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+    state->numChunks = numChunks;
+    state->count = count;
+    state->grainSize = grainSize;
+    state->body = body;
+
+    size_t numHelpers = std::min<size_t>(workers.size(), numChunks - 1);
+    for (size_t i = 0; i < numHelpers; ++i) {
+        submit([state] { state->work(); });
+    }
+
+    state->work();
+
+    std::unique_lock<std::mutex> lock(state->doneMutex);
+    state->doneCondition.wait(lock, [&state] {
+        return state->numChunksDone == state->numChunks;
+    });
+
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void ThreadPool::workerLoop() {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            taskAvailable.wait(lock, [this] { return shuttingDown || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (--numPendingTasks == 0) {
+                tasksFinished.notify_all();
+            }
+        }
+    }
+}
+
+} // end namespace Rigid3D
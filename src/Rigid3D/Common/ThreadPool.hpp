@@ -0,0 +1,71 @@
+/**
+ * @brief ThreadPool
+ */
+
+#ifndef RIGID3D_THREAD_POOL_HPP_
+#define RIGID3D_THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Fixed set of worker threads for running CPU side jobs such as culling,
+     * command building and decompression.
+     *
+     * Tasks are run in submission order by whichever worker is free.
+     * \c parallelFor splits an index range into chunks and blocks until every chunk
+     * has run.  The calling thread works on chunks too, so \c parallelFor may be
+     * called from inside a task without deadlocking.
+     *
+     * \code{.cpp}
+     *  ThreadPool threadPool;
+     *  threadPool.parallelFor(renderables.size(), 256, [&](size_t begin, size_t end) {
+     *      for (size_t i = begin; i < end; ++i) {
+     *          worldBounds[i] = renderables[i]->getWorldBoundingBox();
+     *      }
+     *  });
+     * \endcode
+     */
+    class ThreadPool {
+    public:
+        typedef std::function<void ()> Task;
+        typedef std::function<void (size_t begin, size_t end)> RangeTask;
+
+        explicit ThreadPool(unsigned int numThreads = 0);
+
+        ~ThreadPool();
+
+        unsigned int getNumThreads() const;
+
+        void submit(Task task);
+
+        void wait();
+
+        void parallelFor(size_t count, size_t grainSize, const RangeTask & body);
+
+    private:
+        // Non-copyable, owns threads.
+        ThreadPool(const ThreadPool &);
+        ThreadPool & operator = (const ThreadPool &);
+
+        void workerLoop();
+
+        std::vector<std::thread> workers;
+        std::deque<Task> tasks;
+        std::mutex queueMutex;
+        std::condition_variable taskAvailable;
+        std::condition_variable tasksFinished;
+        size_t numPendingTasks;
+        bool shuttingDown;
+    };
+
+}
+
+#endif /* RIGID3D_THREAD_POOL_HPP_ */
@@ -0,0 +1,347 @@
+#include "TlsfAllocator.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+    // Index of the highest set bit, 'x' must not be 0.
+    inline Rigid3D::uint32 findLastSet(Rigid3D::uint32 x) {
+#if defined(__GNUC__)
+        return 31 - __builtin_clz(x);
+#else
+        Rigid3D::uint32 index = 0;
+        while (x >>= 1) {
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    // Index of the lowest set bit, 'x' must not be 0.
+    inline Rigid3D::uint32 findFirstSet(Rigid3D::uint32 x) {
+#if defined(__GNUC__)
+        return __builtin_ctz(x);
+#else
+        Rigid3D::uint32 index = 0;
+        while ((x & 1) == 0) {
+            x >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+}
+
+namespace Rigid3D {
+
+const uint32 TlsfAllocator::NumSubdivisionsLog2;
+const uint32 TlsfAllocator::NumSubdivisions;
+const uint32 TlsfAllocator::InvalidBlock;
+const uint32 TlsfAllocator::NumFirstLevels;
+
+//----------------------------------------------------------------------------------------
+TlsfAllocator::Allocation::Allocation()
+    : offset(0),
+      size(0),
+      block(InvalidBlock) {
+
+}
+
+//----------------------------------------------------------------------------------------
+TlsfAllocator::Stats::Stats()
+    : capacity(0),
+      numUnitsAllocated(0),
+      numUnitsFree(0),
+      largestFreeBlock(0),
+      numAllocations(0),
+      numFreeBlocks(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param capacity - size of the address space, in the caller's units.
+ */
+TlsfAllocator::TlsfAllocator(uint32 capacity)
+    : capacity(capacity) {
+    clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Allocates 'size' contiguous units.  An allocation of size 0 succeeds without
+ * consuming any space.
+ *
+ * @return false if no free block is large enough, leaving 'allocation' unchanged.
+ */
+bool TlsfAllocator::allocate(uint32 size, Allocation & allocation) {
+    if (size == 0) {
+        allocation = Allocation();
+        return true;
+    }
+
+    const uint32 block = findFreeBlock(size);
+    if (block == InvalidBlock) {
+        return false;
+    }
+    removeFreeBlock(block);
+
+    // Return the tail of the block to the free lists.
+    if (blocks[block].size > size) {
+        const uint32 remainder = newBlock();
+        Block & head = blocks[block];
+        Block & tail = blocks[remainder];
+        tail.offset = head.offset + size;
+        tail.size = head.size - size;
+        tail.prevPhysical = block;
+        tail.nextPhysical = head.nextPhysical;
+        if (head.nextPhysical != InvalidBlock) {
+            blocks[head.nextPhysical].prevPhysical = remainder;
+        }
+        head.nextPhysical = remainder;
+        head.size = size;
+        insertFreeBlock(remainder);
+    }
+
+    blocks[block].isFree = false;
+    numUnitsAllocated += size;
+    ++numAllocations;
+
+    allocation.offset = blocks[block].offset;
+    allocation.size = size;
+    allocation.block = block;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Returns 'allocation' to the allocator, merging it with free neighbours, and resets
+ * it to an empty allocation.
+ */
+void TlsfAllocator::free(Allocation & allocation) {
+    if (allocation.block == InvalidBlock) {
+        return;
+    }
+
+    uint32 block = allocation.block;
+    if (block >= blocks.size() || blocks[block].isFree ||
+            blocks[block].offset != allocation.offset ||
+            blocks[block].size != allocation.size) {
+        std::stringstream errorMessage;
+        errorMessage << "Allocation at offset " << allocation.offset
+                     << " was not made by this allocator or was already freed "
+                     << "within method TlsfAllocator::free";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    numUnitsAllocated -= blocks[block].size;
+    --numAllocations;
+
+    const uint32 next = blocks[block].nextPhysical;
+    if (next != InvalidBlock && blocks[next].isFree) {
+        removeFreeBlock(next);
+        mergeWithNext(block);
+    }
+
+    const uint32 prev = blocks[block].prevPhysical;
+    if (prev != InvalidBlock && blocks[prev].isFree) {
+        removeFreeBlock(prev);
+        mergeWithNext(prev);
+        block = prev;
+    }
+
+    insertFreeBlock(block);
+    allocation = Allocation();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Frees every allocation at once.  Existing allocations must not be freed afterwards.
+ */
+void TlsfAllocator::clear() {
+    blocks.clear();
+    unusedBlocks.clear();
+    firstLevelBitmap = 0;
+    std::fill(secondLevelBitmaps, secondLevelBitmaps + NumFirstLevels, 0);
+    std::fill(&freeLists[0][0], &freeLists[0][0] + NumFirstLevels * NumSubdivisions,
+            InvalidBlock);
+    numUnitsAllocated = 0;
+    numAllocations = 0;
+
+    if (capacity > 0) {
+        const uint32 block = newBlock();
+        blocks[block].offset = 0;
+        blocks[block].size = capacity;
+        blocks[block].prevPhysical = InvalidBlock;
+        blocks[block].nextPhysical = InvalidBlock;
+        insertFreeBlock(block);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+uint32 TlsfAllocator::getCapacity() const {
+    return capacity;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @note Walks every block, so it is not constant time.
+ */
+TlsfAllocator::Stats TlsfAllocator::getStats() const {
+    Stats stats;
+    stats.capacity = capacity;
+    stats.numUnitsAllocated = numUnitsAllocated;
+    stats.numUnitsFree = capacity - numUnitsAllocated;
+    stats.numAllocations = numAllocations;
+
+    // Block 0 starts at offset 0 and is never merged into a predecessor.
+    for (uint32 block = blocks.empty() ? InvalidBlock : 0; block != InvalidBlock;
+            block = blocks[block].nextPhysical) {
+        if (blocks[block].isFree) {
+            stats.largestFreeBlock = std::max(stats.largestFreeBlock, blocks[block].size);
+            ++stats.numFreeBlocks;
+        }
+    }
+
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Maps a block size to the free list holding blocks of that size.
+ */
+void TlsfAllocator::mapping(uint32 size, uint32 & firstLevel, uint32 & secondLevel) {
+    if (size < NumSubdivisions) {
+        // Small sizes get one list each.
+        firstLevel = 0;
+        secondLevel = size;
+    } else {
+        const uint32 msb = findLastSet(size);
+        firstLevel = msb - NumSubdivisionsLog2 + 1;
+        secondLevel = (size >> (msb - NumSubdivisionsLog2)) - NumSubdivisions;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return a free block of at least 'size' units, or InvalidBlock.
+ */
+uint32 TlsfAllocator::findFreeBlock(uint32 size) const {
+    uint32 firstLevel;
+    uint32 secondLevel;
+
+    // Round up to the next list, every block of which is then large enough.
+    uint64 roundedSize = size;
+    if (size >= NumSubdivisions) {
+        roundedSize += (uint64(1) << (findLastSet(size) - NumSubdivisionsLog2)) - 1;
+    }
+
+    if (roundedSize <= capacity) {
+        mapping(uint32(roundedSize), firstLevel, secondLevel);
+
+        uint32 secondLevelMap = secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+        if (secondLevelMap == 0) {
+            // Nothing in this size class, take the smallest non-empty larger class.
+            const uint32 firstLevelMap = (firstLevel + 1 < 32) ?
+                    firstLevelBitmap & (~0u << (firstLevel + 1)) : 0;
+            if (firstLevelMap != 0) {
+                firstLevel = findFirstSet(firstLevelMap);
+                secondLevelMap = secondLevelBitmaps[firstLevel];
+            }
+        }
+        if (secondLevelMap != 0) {
+            return freeLists[firstLevel][findFirstSet(secondLevelMap)];
+        }
+    }
+
+    // Only blocks in the request's own class can still fit, for example when
+    // the request is for nearly all of the remaining space.
+    mapping(size, firstLevel, secondLevel);
+    for (uint32 block = freeLists[firstLevel][secondLevel]; block != InvalidBlock;
+            block = blocks[block].nextFree) {
+        if (blocks[block].size >= size) {
+            return block;
+        }
+    }
+
+    return InvalidBlock;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 TlsfAllocator::newBlock() {
+    if (!unusedBlocks.empty()) {
+        const uint32 block = unusedBlocks.back();
+        unusedBlocks.pop_back();
+        return block;
+    }
+
+    blocks.push_back(Block());
+    return uint32(blocks.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------
+void TlsfAllocator::insertFreeBlock(uint32 block) {
+    uint32 firstLevel;
+    uint32 secondLevel;
+    mapping(blocks[block].size, firstLevel, secondLevel);
+
+    const uint32 head = freeLists[firstLevel][secondLevel];
+    blocks[block].isFree = true;
+    blocks[block].prevFree = InvalidBlock;
+    blocks[block].nextFree = head;
+    if (head != InvalidBlock) {
+        blocks[head].prevFree = block;
+    }
+    freeLists[firstLevel][secondLevel] = block;
+
+    firstLevelBitmap |= 1u << firstLevel;
+    secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+}
+
+//----------------------------------------------------------------------------------------
+void TlsfAllocator::removeFreeBlock(uint32 block) {
+    uint32 firstLevel;
+    uint32 secondLevel;
+    mapping(blocks[block].size, firstLevel, secondLevel);
+
+    const uint32 prev = blocks[block].prevFree;
+    const uint32 next = blocks[block].nextFree;
+    if (prev != InvalidBlock) {
+        blocks[prev].nextFree = next;
+    }
+    if (next != InvalidBlock) {
+        blocks[next].prevFree = prev;
+    }
+
+    if (freeLists[firstLevel][secondLevel] == block) {
+        freeLists[firstLevel][secondLevel] = next;
+        if (next == InvalidBlock) {
+            secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (secondLevelBitmaps[firstLevel] == 0) {
+                firstLevelBitmap &= ~(1u << firstLevel);
+            }
+        }
+    }
+
+    blocks[block].isFree = false;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Absorbs the block following 'block' in address order, which must already be
+ * removed from the free lists.
+ */
+void TlsfAllocator::mergeWithNext(uint32 block) {
+    const uint32 next = blocks[block].nextPhysical;
+    blocks[block].size += blocks[next].size;
+    blocks[block].nextPhysical = blocks[next].nextPhysical;
+    if (blocks[next].nextPhysical != InvalidBlock) {
+        blocks[blocks[next].nextPhysical].prevPhysical = block;
+    }
+    unusedBlocks.push_back(next);
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,117 @@
+/**
+ * @brief TlsfAllocator
+ */
+
+#ifndef RIGID3D_TLSF_ALLOCATOR_HPP_
+#define RIGID3D_TLSF_ALLOCATOR_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Two-level segregated fit allocator handing out ranges of an abstract
+     * address space, such as elements of a GPU buffer, in constant time.
+     *
+     * The allocator never touches the memory it manages; it only tracks offsets
+     * and sizes, in whatever unit the caller chooses.  Free blocks are kept in
+     * lists segregated first by the power of two below their size, then by
+     * \c NumSubdivisions linear steps within that power of two.  One bitmap per
+     * level records which lists are non-empty, so finding a suitable block takes
+     * two bit scans regardless of how many blocks exist.  Requests are rounded up
+     * to the next list boundary, which guarantees that any block found is large
+     * enough.  Only when no such block exists is the request's own list searched,
+     * so that a request can still take a block of nearly its exact size.
+     *
+     * Freed blocks are merged with free neighbours immediately, so the address
+     * space never fragments into adjacent free blocks.
+     *
+     * \code{.cpp}
+     *  TlsfAllocator allocator(1 << 20);
+     *  TlsfAllocator::Allocation allocation;
+     *  if (allocator.allocate(numVertices, allocation)) {
+     *      copyVertices(allocation.offset);
+     *  }
+     *  ...
+     *  allocator.free(allocation);
+     * \endcode
+     */
+    class TlsfAllocator {
+    public:
+        static const uint32 NumSubdivisionsLog2 = 4;
+        static const uint32 NumSubdivisions = 1 << NumSubdivisionsLog2;
+
+        struct Allocation {
+            uint32 offset;
+            uint32 size;
+            uint32 block;    // Handle used by free(), InvalidBlock if empty.
+
+            Allocation();
+        };
+
+        struct Stats {
+            uint32 capacity;
+            uint32 numUnitsAllocated;
+            uint32 numUnitsFree;
+            uint32 largestFreeBlock;
+            size_t numAllocations;
+            size_t numFreeBlocks;
+
+            Stats();
+        };
+
+        static const uint32 InvalidBlock = 0xFFFFFFFF;
+
+        explicit TlsfAllocator(uint32 capacity);
+
+        bool allocate(uint32 size, Allocation & allocation);
+
+        void free(Allocation & allocation);
+
+        void clear();
+
+        uint32 getCapacity() const;
+
+        Stats getStats() const;
+
+    private:
+        static const uint32 NumFirstLevels = 32 - NumSubdivisionsLog2 + 1;
+
+        struct Block {
+            uint32 offset;
+            uint32 size;
+            uint32 prevPhysical;   // Neighbouring blocks in address order.
+            uint32 nextPhysical;
+            uint32 prevFree;       // Neighbours in the block's free list.
+            uint32 nextFree;
+            bool isFree;
+        };
+
+        static void mapping(uint32 size, uint32 & firstLevel, uint32 & secondLevel);
+
+        uint32 findFreeBlock(uint32 size) const;
+
+        uint32 newBlock();
+
+        void insertFreeBlock(uint32 block);
+
+        void removeFreeBlock(uint32 block);
+
+        void mergeWithNext(uint32 block);
+
+        uint32 capacity;
+        std::vector<Block> blocks;
+        std::vector<uint32> unusedBlocks;   // Recycled entries of 'blocks'.
+        uint32 firstLevelBitmap;
+        uint32 secondLevelBitmaps[NumFirstLevels];
+        uint32 freeLists[NumFirstLevels][NumSubdivisions];
+        uint32 numUnitsAllocated;
+        size_t numAllocations;
+    };
+
+}
+
+#endif /* RIGID3D_TLSF_ALLOCATOR_HPP_ */
@@ -0,0 +1,111 @@
+/**
+ * @brief TripleBuffer
+ */
+
+#ifndef RIGID3D_TRIPLE_BUFFER_HPP_
+#define RIGID3D_TRIPLE_BUFFER_HPP_
+
+#include <atomic>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Lock-free handover of successive values from one producer thread to
+     * one consumer thread.
+     *
+     * Three slots are rotated between the producer, the consumer and a shared
+     * "ready" position.  The producer fills its slot and publishes it by swapping
+     * it with the ready slot, and the consumer takes the most recently published
+     * slot the same way.  Neither thread ever waits on the other: a slow consumer
+     * simply skips values, and a slow producer leaves the consumer with the last
+     * value it published.
+     *
+     * Slots are reused rather than reallocated, so a value type holding containers
+     * keeps their capacity from one handover to the next.
+     *
+     * \code{.cpp}
+     *  // Producer thread.
+     *  FramePacket & packet = buffer.getWriteBuffer();
+     *  buildPacket(packet);
+     *  buffer.publish();
+     *
+     *  // Consumer thread.
+     *  if (buffer.acquire()) {
+     *      render(buffer.getReadBuffer());
+     *  }
+     * \endcode
+     */
+    template <typename T>
+    class TripleBuffer {
+    public:
+        TripleBuffer()
+            : writeIndex(0),
+              readIndex(1),
+              readyState(2) { }
+
+        /**
+         * @return the slot owned by the producer.  Only valid until the next call
+         * to \c publish().
+         */
+        T & getWriteBuffer() {
+            return slots[writeIndex];
+        }
+
+        /**
+         * Makes the producer's slot available to the consumer, replacing any value
+         * the consumer has not yet acquired.
+         */
+        void publish() {
+            unsigned int previous = readyState.exchange(writeIndex | freshBit,
+                    std::memory_order_acq_rel);
+            writeIndex = previous & indexMask;
+        }
+
+        /**
+         * Takes the most recently published value, if there is one the consumer has
+         * not already seen.
+         *
+         * @return true if \c getReadBuffer() now refers to a new value.
+         */
+        bool acquire() {
+            if ((readyState.load(std::memory_order_relaxed) & freshBit) == 0) {
+                return false;
+            }
+
+            unsigned int previous = readyState.exchange(readIndex, std::memory_order_acq_rel);
+            readIndex = previous & indexMask;
+            return true;
+        }
+
+        /**
+         * @return the slot owned by the consumer.  Only valid until the next
+         * successful call to \c acquire().
+         */
+        const T & getReadBuffer() const {
+            return slots[readIndex];
+        }
+
+        /**
+         * @return true if a value has been published and not yet acquired.
+         */
+        bool hasFreshValue() const {
+            return (readyState.load(std::memory_order_acquire) & freshBit) != 0;
+        }
+
+    private:
+        // Non-copyable, shared between threads.
+        TripleBuffer(const TripleBuffer &);
+        TripleBuffer & operator = (const TripleBuffer &);
+
+        static const unsigned int indexMask = 0x3;
+        static const unsigned int freshBit = 0x4;
+
+        T slots[3];
+        unsigned int writeIndex;   // Only touched by the producer.
+        unsigned int readIndex;    // Only touched by the consumer.
+        std::atomic<unsigned int> readyState;  // Ready slot index, plus freshBit.
+    };
+
+}
+
+#endif /* RIGID3D_TRIPLE_BUFFER_HPP_ */
@@ -0,0 +1,449 @@
+#include "VirtualFileSystem.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Rigid3D {
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    // Asks the kernel to read all of an open file ahead of use.
+    void adviseWillNeed(int fileDescriptor) {
+#if defined(POSIX_FADV_WILLNEED)
+        posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+        struct stat fileStatus;
+        if (fstat(fileDescriptor, &fileStatus) == 0) {
+            struct radvisory advisory;
+            advisory.ra_offset = 0;
+            advisory.ra_count = int(fileStatus.st_size);
+            fcntl(fileDescriptor, F_RDADVISE, &advisory);
+        }
+#else
+        (void)fileDescriptor;
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+    // Tells the kernel an open file will be read once from start to end, so it can
+    // use a larger read-ahead window.
+    void adviseSequential(int fileDescriptor) {
+#if defined(POSIX_FADV_SEQUENTIAL)
+        posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#else
+        (void)fileDescriptor;
+#endif
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+VirtualFileSystem::Backend::~Backend() {
+
+}
+
+//----------------------------------------------------------------------------------------
+VirtualFileSystem::DirectoryBackend::DirectoryBackend(const char * rootDirectory)
+    : rootDirectory(rootDirectory) {
+
+}
+
+//----------------------------------------------------------------------------------------
+bool VirtualFileSystem::DirectoryBackend::exists(const char * path) const {
+    struct stat fileStatus;
+    return stat(fullPath(path).c_str(), &fileStatus) == 0 && S_ISREG(fileStatus.st_mode);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reads the whole file with one sized allocation and sequential access advice.
+ *
+ * @throws Rigid3DException if the file exists but cannot be read.
+ */
+bool VirtualFileSystem::DirectoryBackend::read(const char * path,
+                                               std::vector<uint8> & data) const {
+    const std::string filePath = fullPath(path);
+    int fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode)) {
+        ::close(fileDescriptor);
+        return false;
+    }
+
+    adviseSequential(fileDescriptor);
+
+    data.resize(size_t(fileStatus.st_size));
+    size_t numBytesRead = 0;
+    while (numBytesRead < data.size()) {
+        ssize_t result = ::read(fileDescriptor, data.data() + numBytesRead,
+                data.size() - numBytesRead);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            ::close(fileDescriptor);
+            std::stringstream errorMessage;
+            errorMessage << "Error reading file " << filePath
+                         << " within method VirtualFileSystem::DirectoryBackend::read";
+            throw Rigid3DException(errorMessage.str());
+        }
+        numBytesRead += size_t(result);
+    }
+
+    ::close(fileDescriptor);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool VirtualFileSystem::DirectoryBackend::prefetch(const char * path) const {
+    int fileDescriptor = ::open(fullPath(path).c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    // Read-ahead carries on after the descriptor is closed.
+    adviseWillNeed(fileDescriptor);
+    ::close(fileDescriptor);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+std::string VirtualFileSystem::DirectoryBackend::fullPath(const char * path) const {
+    if (rootDirectory.empty()) {
+        return path;
+    }
+
+    std::string filePath = rootDirectory;
+    if (filePath.back() != '/') {
+        filePath += '/';
+    }
+    return filePath + AssetPack::normalizePath(path);
+}
+
+//----------------------------------------------------------------------------------------
+VirtualFileSystem::PackBackend::PackBackend(const char * packFilePath)
+    : pack(packFilePath) {
+
+}
+
+//----------------------------------------------------------------------------------------
+bool VirtualFileSystem::PackBackend::exists(const char * path) const {
+    return pack.contains(path);
+}
+
+//----------------------------------------------------------------------------------------
+bool VirtualFileSystem::PackBackend::read(const char * path,
+                                          std::vector<uint8> & data) const {
+    AssetPack::Entry entry;
+    if (!pack.find(path, entry)) {
+        return false;
+    }
+
+    data.resize(size_t(entry.size));
+    pack.decompress(entry, data.data());
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool VirtualFileSystem::PackBackend::prefetch(const char * path) const {
+    AssetPack::Entry entry;
+    if (!pack.find(path, entry)) {
+        return false;
+    }
+
+    pack.prefetch(entry);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool VirtualFileSystem::ReadRequest::operator < (const ReadRequest & other) const {
+    if (priority != other.priority) {
+        return priority < other.priority;
+    }
+    return sequence > other.sequence;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param mountWorkingDirectory - mount a \c DirectoryBackend that opens paths as
+ * given, relative to the current working directory.
+ */
+VirtualFileSystem::VirtualFileSystem(bool mountWorkingDirectory)
+    : recordAccesses(true),
+      nextSequence(0),
+      shuttingDown(false) {
+    if (mountWorkingDirectory) {
+        mount(std::make_shared<DirectoryBackend>());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Finishes any queued reads, then stops the I/O thread.
+ */
+VirtualFileSystem::~VirtualFileSystem() {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        shuttingDown = true;
+    }
+    requestAvailable.notify_all();
+
+    if (ioThread.joinable()) {
+        ioThread.join();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the file system used by the library's own loaders.
+ */
+VirtualFileSystem & VirtualFileSystem::getDefault() {
+    static VirtualFileSystem defaultFileSystem;
+    return defaultFileSystem;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Adds 'backend' ahead of those already mounted.
+ */
+void VirtualFileSystem::mount(std::shared_ptr<Backend> backend) {
+    std::lock_guard<std::mutex> lock(backendMutex);
+    backends.push_back(backend);
+}
+
+//----------------------------------------------------------------------------------------
+void VirtualFileSystem::mountDirectory(const char * rootDirectory) {
+    mount(std::make_shared<DirectoryBackend>(rootDirectory));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @throws Rigid3DException if 'packFilePath' is not a valid \c AssetPack.
+ */
+void VirtualFileSystem::mountPack(const char * packFilePath) {
+    mount(std::make_shared<PackBackend>(packFilePath));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Removes every backend, including the working directory.  Reads already under way
+ * keep the backends they started with.
+ */
+void VirtualFileSystem::unmountAll() {
+    std::lock_guard<std::mutex> lock(backendMutex);
+    backends.clear();
+}
+
+//----------------------------------------------------------------------------------------
+bool VirtualFileSystem::exists(const char * path) const {
+    std::vector<std::shared_ptr<Backend>> mounted = getBackends();
+    for (auto backend = mounted.rbegin(); backend != mounted.rend(); ++backend) {
+        if ((*backend)->exists(path)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Replaces the contents of 'data' with the file at 'path'.
+ *
+ * @throws Rigid3DException if no backend has the file.
+ */
+void VirtualFileSystem::read(const char * path, std::vector<uint8> & data) {
+    if (!tryRead(path, data)) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to open file " << path
+                     << " within method VirtualFileSystem::read";
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Same as \c read(), for callers with their own error reporting.
+ *
+ * @return false if no backend has the file.
+ */
+bool VirtualFileSystem::tryRead(const char * path, std::vector<uint8> & data) {
+    std::vector<std::shared_ptr<Backend>> mounted = getBackends();
+    for (auto backend = mounted.rbegin(); backend != mounted.rend(); ++backend) {
+        if ((*backend)->read(path, data)) {
+            recordAccess(path);
+            return true;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues a read of 'path' for the I/O thread.
+ *
+ * @param priority - requests with a higher priority are read first.
+ *
+ * @return the contents of the file, or the exception \c read() would have thrown.
+ */
+std::future<std::vector<uint8>> VirtualFileSystem::readAsync(const char * path,
+                                                             int priority) {
+    ReadRequest request;
+    request.priority = priority;
+    request.path = path;
+    request.result = std::make_shared<std::promise<std::vector<uint8>>>();
+    std::future<std::vector<uint8>> result = request.result->get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        request.sequence = nextSequence++;
+        requests.push(request);
+
+        if (!ioThread.joinable()) {
+            ioThread = std::thread(&VirtualFileSystem::ioLoop, this);
+        }
+    }
+    requestAvailable.notify_one();
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Issues a read-ahead hint for each path of an access log written by
+ * \c saveAccessLog(), in the order they were first read.  Hints return without
+ * waiting for the reads.
+ *
+ * @return number of paths found, 0 if there is no log yet.
+ */
+uint32 VirtualFileSystem::prefetch(const char * accessLogFilePath) const {
+    std::ifstream log(accessLogFilePath);
+    if (!log) {
+        return 0;
+    }
+
+    std::vector<std::shared_ptr<Backend>> mounted = getBackends();
+    uint32 numPrefetched = 0;
+    std::string path;
+    while (std::getline(log, path)) {
+        if (!path.empty() && path.back() == '\r') {
+            path.pop_back();
+        }
+        if (path.empty()) {
+            continue;
+        }
+
+        for (auto backend = mounted.rbegin(); backend != mounted.rend(); ++backend) {
+            if ((*backend)->prefetch(path.c_str())) {
+                ++numPrefetched;
+                break;
+            }
+        }
+    }
+
+    return numPrefetched;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Recording is on by default.
+ */
+void VirtualFileSystem::setRecordAccesses(bool record) {
+    std::lock_guard<std::mutex> lock(accessLogMutex);
+    recordAccesses = record;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return normalized paths of the files read so far, in order of first access.
+ */
+std::vector<std::string> VirtualFileSystem::getAccessLog() const {
+    std::lock_guard<std::mutex> lock(accessLogMutex);
+    return accessLog;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes the access log, one path per line, for \c prefetch() on a later run.
+ */
+void VirtualFileSystem::saveAccessLog(const char * filePath) const {
+    std::vector<std::string> paths = getAccessLog();
+
+    std::ofstream out(filePath, std::ios::out | std::ios::trunc);
+    for (const std::string & path : paths) {
+        out << path << '\n';
+    }
+
+    if (!out) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to write access log " << filePath
+                     << " within method VirtualFileSystem::saveAccessLog";
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void VirtualFileSystem::clearAccessLog() {
+    std::lock_guard<std::mutex> lock(accessLogMutex);
+    accessLog.clear();
+    accessedPaths.clear();
+}
+
+//----------------------------------------------------------------------------------------
+// Snapshot of the mounted backends, so that reads do not hold the lock during I/O.
+std::vector<std::shared_ptr<VirtualFileSystem::Backend>> VirtualFileSystem::getBackends() const {
+    std::lock_guard<std::mutex> lock(backendMutex);
+    return backends;
+}
+
+//----------------------------------------------------------------------------------------
+void VirtualFileSystem::recordAccess(const char * path) {
+    std::lock_guard<std::mutex> lock(accessLogMutex);
+    if (!recordAccesses) {
+        return;
+    }
+
+    std::string normalizedPath = AssetPack::normalizePath(path);
+    if (accessedPaths.insert(normalizedPath).second) {
+        accessLog.push_back(normalizedPath);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void VirtualFileSystem::ioLoop() {
+    while (true) {
+        ReadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(requestMutex);
+            requestAvailable.wait(lock, [this] {
+                return shuttingDown || !requests.empty();
+            });
+            if (requests.empty()) {
+                return;
+            }
+            request = requests.top();
+            requests.pop();
+        }
+
+        try {
+            std::vector<uint8> data;
+            read(request.path.c_str(), data);
+            request.result->set_value(std::move(data));
+        } catch (...) {
+            request.result->set_exception(std::current_exception());
+        }
+    }
+}
+
+} // end namespace Rigid3D
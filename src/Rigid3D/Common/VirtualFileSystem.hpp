@@ -0,0 +1,181 @@
+/**
+ * @brief VirtualFileSystem
+ */
+
+#ifndef RIGID3D_VIRTUAL_FILE_SYSTEM_HPP_
+#define RIGID3D_VIRTUAL_FILE_SYSTEM_HPP_
+
+#include <Rigid3D/Common/AssetPack.hpp>
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Single point of entry for reading asset files, whether they live in a
+     * directory or in an \c AssetPack.
+     *
+     * Backends are searched from the most recently mounted, so a pack of patched
+     * assets mounted last overrides the same paths in earlier packs and
+     * directories.  \c getDefault() starts out with the current working directory
+     * mounted, and is what \c ObjFileLoader, \c ShaderProgram, \c Shader,
+     * \c CookedTexture and \c MaterialLibrary::loadTexture() read through.
+     *
+     * \c readAsync() queues a read for a dedicated I/O thread.  Higher priority
+     * requests are served first, and requests of equal priority in the order they
+     * were made.
+     *
+     * Assets tend to be read in the same order on every launch.  The paths read
+     * are recorded in order of first access, and \c saveAccessLog() writes them
+     * out at exit.  On the next launch \c prefetch() replays the log as kernel
+     * read-ahead hints (posix_fadvise for files, madvise for packs), so the cold
+     * start reads are issued up front and in file order instead of one at a time
+     * as the loaders get to them.
+     *
+     * \code{.cpp}
+     *  VirtualFileSystem & files = VirtualFileSystem::getDefault();
+     *  files.mountPack("data.pack");
+     *  files.prefetch("assets.log");
+     *
+     *  std::future<std::vector<uint8>> music = files.readAsync("sounds/theme.ogg", -1);
+     *  Mesh bunny("meshes/bunny_smooth.obj");
+     *  ...
+     *  files.saveAccessLog("assets.log");
+     * \endcode
+     */
+    class VirtualFileSystem {
+    public:
+        /**
+         * Source of files for a \c VirtualFileSystem.  Implementations must be
+         * safe to call from several threads at once.
+         */
+        class Backend {
+        public:
+            virtual ~Backend();
+
+            virtual bool exists(const char * path) const = 0;
+
+            // Returns false if there is no file at 'path'.
+            virtual bool read(const char * path, std::vector<uint8> & data) const = 0;
+
+            // Hints that 'path' will be read soon.  Must not block on I/O.
+            virtual bool prefetch(const char * path) const = 0;
+        };
+
+        /**
+         * Files under a root directory, or paths as given if the root is empty.
+         */
+        class DirectoryBackend : public Backend {
+        public:
+            explicit DirectoryBackend(const char * rootDirectory = "");
+
+            virtual bool exists(const char * path) const;
+
+            virtual bool read(const char * path, std::vector<uint8> & data) const;
+
+            virtual bool prefetch(const char * path) const;
+
+        private:
+            std::string fullPath(const char * path) const;
+
+            std::string rootDirectory;
+        };
+
+        /**
+         * Entries of a memory mapped \c AssetPack.
+         */
+        class PackBackend : public Backend {
+        public:
+            explicit PackBackend(const char * packFilePath);
+
+            virtual bool exists(const char * path) const;
+
+            virtual bool read(const char * path, std::vector<uint8> & data) const;
+
+            virtual bool prefetch(const char * path) const;
+
+        private:
+            AssetPack pack;
+        };
+
+        explicit VirtualFileSystem(bool mountWorkingDirectory = true);
+
+        ~VirtualFileSystem();
+
+        static VirtualFileSystem & getDefault();
+
+        void mount(std::shared_ptr<Backend> backend);
+
+        void mountDirectory(const char * rootDirectory);
+
+        void mountPack(const char * packFilePath);
+
+        void unmountAll();
+
+        bool exists(const char * path) const;
+
+        void read(const char * path, std::vector<uint8> & data);
+
+        bool tryRead(const char * path, std::vector<uint8> & data);
+
+        std::future<std::vector<uint8>> readAsync(const char * path, int priority = 0);
+
+        uint32 prefetch(const char * accessLogFilePath) const;
+
+        void setRecordAccesses(bool record);
+
+        std::vector<std::string> getAccessLog() const;
+
+        void saveAccessLog(const char * filePath) const;
+
+        void clearAccessLog();
+
+    private:
+        // Non-copyable, owns the I/O thread.
+        VirtualFileSystem(const VirtualFileSystem &);
+        VirtualFileSystem & operator = (const VirtualFileSystem &);
+
+        struct ReadRequest {
+            int priority;
+            uint64 sequence;
+            std::string path;
+            std::shared_ptr<std::promise<std::vector<uint8>>> result;
+
+            // Orders the priority queue, highest priority then lowest sequence first.
+            bool operator < (const ReadRequest & other) const;
+        };
+
+        std::vector<std::shared_ptr<Backend>> getBackends() const;
+
+        void recordAccess(const char * path);
+
+        void ioLoop();
+
+        std::vector<std::shared_ptr<Backend>> backends;
+        mutable std::mutex backendMutex;
+
+        std::vector<std::string> accessLog;
+        std::unordered_set<std::string> accessedPaths;
+        bool recordAccesses;
+        mutable std::mutex accessLogMutex;
+
+        std::priority_queue<ReadRequest> requests;
+        uint64 nextSequence;
+        std::thread ioThread;
+        std::mutex requestMutex;
+        std::condition_variable requestAvailable;
+        bool shuttingDown;
+    };
+
+}
+
+#endif /* RIGID3D_VIRTUAL_FILE_SYSTEM_HPP_ */
@@ -0,0 +1,489 @@
+#include "AsyncUploader.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+namespace Rigid3D {
+
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    bool isCubeMapFace(GLenum target) {
+        return target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X &&
+               target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z;
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+TextureUpload::TextureUpload()
+    : texture(0),
+      target(GL_TEXTURE_2D),
+      level(0),
+      internalFormat(0),
+      xOffset(0),
+      yOffset(0),
+      width(0),
+      height(0),
+      format(GL_RGBA),
+      type(GL_UNSIGNED_BYTE) {
+
+}
+
+//----------------------------------------------------------------------------------------
+AsyncUploader::Stats::Stats()
+    : numUploadsCompleted(0),
+      numBytesUploaded(0),
+      numPending(0),
+      busySeconds(0.0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return average upload throughput of the worker while it was busy.
+ */
+double AsyncUploader::Stats::getBytesPerSecond() const {
+    return busySeconds > 0.0 ? double(numBytesUploaded) / busySeconds : 0.0;
+}
+
+//----------------------------------------------------------------------------------------
+AsyncUploader::Request::Request()
+    : id(0),
+      priority(0),
+      type(RequestType::BufferData),
+      buffer(0),
+      usage(0),
+      offset(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+AsyncUploader::AsyncUploader()
+    : workerFailed(false),
+      nextId(1),
+      stopRequested(false) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Stops the worker.  Fences still in flight are leaked unless \c stop() was called
+ * beforehand with the render context current.
+ */
+AsyncUploader::~AsyncUploader() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopRequested = true;
+        }
+        requestAvailable.notify_all();
+        worker.join();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Launches the upload thread.
+ *
+ * @param makeContextCurrent - called first on the upload thread, must make a
+ * context current that shares objects with the render context.
+ * @param releaseContext - called last on the upload thread.
+ */
+void AsyncUploader::start(ContextFunction makeContextCurrent, ContextFunction releaseContext) {
+    if (worker.joinable()) {
+        std::stringstream errorMessage;
+        errorMessage << "Upload thread already running within method AsyncUploader::start";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    stopRequested = false;
+    workerException = nullptr;
+    workerFailed = false;
+    worker = std::thread(&AsyncUploader::workerLoop, this, makeContextCurrent, releaseContext);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Finishes the upload in progress, discards requests still queued and joins the
+ * upload thread.  Uploads already issued become complete, once the render context
+ * has been made to wait on their fences.  Discarded uploads report
+ * \c Status::Cancelled and are never issued.
+ *
+ * @note Must be called on the render thread, since fences still in flight are
+ * waited on and deleted.
+ */
+void AsyncUploader::stop() {
+    if (!worker.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopRequested = true;
+    }
+    requestAvailable.notify_all();
+    worker.join();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const FinishedUpload & upload : finishedUploads) {
+        glWaitSync(upload.fence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(upload.fence);
+    }
+    finishedUploads.clear();
+    for (auto & upload : inFlight) {
+        glWaitSync(upload.second, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(upload.second);
+    }
+    inFlight.clear();
+
+    cancelledIds.insert(pendingIds.begin(), pendingIds.end());
+    requests.clear();
+    pendingIds.clear();
+    stats.numPending = 0;
+}
+
+//----------------------------------------------------------------------------------------
+bool AsyncUploader::isRunning() const {
+    return worker.joinable();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues a glBufferData call, replacing the storage of 'buffer' with 'data'.
+ *
+ * @param priority - requests with higher priority are uploaded first.
+ */
+AsyncUploader::UploadId AsyncUploader::uploadBufferData(GLuint buffer,
+                                                        std::vector<unsigned char> data,
+                                                        GLenum usage,
+                                                        int priority) {
+    Request request;
+    request.priority = priority;
+    request.type = RequestType::BufferData;
+    request.buffer = buffer;
+    request.usage = usage;
+    request.offset = 0;
+    request.data = std::move(data);
+
+    return enqueue(std::move(request));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues a glBufferSubData call, writing 'data' into the existing storage of
+ * 'buffer' starting at 'offset' bytes.
+ *
+ * @param priority - requests with higher priority are uploaded first.
+ */
+AsyncUploader::UploadId AsyncUploader::uploadBufferSubData(GLuint buffer,
+                                                           GLintptr offset,
+                                                           std::vector<unsigned char> data,
+                                                           int priority) {
+    Request request;
+    request.priority = priority;
+    request.type = RequestType::BufferSubData;
+    request.buffer = buffer;
+    request.usage = 0;
+    request.offset = offset;
+    request.data = std::move(data);
+
+    return enqueue(std::move(request));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues an upload of 'pixels' to one level of a 2D texture or cube map face.
+ * Rows of 'pixels' are tightly packed.
+ *
+ * @param priority - requests with higher priority are uploaded first.
+ */
+AsyncUploader::UploadId AsyncUploader::uploadTexture(const TextureUpload & destination,
+                                                     std::vector<unsigned char> pixels,
+                                                     int priority) {
+    Request request;
+    request.priority = priority;
+    request.type = RequestType::Texture;
+    request.buffer = 0;
+    request.usage = 0;
+    request.offset = 0;
+    request.texture = destination;
+    request.data = std::move(pixels);
+
+    return enqueue(std::move(request));
+}
+
+//----------------------------------------------------------------------------------------
+bool AsyncUploader::runsAfter(const Request & a, const Request & b) {
+    if (a.priority != b.priority) {
+        return a.priority < b.priority;
+    }
+    return a.id > b.id;
+}
+
+//----------------------------------------------------------------------------------------
+AsyncUploader::UploadId AsyncUploader::enqueue(Request request) {
+    UploadId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = nextId++;
+        request.id = id;
+
+        requests.push_back(std::move(request));
+        std::push_heap(requests.begin(), requests.end(), runsAfter);
+
+        pendingIds.insert(id);
+        stats.numPending = pendingIds.size();
+    }
+    requestAvailable.notify_one();
+
+    return id;
+}
+
+//----------------------------------------------------------------------------------------
+void AsyncUploader::workerLoop(ContextFunction makeContextCurrent,
+                               ContextFunction releaseContext) {
+    GLuint stagingBuffer = 0;
+
+    try {
+        makeContextCurrent();
+        glGenBuffers(1, &stagingBuffer);
+
+        for (;;) {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                requestAvailable.wait(lock, [this] {
+                    return stopRequested || !requests.empty();
+                });
+                if (stopRequested) {
+                    break;
+                }
+
+                std::pop_heap(requests.begin(), requests.end(), runsAfter);
+                request = std::move(requests.back());
+                requests.pop_back();
+            }
+
+            steady_clock::time_point startTime = steady_clock::now();
+
+            execute(request, stagingBuffer);
+
+            // The fence must be flushed for other contexts to see it signal.
+            GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+            CHECK_GL_ERRORS;
+
+            duration<double> elapsed = steady_clock::now() - startTime;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                FinishedUpload upload;
+                upload.id = request.id;
+                upload.fence = fence;
+                finishedUploads.push_back(upload);
+
+                pendingIds.erase(request.id);
+                stats.numPending = pendingIds.size();
+                stats.numUploadsCompleted += 1;
+                stats.numBytesUploaded += request.data.size();
+                stats.busySeconds += elapsed.count();
+            }
+            uploadFinished.notify_all();
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        workerException = std::current_exception();
+        workerFailed = true;
+    }
+    uploadFinished.notify_all();
+
+    if (stagingBuffer != 0) {
+        glDeleteBuffers(1, &stagingBuffer);
+    }
+    releaseContext();
+}
+
+//----------------------------------------------------------------------------------------
+// Ran on the upload thread.
+void AsyncUploader::execute(Request & request, GLuint stagingBuffer) {
+    const GLsizeiptr numBytes = GLsizeiptr(request.data.size());
+
+    switch (request.type) {
+        case RequestType::BufferData:
+            glBindBuffer(GL_COPY_WRITE_BUFFER, request.buffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, numBytes, request.data.data(), request.usage);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            break;
+
+        case RequestType::BufferSubData:
+            glBindBuffer(GL_COPY_WRITE_BUFFER, request.buffer);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, request.offset, numBytes,
+                    request.data.data());
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            break;
+
+        case RequestType::Texture: {
+            const TextureUpload & texture = request.texture;
+
+            // Orphan the staging buffer so writing it never waits on the previous
+            // transfer out of it.
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, numBytes, NULL, GL_STREAM_DRAW);
+            if (numBytes > 0) {
+                void * staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, numBytes,
+                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+                std::memcpy(staging, request.data.data(), request.data.size());
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            }
+
+            GLenum bindTarget = isCubeMapFace(texture.target) ? GL_TEXTURE_CUBE_MAP :
+                                                                texture.target;
+            glBindTexture(bindTarget, texture.texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            if (texture.internalFormat != 0) {
+                glTexImage2D(texture.target, texture.level, texture.internalFormat,
+                        texture.width, texture.height, 0, texture.format, texture.type,
+                        reinterpret_cast<void *>(0));
+            } else {
+                glTexSubImage2D(texture.target, texture.level, texture.xOffset,
+                        texture.yOffset, texture.width, texture.height, texture.format,
+                        texture.type, reinterpret_cast<void *>(0));
+            }
+
+            glBindTexture(bindTarget, 0);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            break;
+        }
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Retires uploads whose fences have signaled, making \c isComplete() true for them.
+ * Rethrows any exception raised on the upload thread.
+ *
+ * @note Must be called on the render thread, typically once per frame.
+ */
+void AsyncUploader::processCompleted() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const FinishedUpload & upload : finishedUploads) {
+            inFlight[upload.id] = upload.fence;
+        }
+        finishedUploads.clear();
+
+        if (workerException) {
+            std::exception_ptr exception = workerException;
+            workerException = nullptr;
+            std::rethrow_exception(exception);
+        }
+    }
+
+    for (auto upload = inFlight.begin(); upload != inFlight.end(); ) {
+        GLenum result = glClientWaitSync(upload->second, 0, 0);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+            glDeleteSync(upload->second);
+            upload = inFlight.erase(upload);
+        } else {
+            ++upload;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return \c Status::Complete once the upload 'id' has been retired by
+ * \c processCompleted(), \c waitForCompletion() or \c stop(), after which the
+ * destination object may be used on the render context.  Ids that were never
+ * returned by an upload method are \c Status::Pending.
+ */
+AsyncUploader::Status AsyncUploader::getStatus(UploadId id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (id == 0 || id >= nextId) {
+        return Status::Pending;
+    }
+    if (cancelledIds.count(id) != 0) {
+        return Status::Cancelled;
+    }
+    if (pendingIds.count(id) != 0 || inFlight.count(id) != 0) {
+        return Status::Pending;
+    }
+    for (const FinishedUpload & upload : finishedUploads) {
+        if (upload.id == id) {
+            return Status::Pending;
+        }
+    }
+
+    return Status::Complete;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if \c getStatus(id) is \c Status::Complete.  Cancelled uploads are
+ * never complete.
+ */
+bool AsyncUploader::isComplete(UploadId id) const {
+    return getStatus(id) == Status::Complete;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Blocks until the upload thread has issued upload 'id', then makes the current
+ * context wait on the GPU for it to finish, without stalling the calling thread on
+ * the transfer itself.
+ *
+ * Throws if the upload was cancelled by \c stop(), or can no longer be issued
+ * because the upload thread failed.
+ *
+ * @note Must be called on the render thread.
+ */
+void AsyncUploader::waitForCompletion(UploadId id) {
+    bool issued;
+    bool failed;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        uploadFinished.wait(lock, [this, id] {
+            return pendingIds.count(id) == 0 || workerFailed;
+        });
+        issued = pendingIds.count(id) == 0 && cancelledIds.count(id) == 0;
+        failed = workerFailed;
+    }
+
+    // Rethrows the upload thread's exception, if not already rethrown.
+    processCompleted();
+
+    if (!issued) {
+        std::stringstream errorMessage;
+        errorMessage << "Upload " << id << " was "
+                     << (failed ? "not issued, the upload thread failed," : "cancelled")
+                     << " within method AsyncUploader::waitForCompletion";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    auto upload = inFlight.find(id);
+    if (upload != inFlight.end()) {
+        glWaitSync(upload->second, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(upload->second);
+        inFlight.erase(upload);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+AsyncUploader::Stats AsyncUploader::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,199 @@
+/**
+ * @brief AsyncUploader
+ */
+
+#ifndef RIGID3D_ASYNC_UPLOADER_HPP_
+#define RIGID3D_ASYNC_UPLOADER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * Describes the destination of a texture upload.
+     *
+     * If internalFormat is zero the pixels replace a region of storage that already
+     * exists, as with glTexSubImage2D.  Otherwise storage for the whole level is
+     * (re)specified, as with glTexImage2D.  Cube map faces are uploaded by setting
+     * target to one of GL_TEXTURE_CUBE_MAP_POSITIVE_X ... NEGATIVE_Z.
+     */
+    struct TextureUpload {
+        GLuint texture;
+        GLenum target;
+        GLint level;
+        GLint internalFormat;
+        GLint xOffset;
+        GLint yOffset;
+        GLsizei width;
+        GLsizei height;
+        GLenum format;
+        GLenum type;
+
+        TextureUpload();
+    };
+
+    /**
+     * @brief Uploads buffer and texture data from a background thread that owns a
+     * second OpenGL context, shared with the render context.
+     *
+     * Large uploads, such as a consolidated vertex buffer or the six faces of a cube
+     * map, otherwise stall the render thread while the driver copies the data.  Here
+     * the render thread only queues a request and keeps drawing.  The worker drains
+     * requests highest priority first, in submission order within a priority.
+     * Texture data is staged through a pixel unpack buffer so the driver can
+     * transfer it without blocking the worker, and every upload is followed by a
+     * fence that the render thread polls to learn when the object may be used.
+     * Requests may be queued before \c start(), in which case they run as soon as
+     * the worker starts.
+     *
+     * Buffer and texture objects must be created by the caller, on any context in
+     * the share group, before uploading into them, and must not be deleted while an
+     * upload into them is pending.
+     *
+     * The make current and release functions passed to \c start() are called on the
+     * worker thread, so the context they bind must not be current on any other
+     * thread.  With GLFW this is a hidden window created with the render window as
+     * its share parameter.
+     *
+     * \code{.cpp}
+     *  uploader.start([=] { glfwMakeContextCurrent(uploadWindow); },
+     *                 [] { glfwMakeContextCurrent(NULL); });
+     *
+     *  AsyncUploader::UploadId id = uploader.uploadBufferData(vbo, std::move(vertexData),
+     *          GL_STATIC_DRAW, 1);
+     *
+     *  // Once per frame on the render thread:
+     *  uploader.processCompleted();
+     *  if (uploader.getStatus(id) == AsyncUploader::Status::Complete) {
+     *      renderable.render(context);
+     *  }
+     * \endcode
+     */
+    class AsyncUploader {
+    public:
+        typedef uint64 UploadId;
+        typedef std::function<void ()> ContextFunction;
+
+        enum class Status {
+            Pending,    // Queued, in progress, or issued but not yet retired.
+            Complete,   // The destination object may be used.
+            Cancelled   // Discarded by stop() before being issued.
+        };
+
+        struct Stats {
+            uint64 numUploadsCompleted;
+            uint64 numBytesUploaded;
+            size_t numPending;       // Queued or in progress on the worker.
+            double busySeconds;      // Worker time spent issuing uploads.
+
+            Stats();
+
+            double getBytesPerSecond() const;
+        };
+
+        AsyncUploader();
+
+        ~AsyncUploader();
+
+        void start(ContextFunction makeContextCurrent, ContextFunction releaseContext);
+
+        void stop();
+
+        bool isRunning() const;
+
+        UploadId uploadBufferData(GLuint buffer,
+                                  std::vector<unsigned char> data,
+                                  GLenum usage,
+                                  int priority = 0);
+
+        UploadId uploadBufferSubData(GLuint buffer,
+                                     GLintptr offset,
+                                     std::vector<unsigned char> data,
+                                     int priority = 0);
+
+        UploadId uploadTexture(const TextureUpload & destination,
+                               std::vector<unsigned char> pixels,
+                               int priority = 0);
+
+        void processCompleted();
+
+        Status getStatus(UploadId id) const;
+
+        bool isComplete(UploadId id) const;
+
+        void waitForCompletion(UploadId id);
+
+        Stats getStats() const;
+
+    private:
+        // Non-copyable, owns a thread and OpenGL sync objects.
+        AsyncUploader(const AsyncUploader &);
+        AsyncUploader & operator = (const AsyncUploader &);
+
+        enum class RequestType {
+            BufferData,
+            BufferSubData,
+            Texture
+        };
+
+        struct Request {
+            UploadId id;
+            int priority;
+            RequestType type;
+            GLuint buffer;
+            GLenum usage;
+            GLintptr offset;
+            TextureUpload texture;
+            std::vector<unsigned char> data;
+
+            Request();
+        };
+
+        struct FinishedUpload {
+            UploadId id;
+            GLsync fence;
+        };
+
+        // Orders the request heap so that the front holds the highest priority,
+        // earliest submitted request.
+        static bool runsAfter(const Request & a, const Request & b);
+
+        UploadId enqueue(Request request);
+
+        void workerLoop(ContextFunction makeContextCurrent, ContextFunction releaseContext);
+
+        void execute(Request & request, GLuint stagingBuffer);
+
+        // Shared between the worker and submitting threads, guarded by mutex.
+        std::thread worker;
+        mutable std::mutex mutex;
+        std::condition_variable requestAvailable;
+        std::condition_variable uploadFinished;
+        std::vector<Request> requests;
+        std::unordered_set<UploadId> pendingIds;
+        std::unordered_set<UploadId> cancelledIds;
+        std::vector<FinishedUpload> finishedUploads;
+        std::exception_ptr workerException;     // Cleared once rethrown.
+        bool workerFailed;                      // Set until the next start().
+        Stats stats;
+        UploadId nextId;
+        bool stopRequested;
+
+        // Fences not yet signaled, only accessed on the render thread.
+        std::unordered_map<UploadId, GLsync> inFlight;
+    };
+
+}
+
+#endif /* RIGID3D_ASYNC_UPLOADER_HPP_ */
@@ -0,0 +1,220 @@
+#include "CommandList.hpp"
+
+#include <cstring>
+
+namespace Rigid3D {
+
+namespace {
+
+    // Payloads hold only 4 byte scalars, so 4 byte alignment keeps every field
+    // naturally aligned.
+    const size_t commandAlignment = 4;
+
+    //------------------------------------------------------------------------------------
+    size_t alignUp(size_t numBytes) {
+        return (numBytes + commandAlignment - 1) & ~(commandAlignment - 1);
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+CommandList::CommandList()
+    : numCommands(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Removes all commands, keeping the allocated buffer for reuse.
+ */
+void CommandList::clear() {
+    bytes.clear();
+    numCommands = 0;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::reserve(size_t numBytes) {
+    bytes.reserve(numBytes);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies all commands of 'other' to the end of this list.
+ */
+void CommandList::append(const CommandList & other) {
+    bytes.insert(bytes.end(), other.bytes.begin(), other.bytes.end());
+    numCommands += other.numCommands;
+}
+
+//----------------------------------------------------------------------------------------
+template <typename T>
+T & CommandList::push(CommandType type) {
+    static_assert(sizeof(CommandHeader) % commandAlignment == 0, "Misaligned header");
+
+    const size_t payloadSize = alignUp(sizeof(T));
+    const size_t offset = bytes.size();
+    bytes.resize(offset + sizeof(CommandHeader) + payloadSize);
+
+    CommandHeader header;
+    header.type = type;
+    header.size = uint16(payloadSize);
+    std::memcpy(&bytes[offset], &header, sizeof(CommandHeader));
+
+    ++numCommands;
+
+    return *reinterpret_cast<T *>(&bytes[offset + sizeof(CommandHeader)]);
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::bindVertexArray(uint32 vertexArray) {
+    push<Commands::BindVertexArray>(CommandType::BindVertexArray).vertexArray = vertexArray;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::useProgram(uint32 program) {
+    push<Commands::UseProgram>(CommandType::UseProgram).program = program;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::bindTexture(uint32 unit, TextureTarget target, uint32 texture) {
+    Commands::BindTexture & command = push<Commands::BindTexture>(CommandType::BindTexture);
+    command.unit = unit;
+    command.target = target;
+    command.texture = texture;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::setUniform(int32 location, int32 value) {
+    Commands::SetUniformInt & command =
+            push<Commands::SetUniformInt>(CommandType::SetUniformInt);
+    command.location = location;
+    command.value = value;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::setUniform(int32 location, float value) {
+    Commands::SetUniformFloat & command =
+            push<Commands::SetUniformFloat>(CommandType::SetUniformFloat);
+    command.location = location;
+    command.value = value;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::setUniform(int32 location, const vec3 & value) {
+    Commands::SetUniformVec3 & command =
+            push<Commands::SetUniformVec3>(CommandType::SetUniformVec3);
+    command.location = location;
+    command.value = value;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::setUniform(int32 location, const vec4 & value) {
+    Commands::SetUniformVec4 & command =
+            push<Commands::SetUniformVec4>(CommandType::SetUniformVec4);
+    command.location = location;
+    command.value = value;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::setUniform(int32 location, const mat3 & value) {
+    Commands::SetUniformMat3 & command =
+            push<Commands::SetUniformMat3>(CommandType::SetUniformMat3);
+    command.location = location;
+    command.value = value;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::setUniform(int32 location, const mat4 & value) {
+    Commands::SetUniformMat4 & command =
+            push<Commands::SetUniformMat4>(CommandType::SetUniformMat4);
+    command.location = location;
+    command.value = value;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::draw(PrimitiveType primitive, uint32 first, uint32 count) {
+    Commands::Draw & command = push<Commands::Draw>(CommandType::Draw);
+    command.primitive = primitive;
+    command.first = first;
+    command.count = count;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandList::drawInstanced(PrimitiveType primitive, uint32 first, uint32 count,
+                                uint32 instanceCount) {
+    Commands::DrawInstanced & command =
+            push<Commands::DrawInstanced>(CommandType::DrawInstanced);
+    command.primitive = primitive;
+    command.first = first;
+    command.count = count;
+    command.instanceCount = instanceCount;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws 'count' indices of the bound element array buffer starting at 'firstIndex',
+ * each offset by 'baseVertex'.
+ */
+void CommandList::drawIndexed(PrimitiveType primitive, uint32 firstIndex, uint32 count,
+                              int32 baseVertex) {
+    Commands::DrawIndexed & command =
+            push<Commands::DrawIndexed>(CommandType::DrawIndexed);
+    command.primitive = primitive;
+    command.firstIndex = firstIndex;
+    command.count = count;
+    command.baseVertex = baseVertex;
+}
+
+//----------------------------------------------------------------------------------------
+bool CommandList::isEmpty() const {
+    return numCommands == 0;
+}
+
+//----------------------------------------------------------------------------------------
+size_t CommandList::getNumCommands() const {
+    return numCommands;
+}
+
+//----------------------------------------------------------------------------------------
+size_t CommandList::getNumBytes() const {
+    return bytes.size();
+}
+
+//----------------------------------------------------------------------------------------
+const unsigned char * CommandList::getData() const {
+    return bytes.data();
+}
+
+//----------------------------------------------------------------------------------------
+CommandList::Reader::Reader(const CommandList & commandList)
+    : position(commandList.bytes.data()),
+      end(commandList.bytes.data() + commandList.bytes.size()),
+      header(nullptr),
+      payload(nullptr) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Advances to the next command.
+ *
+ * @return false once every command has been visited.
+ */
+bool CommandList::Reader::next() {
+    if (position == end) {
+        return false;
+    }
+
+    header = reinterpret_cast<const CommandHeader *>(position);
+    payload = position + sizeof(CommandHeader);
+    position = payload + header->size;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+CommandType CommandList::Reader::getType() const {
+    return header->type;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,186 @@
+/**
+ * @brief CommandList
+ */
+
+#ifndef RIGID3D_COMMAND_LIST_HPP_
+#define RIGID3D_COMMAND_LIST_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * Kinds of commands stored in a \c CommandList.
+     */
+    enum class CommandType : uint16 {
+        BindVertexArray,
+        UseProgram,
+        BindTexture,
+        SetUniformInt,
+        SetUniformFloat,
+        SetUniformVec3,
+        SetUniformVec4,
+        SetUniformMat3,
+        SetUniformMat4,
+        Draw,
+        DrawInstanced,
+        DrawIndexed
+    };
+
+    enum class PrimitiveType : uint32 {
+        Points,
+        Lines,
+        Triangles,
+        TriangleStrip
+    };
+
+    enum class TextureTarget : uint32 {
+        Texture2D,
+        Texture2DArray,
+        TextureCubeMap
+    };
+
+    /**
+     * Command payloads, stored directly after their \c CommandHeader.  Handles such
+     * as programs and textures are the backend's object names, and uniform
+     * locations must already be resolved, so that recording never calls into the
+     * backend.
+     */
+    namespace Commands {
+        struct BindVertexArray { uint32 vertexArray; };
+        struct UseProgram { uint32 program; };
+        struct BindTexture { uint32 unit; TextureTarget target; uint32 texture; };
+        struct SetUniformInt { int32 location; int32 value; };
+        struct SetUniformFloat { int32 location; float value; };
+        struct SetUniformVec3 { int32 location; vec3 value; };
+        struct SetUniformVec4 { int32 location; vec4 value; };
+        struct SetUniformMat3 { int32 location; mat3 value; };
+        struct SetUniformMat4 { int32 location; mat4 value; };
+        struct Draw { PrimitiveType primitive; uint32 first; uint32 count; };
+        struct DrawInstanced {
+            PrimitiveType primitive;
+            uint32 first;
+            uint32 count;
+            uint32 instanceCount;
+        };
+        // 32 bit indices, 'firstIndex' counts indices from the start of the buffer.
+        struct DrawIndexed {
+            PrimitiveType primitive;
+            uint32 firstIndex;
+            uint32 count;
+            int32 baseVertex;
+        };
+    }
+
+    struct CommandHeader {
+        CommandType type;
+        uint16 size;  // Size in bytes of the payload following this header.
+    };
+
+    /**
+     * @brief Backend agnostic sequence of draw, bind and uniform commands, recorded
+     * into one contiguous byte buffer.
+     *
+     * Recording only writes to memory, so lists can be built on any thread and
+     * replayed later by a backend on the thread owning the graphics context, see
+     * \c GlCommandExecutor.  Separate lists may be recorded concurrently by
+     * different threads.
+     *
+     * \c clear() keeps the buffer's capacity, so a list reused every frame stops
+     * allocating once it has grown to its working size.
+     *
+     * \code{.cpp}
+     *  CommandList commandList;
+     *  commandList.useProgram(program);
+     *  commandList.bindVertexArray(vao);
+     *  commandList.setUniform(modelViewLocation, viewMatrix * modelMatrix);
+     *  commandList.draw(PrimitiveType::Triangles, batch.startIndex, batch.numIndices);
+     *
+     *  for (CommandList::Reader reader(commandList); reader.next(); ) {
+     *      if (reader.getType() == CommandType::Draw) {
+     *          const Commands::Draw & draw = reader.get<Commands::Draw>();
+     *      }
+     *  }
+     * \endcode
+     */
+    class CommandList {
+    public:
+        CommandList();
+
+        void clear();
+
+        void reserve(size_t numBytes);
+
+        void append(const CommandList & other);
+
+        void bindVertexArray(uint32 vertexArray);
+
+        void useProgram(uint32 program);
+
+        void bindTexture(uint32 unit, TextureTarget target, uint32 texture);
+
+        void setUniform(int32 location, int32 value);
+
+        void setUniform(int32 location, float value);
+
+        void setUniform(int32 location, const vec3 & value);
+
+        void setUniform(int32 location, const vec4 & value);
+
+        void setUniform(int32 location, const mat3 & value);
+
+        void setUniform(int32 location, const mat4 & value);
+
+        void draw(PrimitiveType primitive, uint32 first, uint32 count);
+
+        void drawInstanced(PrimitiveType primitive, uint32 first, uint32 count,
+                           uint32 instanceCount);
+
+        void drawIndexed(PrimitiveType primitive, uint32 firstIndex, uint32 count,
+                         int32 baseVertex);
+
+        bool isEmpty() const;
+
+        size_t getNumCommands() const;
+
+        size_t getNumBytes() const;
+
+        const unsigned char * getData() const;
+
+        /**
+         * Walks the commands of a \c CommandList in recording order.
+         */
+        class Reader {
+        public:
+            explicit Reader(const CommandList & commandList);
+
+            bool next();
+
+            CommandType getType() const;
+
+            template <typename T>
+            const T & get() const {
+                return *reinterpret_cast<const T *>(payload);
+            }
+
+        private:
+            const unsigned char * position;
+            const unsigned char * end;
+            const CommandHeader * header;
+            const unsigned char * payload;
+        };
+
+    private:
+        template <typename T>
+        T & push(CommandType type);
+
+        std::vector<unsigned char> bytes;
+        size_t numCommands;
+    };
+
+}
+
+#endif /* RIGID3D_COMMAND_LIST_HPP_ */
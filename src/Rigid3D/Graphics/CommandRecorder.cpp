@@ -0,0 +1,155 @@
+#include "CommandRecorder.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param threadPool - pool used to record slices concurrently, or nullptr to record
+ * on the calling thread.  Must outlive this object.
+ * @param grainSize - number of Renderables recorded into each CommandList.
+ */
+CommandRecorder::CommandRecorder(ThreadPool * threadPool, size_t grainSize)
+    : threadPool(threadPool),
+      grainSize(std::max<size_t>(grainSize, 1)),
+      numActiveLists(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Resolves uniform locations for the ShaderProgram of each of 'renderables' that
+ * has not been seen before.
+ *
+ * @note Requires a current OpenGL context.
+ */
+void CommandRecorder::prepare(const std::vector<Renderable *> & renderables) {
+    const ShaderProgram * lastProgram = nullptr;
+
+    for (const Renderable * renderable : renderables) {
+        const ShaderProgram * shaderProgram = renderable->getShaderProgram();
+        if (shaderProgram == nullptr || shaderProgram == lastProgram) {
+            continue;
+        }
+        lastProgram = shaderProgram;
+
+        if (!hasUniformLocations(shaderProgram)) {
+            uniformLocations[shaderProgram] = RenderableUniformLocations(*shaderProgram);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Supplies the uniform locations for 'shaderProgram' directly, replacing any
+ * previously resolved ones.
+ */
+void CommandRecorder::setUniformLocations(const ShaderProgram * shaderProgram,
+        const RenderableUniformLocations & uniformLocations) {
+    this->uniformLocations[shaderProgram] = uniformLocations;
+}
+
+//----------------------------------------------------------------------------------------
+bool CommandRecorder::hasUniformLocations(const ShaderProgram * shaderProgram) const {
+    return uniformLocations.find(shaderProgram) != uniformLocations.end();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Forgets all resolved uniform locations.  Must be called after a ShaderProgram is
+ * relinked, since linking may move its uniforms.
+ */
+void CommandRecorder::clearUniformLocations() {
+    uniformLocations.clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Records draw commands for 'renderables', in order, into one CommandList per slice.
+ * Makes no OpenGL calls.
+ *
+ * @return the recorded lists, valid until the next call to \c record().
+ */
+const std::vector<CommandList> & CommandRecorder::record(
+        const std::vector<Renderable *> & renderables,
+        const RenderContext & context) {
+
+    numActiveLists = (renderables.size() + grainSize - 1) / grainSize;
+    if (commandLists.size() < numActiveLists) {
+        commandLists.resize(numActiveLists);
+    }
+
+    // Lists beyond the active range are cleared but kept, to be reused by a later
+    // frame with more renderables.
+    for (CommandList & commandList : commandLists) {
+        commandList.clear();
+    }
+
+    if (threadPool != nullptr) {
+        threadPool->parallelFor(renderables.size(), grainSize,
+                [&](size_t begin, size_t end) {
+            recordSlice(renderables, begin, end, context);
+        });
+    } else {
+        for (size_t begin = 0; begin < renderables.size(); begin += grainSize) {
+            recordSlice(renderables, begin,
+                    std::min(begin + grainSize, renderables.size()), context);
+        }
+    }
+
+    return commandLists;
+}
+
+//----------------------------------------------------------------------------------------
+void CommandRecorder::recordSlice(const std::vector<Renderable *> & renderables,
+                                  size_t begin,
+                                  size_t end,
+                                  const RenderContext & context) {
+    CommandList & commandList = commandLists[begin / grainSize];
+
+    const ShaderProgram * lastProgram = nullptr;
+    const RenderableUniformLocations * locations = nullptr;
+
+    for (size_t i = begin; i < end; ++i) {
+        const Renderable * renderable = renderables[i];
+        const ShaderProgram * shaderProgram = renderable->getShaderProgram();
+        if (shaderProgram == nullptr) {
+            continue;
+        }
+
+        if (shaderProgram != lastProgram) {
+            auto match = uniformLocations.find(shaderProgram);
+            if (match == uniformLocations.end()) {
+                std::stringstream errorMessage;
+                errorMessage << "Uniform locations for ShaderProgram have not been "
+                             << "prepared within method CommandRecorder::record";
+                throw Rigid3DException(errorMessage.str());
+            }
+            lastProgram = shaderProgram;
+            locations = &match->second;
+        }
+
+        renderable->record(commandList, context, *locations);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the lists produced by the last call to \c record().  Trailing lists past
+ * the last recorded slice are empty.
+ */
+const std::vector<CommandList> & CommandRecorder::getCommandLists() const {
+    return commandLists;
+}
+
+//----------------------------------------------------------------------------------------
+size_t CommandRecorder::getGrainSize() const {
+    return grainSize;
+}
+
+} // end namespace Rigid3D
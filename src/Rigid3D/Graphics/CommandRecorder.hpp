@@ -0,0 +1,80 @@
+/**
+ * @brief CommandRecorder
+ */
+
+#ifndef RIGID3D_COMMAND_RECORDER_HPP_
+#define RIGID3D_COMMAND_RECORDER_HPP_
+
+#include <Rigid3D/Graphics/CommandList.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class ShaderProgram;
+    class ThreadPool;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Records draw commands for many \c Renderable objects in parallel, one
+     * \c CommandList per slice of the input.
+     *
+     * Renderables are split into consecutive slices of \c grainSize elements.  Each
+     * slice is recorded into its own list, so workers never share a buffer, and
+     * replaying the lists in order reproduces the input order exactly.  The output
+     * does not depend on the number of threads.
+     *
+     * Uniform locations must be resolved on the thread owning the OpenGL context by
+     * calling \c prepare() before \c record().  The lists are kept between frames and
+     * cleared rather than freed, so steady state recording does not allocate.
+     *
+     * \code{.cpp}
+     *  CommandRecorder recorder(&threadPool);
+     *  GlCommandExecutor executor;
+     *
+     *  recorder.prepare(visibleRenderables);
+     *  recorder.record(visibleRenderables, renderContext);
+     *  executor.execute(recorder.getCommandLists());
+     * \endcode
+     */
+    class CommandRecorder {
+    public:
+        explicit CommandRecorder(ThreadPool * threadPool = nullptr, size_t grainSize = 256);
+
+        void prepare(const std::vector<Renderable *> & renderables);
+
+        void setUniformLocations(const ShaderProgram * shaderProgram,
+                                 const RenderableUniformLocations & uniformLocations);
+
+        bool hasUniformLocations(const ShaderProgram * shaderProgram) const;
+
+        void clearUniformLocations();
+
+        const std::vector<CommandList> & record(const std::vector<Renderable *> & renderables,
+                                                const RenderContext & context);
+
+        const std::vector<CommandList> & getCommandLists() const;
+
+        size_t getGrainSize() const;
+
+    private:
+        void recordSlice(const std::vector<Renderable *> & renderables,
+                         size_t begin,
+                         size_t end,
+                         const RenderContext & context);
+
+        ThreadPool * threadPool;
+        size_t grainSize;
+        size_t numActiveLists;
+
+        std::unordered_map<const ShaderProgram *, RenderableUniformLocations> uniformLocations;
+        std::vector<CommandList> commandLists;
+    };
+
+}
+
+#endif /* RIGID3D_COMMAND_RECORDER_HPP_ */
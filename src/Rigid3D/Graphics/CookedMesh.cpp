@@ -0,0 +1,286 @@
+#include "CookedMesh.hpp"
+
+#include <Rigid3D/Common/BlockCompression.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/MeshCodec.hpp>
+#include <Rigid3D/Graphics/OccluderGenerator.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace Rigid3D {
+
+using namespace std;
+
+namespace {
+
+    const char magic[4] = {'R', '3', 'D', 'M'};
+
+    struct ChunkHeader {
+        char id[4];
+        uint32 byteSize;
+    };
+
+    //------------------------------------------------------------------------------------
+    template <typename T>
+    void writeChunk(ofstream & out, const char * id, const vector<T> & data,
+            bool compress, ThreadPool * threadPool) {
+        ChunkHeader header;
+        memcpy(header.id, id, 4);
+
+        const uint8 * payload = reinterpret_cast<const uint8 *>(data.data());
+        size_t payloadSize = data.size() * sizeof(T);
+
+        vector<uint8> stream;
+        if (compress) {
+            BlockCompression::compress(payload, payloadSize, stream,
+                    BlockCompression::DefaultBlockSize, threadPool);
+            payload = stream.data();
+            payloadSize = stream.size();
+        }
+        header.byteSize = uint32(payloadSize);
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        if (header.byteSize > 0) {
+            out.write(reinterpret_cast<const char *>(payload), header.byteSize);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    void throwMalformedChunk(const ChunkHeader & header, const char * filePath) {
+        stringstream errorMessage;
+        errorMessage << "Malformed chunk '" << string(header.id, 4) << "' in cooked mesh "
+            << filePath << " within method CookedMesh::read";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    //------------------------------------------------------------------------------------
+    template <typename T>
+    void readChunk(ifstream & in, const ChunkHeader & header, vector<T> & data,
+            bool compressed, ThreadPool * threadPool, const char * filePath) {
+        if (!compressed) {
+            if (header.byteSize % sizeof(T) != 0) {
+                throwMalformedChunk(header, filePath);
+            }
+
+            data.resize(header.byteSize / sizeof(T));
+            if (header.byteSize > 0) {
+                in.read(reinterpret_cast<char *>(data.data()), header.byteSize);
+            }
+            return;
+        }
+
+        vector<uint8> stream(header.byteSize);
+        if (header.byteSize > 0) {
+            in.read(reinterpret_cast<char *>(stream.data()), header.byteSize);
+        }
+        if (!in) {
+            return;
+        }
+
+        uint64 size = 0;
+        try {
+            size = BlockCompression::getDecompressedSize(stream.data(), stream.size());
+        } catch (const Rigid3DException &) {
+            throwMalformedChunk(header, filePath);
+        }
+        if (size % sizeof(T) != 0) {
+            throwMalformedChunk(header, filePath);
+        }
+
+        // Blocks decompress straight into the destination array.
+        data.resize(size / sizeof(T));
+        try {
+            BlockCompression::decompress(stream.data(), stream.size(),
+                    reinterpret_cast<uint8 *>(data.data()), size, threadPool);
+        } catch (const Rigid3DException &) {
+            throwMalformedChunk(header, filePath);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    bool chunkIs(const ChunkHeader & header, const char * id) {
+        return memcmp(header.id, id, 4) == 0;
+    }
+
+} // end anonymous namespace
+
+const uint32 CookedMesh::version;
+const uint32 CookedMesh::CompressedChunks;
+const uint32 CookedMesh::EncodedVertices;
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes 'mesh' and its 'occluder' to a cooked mesh file.
+ *
+ * @param filePath - destination file, overwritten if it exists.
+ * @param mesh
+ * @param occluder - may be empty.
+ * @param flags - \c CompressedChunks and/or \c EncodedVertices.
+ * @param threadPool - compresses blocks in parallel if given.
+ */
+void CookedMesh::write(const char * filePath,
+                       const Mesh & mesh,
+                       const Occluder & occluder,
+                       uint32 flags,
+                       ThreadPool * threadPool) {
+    ofstream out(filePath, ios::out | ios::binary | ios::trunc);
+    if (!out) {
+        stringstream errorMessage;
+        errorMessage << "Unable to open file " << filePath
+            << " for writing within method CookedMesh::write";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const bool compress = (flags & CompressedChunks) != 0;
+    const bool encode = (flags & EncodedVertices) != 0;
+    const uint32 numChunks = encode ? 3 : 5;
+    out.write(magic, 4);
+    out.write(reinterpret_cast<const char *>(&version), sizeof(uint32));
+    out.write(reinterpret_cast<const char *>(&numChunks), sizeof(uint32));
+    out.write(reinterpret_cast<const char *>(&flags), sizeof(uint32));
+
+    if (encode) {
+        // Already compressed by the codec, so never block compressed again.
+        vector<uint8> encodedMesh;
+        MeshCodec::encode(mesh, encodedMesh, MeshCodecSettings(), threadPool);
+        writeChunk(out, "MCDC", encodedMesh, false, threadPool);
+    } else {
+        writeChunk(out, "POS ", *(mesh.getVertexPositionVector()), compress, threadPool);
+        writeChunk(out, "NRM ", *(mesh.getVertexNormalVector()), compress, threadPool);
+        writeChunk(out, "TEX ", *(mesh.getTextureCoordVector()), compress, threadPool);
+    }
+    writeChunk(out, "OCCB", occluder.boxes, compress, threadPool);
+    writeChunk(out, "OCCT", occluder.trianglePositions, compress, threadPool);
+
+    if (!out) {
+        stringstream errorMessage;
+        errorMessage << "Error writing cooked mesh " << filePath
+            << " within method CookedMesh::write";
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes 'mesh' and its 'occluder' with \c CompressedChunks set if 'compress' is
+ * true.  Kept for callers of the earlier bool signature, so that a bool is never
+ * taken as raw flag bits.
+ */
+void CookedMesh::write(const char * filePath,
+                       const Mesh & mesh,
+                       const Occluder & occluder,
+                       bool compress,
+                       ThreadPool * threadPool) {
+    write(filePath, mesh, occluder, compress ? CompressedChunks : uint32(0), threadPool);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reads a cooked mesh file written by \c CookedMesh::write.
+ *
+ * @param filePath - path to cooked mesh file.
+ * @param mesh - receives vertex data.
+ * @param occluder - receives occluder data, left empty if the file has none.
+ * @param threadPool - decompresses blocks of compressed chunks in parallel if given.
+ */
+void CookedMesh::read(const char * filePath,
+                      Mesh & mesh,
+                      Occluder & occluder,
+                      ThreadPool * threadPool) {
+    ifstream in(filePath, ios::in | ios::binary);
+    if (!in) {
+        stringstream errorMessage;
+        errorMessage << "Unable to open cooked mesh " << filePath
+            << " within method CookedMesh::read";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    char fileMagic[4];
+    uint32 fileVersion = 0;
+    uint32 numChunks = 0;
+    in.read(fileMagic, 4);
+    in.read(reinterpret_cast<char *>(&fileVersion), sizeof(uint32));
+    in.read(reinterpret_cast<char *>(&numChunks), sizeof(uint32));
+
+    // Version 1 files have no flags and are never compressed.
+    uint32 flags = 0;
+    if (fileVersion >= 2) {
+        in.read(reinterpret_cast<char *>(&flags), sizeof(uint32));
+    }
+    const bool compressed = (flags & CompressedChunks) != 0;
+
+    if (!in || memcmp(fileMagic, magic, 4) != 0 || fileVersion > version) {
+        stringstream errorMessage;
+        errorMessage << filePath << " is not a supported cooked mesh file"
+            << " within method CookedMesh::read";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    vector<vec3> positions;
+    vector<vec3> normals;
+    vector<vec2> textureCoords;
+    vector<uint8> encodedMesh;
+    occluder.boxes.clear();
+    occluder.trianglePositions.clear();
+
+    for (uint32 i = 0; i < numChunks; ++i) {
+        ChunkHeader header;
+        in.read(reinterpret_cast<char *>(&header), sizeof(header));
+        if (!in) {
+            break;
+        }
+
+        if (chunkIs(header, "POS ")) {
+            readChunk(in, header, positions, compressed, threadPool, filePath);
+        } else if (chunkIs(header, "NRM ")) {
+            readChunk(in, header, normals, compressed, threadPool, filePath);
+        } else if (chunkIs(header, "TEX ")) {
+            readChunk(in, header, textureCoords, compressed, threadPool, filePath);
+        } else if (chunkIs(header, "MCDC")) {
+            readChunk(in, header, encodedMesh, false, threadPool, filePath);
+        } else if (chunkIs(header, "OCCB")) {
+            readChunk(in, header, occluder.boxes, compressed, threadPool, filePath);
+        } else if (chunkIs(header, "OCCT")) {
+            readChunk(in, header, occluder.trianglePositions, compressed, threadPool,
+                    filePath);
+        } else {
+            in.seekg(header.byteSize, ios::cur);
+        }
+    }
+
+    if (!in) {
+        stringstream errorMessage;
+        errorMessage << "Unexpected end of file in cooked mesh " << filePath
+            << " within method CookedMesh::read";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    if (!encodedMesh.empty()) {
+        try {
+            MeshCodec::decode(encodedMesh.data(), encodedMesh.size(), mesh, threadPool);
+        } catch (const Rigid3DException &) {
+            stringstream errorMessage;
+            errorMessage << "Malformed chunk 'MCDC' in cooked mesh " << filePath
+                << " within method CookedMesh::read";
+            throw Rigid3DException(errorMessage.str());
+        }
+        return;
+    }
+
+    mesh = Mesh(std::move(positions), std::move(normals), std::move(textureCoords));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reads only the vertex data of a cooked mesh file.
+ */
+void CookedMesh::read(const char * filePath, Mesh & mesh, ThreadPool * threadPool) {
+    Occluder occluder;
+    read(filePath, mesh, occluder, threadPool);
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,66 @@
+/**
+ * @brief CookedMesh
+ */
+
+#ifndef RIGID3D_COOKED_MESH_HPP_
+#define RIGID3D_COOKED_MESH_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+// Forward declarations
+namespace Rigid3D {
+    class Mesh;
+    struct Occluder;
+    class ThreadPool;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Reads and writes meshes in a binary, ready to load format.
+     *
+     * A cooked mesh file starts with a header followed by a list of chunks.  Each
+     * chunk is a four character identifier, a 32-bit payload size in bytes, and the
+     * raw little-endian payload:
+     *
+     * # "POS " - vertex positions, 3 floats per vertex.
+     * # "NRM " - vertex normals, 3 floats per vertex.
+     * # "TEX " - texture coordinates, 2 floats per vertex.
+     * # "OCCB" - occluder boxes, 6 floats (min, max) per box.
+     * # "OCCT" - occluder triangle positions, 3 floats per vertex.
+     * # "MCDC" - vertex data encoded by \c MeshCodec, in place of "POS ", "NRM "
+     *   and "TEX ".  Never block compressed, since the codec already is.
+     *
+     * Readers skip chunks they do not recognize.
+     *
+     * Version 2 adds a 32-bit flags field after the chunk count.  If
+     * \c CompressedChunks is set, every payload except "MCDC" is a
+     * \c BlockCompression stream, whose blocks are decompressed in parallel
+     * straight into the mesh's vertex arrays when a \c ThreadPool is given.
+     *
+     * @see OccluderGenerator
+     */
+    class CookedMesh {
+    public:
+        static void write(const char * filePath, const Mesh & mesh, const Occluder & occluder,
+                          uint32 flags = 0, ThreadPool * threadPool = nullptr);
+
+        static void write(const char * filePath, const Mesh & mesh, const Occluder & occluder,
+                          bool compress, ThreadPool * threadPool = nullptr);
+
+        static void read(const char * filePath, Mesh & mesh, Occluder & occluder,
+                         ThreadPool * threadPool = nullptr);
+
+        static void read(const char * filePath, Mesh & mesh,
+                         ThreadPool * threadPool = nullptr);
+
+        static const uint32 version = 2;
+
+        static const uint32 CompressedChunks = 1;
+
+        static const uint32 EncodedVertices = 2;
+    };
+
+}
+
+#endif /* RIGID3D_COOKED_MESH_HPP_ */
@@ -0,0 +1,212 @@
+#include "CookedTexture.hpp"
+
+#include <Rigid3D/Common/BlockCompression.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/VirtualFileSystem.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace Rigid3D {
+
+using namespace std;
+
+namespace {
+
+    const char magic[4] = {'R', '3', 'D', 'T'};
+
+    struct FileHeader {
+        char magic[4];
+        uint32 version;
+        uint32 width;
+        uint32 height;
+        uint32 flags;
+        uint32 payloadSize;
+    };
+
+} // end anonymous namespace
+
+const uint32 CookedTexture::version;
+const uint32 CookedTexture::CompressedPixels;
+
+//----------------------------------------------------------------------------------------
+CookedTexture::CookedTexture()
+    : width(0),
+      height(0),
+      compressed(false) {
+
+}
+
+//----------------------------------------------------------------------------------------
+CookedTexture::CookedTexture(const char * filePath)
+    : width(0),
+      height(0),
+      compressed(false) {
+    read(filePath);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Loads the header and payload of a cooked texture file written by
+ * \c CookedTexture::write, through \c VirtualFileSystem::getDefault().
+ * Compressed pixels stay compressed until \c decompress() is called.
+ */
+void CookedTexture::read(const char * filePath) {
+    vector<uint8> filePayload;
+    if (!VirtualFileSystem::getDefault().tryRead(filePath, filePayload)) {
+        stringstream errorMessage;
+        errorMessage << "Unable to open cooked texture " << filePath
+            << " within method CookedTexture::read";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    FileHeader header;
+    if (filePayload.size() >= sizeof(header)) {
+        memcpy(&header, filePayload.data(), sizeof(header));
+    }
+    if (filePayload.size() < sizeof(header) || memcmp(header.magic, magic, 4) != 0 ||
+            header.version > version) {
+        stringstream errorMessage;
+        errorMessage << filePath << " is not a supported cooked texture file"
+            << " within method CookedTexture::read";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const bool fileCompressed = (header.flags & CompressedPixels) != 0;
+    bool malformed = filePayload.size() - sizeof(header) < header.payloadSize;
+    filePayload.erase(filePayload.begin(), filePayload.begin() + sizeof(header));
+    if (!malformed) {
+        filePayload.resize(header.payloadSize);
+    }
+
+    const uint64 numBytes = uint64(header.width) * header.height * 4;
+    if (!malformed && fileCompressed) {
+        try {
+            malformed = BlockCompression::getDecompressedSize(filePayload.data(),
+                    filePayload.size()) != numBytes;
+        } catch (const Rigid3DException &) {
+            malformed = true;
+        }
+    } else if (!malformed) {
+        malformed = filePayload.size() != numBytes;
+    }
+
+    if (malformed) {
+        stringstream errorMessage;
+        errorMessage << "Malformed pixel data in cooked texture " << filePath
+            << " within method CookedTexture::read";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    width = header.width;
+    height = header.height;
+    compressed = fileCompressed;
+    payload.swap(filePayload);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes RGBA8 'pixels', bottom row first, to a cooked texture file.
+ *
+ * @param filePath - destination file, overwritten if it exists.
+ * @param compress - store the pixels as a block compressed stream.
+ * @param threadPool - compresses blocks in parallel if given.
+ */
+void CookedTexture::write(const char * filePath,
+                          uint32 width,
+                          uint32 height,
+                          const uint8 * pixels,
+                          bool compress,
+                          ThreadPool * threadPool) {
+    const size_t numBytes = size_t(width) * height * 4;
+
+    vector<uint8> stream;
+    const uint8 * data = pixels;
+    size_t dataSize = numBytes;
+    if (compress) {
+        BlockCompression::compress(pixels, numBytes, stream,
+                BlockCompression::DefaultBlockSize, threadPool);
+        data = stream.data();
+        dataSize = stream.size();
+    }
+
+    ofstream out(filePath, ios::out | ios::binary | ios::trunc);
+    if (!out) {
+        stringstream errorMessage;
+        errorMessage << "Unable to open file " << filePath
+            << " for writing within method CookedTexture::write";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    FileHeader header;
+    memcpy(header.magic, magic, 4);
+    header.version = version;
+    header.width = width;
+    header.height = height;
+    header.flags = compress ? CompressedPixels : 0;
+    header.payloadSize = uint32(dataSize);
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (dataSize > 0) {
+        out.write(reinterpret_cast<const char *>(data), dataSize);
+    }
+
+    if (!out) {
+        stringstream errorMessage;
+        errorMessage << "Error writing cooked texture " << filePath
+            << " within method CookedTexture::write";
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+uint32 CookedTexture::getWidth() const {
+    return width;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 CookedTexture::getHeight() const {
+    return height;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return size of the decompressed pixels in bytes.
+ */
+size_t CookedTexture::getNumBytes() const {
+    return size_t(width) * height * 4;
+}
+
+//----------------------------------------------------------------------------------------
+bool CookedTexture::isCompressed() const {
+    return compressed;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes the pixels to 'destination', which must hold \c getNumBytes() bytes.
+ *
+ * @param destination - any writable memory, including a mapped buffer object.
+ * @param threadPool - decompresses blocks in parallel if given.
+ */
+void CookedTexture::decompress(uint8 * destination, ThreadPool * threadPool) const {
+    if (compressed) {
+        BlockCompression::decompress(payload.data(), payload.size(), destination,
+                getNumBytes(), threadPool);
+    } else if (!payload.empty()) {
+        memcpy(destination, payload.data(), payload.size());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Replaces the contents of 'pixels' with the decompressed pixels, for example to
+ * pass on to \c AsyncUploader::uploadTexture().
+ */
+void CookedTexture::decompress(vector<uint8> & pixels, ThreadPool * threadPool) const {
+    pixels.resize(getNumBytes());
+    decompress(pixels.data(), threadPool);
+}
+
+} // end namespace Rigid3D
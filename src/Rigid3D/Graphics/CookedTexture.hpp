@@ -0,0 +1,80 @@
+/**
+ * @brief CookedTexture
+ */
+
+#ifndef RIGID3D_COOKED_TEXTURE_HPP_
+#define RIGID3D_COOKED_TEXTURE_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class ThreadPool;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Reads and writes RGBA8 textures in a binary, ready to upload format.
+     *
+     * A cooked texture file is a 24 byte header (magic "R3DT", version, width,
+     * height, flags and payload size) followed by the pixels, bottom row first as
+     * OpenGL expects.  If \c CompressedPixels is set the payload is a
+     * \c BlockCompression stream.
+     *
+     * Reading only loads the payload.  \c decompress() then writes the pixels to
+     * any destination, such as a persistently mapped pixel unpack buffer, with
+     * blocks decompressed in parallel when a \c ThreadPool is given.
+     *
+     * \code{.cpp}
+     *  CookedTexture texture("textures/brick.tex");
+     *  uint8 * pixels = static_cast<uint8 *>(persistentPixelBufferPtr);
+     *  texture.decompress(pixels, &threadPool);
+     *  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture.getWidth(), texture.getHeight(),
+     *          GL_RGBA, GL_UNSIGNED_BYTE, 0);
+     * \endcode
+     */
+    class CookedTexture {
+    public:
+        CookedTexture();
+
+        CookedTexture(const char * filePath);
+
+        void read(const char * filePath);
+
+        static void write(const char * filePath,
+                          uint32 width,
+                          uint32 height,
+                          const uint8 * pixels,
+                          bool compress = false,
+                          ThreadPool * threadPool = nullptr);
+
+        uint32 getWidth() const;
+
+        uint32 getHeight() const;
+
+        size_t getNumBytes() const;
+
+        bool isCompressed() const;
+
+        void decompress(uint8 * destination, ThreadPool * threadPool = nullptr) const;
+
+        void decompress(std::vector<uint8> & pixels, ThreadPool * threadPool = nullptr) const;
+
+        static const uint32 version = 1;
+
+        static const uint32 CompressedPixels = 1;
+
+    private:
+        uint32 width;
+        uint32 height;
+        bool compressed;
+        std::vector<uint8> payload;
+    };
+
+}
+
+#endif /* RIGID3D_COOKED_TEXTURE_HPP_ */
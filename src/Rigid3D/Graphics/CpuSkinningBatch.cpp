@@ -0,0 +1,281 @@
+#include "CpuSkinningBatch.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Rigid3D {
+
+namespace {
+
+    // Vertices per parallelFor chunk.
+    const size_t grainSize = 2048;
+
+    const size_t floatsPerVertex = 6;
+
+    //------------------------------------------------------------------------------------
+    // Transforms one vertex by the weighted sum of its joint matrices.
+    void skinVertex(const mat4 * palette, const uint8 * indices, const vec4 & weights,
+                    const vec3 & position, const vec3 & normal, float * result) {
+#if defined(__SSE2__)
+        __m128 c0 = _mm_setzero_ps();
+        __m128 c1 = _mm_setzero_ps();
+        __m128 c2 = _mm_setzero_ps();
+        __m128 c3 = _mm_setzero_ps();
+        for (unsigned int i = 0; i < Mesh::MaxBonesPerVertex; ++i) {
+            if (weights[i] == 0.0f) {
+                continue;
+            }
+            const float * m = glm::value_ptr(palette[indices[i]]);
+            const __m128 w = _mm_set1_ps(weights[i]);
+            c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(m), w));
+            c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(m + 4), w));
+            c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(m + 8), w));
+            c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(m + 12), w));
+        }
+
+        __m128 p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(position.x)),
+                                         _mm_mul_ps(c1, _mm_set1_ps(position.y))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(position.z)), c3));
+        __m128 n = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(normal.x)),
+                                         _mm_mul_ps(c1, _mm_set1_ps(normal.y))),
+                              _mm_mul_ps(c2, _mm_set1_ps(normal.z)));
+
+        float out[8];
+        _mm_storeu_ps(out, p);
+        _mm_storeu_ps(out + 4, n);
+        std::memcpy(result, out, 3 * sizeof(float));
+        std::memcpy(result + 3, out + 4, 3 * sizeof(float));
+#else
+        mat4 skin(0.0f);
+        for (unsigned int i = 0; i < Mesh::MaxBonesPerVertex; ++i) {
+            skin += palette[indices[i]] * weights[i];
+        }
+        vec4 p = skin * vec4(position, 1.0f);
+        vec4 n = skin * vec4(normal, 0.0f);
+        result[0] = p.x;
+        result[1] = p.y;
+        result[2] = p.z;
+        result[3] = n.x;
+        result[4] = n.y;
+        result[5] = n.z;
+#endif
+    }
+
+} // end anonymous namespace
+
+const GLuint CpuSkinningBatch::PositionLocation;
+const GLuint CpuSkinningBatch::NormalLocation;
+const uint32 CpuSkinningBatch::BytesPerVertex;
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param maxVertices - total vertices of all meshes skinned per frame.
+ *
+ * @note Requires a current OpenGL context.
+ */
+CpuSkinningBatch::CpuSkinningBatch(uint32 maxVertices)
+    : maxVertices(maxVertices),
+      numVertices(0),
+      vao(0),
+      vertexBuffer(0) {
+
+    skinnedVertices.reserve(size_t(maxVertices) * floatsPerVertex);
+
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(maxVertices) * BytesPerVertex, NULL,
+            GL_STREAM_DRAW);
+
+    glEnableVertexAttribArray(PositionLocation);
+    glVertexAttribPointer(PositionLocation, 3, GL_FLOAT, GL_FALSE, BytesPerVertex,
+            reinterpret_cast<const void *>(0));
+    glEnableVertexAttribArray(NormalLocation);
+    glVertexAttribPointer(NormalLocation, 3, GL_FLOAT, GL_FALSE, BytesPerVertex,
+            reinterpret_cast<const void *>(3 * sizeof(float)));
+
+    glBindVertexArray(GLuint(prevVao));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+CpuSkinningBatch::~CpuSkinningBatch() {
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteVertexArrays(1, &vao);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues 'mesh' to be skinned by 'palette' on the next call to \c skin.  Both must
+ * stay alive until then.
+ *
+ * @param numMatrices - size of 'palette', which every bone index of 'mesh' must
+ * lie within.
+ *
+ * @return where the skinned vertices of 'mesh' will be in the vertex buffer.
+ */
+CpuSkinningBatch::Range CpuSkinningBatch::add(const Mesh & mesh,
+                                              const mat4 * palette,
+                                              uint32 numMatrices) {
+    const uint32 meshVertices = mesh.getNumVertexPositions();
+    if (!mesh.hasBoneWeights() || mesh.getNumVertexNormals() != meshVertices) {
+        std::stringstream errorMessage;
+        errorMessage << "Mesh needs a normal and bone weights per vertex"
+                     << " within method CpuSkinningBatch::add";
+        throw Rigid3DException(errorMessage.str());
+    }
+    if (meshVertices > maxVertices - numVertices) {
+        std::stringstream errorMessage;
+        errorMessage << "Cannot add " << meshVertices << " vertices to a batch holding "
+                     << numVertices << " of " << maxVertices
+                     << " within method CpuSkinningBatch::add";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    // skinVertex() indexes the palette without checks.
+    const std::vector<uint8> & boneIndices = *mesh.getBoneIndexVector();
+    const uint8 maxBoneIndex = boneIndices.empty() ? 0 :
+            *std::max_element(boneIndices.begin(), boneIndices.end());
+    if (!boneIndices.empty() && maxBoneIndex >= numMatrices) {
+        std::stringstream errorMessage;
+        errorMessage << "Mesh uses bone " << uint32(maxBoneIndex)
+                     << " but the palette holds " << numMatrices << " matrices"
+                     << " within method CpuSkinningBatch::add";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    Entry entry;
+    entry.mesh = &mesh;
+    entry.palette = palette;
+    entry.firstVertex = numVertices;
+    entries.push_back(entry);
+
+    Range range;
+    range.firstVertex = numVertices;
+    range.numVertices = meshVertices;
+
+    numVertices += meshVertices;
+    return range;
+}
+
+//----------------------------------------------------------------------------------------
+void CpuSkinningBatch::clear() {
+    entries.clear();
+    numVertices = 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Skins every mesh added since the last \c clear, then uploads the results with
+ * one buffer update.  Vertices, rather than meshes, are split across
+ * 'threadPool', so one large mesh does not hold up the rest.
+ */
+void CpuSkinningBatch::skin(ThreadPool * threadPool) {
+    skinnedVertices.resize(size_t(numVertices) * floatsPerVertex);
+
+    if (threadPool) {
+        threadPool->parallelFor(numVertices, grainSize, [this](size_t begin, size_t end) {
+            skinRange(begin, end);
+        });
+    } else {
+        skinRange(0, numVertices);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(maxVertices) * BytesPerVertex, NULL,
+            GL_STREAM_DRAW);
+    if (numVertices > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, GLsizeiptr(numVertices) * BytesPerVertex,
+                skinnedVertices.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+void CpuSkinningBatch::skinRange(size_t begin, size_t end) {
+    // Last entry starting at or before 'begin'.
+    size_t e = std::upper_bound(entries.begin(), entries.end(), begin,
+            [](size_t vertex, const Entry & entry) {
+                return vertex < entry.firstVertex;
+            }) - entries.begin() - 1;
+
+    size_t vertex = begin;
+    while (vertex < end) {
+        const Entry & entry = entries[e];
+        const std::vector<vec3> & positions = *entry.mesh->getVertexPositionVector();
+        const std::vector<vec3> & normals = *entry.mesh->getVertexNormalVector();
+        const uint8 * boneIndices = entry.mesh->getBoneIndexVector()->data();
+        const std::vector<vec4> & boneWeights = *entry.mesh->getBoneWeightVector();
+
+        const size_t entryEnd = std::min(end, entry.firstVertex + positions.size());
+        for (; vertex < entryEnd; ++vertex) {
+            const size_t i = vertex - entry.firstVertex;
+            skinVertex(entry.palette, boneIndices + i * Mesh::MaxBonesPerVertex,
+                    boneWeights[i], positions[i], normals[i],
+                    &skinnedVertices[vertex * floatsPerVertex]);
+        }
+        ++e;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws every skinned mesh with one draw call, using the currently enabled
+ * ShaderProgram.
+ */
+void CpuSkinningBatch::draw() const {
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, GLsizei(numVertices));
+    glBindVertexArray(GLuint(prevVao));
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return skinned positions and normals from the last \c skin, 6 floats per vertex.
+ */
+const float * CpuSkinningBatch::getSkinnedVertexDataPtr() const {
+    return skinnedVertices.data();
+}
+
+//----------------------------------------------------------------------------------------
+uint32 CpuSkinningBatch::getNumVertices() const {
+    return numVertices;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint CpuSkinningBatch::getVertexArray() const {
+    return vao;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint CpuSkinningBatch::getVertexBuffer() const {
+    return vertexBuffer;
+}
+
+} // end namespace Rigid3D
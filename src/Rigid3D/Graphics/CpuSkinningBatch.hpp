@@ -0,0 +1,102 @@
+/**
+ * @brief CpuSkinningBatch
+ */
+
+#ifndef RIGID3D_CPU_SKINNING_BATCH_HPP_
+#define RIGID3D_CPU_SKINNING_BATCH_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class Mesh;
+    class ThreadPool;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Skins many meshes on the CPU into one shared vertex buffer.
+     *
+     * A deliberate alternative to \c SkinnedMesh and \c SkinningPalette, rather than
+     * a fallback for missing GL features: it suits shaders without a skinning path,
+     * crowds of small meshes that would otherwise cost a draw call each, and effects
+     * that need posed vertices on the CPU.  Skinned positions and normals are written
+     * in the same layout as \c StaticGeometryBuffer, so the batch draws with
+     * PerFragLighting.vert, and every mesh added in a frame is uploaded at once.
+     *
+     * \code{.cpp}
+     *  batch.clear();
+     *  for (Character & character : characters) {
+     *      character.range = batch.add(character.mesh, character.palette.data(),
+     *              uint32(character.palette.size()));
+     *  }
+     *  batch.skin(&threadPool);
+     *  shader.enable();
+     *  batch.draw();
+     *  shader.disable();
+     * \endcode
+     */
+    class CpuSkinningBatch {
+    public:
+        struct Range {
+            uint32 firstVertex;
+            uint32 numVertices;
+        };
+
+        explicit CpuSkinningBatch(uint32 maxVertices);
+
+        ~CpuSkinningBatch();
+
+        Range add(const Mesh & mesh, const mat4 * palette, uint32 numMatrices);
+
+        void clear();
+
+        void skin(ThreadPool * threadPool = nullptr);
+
+        void draw() const;
+
+        const float * getSkinnedVertexDataPtr() const;
+
+        uint32 getNumVertices() const;
+
+        GLuint getVertexArray() const;
+
+        GLuint getVertexBuffer() const;
+
+        static const GLuint PositionLocation = 0;
+        static const GLuint NormalLocation = 1;
+
+        static const uint32 BytesPerVertex = 24;
+
+    private:
+        // Non-copyable, owns GL buffer objects.
+        CpuSkinningBatch(const CpuSkinningBatch &);
+        CpuSkinningBatch & operator = (const CpuSkinningBatch &);
+
+        struct Entry {
+            const Mesh * mesh;
+            const mat4 * palette;
+            uint32 firstVertex;
+        };
+
+        void skinRange(size_t begin, size_t end);
+
+        uint32 maxVertices;
+        uint32 numVertices;
+        std::vector<Entry> entries;
+
+        // Interleaved skinned position and normal per vertex.
+        std::vector<float> skinnedVertices;
+
+        GLuint vao;
+        GLuint vertexBuffer;
+    };
+
+}
+
+#endif /* RIGID3D_CPU_SKINNING_BATCH_HPP_ */
@@ -0,0 +1,302 @@
+#include "DynamicResolution.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+ResolutionController::ResolutionController(const DynamicResolutionSettings & settings)
+    : settings(settings) {
+    checkSettings(settings, "ResolutionController::ResolutionController");
+    reset();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Adjusts the scale given the GPU time of a frame rendered at the current scale.
+ *
+ * @return the new scale.
+ */
+float ResolutionController::update(double gpuMilliseconds) {
+    // Positive when there is time to spare, negative when over budget.
+    double error = (settings.targetMilliseconds - gpuMilliseconds) /
+            settings.targetMilliseconds;
+
+    if (std::abs(error) <= settings.hysteresis) {
+        error = 0.0;
+    }
+
+    // Incremental form, the output is the relative change in render area, which
+    // the scale itself accumulates.
+    const double change =
+            settings.proportionalGain * (error - previousError) +
+            settings.integralGain * error +
+            settings.derivativeGain * (error - 2.0 * previousError + earlierError);
+
+    earlierError = previousError;
+    previousError = error;
+
+    if (error == 0.0) {
+        return scale;
+    }
+
+    // GPU time is taken to be proportional to the number of pixels shaded.
+    const double area = double(scale) * scale * std::max(1.0 + change, 0.0);
+    float newScale = float(std::sqrt(area));
+
+    // Rounded before limiting the step, which is at least one granule, so that
+    // rounding can neither undo a limited step nor leave the scale stuck.
+    float maxChange = settings.maxScaleChange;
+    if (settings.scaleGranularity > 0.0f) {
+        const float granularity = settings.scaleGranularity;
+        newScale = std::floor(newScale / granularity + 0.5f) * granularity;
+        maxChange = std::max(std::floor(maxChange / granularity + 1.0e-4f) * granularity,
+                granularity);
+    }
+
+    newScale = std::min(std::max(newScale, scale - maxChange), scale + maxChange);
+    scale = std::min(std::max(newScale, settings.minScale), settings.maxScale);
+
+    return scale;
+}
+
+//----------------------------------------------------------------------------------------
+float ResolutionController::getScale() const {
+    return scale;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Returns to full resolution, \c maxScale, and clears the controller's history.
+ */
+void ResolutionController::reset() {
+    scale = settings.maxScale;
+    previousError = 0.0;
+    earlierError = 0.0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Replaces the settings, keeping the current scale if it lies within the new bounds.
+ */
+void ResolutionController::setSettings(const DynamicResolutionSettings & settings) {
+    checkSettings(settings, "ResolutionController::setSettings");
+
+    this->settings = settings;
+    scale = std::min(std::max(scale, settings.minScale), settings.maxScale);
+}
+
+//----------------------------------------------------------------------------------------
+const DynamicResolutionSettings & ResolutionController::getSettings() const {
+    return settings;
+}
+
+//----------------------------------------------------------------------------------------
+void ResolutionController::checkSettings(const DynamicResolutionSettings & settings,
+                                         const char * method) {
+    if (settings.targetMilliseconds <= 0.0 || settings.minScale <= 0.0f ||
+            settings.minScale > settings.maxScale || settings.maxScaleChange <= 0.0f ||
+            settings.scaleGranularity < 0.0f) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid settings, targetMilliseconds: "
+                     << settings.targetMilliseconds << ", minScale: "
+                     << settings.minScale << ", maxScale: " << settings.maxScale
+                     << ", maxScaleChange: " << settings.maxScaleChange
+                     << ", scaleGranularity: " << settings.scaleGranularity
+                     << " within method " << method;
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param pool - supplies the offscreen render target, and must outlive this object.
+ *
+ * @note Requires a current OpenGL context.
+ */
+DynamicResolution::DynamicResolution(RenderTargetPool & pool,
+                                     const DynamicResolutionSettings & settings)
+    : pool(pool),
+      outputWidth(0),
+      outputHeight(0),
+      renderWidth(0),
+      renderHeight(0),
+      gpuMilliseconds(0.0) {
+
+    controller.setSettings(settings);
+    controller.reset();
+}
+
+//----------------------------------------------------------------------------------------
+DynamicResolution::~DynamicResolution() {
+    if (renderTarget.framebuffer != 0) {
+        pool.releaseRenderTarget(renderTarget);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets the size of the framebuffer the main pass is upsampled to, replacing the
+ * offscreen render target.  Must be called before the first frame and whenever
+ * the output framebuffer is resized.
+ */
+void DynamicResolution::resize(GLsizei outputWidth, GLsizei outputHeight) {
+    this->outputWidth = outputWidth;
+    this->outputHeight = outputHeight;
+
+    acquireRenderTarget();
+    updateRenderSize();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Updates the render size from the GPU times that have arrived since the last frame,
+ * then binds the offscreen target for the main pass and starts timing it.
+ */
+void DynamicResolution::beginFrame() {
+    if (renderTarget.framebuffer == 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Output size has not been set, call resize() first "
+                     << "within method DynamicResolution::beginFrame";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    // Only the most recent measurement is used, rescaled to the current scale.
+    bool measured = false;
+    double estimatedMilliseconds = 0.0;
+    double milliseconds;
+    while (timer.getResult(milliseconds)) {
+        const float measuredScale = pendingScales.front();
+        pendingScales.pop_front();
+
+        const float scale = controller.getScale();
+        gpuMilliseconds = milliseconds;
+        estimatedMilliseconds = milliseconds * (scale * scale) /
+                (measuredScale * measuredScale);
+        measured = true;
+    }
+
+    if (measured) {
+        controller.update(estimatedMilliseconds);
+        updateRenderSize();
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, renderTarget.framebuffer);
+    glViewport(0, 0, renderWidth, renderHeight);
+
+    if (timer.begin()) {
+        pendingScales.push_back(controller.getScale());
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Stops timing the main pass and upsamples it to 'outputFramebuffer', which is left
+ * bound with the viewport covering it.
+ */
+void DynamicResolution::endFrame(GLuint outputFramebuffer) {
+    timer.end();
+
+    const GLenum filter = (renderWidth == outputWidth && renderHeight == outputHeight) ?
+            GL_NEAREST : GL_LINEAR;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, renderTarget.framebuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFramebuffer);
+    glBlitFramebuffer(0, 0, renderWidth, renderHeight, 0, 0, outputWidth, outputHeight,
+            GL_COLOR_BUFFER_BIT, filter);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    glViewport(0, 0, outputWidth, outputHeight);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Replaces the settings.  A new \c maxScale takes effect immediately, reallocating
+ * the offscreen target if an output size has been set.
+ */
+void DynamicResolution::setSettings(const DynamicResolutionSettings & settings) {
+    const float previousMaxScale = controller.getSettings().maxScale;
+    controller.setSettings(settings);
+
+    if (renderTarget.framebuffer != 0) {
+        if (settings.maxScale != previousMaxScale) {
+            acquireRenderTarget();
+        }
+        updateRenderSize();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+const DynamicResolutionSettings & DynamicResolution::getSettings() const {
+    return controller.getSettings();
+}
+
+//----------------------------------------------------------------------------------------
+float DynamicResolution::getScale() const {
+    return controller.getScale();
+}
+
+//----------------------------------------------------------------------------------------
+GLsizei DynamicResolution::getRenderWidth() const {
+    return renderWidth;
+}
+
+//----------------------------------------------------------------------------------------
+GLsizei DynamicResolution::getRenderHeight() const {
+    return renderHeight;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the GPU time of the most recently measured main pass in milliseconds, or 0
+ * if no measurement has arrived yet.
+ */
+double DynamicResolution::getGpuMilliseconds() const {
+    return gpuMilliseconds;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the offscreen target, of which only the lower left
+ * \c getRenderWidth() by \c getRenderHeight() pixels hold the current frame.
+ */
+const RenderTarget & DynamicResolution::getRenderTarget() const {
+    return renderTarget;
+}
+
+//----------------------------------------------------------------------------------------
+void DynamicResolution::acquireRenderTarget() {
+    // The previous target may still be read by the GPU for the last upsample.
+    if (renderTarget.framebuffer != 0) {
+        pool.releaseRenderTarget(renderTarget, 1);
+    }
+
+    const float maxScale = controller.getSettings().maxScale;
+    const GLsizei width = std::max(GLsizei(std::ceil(outputWidth * maxScale)), 1);
+    const GLsizei height = std::max(GLsizei(std::ceil(outputHeight * maxScale)), 1);
+
+    RenderTargetDesc color(width, height, GL_RGBA8);
+    RenderTargetDesc depth(width, height, GL_DEPTH_COMPONENT24);
+    renderTarget = pool.acquireRenderTarget({ color }, depth);
+}
+
+//----------------------------------------------------------------------------------------
+void DynamicResolution::updateRenderSize() {
+    const float scale = controller.getScale();
+    renderWidth = std::min(std::max(GLsizei(std::lround(outputWidth * scale)), 1),
+            renderTarget.width);
+    renderHeight = std::min(std::max(GLsizei(std::lround(outputHeight * scale)), 1),
+            renderTarget.height);
+}
+
+} // end namespace Rigid3D
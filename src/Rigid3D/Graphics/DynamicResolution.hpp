@@ -0,0 +1,162 @@
+/**
+ * @brief DynamicResolution
+ */
+
+#ifndef RIGID3D_DYNAMIC_RESOLUTION_HPP_
+#define RIGID3D_DYNAMIC_RESOLUTION_HPP_
+
+#include <Rigid3D/Graphics/GpuTimer.hpp>
+#include <Rigid3D/Graphics/RenderTargetPool.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <deque>
+
+namespace Rigid3D {
+
+    /**
+     * Parameters controlling \c ResolutionController and \c DynamicResolution.
+     */
+    struct DynamicResolutionSettings {
+        double targetMilliseconds;   // GPU time budget of the timed pass.
+        float minScale;              // Bounds on the render size, as a fraction of
+        float maxScale;              // the output size along each axis.
+        float hysteresis;            // Relative error from the target within which
+                                     // the scale is left unchanged.
+        float proportionalGain;
+        float integralGain;
+        float derivativeGain;
+        float maxScaleChange;        // Largest change of scale in one update.
+        float scaleGranularity;      // Scales are rounded to multiples of this.
+
+        DynamicResolutionSettings()
+            : targetMilliseconds(14.0),
+              minScale(0.5f),
+              maxScale(1.0f),
+              hysteresis(0.05f),
+              proportionalGain(0.2f),
+              integralGain(0.5f),
+              derivativeGain(0.05f),
+              maxScaleChange(0.1f),
+              scaleGranularity(0.025f) { }
+    };
+
+    /**
+     * @brief Chooses a render scale that keeps measured GPU time at a target.
+     *
+     * A PID controller in incremental form acts on the relative error between the
+     * target and measured time.  Since fill-bound GPU time grows with the number of
+     * pixels shaded, each update outputs a relative change in render area, and the
+     * scale along each axis is the square root of the area.  The render area itself
+     * plays the part of the integral, so there is no separate accumulator to wind
+     * up during a long climb or while pinned at a bound.  Errors inside the
+     * \c hysteresis band count as zero and leave the scale unchanged.
+     *
+     * Each update rounds the scale to \c scaleGranularity and then moves it by at
+     * most \c maxScaleChange, or one granule if that is larger, so the render size
+     * changes in a few visible steps rather than a little every frame.
+     */
+    class ResolutionController {
+    public:
+        explicit ResolutionController(
+                const DynamicResolutionSettings & settings = DynamicResolutionSettings());
+
+        float update(double gpuMilliseconds);
+
+        float getScale() const;
+
+        void reset();
+
+        void setSettings(const DynamicResolutionSettings & settings);
+
+        const DynamicResolutionSettings & getSettings() const;
+
+    private:
+        static void checkSettings(const DynamicResolutionSettings & settings,
+                                  const char * method);
+
+        DynamicResolutionSettings settings;
+        float scale;
+        double previousError;
+        double earlierError;
+    };
+
+    /**
+     * @brief Renders the main pass into an offscreen target at a resolution that
+     * adapts to measured GPU time, then upsamples it to the output framebuffer.
+     *
+     * When a scene becomes fill-rate bound, lowering the resolution keeps the frame
+     * within a fixed time budget rather than dropping frames.  \c beginFrame() binds
+     * the offscreen target with its viewport set to the current render size and
+     * starts a \c GpuTimer, and \c endFrame() stops the timer and blits the rendered
+     * region to the output with linear filtering.  GPU times arrive a few frames
+     * late, so each one is first rescaled by the ratio of pixel counts between the
+     * frame it measured and the current one before it is passed to the
+     * \c ResolutionController.
+     *
+     * The offscreen target is acquired from a \c RenderTargetPool at the largest
+     * render size, \c maxScale times the output size, and only the viewport changes
+     * with the scale.  Resolution changes therefore never reallocate anything, and
+     * the target is only replaced when the output is resized.
+     *
+     * \code{.cpp}
+     *  DynamicResolution dynamicResolution(pool);
+     *  dynamicResolution.resize(framebufferWidth, framebufferHeight);
+     *  ...
+     *  dynamicResolution.beginFrame();
+     *  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+     *  drawScene();
+     *  dynamicResolution.endFrame();
+     * \endcode
+     */
+    class DynamicResolution {
+    public:
+        explicit DynamicResolution(RenderTargetPool & pool,
+                const DynamicResolutionSettings & settings = DynamicResolutionSettings());
+
+        ~DynamicResolution();
+
+        void resize(GLsizei outputWidth, GLsizei outputHeight);
+
+        void beginFrame();
+
+        void endFrame(GLuint outputFramebuffer = 0);
+
+        void setSettings(const DynamicResolutionSettings & settings);
+
+        const DynamicResolutionSettings & getSettings() const;
+
+        float getScale() const;
+
+        GLsizei getRenderWidth() const;
+
+        GLsizei getRenderHeight() const;
+
+        double getGpuMilliseconds() const;
+
+        const RenderTarget & getRenderTarget() const;
+
+    private:
+        // Non-copyable, owns GL objects.
+        DynamicResolution(const DynamicResolution &);
+        DynamicResolution & operator = (const DynamicResolution &);
+
+        void acquireRenderTarget();
+
+        void updateRenderSize();
+
+        RenderTargetPool & pool;
+        ResolutionController controller;
+        GpuTimer timer;
+        std::deque<float> pendingScales;   // Scale of each frame the timer measures.
+        RenderTarget renderTarget;
+        GLsizei outputWidth;
+        GLsizei outputHeight;
+        GLsizei renderWidth;
+        GLsizei renderHeight;
+        double gpuMilliseconds;            // Latest measurement, 0 until one arrives.
+    };
+
+}
+
+#endif /* RIGID3D_DYNAMIC_RESOLUTION_HPP_ */
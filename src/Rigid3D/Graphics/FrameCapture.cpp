@@ -0,0 +1,341 @@
+#include "FrameCapture.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <LoadPNG/lodepng.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace Rigid3D {
+
+namespace {
+
+    const size_t bytesPerPixel = 4;
+
+    //------------------------------------------------------------------------------------
+    // OpenGL returns rows bottom-up, image files store them top-down.
+    void flipRows(std::vector<unsigned char> & pixels, int width, int height) {
+        const size_t rowSize = size_t(width) * bytesPerPixel;
+        std::vector<unsigned char> row(rowSize);
+
+        for (int top = 0, bottom = height - 1; top < bottom; ++top, --bottom) {
+            unsigned char * topRow = &pixels[size_t(top) * rowSize];
+            unsigned char * bottomRow = &pixels[size_t(bottom) * rowSize];
+            std::memcpy(row.data(), topRow, rowSize);
+            std::memcpy(topRow, bottomRow, rowSize);
+            std::memcpy(bottomRow, row.data(), rowSize);
+        }
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+FrameCapture::Stats::Stats()
+    : numFramesCaptured(0),
+      numFramesWritten(0),
+      numReadbackStalls(0),
+      numEncoderStalls(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param numReadbackBuffers - size of the pixel pack buffer ring, which is how many
+ * frames the GPU has to finish a readback before it is mapped.
+ * @param numEncoderThreads - threads encoding and writing frames.
+ * @param maxQueuedFrames - CPU frame buffers shared by frames waiting to be encoded.
+ */
+FrameCapture::FrameCapture(unsigned int numReadbackBuffers,
+                           unsigned int numEncoderThreads,
+                           unsigned int maxQueuedFrames)
+    : readbacks(std::max(numReadbackBuffers, 1u)),
+      nextReadback(0),
+      width(0),
+      height(0),
+      format(Format::Png),
+      capturing(false),
+      numFramesIssued(0),
+      encoders(std::max(numEncoderThreads, 1u)),
+      frameBuffers(std::max(maxQueuedFrames, 1u)),
+      nextFrameToWrite(0) {
+
+    for (Readback & readback : readbacks) {
+        readback.pixelBuffer = 0;
+        readback.fence = 0;
+        readback.frameIndex = 0;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Waits for frames already handed to the encoders.  Call \c end() beforehand, with
+ * the OpenGL context current, to also write frames still in the readback ring.
+ */
+FrameCapture::~FrameCapture() {
+    encoders.wait();
+
+    for (Readback & readback : readbacks) {
+        if (readback.pixelBuffer != 0) {
+            glDeleteBuffers(1, &readback.pixelBuffer);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Starts a capture of frames of 'width' by 'height' pixels.
+ *
+ * @param outputPath - file name prefix for Png, or the output file for Raw.
+ */
+void FrameCapture::begin(int width, int height, const std::string & outputPath,
+                         Format format) {
+    if (capturing) {
+        std::stringstream errorMessage;
+        errorMessage << "Capture already in progress within method FrameCapture::begin";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    this->width = width;
+    this->height = height;
+    this->outputPath = outputPath;
+    this->format = format;
+
+    if (format == Format::Raw) {
+        rawOutput.open(outputPath.c_str(), std::ios::binary | std::ios::trunc);
+        if (!rawOutput) {
+            std::stringstream errorMessage;
+            errorMessage << "Unable to open file " << outputPath
+                         << " within method FrameCapture::begin";
+            throw Rigid3DException(errorMessage.str());
+        }
+    }
+
+    const GLsizeiptr frameSize = GLsizeiptr(width) * height * bytesPerPixel;
+    for (Readback & readback : readbacks) {
+        if (readback.pixelBuffer == 0) {
+            glGenBuffers(1, &readback.pixelBuffer);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pixelBuffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameSize, NULL, GL_STREAM_READ);
+        readback.fence = 0;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeFrameBuffers.clear();
+        for (std::vector<unsigned char> & frameBuffer : frameBuffers) {
+            frameBuffer.resize(size_t(frameSize));
+            freeFrameBuffers.push_back(&frameBuffer);
+        }
+        nextFrameToWrite = 0;
+        encoderError.clear();
+        stats = Stats();
+    }
+
+    nextReadback = 0;
+    numFramesIssued = 0;
+    capturing = true;
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues a readback of the lower left 'width' by 'height' pixels of the current read
+ * framebuffer, and hands the frame read back one ring cycle ago to the encoders.
+ * Call after rendering and before swapping buffers.
+ */
+void FrameCapture::captureFrame() {
+    if (!capturing) {
+        return;
+    }
+    rethrowEncoderError("captureFrame");
+
+    Readback & readback = readbacks[nextReadback];
+    nextReadback = (nextReadback + 1) % readbacks.size();
+
+    // The oldest readback occupies the slot being reused.
+    if (readback.fence != 0) {
+        collect(readback);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pixelBuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<void *>(0));
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.frameIndex = numFramesIssued++;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++stats.numFramesCaptured;
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Collects every readback still in the ring, waits for the encoders to write all
+ * frames and closes the output.  Rethrows the first encoding error, if any.
+ */
+void FrameCapture::end() {
+    if (!capturing) {
+        return;
+    }
+    capturing = false;
+
+    // Oldest first, so Raw frames stay in order.
+    for (size_t i = 0; i < readbacks.size(); ++i) {
+        Readback & readback = readbacks[(nextReadback + i) % readbacks.size()];
+        if (readback.fence != 0) {
+            collect(readback);
+        }
+    }
+
+    encoders.wait();
+
+    if (rawOutput.is_open()) {
+        rawOutput.close();
+    }
+
+    rethrowEncoderError("end");
+}
+
+//----------------------------------------------------------------------------------------
+bool FrameCapture::isCapturing() const {
+    return capturing;
+}
+
+//----------------------------------------------------------------------------------------
+FrameCapture::Stats FrameCapture::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+// Maps a finished readback and passes a copy of its pixels to the encoders.
+void FrameCapture::collect(Readback & readback) {
+    GLenum status = glClientWaitSync(readback.fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.numReadbackStalls;
+        }
+        glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    }
+    glDeleteSync(readback.fence);
+    readback.fence = 0;
+
+    std::vector<unsigned char> * pixels = acquireFrameBuffer();
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pixelBuffer);
+    const void * mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+            GLsizeiptr(pixels->size()), GL_MAP_READ_BIT);
+    if (mapped != nullptr) {
+        std::memcpy(pixels->data(), mapped, pixels->size());
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+
+    uint64 frameIndex = readback.frameIndex;
+    encoders.submit([this, pixels, frameIndex] {
+        encode(pixels, frameIndex);
+    });
+}
+
+//----------------------------------------------------------------------------------------
+std::vector<unsigned char> * FrameCapture::acquireFrameBuffer() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (freeFrameBuffers.empty()) {
+        ++stats.numEncoderStalls;
+        frameBufferFreed.wait(lock, [this] { return !freeFrameBuffers.empty(); });
+    }
+
+    std::vector<unsigned char> * pixels = freeFrameBuffers.back();
+    freeFrameBuffers.pop_back();
+
+    return pixels;
+}
+
+//----------------------------------------------------------------------------------------
+// Ran on an encoder thread.
+void FrameCapture::encode(std::vector<unsigned char> * pixels, uint64 frameIndex) {
+    flipRows(*pixels, width, height);
+
+    std::string error;
+
+    if (format == Format::Png) {
+        std::stringstream fileName;
+        fileName << outputPath << "_" << std::setw(6) << std::setfill('0')
+                 << frameIndex << ".png";
+
+        // The C entry point, since lodepng::encode() ignores failures to open the file.
+        unsigned result = lodepng_encode32_file(fileName.str().c_str(), pixels->data(),
+                unsigned(width), unsigned(height));
+        if (result != 0) {
+            error = std::string("Unable to write ") + fileName.str() + ": " +
+                    lodepng_error_text(result);
+        }
+    } else {
+        // Frames may finish encoding out of order, so wait for this frame's turn.
+        std::unique_lock<std::mutex> lock(mutex);
+        frameWritten.wait(lock, [this, frameIndex] {
+            return nextFrameToWrite == frameIndex;
+        });
+        lock.unlock();
+
+        rawOutput.write(reinterpret_cast<const char *>(pixels->data()),
+                std::streamsize(pixels->size()));
+        if (!rawOutput) {
+            error = std::string("Unable to write to ") + outputPath;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error.empty()) {
+            ++stats.numFramesWritten;
+        } else if (encoderError.empty()) {
+            encoderError = error;
+        }
+        ++nextFrameToWrite;
+    }
+    frameWritten.notify_all();
+
+    releaseFrameBuffer(pixels);
+}
+
+//----------------------------------------------------------------------------------------
+void FrameCapture::releaseFrameBuffer(std::vector<unsigned char> * pixels) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeFrameBuffers.push_back(pixels);
+    }
+    frameBufferFreed.notify_one();
+}
+
+//----------------------------------------------------------------------------------------
+void FrameCapture::rethrowEncoderError(const char * methodName) {
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        error.swap(encoderError);
+    }
+
+    if (!error.empty()) {
+        std::stringstream errorMessage;
+        errorMessage << error << " within method FrameCapture::" << methodName;
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,133 @@
+/**
+ * @brief FrameCapture
+ */
+
+#ifndef RIGID3D_FRAME_CAPTURE_HPP_
+#define RIGID3D_FRAME_CAPTURE_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Records rendered frames to disk without stalling the render thread on
+     * readback or encoding.
+     *
+     * Each call to \c captureFrame() starts an asynchronous glReadPixels of the
+     * current read framebuffer into the next pixel pack buffer of a ring, followed by
+     * a fence.  The buffer is mapped only when the ring wraps around to it, a few
+     * frames later, by which point the GPU has normally finished the transfer.  The
+     * mapped pixels are copied into a CPU frame buffer and handed to encoder threads,
+     * which flip them to top-down row order and write either:
+     * # Png - one file per frame, named prefix_000000.png, prefix_000001.png, ...
+     *   encoded with lodepng.
+     * # Raw - all frames appended, in order, to a single file of tightly packed
+     *   RGBA8 images, suitable for ffmpeg's rawvideo demuxer.
+     *
+     * Memory is bounded by the ring size plus \c maxQueuedFrames CPU frame buffers.
+     * If the encoders fall that far behind, \c captureFrame() blocks until a buffer
+     * is free rather than dropping frames, and the wait is counted in the stats.
+     *
+     * All methods except the stats accessor must be called on the thread owning the
+     * OpenGL context.
+     *
+     * \code{.cpp}
+     *  FrameCapture capture;
+     *  capture.begin(width, height, "benchmark.rgba", FrameCapture::Format::Raw);
+     *  while (rendering) {
+     *      renderFrame();
+     *      capture.captureFrame();
+     *      glfwSwapBuffers(window);
+     *  }
+     *  capture.end();
+     * \endcode
+     */
+    class FrameCapture {
+    public:
+        enum class Format {
+            Png,
+            Raw
+        };
+
+        struct Stats {
+            uint64 numFramesCaptured;   // Readbacks issued.
+            uint64 numFramesWritten;    // Frames encoded and written to disk.
+            uint64 numReadbackStalls;   // Maps that had to wait for the GPU.
+            uint64 numEncoderStalls;    // Waits for a free CPU frame buffer.
+
+            Stats();
+        };
+
+        FrameCapture(unsigned int numReadbackBuffers = 3,
+                     unsigned int numEncoderThreads = 2,
+                     unsigned int maxQueuedFrames = 4);
+
+        ~FrameCapture();
+
+        void begin(int width, int height, const std::string & outputPath, Format format);
+
+        void captureFrame();
+
+        void end();
+
+        bool isCapturing() const;
+
+        Stats getStats() const;
+
+    private:
+        // Non-copyable, owns GL buffer objects and encoder threads.
+        FrameCapture(const FrameCapture &);
+        FrameCapture & operator = (const FrameCapture &);
+
+        struct Readback {
+            GLuint pixelBuffer;
+            GLsync fence;
+            uint64 frameIndex;
+        };
+
+        void collect(Readback & readback);
+
+        std::vector<unsigned char> * acquireFrameBuffer();
+
+        void encode(std::vector<unsigned char> * pixels, uint64 frameIndex);
+
+        void releaseFrameBuffer(std::vector<unsigned char> * pixels);
+
+        void rethrowEncoderError(const char * methodName);
+
+        std::vector<Readback> readbacks;
+        size_t nextReadback;
+
+        int width;
+        int height;
+        std::string outputPath;
+        Format format;
+        bool capturing;
+        uint64 numFramesIssued;
+
+        ThreadPool encoders;
+        std::ofstream rawOutput;
+
+        // Shared with the encoder threads, guarded by mutex.
+        mutable std::mutex mutex;
+        std::condition_variable frameBufferFreed;
+        std::condition_variable frameWritten;
+        std::vector<std::vector<unsigned char>> frameBuffers;
+        std::vector<std::vector<unsigned char> *> freeFrameBuffers;
+        uint64 nextFrameToWrite;
+        std::string encoderError;
+        Stats stats;
+    };
+
+}
+
+#endif /* RIGID3D_FRAME_CAPTURE_HPP_ */
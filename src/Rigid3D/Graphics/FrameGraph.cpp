@@ -0,0 +1,522 @@
+#include "FrameGraph.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+FrameGraph::PassBuilder::PassBuilder(FrameGraph & graph, size_t passIndex)
+    : graph(graph),
+      passIndex(passIndex) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Declares a transient render target written by this pass.
+ *
+ * @return the resource's first version.
+ */
+FrameGraph::ResourceId FrameGraph::PassBuilder::create(const std::string & name,
+                                                      const RenderTargetDesc & desc) {
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resource.imported = false;
+    resource.isFramebuffer = false;
+    resource.texture = 0;
+    resource.framebuffer = 0;
+
+    ResourceId id = graph.addResource(resource, int(passIndex));
+    graph.passes[passIndex].writes.push_back(id);
+
+    return id;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Declares that this pass samples 'resource'.
+ *
+ * @return 'resource', for convenience.
+ */
+FrameGraph::ResourceId FrameGraph::PassBuilder::read(ResourceId resource) {
+    graph.getVersion(resource, "PassBuilder::read");
+    graph.passes[passIndex].reads.push_back(resource);
+
+    return resource;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Declares that this pass renders into 'resource', on top of its current contents.
+ *
+ * @return the new version of the resource, which later passes should read.
+ */
+FrameGraph::ResourceId FrameGraph::PassBuilder::write(ResourceId resource) {
+    ResourceVersion version = graph.getVersion(resource, "PassBuilder::write");
+    version.writer = int(passIndex);
+    version.previous = resource;
+
+    ResourceId id = ResourceId(graph.versions.size());
+    graph.versions.push_back(version);
+    graph.passes[passIndex].writes.push_back(id);
+
+    return id;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Keeps this pass from being culled even if nothing reads its output, for passes
+ * that read back results or write to buffers outside the graph.
+ */
+void FrameGraph::PassBuilder::setSideEffect() {
+    graph.passes[passIndex].sideEffect = true;
+}
+
+//----------------------------------------------------------------------------------------
+FrameGraph::PassResources::PassResources(const FrameGraph & graph)
+    : graph(graph),
+      framebuffer(0),
+      width(0),
+      height(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the texture backing 'resource' while the pass executes.
+ */
+GLuint FrameGraph::PassResources::getTexture(ResourceId resource) const {
+    const ResourceVersion & version = graph.getVersion(resource, "PassResources::getTexture");
+    return graph.resources[version.resource].texture;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the framebuffer bound for this pass.  This is 0 for the default framebuffer,
+ * and also for passes that write no render targets, which leave the binding unchanged.
+ */
+GLuint FrameGraph::PassResources::getFramebuffer() const {
+    return framebuffer;
+}
+
+//----------------------------------------------------------------------------------------
+GLsizei FrameGraph::PassResources::getWidth() const {
+    return width;
+}
+
+//----------------------------------------------------------------------------------------
+GLsizei FrameGraph::PassResources::getHeight() const {
+    return height;
+}
+
+//----------------------------------------------------------------------------------------
+FrameGraph::Stats::Stats()
+    : numPasses(0),
+      numPassesCulled(0),
+      numTransientResources(0),
+      numTransientTextures(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param pool - supplies transient textures and framebuffers, and must outlive the
+ * graph.  A pool may be shared by several graphs.
+ */
+FrameGraph::FrameGraph(RenderTargetPool & pool)
+    : pool(pool),
+      compiled(false),
+      numTransientTextures(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Imports a framebuffer owned outside the graph, such as the default framebuffer 0.
+ * Passes writing it always execute.
+ */
+FrameGraph::ResourceId FrameGraph::importFramebuffer(const std::string & name,
+                                                    GLuint framebuffer,
+                                                    GLsizei width,
+                                                    GLsizei height) {
+    Resource resource;
+    resource.name = name;
+    resource.desc = RenderTargetDesc(width, height, GL_RGBA8);
+    resource.imported = true;
+    resource.isFramebuffer = true;
+    resource.texture = 0;
+    resource.framebuffer = framebuffer;
+
+    return addResource(resource, -1);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Imports a texture owned outside the graph, which passes may read or render into.
+ * Passes writing it always execute.
+ */
+FrameGraph::ResourceId FrameGraph::importTexture(const std::string & name,
+                                                GLuint texture,
+                                                const RenderTargetDesc & desc) {
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resource.imported = true;
+    resource.isFramebuffer = false;
+    resource.texture = texture;
+    resource.framebuffer = 0;
+
+    return addResource(resource, -1);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Adds a pass and immediately calls 'setup' to declare its resources, so resource
+ * ids returned by the builder can be captured for use by later passes.
+ */
+void FrameGraph::addPass(const std::string & name,
+                         const SetupFunction & setup,
+                         const ExecuteFunction & execute) {
+    if (compiled) {
+        std::stringstream errorMessage;
+        errorMessage << "Cannot add pass " << name << " after compile(), call reset() "
+                     << "first within method FrameGraph::addPass";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    Pass pass;
+    pass.name = name;
+    pass.execute = execute;
+    pass.sideEffect = false;
+    pass.culled = false;
+    passes.push_back(pass);
+
+    PassBuilder builder(*this, passes.size() - 1);
+    setup(builder);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Culls unused passes, orders the remaining ones and computes the lifetime of each
+ * transient resource.  Does not touch OpenGL.
+ */
+void FrameGraph::compile() {
+    const size_t numPasses = passes.size();
+
+    // Passes reading each version, for write-after-read ordering.
+    std::vector<std::vector<size_t>> readers(versions.size());
+    for (size_t p = 0; p < numPasses; ++p) {
+        for (ResourceId id : passes[p].reads) {
+            readers[id].push_back(p);
+        }
+    }
+
+    std::vector<std::set<size_t>> dependencies(numPasses);
+    for (size_t p = 0; p < numPasses; ++p) {
+        for (ResourceId id : passes[p].reads) {
+            const ResourceVersion & version = versions[id];
+            const Resource & resource = resources[version.resource];
+            if (version.writer < 0 && !resource.imported) {
+                std::stringstream errorMessage;
+                errorMessage << "Pass " << passes[p].name << " reads " << resource.name
+                             << " before any pass writes it within method FrameGraph::compile";
+                throw Rigid3DException(errorMessage.str());
+            }
+            if (version.writer >= 0 && size_t(version.writer) != p) {
+                dependencies[p].insert(size_t(version.writer));
+            }
+        }
+
+        for (ResourceId id : passes[p].writes) {
+            ResourceId previous = versions[id].previous;
+            if (previous == InvalidResource) {
+                continue;
+            }
+            if (versions[previous].writer >= 0 && size_t(versions[previous].writer) != p) {
+                dependencies[p].insert(size_t(versions[previous].writer));
+            }
+            for (size_t reader : readers[previous]) {
+                if (reader != p) {
+                    dependencies[p].insert(reader);
+                }
+            }
+        }
+    }
+
+    // Cull passes that nothing observable depends on.
+    std::vector<size_t> stack;
+    for (size_t p = 0; p < numPasses; ++p) {
+        Pass & pass = passes[p];
+        pass.culled = true;
+
+        bool writesImported = false;
+        bool writesFramebuffer = false;
+        size_t numTextureWrites = 0;
+        for (ResourceId id : pass.writes) {
+            const Resource & resource = resources[versions[id].resource];
+            writesImported |= resource.imported;
+            if (resource.isFramebuffer) {
+                writesFramebuffer = true;
+            } else {
+                ++numTextureWrites;
+            }
+        }
+        if (writesFramebuffer && numTextureWrites > 0) {
+            std::stringstream errorMessage;
+            errorMessage << "Pass " << pass.name << " writes both an imported framebuffer "
+                         << "and textures within method FrameGraph::compile";
+            throw Rigid3DException(errorMessage.str());
+        }
+
+        if (writesImported || pass.sideEffect) {
+            pass.culled = false;
+            stack.push_back(p);
+        }
+    }
+    while (!stack.empty()) {
+        size_t p = stack.back();
+        stack.pop_back();
+        for (size_t dependency : dependencies[p]) {
+            if (passes[dependency].culled) {
+                passes[dependency].culled = false;
+                stack.push_back(dependency);
+            }
+        }
+    }
+
+    // Topological sort, preferring the order in which passes were added.
+    std::vector<size_t> numUnresolved(numPasses, 0);
+    std::vector<std::vector<size_t>> dependents(numPasses);
+    for (size_t p = 0; p < numPasses; ++p) {
+        if (passes[p].culled) {
+            continue;
+        }
+        numUnresolved[p] = dependencies[p].size();
+        for (size_t dependency : dependencies[p]) {
+            dependents[dependency].push_back(p);
+        }
+    }
+
+    std::set<size_t> ready;
+    for (size_t p = 0; p < numPasses; ++p) {
+        if (!passes[p].culled && numUnresolved[p] == 0) {
+            ready.insert(p);
+        }
+    }
+
+    executionOrder.clear();
+    while (!ready.empty()) {
+        size_t p = *ready.begin();
+        ready.erase(ready.begin());
+        executionOrder.push_back(p);
+
+        for (size_t dependent : dependents[p]) {
+            if (--numUnresolved[dependent] == 0) {
+                ready.insert(dependent);
+            }
+        }
+    }
+
+    size_t numAlive = 0;
+    for (const Pass & pass : passes) {
+        numAlive += pass.culled ? 0 : 1;
+    }
+    if (executionOrder.size() != numAlive) {
+        std::stringstream errorMessage;
+        errorMessage << "Pass dependencies form a cycle within method FrameGraph::compile";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    // Lifetimes, as positions within the execution order.
+    for (Resource & resource : resources) {
+        resource.firstUse = -1;
+        resource.lastUse = -1;
+    }
+    for (size_t position = 0; position < executionOrder.size(); ++position) {
+        const Pass & pass = passes[executionOrder[position]];
+        for (const std::vector<ResourceId> * ids : { &pass.reads, &pass.writes }) {
+            for (ResourceId id : *ids) {
+                Resource & resource = resources[versions[id].resource];
+                if (resource.firstUse < 0) {
+                    resource.firstUse = int(position);
+                }
+                resource.lastUse = int(position);
+            }
+        }
+    }
+
+    compiled = true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Runs the surviving passes in order, compiling first if needed.  Each transient
+ * texture is acquired from the pool just before its first use and released right
+ * after its last, so a later resource of the same size and format reuses it.
+ *
+ * @note Requires a current OpenGL context.
+ */
+void FrameGraph::execute() {
+    if (!compiled) {
+        compile();
+    }
+
+    GLint prevFramebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    GLint prevViewport[4];
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+
+    std::set<GLuint> transientTextures;
+
+    for (size_t position = 0; position < executionOrder.size(); ++position) {
+        for (Resource & resource : resources) {
+            if (!resource.imported && resource.firstUse == int(position)) {
+                resource.texture = pool.acquireTexture(resource.desc);
+                transientTextures.insert(resource.texture);
+            }
+        }
+
+        executePass(passes[executionOrder[position]]);
+
+        for (Resource & resource : resources) {
+            if (!resource.imported && resource.lastUse == int(position)) {
+                pool.releaseTexture(resource.texture);
+                resource.texture = 0;
+            }
+        }
+    }
+
+    numTransientTextures = transientTextures.size();
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GLuint(prevFramebuffer));
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Removes all passes and resources so the next frame can be described.  Textures
+ * remain in the pool.
+ */
+void FrameGraph::reset() {
+    // Textures still held if a pass threw during execute().
+    for (Resource & resource : resources) {
+        if (!resource.imported && resource.texture != 0) {
+            pool.releaseTexture(resource.texture);
+        }
+    }
+
+    resources.clear();
+    versions.clear();
+    passes.clear();
+    executionOrder.clear();
+    compiled = false;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return names of the passes that survived culling, in execution order.
+ */
+std::vector<std::string> FrameGraph::getExecutionOrder() const {
+    std::vector<std::string> names;
+    for (size_t p : executionOrder) {
+        names.push_back(passes[p].name);
+    }
+
+    return names;
+}
+
+//----------------------------------------------------------------------------------------
+FrameGraph::Stats FrameGraph::getStats() const {
+    Stats stats;
+    stats.numPasses = passes.size();
+    stats.numTransientTextures = numTransientTextures;
+
+    for (const Pass & pass : passes) {
+        if (pass.culled) {
+            ++stats.numPassesCulled;
+        }
+    }
+    for (const Resource & resource : resources) {
+        if (!resource.imported && resource.firstUse >= 0) {
+            ++stats.numTransientResources;
+        }
+    }
+
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+FrameGraph::ResourceId FrameGraph::addResource(const Resource & resource, int writer) {
+    resources.push_back(resource);
+    resources.back().firstUse = -1;
+    resources.back().lastUse = -1;
+
+    ResourceVersion version;
+    version.resource = resources.size() - 1;
+    version.writer = writer;
+    version.previous = InvalidResource;
+    versions.push_back(version);
+
+    return ResourceId(versions.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------
+const FrameGraph::ResourceVersion & FrameGraph::getVersion(ResourceId resource,
+                                                           const char * methodName) const {
+    if (resource < 0 || size_t(resource) >= versions.size()) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid resource id " << resource
+                     << " within method FrameGraph::" << methodName;
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    return versions[resource];
+}
+
+//----------------------------------------------------------------------------------------
+// Binds the targets written by 'pass' and runs it.
+void FrameGraph::executePass(const Pass & pass) {
+    PassResources passResources(*this);
+
+    std::vector<GLuint> colorTextures;
+    GLuint depthTexture = 0;
+    const Resource * sizeSource = nullptr;
+
+    for (ResourceId id : pass.writes) {
+        const Resource & resource = resources[versions[id].resource];
+        if (resource.isFramebuffer) {
+            passResources.framebuffer = resource.framebuffer;
+            sizeSource = &resource;
+        } else if (resource.desc.isDepthFormat()) {
+            depthTexture = resource.texture;
+            sizeSource = sizeSource ? sizeSource : &resource;
+        } else if (std::find(colorTextures.begin(), colorTextures.end(),
+                resource.texture) == colorTextures.end()) {
+            colorTextures.push_back(resource.texture);
+            sizeSource = sizeSource ? sizeSource : &resource;
+        }
+    }
+
+    if (sizeSource != nullptr) {
+        if (!sizeSource->isFramebuffer) {
+            passResources.framebuffer = pool.getFramebuffer(colorTextures, depthTexture);
+        }
+        passResources.width = sizeSource->desc.width;
+        passResources.height = sizeSource->desc.height;
+
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, passResources.framebuffer);
+        glViewport(0, 0, passResources.width, passResources.height);
+    }
+
+    pass.execute(passResources);
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,205 @@
+/**
+ * @brief FrameGraph
+ */
+
+#ifndef RIGID3D_FRAME_GRAPH_HPP_
+#define RIGID3D_FRAME_GRAPH_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/RenderTargetPool.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Orders render passes from the resources they declare, culls passes
+     * whose results are never used, and allocates their render targets from a
+     * \c RenderTargetPool.
+     *
+     * A frame is described by adding passes, each with a setup function that
+     * declares what the pass creates, reads and writes, and an execute function
+     * that issues its draw calls.  Resources created inside the graph are transient:
+     * they only exist from the first pass that uses them to the last, and targets
+     * with disjoint lifetimes and matching formats share the same texture.  Resources
+     * owned elsewhere, such as the default framebuffer, are imported.
+     *
+     * Writing a resource produces a new version of it, so passes that read the new
+     * version run after the writer, and a writer runs after the readers and writer
+     * of the version it replaces.  Passes run in the order they were added unless a
+     * dependency requires otherwise.  A pass survives culling if it writes an
+     * imported resource, is marked as having side effects, or produces something
+     * read by a surviving pass.
+     *
+     * Before a pass executes, the graph binds a framebuffer holding the textures the
+     * pass writes, colors in declaration order followed by depth, and sets the
+     * viewport to their size.  Framebuffers come from the pool's cache.  A pass that
+     * writes an imported framebuffer has that framebuffer bound instead.
+     *
+     * \code{.cpp}
+     *  graph.reset();
+     *  FrameGraph::ResourceId backbuffer = graph.importFramebuffer("backbuffer", 0,
+     *          width, height);
+     *  FrameGraph::ResourceId shadowMap;
+     *
+     *  graph.addPass("shadow",
+     *      [&](FrameGraph::PassBuilder & builder) {
+     *          shadowMap = builder.create("shadowMap",
+     *                  RenderTargetDesc(1024, 1024, GL_DEPTH_COMPONENT24));
+     *      },
+     *      [&](const FrameGraph::PassResources &) {
+     *          glClear(GL_DEPTH_BUFFER_BIT);
+     *          drawCasters();
+     *      });
+     *
+     *  graph.addPass("main",
+     *      [&](FrameGraph::PassBuilder & builder) {
+     *          builder.read(shadowMap);
+     *          builder.write(backbuffer);
+     *      },
+     *      [&](const FrameGraph::PassResources & resources) {
+     *          glBindTexture(GL_TEXTURE_2D, resources.getTexture(shadowMap));
+     *          drawScene();
+     *      });
+     *
+     *  graph.compile();
+     *  graph.execute();
+     * \endcode
+     */
+    class FrameGraph {
+    public:
+        typedef int ResourceId;
+
+        static const ResourceId InvalidResource = -1;
+
+        class PassBuilder {
+        public:
+            ResourceId create(const std::string & name, const RenderTargetDesc & desc);
+
+            ResourceId read(ResourceId resource);
+
+            ResourceId write(ResourceId resource);
+
+            void setSideEffect();
+
+        private:
+            friend class FrameGraph;
+
+            PassBuilder(FrameGraph & graph, size_t passIndex);
+
+            FrameGraph & graph;
+            size_t passIndex;
+        };
+
+        class PassResources {
+        public:
+            GLuint getTexture(ResourceId resource) const;
+
+            GLuint getFramebuffer() const;
+
+            GLsizei getWidth() const;
+
+            GLsizei getHeight() const;
+
+        private:
+            friend class FrameGraph;
+
+            PassResources(const FrameGraph & graph);
+
+            const FrameGraph & graph;
+            GLuint framebuffer;
+            GLsizei width;
+            GLsizei height;
+        };
+
+        typedef std::function<void (PassBuilder &)> SetupFunction;
+        typedef std::function<void (const PassResources &)> ExecuteFunction;
+
+        struct Stats {
+            size_t numPasses;
+            size_t numPassesCulled;
+            size_t numTransientResources;
+            size_t numTransientTextures;   // Distinct textures backing them.
+
+            Stats();
+        };
+
+        explicit FrameGraph(RenderTargetPool & pool);
+
+        ResourceId importFramebuffer(const std::string & name,
+                                     GLuint framebuffer,
+                                     GLsizei width,
+                                     GLsizei height);
+
+        ResourceId importTexture(const std::string & name,
+                                 GLuint texture,
+                                 const RenderTargetDesc & desc);
+
+        void addPass(const std::string & name,
+                     const SetupFunction & setup,
+                     const ExecuteFunction & execute);
+
+        void compile();
+
+        void execute();
+
+        void reset();
+
+        std::vector<std::string> getExecutionOrder() const;
+
+        Stats getStats() const;
+
+    private:
+        // Non-copyable, passes hold references into the graph.
+        FrameGraph(const FrameGraph &);
+        FrameGraph & operator = (const FrameGraph &);
+
+        struct Resource {
+            std::string name;
+            RenderTargetDesc desc;
+            bool imported;
+            bool isFramebuffer;    // Imported framebuffer, rather than a texture.
+            GLuint texture;        // Imported, or acquired while executing.
+            GLuint framebuffer;
+            int firstUse;          // Positions in executionOrder, -1 if unused.
+            int lastUse;
+        };
+
+        // A ResourceId names one version of a resource.
+        struct ResourceVersion {
+            size_t resource;
+            int writer;            // Pass index, -1 for imported or not yet written.
+            ResourceId previous;   // Version this one replaced, or InvalidResource.
+        };
+
+        struct Pass {
+            std::string name;
+            ExecuteFunction execute;
+            std::vector<ResourceId> reads;
+            std::vector<ResourceId> writes;   // Includes resources the pass creates.
+            bool sideEffect;
+            bool culled;
+        };
+
+        ResourceId addResource(const Resource & resource, int writer);
+
+        const ResourceVersion & getVersion(ResourceId resource, const char * methodName) const;
+
+        void executePass(const Pass & pass);
+
+        RenderTargetPool & pool;
+        std::vector<Resource> resources;
+        std::vector<ResourceVersion> versions;
+        std::vector<Pass> passes;
+        std::vector<size_t> executionOrder;
+        bool compiled;
+        size_t numTransientTextures;   // Counted by the last execute().
+    };
+
+}
+
+#endif /* RIGID3D_FRAME_GRAPH_HPP_ */
@@ -0,0 +1,168 @@
+#include "FramePacket.hpp"
+
+#include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Graphics/CommandList.hpp>
+#include <Rigid3D/Graphics/GlCommandExecutor.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+RenderItem::RenderItem()
+    : vao(0),
+      shaderProgram(nullptr) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies the current transform, material and draw state of 'renderable'.
+ */
+RenderItem::RenderItem(const Renderable & renderable)
+    : vao(renderable.getVao()),
+      shaderProgram(const_cast<ShaderProgram *>(renderable.getShaderProgram())),
+      modelMatrix(renderable.getModelMatrix()),
+      material(renderable.getMaterial()) {
+
+    if (renderable.getBatchInfo() != nullptr) {
+        batchInfo = *renderable.getBatchInfo();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Loads this item's transform and material into its ShaderProgram and issues the
+ * draw call.  See \c Renderable for the uniforms the ShaderProgram must declare.
+ *
+ * Uniform locations are looked up on every call, so this suits one-off draws.  Many
+ * items are drawn by \c FramePacket::render(), which resolves them once per
+ * ShaderProgram.
+ */
+void RenderItem::render(const RenderContext & context) const {
+    if (vao == 0 || shaderProgram == nullptr || batchInfo.numIndices == 0) {
+        return;
+    }
+
+    CommandList commandList;
+    record(commandList, context, RenderableUniformLocations(*shaderProgram));
+
+    GlCommandExecutor executor;
+    executor.execute(commandList);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Records the commands that draw this item into 'commandList'.  Only memory is
+ * written, so items may be recorded from any thread.
+ *
+ * @param uniformLocations - locations resolved from this item's ShaderProgram.
+ */
+void RenderItem::record(CommandList & commandList,
+                        const RenderContext & context,
+                        const RenderableUniformLocations & uniformLocations) const {
+    if (vao == 0 || shaderProgram == nullptr || batchInfo.numIndices == 0) {
+        return;
+    }
+
+    mat4 modelView = context.viewMatrix * modelMatrix;
+
+    commandList.useProgram(shaderProgram->getProgramObject());
+    commandList.bindVertexArray(vao);
+
+    commandList.setUniform(uniformLocations.modelViewMatrix, modelView);
+    commandList.setUniform(uniformLocations.projectionMatrix, context.projectionMatrix);
+    commandList.setUniform(uniformLocations.normalMatrix,
+            glm::transpose(glm::inverse(mat3(modelView))));
+
+    commandList.setUniform(uniformLocations.emission, material.emission);
+    commandList.setUniform(uniformLocations.Ka, material.Ka);
+    commandList.setUniform(uniformLocations.Kd, material.Kd);
+    commandList.setUniform(uniformLocations.Ks, material.Ks);
+    commandList.setUniform(uniformLocations.shininessFactor, material.shininessFactor);
+
+    if (batchInfo.indexed) {
+        commandList.drawIndexed(PrimitiveType::Triangles, batchInfo.startIndex,
+                batchInfo.numIndices, batchInfo.baseVertex);
+    } else {
+        commandList.draw(PrimitiveType::Triangles, batchInfo.startIndex,
+                batchInfo.numIndices);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+FramePacket::FramePacket()
+    : frameNumber(0),
+      cameraPosition(0.0f),
+      viewportWidth(0),
+      viewportHeight(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Empties the packet for reuse, keeping the capacity of its containers.
+ */
+void FramePacket::clear() {
+    renderItems.clear();
+    pointLights.clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies the view and projection state of 'camera'.
+ */
+void FramePacket::setCamera(const Camera & camera) {
+    renderContext.viewMatrix = camera.getViewMatrix();
+    renderContext.projectionMatrix = camera.getProjectionMatrix();
+    cameraPosition = camera.getPosition();
+}
+
+//----------------------------------------------------------------------------------------
+void FramePacket::addRenderable(const Renderable & renderable) {
+    renderItems.push_back(RenderItem(renderable));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws every \c RenderItem in the order they were added.  All items are recorded
+ * into one CommandList and executed together, with the uniform locations of each
+ * ShaderProgram looked up once.
+ */
+void FramePacket::render() const {
+    commandList.clear();
+    uniformLocations.clear();
+
+    const ShaderProgram * lastProgram = nullptr;
+    const RenderableUniformLocations * locations = nullptr;
+
+    for (const RenderItem & item : renderItems) {
+        if (item.vao == 0 || item.shaderProgram == nullptr || item.batchInfo.numIndices == 0) {
+            continue;
+        }
+
+        if (item.shaderProgram != lastProgram) {
+            locations = nullptr;
+            for (const auto & entry : uniformLocations) {
+                if (entry.first == item.shaderProgram) {
+                    locations = &entry.second;
+                    break;
+                }
+            }
+            if (locations == nullptr) {
+                uniformLocations.push_back(std::make_pair(item.shaderProgram,
+                        RenderableUniformLocations(*item.shaderProgram)));
+                locations = &uniformLocations.back().second;
+            }
+            lastProgram = item.shaderProgram;
+        }
+
+        item.record(commandList, renderContext, *locations);
+    }
+
+    if (!commandList.isEmpty()) {
+        GlCommandExecutor executor;
+        executor.execute(commandList);
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,90 @@
+/**
+ * @brief FramePacket
+ */
+
+#ifndef RIGID3D_FRAME_PACKET_HPP_
+#define RIGID3D_FRAME_PACKET_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/CommandList.hpp>
+#include <Rigid3D/Graphics/MaterialProperties.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/PointLight.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+
+#include <OpenGL/gltypes.h>
+
+#include <utility>
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class Camera;
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * Snapshot of everything needed to draw one \c Renderable, taken at the time it
+     * was added to a \c FramePacket.  Later changes to the Renderable do not
+     * affect the snapshot.
+     */
+    struct RenderItem {
+        GLuint vao;
+        ShaderProgram * shaderProgram;
+        BatchInfo batchInfo;
+        mat4 modelMatrix;
+        MaterialProperties material;
+
+        RenderItem();
+
+        explicit RenderItem(const Renderable & renderable);
+
+        void render(const RenderContext & context) const;
+
+        void record(CommandList & commandList,
+                    const RenderContext & context,
+                    const RenderableUniformLocations & uniformLocations) const;
+    };
+
+    /**
+     * @brief The state needed to render one frame, produced by the simulation thread
+     * and consumed by the render thread.
+     *
+     * A packet holds copies rather than references to simulation objects, so the
+     * simulation may go on to modify them while the packet is being drawn.
+     * Packets are meant to be reused: \c clear() keeps the capacity of the
+     * containers, so steady state frames do not allocate.
+     *
+     * @see FramePipeline
+     */
+    struct FramePacket {
+        uint64 frameNumber;
+        RenderContext renderContext;
+        vec3 cameraPosition;
+        int viewportWidth;
+        int viewportHeight;
+        std::vector<RenderItem> renderItems;   // Visible renderables only.
+        std::vector<PointLight> pointLights;
+
+        FramePacket();
+
+        void clear();
+
+        void setCamera(const Camera & camera);
+
+        void addRenderable(const Renderable & renderable);
+
+        void render() const;
+
+        // Scratch space for render(), kept with the packet so that steady state
+        // frames reuse it.  Only touched by the thread rendering the packet.
+        mutable CommandList commandList;
+        mutable std::vector<std::pair<const ShaderProgram *, RenderableUniformLocations> >
+                uniformLocations;
+    };
+
+}
+
+#endif /* RIGID3D_FRAME_PACKET_HPP_ */
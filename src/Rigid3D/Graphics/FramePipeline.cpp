@@ -0,0 +1,179 @@
+#include "FramePipeline.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+FramePipeline::FramePipeline()
+    : stopRequested(false),
+      renderThreadFailed(false),
+      numFramesSubmitted(0),
+      numFramesRendered(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+FramePipeline::~FramePipeline() {
+    // Exceptions can not escape a destructor, call stop() directly to observe them.
+    try {
+        stop();
+    } catch (...) {
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Launches the render thread.
+ *
+ * @param threadBegin - ran once on the render thread before any packets are drawn,
+ * typically to make the OpenGL context current.  The context must not be current
+ * on any other thread at this point.
+ * @param render - draws one packet.  Called on the render thread.
+ * @param threadEnd - ran once on the render thread after the last packet is drawn,
+ * typically to release the OpenGL context.
+ */
+void FramePipeline::start(const ThreadTask & threadBegin,
+                          const RenderFunction & render,
+                          const ThreadTask & threadEnd) {
+    if (isRunning()) {
+        std::stringstream errorMessage;
+        errorMessage << "Render thread is already running within method "
+            << "FramePipeline::start";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    this->threadBegin = threadBegin;
+    this->render = render;
+    this->threadEnd = threadEnd;
+    stopRequested = false;
+
+    renderThread = std::thread(&FramePipeline::renderLoop, this);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws any packet submitted but not yet rendered, then joins the render thread.
+ * Does nothing if the render thread is not running.
+ */
+void FramePipeline::stop() {
+    if (!renderThread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopRequested = true;
+    }
+    wakeRenderThread.notify_one();
+    renderThread.join();
+
+    rethrowRenderThreadException();
+}
+
+//----------------------------------------------------------------------------------------
+bool FramePipeline::isRunning() const {
+    return renderThread.joinable();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the packet to fill for the next frame.  It holds the contents of an
+ * older frame, so call \c FramePacket::clear() before adding to it.
+ */
+FramePacket & FramePipeline::beginFrame() {
+    FramePacket & packet = packets.getWriteBuffer();
+    packet.frameNumber = numFramesSubmitted;
+    return packet;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Hands the packet returned by \c beginFrame() over to the render thread.  The
+ * packet must not be touched afterwards.
+ *
+ * @throws any exception thrown on the render thread since the last call.
+ */
+void FramePipeline::submitFrame() {
+    rethrowRenderThreadException();
+
+    packets.publish();
+    ++numFramesSubmitted;
+
+    // Taking the lock orders this wake up after the render thread's check for
+    // fresh packets, so the notification can not be missed.
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wakeRenderThread.notify_one();
+}
+
+//----------------------------------------------------------------------------------------
+uint64 FramePipeline::getNumFramesSubmitted() const {
+    return numFramesSubmitted;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the number of packets drawn so far.  Less than the number submitted
+ * when the renderer falls behind and skips packets.
+ */
+uint64 FramePipeline::getNumFramesRendered() const {
+    return numFramesRendered.load();
+}
+
+//----------------------------------------------------------------------------------------
+void FramePipeline::rethrowRenderThreadException() {
+    if (!renderThreadFailed.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // The render thread has left its loop, so joining it can not block for long.
+    if (renderThread.joinable()) {
+        renderThread.join();
+    }
+
+    std::exception_ptr exception = renderThreadException;
+    renderThreadException = nullptr;
+    renderThreadFailed.store(false);
+    std::rethrow_exception(exception);
+}
+
+//----------------------------------------------------------------------------------------
+void FramePipeline::renderLoop() {
+    try {
+        threadBegin();
+
+        while (true) {
+            bool stopping;
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeRenderThread.wait(lock, [this]() {
+                    return stopRequested || packets.hasFreshValue();
+                });
+                stopping = stopRequested;
+            }
+
+            // The last packet submitted before stop() is still drawn.
+            if (packets.acquire()) {
+                render(packets.getReadBuffer());
+                ++numFramesRendered;
+            } else if (stopping) {
+                break;
+            }
+        }
+
+        threadEnd();
+    } catch (...) {
+        renderThreadException = std::current_exception();
+        try {
+            threadEnd();
+        } catch (...) {
+        }
+        renderThreadFailed.store(true, std::memory_order_release);
+    }
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,112 @@
+/**
+ * @brief FramePipeline
+ */
+
+#ifndef RIGID3D_FRAME_PIPELINE_HPP_
+#define RIGID3D_FRAME_PIPELINE_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Common/TripleBuffer.hpp>
+#include <Rigid3D/Graphics/FramePacket.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Overlaps simulation with rendering by running them on separate threads.
+     *
+     * The simulation thread fills a \c FramePacket for frame N+1 while a dedicated
+     * render thread, which owns the OpenGL context, draws frame N.  Packets are
+     * handed over through a lock-free \c TripleBuffer, so the simulation never waits
+     * on the renderer.  If the simulation runs ahead, the renderer always draws the
+     * newest packet and older ones are dropped.
+     *
+     * The render thread sleeps while no new packet is available.  The lock used to
+     * wake it up is never held while packets are exchanged.
+     *
+     * Exceptions thrown on the render thread stop it, and are rethrown on the
+     * simulation thread by the next call to \c submitFrame() or \c stop().
+     *
+     * \code{.cpp}
+     *  glfwMakeContextCurrent(NULL);
+     *  framePipeline.start(
+     *      [&]() { glfwMakeContextCurrent(window); },
+     *      [&](const FramePacket & packet) {
+     *          glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+     *          packet.render();
+     *          glfwSwapBuffers(window);
+     *      },
+     *      [&]() { glfwMakeContextCurrent(NULL); });
+     *
+     *  while (running) {
+     *      updateSimulation();
+     *      FramePacket & packet = framePipeline.beginFrame();
+     *      packet.setCamera(camera);
+     *      for (const Renderable * renderable : visibleRenderables) {
+     *          packet.addRenderable(*renderable);
+     *      }
+     *      framePipeline.submitFrame();
+     *  }
+     *  framePipeline.stop();
+     * \endcode
+     */
+    class FramePipeline {
+    public:
+        typedef std::function<void ()> ThreadTask;
+        typedef std::function<void (const FramePacket & packet)> RenderFunction;
+
+        FramePipeline();
+
+        ~FramePipeline();
+
+        void start(const ThreadTask & threadBegin,
+                   const RenderFunction & render,
+                   const ThreadTask & threadEnd);
+
+        void stop();
+
+        bool isRunning() const;
+
+        FramePacket & beginFrame();
+
+        void submitFrame();
+
+        uint64 getNumFramesSubmitted() const;
+
+        uint64 getNumFramesRendered() const;
+
+    private:
+        // Non-copyable, owns a thread.
+        FramePipeline(const FramePipeline &);
+        FramePipeline & operator = (const FramePipeline &);
+
+        void renderLoop();
+
+        void rethrowRenderThreadException();
+
+        TripleBuffer<FramePacket> packets;
+
+        ThreadTask threadBegin;
+        RenderFunction render;
+        ThreadTask threadEnd;
+
+        std::thread renderThread;
+        std::mutex wakeMutex;
+        std::condition_variable wakeRenderThread;
+        bool stopRequested;
+        std::exception_ptr renderThreadException;
+        std::atomic<bool> renderThreadFailed;
+
+        uint64 numFramesSubmitted;
+        std::atomic<uint64> numFramesRendered;
+    };
+
+}
+
+#endif /* RIGID3D_FRAME_PIPELINE_HPP_ */
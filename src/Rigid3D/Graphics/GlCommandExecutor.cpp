@@ -0,0 +1,203 @@
+#include "GlCommandExecutor.hpp"
+
+#include <Rigid3D/Graphics/CommandList.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <OpenGL/gl3.h>
+
+namespace Rigid3D {
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    GLenum toGlPrimitive(PrimitiveType primitive) {
+        switch (primitive) {
+            case PrimitiveType::Points: return GL_POINTS;
+            case PrimitiveType::Lines: return GL_LINES;
+            case PrimitiveType::TriangleStrip: return GL_TRIANGLE_STRIP;
+            case PrimitiveType::Triangles:
+            default: return GL_TRIANGLES;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    GLenum toGlTextureTarget(TextureTarget target) {
+        switch (target) {
+            case TextureTarget::Texture2DArray: return GL_TEXTURE_2D_ARRAY;
+            case TextureTarget::TextureCubeMap: return GL_TEXTURE_CUBE_MAP;
+            case TextureTarget::Texture2D:
+            default: return GL_TEXTURE_2D;
+        }
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+GlCommandExecutor::Stats::Stats()
+    : numCommands(0),
+      numDrawCalls(0),
+      numSkippedBinds(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+GlCommandExecutor::GlCommandExecutor()
+    : currentProgram(0),
+      currentVao(0),
+      prevProgram(0),
+      prevVao(0),
+      prevActiveTexture(GL_TEXTURE0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Issues the commands of 'commandList' to the current OpenGL context.
+ */
+void GlCommandExecutor::execute(const CommandList & commandList) {
+    begin();
+    replay(commandList);
+    end();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Issues the commands of each list in 'commandLists' in order, as if they had been
+ * recorded into a single list.
+ */
+void GlCommandExecutor::execute(const std::vector<CommandList> & commandLists) {
+    begin();
+    for (const CommandList & commandList : commandLists) {
+        replay(commandList);
+    }
+    end();
+}
+
+//----------------------------------------------------------------------------------------
+void GlCommandExecutor::begin() {
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+    currentVao = GLuint(prevVao);
+
+    glGetIntegerv(GL_CURRENT_PROGRAM, &prevProgram);
+    currentProgram = GLuint(prevProgram);
+
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &prevActiveTexture);
+}
+
+//----------------------------------------------------------------------------------------
+void GlCommandExecutor::replay(const CommandList & commandList) {
+    stats.numCommands += commandList.getNumCommands();
+
+    for (CommandList::Reader reader(commandList); reader.next(); ) {
+        switch (reader.getType()) {
+            case CommandType::BindVertexArray: {
+                GLuint vao = reader.get<Commands::BindVertexArray>().vertexArray;
+                if (vao == currentVao) {
+                    ++stats.numSkippedBinds;
+                } else {
+                    glBindVertexArray(vao);
+                    currentVao = vao;
+                }
+                break;
+            }
+            case CommandType::UseProgram: {
+                GLuint program = reader.get<Commands::UseProgram>().program;
+                if (program == currentProgram) {
+                    ++stats.numSkippedBinds;
+                } else {
+                    glUseProgram(program);
+                    currentProgram = program;
+                }
+                break;
+            }
+            case CommandType::BindTexture: {
+                const Commands::BindTexture & command = reader.get<Commands::BindTexture>();
+                glActiveTexture(GL_TEXTURE0 + command.unit);
+                glBindTexture(toGlTextureTarget(command.target), command.texture);
+                break;
+            }
+            case CommandType::SetUniformInt: {
+                const Commands::SetUniformInt & command = reader.get<Commands::SetUniformInt>();
+                glUniform1i(command.location, command.value);
+                break;
+            }
+            case CommandType::SetUniformFloat: {
+                const Commands::SetUniformFloat & command =
+                        reader.get<Commands::SetUniformFloat>();
+                glUniform1f(command.location, command.value);
+                break;
+            }
+            case CommandType::SetUniformVec3: {
+                const Commands::SetUniformVec3 & command =
+                        reader.get<Commands::SetUniformVec3>();
+                glUniform3fv(command.location, 1, &command.value[0]);
+                break;
+            }
+            case CommandType::SetUniformVec4: {
+                const Commands::SetUniformVec4 & command =
+                        reader.get<Commands::SetUniformVec4>();
+                glUniform4fv(command.location, 1, &command.value[0]);
+                break;
+            }
+            case CommandType::SetUniformMat3: {
+                const Commands::SetUniformMat3 & command =
+                        reader.get<Commands::SetUniformMat3>();
+                glUniformMatrix3fv(command.location, 1, GL_FALSE, &command.value[0][0]);
+                break;
+            }
+            case CommandType::SetUniformMat4: {
+                const Commands::SetUniformMat4 & command =
+                        reader.get<Commands::SetUniformMat4>();
+                glUniformMatrix4fv(command.location, 1, GL_FALSE, &command.value[0][0]);
+                break;
+            }
+            case CommandType::Draw: {
+                const Commands::Draw & command = reader.get<Commands::Draw>();
+                glDrawArrays(toGlPrimitive(command.primitive), command.first, command.count);
+                ++stats.numDrawCalls;
+                break;
+            }
+            case CommandType::DrawInstanced: {
+                const Commands::DrawInstanced & command =
+                        reader.get<Commands::DrawInstanced>();
+                glDrawArraysInstanced(toGlPrimitive(command.primitive), command.first,
+                        command.count, command.instanceCount);
+                ++stats.numDrawCalls;
+                break;
+            }
+            case CommandType::DrawIndexed: {
+                const Commands::DrawIndexed & command =
+                        reader.get<Commands::DrawIndexed>();
+                glDrawElementsBaseVertex(toGlPrimitive(command.primitive), command.count,
+                        GL_UNSIGNED_INT,
+                        reinterpret_cast<const void *>(command.firstIndex * sizeof(GLuint)),
+                        command.baseVertex);
+                ++stats.numDrawCalls;
+                break;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void GlCommandExecutor::end() {
+    glUseProgram(GLuint(prevProgram));
+    glBindVertexArray(GLuint(prevVao));
+    glActiveTexture(GLenum(prevActiveTexture));
+    currentProgram = GLuint(prevProgram);
+    currentVao = GLuint(prevVao);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+const GlCommandExecutor::Stats & GlCommandExecutor::getStats() const {
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+void GlCommandExecutor::resetStats() {
+    stats = Stats();
+}
+
+} // end namespace Rigid3D
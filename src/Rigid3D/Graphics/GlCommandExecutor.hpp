@@ -0,0 +1,71 @@
+/**
+ * @brief GlCommandExecutor
+ */
+
+#ifndef RIGID3D_GL_COMMAND_EXECUTOR_HPP_
+#define RIGID3D_GL_COMMAND_EXECUTOR_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gltypes.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class CommandList;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Replays \c CommandList contents as OpenGL calls.
+     *
+     * Must only be used on the thread owning the current OpenGL context.  Program
+     * and vertex array binds that match the currently bound object are skipped,
+     * including across consecutive lists, so lists recorded independently by
+     * different threads can be submitted back to back without redundant state
+     * changes at their boundaries.
+     *
+     * After each call to \c execute() the program, vertex array and active texture
+     * unit are restored to what they were beforehand.  Texture bindings made by
+     * the lists are left in place.
+     */
+    class GlCommandExecutor {
+    public:
+        struct Stats {
+            size_t numCommands;
+            size_t numDrawCalls;
+            size_t numSkippedBinds;  // Redundant program or vertex array binds.
+
+            Stats();
+        };
+
+        GlCommandExecutor();
+
+        void execute(const CommandList & commandList);
+
+        void execute(const std::vector<CommandList> & commandLists);
+
+        const Stats & getStats() const;
+
+        void resetStats();
+
+    private:
+        void begin();
+
+        void replay(const CommandList & commandList);
+
+        void end();
+
+        GLuint currentProgram;
+        GLuint currentVao;
+        GLint prevProgram;
+        GLint prevVao;
+        GLint prevActiveTexture;
+        Stats stats;
+    };
+
+}
+
+#endif /* RIGID3D_GL_COMMAND_EXECUTOR_HPP_ */
@@ -0,0 +1,313 @@
+#include "GlyphAtlas.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/VirtualFileSystem.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace Rigid3D {
+
+namespace {
+
+    // Blank texels around each glyph, so that linear filtering never reads a
+    // neighbouring cell.
+    const uint32 cellPadding = 1;
+
+    //------------------------------------------------------------------------------------
+    // FreeType 26.6 fixed point to pixels, rounded up.
+    uint32 ceilPixels(long value) {
+        return uint32(std::max(0L, (value + 63) >> 6));
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+/**
+ * Opens the font at 'fontFilePath', read through \c VirtualFileSystem::getDefault(),
+ * and creates an empty atlas texture.
+ *
+ * @param pixelHeight - nominal glyph height in pixels.
+ *
+ * @note Requires a current OpenGL context.
+ */
+GlyphAtlas::GlyphAtlas(const char * fontFilePath, uint32 pixelHeight,
+                       uint32 textureWidth, uint32 textureHeight)
+    : library(nullptr),
+      face(nullptr),
+      ascender(0.0f),
+      lineHeight(0.0f),
+      texture(0),
+      textureWidth(textureWidth),
+      textureHeight(textureHeight),
+      cellWidth(0),
+      cellHeight(0),
+      numColumns(0),
+      capacity(0),
+      frame(0),
+      numRasterized(0) {
+
+    if (!VirtualFileSystem::getDefault().tryRead(fontFilePath, fontData)) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to open font " << fontFilePath
+                     << " within method GlyphAtlas::GlyphAtlas";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    if (FT_Init_FreeType(&library) != 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to initialize FreeType within method "
+                     << "GlyphAtlas::GlyphAtlas";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    if (FT_New_Memory_Face(library, fontData.data(), FT_Long(fontData.size()), 0, &face) != 0 ||
+            FT_Set_Pixel_Sizes(face, 0, pixelHeight) != 0) {
+        FT_Done_FreeType(library);
+        std::stringstream errorMessage;
+        errorMessage << fontFilePath << " is not a supported font, or has no "
+                     << pixelHeight << " pixel size, within method GlyphAtlas::GlyphAtlas";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const FT_Size_Metrics & metrics = face->size->metrics;
+    ascender = float(ceilPixels(metrics.ascender));
+    lineHeight = float(ceilPixels(metrics.height));
+
+    // Bounding box of all glyphs, at this size.
+    uint32 maxGlyphWidth = uint32(pixelHeight);
+    uint32 maxGlyphHeight = uint32(pixelHeight);
+    if (FT_IS_SCALABLE(face)) {
+        maxGlyphWidth = ceilPixels(FT_MulFix(face->bbox.xMax - face->bbox.xMin,
+                metrics.x_scale));
+        maxGlyphHeight = ceilPixels(FT_MulFix(face->bbox.yMax - face->bbox.yMin,
+                metrics.y_scale));
+    }
+    cellWidth = maxGlyphWidth + 2 * cellPadding;
+    cellHeight = maxGlyphHeight + 2 * cellPadding;
+    numColumns = textureWidth / cellWidth;
+    capacity = numColumns * (textureHeight / cellHeight);
+
+    if (capacity == 0) {
+        FT_Done_Face(face);
+        FT_Done_FreeType(library);
+        std::stringstream errorMessage;
+        errorMessage << "A " << textureWidth << "x" << textureHeight
+                     << " texture cannot hold a " << cellWidth << "x" << cellHeight
+                     << " glyph within method GlyphAtlas::GlyphAtlas";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    cellPixels.resize(size_t(cellWidth) * cellHeight);
+
+    const std::vector<uint8> blank(size_t(textureWidth) * textureHeight, 0);
+    GLint prevAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, GLsizei(textureWidth), GLsizei(textureHeight),
+            0, GL_RED, GL_UNSIGNED_BYTE, blank.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prevAlignment);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+GlyphAtlas::~GlyphAtlas() {
+    glDeleteTextures(1, &texture);
+    FT_Done_Face(face);
+    FT_Done_FreeType(library);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Starts a new frame, allowing glyphs used during previous frames to be replaced.
+ */
+void GlyphAtlas::beginFrame() {
+    ++frame;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Returns the glyph for 'codePoint', rasterizing it into the least recently used
+ * cell if it is not in the atlas.  Code points missing from the font give the
+ * font's missing glyph.
+ *
+ * @return nullptr if every cell holds a glyph used this frame.
+ *
+ * @throws Rigid3DException if FreeType cannot render the glyph, in which case the
+ * atlas is unchanged.
+ */
+const GlyphAtlas::Glyph * GlyphAtlas::findGlyph(uint32 codePoint) {
+    std::unordered_map<uint32, std::list<Entry>::iterator>::iterator found =
+            entryMap.find(codePoint);
+    if (found != entryMap.end()) {
+        std::list<Entry>::iterator entry = found->second;
+        entries.splice(entries.begin(), entries, entry);
+        entry->lastUsedFrame = frame;
+        return &entry->glyph;
+    }
+
+    // Rasterized before the cache is touched, so that a glyph FreeType cannot
+    // render leaves the atlas as it was.
+    Entry entry;
+    if (entries.size() < capacity) {
+        entry.cell = uint32(entries.size());
+    } else {
+        if (entries.back().lastUsedFrame == frame) {
+            return nullptr;
+        }
+        entry.cell = entries.back().cell;
+    }
+    entry.codePoint = codePoint;
+    entry.lastUsedFrame = frame;
+    rasterize(codePoint, entry);
+
+    if (entries.size() == capacity) {
+        entryMap.erase(entries.back().codePoint);
+        entries.pop_back();
+    }
+    entries.push_front(entry);
+    entryMap[codePoint] = entries.begin();
+    uploadCell(entry.cell);
+
+    return &entries.front().glyph;
+}
+
+//----------------------------------------------------------------------------------------
+// Renders 'codePoint' into cellPixels and fills in the glyph metrics of 'entry' for
+// its cell.  Changes nothing else, so may throw freely.
+void GlyphAtlas::rasterize(uint32 codePoint, Entry & entry) {
+    if (FT_Load_Char(face, FT_ULong(codePoint), FT_LOAD_RENDER) != 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to rasterize code point " << codePoint
+                     << " within method GlyphAtlas::rasterize";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const FT_GlyphSlot slot = face->glyph;
+    const FT_Bitmap & bitmap = slot->bitmap;
+    if (bitmap.pixel_mode != FT_PIXEL_MODE_GRAY && bitmap.pixel_mode != FT_PIXEL_MODE_MONO &&
+            bitmap.rows > 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Code point " << codePoint << " rendered with unsupported pixel "
+                     << "mode " << int(bitmap.pixel_mode)
+                     << " within method GlyphAtlas::rasterize";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const uint32 width = std::min(uint32(bitmap.width), cellWidth - 2 * cellPadding);
+    const uint32 height = std::min(uint32(bitmap.rows), cellHeight - 2 * cellPadding);
+
+    // The whole cell is uploaded, clearing what the previous glyph left.
+    std::fill(cellPixels.begin(), cellPixels.end(), uint8(0));
+    for (uint32 row = 0; row < height; ++row) {
+        const uint8 * source = bitmap.buffer + ptrdiff_t(row) * bitmap.pitch;
+        uint8 * destination = &cellPixels[(row + cellPadding) * cellWidth + cellPadding];
+        if (bitmap.pixel_mode == FT_PIXEL_MODE_MONO) {
+            // One bit per pixel, most significant bit first.
+            for (uint32 x = 0; x < width; ++x) {
+                destination[x] = ((source[x >> 3] >> (7 - (x & 7))) & 1) ? 255 : 0;
+            }
+        } else if (bitmap.num_grays != 256 && bitmap.num_grays > 1) {
+            for (uint32 x = 0; x < width; ++x) {
+                destination[x] = uint8(uint32(source[x]) * 255 / (bitmap.num_grays - 1));
+            }
+        } else {
+            memcpy(destination, source, width);
+        }
+    }
+
+    const uint32 cellX = (entry.cell % numColumns) * cellWidth;
+    const uint32 cellY = (entry.cell / numColumns) * cellHeight;
+
+    const vec2 textureSize = vec2(float(textureWidth), float(textureHeight));
+    Glyph & glyph = entry.glyph;
+    glyph.offset = vec2(float(slot->bitmap_left), -float(slot->bitmap_top));
+    glyph.size = vec2(float(width), float(height));
+    glyph.texCoordMin = vec2(float(cellX + cellPadding), float(cellY + cellPadding)) /
+            textureSize;
+    glyph.texCoordMax = glyph.texCoordMin + glyph.size / textureSize;
+    glyph.advance = float(slot->advance.x) / 64.0f;
+}
+
+//----------------------------------------------------------------------------------------
+// Copies cellPixels, as left by rasterize(), into 'cell' of the texture.
+void GlyphAtlas::uploadCell(uint32 cell) {
+    const uint32 cellX = (cell % numColumns) * cellWidth;
+    const uint32 cellY = (cell / numColumns) * cellHeight;
+
+    // Glyphs are uploaded while the caller lays out text, so its binding is kept.
+    GLint prevAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevAlignment);
+    GLint prevTexture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, GLint(cellX), GLint(cellY), GLsizei(cellWidth),
+            GLsizei(cellHeight), GL_RED, GL_UNSIGNED_BYTE, cellPixels.data());
+    glBindTexture(GL_TEXTURE_2D, GLuint(prevTexture));
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prevAlignment);
+
+    ++numRasterized;
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return distance from the top of a line to its baseline, in pixels.
+ */
+float GlyphAtlas::getAscender() const {
+    return ascender;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return distance between the baselines of consecutive lines, in pixels.
+ */
+float GlyphAtlas::getLineHeight() const {
+    return lineHeight;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint GlyphAtlas::getTexture() const {
+    return texture;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of glyphs the atlas holds at once.
+ */
+uint32 GlyphAtlas::getCapacity() const {
+    return capacity;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 GlyphAtlas::getNumGlyphs() const {
+    return uint32(entries.size());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of glyphs rasterized since construction, counting those
+ * rasterized again after being replaced.
+ */
+uint32 GlyphAtlas::getNumRasterized() const {
+    return numRasterized;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,112 @@
+/**
+ * @brief GlyphAtlas
+ */
+
+#ifndef RIGID3D_GLYPH_ATLAS_HPP_
+#define RIGID3D_GLYPH_ATLAS_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations
+struct FT_LibraryRec_;
+struct FT_FaceRec_;
+
+namespace Rigid3D {
+
+    /**
+     * @brief Texture of the glyphs of one font at one pixel size, rasterized with
+     * FreeType as they are first needed.
+     *
+     * The texture is a grid of equally sized cells, each large enough for any
+     * glyph of the face, so placing a glyph never needs packing.  When every
+     * cell is taken the least recently used glyph is replaced.  Glyphs used since
+     * the last \c beginFrame() are never replaced, since vertices already laid out
+     * this frame refer to them; \c findGlyph() returns nullptr instead.
+     *
+     * Coverage is stored in the red channel of a GL_R8 texture.  Antialiased and
+     * monochrome (embedded bitmap) glyphs are both accepted, the latter expanded to
+     * full coverage.
+     */
+    class GlyphAtlas {
+    public:
+        struct Glyph {
+            vec2 offset;        // Pen position to top left corner, pixels, y down.
+            vec2 size;          // Pixels.
+            vec2 texCoordMin;
+            vec2 texCoordMax;
+            float advance;      // Pixels.
+        };
+
+        GlyphAtlas(const char * fontFilePath, uint32 pixelHeight,
+                   uint32 textureWidth = 512, uint32 textureHeight = 512);
+
+        ~GlyphAtlas();
+
+        void beginFrame();
+
+        const Glyph * findGlyph(uint32 codePoint);
+
+        float getAscender() const;
+
+        float getLineHeight() const;
+
+        GLuint getTexture() const;
+
+        uint32 getCapacity() const;
+
+        uint32 getNumGlyphs() const;
+
+        uint32 getNumRasterized() const;
+
+    private:
+        // Non-copyable, owns the FreeType face and a GL texture.
+        GlyphAtlas(const GlyphAtlas &);
+        GlyphAtlas & operator = (const GlyphAtlas &);
+
+        struct Entry {
+            uint32 codePoint;
+            uint32 cell;
+            uint64 lastUsedFrame;
+            Glyph glyph;
+        };
+
+        void rasterize(uint32 codePoint, Entry & entry);
+
+        void uploadCell(uint32 cell);
+
+        // FreeType reads from the font data for as long as the face is open.
+        std::vector<uint8> fontData;
+        FT_LibraryRec_ * library;
+        FT_FaceRec_ * face;
+
+        float ascender;
+        float lineHeight;
+
+        GLuint texture;
+        uint32 textureWidth;
+        uint32 textureHeight;
+        uint32 cellWidth;
+        uint32 cellHeight;
+        uint32 numColumns;
+        uint32 capacity;
+
+        // Most recently used first.
+        std::list<Entry> entries;
+        std::unordered_map<uint32, std::list<Entry>::iterator> entryMap;
+
+        uint64 frame;
+        uint32 numRasterized;
+
+        // One cell of coverage, uploaded per rasterized glyph.
+        std::vector<uint8> cellPixels;
+    };
+
+}
+
+#endif /* RIGID3D_GLYPH_ATLAS_HPP_ */
@@ -0,0 +1,479 @@
+#include "GpuCuller.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Collision/FrustumPlanes.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/HiZPyramid.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace Rigid3D {
+
+namespace {
+
+    // Must match local_size_x within CullInstances.comp and BuildDrawCommands.comp.
+    const unsigned int workGroupSize = 64;
+
+    // Shader storage binding points shared by the culling shaders.
+    const GLuint instanceBinding = 0;
+    const GLuint batchBinding = 1;
+    const GLuint batchCountBinding = 2;
+    const GLuint visibleInstanceBinding = 3;
+    const GLuint drawCommandBinding = 4;
+    const GLuint drawCountBinding = 5;
+
+    struct DrawArraysIndirectCommand {
+        uint32 count;
+        uint32 instanceCount;
+        uint32 first;
+        uint32 baseInstance;
+    };
+
+    //------------------------------------------------------------------------------------
+    GLuint numWorkGroups(unsigned int numItems) {
+        return (numItems + workGroupSize - 1) / workGroupSize;
+    }
+
+    //------------------------------------------------------------------------------------
+    void clearToZero(GLuint buffer) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER,
+                GL_UNSIGNED_INT, NULL);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Buffers are never allocated empty so that they can always be bound.
+    void allocateBuffer(GLuint buffer, size_t numBytes, const void * data, GLenum usage) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, GLsizeiptr(std::max(numBytes, size_t(16))),
+                NULL, usage);
+        if (data != NULL && numBytes > 0) {
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, GLsizeiptr(numBytes), data);
+        }
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+/**
+ * @note Requires a current OpenGL 4.3 context.
+ *
+ * @param cullShader - linked CullInstances ShaderProgram.
+ * @param buildCommandsShader - linked BuildDrawCommands ShaderProgram.
+ */
+GpuCuller::GpuCuller(ShaderProgram & cullShader, ShaderProgram & buildCommandsShader)
+    : cullShader(&cullShader),
+      buildCommandsShader(&buildCommandsShader),
+      dirtyBegin(0),
+      dirtyEnd(0),
+      buffersStale(true),
+      hiZPyramid(nullptr),
+      instanceBuffer(0),
+      batchBuffer(0),
+      batchCountBuffer(0),
+      visibleInstanceBuffer(0),
+      drawCommandBuffer(0),
+      drawCountBuffer(0),
+      indirectCountSupported(false) {
+
+    location_numInstances = cullShader.getUniformLocation("numInstances");
+    location_frustumPlanes = cullShader.getUniformLocation("frustumPlanes");
+    location_occlusionCulling = cullShader.getUniformLocation("occlusionCulling");
+    location_hiZViewProjection = cullShader.getUniformLocation("hiZViewProjection");
+    location_hiZSize = cullShader.getUniformLocation("hiZSize");
+    location_hiZLevels = cullShader.getUniformLocation("hiZLevels");
+    location_numBatches = buildCommandsShader.getUniformLocation("numBatches");
+
+    cullShader.setUniform("hiZ", 0);
+
+    glGenBuffers(1, &instanceBuffer);
+    glGenBuffers(1, &batchBuffer);
+    glGenBuffers(1, &batchCountBuffer);
+    glGenBuffers(1, &visibleInstanceBuffer);
+    glGenBuffers(1, &drawCommandBuffer);
+    glGenBuffers(1, &drawCountBuffer);
+
+    allocateBuffer(drawCountBuffer, sizeof(uint32), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+#ifdef GL_VERSION_4_6
+    GLint majorVersion = 0;
+    GLint minorVersion = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+    indirectCountSupported = (majorVersion > 4) || (majorVersion == 4 && minorVersion >= 6);
+#endif
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+GpuCuller::~GpuCuller() {
+    glDeleteBuffers(1, &instanceBuffer);
+    glDeleteBuffers(1, &batchBuffer);
+    glDeleteBuffers(1, &batchCountBuffer);
+    glDeleteBuffers(1, &visibleInstanceBuffer);
+    glDeleteBuffers(1, &drawCommandBuffer);
+    glDeleteBuffers(1, &drawCountBuffer);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Registers a range of vertices to be drawn for each visible instance placed with
+ * it.
+ *
+ * @return index of the new batch, for use with \c addInstance().
+ */
+unsigned int GpuCuller::addBatch(const BatchInfo & batchInfo) {
+    if (batchInfo.indexed) {
+        std::stringstream errorMessage;
+        errorMessage << "Indexed batches are not supported within method "
+                     << "GpuCuller::addBatch";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    Batch batch;
+    batch.first = batchInfo.startIndex;
+    batch.count = batchInfo.numIndices;
+    batch.instanceOffset = 0;
+    batch.padding = 0;
+    batches.push_back(batch);
+
+    buffersStale = true;
+
+    return (unsigned int)(batches.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Places a copy of batch 'batchIndex' in the world.
+ *
+ * @param batchIndex - index returned from \c addBatch().
+ * @param modelMatrix - model to world transform.
+ * @param modelBounds - model space bounding box of the batch's geometry.
+ *
+ * @return index of the new instance, as seen by the vertex shader.
+ */
+unsigned int GpuCuller::addInstance(unsigned int batchIndex, const mat4 & modelMatrix,
+                                    const AABB & modelBounds) {
+    if (batchIndex >= batches.size()) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid batch index " << batchIndex << " within method "
+            << "GpuCuller::addInstance";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    Instance instance;
+    instance.modelMatrix = modelMatrix;
+    instance.boundsMin = modelBounds.minBounds;
+    instance.batchIndex = batchIndex;
+    instance.boundsMax = modelBounds.maxBounds;
+    instance.padding = 0.0f;
+    instances.push_back(instance);
+
+    buffersStale = true;
+
+    return (unsigned int)(instances.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Moves an instance.  Only the range of instances modified since the previous
+ * \c cull() is uploaded.
+ */
+void GpuCuller::setModelMatrix(unsigned int instanceIndex, const mat4 & modelMatrix) {
+    instances.at(instanceIndex).modelMatrix = modelMatrix;
+
+    if (dirtyBegin == dirtyEnd) {
+        dirtyBegin = instanceIndex;
+        dirtyEnd = instanceIndex + 1;
+    } else {
+        dirtyBegin = std::min(dirtyBegin, instanceIndex);
+        dirtyEnd = std::max(dirtyEnd, instanceIndex + 1);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Removes all batches and instances.
+ */
+void GpuCuller::clear() {
+    instances.clear();
+    batches.clear();
+    dirtyBegin = dirtyEnd = 0;
+    buffersStale = true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Enables occlusion culling against 'hiZPyramid'.
+ *
+ * @param hiZPyramid - depth pyramid, usually built from the previous frame's depth
+ * buffer.  Must outlive its use by this object.
+ * @param hiZViewProjection - projection * view matrix the depth was rendered with.
+ */
+void GpuCuller::setOcclusionCulling(const HiZPyramid * hiZPyramid,
+                                    const mat4 & hiZViewProjection) {
+    this->hiZPyramid = hiZPyramid;
+    this->hiZViewProjection = hiZViewProjection;
+}
+
+//----------------------------------------------------------------------------------------
+void GpuCuller::disableOcclusionCulling() {
+    hiZPyramid = nullptr;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reallocates all buffers after batches or instances were added, assigning each
+ * batch a range of the visible instance list large enough for all its instances.
+ */
+void GpuCuller::uploadBuffers() {
+    for (Batch & batch : batches) {
+        batch.instanceOffset = 0;
+    }
+    for (const Instance & instance : instances) {
+        ++batches[instance.batchIndex].instanceOffset;
+    }
+
+    // Exclusive prefix sum of instance counts.
+    uint32 offset = 0;
+    for (Batch & batch : batches) {
+        uint32 numBatchInstances = batch.instanceOffset;
+        batch.instanceOffset = offset;
+        offset += numBatchInstances;
+    }
+
+    allocateBuffer(instanceBuffer, instances.size() * sizeof(Instance), instances.data(),
+            GL_DYNAMIC_DRAW);
+    allocateBuffer(batchBuffer, batches.size() * sizeof(Batch), batches.data(),
+            GL_STATIC_DRAW);
+    allocateBuffer(batchCountBuffer, batches.size() * sizeof(uint32), NULL, GL_DYNAMIC_COPY);
+    allocateBuffer(visibleInstanceBuffer, instances.size() * sizeof(uint32), NULL,
+            GL_DYNAMIC_COPY);
+    allocateBuffer(drawCommandBuffer, batches.size() * sizeof(DrawArraysIndirectCommand),
+            NULL, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    buffersStale = false;
+    dirtyBegin = dirtyEnd = 0;
+}
+
+//----------------------------------------------------------------------------------------
+void GpuCuller::uploadDirtyInstances() {
+    if (dirtyBegin == dirtyEnd) {
+        return;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, instanceBuffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, GLintptr(dirtyBegin * sizeof(Instance)),
+            GLsizeiptr((dirtyEnd - dirtyBegin) * sizeof(Instance)), &instances[dirtyBegin]);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    dirtyBegin = dirtyEnd = 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Culls all instances against the frustum of 'viewProjection', and against the
+ * occlusion culling \c HiZPyramid if one is set, then regenerates the indirect
+ * draw commands.  No results are read back to the CPU.
+ *
+ * @param viewProjection - projection * view matrix of the camera being drawn.
+ */
+void GpuCuller::cull(const mat4 & viewProjection) {
+    if (buffersStale) {
+        uploadBuffers();
+    } else {
+        uploadDirtyInstances();
+    }
+
+    clearToZero(batchCountBuffer);
+    clearToZero(drawCommandBuffer);
+    clearToZero(drawCountBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, instanceBinding, instanceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, batchBinding, batchBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, batchCountBinding, batchCountBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, visibleInstanceBinding, visibleInstanceBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, drawCommandBinding, drawCommandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, drawCountBinding, drawCountBuffer);
+
+    // Pass 1: per instance visibility.
+    FrustumPlanes frustum(viewProjection);
+    vec4 planes[FrustumPlanes::NumPlanes];
+    for (int i = 0; i < FrustumPlanes::NumPlanes; ++i) {
+        planes[i] = frustum.getPlane(FrustumPlanes::Plane(i));
+    }
+
+    cullShader->enable();
+    glUniform1ui(location_numInstances, GLuint(instances.size()));
+    glUniform4fv(location_frustumPlanes, FrustumPlanes::NumPlanes, glm::value_ptr(planes[0]));
+
+    bool occlusionCulling = (hiZPyramid != nullptr && hiZPyramid->getTexture() != 0);
+    glUniform1i(location_occlusionCulling, occlusionCulling);
+    if (occlusionCulling) {
+        glUniformMatrix4fv(location_hiZViewProjection, 1, GL_FALSE,
+                glm::value_ptr(hiZViewProjection));
+        glUniform2f(location_hiZSize, float(hiZPyramid->getWidth()),
+                float(hiZPyramid->getHeight()));
+        glUniform1i(location_hiZLevels, GLint(hiZPyramid->getNumLevels()));
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, hiZPyramid->getTexture());
+    }
+
+    if (!instances.empty()) {
+        glDispatchCompute(numWorkGroups(instances.size()), 1, 1);
+    }
+    cullShader->disable();
+
+    if (occlusionCulling) {
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    // Pass 2: compact per batch counts into draw commands.
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    buildCommandsShader->enable();
+    glUniform1ui(location_numBatches, GLuint(batches.size()));
+    if (!batches.empty()) {
+        glDispatchCompute(numWorkGroups(batches.size()), 1, 1);
+    }
+    buildCommandsShader->disable();
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+            GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws every batch with visible instances using the commands generated by the
+ * last call to \c cull().  The caller is responsible for binding the VAO set up
+ * with \c bindInstanceIndexAttribute() and enabling the instance ShaderProgram.
+ *
+ * @param mode - primitive type, such as GL_TRIANGLES.
+ */
+void GpuCuller::draw(GLenum mode) const {
+    if (batches.empty()) {
+        return;
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, instanceBinding, instanceBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandBuffer);
+
+#ifdef GL_VERSION_4_6
+    if (indirectCountSupported) {
+        glBindBuffer(GL_PARAMETER_BUFFER, drawCountBuffer);
+        glMultiDrawArraysIndirectCount(mode, 0, 0, GLsizei(batches.size()), 0);
+        glBindBuffer(GL_PARAMETER_BUFFER, 0);
+    } else
+#endif
+    {
+        glMultiDrawArraysIndirect(mode, 0, GLsizei(batches.size()), 0);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sources the integer vertex attribute at 'attributeLocation' of the currently
+ * bound VAO from the visible instance list, advancing once per instance.  The
+ * vertex shader reads it as the index of the instance being drawn.
+ *
+ * @note Call after the first \c cull(), or again whenever batches or instances
+ * are added, since the visible instance list is reallocated at that point.
+ */
+void GpuCuller::bindInstanceIndexAttribute(GLuint attributeLocation) const {
+    glBindBuffer(GL_ARRAY_BUFFER, visibleInstanceBuffer);
+    glEnableVertexAttribArray(attributeLocation);
+    glVertexAttribIPointer(attributeLocation, 1, GL_UNSIGNED_INT, 0, reinterpret_cast<void *>(0));
+    glVertexAttribDivisor(attributeLocation, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint GpuCuller::getInstanceBuffer() const {
+    return instanceBuffer;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint GpuCuller::getDrawCommandBuffer() const {
+    return drawCommandBuffer;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int GpuCuller::getNumBatches() const {
+    return (unsigned int)batches.size();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int GpuCuller::getNumInstances() const {
+    return (unsigned int)instances.size();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the number of instances that passed the last \c cull().
+ *
+ * @note Reads back from the GPU and stalls the pipeline, intended for statistics
+ * and testing only.
+ */
+unsigned int GpuCuller::readNumVisibleInstances() const {
+    if (batches.empty()) {
+        return 0;
+    }
+
+    std::vector<uint32> batchCounts(batches.size());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, batchCountBuffer);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, GLsizeiptr(batchCounts.size() * sizeof(uint32)),
+            batchCounts.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    unsigned int numVisible = 0;
+    for (uint32 count : batchCounts) {
+        numVisible += count;
+    }
+
+    return numVisible;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the number of draw commands generated by the last \c cull().
+ *
+ * @note Reads back from the GPU and stalls the pipeline, intended for statistics
+ * and testing only.
+ */
+unsigned int GpuCuller::readNumDrawCommands() const {
+    uint32 drawCount = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawCountBuffer);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32), &drawCount);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    return drawCount;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if \c draw() uses glMultiDrawArraysIndirectCount, false if it
+ * falls back to glMultiDrawArraysIndirect.
+ */
+bool GpuCuller::hasIndirectCount() const {
+    return indirectCountSupported;
+}
+
+} // end namespace Rigid3D
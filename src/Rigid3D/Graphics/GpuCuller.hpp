@@ -0,0 +1,170 @@
+/**
+ * @brief GpuCuller
+ */
+
+#ifndef RIGID3D_GPU_CULLER_HPP_
+#define RIGID3D_GPU_CULLER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    struct AABB;
+    struct BatchInfo;
+    class HiZPyramid;
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Culls large numbers of instances on the GPU and generates the indirect
+     * draw commands that render the survivors.
+     *
+     * Batches are vertex ranges within a shared vertex buffer, normally taken from
+     * \c MeshConsolidator \c BatchInfos, and each instance places one batch in the
+     * world.  Instance transforms and model space bounds live in a shader storage
+     * buffer, so the CPU only touches instances that change.
+     *
+     * Each call to \c cull() runs two compute passes:
+     * # CullInstances.comp tests every instance against the view frustum and,
+     *   optionally, a \c HiZPyramid of the previous frame's depth, appending
+     *   visible instance indices to per batch ranges of a visible instance list.
+     * # BuildDrawCommands.comp writes one DrawArraysIndirectCommand per batch with
+     *   visible instances, packed at the front of the command buffer.
+     *
+     * \c draw() then renders everything with one call to
+     * glMultiDrawArraysIndirectCount when OpenGL 4.6 is available.  Otherwise
+     * glMultiDrawArraysIndirect is issued for every batch, which costs nothing
+     * extra for the unused commands since they are cleared to zero instances.
+     * Neither path reads results back to the CPU.
+     *
+     * The index of each drawn instance reaches the vertex shader through an
+     * integer vertex attribute sourced from the visible instance list, which
+     * \c bindInstanceIndexAttribute() sets up within the bound VAO.  The
+     * instance buffer is bound to shader storage binding 0, see
+     * GpuCulledInstance.vert.
+     *
+     * \code{.cpp}
+     *  GpuCuller culler(cullShader, buildCommandsShader);
+     *  unsigned int cubeBatch = culler.addBatch(batchInfoMap.at("cube"));
+     *  for (const mat4 & transform : cubeTransforms) {
+     *      culler.addInstance(cubeBatch, transform, boundingBoxMap.at("cube"));
+     *  }
+     *
+     *  glBindVertexArray(vao);
+     *  culler.bindInstanceIndexAttribute(2);
+     *
+     *  // Each frame.
+     *  culler.cull(camera.getProjectionMatrix() * camera.getViewMatrix());
+     *  instanceShader.enable();
+     *  culler.draw(GL_TRIANGLES);
+     *  instanceShader.disable();
+     * \endcode
+     *
+     * Requires an OpenGL 4.3 context.
+     */
+    class GpuCuller {
+    public:
+        GpuCuller(ShaderProgram & cullShader, ShaderProgram & buildCommandsShader);
+
+        ~GpuCuller();
+
+        unsigned int addBatch(const BatchInfo & batchInfo);
+
+        unsigned int addInstance(unsigned int batchIndex, const mat4 & modelMatrix,
+                                 const AABB & modelBounds);
+
+        void setModelMatrix(unsigned int instanceIndex, const mat4 & modelMatrix);
+
+        void clear();
+
+        void setOcclusionCulling(const HiZPyramid * hiZPyramid,
+                                 const mat4 & hiZViewProjection);
+
+        void disableOcclusionCulling();
+
+        void cull(const mat4 & viewProjection);
+
+        void draw(GLenum mode) const;
+
+        void bindInstanceIndexAttribute(GLuint attributeLocation) const;
+
+        GLuint getInstanceBuffer() const;
+
+        GLuint getDrawCommandBuffer() const;
+
+        unsigned int getNumBatches() const;
+
+        unsigned int getNumInstances() const;
+
+        unsigned int readNumVisibleInstances() const;
+
+        unsigned int readNumDrawCommands() const;
+
+        bool hasIndirectCount() const;
+
+    private:
+        // Non-copyable, owns GL buffer objects.
+        GpuCuller(const GpuCuller &);
+        GpuCuller & operator = (const GpuCuller &);
+
+        // std430 layouts matching CullInstances.comp.
+        struct Instance {
+            mat4 modelMatrix;
+            vec3 boundsMin;
+            uint32 batchIndex;
+            vec3 boundsMax;
+            float padding;
+        };
+
+        struct Batch {
+            uint32 first;
+            uint32 count;
+            uint32 instanceOffset;
+            uint32 padding;
+        };
+
+        void uploadBuffers();
+
+        void uploadDirtyInstances();
+
+        ShaderProgram * cullShader;
+        ShaderProgram * buildCommandsShader;
+
+        std::vector<Instance> instances;
+        std::vector<Batch> batches;
+
+        // Range of instances modified since the last upload.
+        unsigned int dirtyBegin;
+        unsigned int dirtyEnd;
+        bool buffersStale;
+
+        const HiZPyramid * hiZPyramid;
+        mat4 hiZViewProjection;
+
+        GLuint instanceBuffer;
+        GLuint batchBuffer;
+        GLuint batchCountBuffer;
+        GLuint visibleInstanceBuffer;
+        GLuint drawCommandBuffer;
+        GLuint drawCountBuffer;
+
+        bool indirectCountSupported;
+
+        GLint location_numInstances;
+        GLint location_frustumPlanes;
+        GLint location_occlusionCulling;
+        GLint location_hiZViewProjection;
+        GLint location_hiZSize;
+        GLint location_hiZLevels;
+        GLint location_numBatches;
+    };
+
+}
+
+#endif /* RIGID3D_GPU_CULLER_HPP_ */
@@ -0,0 +1,320 @@
+#include "GpuParticleEmitter.hpp"
+
+#include <Rigid3D/Common/PackColor.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace Rigid3D {
+
+const uint32 GpuParticleEmitter::MaxPlanes;
+const uint32 GpuParticleEmitter::MaxSpheres;
+const uint32 GpuParticleEmitter::BytesPerParticle;
+
+namespace {
+
+    // Must match local_size_x within GpuParticleEmit.comp and GpuParticleSimulate.comp.
+    const unsigned int workGroupSize = 64;
+
+    // Shader storage binding points shared by the particle shaders.
+    const GLuint sourceBinding = 0;
+    const GLuint destinationBinding = 1;
+    const GLuint counterBinding = 2;
+    const GLuint indirectBinding = 3;
+
+    // Layout of the indirect buffer, written by GpuParticleDrawArgs.comp.
+    struct IndirectArgs {
+        uint32 count;
+        uint32 instanceCount;
+        uint32 first;
+        uint32 baseInstance;
+        uint32 numGroupsX;
+        uint32 numGroupsY;
+        uint32 numGroupsZ;
+        uint32 padding;
+    };
+
+    const GLintptr dispatchArgsOffset = 4 * sizeof(uint32);
+
+    //------------------------------------------------------------------------------------
+    GLuint numWorkGroups(unsigned int numItems) {
+        return (numItems + workGroupSize - 1) / workGroupSize;
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+/**
+ * @note Requires a current OpenGL 4.3 context.
+ *
+ * @param emitShader - linked GpuParticleEmit ShaderProgram.
+ * @param simulateShader - linked GpuParticleSimulate ShaderProgram.
+ * @param drawArgsShader - linked GpuParticleDrawArgs ShaderProgram.
+ * @param maxParticles - capacity, particles spawned beyond it are dropped.
+ */
+GpuParticleEmitter::GpuParticleEmitter(ShaderProgram & emitShader,
+        ShaderProgram & simulateShader, ShaderProgram & drawArgsShader,
+        uint32 maxParticles, const ParticleEmitter::Params & params, uint32 seed)
+    : emitShader(&emitShader),
+      simulateShader(&simulateShader),
+      drawArgsShader(&drawArgsShader),
+      params(params),
+      maxParticles(maxParticles),
+      seed(seed),
+      frame(0),
+      emissionDebt(0.0f),
+      numBurstParticles(0),
+      current(0),
+      counterBuffer(0),
+      indirectBuffer(0),
+      vao(0) {
+
+    if (maxParticles == 0) {
+        std::stringstream errorMessage;
+        errorMessage << "maxParticles must be greater than zero"
+                     << " within method GpuParticleEmitter::GpuParticleEmitter";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    glGenBuffers(2, particleBuffers);
+    for (int i = 0; i < 2; ++i) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, particleBuffers[i]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, GLsizeiptr(maxParticles) * BytesPerParticle,
+                NULL, GL_DYNAMIC_COPY);
+    }
+
+    const uint32 counts[2] = {0, 0};
+    glGenBuffers(1, &counterBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, counterBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(counts), counts, GL_DYNAMIC_COPY);
+
+    // Nothing to draw or simulate until the first update().
+    const IndirectArgs args = {0, 1, 0, 0, 0, 1, 1, 0};
+    glGenBuffers(1, &indirectBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, indirectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(args), &args, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // Particles are fetched from the storage buffer by gl_VertexID, but a vertex
+    // array must still be bound to draw.
+    glGenVertexArrays(1, &vao);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+GpuParticleEmitter::~GpuParticleEmitter() {
+    glDeleteBuffers(2, particleBuffers);
+    glDeleteBuffers(1, &counterBuffer);
+    glDeleteBuffers(1, &indirectBuffer);
+    glDeleteVertexArrays(1, &vao);
+}
+
+//----------------------------------------------------------------------------------------
+const ParticleEmitter::Params & GpuParticleEmitter::getParams() const {
+    return params;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Changes how new particles are spawned and how all particles move.  Existing
+ * particles keep their color and remaining life.
+ */
+void GpuParticleEmitter::setParams(const ParticleEmitter::Params & params) {
+    this->params = params;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Keeps particles on the positive side of 'plane', (normal, distance) with
+ * dot(normal, p) + distance = 0 on the plane.
+ */
+void GpuParticleEmitter::addCollisionPlane(const vec4 & plane) {
+    float length = glm::length(vec3(plane));
+    if (length <= 0.0f) {
+        std::stringstream errorMessage;
+        errorMessage << "Collision plane needs a non zero normal"
+                     << " within method GpuParticleEmitter::addCollisionPlane";
+        throw Rigid3DException(errorMessage.str());
+    }
+    if (planes.size() == MaxPlanes) {
+        std::stringstream errorMessage;
+        errorMessage << "Cannot add more than " << MaxPlanes << " collision planes"
+                     << " within method GpuParticleEmitter::addCollisionPlane";
+        throw Rigid3DException(errorMessage.str());
+    }
+    planes.push_back(plane / length);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Keeps particles outside of the sphere at 'center'.
+ */
+void GpuParticleEmitter::addCollisionSphere(const vec3 & center, float radius) {
+    if (spheres.size() == MaxSpheres) {
+        std::stringstream errorMessage;
+        errorMessage << "Cannot add more than " << MaxSpheres << " collision spheres"
+                     << " within method GpuParticleEmitter::addCollisionSphere";
+        throw Rigid3DException(errorMessage.str());
+    }
+    spheres.push_back(vec4(center, radius));
+}
+
+//----------------------------------------------------------------------------------------
+void GpuParticleEmitter::clearColliders() {
+    planes.clear();
+    spheres.clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Spawns 'count' particles on the next \c update(), in addition to those spawned
+ * at \c Params::emissionRate.  Particles beyond the capacity are dropped on the
+ * GPU.
+ */
+void GpuParticleEmitter::emit(uint32 count) {
+    numBurstParticles += count;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Advances all particles by 'seconds', removes those that expired, then spawns
+ * the new ones.  Only uniforms are uploaded, the particle count never leaves
+ * the GPU.
+ */
+void GpuParticleEmitter::update(float seconds) {
+    const uint32 source = current;
+    const uint32 destination = 1 - current;
+
+    emissionDebt += params.emissionRate * seconds;
+    uint32 numToEmit = uint32(emissionDebt);
+    emissionDebt -= float(numToEmit);
+    numToEmit = std::min(numToEmit + numBurstParticles, maxParticles);
+    numBurstParticles = 0;
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, sourceBinding, particleBuffers[source]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, destinationBinding,
+            particleBuffers[destination]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, counterBinding, counterBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, indirectBinding, indirectBuffer);
+
+    // Survivors of the source buffer, sized by the previous GpuParticleDrawArgs pass.
+    simulateShader->setUniform("sourceIndex", source);
+    simulateShader->setUniform("seconds", seconds);
+    simulateShader->setUniform("acceleration", params.acceleration);
+    simulateShader->setUniform("drag", params.drag);
+    simulateShader->setUniform("restitution", params.restitution);
+    simulateShader->setUniform("numPlanes", int(planes.size()));
+    simulateShader->setUniform("numSpheres", int(spheres.size()));
+    simulateShader->enable();
+    if (!planes.empty()) {
+        glUniform4fv(simulateShader->getUniformLocation("planes"), GLsizei(planes.size()),
+                glm::value_ptr(planes[0]));
+    }
+    if (!spheres.empty()) {
+        glUniform4fv(simulateShader->getUniformLocation("spheres"), GLsizei(spheres.size()),
+                glm::value_ptr(spheres[0]));
+    }
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, indirectBuffer);
+    glDispatchComputeIndirect(dispatchArgsOffset);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    simulateShader->disable();
+
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    if (numToEmit > 0) {
+        emitShader->setUniform("destinationIndex", destination);
+        emitShader->setUniform("numToEmit", numToEmit);
+        emitShader->setUniform("maxParticles", maxParticles);
+        emitShader->setUniform("seed", seed + frame * 0x9e3779b9u);
+        emitShader->setUniform("position", params.position);
+        emitShader->setUniform("positionSpread", params.positionSpread);
+        emitShader->setUniform("velocity", params.velocity);
+        emitShader->setUniform("velocitySpread", params.velocitySpread);
+        emitShader->setUniform("lifetime", params.lifetime);
+        emitShader->setUniform("lifetimeSpread", params.lifetimeSpread);
+        emitShader->setUniform("color", packColor(params.color));
+        emitShader->enable();
+        glDispatchCompute(numWorkGroups(numToEmit), 1, 1);
+        emitShader->disable();
+
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    drawArgsShader->setUniform("destinationIndex", destination);
+    drawArgsShader->setUniform("maxParticles", maxParticles);
+    drawArgsShader->enable();
+    glDispatchCompute(1, 1, 1);
+    drawArgsShader->disable();
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT |
+            GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    current = destination;
+    ++frame;
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws the live particles as points with one indirect draw call, using the
+ * currently enabled ShaderProgram.
+ */
+void GpuParticleEmitter::draw() const {
+    GLint previousVao = 0;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVao);
+
+    glBindVertexArray(vao);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, sourceBinding, particleBuffers[current]);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glDrawArraysIndirect(GL_POINTS, NULL);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    glBindVertexArray(GLuint(previousVao));
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 GpuParticleEmitter::getMaxParticles() const {
+    return maxParticles;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return shader storage buffer holding the particles drawn by \c draw(), each
+ * BytesPerParticle bytes as laid out within GpuParticle.vert.
+ */
+GLuint GpuParticleEmitter::getParticleBuffer() const {
+    return particleBuffers[current];
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return buffer holding the DrawArraysIndirectCommand used by \c draw().
+ */
+GLuint GpuParticleEmitter::getIndirectBuffer() const {
+    return indirectBuffer;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reads the live particle count back from the GPU, stalling until the last
+ * \c update() completes.  Meant for tests and debugging.
+ */
+uint32 GpuParticleEmitter::readNumParticles() const {
+    uint32 count = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, indirectBuffer);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32), &count);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return count;
+}
+
+} // end namespace Rigid3D
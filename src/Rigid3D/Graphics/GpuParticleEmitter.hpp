@@ -0,0 +1,134 @@
+/**
+ * @brief GpuParticleEmitter
+ */
+
+#ifndef RIGID3D_GPU_PARTICLE_EMITTER_HPP_
+#define RIGID3D_GPU_PARTICLE_EMITTER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Particles/ParticleEmitter.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Spawns, simulates and draws the particles of one effect entirely on
+     * the GPU.
+     *
+     * Behaves like \c ParticleEmitter, with the same \c ParticleEmitter::Params,
+     * but particle state lives in two shader storage buffers that swap roles each
+     * frame.  The CPU uploads only the emitter's parameters, so particle counts are
+     * not limited by upload bandwidth.
+     *
+     * Each call to \c update() runs three compute passes:
+     * # GpuParticleSimulate.comp integrates and collides every particle of the
+     *   source buffer and appends the survivors to the destination buffer through
+     *   an atomic counter, which also compacts away expired particles.
+     * # GpuParticleEmit.comp appends the particles spawned this frame.
+     * # GpuParticleDrawArgs.comp clamps the new count to the capacity and writes
+     *   the indirect draw arguments, plus the indirect dispatch arguments of the
+     *   next simulation pass.
+     *
+     * \c draw() then issues one glDrawArraysIndirect of points, which the
+     * GpuParticle.geom geometry shader expands to camera facing quads, as in
+     * GeometryShaderExample.  Nothing is read back to the CPU.
+     *
+     * The draw ShaderProgram is expected to be built from GpuParticle.vert,
+     * GpuParticle.geom and Particle.frag, and the caller sets:
+     * # uniform mat4 ModelViewMatrix
+     * # uniform mat4 ProjectionMatrix
+     * # uniform float particleSize
+     *
+     * \code{.cpp}
+     *  GpuParticleEmitter fountain(emitShader, simulateShader, drawArgsShader,
+     *          1 << 22, params);
+     *
+     *  // Each frame.
+     *  fountain.update(frameSeconds);
+     *  particleShader.enable();
+     *  fountain.draw();
+     *  particleShader.disable();
+     * \endcode
+     *
+     * Requires an OpenGL 4.3 context.
+     */
+    class GpuParticleEmitter {
+    public:
+        GpuParticleEmitter(ShaderProgram & emitShader, ShaderProgram & simulateShader,
+                           ShaderProgram & drawArgsShader, uint32 maxParticles,
+                           const ParticleEmitter::Params & params, uint32 seed = 1);
+
+        ~GpuParticleEmitter();
+
+        const ParticleEmitter::Params & getParams() const;
+
+        void setParams(const ParticleEmitter::Params & params);
+
+        void addCollisionPlane(const vec4 & plane);
+
+        void addCollisionSphere(const vec3 & center, float radius);
+
+        void clearColliders();
+
+        void emit(uint32 count);
+
+        void update(float seconds);
+
+        void draw() const;
+
+        uint32 getMaxParticles() const;
+
+        GLuint getParticleBuffer() const;
+
+        GLuint getIndirectBuffer() const;
+
+        uint32 readNumParticles() const;
+
+        static const uint32 MaxPlanes = 8;
+        static const uint32 MaxSpheres = 8;
+
+        static const uint32 BytesPerParticle = 8 * sizeof(float);
+
+    private:
+        // Non-copyable, owns GL buffer objects.
+        GpuParticleEmitter(const GpuParticleEmitter &);
+        GpuParticleEmitter & operator = (const GpuParticleEmitter &);
+
+        ShaderProgram * emitShader;
+        ShaderProgram * simulateShader;
+        ShaderProgram * drawArgsShader;
+
+        ParticleEmitter::Params params;
+        uint32 maxParticles;
+        uint32 seed;
+        uint32 frame;
+        float emissionDebt;
+        uint32 numBurstParticles;
+
+        std::vector<vec4> planes;
+        std::vector<vec4> spheres;   // Center and radius.
+
+        // particleBuffers[current] holds the particles drawn by draw().
+        GLuint particleBuffers[2];
+        uint32 current;
+
+        // Particle count of each particle buffer.
+        GLuint counterBuffer;
+
+        // Draw arrays command, then the next simulation's dispatch size.
+        GLuint indirectBuffer;
+
+        GLuint vao;
+    };
+
+}
+
+#endif /* RIGID3D_GPU_PARTICLE_EMITTER_HPP_ */
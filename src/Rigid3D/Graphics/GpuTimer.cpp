@@ -0,0 +1,117 @@
+#include "GpuTimer.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param maxPendingQueries - spans whose results may be outstanding at once.  Results
+ * typically lag two or three frames behind.
+ *
+ * @note Requires a current OpenGL context.
+ */
+GpuTimer::GpuTimer(unsigned int maxPendingQueries)
+    : queries(std::max(maxPendingQueries, 1u)),
+      firstQuery(0),
+      numPendingQueries(0),
+      active(false) {
+
+    glGenQueries(GLsizei(queries.size()), queries.data());
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+GpuTimer::~GpuTimer() {
+    if (active) {
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+    glDeleteQueries(GLsizei(queries.size()), queries.data());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Starts timing the commands that follow.
+ *
+ * @return false if every query is still waiting for its result, in which case the
+ * span up to the next \c end() is not timed.
+ */
+bool GpuTimer::begin() {
+    if (active) {
+        std::stringstream errorMessage;
+        errorMessage << "GpuTimer::end() must be called before timing another span "
+                     << "within method GpuTimer::begin";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    if (numPendingQueries == queries.size()) {
+        return false;
+    }
+
+    GLuint query = queries[(firstQuery + numPendingQueries) % queries.size()];
+    ++numPendingQueries;
+    active = true;
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Stops timing.  Does nothing if the matching \c begin() returned false.
+ */
+void GpuTimer::end() {
+    if (!active) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    active = false;
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Collects the oldest timed span if its result is available.  Never blocks.
+ *
+ * @return true if 'milliseconds' was filled in.
+ */
+bool GpuTimer::getResult(double & milliseconds) {
+    // The most recent query cannot be read while it is still active.
+    const size_t numEndedQueries = active ? numPendingQueries - 1 : numPendingQueries;
+    if (numEndedQueries == 0) {
+        return false;
+    }
+
+    GLuint query = queries[firstQuery];
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+        return false;
+    }
+
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+    milliseconds = double(nanoseconds) * 1.0e-6;
+
+    firstQuery = (firstQuery + 1) % queries.size();
+    --numPendingQueries;
+
+    CHECK_GL_ERRORS;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int GpuTimer::getNumPendingQueries() const {
+    return (unsigned int)numPendingQueries;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,68 @@
+/**
+ * @brief GpuTimer
+ */
+
+#ifndef RIGID3D_GPU_TIMER_HPP_
+#define RIGID3D_GPU_TIMER_HPP_
+
+#include <OpenGL/gl3.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Measures the GPU time taken by a span of OpenGL commands, without
+     * stalling the CPU to wait for the result.
+     *
+     * Each \c begin() / \c end() pair issues a GL_TIME_ELAPSED query from a small
+     * ring.  Results become available a few frames later and are collected in the
+     * order the spans were timed by \c getResult(), which never blocks.  If every
+     * query is still in flight, \c begin() returns false and that span is simply not
+     * timed.
+     *
+     * Only one span may be timed at a time, and timer queries of other users must
+     * not be active between \c begin() and \c end().
+     *
+     * \code{.cpp}
+     *  GpuTimer timer;
+     *  ...
+     *  timer.begin();
+     *  drawScene();
+     *  timer.end();
+     *
+     *  double milliseconds;
+     *  while (timer.getResult(milliseconds)) {
+     *      cout << "Scene took " << milliseconds << " ms" << endl;
+     *  }
+     * \endcode
+     */
+    class GpuTimer {
+    public:
+        explicit GpuTimer(unsigned int maxPendingQueries = 4);
+
+        ~GpuTimer();
+
+        bool begin();
+
+        void end();
+
+        bool getResult(double & milliseconds);
+
+        unsigned int getNumPendingQueries() const;
+
+    private:
+        // Non-copyable, owns GL objects.
+        GpuTimer(const GpuTimer &);
+        GpuTimer & operator = (const GpuTimer &);
+
+        std::vector<GLuint> queries;
+        size_t firstQuery;          // Oldest query in flight.
+        size_t numPendingQueries;   // Includes a query between begin() and end().
+        bool active;
+    };
+
+}
+
+#endif /* RIGID3D_GPU_TIMER_HPP_ */
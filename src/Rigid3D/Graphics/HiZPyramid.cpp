@@ -0,0 +1,165 @@
+#include "HiZPyramid.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace Rigid3D {
+
+namespace {
+
+    // Must match local_size_x and local_size_y within HiZDownsample.comp.
+    const unsigned int workGroupSize = 8;
+
+    //------------------------------------------------------------------------------------
+    GLuint numWorkGroups(unsigned int numTexels) {
+        return (numTexels + workGroupSize - 1) / workGroupSize;
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+/**
+ * @note Requires a current OpenGL 4.3 context.
+ *
+ * @param downsampleShader - linked HiZDownsample ShaderProgram.
+ */
+HiZPyramid::HiZPyramid(ShaderProgram & downsampleShader)
+    : downsampleShader(&downsampleShader),
+      texture(0),
+      width(0),
+      height(0),
+      numLevels(0) {
+
+    location_sourceLevel = downsampleShader.getUniformLocation("sourceLevel");
+    location_sourceSize = downsampleShader.getUniformLocation("sourceSize");
+    location_copySource = downsampleShader.getUniformLocation("copySource");
+
+    downsampleShader.setUniform("source", 0);
+}
+
+//----------------------------------------------------------------------------------------
+HiZPyramid::~HiZPyramid() {
+    glDeleteTextures(1, &texture);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the number of levels in a full mipmap chain for a 'width' by 'height'
+ * texture.
+ */
+unsigned int HiZPyramid::computeNumLevels(unsigned int width, unsigned int height) {
+    unsigned int levels = 1;
+    for (unsigned int size = std::max(width, height); size > 1; size /= 2) {
+        ++levels;
+    }
+    return levels;
+}
+
+//----------------------------------------------------------------------------------------
+void HiZPyramid::allocateTexture(unsigned int width, unsigned int height) {
+    glDeleteTextures(1, &texture);
+
+    this->width = width;
+    this->height = height;
+    numLevels = computeNumLevels(width, height);
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, GLsizei(numLevels), GL_R32F, GLsizei(width), GLsizei(height));
+
+    // Culling reads individual texels of a chosen level, never filtered values.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Rebuilds the pyramid from the contents of 'depthTexture'.  Storage is
+ * reallocated whenever the dimensions change.
+ *
+ * @param depthTexture - GL_TEXTURE_2D depth attachment with comparison mode
+ * disabled.
+ * @param width - width of 'depthTexture' in texels.
+ * @param height - height of 'depthTexture' in texels.
+ */
+void HiZPyramid::build(GLuint depthTexture, unsigned int width, unsigned int height) {
+    if (width == 0 || height == 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Depth texture dimensions must be non-zero within method "
+            << "HiZPyramid::build";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    if (width != this->width || height != this->height) {
+        allocateTexture(width, height);
+    }
+
+    downsampleShader->enable();
+    glActiveTexture(GL_TEXTURE0);
+
+    // Level 0 is copied straight from the depth texture.
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glBindImageTexture(0, texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    glUniform1i(location_copySource, GL_TRUE);
+    glUniform1i(location_sourceLevel, 0);
+    glUniform2i(location_sourceSize, GLint(width), GLint(height));
+    glDispatchCompute(numWorkGroups(width), numWorkGroups(height), 1);
+
+    // Each following level reduces the level above it.
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glUniform1i(location_copySource, GL_FALSE);
+
+    unsigned int sourceWidth = width;
+    unsigned int sourceHeight = height;
+    for (unsigned int level = 1; level < numLevels; ++level) {
+        unsigned int levelWidth = std::max(sourceWidth / 2, 1u);
+        unsigned int levelHeight = std::max(sourceHeight / 2, 1u);
+
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+        glBindImageTexture(0, texture, GLint(level), GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        glUniform1i(location_sourceLevel, GLint(level - 1));
+        glUniform2i(location_sourceSize, GLint(sourceWidth), GLint(sourceHeight));
+        glDispatchCompute(numWorkGroups(levelWidth), numWorkGroups(levelHeight), 1);
+
+        sourceWidth = levelWidth;
+        sourceHeight = levelHeight;
+    }
+
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    downsampleShader->disable();
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint HiZPyramid::getTexture() const {
+    return texture;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int HiZPyramid::getWidth() const {
+    return width;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int HiZPyramid::getHeight() const {
+    return height;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int HiZPyramid::getNumLevels() const {
+    return numLevels;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,71 @@
+/**
+ * @brief HiZPyramid
+ */
+
+#ifndef RIGID3D_HIZ_PYRAMID_HPP_
+#define RIGID3D_HIZ_PYRAMID_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+// Forward declarations
+namespace Rigid3D {
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Hierarchical depth buffer built from a depth texture, used for
+     * occlusion culling on the GPU.
+     *
+     * Level 0 is a copy of the depth texture, and each following level stores the
+     * farthest depth of the 2x2 texels beneath it.  An object whose nearest depth
+     * lies behind the farthest depth of the texels covering it is occluded.
+     *
+     * The ShaderProgram is expected to be built from HiZDownsample.comp, and an
+     * OpenGL 4.3 context is required.
+     *
+     * @see GpuCuller
+     */
+    class HiZPyramid {
+    public:
+        HiZPyramid(ShaderProgram & downsampleShader);
+
+        ~HiZPyramid();
+
+        void build(GLuint depthTexture, unsigned int width, unsigned int height);
+
+        GLuint getTexture() const;
+
+        unsigned int getWidth() const;
+
+        unsigned int getHeight() const;
+
+        unsigned int getNumLevels() const;
+
+        static unsigned int computeNumLevels(unsigned int width, unsigned int height);
+
+    private:
+        // Non-copyable, owns its texture.
+        HiZPyramid(const HiZPyramid &);
+        HiZPyramid & operator = (const HiZPyramid &);
+
+        void allocateTexture(unsigned int width, unsigned int height);
+
+        ShaderProgram * downsampleShader;
+
+        GLuint texture;
+        unsigned int width;
+        unsigned int height;
+        unsigned int numLevels;
+
+        GLint location_sourceLevel;
+        GLint location_sourceSize;
+        GLint location_copySource;
+    };
+
+}
+
+#endif /* RIGID3D_HIZ_PYRAMID_HPP_ */
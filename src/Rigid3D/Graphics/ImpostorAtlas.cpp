@@ -0,0 +1,278 @@
+#include "ImpostorAtlas.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Math/Octahedral.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace Rigid3D {
+
+using std::vector;
+
+//----------------------------------------------------------------------------------------
+ImpostorAtlas::ImpostorAtlas()
+    : colorTexture(0),
+      normalDepthTexture(0),
+      framesPerSide(0),
+      frameResolution(0),
+      boundingSphereCenter(0.0f),
+      boundingSphereRadius(0.0f) {
+
+}
+
+//----------------------------------------------------------------------------------------
+ImpostorAtlas::~ImpostorAtlas() {
+    releaseTextures();
+}
+
+//----------------------------------------------------------------------------------------
+void ImpostorAtlas::releaseTextures() {
+    if (colorTexture != 0) {
+        glDeleteTextures(1, &colorTexture);
+        colorTexture = 0;
+    }
+    if (normalDepthTexture != 0) {
+        glDeleteTextures(1, &normalDepthTexture);
+        normalDepthTexture = 0;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Renders 'mesh' into a new atlas, replacing any previously baked atlas.
+ *
+ * @param mesh
+ * @param diffuseColor - RGB color written to the color texture.
+ * @param bakeShader - linked ImpostorBake ShaderProgram.
+ * @param framesPerSide - number of view directions along each side of the atlas.
+ * @param frameResolution - width and height in pixels of each frame.
+ */
+void ImpostorAtlas::bake(const Mesh & mesh,
+                         const vec3 & diffuseColor,
+                         ShaderProgram & bakeShader,
+                         unsigned int framesPerSide,
+                         unsigned int frameResolution) {
+    const vector<vec3> & positions = *(mesh.getVertexPositionVector());
+    const vector<vec3> & normals = *(mesh.getVertexNormalVector());
+
+    if (positions.empty() || framesPerSide == 0 || frameResolution == 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid mesh or atlas dimensions within method ImpostorAtlas::bake";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    //-- Bounding sphere centered on the mesh bounds.
+    vec3 minBounds = positions[0];
+    vec3 maxBounds = positions[0];
+    for (const vec3 & p : positions) {
+        minBounds = glm::min(minBounds, p);
+        maxBounds = glm::max(maxBounds, p);
+    }
+    boundingSphereCenter = (minBounds + maxBounds) * 0.5f;
+    boundingSphereRadius = 0.0f;
+    for (const vec3 & p : positions) {
+        boundingSphereRadius = std::max(boundingSphereRadius,
+                glm::length(p - boundingSphereCenter));
+    }
+    boundingSphereRadius = std::max(boundingSphereRadius, 1e-4f);
+
+    this->framesPerSide = framesPerSide;
+    this->frameResolution = frameResolution;
+    const GLsizei atlasSize = GLsizei(framesPerSide * frameResolution);
+
+    //-- Save state that is modified below.
+    GLint prevFramebuffer;
+    GLint prevVao;
+    GLint prevViewport[4];
+    GLfloat prevClearColor[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, prevClearColor);
+    GLboolean depthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
+
+    //-- Atlas textures.
+    releaseTextures();
+
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlasSize, atlasSize, 0, GL_RGBA,
+            GL_UNSIGNED_BYTE, NULL);
+
+    glGenTextures(1, &normalDepthTexture);
+    glBindTexture(GL_TEXTURE_2D, normalDepthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, atlasSize, atlasSize, 0, GL_RGBA,
+            GL_FLOAT, NULL);
+
+    GLuint depthBuffer;
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, atlasSize, atlasSize);
+
+    GLuint fbo;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+            colorTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D,
+            normalDepthTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER,
+            depthBuffer);
+
+    const GLenum drawBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+    CHECK_FRAMEBUFFER_COMPLETENESS;
+
+    //-- Temporary vertex data.
+    GLuint vao;
+    GLuint vbos[2];
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glGenBuffers(2, vbos);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbos[0]);
+    glBufferData(GL_ARRAY_BUFFER, mesh.getNumVertexPositionBytes(),
+            mesh.getVertexPositionDataPtr(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, NULL);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbos[1]);
+    if (normals.size() == positions.size()) {
+        glBufferData(GL_ARRAY_BUFFER, mesh.getNumVertexNormalBytes(),
+                mesh.getVertexNormalDataPtr(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, NULL);
+    } else {
+        glDisableVertexAttribArray(1);
+        glVertexAttrib3f(1, 0.0f, 0.0f, 1.0f);
+    }
+
+    //-- Render one orthographic frame per octahedral direction.
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glViewport(0, 0, atlasSize, atlasSize);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    const float r = boundingSphereRadius;
+    mat4 projectionMatrix = glm::ortho(-r, r, -r, r, 0.0f, 2.0f * r);
+    bakeShader.setUniform("ProjectionMatrix", projectionMatrix);
+    bakeShader.setUniform("diffuseColor", diffuseColor);
+
+    bakeShader.enable();
+    for (unsigned int j = 0; j < framesPerSide; ++j) {
+        for (unsigned int i = 0; i < framesPerSide; ++i) {
+            vec3 direction = getFrameDirection(i, j, framesPerSide);
+            vec3 right, up;
+            getFrameBasis(direction, right, up);
+
+            mat4 viewMatrix = glm::lookAt(boundingSphereCenter + direction * r,
+                    boundingSphereCenter, up);
+            bakeShader.setUniform("ViewMatrix", viewMatrix);
+
+            glViewport(GLint(i * frameResolution), GLint(j * frameResolution),
+                    GLsizei(frameResolution), GLsizei(frameResolution));
+            glDrawArrays(GL_TRIANGLES, 0, GLsizei(positions.size()));
+        }
+    }
+    bakeShader.disable();
+
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glBindTexture(GL_TEXTURE_2D, normalDepthTexture);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    //-- Release temporaries and restore state.
+    glBindVertexArray(prevVao);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDeleteBuffers(2, vbos);
+    glDeleteVertexArrays(1, &vao);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFramebuffer);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &depthBuffer);
+
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    glClearColor(prevClearColor[0], prevClearColor[1], prevClearColor[2], prevClearColor[3]);
+    if (!depthTestEnabled) {
+        glDisable(GL_DEPTH_TEST);
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint ImpostorAtlas::getColorTexture() const {
+    return colorTexture;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint ImpostorAtlas::getNormalDepthTexture() const {
+    return normalDepthTexture;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ImpostorAtlas::getFramesPerSide() const {
+    return framesPerSide;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ImpostorAtlas::getFrameResolution() const {
+    return frameResolution;
+}
+
+//----------------------------------------------------------------------------------------
+const vec3 & ImpostorAtlas::getBoundingSphereCenter() const {
+    return boundingSphereCenter;
+}
+
+//----------------------------------------------------------------------------------------
+float ImpostorAtlas::getBoundingSphereRadius() const {
+    return boundingSphereRadius;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the object space direction, pointing from the mesh towards the viewer,
+ * from which frame (i, j) is rendered.
+ */
+vec3 ImpostorAtlas::getFrameDirection(unsigned int i, unsigned int j,
+                                      unsigned int framesPerSide) {
+    vec2 uv((float(i) + 0.5f) / float(framesPerSide),
+            (float(j) + 0.5f) / float(framesPerSide));
+    return octahedralDecode(uv);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Computes the image plane axes of a frame rendered from 'direction'.  The same
+ * construction is used by Impostor.vert when mapping quads back onto frames.
+ *
+ * @param direction - unit vector pointing towards the viewer.
+ * @param right - receives the frame's +x axis.
+ * @param up - receives the frame's +y axis.
+ */
+void ImpostorAtlas::getFrameBasis(const vec3 & direction, vec3 & right, vec3 & up) {
+    vec3 worldUp = (std::fabs(direction.y) < 0.999f) ? vec3(0.0f, 1.0f, 0.0f)
+                                                     : vec3(0.0f, 0.0f, 1.0f);
+    right = glm::normalize(glm::cross(worldUp, direction));
+    up = glm::cross(direction, right);
+}
+
+} // end namespace Rigid3D
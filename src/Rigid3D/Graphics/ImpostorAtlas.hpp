@@ -0,0 +1,95 @@
+/**
+ * @brief ImpostorAtlas
+ */
+
+#ifndef RIGID3D_IMPOSTOR_ATLAS_HPP_
+#define RIGID3D_IMPOSTOR_ATLAS_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+// Forward declarations
+namespace Rigid3D {
+    class Mesh;
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Pre-rendered views of a \c Mesh used to draw distant copies as camera
+     * facing quads.
+     *
+     * The mesh is rendered orthographically from framesPerSide * framesPerSide view
+     * directions laid out on an octahedral grid, so that frame (i, j) is seen from
+     * \c octahedralDecode(((i, j) + 0.5) / framesPerSide).  Each frame covers the
+     * mesh's bounding sphere.  Two textures are produced:
+     * # color - RGB diffuse color with coverage in alpha.
+     * # normalDepth - object space normal packed into [0,1] in RGB, and depth across
+     *   the bounding sphere in alpha, 0 being nearest the viewer.
+     * Both are premultiplied by coverage so they can be mipmapped and blended.
+     *
+     * The bake ShaderProgram is expected to be built from ImpostorBake.vert and
+     * ImpostorBake.frag, and a current OpenGL context is required.
+     *
+     * \code{.cpp}
+     *  ShaderProgram bakeShader;
+     *  bakeShader.generateProgramObject();
+     *  bakeShader.attachVertexShader("../data/shaders/ImpostorBake.vert");
+     *  bakeShader.attachFragmentShader("../data/shaders/ImpostorBake.frag");
+     *  bakeShader.link();
+     *
+     *  ImpostorAtlas treeAtlas;
+     *  treeAtlas.bake(Mesh("../data/meshes/tree.obj"), vec3(0.2f, 0.6f, 0.2f), bakeShader);
+     * \endcode
+     *
+     * @see ImpostorRenderer
+     */
+    class ImpostorAtlas {
+    public:
+        ImpostorAtlas();
+
+        ~ImpostorAtlas();
+
+        void bake(const Mesh & mesh,
+                  const vec3 & diffuseColor,
+                  ShaderProgram & bakeShader,
+                  unsigned int framesPerSide = 8,
+                  unsigned int frameResolution = 128);
+
+        GLuint getColorTexture() const;
+
+        GLuint getNormalDepthTexture() const;
+
+        unsigned int getFramesPerSide() const;
+
+        unsigned int getFrameResolution() const;
+
+        const vec3 & getBoundingSphereCenter() const;
+
+        float getBoundingSphereRadius() const;
+
+        static vec3 getFrameDirection(unsigned int i, unsigned int j,
+                                      unsigned int framesPerSide);
+
+        static void getFrameBasis(const vec3 & direction, vec3 & right, vec3 & up);
+
+    private:
+        // Non-copyable, the atlas owns its textures.
+        ImpostorAtlas(const ImpostorAtlas &);
+        ImpostorAtlas & operator = (const ImpostorAtlas &);
+
+        void releaseTextures();
+
+        GLuint colorTexture;
+        GLuint normalDepthTexture;
+        unsigned int framesPerSide;
+        unsigned int frameResolution;
+        vec3 boundingSphereCenter;
+        float boundingSphereRadius;
+    };
+
+}
+
+#endif /* RIGID3D_IMPOSTOR_ATLAS_HPP_ */
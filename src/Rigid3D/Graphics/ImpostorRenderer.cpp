@@ -0,0 +1,162 @@
+#include "ImpostorRenderer.hpp"
+
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/ImpostorAtlas.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+
+#include <algorithm>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * @note Requires a current OpenGL context.
+ *
+ * @param atlas - baked views of the mesh being drawn.  Must outlive this object.
+ * @param shaderProgram - linked Impostor ShaderProgram.
+ */
+ImpostorRenderer::ImpostorRenderer(const ImpostorAtlas & atlas, ShaderProgram & shaderProgram)
+    : atlas(&atlas),
+      shaderProgram(&shaderProgram),
+      switchDistance(50.0f),
+      vao(0),
+      instanceVbo(0) {
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+
+    // Quad corners are generated from gl_VertexID, so only instance data is sourced.
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+            reinterpret_cast<void *>(0));
+    glVertexAttribDivisor(0, 1);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+            reinterpret_cast<void *>(sizeof(vec4)));
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+ImpostorRenderer::~ImpostorRenderer() {
+    glDeleteBuffers(1, &instanceVbo);
+    glDeleteVertexArrays(1, &vao);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets the camera distance beyond which \c submit() replaces a \c Renderable with
+ * an impostor.
+ */
+void ImpostorRenderer::setSwitchDistance(float distance) {
+    switchDistance = distance;
+}
+
+//----------------------------------------------------------------------------------------
+float ImpostorRenderer::getSwitchDistance() const {
+    return switchDistance;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues an impostor instance for 'renderable' if it lies farther than the switch
+ * distance from 'cameraPosition'.
+ *
+ * @return true if an impostor was queued, in which case the caller should not
+ * render 'renderable' itself.
+ */
+bool ImpostorRenderer::submit(const Renderable & renderable, const vec3 & cameraPosition) {
+    vec3 position = renderable.getPosition();
+    vec3 offset = position - cameraPosition;
+
+    if (glm::dot(offset, offset) < switchDistance * switchDistance) {
+        return false;
+    }
+
+    vec3 scale = renderable.getScale();
+    addInstance(position, renderable.getPose(), std::max(scale.x, std::max(scale.y, scale.z)));
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues an impostor instance.
+ *
+ * @param position - world space position of the mesh origin.
+ * @param pose - world space orientation of the mesh.
+ * @param scale - uniform scale factor applied to the mesh.
+ */
+void ImpostorRenderer::addInstance(const vec3 & position, const quat & pose, float scale) {
+    Instance instance;
+    instance.positionScale = vec4(position, scale);
+    instance.orientation = vec4(pose.x, pose.y, pose.z, pose.w);
+    instances.push_back(instance);
+}
+
+//----------------------------------------------------------------------------------------
+void ImpostorRenderer::clearInstances() {
+    instances.clear();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ImpostorRenderer::getNumInstances() const {
+    return (unsigned int)instances.size();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws all queued instances with a single instanced draw call.
+ */
+void ImpostorRenderer::render(const RenderContext & context) {
+    if (instances.empty() || atlas->getColorTexture() == 0) {
+        return;
+    }
+
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+
+    // Orphan the previous frame's storage so the upload does not stall.
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(Instance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(Instance), instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    shaderProgram->setUniform("ViewMatrix", context.viewMatrix);
+    shaderProgram->setUniform("ProjectionMatrix", context.projectionMatrix);
+    shaderProgram->setUniform("framesPerSide", int(atlas->getFramesPerSide()));
+    shaderProgram->setUniform("frameResolution", float(atlas->getFrameResolution()));
+    shaderProgram->setUniform("boundsCenter", atlas->getBoundingSphereCenter());
+    shaderProgram->setUniform("boundsRadius", atlas->getBoundingSphereRadius());
+    shaderProgram->setUniform("colorAtlas", 0);
+    shaderProgram->setUniform("normalDepthAtlas", 1);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas->getColorTexture());
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, atlas->getNormalDepthTexture());
+
+    glBindVertexArray(vao);
+    shaderProgram->enable();
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GLsizei(instances.size()));
+    shaderProgram->disable();
+    glBindVertexArray(prevVao);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+} // end namespace Rigid3D
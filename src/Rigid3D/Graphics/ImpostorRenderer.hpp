@@ -0,0 +1,91 @@
+/**
+ * @brief ImpostorRenderer
+ */
+
+#ifndef RIGID3D_IMPOSTOR_RENDERER_HPP_
+#define RIGID3D_IMPOSTOR_RENDERER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class ImpostorAtlas;
+    class Renderable;
+    class ShaderProgram;
+    struct RenderContext;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Draws distant copies of a mesh as camera facing quads textured from an
+     * \c ImpostorAtlas, using one instanced draw call.
+     *
+     * Each quad picks the four atlas frames surrounding the view direction and
+     * blends them bilinearly.  Baked depth is written to the depth buffer so that
+     * impostors intersect regular geometry correctly.
+     *
+     * The ShaderProgram is expected to be built from Impostor.vert and
+     * Impostor.frag, and the following uniforms must be set by the caller:
+     * # uniform vec3 ambientIntensity
+     * # uniform vec3 lightDirection  // Eye space direction towards the light.
+     *
+     * Typical per frame usage:
+     * \code{.cpp}
+     *  for (Renderable & tree : trees) {
+     *      if (!treeImpostors.submit(tree, camera.getPosition())) {
+     *          tree.render(renderContext);
+     *      }
+     *  }
+     *  treeImpostors.render(renderContext);
+     *  treeImpostors.clearInstances();
+     * \endcode
+     */
+    class ImpostorRenderer {
+    public:
+        ImpostorRenderer(const ImpostorAtlas & atlas, ShaderProgram & shaderProgram);
+
+        ~ImpostorRenderer();
+
+        void setSwitchDistance(float distance);
+
+        float getSwitchDistance() const;
+
+        bool submit(const Renderable & renderable, const vec3 & cameraPosition);
+
+        void addInstance(const vec3 & position, const quat & pose, float scale);
+
+        void clearInstances();
+
+        unsigned int getNumInstances() const;
+
+        void render(const RenderContext & context);
+
+    private:
+        // Non-copyable, owns GL buffer objects.
+        ImpostorRenderer(const ImpostorRenderer &);
+        ImpostorRenderer & operator = (const ImpostorRenderer &);
+
+        // Per instance vertex data, matching the layout in Impostor.vert.
+        struct Instance {
+            vec4 positionScale;
+            vec4 orientation;
+        };
+
+        const ImpostorAtlas * atlas;
+        ShaderProgram * shaderProgram;
+        float switchDistance;
+
+        std::vector<Instance> instances;
+
+        GLuint vao;
+        GLuint instanceVbo;
+    };
+
+}
+
+#endif /* RIGID3D_IMPOSTOR_RENDERER_HPP_ */
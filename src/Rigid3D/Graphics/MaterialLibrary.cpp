@@ -0,0 +1,570 @@
+#include "MaterialLibrary.hpp"
+
+#include <Rigid3D/Common/ContentHash.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/VirtualFileSystem.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <LoadPNG/lodepng.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace Rigid3D {
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    GLsizei numMipmapLevels(GLsizei width, GLsizei height) {
+        GLsizei numLevels = 1;
+        for (GLsizei size = std::max(width, height); size > 1; size /= 2) {
+            ++numLevels;
+        }
+        return numLevels;
+    }
+
+    //------------------------------------------------------------------------------------
+    bool hasExtension(const char * extensionName) {
+        GLint numExtensions = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+        for (GLint i = 0; i < numExtensions; ++i) {
+            const GLubyte * name = glGetStringi(GL_EXTENSIONS, GLuint(i));
+            if (name != NULL &&
+                    std::strcmp(reinterpret_cast<const char *>(name), extensionName) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //------------------------------------------------------------------------------------
+    void setSamplingParameters(GLenum target) {
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    }
+
+} // end anonymous namespace
+
+const uint32 MaterialLibrary::NoTexture;
+const uint32 MaterialLibrary::MaxTextureArrays;
+const GLuint MaterialLibrary::MaterialBinding;
+const GLuint MaterialLibrary::FirstTextureUnit;
+
+//----------------------------------------------------------------------------------------
+MaterialLibrary::Stats::Stats()
+    : numMaterials(0),
+      numTextures(0),
+      numTextureArrays(0),
+      numTextureLayers(0),
+      numSharedTextures(0),
+      bindless(false) {
+
+}
+
+//----------------------------------------------------------------------------------------
+MaterialLibrary::Texture::Texture()
+    : arraySlot(NoTexture),
+      layer(0),
+      bindlessTexture(0),
+      handle(0),
+      hash(0),
+      refCount(0),
+      width(0),
+      height(0),
+      internalFormat(GL_NONE) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param allowBindless - use ARB_bindless_texture handles when the extension is
+ * available.  If false, texture arrays are always used.
+ *
+ * @note Requires a current OpenGL 4.3 context.
+ */
+MaterialLibrary::MaterialLibrary(bool allowBindless)
+    : bindless(false),
+      maxArrayLayers(0),
+      numSharedTextures(0),
+      materialBuffer(0),
+      materialBufferCapacity(0),
+      materialsDirty(true) {
+
+#ifdef GL_ARB_bindless_texture
+    bindless = allowBindless && hasExtension("GL_ARB_bindless_texture");
+#else
+    (void)allowBindless;
+#endif
+
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxArrayLayers);
+    glGenBuffers(1, &materialBuffer);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+MaterialLibrary::~MaterialLibrary() {
+    for (const Texture & texture : textures) {
+        if (texture.bindlessTexture != 0) {
+#ifdef GL_ARB_bindless_texture
+            glMakeTextureHandleNonResidentARB(texture.handle);
+#endif
+            glDeleteTextures(1, &texture.bindlessTexture);
+        }
+    }
+    for (const TextureArray & textureArray : textureArrays) {
+        glDeleteTextures(1, &textureArray.texture);
+    }
+    glDeleteBuffers(1, &materialBuffer);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies an RGBA image, 4 bytes per pixel with rows ordered bottom to top, into the
+ * library.
+ *
+ * @param internalFormat - sized internal format such as GL_RGBA8 or
+ * GL_SRGB8_ALPHA8.  Textures only share an array if their size and format match.
+ *
+ * @return index of the texture, for use with \c addMaterial().  Adding an image
+ * identical to a live texture returns that texture without uploading, and adds a
+ * reference to it.
+ */
+uint32 MaterialLibrary::addTexture(GLsizei width,
+                                   GLsizei height,
+                                   const unsigned char * rgbaPixels,
+                                   GLenum internalFormat) {
+    if (width <= 0 || height <= 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid texture size " << width << "x" << height
+                     << " within method MaterialLibrary::addTexture";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const size_t numBytes = size_t(width) * size_t(height) * 4;
+    const GLint key[3] = {width, height, GLint(internalFormat)};
+    uint64 hash = ContentHash::hash(key, sizeof(key));
+    hash = ContentHash::hash(rgbaPixels, numBytes, hash);
+
+    // A 64 bit hash of the pixels, with matching size and format, is taken as
+    // identity rather than keeping a CPU copy of every image to compare against.
+    auto candidates = texturesByHash.equal_range(hash);
+    for (auto candidate = candidates.first; candidate != candidates.second; ++candidate) {
+        Texture & texture = textures[candidate->second];
+        if (texture.width == width && texture.height == height &&
+                texture.internalFormat == internalFormat) {
+            ++texture.refCount;
+            ++numSharedTextures;
+            return candidate->second;
+        }
+    }
+
+    uint32 index;
+    if (bindless) {
+        index = addBindlessTexture(width, height, rgbaPixels, internalFormat);
+    } else {
+        const uint32 arraySlot = findTextureArray(width, height, internalFormat);
+        TextureArray & textureArray = textureArrays[arraySlot];
+
+        uint32 layer;
+        if (!textureArray.freeLayers.empty()) {
+            layer = textureArray.freeLayers.back();
+            textureArray.freeLayers.pop_back();
+        } else {
+            if (textureArray.numLayers == textureArray.layerCapacity) {
+                growTextureArray(textureArray);
+            }
+            layer = textureArray.numLayers++;
+        }
+
+        GLint prevAlignment;
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevAlignment);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, GLint(layer), width, height, 1,
+                GL_RGBA, GL_UNSIGNED_BYTE, rgbaPixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, prevAlignment);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        textureArray.mipmapsStale = true;
+
+        Texture texture;
+        texture.arraySlot = arraySlot;
+        texture.layer = layer;
+        textures.push_back(texture);
+        index = uint32(textures.size() - 1);
+
+        CHECK_GL_ERRORS;
+    }
+
+    Texture & texture = textures[index];
+    texture.hash = hash;
+    texture.refCount = 1;
+    texture.width = width;
+    texture.height = height;
+    texture.internalFormat = internalFormat;
+    texturesByHash.insert(std::make_pair(hash, index));
+
+    return index;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Decodes a PNG file, read through \c VirtualFileSystem::getDefault(), and adds it
+ * with \c addTexture().
+ */
+uint32 MaterialLibrary::loadTexture(const char * pngFilePath, GLenum internalFormat) {
+    std::vector<uint8> png;
+    VirtualFileSystem::getDefault().read(pngFilePath, png);
+
+    std::vector<unsigned char> pixels;
+    unsigned width;
+    unsigned height;
+    unsigned error = lodepng::decode(pixels, width, height, png);
+    if (error) {
+        std::stringstream errorMessage;
+        errorMessage << "Unable to decode " << pngFilePath << ": "
+                     << lodepng_error_text(error)
+                     << " within method MaterialLibrary::loadTexture";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    // PNG rows run top to bottom, OpenGL expects the bottom row first.
+    const size_t rowBytes = size_t(width) * 4;
+    for (unsigned row = 0; row < height / 2; ++row) {
+        std::swap_ranges(pixels.begin() + row * rowBytes,
+                         pixels.begin() + (row + 1) * rowBytes,
+                         pixels.begin() + (height - 1 - row) * rowBytes);
+    }
+
+    return addTexture(GLsizei(width), GLsizei(height), pixels.data(), internalFormat);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Drops one reference to 'texture', added by \c addTexture() or \c loadTexture().
+ * With the last reference the texture stops being shared, a bindless texture is
+ * deleted and an array layer becomes free for reuse.  Materials must no longer use
+ * it, and its index is not reused.
+ */
+void MaterialLibrary::releaseTexture(uint32 texture) {
+    checkTexture(texture, "releaseTexture");
+
+    Texture & released = textures[texture];
+    if (--released.refCount > 0) {
+        return;
+    }
+
+    auto candidates = texturesByHash.equal_range(released.hash);
+    for (auto candidate = candidates.first; candidate != candidates.second; ++candidate) {
+        if (candidate->second == texture) {
+            texturesByHash.erase(candidate);
+            break;
+        }
+    }
+
+    if (released.bindlessTexture != 0) {
+#ifdef GL_ARB_bindless_texture
+        glMakeTextureHandleNonResidentARB(released.handle);
+#endif
+        glDeleteTextures(1, &released.bindlessTexture);
+        released.bindlessTexture = 0;
+        released.handle = 0;
+    } else if (released.arraySlot != NoTexture) {
+        textureArrays[released.arraySlot].freeLayers.push_back(released.layer);
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param texture - index returned by \c addTexture(), or NoTexture.  Textured
+ * materials multiply their ambient and diffuse terms by the texture color.
+ *
+ * @return index of the material, which shaders use to look it up.
+ */
+uint32 MaterialLibrary::addMaterial(const MaterialProperties & properties,
+                                    uint32 texture) {
+    materials.push_back(packMaterial(properties, texture));
+    materialsDirty = true;
+
+    return uint32(materials.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------
+void MaterialLibrary::setMaterial(uint32 material,
+                                  const MaterialProperties & properties,
+                                  uint32 texture) {
+    if (material >= materials.size()) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid material index " << material
+                     << " within method MaterialLibrary::setMaterial";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    materials[material] = packMaterial(properties, texture);
+    materialsDirty = true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Uploads changed materials, regenerates the mipmaps of texture arrays that gained
+ * layers, then binds the material buffer and texture arrays for drawing.
+ *
+ * @note Leaves GL_TEXTURE0 as the active texture unit.
+ */
+void MaterialLibrary::bind() {
+    if (materialsDirty) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, materialBuffer);
+        if (materials.size() > materialBufferCapacity || materialBufferCapacity == 0) {
+            // Never allocated empty, so that it can always be bound.
+            materialBufferCapacity = std::max(materials.size(), size_t(1));
+            glBufferData(GL_SHADER_STORAGE_BUFFER,
+                    GLsizeiptr(materialBufferCapacity * sizeof(GpuMaterial)), NULL,
+                    GL_DYNAMIC_DRAW);
+        }
+        if (!materials.empty()) {
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0,
+                    GLsizeiptr(materials.size() * sizeof(GpuMaterial)), materials.data());
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        materialsDirty = false;
+    }
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MaterialBinding, materialBuffer);
+
+    for (size_t slot = 0; slot < textureArrays.size(); ++slot) {
+        TextureArray & textureArray = textureArrays[slot];
+        glActiveTexture(GLenum(GL_TEXTURE0 + FirstTextureUnit + slot));
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.texture);
+        if (textureArray.mipmapsStale) {
+            glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+            textureArray.mipmapsStale = false;
+        }
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+bool MaterialLibrary::isBindless() const {
+    return bindless;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint MaterialLibrary::getMaterialBuffer() const {
+    return materialBuffer;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @note The texture object changes whenever the array grows.
+ */
+GLuint MaterialLibrary::getTextureArray(uint32 arraySlot) const {
+    return (arraySlot < textureArrays.size()) ? textureArrays[arraySlot].texture : 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Retrieves where 'texture' is stored.  'arraySlot' is NoTexture for bindless
+ * textures.
+ */
+void MaterialLibrary::getTextureLocation(uint32 texture,
+                                         uint32 & arraySlot,
+                                         uint32 & layer) const {
+    checkTexture(texture, "getTextureLocation");
+
+    arraySlot = textures[texture].arraySlot;
+    layer = textures[texture].layer;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 MaterialLibrary::getNumMaterials() const {
+    return uint32(materials.size());
+}
+
+//----------------------------------------------------------------------------------------
+uint32 MaterialLibrary::getNumTextures() const {
+    return uint32(textures.size());
+}
+
+//----------------------------------------------------------------------------------------
+MaterialLibrary::Stats MaterialLibrary::getStats() const {
+    Stats stats;
+    stats.numMaterials = uint32(materials.size());
+    for (const Texture & texture : textures) {
+        if (texture.refCount > 0) {
+            ++stats.numTextures;
+        }
+    }
+    stats.numTextureArrays = uint32(textureArrays.size());
+    for (const TextureArray & textureArray : textureArrays) {
+        stats.numTextureLayers += textureArray.layerCapacity;
+    }
+    stats.numSharedTextures = numSharedTextures;
+    stats.bindless = bindless;
+
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 MaterialLibrary::addBindlessTexture(GLsizei width,
+                                           GLsizei height,
+                                           const unsigned char * rgbaPixels,
+                                           GLenum internalFormat) {
+    Texture texture;
+
+#ifdef GL_ARB_bindless_texture
+    glGenTextures(1, &texture.bindlessTexture);
+    glBindTexture(GL_TEXTURE_2D, texture.bindlessTexture);
+    glTexStorage2D(GL_TEXTURE_2D, numMipmapLevels(width, height), internalFormat,
+            width, height);
+    GLint prevAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+            rgbaPixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prevAlignment);
+    setSamplingParameters(GL_TEXTURE_2D);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // The texture's state is frozen once a handle is taken.
+    texture.handle = glGetTextureHandleARB(texture.bindlessTexture);
+    glMakeTextureHandleResidentARB(texture.handle);
+#else
+    (void)width;
+    (void)height;
+    (void)rgbaPixels;
+    (void)internalFormat;
+#endif
+
+    textures.push_back(texture);
+
+    CHECK_GL_ERRORS;
+
+    return uint32(textures.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return slot of the texture array holding textures of the given size and format,
+ * creating it if needed.
+ */
+uint32 MaterialLibrary::findTextureArray(GLsizei width, GLsizei height,
+                                         GLenum internalFormat) {
+    for (size_t slot = 0; slot < textureArrays.size(); ++slot) {
+        const TextureArray & textureArray = textureArrays[slot];
+        if (textureArray.width == width && textureArray.height == height &&
+                textureArray.internalFormat == internalFormat) {
+            return uint32(slot);
+        }
+    }
+
+    if (textureArrays.size() == MaxTextureArrays) {
+        std::stringstream errorMessage;
+        errorMessage << "A texture of size " << width << "x" << height
+                     << " needs a new texture array, but all " << MaxTextureArrays
+                     << " are in use within method MaterialLibrary::addTexture";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    TextureArray textureArray;
+    textureArray.texture = 0;
+    textureArray.width = width;
+    textureArray.height = height;
+    textureArray.internalFormat = internalFormat;
+    textureArray.numLevels = numMipmapLevels(width, height);
+    textureArray.numLayers = 0;
+    textureArray.layerCapacity = 0;
+    textureArray.mipmapsStale = false;
+    textureArrays.push_back(textureArray);
+
+    return uint32(textureArrays.size() - 1);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Throws unless 'texture' is the index of a texture that has not been released.
+ */
+void MaterialLibrary::checkTexture(uint32 texture, const char * methodName) const {
+    if (texture >= textures.size() || textures[texture].refCount == 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid texture index " << texture
+                     << " within method MaterialLibrary::" << methodName;
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Doubles the layer capacity of 'textureArray', copying existing layers into a
+ * new immutable texture.
+ */
+void MaterialLibrary::growTextureArray(TextureArray & textureArray) {
+    if (textureArray.layerCapacity >= uint32(maxArrayLayers)) {
+        std::stringstream errorMessage;
+        errorMessage << "Texture array of size " << textureArray.width << "x"
+                     << textureArray.height << " is full at " << maxArrayLayers
+                     << " layers within method MaterialLibrary::addTexture";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const uint32 layerCapacity = std::min(std::max(textureArray.layerCapacity * 2, 4u),
+            uint32(maxArrayLayers));
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, textureArray.numLevels,
+            textureArray.internalFormat, textureArray.width, textureArray.height,
+            GLsizei(layerCapacity));
+    setSamplingParameters(GL_TEXTURE_2D_ARRAY);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    if (textureArray.numLayers > 0) {
+        // Mipmaps are regenerated by bind(), so only the base level is copied.
+        glCopyImageSubData(textureArray.texture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+                texture, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+                textureArray.width, textureArray.height, GLsizei(textureArray.numLayers));
+        textureArray.mipmapsStale = true;
+    }
+    glDeleteTextures(1, &textureArray.texture);
+
+    textureArray.texture = texture;
+    textureArray.layerCapacity = layerCapacity;
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+MaterialLibrary::GpuMaterial MaterialLibrary::packMaterial(
+        const MaterialProperties & properties,
+        uint32 texture) const {
+    if (texture != NoTexture) {
+        checkTexture(texture, "addMaterial");
+    }
+
+    GpuMaterial material;
+    material.emission = vec4(properties.emission, properties.shininessFactor);
+    material.ambient = vec4(properties.Ka, properties.Ks);
+    material.diffuse = vec4(properties.Kd, 1.0f);
+    material.arraySlot = NoTexture;
+    material.layer = 0;
+    material.handleLow = 0;
+    material.handleHigh = 0;
+
+    if (texture != NoTexture) {
+        material.arraySlot = textures[texture].arraySlot;
+        material.layer = textures[texture].layer;
+        material.handleLow = uint32(textures[texture].handle & 0xFFFFFFFF);
+        material.handleHigh = uint32(textures[texture].handle >> 32);
+    }
+
+    return material;
+}
+
+} // end namespace Rigid3D
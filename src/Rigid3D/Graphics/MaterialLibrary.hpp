@@ -0,0 +1,185 @@
+/**
+ * @brief MaterialLibrary
+ */
+
+#ifndef RIGID3D_MATERIAL_LIBRARY_HPP_
+#define RIGID3D_MATERIAL_LIBRARY_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/MaterialProperties.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Holds every material and material texture of a scene in a form that
+     * shaders can select per draw, so that meshes with different materials can be
+     * drawn without binding anything in between.
+     *
+     * Material properties live in a shader storage buffer at binding
+     * \c MaterialBinding, one 64 byte entry per material, see MaterialBatched.frag.
+     *
+     * Textures are stored in one of two ways, decided at construction:
+     * # If ARB_bindless_texture is available, and allowed, each texture gets its own
+     *   resident texture object whose 64 bit handle is written into the materials
+     *   that use it.
+     * # Otherwise textures are grouped by size and internal format into
+     *   GL_TEXTURE_2D_ARRAY objects, one per group, and materials record the array
+     *   and layer they use.  Arrays double their layer count as textures are added.
+     *   At most \c MaxTextureArrays groups may exist, bound to consecutive texture
+     *   units starting at \c FirstTextureUnit.
+     *
+     * Identical images added more than once, for instance under different file
+     * names, share one texture.  Images are identified by a 64 bit content hash
+     * together with their size and format, so no CPU copy is kept.  A texture is
+     * reference counted until released with \c releaseTexture(), and a released
+     * array layer is reused by the next texture of the same size and format.
+     *
+     * Changes are uploaded by the next call to \c bind().
+     *
+     * \code{.cpp}
+     *  MaterialLibrary materials;
+     *  uint32 brick = materials.loadTexture("../data/textures/brick.png");
+     *  uint32 wall = materials.addMaterial(wallProperties, brick);
+     *  uint32 glass = materials.addMaterial(glassProperties);
+     *
+     *  // Each frame.
+     *  materials.bind();
+     *  batch.draw(GL_TRIANGLES);
+     * \endcode
+     *
+     * Requires an OpenGL 4.3 context.
+     *
+     * @see MultiDrawBatch
+     */
+    class MaterialLibrary {
+    public:
+        static const uint32 NoTexture = 0xFFFFFFFF;
+        static const uint32 MaxTextureArrays = 4;
+        static const GLuint MaterialBinding = 1;
+        static const GLuint FirstTextureUnit = 0;
+
+        struct Stats {
+            uint32 numMaterials;
+            uint32 numTextures;
+            uint32 numTextureArrays;
+            uint32 numTextureLayers;   // Allocated layers across all arrays.
+            uint32 numSharedTextures;  // Additions answered by an identical texture.
+            bool bindless;
+
+            Stats();
+        };
+
+        explicit MaterialLibrary(bool allowBindless = true);
+
+        ~MaterialLibrary();
+
+        uint32 addTexture(GLsizei width,
+                          GLsizei height,
+                          const unsigned char * rgbaPixels,
+                          GLenum internalFormat = GL_RGBA8);
+
+        uint32 loadTexture(const char * pngFilePath, GLenum internalFormat = GL_RGBA8);
+
+        void releaseTexture(uint32 texture);
+
+        uint32 addMaterial(const MaterialProperties & properties,
+                           uint32 texture = NoTexture);
+
+        void setMaterial(uint32 material,
+                         const MaterialProperties & properties,
+                         uint32 texture = NoTexture);
+
+        void bind();
+
+        bool isBindless() const;
+
+        GLuint getMaterialBuffer() const;
+
+        GLuint getTextureArray(uint32 arraySlot) const;
+
+        void getTextureLocation(uint32 texture, uint32 & arraySlot, uint32 & layer) const;
+
+        uint32 getNumMaterials() const;
+
+        uint32 getNumTextures() const;
+
+        Stats getStats() const;
+
+    private:
+        // Non-copyable, owns GL objects.
+        MaterialLibrary(const MaterialLibrary &);
+        MaterialLibrary & operator = (const MaterialLibrary &);
+
+        // std430 layout matching MaterialBatched.frag.
+        struct GpuMaterial {
+            vec4 emission;      // w holds the shininess factor.
+            vec4 ambient;       // w holds the specular coefficient Ks.
+            vec4 diffuse;
+            uint32 arraySlot;   // NoTexture if untextured.
+            uint32 layer;
+            uint32 handleLow;   // Bindless handle, 0 when texture arrays are used.
+            uint32 handleHigh;
+        };
+
+        struct TextureArray {
+            GLuint texture;
+            GLsizei width;
+            GLsizei height;
+            GLenum internalFormat;
+            GLsizei numLevels;
+            uint32 numLayers;
+            uint32 layerCapacity;
+            std::vector<uint32> freeLayers;   // Released, below numLayers.
+            bool mipmapsStale;
+        };
+
+        struct Texture {
+            uint32 arraySlot;
+            uint32 layer;
+            GLuint bindlessTexture;
+            uint64 handle;
+            uint64 hash;
+            uint32 refCount;                    // Zero once released.
+            GLsizei width;
+            GLsizei height;
+            GLenum internalFormat;
+
+            Texture();
+        };
+
+        uint32 addBindlessTexture(GLsizei width, GLsizei height,
+                                  const unsigned char * rgbaPixels, GLenum internalFormat);
+
+        uint32 findTextureArray(GLsizei width, GLsizei height, GLenum internalFormat);
+
+        void checkTexture(uint32 texture, const char * methodName) const;
+
+        void growTextureArray(TextureArray & textureArray);
+
+        GpuMaterial packMaterial(const MaterialProperties & properties,
+                                 uint32 texture) const;
+
+        bool bindless;
+        GLint maxArrayLayers;
+
+        std::vector<GpuMaterial> materials;
+        std::vector<Texture> textures;
+        std::vector<TextureArray> textureArrays;
+
+        // Index of each live texture by content hash, colliding images included.
+        std::unordered_multimap<uint64, uint32> texturesByHash;
+        uint32 numSharedTextures;
+
+        GLuint materialBuffer;
+        size_t materialBufferCapacity;   // In materials.
+        bool materialsDirty;
+    };
+
+}
+
+#endif /* RIGID3D_MATERIAL_LIBRARY_HPP_ */
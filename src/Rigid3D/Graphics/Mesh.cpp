@@ -3,10 +3,13 @@
 #include <Rigid3D/Common/Rigid3DException.hpp>
 #include <Rigid3D/Graphics/ObjFileLoader.hpp>
 
+#include <sstream>
 #include <utility>
 
 namespace Rigid3D {
 
+const unsigned int Mesh::MaxBonesPerVertex;
+
 //----------------------------------------------------------------------------------------
 /**
  * Constructs a Mesh object from a Wavefront .obj file format.
@@ -25,6 +28,24 @@ Mesh::Mesh() {
     // Empty, like my ice cold heart.
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Constructs a Mesh by taking ownership of already decoded vertex data, such as
+ * data read back from a cooked mesh file.
+ *
+ * @param positions - positions given in (x,y,z) object space.
+ * @param normals - normals given in (x,y,z) object space.
+ * @param textureCoords - texture coordinates, may be empty.
+ */
+Mesh::Mesh(vector<vec3> && positions,
+           vector<vec3> && normals,
+           vector<vec2> && textureCoords)
+    : vertexPositions(std::move(positions)),
+      vertexNormals(std::move(normals)),
+      textureCoords(std::move(textureCoords)) {
+
+}
+
 //----------------------------------------------------------------------------------------
 /**
 * Move assignment operator.
@@ -33,6 +54,8 @@ Mesh & Mesh::operator = (Mesh && other) {
     this->vertexPositions = std::move(other.vertexPositions);
     this->vertexNormals = std::move(other.vertexNormals);
     this->textureCoords = std::move(other.textureCoords);
+    this->boneIndices = std::move(other.boneIndices);
+    this->boneWeights = std::move(other.boneWeights);
 
     return *this;
 }
@@ -73,6 +96,43 @@ const vector<vec2> * Mesh::getTextureCoordVector() const {
     return &textureCoords;
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Attaches skinning influences, taking ownership of them.
+ *
+ * @param boneIndices - \c MaxBonesPerVertex joint indices per vertex.
+ * @param boneWeights - one weight per index, summing to 1.  Unused influences
+ * have a weight of 0.
+ */
+void Mesh::setBoneWeights(vector<uint8> && boneIndices, vector<vec4> && boneWeights) {
+    if (boneWeights.size() != vertexPositions.size() ||
+            boneIndices.size() != boneWeights.size() * MaxBonesPerVertex) {
+        std::stringstream errorMessage;
+        errorMessage << "Expected bone weights for " << vertexPositions.size()
+                     << " vertices, got " << boneWeights.size() << " weights and "
+                     << boneIndices.size() << " indices within method Mesh::setBoneWeights";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    this->boneIndices = std::move(boneIndices);
+    this->boneWeights = std::move(boneWeights);
+}
+
+//----------------------------------------------------------------------------------------
+bool Mesh::hasBoneWeights() const {
+    return !boneWeights.empty();
+}
+
+//----------------------------------------------------------------------------------------
+const vector<uint8> * Mesh::getBoneIndexVector() const {
+    return &boneIndices;
+}
+
+//----------------------------------------------------------------------------------------
+const vector<vec4> * Mesh::getBoneWeightVector() const {
+    return &boneWeights;
+}
+
 //----------------------------------------------------------------------------------------
 /**
  * Returns the total size in bytes of the Mesh's vertex data.
@@ -17,6 +17,10 @@ using std::string;
 
         Mesh();
 
+        Mesh(vector<vec3> && positions,
+             vector<vec3> && normals,
+             vector<vec2> && textureCoords);
+
         Mesh & operator = (Mesh && other);
 
         const float * getVertexPositionDataPtr() const;
@@ -28,6 +32,11 @@ using std::string;
         const float * getTextureCoordDataPtr() const;
         const vector<vec2> * getTextureCoordVector() const;
 
+        void setBoneWeights(vector<uint8> && boneIndices, vector<vec4> && boneWeights);
+        bool hasBoneWeights() const;
+        const vector<uint8> * getBoneIndexVector() const;
+        const vector<vec4> * getBoneWeightVector() const;
+
         size_t getNumVertexPositionBytes() const;
         size_t getNumVertexNormalBytes() const;
         size_t getNumTextureCoordBytes() const;
@@ -40,6 +49,8 @@ using std::string;
         unsigned int getNumElementsPerVertexNormal() const;
         unsigned int getNumElementsPerTextureCoord() const;
 
+        static const unsigned int MaxBonesPerVertex = 4;
+
     private:
         vector<vec3> vertexPositions;
         static const short num_elements_per_vertex_position = 3;
@@ -49,6 +60,10 @@ using std::string;
 
         vector<vec2> textureCoords;
         static const short num_elements_per_texturedCoord = 2;
+
+        // Skinning influences, MaxBonesPerVertex per vertex.
+        vector<uint8> boneIndices;
+        vector<vec4> boneWeights;
     };
 }
 
@@ -0,0 +1,736 @@
+#include "MeshCodec.hpp"
+
+#include <Rigid3D/Common/BlockCompression.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Math/Octahedral.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+namespace Rigid3D {
+
+using namespace std;
+
+namespace {
+
+    const char magic[4] = {'R', '3', 'M', 'C'};
+
+    const uint32 invalidIndex = 0xFFFFFFFF;
+
+    // Size of the simulated cache used to score vertices while reordering.
+    const uint32 maxCacheSize = 32;
+
+    struct Header {
+        char magic[4];
+        uint32 version;
+        uint32 numVertices;
+        uint32 numIndices;
+        uint32 flags;
+        uint32 indexBytes;
+        uint8 positionBits;
+        uint8 normalBits;
+        uint8 textureCoordBits;
+        uint8 padding;
+        float positionMin[3];
+        float positionExtent[3];
+        float textureCoordMin[2];
+        float textureCoordExtent[2];
+    };
+
+    struct Vertex {
+        vec3 position;
+        vec3 normal;
+        vec2 textureCoord;
+    };
+
+    struct VertexHash {
+        size_t operator () (const Vertex & vertex) const {
+            size_t hash = 0;
+            for (int i = 0; i < 3; ++i) {
+                hash = hash * 31 + std::hash<float>()(vertex.position[i]);
+                hash = hash * 31 + std::hash<float>()(vertex.normal[i]);
+            }
+            for (int i = 0; i < 2; ++i) {
+                hash = hash * 31 + std::hash<float>()(vertex.textureCoord[i]);
+            }
+            return hash;
+        }
+    };
+
+    struct VertexEqual {
+        bool operator () (const Vertex & a, const Vertex & b) const {
+            return a.position == b.position && a.normal == b.normal &&
+                   a.textureCoord == b.textureCoord;
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+    void throwMalformed(const char * methodName) {
+        stringstream errorMessage;
+        errorMessage << "Malformed encoded mesh within method MeshCodec::" << methodName;
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    //------------------------------------------------------------------------------------
+    // Size of the decompressed payload, computed in 64 bits so that no header can
+    // overflow it.
+    uint64 getPayloadSize(const Header & header) {
+        uint64 bytesPerVertex = 3 * sizeof(uint16);
+        if ((header.flags & MeshCodec::HasNormals) != 0) {
+            bytesPerVertex += 2 * sizeof(uint16);
+        }
+        if ((header.flags & MeshCodec::HasTextureCoords) != 0) {
+            bytesPerVertex += 2 * sizeof(uint16);
+        }
+        return uint64(header.indexBytes) + uint64(header.numVertices) * bytesPerVertex;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Validates the header against the block stream that follows it, so that the
+    // counts may be used to size allocations before anything is decompressed.
+    Header readHeader(const uint8 * data, size_t size, const char * methodName) {
+        Header header;
+        if (size < sizeof(header) || memcmp(data, magic, 4) != 0) {
+            throwMalformed(methodName);
+        }
+        memcpy(&header, data, sizeof(header));
+
+        if (header.version > MeshCodec::version || header.numIndices % 3 != 0 ||
+                header.positionBits == 0 || header.positionBits > 16 ||
+                header.normalBits == 0 || header.normalBits > 16 ||
+                header.textureCoordBits == 0 || header.textureCoordBits > 16) {
+            throwMalformed(methodName);
+        }
+
+        // Every index delta is a varint of one to five bytes.
+        if (header.indexBytes < header.numIndices ||
+                uint64(header.indexBytes) > uint64(header.numIndices) * 5) {
+            throwMalformed(methodName);
+        }
+
+        uint64 storedSize = 0;
+        try {
+            storedSize = BlockCompression::getDecompressedSize(data + sizeof(header),
+                    size - sizeof(header));
+        } catch (const Rigid3DException &) {
+            throwMalformed(methodName);
+        }
+        const uint64 payloadSize = getPayloadSize(header);
+        if (payloadSize != storedSize || payloadSize > numeric_limits<size_t>::max()) {
+            throwMalformed(methodName);
+        }
+
+        return header;
+    }
+
+    //------------------------------------------------------------------------------------
+    uint16 quantize(float value, float minimum, float extent, uint32 bits) {
+        float t = (extent > 0.0f) ? (value - minimum) / extent : 0.0f;
+        t = std::min(std::max(t, 0.0f), 1.0f);
+        return uint16(t * float((1u << bits) - 1) + 0.5f);
+    }
+
+    //------------------------------------------------------------------------------------
+    void writeVarint(uint32 value, vector<uint8> & output) {
+        while (value >= 0x80) {
+            output.push_back(uint8(value | 0x80));
+            value >>= 7;
+        }
+        output.push_back(uint8(value));
+    }
+
+    //------------------------------------------------------------------------------------
+    // Appends 'values', 'numComponents' per vertex, as zigzag encoded differences
+    // from the previous vertex, split into a plane of low bytes followed by a plane
+    // of high bytes.
+    void encodeAttribute(const vector<uint16> & values, uint32 numComponents,
+            vector<uint8> & output) {
+        const size_t numValues = values.size();
+        const size_t base = output.size();
+        output.resize(base + 2 * numValues);
+        uint8 * low = &output[base];
+        uint8 * high = low + numValues;
+
+        for (size_t i = 0; i < numValues; ++i) {
+            const uint16 previous = (i >= numComponents) ? values[i - numComponents] : 0;
+            const int16 delta = int16(uint16(values[i] - previous));
+            const uint16 zigzag = uint16((uint16(delta) << 1) ^ uint16(delta >> 15));
+            low[i] = uint8(zigzag);
+            high[i] = uint8(zigzag >> 8);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Undoes encodeAttribute, passing each vertex's quantized components to 'store'.
+    template <uint32 NumComponents, typename Store>
+    void decodeAttribute(const uint8 * low, uint32 numVertices, Store store) {
+        const uint8 * high = low + size_t(numVertices) * NumComponents;
+        uint16 values[NumComponents] = {};
+
+        for (uint32 vertex = 0; vertex < numVertices; ++vertex) {
+            const size_t base = size_t(vertex) * NumComponents;
+            for (uint32 c = 0; c < NumComponents; ++c) {
+                const uint32 zigzag = uint32(low[base + c]) | (uint32(high[base + c]) << 8);
+                values[c] = uint16(values[c] + ((zigzag >> 1) ^ (0u - (zigzag & 1u))));
+            }
+            store(vertex, values);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    float scoreVertex(int cachePosition, uint32 numLiveTriangles) {
+        if (numLiveTriangles == 0) {
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            // The last triangle's vertices score equally, so that no single edge
+            // is favored.
+            if (cachePosition < 3) {
+                score = 0.75f;
+            } else {
+                score = std::pow(1.0f - float(cachePosition - 3) / float(maxCacheSize - 3),
+                        1.5f);
+            }
+        }
+
+        // Vertices with few remaining triangles are finished off first.
+        return score + 2.0f / std::sqrt(float(numLiveTriangles));
+    }
+
+    //------------------------------------------------------------------------------------
+    // Merges identical vertices of the triangle soup in 'mesh'.
+    void weldVertices(const Mesh & mesh, bool normals, bool textureCoords,
+            vector<Vertex> & vertices, vector<uint32> & indices) {
+        const vector<vec3> & meshPositions = *mesh.getVertexPositionVector();
+        const vector<vec3> & meshNormals = *mesh.getVertexNormalVector();
+        const vector<vec2> & meshTextureCoords = *mesh.getTextureCoordVector();
+
+        unordered_map<Vertex, uint32, VertexHash, VertexEqual> vertexIndices;
+        vertexIndices.reserve(meshPositions.size());
+        indices.reserve(meshPositions.size());
+
+        for (size_t i = 0; i < meshPositions.size(); ++i) {
+            Vertex vertex;
+            vertex.position = meshPositions[i];
+            vertex.normal = normals ? meshNormals[i] : vec3(0.0f);
+            vertex.textureCoord = textureCoords ? meshTextureCoords[i] : vec2(0.0f);
+
+            auto inserted = vertexIndices.insert(make_pair(vertex, uint32(vertices.size())));
+            if (inserted.second) {
+                vertices.push_back(vertex);
+            }
+            indices.push_back(inserted.first->second);
+        }
+    }
+
+} // end anonymous namespace
+
+const uint32 MeshCodec::version;
+const uint32 MeshCodec::HasNormals;
+const uint32 MeshCodec::HasTextureCoords;
+
+//----------------------------------------------------------------------------------------
+MeshCodecSettings::MeshCodecSettings()
+    : positionBits(16),
+      normalBits(12),
+      textureCoordBits(14) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Encodes the triangles of 'mesh', replacing the contents of 'output'.  Normals and
+ * texture coordinates are kept if the mesh has one per vertex position.
+ *
+ * @param threadPool - compresses the encoded streams in parallel if given.
+ */
+void MeshCodec::encode(const Mesh & mesh,
+                       vector<uint8> & output,
+                       const MeshCodecSettings & settings,
+                       ThreadPool * threadPool) {
+    if (settings.positionBits == 0 || settings.positionBits > 16 ||
+            settings.normalBits == 0 || settings.normalBits > 16 ||
+            settings.textureCoordBits == 0 || settings.textureCoordBits > 16) {
+        throw Rigid3DException("Quantization must be between 1 and 16 bits within "
+                "method MeshCodec::encode");
+    }
+
+    const vector<vec3> & meshPositions = *mesh.getVertexPositionVector();
+    if (meshPositions.size() % 3 != 0) {
+        stringstream errorMessage;
+        errorMessage << "Mesh has " << meshPositions.size() << " vertex positions, which"
+                     << " is not a whole number of triangles within method MeshCodec::encode";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const bool normals = !meshPositions.empty() &&
+            mesh.getVertexNormalVector()->size() == meshPositions.size();
+    const bool textureCoords = !meshPositions.empty() &&
+            mesh.getTextureCoordVector()->size() == meshPositions.size();
+
+    vector<Vertex> weldedVertices;
+    vector<uint32> indices;
+    weldVertices(mesh, normals, textureCoords, weldedVertices, indices);
+    optimizeVertexCache(indices.data(), indices.size(), uint32(weldedVertices.size()));
+
+    // Renumber vertices in order of first use, so that each index is close to the
+    // previous one and vertex data is fetched sequentially.
+    vector<uint32> remap(weldedVertices.size(), invalidIndex);
+    vector<Vertex> vertices;
+    vertices.reserve(weldedVertices.size());
+    for (uint32 & index : indices) {
+        if (remap[index] == invalidIndex) {
+            remap[index] = uint32(vertices.size());
+            vertices.push_back(weldedVertices[index]);
+        }
+        index = remap[index];
+    }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, 4);
+    header.version = version;
+    header.numVertices = uint32(vertices.size());
+    header.numIndices = uint32(indices.size());
+    header.flags = (normals ? HasNormals : 0) | (textureCoords ? HasTextureCoords : 0);
+    header.positionBits = uint8(settings.positionBits);
+    header.normalBits = uint8(settings.normalBits);
+    header.textureCoordBits = uint8(settings.textureCoordBits);
+
+    if (!vertices.empty()) {
+        vec3 minimum = vertices[0].position;
+        vec3 maximum = minimum;
+        vec2 textureMinimum = vertices[0].textureCoord;
+        vec2 textureMaximum = textureMinimum;
+        for (const Vertex & vertex : vertices) {
+            minimum = glm::min(minimum, vertex.position);
+            maximum = glm::max(maximum, vertex.position);
+            textureMinimum = glm::min(textureMinimum, vertex.textureCoord);
+            textureMaximum = glm::max(textureMaximum, vertex.textureCoord);
+        }
+        for (int i = 0; i < 3; ++i) {
+            header.positionMin[i] = minimum[i];
+            header.positionExtent[i] = maximum[i] - minimum[i];
+        }
+        for (int i = 0; i < 2; ++i) {
+            header.textureCoordMin[i] = textureMinimum[i];
+            header.textureCoordExtent[i] = textureMaximum[i] - textureMinimum[i];
+        }
+    }
+
+    vector<uint8> payload;
+    uint32 previous = 0;
+    for (uint32 index : indices) {
+        const int32 delta = int32(index - previous);
+        writeVarint((uint32(delta) << 1) ^ uint32(delta >> 31), payload);
+        previous = index;
+    }
+    header.indexBytes = uint32(payload.size());
+
+    vector<uint16> values;
+    values.reserve(vertices.size() * 3);
+    for (const Vertex & vertex : vertices) {
+        for (int i = 0; i < 3; ++i) {
+            values.push_back(quantize(vertex.position[i], header.positionMin[i],
+                    header.positionExtent[i], settings.positionBits));
+        }
+    }
+    encodeAttribute(values, 3, payload);
+
+    if (normals) {
+        values.clear();
+        for (const Vertex & vertex : vertices) {
+            const vec2 octahedral = (glm::length(vertex.normal) > 0.0f) ?
+                    octahedralEncode(glm::normalize(vertex.normal)) : vec2(0.5f);
+            values.push_back(quantize(octahedral.x, 0.0f, 1.0f, settings.normalBits));
+            values.push_back(quantize(octahedral.y, 0.0f, 1.0f, settings.normalBits));
+        }
+        encodeAttribute(values, 2, payload);
+    }
+
+    if (textureCoords) {
+        values.clear();
+        for (const Vertex & vertex : vertices) {
+            for (int i = 0; i < 2; ++i) {
+                values.push_back(quantize(vertex.textureCoord[i], header.textureCoordMin[i],
+                        header.textureCoordExtent[i], settings.textureCoordBits));
+            }
+        }
+        encodeAttribute(values, 2, payload);
+    }
+
+    vector<uint8> stream;
+    BlockCompression::compress(payload.data(), payload.size(), stream,
+            BlockCompression::DefaultBlockSize, threadPool);
+
+    output.resize(sizeof(header) + stream.size());
+    memcpy(output.data(), &header, sizeof(header));
+    memcpy(output.data() + sizeof(header), stream.data(), stream.size());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if 'data' starts with an encoded mesh header.
+ */
+bool MeshCodec::isEncodedMesh(const uint8 * data, size_t size) {
+    return size >= sizeof(Header) && memcmp(data, magic, 4) == 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of distinct vertices, as written by \c decodeIndexed().
+ */
+uint32 MeshCodec::getNumVertices(const uint8 * data, size_t size) {
+    return readHeader(data, size, "getNumVertices").numVertices;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 MeshCodec::getNumIndices(const uint8 * data, size_t size) {
+    return readHeader(data, size, "getNumIndices").numIndices;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of vertices in the triangle soup written by \c decode(), three per
+ * triangle.
+ */
+uint32 MeshCodec::getNumTriangleVertices(const uint8 * data, size_t size) {
+    return readHeader(data, size, "getNumTriangleVertices").numIndices;
+}
+
+//----------------------------------------------------------------------------------------
+bool MeshCodec::hasNormals(const uint8 * data, size_t size) {
+    return (readHeader(data, size, "hasNormals").flags & HasNormals) != 0;
+}
+
+//----------------------------------------------------------------------------------------
+bool MeshCodec::hasTextureCoords(const uint8 * data, size_t size) {
+    return (readHeader(data, size, "hasTextureCoords").flags & HasTextureCoords) != 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Decodes indexed vertices.  Each destination holds \c getNumVertices() elements,
+ * and 'indices' holds \c getNumIndices(), and any of them may be null to skip that
+ * stream.  Normals and texture coordinates are left untouched if the mesh has none.
+ *
+ * @param threadPool - decompresses blocks in parallel if given.
+ *
+ * @throws Rigid3DException if 'data' is malformed.
+ */
+void MeshCodec::decodeIndexed(const uint8 * data,
+                              size_t size,
+                              vec3 * positions,
+                              vec3 * normals,
+                              vec2 * textureCoords,
+                              uint32 * indices,
+                              ThreadPool * threadPool) {
+    const Header header = readHeader(data, size, "decodeIndexed");
+    const uint8 * stream = data + sizeof(header);
+    const size_t streamSize = size - sizeof(header);
+
+    // The header has been checked against the stream's decompressed size.
+    vector<uint8> payload(size_t(getPayloadSize(header)));
+    try {
+        BlockCompression::decompress(stream, streamSize, payload.data(), payload.size(),
+                threadPool);
+    } catch (const Rigid3DException &) {
+        throwMalformed("decodeIndexed");
+    }
+
+    if (indices != nullptr) {
+        const uint8 * in = payload.data();
+        const uint8 * end = in + header.indexBytes;
+        uint32 previous = 0;
+        for (uint32 i = 0; i < header.numIndices; ++i) {
+            uint32 zigzag = 0;
+            for (uint32 shift = 0; ; shift += 7) {
+                if (in == end || shift > 28) {
+                    throwMalformed("decodeIndexed");
+                }
+                const uint8 byte = *in++;
+                zigzag |= uint32(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+
+            previous += (zigzag >> 1) ^ (0u - (zigzag & 1u));
+            if (previous >= header.numVertices) {
+                throwMalformed("decodeIndexed");
+            }
+            indices[i] = previous;
+        }
+    }
+
+    const uint8 * attributes = payload.data() + header.indexBytes;
+
+    if (positions != nullptr) {
+        vec3 minimum;
+        vec3 scale;
+        for (int i = 0; i < 3; ++i) {
+            minimum[i] = header.positionMin[i];
+            scale[i] = header.positionExtent[i] / float((1u << header.positionBits) - 1);
+        }
+        decodeAttribute<3>(attributes, header.numVertices,
+                [&](uint32 vertex, const uint16 * values) {
+                    positions[vertex] = minimum +
+                            vec3(values[0], values[1], values[2]) * scale;
+                });
+    }
+    attributes += size_t(header.numVertices) * 3 * sizeof(uint16);
+
+    if ((header.flags & HasNormals) != 0) {
+        if (normals != nullptr) {
+            const float scale = 1.0f / float((1u << header.normalBits) - 1);
+            decodeAttribute<2>(attributes, header.numVertices,
+                    [&](uint32 vertex, const uint16 * values) {
+                        normals[vertex] = octahedralDecode(
+                                vec2(values[0], values[1]) * scale);
+                    });
+        }
+        attributes += size_t(header.numVertices) * 2 * sizeof(uint16);
+    }
+
+    if ((header.flags & HasTextureCoords) != 0 && textureCoords != nullptr) {
+        vec2 minimum;
+        vec2 scale;
+        for (int i = 0; i < 2; ++i) {
+            minimum[i] = header.textureCoordMin[i];
+            scale[i] = header.textureCoordExtent[i] /
+                    float((1u << header.textureCoordBits) - 1);
+        }
+        decodeAttribute<2>(attributes, header.numVertices,
+                [&](uint32 vertex, const uint16 * values) {
+                    textureCoords[vertex] = minimum + vec2(values[0], values[1]) * scale;
+                });
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Decodes the triangle soup, three vertices per triangle, in place into caller
+ * provided arrays of \c getNumTriangleVertices() elements, such as the consolidated
+ * buffers of a \c MeshConsolidator or a mapped vertex buffer.  Any destination may
+ * be null to skip it.  Normals and texture coordinates are zero if the mesh has
+ * none.
+ *
+ * @param threadPool - decompresses blocks in parallel if given.
+ */
+void MeshCodec::decode(const uint8 * data,
+                       size_t size,
+                       vec3 * positions,
+                       vec3 * normals,
+                       vec2 * textureCoords,
+                       ThreadPool * threadPool) {
+    const Header header = readHeader(data, size, "decode");
+    const bool meshNormals = (header.flags & HasNormals) != 0;
+    const bool meshTextureCoords = (header.flags & HasTextureCoords) != 0;
+
+    vector<vec3> vertexPositions(positions != nullptr ? header.numVertices : 0);
+    vector<vec3> vertexNormals((normals != nullptr && meshNormals) ? header.numVertices : 0);
+    vector<vec2> vertexTextureCoords((textureCoords != nullptr && meshTextureCoords) ?
+            header.numVertices : 0);
+    vector<uint32> indices(header.numIndices);
+
+    decodeIndexed(data, size,
+            vertexPositions.empty() ? nullptr : vertexPositions.data(),
+            vertexNormals.empty() ? nullptr : vertexNormals.data(),
+            vertexTextureCoords.empty() ? nullptr : vertexTextureCoords.data(),
+            indices.data(), threadPool);
+
+    for (uint32 i = 0; i < header.numIndices; ++i) {
+        const uint32 index = indices[i];
+        if (positions != nullptr) {
+            positions[i] = vertexPositions[index];
+        }
+        if (normals != nullptr) {
+            normals[i] = meshNormals ? vertexNormals[index] : vec3(0.0f);
+        }
+        if (textureCoords != nullptr) {
+            textureCoords[i] = meshTextureCoords ? vertexTextureCoords[index] : vec2(0.0f);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Decodes into 'mesh', replacing its contents with the triangle soup.
+ */
+void MeshCodec::decode(const uint8 * data, size_t size, Mesh & mesh, ThreadPool * threadPool) {
+    const Header header = readHeader(data, size, "decode");
+
+    vector<vec3> positions(header.numIndices);
+    vector<vec3> normals(((header.flags & HasNormals) != 0) ? header.numIndices : 0);
+    vector<vec2> textureCoords(((header.flags & HasTextureCoords) != 0) ?
+            header.numIndices : 0);
+
+    decode(data, size, positions.data(),
+            normals.empty() ? nullptr : normals.data(),
+            textureCoords.empty() ? nullptr : textureCoords.data(), threadPool);
+
+    mesh = Mesh(std::move(positions), std::move(normals), std::move(textureCoords));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reorders the triangles of an indexed triangle list so that consecutive triangles
+ * share vertices, using Tom Forsyth's linear speed vertex cache optimization.
+ *
+ * @param numVertices - one more than the largest index.
+ */
+void MeshCodec::optimizeVertexCache(uint32 * indices, size_t numIndices, uint32 numVertices) {
+    const size_t numTriangles = numIndices / 3;
+    if (numTriangles == 0) {
+        return;
+    }
+
+    // Triangles using each vertex, with those not yet emitted at the front of each
+    // vertex's range.
+    vector<uint32> offsets(size_t(numVertices) + 1, 0);
+    for (size_t i = 0; i < numTriangles * 3; ++i) {
+        if (indices[i] >= numVertices) {
+            stringstream errorMessage;
+            errorMessage << "Index " << indices[i] << " is out of range for "
+                         << numVertices << " vertices within method "
+                         << "MeshCodec::optimizeVertexCache";
+            throw Rigid3DException(errorMessage.str());
+        }
+        ++offsets[indices[i] + 1];
+    }
+    for (uint32 v = 0; v < numVertices; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    vector<uint32> adjacency(numTriangles * 3);
+    vector<uint32> numLiveTriangles(numVertices, 0);
+    for (size_t t = 0; t < numTriangles; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            const uint32 v = indices[t * 3 + k];
+            adjacency[offsets[v] + numLiveTriangles[v]++] = uint32(t);
+        }
+    }
+
+    vector<int> cachePosition(numVertices, -1);
+    vector<float> vertexScore(numVertices);
+    for (uint32 v = 0; v < numVertices; ++v) {
+        vertexScore[v] = scoreVertex(-1, numLiveTriangles[v]);
+    }
+
+    vector<float> triangleScore(numTriangles);
+    size_t best = 0;
+    for (size_t t = 0; t < numTriangles; ++t) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                vertexScore[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[best]) {
+            best = t;
+        }
+    }
+
+    vector<bool> emitted(numTriangles, false);
+    vector<uint32> output;
+    output.reserve(numTriangles * 3);
+    vector<uint32> cache;
+    vector<uint32> newCache;
+    size_t cursor = 0;
+
+    for (size_t n = 0; n < numTriangles; ++n) {
+        // With nothing left around the cache, restart from the first triangle not
+        // yet emitted.
+        if (best == numTriangles) {
+            while (emitted[cursor]) {
+                ++cursor;
+            }
+            best = cursor;
+        }
+
+        emitted[best] = true;
+        newCache.clear();
+        for (int k = 0; k < 3; ++k) {
+            const uint32 v = indices[best * 3 + k];
+            output.push_back(v);
+
+            uint32 * begin = &adjacency[offsets[v]];
+            uint32 * end = begin + numLiveTriangles[v];
+            std::swap(*std::find(begin, end, uint32(best)), *(end - 1));
+            --numLiveTriangles[v];
+
+            if (std::find(newCache.begin(), newCache.end(), v) == newCache.end()) {
+                newCache.push_back(v);
+            }
+        }
+        const size_t numEmitted = newCache.size();
+        for (uint32 v : cache) {
+            if (std::find(newCache.begin(), newCache.begin() + numEmitted, v) ==
+                    newCache.begin() + numEmitted) {
+                newCache.push_back(v);
+            }
+        }
+
+        for (size_t i = 0; i < newCache.size(); ++i) {
+            const uint32 v = newCache[i];
+            cachePosition[v] = (i < maxCacheSize) ? int(i) : -1;
+            vertexScore[v] = scoreVertex(cachePosition[v], numLiveTriangles[v]);
+        }
+
+        best = numTriangles;
+        float bestScore = -std::numeric_limits<float>::max();
+        for (uint32 v : newCache) {
+            for (uint32 i = 0; i < numLiveTriangles[v]; ++i) {
+                const uint32 t = adjacency[offsets[v] + i];
+                const float score = vertexScore[indices[t * 3]] +
+                        vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                triangleScore[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+
+        if (newCache.size() > maxCacheSize) {
+            newCache.resize(maxCacheSize);
+        }
+        cache.swap(newCache);
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Simulates a first in first out post-transform vertex cache.
+ *
+ * @return vertices transformed per triangle, between 0.5 for an ideal mesh and 3.
+ */
+float MeshCodec::getAverageCacheMissRatio(const uint32 * indices, size_t numIndices,
+                                          uint32 cacheSize) {
+    const size_t numTriangles = numIndices / 3;
+    if (numTriangles == 0) {
+        return 0.0f;
+    }
+
+    vector<uint32> cache;
+    size_t numMisses = 0;
+    for (size_t i = 0; i < numTriangles * 3; ++i) {
+        if (std::find(cache.begin(), cache.end(), indices[i]) == cache.end()) {
+            ++numMisses;
+            cache.push_back(indices[i]);
+            if (cache.size() > cacheSize) {
+                cache.erase(cache.begin());
+            }
+        }
+    }
+
+    return float(numMisses) / float(numTriangles);
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,121 @@
+/**
+ * @brief MeshCodec
+ */
+
+#ifndef RIGID3D_MESH_CODEC_HPP_
+#define RIGID3D_MESH_CODEC_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class Mesh;
+    class ThreadPool;
+}
+
+namespace Rigid3D {
+
+    /**
+     * Quantization of each vertex attribute, in bits per component.  At most 16
+     * bits are kept per component.
+     */
+    struct MeshCodecSettings {
+        // Uniform grid over the mesh's bounding box.
+        uint32 positionBits;
+
+        // Octahedral mapped unit square.
+        uint32 normalBits;
+
+        // Uniform grid over the range of texture coordinates.
+        uint32 textureCoordBits;
+
+        MeshCodecSettings();
+    };
+
+    /**
+     * @brief Compact encoding of triangle meshes for cooked files.
+     *
+     * Encoding welds the triangle soup of a \c Mesh into indexed vertices, then:
+     * # Reorders triangles for the post-transform vertex cache (Forsyth's linear
+     *   speed optimizer) and renumbers vertices in order of first use.
+     * # Stores each index as the zigzag encoded difference from the previous index,
+     *   as a variable length integer.  After reordering most differences fit in one
+     *   byte.
+     * # Quantizes positions, octahedral normals and texture coordinates to 16-bit
+     *   integers, stores the zigzag difference between consecutive vertices, and
+     *   transposes the values into a plane of low bytes and a plane of high bytes.
+     * # Block compresses the index and attribute streams, which after these
+     *   transforms are mostly small, repetitive bytes.
+     *
+     * Decoding is a few linear passes with no tables, so it keeps up with memory
+     * bandwidth.  It writes either indexed vertices, for a \c StaticGeometryBuffer,
+     * or the triangle soup straight into caller provided arrays, such as the
+     * consolidated buffers of a \c MeshConsolidator.
+     *
+     * \code{.cpp}
+     *  std::vector<uint8> encoded;
+     *  MeshCodec::encode(Mesh("../data/meshes/bunny_smooth.obj"), encoded);
+     *  ...
+     *  uint32 numVertices = MeshCodec::getNumTriangleVertices(encoded.data(), encoded.size());
+     *  std::vector<vec3> positions(numVertices);
+     *  std::vector<vec3> normals(numVertices);
+     *  MeshCodec::decode(encoded.data(), encoded.size(), positions.data(), normals.data());
+     * \endcode
+     */
+    class MeshCodec {
+    public:
+        static void encode(const Mesh & mesh,
+                           std::vector<uint8> & output,
+                           const MeshCodecSettings & settings = MeshCodecSettings(),
+                           ThreadPool * threadPool = nullptr);
+
+        static bool isEncodedMesh(const uint8 * data, size_t size);
+
+        static uint32 getNumVertices(const uint8 * data, size_t size);
+
+        static uint32 getNumIndices(const uint8 * data, size_t size);
+
+        static uint32 getNumTriangleVertices(const uint8 * data, size_t size);
+
+        static bool hasNormals(const uint8 * data, size_t size);
+
+        static bool hasTextureCoords(const uint8 * data, size_t size);
+
+        static void decodeIndexed(const uint8 * data,
+                                  size_t size,
+                                  vec3 * positions,
+                                  vec3 * normals,
+                                  vec2 * textureCoords,
+                                  uint32 * indices,
+                                  ThreadPool * threadPool = nullptr);
+
+        static void decode(const uint8 * data,
+                           size_t size,
+                           vec3 * positions,
+                           vec3 * normals,
+                           vec2 * textureCoords = nullptr,
+                           ThreadPool * threadPool = nullptr);
+
+        static void decode(const uint8 * data,
+                           size_t size,
+                           Mesh & mesh,
+                           ThreadPool * threadPool = nullptr);
+
+        static void optimizeVertexCache(uint32 * indices, size_t numIndices,
+                                        uint32 numVertices);
+
+        static float getAverageCacheMissRatio(const uint32 * indices, size_t numIndices,
+                                              uint32 cacheSize = 16);
+
+        static const uint32 version = 1;
+
+        static const uint32 HasNormals = 1;
+        static const uint32 HasTextureCoords = 2;
+    };
+
+}
+
+#endif /* RIGID3D_MESH_CODEC_HPP_ */
@@ -1,14 +1,57 @@
 #include "MeshConsolidator.hpp"
 
+#include <Rigid3D/Common/ContentHash.hpp>
 #include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/MeshCodec.hpp>
 
 #include <cstring>
 #include <cstdlib>
+#include <string>
 
 namespace Rigid3D {
     
 using namespace std;
 
+namespace {
+
+    //------------------------------------------------------------------------------------
+    AABB computeBounds(const vec3 * positions, size_t numPositions) {
+        AABB bounds;
+        if (numPositions > 0) {
+            bounds.minBounds = bounds.maxBounds = positions[0];
+            for (size_t i = 0; i < numPositions; ++i) {
+                bounds.minBounds = glm::min(bounds.minBounds, positions[i]);
+                bounds.maxBounds = glm::max(bounds.maxBounds, positions[i]);
+            }
+        }
+        return bounds;
+    }
+
+    //------------------------------------------------------------------------------------
+    uint64 hashMesh(const Mesh & mesh) {
+        uint64 hash = ContentHash::hash(mesh.getVertexPositionDataPtr(),
+                mesh.getNumVertexPositionBytes());
+        return ContentHash::hash(mesh.getVertexNormalDataPtr(),
+                mesh.getNumVertexNormalBytes(), hash);
+    }
+
+    //------------------------------------------------------------------------------------
+    // True if 'a' and 'b' consolidate to the same data.
+    bool sameContents(const Mesh & a, const Mesh & b) {
+        if (&a == &b) {
+            return true;
+        }
+
+        return a.getNumVertexPositionBytes() == b.getNumVertexPositionBytes() &&
+               a.getNumVertexNormalBytes() == b.getNumVertexNormalBytes() &&
+               memcmp(a.getVertexPositionDataPtr(), b.getVertexPositionDataPtr(),
+                       a.getNumVertexPositionBytes()) == 0 &&
+               memcmp(a.getVertexNormalDataPtr(), b.getVertexNormalDataPtr(),
+                       a.getNumVertexNormalBytes()) == 0;
+    }
+
+} // end anonymous namespace
+
 //----------------------------------------------------------------------------------------
 /**
  * Default constructor
@@ -19,7 +62,8 @@ MeshConsolidator::MeshConsolidator()
           vertexPositionDataPtr_head(nullptr),
           vertexPositionDataPtr_tail(nullptr),
           normalDataPtr_head(nullptr),
-          normalDataPtr_tail(nullptr) { }
+          normalDataPtr_tail(nullptr),
+          numUniqueMeshes(0) { }
 
 
 //----------------------------------------------------------------------------------------
@@ -30,7 +74,7 @@ MeshConsolidator::MeshConsolidator()
  * @param list
  */
 MeshConsolidator::MeshConsolidator(initializer_list<pair<const char *, const Mesh *> > list)
-        : totalPositionBytes(0), totalNormalBytes(0) {
+        : totalPositionBytes(0), totalNormalBytes(0), numUniqueMeshes(0) {
 
     unordered_map<const char *, const Mesh *> meshMap;
     for(auto key_value : list) {
@@ -44,62 +88,153 @@ MeshConsolidator::MeshConsolidator(initializer_list<pair<const char *, const Mes
 /**
  * Constructs a \c MeshConsolidator object from an \c unordered_map with keys equal to
  * c-string identifiers, and mapped values equal to Wavefront .obj file names.
+ * A file named under several identifiers is loaded only once.
  *
  * @param list
  */
 MeshConsolidator::MeshConsolidator(initializer_list<pair<const char *, const char *> > list)
-        : totalPositionBytes(0), totalNormalBytes(0) {
+        : totalPositionBytes(0), totalNormalBytes(0), numUniqueMeshes(0) {
 
     // Need to keep Mesh objects in memory for processing until the end of this block.
     // Use vector<shared_ptr<Mesh>> as memory requirements could be large for some Meshes.
     // Meshes will auto-destruct at the end of this method when vector goes out of scope.
-    vector<shared_ptr<Mesh> > meshVector;
-    meshVector.resize(list.size());
+    unordered_map<string, shared_ptr<Mesh> > meshesByFileName;
 
     unordered_map<const char *, const Mesh *> meshMap;
-    int i = 0;
     for(auto key_value : list) {
         const char * meshId = key_value.first;
         const char * meshFileName = key_value.second;
-        meshVector[i] = make_shared<Mesh>(meshFileName);
-        meshMap[meshId] = meshVector[i].get();
-        i++;
+        shared_ptr<Mesh> & mesh = meshesByFileName[meshFileName];
+        if (!mesh) {
+            mesh = make_shared<Mesh>(meshFileName);
+        }
+        meshMap[meshId] = mesh.get();
     }
 
     processMeshes(meshMap);
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Constructs a \c MeshConsolidator object from c-string identifiers paired with
+ * meshes encoded by \c MeshCodec::encode, which are decoded straight into the
+ * consolidated memory blocks.  Identical encodings are decoded once.
+ *
+ * @param list
+ */
+MeshConsolidator::MeshConsolidator(
+        initializer_list<pair<const char *, const vector<uint8> *> > list)
+        : totalPositionBytes(0), totalNormalBytes(0), numUniqueMeshes(0) {
+
+    unordered_map<uint64, vector<pair<MeshID, const vector<uint8> *> > > meshesByHash;
+    vector<pair<MeshID, const vector<uint8> *> > uniqueMeshes;
+    vector<pair<MeshID, MeshID> > duplicates;
+
+    for(auto key_value : list) {
+        const vector<uint8> & encodedMesh = *(key_value.second);
+        auto & candidates = meshesByHash[ContentHash::hash(encodedMesh.data(),
+                encodedMesh.size())];
+
+        bool duplicate = false;
+        for (const auto & candidate : candidates) {
+            if (*(candidate.second) == encodedMesh) {
+                duplicates.push_back(make_pair(key_value.first, candidate.first));
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) {
+            continue;
+        }
+        candidates.push_back(key_value);
+        uniqueMeshes.push_back(key_value);
+
+        const unsigned long numVertices = MeshCodec::getNumTriangleVertices(
+                encodedMesh.data(), encodedMesh.size());
+        totalPositionBytes += numVertices * sizeof(vec3);
+        totalNormalBytes += numVertices * sizeof(vec3);
+    }
+
+    allocateMemory();
+
+    for(auto key_value : uniqueMeshes) {
+        consolidateEncodedMesh(key_value.first, *(key_value.second));
+    }
+    shareDuplicates(duplicates);
+}
+
 //----------------------------------------------------------------------------------------
 void MeshConsolidator::processMeshes(const unordered_map<const char *, const Mesh *> & meshMap) {
 
-    // Calculate the total number of bytes for both vertex and normal data.
+    // Meshes with identical contents are consolidated once, whatever their ids, and
+    // share a BatchInfo.
+    unordered_map<uint64, vector<pair<MeshID, const Mesh *> > > meshesByHash;
+    vector<pair<MeshID, const Mesh *> > uniqueMeshes;
+    vector<pair<MeshID, MeshID> > duplicates;
+
     for(auto key_value: meshMap) {
         const Mesh & mesh = *(key_value.second);
+        auto & candidates = meshesByHash[hashMesh(mesh)];
+
+        bool duplicate = false;
+        for (const auto & candidate : candidates) {
+            if (sameContents(*(candidate.second), mesh)) {
+                duplicates.push_back(make_pair(key_value.first, candidate.first));
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) {
+            continue;
+        }
+        candidates.push_back(key_value);
+        uniqueMeshes.push_back(key_value);
+
+        // Calculate the total number of bytes for both vertex and normal data.
         totalPositionBytes += mesh.getNumVertexPositionBytes();
         totalNormalBytes += mesh.getNumVertexNormalBytes();
     }
 
+    allocateMemory();
+
+    for(auto key_value : uniqueMeshes) {
+        const char * meshId = key_value.first;
+        const Mesh & mesh = *(key_value.second);
+        consolidateMesh(meshId, mesh);
+    }
+    shareDuplicates(duplicates);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Points each duplicate id, the first of each pair, at the data already
+ * consolidated for the second.
+ */
+void MeshConsolidator::shareDuplicates(const vector<pair<MeshID, MeshID> > & duplicates) {
+    numUniqueMeshes = (unsigned int)batchInfoMap.size();
+    for (const auto & duplicate : duplicates) {
+        batchInfoMap[duplicate.first] = batchInfoMap[duplicate.second];
+        boundingBoxMap[duplicate.first] = boundingBoxMap[duplicate.second];
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void MeshConsolidator::allocateMemory() {
     // Allocate memory for vertex position data.
     vertexPositionDataPtr_head = shared_ptr<float>((float *)malloc(totalPositionBytes), free);
     if (vertexPositionDataPtr_head.get() == (float *)0) {
-        throw Rigid3DException("Unable to allocate system memory within method MeshConsolidator::processMeshes");
+        throw Rigid3DException("Unable to allocate system memory within method MeshConsolidator::allocateMemory");
     }
 
     // Allocate memory for normal data.
     normalDataPtr_head = shared_ptr<float>((float *)malloc(totalNormalBytes), free);
-    if (vertexPositionDataPtr_head.get() == (float *)0) {
-        throw Rigid3DException("Unable to allocate system memory within method MeshConsolidator::processMeshes");
+    if (normalDataPtr_head.get() == (float *)0) {
+        throw Rigid3DException("Unable to allocate system memory within method MeshConsolidator::allocateMemory");
     }
 
     // Assign pointers to beginning of memory blocks.
     vertexPositionDataPtr_tail = vertexPositionDataPtr_head.get();
     normalDataPtr_tail = normalDataPtr_head.get();
-
-    for(auto key_value : meshMap) {
-        const char * meshId = key_value.first;
-        const Mesh & mesh = *(key_value.second);
-        consolidateMesh(meshId, mesh);
-    }
 }
 
 //----------------------------------------------------------------------------------------
@@ -119,6 +254,27 @@ void MeshConsolidator::consolidateMesh(const char * meshId, const Mesh & mesh) {
     normalDataPtr_tail += mesh.getNumVertexNormalBytes() / sizeof(float);
 
     batchInfoMap[meshId] = BatchInfo(startIndex, numIndices);
+
+    const vector<vec3> & positions = *(mesh.getVertexPositionVector());
+    boundingBoxMap[meshId] = computeBounds(positions.data(), positions.size());
+}
+
+//----------------------------------------------------------------------------------------
+void MeshConsolidator::consolidateEncodedMesh(const char * meshId,
+                                              const vector<uint8> & encodedMesh) {
+    unsigned int startIndex = (unsigned int)((vertexPositionDataPtr_tail - vertexPositionDataPtr_head.get()) / num_floats_per_vertex);
+    unsigned int numIndices = MeshCodec::getNumTriangleVertices(encodedMesh.data(),
+            encodedMesh.size());
+
+    // Decode in place, straight after the previously consolidated mesh.
+    vec3 * positions = reinterpret_cast<vec3 *>(vertexPositionDataPtr_tail);
+    MeshCodec::decode(encodedMesh.data(), encodedMesh.size(), positions,
+            reinterpret_cast<vec3 *>(normalDataPtr_tail));
+    vertexPositionDataPtr_tail += numIndices * num_floats_per_vertex;
+    normalDataPtr_tail += numIndices * num_floats_per_vertex;
+
+    batchInfoMap[meshId] = BatchInfo(startIndex, numIndices);
+    boundingBoxMap[meshId] = computeBounds(positions, numIndices);
 }
 
 //----------------------------------------------------------------------------------------
@@ -139,6 +295,19 @@ void MeshConsolidator::getBatchInfo(unordered_map<const char *, BatchInfo> & bat
     }
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Appends to \c boundingBoxMap the model space \c AABB of each consolidated \c Mesh,
+ * keyed by the same c-string identifiers used for \c getBatchInfo.
+ *
+ * @param boundingBoxMap
+ */
+void MeshConsolidator::getBoundingBoxes(unordered_map<const char *, AABB> & boundingBoxMap) const {
+    for(const auto & key_value : this->boundingBoxMap) {
+        boundingBoxMap[key_value.first] = key_value.second;
+    }
+}
+
 //----------------------------------------------------------------------------------------
 /**
  * @return the starting memory location for all consolidated \c Mesh vertex data.
@@ -171,4 +340,13 @@ unsigned long MeshConsolidator::getNumVertexNormalBytes() const {
     return totalNormalBytes;
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * @return the number of distinct meshes stored.  Ids whose meshes have identical
+ * contents share one copy, so this may be less than the number of ids.
+ */
+unsigned int MeshConsolidator::getNumUniqueMeshes() const {
+    return numUniqueMeshes;
+}
+
 } // end namespace Rigid3D
@@ -2,11 +2,13 @@
 #define RIGID3D_MESH_CONSOLIDATOR_HPP_
 
 #include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
 
 #include <initializer_list>
 #include <utility>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace Rigid3D {
     
@@ -24,19 +26,36 @@ namespace Rigid3D {
      *  glDrawArrays(GL_TRIANGLES, batchInfo.startIndex, batchInfo.numIndices);
      * \endcode
      *
+     * Indexed batches, such as those allocated from a \c StaticGeometryBuffer,
+     * instead refer to a range of 32 bit indices, which are offset by 'baseVertex'
+     * before they fetch vertices:
+     * \code{.cpp}
+     *  glDrawElementsBaseVertex(GL_TRIANGLES, batchInfo.numIndices, GL_UNSIGNED_INT,
+     *          (void *)(batchInfo.startIndex * sizeof(GLuint)), batchInfo.baseVertex);
+     * \endcode
+     * \c Renderable draws either kind, and \c rayCastTriangles() walks either given
+     * the index data.  \c GpuCuller takes non-indexed batches only.
      */
     struct BatchInfo {
         unsigned int startIndex;
         unsigned int numIndices;
+        int baseVertex;   // Added to each index of an indexed batch.
+        bool indexed;
 
         BatchInfo()
-                : startIndex(0), numIndices(0) { }
+                : startIndex(0), numIndices(0), baseVertex(0), indexed(false) { }
 
         BatchInfo(unsigned int startIndex, unsigned int numIndices)
-                : startIndex(startIndex), numIndices(numIndices) { }
+                : startIndex(startIndex), numIndices(numIndices), baseVertex(0),
+                  indexed(false) { }
+
+        BatchInfo(unsigned int startIndex, unsigned int numIndices, int baseVertex)
+                : startIndex(startIndex), numIndices(numIndices), baseVertex(baseVertex),
+                  indexed(true) { }
 
         BatchInfo(const BatchInfo & other)
-                : startIndex(other.startIndex), numIndices(other.numIndices) { }
+                : startIndex(other.startIndex), numIndices(other.numIndices),
+                  baseVertex(other.baseVertex), indexed(other.indexed) { }
     };
 
     /**
@@ -73,8 +92,18 @@ namespace Rigid3D {
      *  }
      * \endcode
      *
+     * Meshes with identical contents are stored once, even under different ids, and
+     * all of their ids map to the same \c BatchInfo.
+     *
+     * Meshes encoded with \c MeshCodec are decoded in place into the consolidated
+     * blocks, without an intermediate \c Mesh:
+     * \code{.cpp}
+     *  MeshConsolidator meshConsolidator = {{"bunny", &encodedBunny}, {"torus", &encodedTorus}};
+     * \endcode
+     *
      * @see BatchInfo
      * @see Mesh
+     * @see MeshCodec
      */
     class MeshConsolidator {
     public:
@@ -84,6 +113,8 @@ namespace Rigid3D {
 
         MeshConsolidator(std::initializer_list<std::pair<MeshID, ObjFile> > list);
 
+        MeshConsolidator(std::initializer_list<std::pair<MeshID, const std::vector<uint8> *> > list);
+
         ~MeshConsolidator();
 
         const float * getVertexPositionDataPtr() const;
@@ -94,13 +125,23 @@ namespace Rigid3D {
 
         unsigned long getNumVertexNormalBytes() const;
 
+        unsigned int getNumUniqueMeshes() const;
+
         void getBatchInfo(std::unordered_map<const char *, BatchInfo> & batchInfoMap) const;
 
+        void getBoundingBoxes(std::unordered_map<const char *, AABB> & boundingBoxMap) const;
+
     private:
         void processMeshes(const std::unordered_map<MeshID, const Mesh *> & meshMap);
 
+        void allocateMemory();
+
         void consolidateMesh(MeshID meshId, const Mesh & mesh);
 
+        void consolidateEncodedMesh(MeshID meshId, const std::vector<uint8> & encodedMesh);
+
+        void shareDuplicates(const std::vector<std::pair<MeshID, MeshID> > & duplicates);
+
         unsigned long totalPositionBytes;
         unsigned long totalNormalBytes;
 
@@ -111,6 +152,9 @@ namespace Rigid3D {
         float * normalDataPtr_tail;
 
         std::unordered_map<MeshID, BatchInfo> batchInfoMap;
+        std::unordered_map<MeshID, AABB> boundingBoxMap;
+
+        unsigned int numUniqueMeshes;
 
         static const short num_floats_per_vertex = 3;
     };
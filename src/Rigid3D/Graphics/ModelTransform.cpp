@@ -6,8 +6,7 @@ namespace Rigid3D {
 
 //----------------------------------------------------------------------------------------
 ModelTransform::ModelTransform()
-    : recalcModelMatrix(false),
-      position(0.0f, 0.0f, 0.0f),
+    : position(0.0f, 0.0f, 0.0f),
       pose(),
       scaleFactor(1.0f, 1.0f, 1.0f),
       modelMatrix() {
@@ -26,7 +25,7 @@ ModelTransform::~ModelTransform() {
  */
 void ModelTransform::setPosition(const vec3& position) {
     this->position = position;
-    recalcModelMatrix = true;
+    updateModelMatrix();
 }
 
 //----------------------------------------------------------------------------------------
@@ -36,7 +35,7 @@ void ModelTransform::setPosition(const vec3& position) {
  */
 void ModelTransform::setPose(const quat& pose) {
     this->pose = pose;
-    recalcModelMatrix = true;
+    updateModelMatrix();
 }
 
 //----------------------------------------------------------------------------------------
@@ -46,30 +45,35 @@ void ModelTransform::setPose(const quat& pose) {
  */
 void ModelTransform::setScale(const vec3 & scale) {
     this->scaleFactor = scale;
-    recalcModelMatrix = true;
+    updateModelMatrix();
 }
 
 //----------------------------------------------------------------------------------------
-vec3 ModelTransform::getPosition() {
+vec3 ModelTransform::getPosition() const {
     return position;
 }
 
 //----------------------------------------------------------------------------------------
-quat ModelTransform::getPose() {
+quat ModelTransform::getPose() const {
     return pose;
 }
 
 //----------------------------------------------------------------------------------------
-vec3 ModelTransform::getScale() {
+vec3 ModelTransform::getScale() const {
     return scaleFactor;
 }
 
 //----------------------------------------------------------------------------------------
-mat4 ModelTransform::getModelMatrix() {
-    if (!recalcModelMatrix) {
-        return modelMatrix;
-    }
+/**
+ * @note Only reads, so that the matrix may be fetched concurrently from several
+ * threads; the setters recompute it.
+ */
+mat4 ModelTransform::getModelMatrix() const {
+    return modelMatrix;
+}
 
+//----------------------------------------------------------------------------------------
+void ModelTransform::updateModelMatrix() {
     // 1. Scale
     // 2. Rotate
     // 3. Translate
@@ -87,9 +91,6 @@ mat4 ModelTransform::getModelMatrix() {
     modelMatrix[3][0] = position.x;
     modelMatrix[3][1] = position.y;
     modelMatrix[3][2] = position.z;
-
-    recalcModelMatrix = false;
-    return modelMatrix;
 }
 
 
@@ -20,13 +20,14 @@ namespace Rigid3D {
         void setPose(const quat & pose);
         void setScale(const vec3 & scale);
 
-        vec3 getPosition();
-        quat getPose();
-        vec3 getScale();
-        mat4 getModelMatrix();
+        vec3 getPosition() const;
+        quat getPose() const;
+        vec3 getScale() const;
+        mat4 getModelMatrix() const;
 
     private:
-        bool recalcModelMatrix;
+        void updateModelMatrix();
+
         vec3 position;
         quat pose;
         vec3 scaleFactor;
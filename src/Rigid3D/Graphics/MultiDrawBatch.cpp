@@ -0,0 +1,247 @@
+#include "MultiDrawBatch.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace Rigid3D {
+
+const GLuint MultiDrawBatch::DrawBinding;
+
+//----------------------------------------------------------------------------------------
+/**
+ * @note Requires a current OpenGL 4.3 context.
+ */
+MultiDrawBatch::MultiDrawBatch()
+    : indexed(false),
+      drawBuffer(0),
+      commandBuffer(0),
+      drawIdBuffer(0),
+      bufferCapacity(0),
+      commandsDirty(true),
+      drawsDirty(true) {
+
+    glGenBuffers(1, &drawBuffer);
+    glGenBuffers(1, &commandBuffer);
+    glGenBuffers(1, &drawIdBuffer);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+MultiDrawBatch::~MultiDrawBatch() {
+    glDeleteBuffers(1, &drawBuffer);
+    glDeleteBuffers(1, &commandBuffer);
+    glDeleteBuffers(1, &drawIdBuffer);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Adds one draw of 'batchInfo', placed by 'modelMatrix' and shaded with
+ * 'material', an index into the \c MaterialLibrary bound when drawing.
+ *
+ * @return index of the draw, for use with \c setModelMatrix() and \c setMaterial().
+ */
+uint32 MultiDrawBatch::addDraw(const BatchInfo & batchInfo, const mat4 & modelMatrix,
+                               uint32 material) {
+    if (draws.empty()) {
+        indexed = batchInfo.indexed;
+    } else if (batchInfo.indexed != indexed) {
+        std::stringstream errorMessage;
+        errorMessage << "Indexed and non-indexed batches cannot be mixed within method "
+                     << "MultiDrawBatch::addDraw";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const uint32 drawIndex = uint32(draws.size());
+
+    Draw draw;
+    draw.modelMatrix = modelMatrix;
+    draw.material = material;
+    std::fill(draw.padding, draw.padding + 3, 0);
+    draws.push_back(draw);
+
+    Command command;
+    command.count = batchInfo.numIndices;
+    command.instanceCount = 1;
+    command.first = batchInfo.startIndex;
+    if (indexed) {
+        command.baseVertex = batchInfo.baseVertex;
+        command.baseInstance = drawIndex;
+    } else {
+        // DrawArraysIndirectCommand reads baseInstance from this field.
+        command.baseVertex = int32(drawIndex);
+        command.baseInstance = 0;
+    }
+    commands.push_back(command);
+
+    commandsDirty = true;
+    drawsDirty = true;
+
+    return drawIndex;
+}
+
+//----------------------------------------------------------------------------------------
+void MultiDrawBatch::setModelMatrix(uint32 draw, const mat4 & modelMatrix) {
+    checkDrawIndex(draw, "setModelMatrix");
+    draws[draw].modelMatrix = modelMatrix;
+    drawsDirty = true;
+}
+
+//----------------------------------------------------------------------------------------
+void MultiDrawBatch::setMaterial(uint32 draw, uint32 material) {
+    checkDrawIndex(draw, "setMaterial");
+    draws[draw].material = material;
+    drawsDirty = true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Removes every draw, keeping buffer storage for reuse.
+ */
+void MultiDrawBatch::clear() {
+    draws.clear();
+    commands.clear();
+    indexed = false;
+    commandsDirty = true;
+    drawsDirty = true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sources the integer vertex attribute at 'attributeLocation' of the currently
+ * bound VAO from a buffer of draw indices, advancing once per instance so that
+ * each command's baseInstance selects its own draw index.
+ *
+ * The buffer object is kept as draws are added, so this need only be called once
+ * per VAO.
+ */
+void MultiDrawBatch::bindDrawIdAttribute(GLuint attributeLocation) {
+    upload();
+
+    glBindBuffer(GL_ARRAY_BUFFER, drawIdBuffer);
+    glEnableVertexAttribArray(attributeLocation);
+    glVertexAttribIPointer(attributeLocation, 1, GL_UNSIGNED_INT, 0,
+            reinterpret_cast<void *>(0));
+    glVertexAttribDivisor(attributeLocation, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Uploads changed draws and issues every draw with one multi-draw indirect call.
+ * The caller is responsible for binding the VAO set up with
+ * \c bindDrawIdAttribute(), binding a \c MaterialLibrary and enabling the
+ * ShaderProgram.
+ *
+ * @param mode - primitive type, such as GL_TRIANGLES.
+ */
+void MultiDrawBatch::draw(GLenum mode) {
+    if (draws.empty()) {
+        return;
+    }
+    upload();
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DrawBinding, drawBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+
+    if (indexed) {
+        glMultiDrawElementsIndirect(mode, GL_UNSIGNED_INT, reinterpret_cast<void *>(0),
+                GLsizei(commands.size()), sizeof(Command));
+    } else {
+        glMultiDrawArraysIndirect(mode, reinterpret_cast<void *>(0),
+                GLsizei(commands.size()), sizeof(Command));
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 MultiDrawBatch::getNumDraws() const {
+    return uint32(draws.size());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return true if the batch holds indexed draws.  Meaningless while empty.
+ */
+bool MultiDrawBatch::isIndexed() const {
+    return indexed;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint MultiDrawBatch::getDrawBuffer() const {
+    return drawBuffer;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint MultiDrawBatch::getCommandBuffer() const {
+    return commandBuffer;
+}
+
+//----------------------------------------------------------------------------------------
+void MultiDrawBatch::checkDrawIndex(uint32 draw, const char * methodName) const {
+    if (draw >= draws.size()) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid draw index " << draw << " within method "
+                     << "MultiDrawBatch::" << methodName;
+        throw Rigid3DException(errorMessage.str());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void MultiDrawBatch::upload() {
+    if (draws.size() > bufferCapacity || bufferCapacity == 0) {
+        // Buffers are never allocated empty so that they can always be bound.
+        bufferCapacity = std::max(std::max(draws.size(), bufferCapacity * 2), size_t(1));
+
+        std::vector<uint32> drawIds(bufferCapacity);
+        for (size_t i = 0; i < drawIds.size(); ++i) {
+            drawIds[i] = uint32(i);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, drawIdBuffer);
+        glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(drawIds.size() * sizeof(uint32)),
+                drawIds.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, GLsizeiptr(bufferCapacity * sizeof(Draw)),
+                NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, GLsizeiptr(bufferCapacity * sizeof(Command)),
+                NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        commandsDirty = true;
+        drawsDirty = true;
+    }
+
+    if (drawsDirty && !draws.empty()) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0,
+                GLsizeiptr(draws.size() * sizeof(Draw)), draws.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+    drawsDirty = false;
+
+    if (commandsDirty && !commands.empty()) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0,
+                GLsizeiptr(commands.size() * sizeof(Command)), commands.data());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+    commandsDirty = false;
+
+    CHECK_GL_ERRORS;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,125 @@
+/**
+ * @brief MultiDrawBatch
+ */
+
+#ifndef RIGID3D_MULTI_DRAW_BATCH_HPP_
+#define RIGID3D_MULTI_DRAW_BATCH_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    struct BatchInfo;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Draws many batches, each with its own model matrix and material, using
+     * a single multi-draw indirect call.
+     *
+     * Every draw has an entry in a shader storage buffer at binding \c DrawBinding
+     * holding its model matrix and material index, see MaterialBatched.vert.  The
+     * vertex shader finds its entry through an integer vertex attribute, set up
+     * within the bound VAO by \c bindDrawIdAttribute(), that holds the draw index.
+     * Each indirect command's baseInstance selects that index, since OpenGL 4.3
+     * lacks gl_DrawID.  Combined with a \c MaterialLibrary this removes every
+     * texture and uniform change between draws.
+     *
+     * Batches are either all indexed, such as those of a \c StaticGeometryBuffer,
+     * or all non-indexed, such as those of a \c MeshConsolidator.
+     *
+     * \code{.cpp}
+     *  MultiDrawBatch batch;
+     *  for (const Object & object : objects) {
+     *      batch.addDraw(object.batchInfo, object.modelMatrix, object.material);
+     *  }
+     *
+     *  glBindVertexArray(vao);
+     *  batch.bindDrawIdAttribute(3);
+     *
+     *  // Each frame.
+     *  materials.bind();
+     *  shader.enable();
+     *  batch.draw(GL_TRIANGLES);
+     *  shader.disable();
+     * \endcode
+     *
+     * Requires an OpenGL 4.3 context.
+     *
+     * @see MaterialLibrary
+     */
+    class MultiDrawBatch {
+    public:
+        static const GLuint DrawBinding = 2;
+
+        MultiDrawBatch();
+
+        ~MultiDrawBatch();
+
+        uint32 addDraw(const BatchInfo & batchInfo, const mat4 & modelMatrix,
+                       uint32 material);
+
+        void setModelMatrix(uint32 draw, const mat4 & modelMatrix);
+
+        void setMaterial(uint32 draw, uint32 material);
+
+        void clear();
+
+        void bindDrawIdAttribute(GLuint attributeLocation);
+
+        void draw(GLenum mode);
+
+        uint32 getNumDraws() const;
+
+        bool isIndexed() const;
+
+        GLuint getDrawBuffer() const;
+
+        GLuint getCommandBuffer() const;
+
+    private:
+        // Non-copyable, owns GL buffer objects.
+        MultiDrawBatch(const MultiDrawBatch &);
+        MultiDrawBatch & operator = (const MultiDrawBatch &);
+
+        // std430 layout matching MaterialBatched.vert.
+        struct Draw {
+            mat4 modelMatrix;
+            uint32 material;
+            uint32 padding[3];
+        };
+
+        // Layout shared by DrawArraysIndirectCommand and DrawElementsIndirectCommand,
+        // the former ignoring baseVertex and reading baseInstance in its place.
+        struct Command {
+            uint32 count;
+            uint32 instanceCount;
+            uint32 first;
+            int32 baseVertex;
+            uint32 baseInstance;
+        };
+
+        void checkDrawIndex(uint32 draw, const char * methodName) const;
+
+        void upload();
+
+        std::vector<Draw> draws;
+        std::vector<Command> commands;
+        bool indexed;
+
+        GLuint drawBuffer;
+        GLuint commandBuffer;
+        GLuint drawIdBuffer;
+        size_t bufferCapacity;   // In draws, shared by all three buffers.
+        bool commandsDirty;
+        bool drawsDirty;
+    };
+
+}
+
+#endif /* RIGID3D_MULTI_DRAW_BATCH_HPP_ */
@@ -0,0 +1,225 @@
+#include "MultiViewRenderer.hpp"
+
+#include <Rigid3D/Common/ThreadPool.hpp>
+#include <Rigid3D/Collision/FrustumPlanes.hpp>
+#include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace Rigid3D {
+
+using std::vector;
+
+namespace {
+
+    const size_t boundsGrainSize = 256;
+
+    //------------------------------------------------------------------------------------
+    bool overlaps(const AABB & a, const AABB & b) {
+        return a.minBounds.x <= b.maxBounds.x && a.maxBounds.x >= b.minBounds.x &&
+               a.minBounds.y <= b.maxBounds.y && a.maxBounds.y >= b.minBounds.y &&
+               a.minBounds.z <= b.maxBounds.z && a.maxBounds.z >= b.minBounds.z;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Grows 'box' to contain the world space corners of the view volume of 'viewProjection'.
+    void expandByFrustumCorners(const mat4 & viewProjection, AABB & box, bool & empty) {
+        mat4 inverseViewProjection = glm::inverse(viewProjection);
+
+        for (int i = 0; i < 8; ++i) {
+            vec4 ndc((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+            vec4 corner = inverseViewProjection * ndc;
+            vec3 p = vec3(corner) / corner.w;
+
+            if (empty) {
+                box.minBounds = box.maxBounds = p;
+                empty = false;
+            } else {
+                box.minBounds = glm::min(box.minBounds, p);
+                box.maxBounds = glm::max(box.maxBounds, p);
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Runs body over [0, count) on 'threadPool' if there is one, otherwise inline.
+    void forRange(ThreadPool * threadPool, size_t count, size_t grainSize,
+            const std::function<void (size_t, size_t)> & body) {
+        if (threadPool) {
+            threadPool->parallelFor(count, grainSize, body);
+        } else if (count > 0) {
+            body(0, count);
+        }
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param threadPool - optional pool used to compute bounds and build command lists
+ * in parallel.  Must outlive this object.
+ */
+MultiViewRenderer::MultiViewRenderer(ThreadPool * threadPool)
+    : threadPool(threadPool) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Builds command lists for 'views' and submits them.
+ */
+void MultiViewRenderer::render(const vector<RenderView> & views,
+                               const vector<Renderable *> & renderables) {
+    buildCommandLists(views, renderables);
+    submitCommandLists(views);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Culls and sorts 'renderables' for every view.  Makes no GL calls, so may be
+ * called from any thread.
+ */
+void MultiViewRenderer::buildCommandLists(const vector<RenderView> & views,
+                                          const vector<Renderable *> & renderables) {
+    const size_t numRenderables = renderables.size();
+
+    //-- Shared view independent data.
+    vector<FrustumPlanes> viewPlanes(views.size());
+    AABB unionBounds;
+    bool unionEmpty = true;
+    for (size_t v = 0; v < views.size(); ++v) {
+        const Camera & camera = *(views[v].camera);
+        mat4 viewProjection = camera.getProjectionMatrix() * camera.getViewMatrix();
+        viewPlanes[v].set(viewProjection);
+        expandByFrustumCorners(viewProjection, unionBounds, unionEmpty);
+    }
+
+    worldBounds.resize(numRenderables);
+    isCandidate.assign(numRenderables, 0);
+
+    if (!unionEmpty) {
+        forRange(threadPool, numRenderables, boundsGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Renderable & renderable = *renderables[i];
+                if (!renderable.hasBoundingBox()) {
+                    isCandidate[i] = 1;
+                    continue;
+                }
+                worldBounds[i] = renderable.getWorldBoundingBox();
+                isCandidate[i] = overlaps(worldBounds[i], unionBounds) ? 1 : 0;
+            }
+        });
+    }
+
+    candidates.clear();
+    for (size_t i = 0; i < numRenderables; ++i) {
+        if (isCandidate[i]) {
+            candidates.push_back(i);
+        }
+    }
+
+    // Sort once by state for all views.  Index breaks ties to keep the order stable.
+    std::sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) {
+        const Renderable & ra = *renderables[a];
+        const Renderable & rb = *renderables[b];
+        std::less<const void *> less;
+        if (ra.getShaderProgram() != rb.getShaderProgram()) {
+            return less(ra.getShaderProgram(), rb.getShaderProgram());
+        }
+        if (ra.getBatchInfo() != rb.getBatchInfo()) {
+            return less(ra.getBatchInfo(), rb.getBatchInfo());
+        }
+        return a < b;
+    });
+
+    //-- Per view culling.
+    commandLists.resize(views.size());
+    forRange(threadPool, views.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            vector<Renderable *> & commandList = commandLists[v];
+            commandList.clear();
+
+            for (size_t i : candidates) {
+                if (!renderables[i]->hasBoundingBox() || viewPlanes[v].intersects(worldBounds[i])) {
+                    commandList.push_back(renderables[i]);
+                }
+            }
+        }
+    });
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Renders the command lists built by the last call to \c buildCommandLists().
+ * Must be called on the thread owning the OpenGL context.
+ */
+void MultiViewRenderer::submitCommandLists(const vector<RenderView> & views) const {
+    GLint prevFramebuffer;
+    GLint prevViewport[4];
+    GLint prevScissorBox[4];
+    GLfloat prevClearColor[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+    glGetIntegerv(GL_SCISSOR_BOX, prevScissorBox);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, prevClearColor);
+    GLboolean scissorEnabled = glIsEnabled(GL_SCISSOR_TEST);
+
+    for (size_t v = 0; v < views.size() && v < commandLists.size(); ++v) {
+        const RenderView & view = views[v];
+        const Viewport & viewport = view.viewport;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, view.framebuffer);
+        glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+
+        if (view.clear) {
+            // Restrict the clear to this view's viewport.
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(viewport.x, viewport.y, viewport.width, viewport.height);
+            glClearColor(view.clearColor.x, view.clearColor.y, view.clearColor.z,
+                    view.clearColor.w);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            if (!scissorEnabled) {
+                glDisable(GL_SCISSOR_TEST);
+            }
+        }
+
+        RenderContext context;
+        context.viewMatrix = view.camera->getViewMatrix();
+        context.projectionMatrix = view.camera->getProjectionMatrix();
+
+        for (Renderable * renderable : commandLists[v]) {
+            renderable->render(context);
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFramebuffer);
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    glScissor(prevScissorBox[0], prevScissorBox[1], prevScissorBox[2], prevScissorBox[3]);
+    glClearColor(prevClearColor[0], prevClearColor[1], prevClearColor[2], prevClearColor[3]);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the Renderables to draw for view 'viewIndex', in submission order.
+ */
+const vector<Renderable *> & MultiViewRenderer::getCommandList(size_t viewIndex) const {
+    return commandLists.at(viewIndex);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the number of Renderables that survived the union frustum pre-cull in the
+ * last call to \c buildCommandLists().
+ */
+size_t MultiViewRenderer::getNumSharedCandidates() const {
+    return candidates.size();
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,72 @@
+/**
+ * @brief MultiViewRenderer
+ */
+
+#ifndef RIGID3D_MULTI_VIEW_RENDERER_HPP_
+#define RIGID3D_MULTI_VIEW_RENDERER_HPP_
+
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Graphics/RenderView.hpp>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class Renderable;
+    class ThreadPool;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Renders a set of \c Renderables into several \c RenderViews per frame
+     * while sharing the CPU work between views.
+     *
+     * Building the command lists happens in four steps:
+     * # World space bounds of every Renderable are computed once for all views.
+     * # Renderables outside the bounding box of the union of all view frustums are
+     *   rejected for every view at once.
+     * # Survivors are sorted once by ShaderProgram and mesh to reduce state
+     *   changes.  Each view keeps this order.
+     * # Each view's command list is built by frustum culling the survivors.  Views
+     *   are processed in parallel when a \c ThreadPool is supplied.
+     *
+     * Submitting the lists issues GL calls and must happen on the thread owning
+     * the OpenGL context.
+     *
+     * \code{.cpp}
+     *  std::vector<RenderView> views = {
+     *      RenderView(playerOneCamera, 0, Viewport(0, 0, width / 2, height)),
+     *      RenderView(playerTwoCamera, 0, Viewport(width / 2, 0, width / 2, height))
+     *  };
+     *  multiViewRenderer.render(views, renderables);
+     * \endcode
+     */
+    class MultiViewRenderer {
+    public:
+        explicit MultiViewRenderer(ThreadPool * threadPool = nullptr);
+
+        void render(const std::vector<RenderView> & views,
+                    const std::vector<Renderable *> & renderables);
+
+        void buildCommandLists(const std::vector<RenderView> & views,
+                               const std::vector<Renderable *> & renderables);
+
+        void submitCommandLists(const std::vector<RenderView> & views) const;
+
+        const std::vector<Renderable *> & getCommandList(size_t viewIndex) const;
+
+        size_t getNumSharedCandidates() const;
+
+    private:
+        ThreadPool * threadPool;
+
+        std::vector<AABB> worldBounds;
+        std::vector<unsigned char> isCandidate;
+        std::vector<size_t> candidates;
+        std::vector< std::vector<Renderable *> > commandLists;
+    };
+
+}
+
+#endif /* RIGID3D_MULTI_VIEW_RENDERER_HPP_ */
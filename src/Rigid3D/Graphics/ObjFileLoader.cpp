@@ -1,8 +1,8 @@
 #include "Rigid3D/Graphics/ObjFileLoader.hpp"
 
 #include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/VirtualFileSystem.hpp>
 
-#include <fstream>
 #include <sstream>
 #include <iostream>
 
@@ -11,7 +11,8 @@ namespace Rigid3D {
 using namespace std;
 
 /**
-* Extracts vertex data from a Wavefront .obj file
+* Extracts vertex data from a Wavefront .obj file, read through
+* VirtualFileSystem::getDefault().
 * @param objFilePath - path to .obj file
 * @param positions - positions given in (x,y,z) object space.
 * @param normals - normals given in (x,y,z) object space.
@@ -22,10 +23,8 @@ void ObjFileLoader::decode(const char * objFilePath,
                            std::vector<vec3> & normals,
                            std::vector<vec2> & uvCoords) {
 
-    ifstream in(objFilePath, std::ios::in);
-    in.exceptions(std::ifstream::badbit);
-
-    if (!in) {
+    vector<uint8> fileContents;
+    if (!VirtualFileSystem::getDefault().tryRead(objFilePath, fileContents)) {
         stringstream errorMessage;
         errorMessage << "Unable to open .obj file " << objFilePath
             << " within method ObjFileLoader::decode" << endl;
@@ -33,6 +32,9 @@ void ObjFileLoader::decode(const char * objFilePath,
         throw Rigid3DException(errorMessage.str().c_str());
     }
 
+    istringstream in(string(fileContents.begin(), fileContents.end()));
+    in.exceptions(std::istringstream::badbit);
+
     string currentLine;
     int positionIndexA, positionIndexB, positionIndexC;
     int normalIndexA, normalIndexB, normalIndexC;
@@ -44,8 +46,7 @@ void ObjFileLoader::decode(const char * objFilePath,
     while (!in.eof()) {
         try {
             getline(in, currentLine);
-        } catch (const ifstream::failure &e) {
-            in.close();
+        } catch (const istringstream::failure &e) {
             stringstream errorMessage;
             errorMessage << "Error calling getline() -- " << e.what() << endl;
             throw Rigid3DException(errorMessage.str());
@@ -129,8 +130,6 @@ void ObjFileLoader::decode(const char * objFilePath,
             normals.push_back(temp_normals[normalIndexC]);
         }
     }
-
-    in.close();
 }
 
 /**
@@ -0,0 +1,266 @@
+#include "ObjectIdPicker.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param searchRadius - half size, in pixels, of the square read back around each
+ * picked pixel.
+ * @param maxPendingPicks - picks that may be in flight at once.
+ *
+ * @note Requires a current OpenGL context.
+ */
+ObjectIdPicker::ObjectIdPicker(int searchRadius, unsigned int maxPendingPicks)
+    : searchRadius(std::max(searchRadius, 0)),
+      width(0),
+      height(0),
+      idTexture(0),
+      framebuffer(0),
+      colorAttachment(GL_COLOR_ATTACHMENT1),
+      picks(std::max(maxPendingPicks, 1u)),
+      firstPick(0),
+      numPendingPicks(0) {
+
+    const int regionSize = 2 * this->searchRadius + 1;
+
+    for (PendingPick & pick : picks) {
+        glGenBuffers(1, &pick.pixelBuffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pick.pixelBuffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, regionSize * regionSize * sizeof(uint32), NULL,
+                GL_STREAM_READ);
+        pick.fence = 0;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+ObjectIdPicker::~ObjectIdPicker() {
+    for (PendingPick & pick : picks) {
+        if (pick.fence != 0) {
+            glDeleteSync(pick.fence);
+        }
+        glDeleteBuffers(1, &pick.pixelBuffer);
+    }
+    glDeleteTextures(1, &idTexture);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * (Re)creates the ID texture to match a scene framebuffer of 'width' by 'height'
+ * pixels, reattaching it if \c attachToFramebuffer() was called before.  Picks in
+ * flight are discarded.
+ */
+void ObjectIdPicker::resize(int width, int height) {
+    this->width = width;
+    this->height = height;
+
+    for (PendingPick & pick : picks) {
+        if (pick.fence != 0) {
+            glDeleteSync(pick.fence);
+            pick.fence = 0;
+        }
+    }
+    firstPick = 0;
+    numPendingPicks = 0;
+
+    if (idTexture == 0) {
+        glGenTextures(1, &idTexture);
+    }
+    glBindTexture(GL_TEXTURE_2D, idTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0, GL_RED_INTEGER,
+            GL_UNSIGNED_INT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (framebuffer != 0) {
+        attachToFramebuffer(framebuffer, colorAttachment);
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Attaches the ID texture to 'framebuffer' at 'colorAttachment'.  The caller remains
+ * responsible for including the attachment in glDrawBuffers so that fragment
+ * shaders can write to it.
+ */
+void ObjectIdPicker::attachToFramebuffer(GLuint framebuffer, GLenum colorAttachment) {
+    if (idTexture == 0) {
+        std::stringstream errorMessage;
+        errorMessage << "ID texture has not been created, call resize() first "
+                     << "within method ObjectIdPicker::attachToFramebuffer";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    this->framebuffer = framebuffer;
+    this->colorAttachment = colorAttachment;
+
+    GLint prevFramebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, colorAttachment, GL_TEXTURE_2D, idTexture, 0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GLuint(prevFramebuffer));
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Reads IDs from a GL_R32UI attachment owned by the caller, such as one of a pooled
+ * render target, instead of the picker's own texture.  Call again whenever the
+ * framebuffer is replaced or resized, rather than \c resize().
+ */
+void ObjectIdPicker::setSource(GLuint framebuffer, GLenum colorAttachment, int width,
+                               int height) {
+    this->framebuffer = framebuffer;
+    this->colorAttachment = colorAttachment;
+    this->width = width;
+    this->height = height;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Fills the ID texture with the background ID 0.  The scene framebuffer must be
+ * bound for drawing.
+ *
+ * @param drawBuffer - index of the ID attachment within the framebuffer's
+ * glDrawBuffers list.
+ */
+void ObjectIdPicker::clear(GLint drawBuffer) {
+    const GLuint background[4] = { 0, 0, 0, 0 };
+    glClearBufferuiv(GL_COLOR, drawBuffer, background);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Queues an asynchronous read of the IDs around pixel ('x', 'y'), measured from the
+ * lower left corner of the scene framebuffer.  Call after the scene pass.
+ *
+ * @return false if the pixel lies outside the framebuffer, or if
+ * 'maxPendingPicks' picks are already in flight.
+ */
+bool ObjectIdPicker::requestPick(int x, int y) {
+    if (x < 0 || y < 0 || x >= width || y >= height || numPendingPicks == picks.size()) {
+        return false;
+    }
+
+    PendingPick & pick = picks[(firstPick + numPendingPicks) % picks.size()];
+    ++numPendingPicks;
+
+    const int left = std::max(x - searchRadius, 0);
+    const int bottom = std::max(y - searchRadius, 0);
+    pick.regionWidth = std::min(x + searchRadius + 1, width) - left;
+    pick.regionHeight = std::min(y + searchRadius + 1, height) - bottom;
+    pick.centerX = x - left;
+    pick.centerY = y - bottom;
+    pick.result.objectId = 0;
+    pick.result.x = x;
+    pick.result.y = y;
+
+    GLint prevFramebuffer;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    GLint prevReadBuffer;
+    glGetIntegerv(GL_READ_BUFFER, &prevReadBuffer);
+    glReadBuffer(colorAttachment);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pick.pixelBuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(left, bottom, pick.regionWidth, pick.regionHeight, GL_RED_INTEGER,
+            GL_UNSIGNED_INT, reinterpret_cast<void *>(0));
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    glReadBuffer(GLenum(prevReadBuffer));
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, GLuint(prevFramebuffer));
+
+    pick.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    CHECK_GL_ERRORS;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Resolves the oldest pick if its readback has finished.  Never blocks.
+ *
+ * @return true if 'result' was filled in.
+ */
+bool ObjectIdPicker::getResult(PickResult & result) {
+    if (numPendingPicks == 0) {
+        return false;
+    }
+
+    PendingPick & pick = picks[firstPick];
+    GLenum status = glClientWaitSync(pick.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        return false;
+    }
+    glDeleteSync(pick.fence);
+    pick.fence = 0;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pick.pixelBuffer);
+    const uint32 * ids = static_cast<const uint32 *>(glMapBufferRange(GL_PIXEL_PACK_BUFFER,
+            0, pick.regionWidth * pick.regionHeight * sizeof(uint32), GL_MAP_READ_BIT));
+    if (ids != nullptr) {
+        pick.result.objectId = findNearestId(ids, pick.regionWidth, pick.regionHeight,
+                pick.centerX, pick.centerY);
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    result = pick.result;
+    firstPick = (firstPick + 1) % picks.size();
+    --numPendingPicks;
+
+    CHECK_GL_ERRORS;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ObjectIdPicker::getNumPendingPicks() const {
+    return (unsigned int)numPendingPicks;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint ObjectIdPicker::getIdTexture() const {
+    return idTexture;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the non-zero ID closest to ('centerX', 'centerY') within a row major
+ * region of IDs, or 0 if the region only contains background.
+ */
+uint32 ObjectIdPicker::findNearestId(const uint32 * ids, int regionWidth, int regionHeight,
+                                     int centerX, int centerY) {
+    uint32 nearestId = 0;
+    int nearestDistance = INT_MAX;
+
+    for (int y = 0; y < regionHeight; ++y) {
+        for (int x = 0; x < regionWidth; ++x) {
+            uint32 id = ids[y * regionWidth + x];
+            int distance = (x - centerX) * (x - centerX) + (y - centerY) * (y - centerY);
+            if (id != 0 && distance < nearestDistance) {
+                nearestId = id;
+                nearestDistance = distance;
+            }
+        }
+    }
+
+    return nearestId;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,117 @@
+/**
+ * @brief ObjectIdPicker
+ */
+
+#ifndef RIGID3D_OBJECT_ID_PICKER_HPP_
+#define RIGID3D_OBJECT_ID_PICKER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Picks objects under the cursor from a 32-bit object ID buffer written
+     * during the regular scene pass, reading it back without stalling.
+     *
+     * The picker owns a GL_R32UI texture that is attached as an extra color
+     * attachment of the framebuffer used for the scene pass.  Fragment shaders of
+     * pickable objects write their ID to it alongside their color, for example with
+     * PerFragLighting_withObjectId.frag:
+     * # uniform uint objectId;
+     * # layout (location = 1) out uint fragObjectId;
+     * ID 0 is reserved for the background.  Alternatively \c setSource() points the
+     * picker at an R32UI attachment owned elsewhere, such as a pooled render target.
+     *
+     * \c requestPick() copies a small square around the cursor into a pixel pack
+     * buffer and fences it.  \c getResult() returns false until the fence has
+     * signaled, typically on the next frame, so picking costs neither a second
+     * scene pass nor a pipeline stall.  The object reported is the one closest to
+     * the requested pixel within the square, which makes thin objects easier to hit.
+     *
+     * \code{.cpp}
+     *  // Once, after creating the scene framebuffer:
+     *  picker.resize(width, height);
+     *  picker.attachToFramebuffer(sceneFramebuffer, GL_COLOR_ATTACHMENT1);
+     *
+     *  // Each frame:
+     *  glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+     *  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+     *  picker.clear(1);
+     *  renderScene();
+     *  if (mouseClicked) {
+     *      picker.requestPick(cursorX, cursorY);
+     *  }
+     *
+     *  ObjectIdPicker::PickResult pick;
+     *  if (picker.getResult(pick) && pick.objectId != 0) {
+     *      select(pick.objectId);
+     *  }
+     * \endcode
+     *
+     * @see computePickRay() for exact hit points on the picked object.
+     */
+    class ObjectIdPicker {
+    public:
+        struct PickResult {
+            uint32 objectId;   // 0 if no object was found.
+            int x;             // Pixel passed to requestPick().
+            int y;
+        };
+
+        explicit ObjectIdPicker(int searchRadius = 2, unsigned int maxPendingPicks = 3);
+
+        ~ObjectIdPicker();
+
+        void resize(int width, int height);
+
+        void attachToFramebuffer(GLuint framebuffer, GLenum colorAttachment);
+
+        void setSource(GLuint framebuffer, GLenum colorAttachment, int width, int height);
+
+        void clear(GLint drawBuffer = 1);
+
+        bool requestPick(int x, int y);
+
+        bool getResult(PickResult & result);
+
+        unsigned int getNumPendingPicks() const;
+
+        GLuint getIdTexture() const;
+
+        static uint32 findNearestId(const uint32 * ids, int regionWidth, int regionHeight,
+                                    int centerX, int centerY);
+
+    private:
+        // Non-copyable, owns GL objects.
+        ObjectIdPicker(const ObjectIdPicker &);
+        ObjectIdPicker & operator = (const ObjectIdPicker &);
+
+        struct PendingPick {
+            GLuint pixelBuffer;
+            GLsync fence;
+            PickResult result;
+            int regionWidth;
+            int regionHeight;
+            int centerX;    // Requested pixel relative to the region.
+            int centerY;
+        };
+
+        int searchRadius;
+        int width;
+        int height;
+        GLuint idTexture;
+        GLuint framebuffer;
+        GLenum colorAttachment;
+
+        std::vector<PendingPick> picks;   // Ring, oldest at firstPick.
+        size_t firstPick;
+        size_t numPendingPicks;
+    };
+
+}
+
+#endif /* RIGID3D_OBJECT_ID_PICKER_HPP_ */
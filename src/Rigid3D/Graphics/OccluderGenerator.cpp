@@ -0,0 +1,397 @@
+#include "OccluderGenerator.hpp"
+
+#include <Rigid3D/Graphics/Mesh.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Rigid3D {
+
+using std::vector;
+using glm::dot;
+using glm::cross;
+
+namespace {
+
+    enum VoxelState : unsigned char {
+        Voxel_Unknown = 0,
+        Voxel_Surface,
+        Voxel_Exterior,
+        Voxel_Solid
+    };
+
+    /**
+     * Dense voxel grid padded by two voxels on every side.  Voxels need not be
+     * cubes, each axis is split into the same number of cells so thin walls are
+     * still resolved across their thickness.  The outermost layer
+     * can never touch a triangle, so voxel (0,0,0) always lies outside the mesh
+     * and can seed the exterior flood fill.
+     */
+    struct VoxelGrid {
+        int dim[3];
+        vec3 origin;
+        vec3 voxelSize;
+        vector<unsigned char> cells;
+
+        int index(int x, int y, int z) const {
+            return x + dim[0] * (y + dim[1] * z);
+        }
+
+        vec3 voxelMin(int x, int y, int z) const {
+            return origin + vec3(float(x), float(y), float(z)) * voxelSize;
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+    // Returns true if 'axis' separates the triangle (v0, v1, v2) from a box centered at
+    // the origin with half extents 'h'.
+    bool axisSeparates(const vec3 & axis, const vec3 & v0, const vec3 & v1,
+            const vec3 & v2, const vec3 & h) {
+        float p0 = dot(axis, v0);
+        float p1 = dot(axis, v1);
+        float p2 = dot(axis, v2);
+        float r = h.x * std::fabs(axis.x) + h.y * std::fabs(axis.y) + h.z * std::fabs(axis.z);
+
+        return std::min(p0, std::min(p1, p2)) > r || std::max(p0, std::max(p1, p2)) < -r;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Separating axis test between a triangle and an axis aligned box.
+    bool triangleOverlapsBox(const vec3 & a, const vec3 & b, const vec3 & c,
+            const vec3 & boxCenter, const vec3 & h) {
+        vec3 v0 = a - boxCenter;
+        vec3 v1 = b - boxCenter;
+        vec3 v2 = c - boxCenter;
+
+        vec3 edges[3] = {v1 - v0, v2 - v1, v0 - v2};
+        vec3 boxAxes[3] = {vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f)};
+
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                if (axisSeparates(cross(boxAxes[i], edges[j]), v0, v1, v2, h)) {
+                    return false;
+                }
+            }
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            if (axisSeparates(boxAxes[i], v0, v1, v2, h)) {
+                return false;
+            }
+        }
+
+        return !axisSeparates(cross(edges[0], edges[1]), v0, v1, v2, h);
+    }
+
+    //------------------------------------------------------------------------------------
+    void markSurfaceVoxels(const vector<vec3> & positions, VoxelGrid & grid) {
+        // Grow voxels slightly so triangles lying exactly on voxel faces are caught.
+        // Marking extra surface only shrinks the interior, so stays conservative.
+        vec3 h = grid.voxelSize * 0.5f * 1.001f;
+
+        for (size_t i = 0; i + 2 < positions.size(); i += 3) {
+            const vec3 & a = positions[i];
+            const vec3 & b = positions[i + 1];
+            const vec3 & c = positions[i + 2];
+
+            int lo[3], hi[3];
+            for (int k = 0; k < 3; ++k) {
+                float minCoord = std::min(a[k], std::min(b[k], c[k]));
+                float maxCoord = std::max(a[k], std::max(b[k], c[k]));
+                lo[k] = int(std::floor((minCoord - grid.origin[k]) / grid.voxelSize[k])) - 1;
+                hi[k] = int(std::floor((maxCoord - grid.origin[k]) / grid.voxelSize[k])) + 1;
+                lo[k] = std::max(lo[k], 0);
+                hi[k] = std::min(hi[k], grid.dim[k] - 1);
+            }
+
+            for (int z = lo[2]; z <= hi[2]; ++z) {
+                for (int y = lo[1]; y <= hi[1]; ++y) {
+                    for (int x = lo[0]; x <= hi[0]; ++x) {
+                        unsigned char & cell = grid.cells[grid.index(x, y, z)];
+                        if (cell == Voxel_Surface) {
+                            continue;
+                        }
+                        vec3 center = grid.voxelMin(x, y, z) + grid.voxelSize * 0.5f;
+                        if (triangleOverlapsBox(a, b, c, center, h)) {
+                            cell = Voxel_Surface;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Flood fills the exterior starting from the padded corner voxel, then marks all
+    // remaining unknown voxels as solid.
+    void classifyInterior(VoxelGrid & grid) {
+        vector<int> stack;
+        stack.push_back(grid.index(0, 0, 0));
+        grid.cells[0] = Voxel_Exterior;
+
+        const int strideY = grid.dim[0];
+        const int strideZ = grid.dim[0] * grid.dim[1];
+
+        while (!stack.empty()) {
+            int i = stack.back();
+            stack.pop_back();
+
+            int x = i % grid.dim[0];
+            int y = (i / strideY) % grid.dim[1];
+            int z = i / strideZ;
+
+            int neighbours[6];
+            int count = 0;
+            if (x > 0)               neighbours[count++] = i - 1;
+            if (x < grid.dim[0] - 1) neighbours[count++] = i + 1;
+            if (y > 0)               neighbours[count++] = i - strideY;
+            if (y < grid.dim[1] - 1) neighbours[count++] = i + strideY;
+            if (z > 0)               neighbours[count++] = i - strideZ;
+            if (z < grid.dim[2] - 1) neighbours[count++] = i + strideZ;
+
+            for (int n = 0; n < count; ++n) {
+                if (grid.cells[neighbours[n]] == Voxel_Unknown) {
+                    grid.cells[neighbours[n]] = Voxel_Exterior;
+                    stack.push_back(neighbours[n]);
+                }
+            }
+        }
+
+        for (unsigned char & cell : grid.cells) {
+            if (cell == Voxel_Unknown) {
+                cell = Voxel_Solid;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Removes every solid voxel that has a non-solid face neighbour.
+    void erode(VoxelGrid & grid) {
+        vector<unsigned char> eroded = grid.cells;
+
+        for (int z = 0; z < grid.dim[2]; ++z) {
+            for (int y = 0; y < grid.dim[1]; ++y) {
+                for (int x = 0; x < grid.dim[0]; ++x) {
+                    int i = grid.index(x, y, z);
+                    if (grid.cells[i] != Voxel_Solid) {
+                        continue;
+                    }
+                    // Solid voxels never touch the grid border because of padding.
+                    bool interior =
+                        grid.cells[grid.index(x - 1, y, z)] == Voxel_Solid &&
+                        grid.cells[grid.index(x + 1, y, z)] == Voxel_Solid &&
+                        grid.cells[grid.index(x, y - 1, z)] == Voxel_Solid &&
+                        grid.cells[grid.index(x, y + 1, z)] == Voxel_Solid &&
+                        grid.cells[grid.index(x, y, z - 1)] == Voxel_Solid &&
+                        grid.cells[grid.index(x, y, z + 1)] == Voxel_Solid;
+                    if (!interior) {
+                        eroded[i] = Voxel_Exterior;
+                    }
+                }
+            }
+        }
+
+        grid.cells.swap(eroded);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Grows a box of available voxels from 'seed', extending fully along axis order[0],
+    // then order[1], then order[2].  Writes the exclusive upper voxel corner to 'end'.
+    template <typename Available>
+    void growBox(const VoxelGrid & grid, const int seed[3], const int order[3],
+            Available available, int end[3]) {
+        for (int k = 0; k < 3; ++k) {
+            end[k] = seed[k] + 1;
+        }
+
+        for (int a = 0; a < 3; ++a) {
+            const int axis = order[a];
+            const int u = (axis + 1) % 3;
+            const int v = (axis + 2) % 3;
+
+            for (bool grow = true; grow && end[axis] < grid.dim[axis]; ) {
+                int p[3];
+                p[axis] = end[axis];
+                for (p[v] = seed[v]; p[v] < end[v] && grow; ++p[v]) {
+                    for (p[u] = seed[u]; p[u] < end[u]; ++p[u]) {
+                        if (!available(p[0], p[1], p[2])) { grow = false; break; }
+                    }
+                }
+                if (grow) { ++end[axis]; }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Repeatedly takes the largest box that can be grown from any remaining solid voxel,
+    // trying every axis order, until 'maxBoxes' boxes are taken or none are left with
+    // at least 'minVoxels' voxels.  Boxes never overlap.
+    void extractBoxes(const VoxelGrid & grid, unsigned int maxBoxes, int minVoxels,
+            vector<AABB> & boxes) {
+        static const int orders[6][3] = {
+            {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+        };
+
+        vector<bool> used(grid.cells.size(), false);
+
+        auto available = [&](int x, int y, int z) {
+            int i = grid.index(x, y, z);
+            return grid.cells[i] == Voxel_Solid && !used[i];
+        };
+
+        while (boxes.size() < maxBoxes) {
+            int bestVoxels = 0;
+            int bestStart[3] = {0, 0, 0};
+            int bestEnd[3] = {0, 0, 0};
+
+            int seed[3];
+            for (seed[2] = 0; seed[2] < grid.dim[2]; ++seed[2]) {
+                for (seed[1] = 0; seed[1] < grid.dim[1]; ++seed[1]) {
+                    for (seed[0] = 0; seed[0] < grid.dim[0]; ++seed[0]) {
+                        if (!available(seed[0], seed[1], seed[2])) {
+                            continue;
+                        }
+                        for (const int * order : orders) {
+                            int end[3];
+                            growBox(grid, seed, order, available, end);
+                            int voxels = (end[0] - seed[0]) * (end[1] - seed[1]) *
+                                (end[2] - seed[2]);
+                            if (voxels > bestVoxels) {
+                                bestVoxels = voxels;
+                                std::copy(seed, seed + 3, bestStart);
+                                std::copy(end, end + 3, bestEnd);
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (bestVoxels == 0 || bestVoxels < minVoxels) {
+                break;
+            }
+
+            for (int z = bestStart[2]; z < bestEnd[2]; ++z) {
+                for (int y = bestStart[1]; y < bestEnd[1]; ++y) {
+                    for (int x = bestStart[0]; x < bestEnd[0]; ++x) {
+                        used[grid.index(x, y, z)] = true;
+                    }
+                }
+            }
+
+            AABB box;
+            box.minBounds = grid.voxelMin(bestStart[0], bestStart[1], bestStart[2]);
+            box.maxBounds = grid.voxelMin(bestEnd[0], bestEnd[1], bestEnd[2]);
+            boxes.push_back(box);
+        }
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+unsigned int Occluder::getNumTriangles() const {
+    return (unsigned int)(trianglePositions.size() / 3);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Generates an inner occluder for 'mesh'.
+ *
+ * @param mesh - closed triangle mesh.
+ * @param settings - voxel resolution and box limits.
+ * @param occluder - receives the resulting boxes and their triangles.
+ */
+void OccluderGenerator::generate(const Mesh & mesh,
+                                 const OccluderSettings & settings,
+                                 Occluder & occluder) {
+    generate(*(mesh.getVertexPositionVector()), settings, occluder);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Generates an inner occluder for a triangle list of object space positions, three
+ * vertices per triangle.
+ *
+ * @param trianglePositions
+ * @param settings - voxel resolution and box limits.
+ * @param occluder - receives the resulting boxes and their triangles.
+ */
+void OccluderGenerator::generate(const vector<vec3> & trianglePositions,
+                                 const OccluderSettings & settings,
+                                 Occluder & occluder) {
+    occluder.boxes.clear();
+    occluder.trianglePositions.clear();
+
+    if (trianglePositions.size() < 3 || settings.resolution == 0) {
+        return;
+    }
+
+    AABB bounds;
+    bounds.minBounds = bounds.maxBounds = trianglePositions[0];
+    for (const vec3 & p : trianglePositions) {
+        bounds.minBounds = glm::min(bounds.minBounds, p);
+        bounds.maxBounds = glm::max(bounds.maxBounds, p);
+    }
+
+    vec3 extent = bounds.maxBounds - bounds.minBounds;
+    float longestAxis = std::max(extent.x, std::max(extent.y, extent.z));
+    if (longestAxis <= 0.0f) {
+        return;
+    }
+
+    VoxelGrid grid;
+    for (int k = 0; k < 3; ++k) {
+        // Flat axes still get a voxel of sensible thickness.
+        float axisExtent = std::max(extent[k], longestAxis / float(settings.resolution));
+        grid.voxelSize[k] = axisExtent / float(settings.resolution);
+        grid.dim[k] = int(std::ceil(extent[k] / grid.voxelSize[k])) + 4;
+    }
+    grid.origin = bounds.minBounds - 2.0f * grid.voxelSize;
+    grid.cells.assign(size_t(grid.dim[0]) * grid.dim[1] * grid.dim[2], Voxel_Unknown);
+
+    markSurfaceVoxels(trianglePositions, grid);
+    classifyInterior(grid);
+    for (unsigned int i = 0; i < settings.erosionSteps; ++i) {
+        erode(grid);
+    }
+
+    float voxelVolume = grid.voxelSize.x * grid.voxelSize.y * grid.voxelSize.z;
+    float boundsVolume = extent.x * extent.y * extent.z;
+    int minVoxels = int(std::ceil(settings.minVolumeFraction * boundsVolume / voxelVolume));
+
+    extractBoxes(grid, settings.maxBoxes, minVoxels, occluder.boxes);
+    for (const AABB & box : occluder.boxes) {
+        triangulateBox(box, occluder.trianglePositions);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Appends the 12 outward facing, counter-clockwise wound triangles of 'box' to
+ * 'trianglePositions'.
+ */
+void OccluderGenerator::triangulateBox(const AABB & box, vector<vec3> & trianglePositions) {
+    const vec3 & lo = box.minBounds;
+    const vec3 & hi = box.maxBounds;
+
+    const vec3 c[8] = {
+        vec3(lo.x, lo.y, lo.z), vec3(hi.x, lo.y, lo.z),
+        vec3(hi.x, hi.y, lo.z), vec3(lo.x, hi.y, lo.z),
+        vec3(lo.x, lo.y, hi.z), vec3(hi.x, lo.y, hi.z),
+        vec3(hi.x, hi.y, hi.z), vec3(lo.x, hi.y, hi.z)
+    };
+
+    static const int faceIndices[36] = {
+        0, 3, 2,  0, 2, 1,  // -z
+        4, 5, 6,  4, 6, 7,  // +z
+        0, 4, 7,  0, 7, 3,  // -x
+        1, 2, 6,  1, 6, 5,  // +x
+        0, 1, 5,  0, 5, 4,  // -y
+        3, 7, 6,  3, 6, 2   // +y
+    };
+
+    for (int i : faceIndices) {
+        trianglePositions.push_back(c[i]);
+    }
+}
+
+} // end namespace Rigid3D
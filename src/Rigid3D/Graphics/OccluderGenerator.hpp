@@ -0,0 +1,88 @@
+/**
+ * @brief OccluderGenerator
+ */
+
+#ifndef RIGID3D_OCCLUDER_GENERATOR_HPP_
+#define RIGID3D_OCCLUDER_GENERATOR_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class Mesh;
+}
+
+namespace Rigid3D {
+
+    /**
+     * Low polygon stand-in for a render mesh, used when rasterizing occluders for
+     * occlusion culling.  Every box lies entirely within the source mesh, so
+     * anything the occluder hides is guaranteed to be hidden by the mesh itself.
+     *
+     * Box triangles are stored as a triangle list of object space positions, three
+     * vertices per triangle, matching the layout used by \c Mesh.
+     */
+    struct Occluder {
+        std::vector<AABB> boxes;
+        std::vector<vec3> trianglePositions;
+
+        unsigned int getNumTriangles() const;
+    };
+
+    /**
+     * Parameters controlling \c OccluderGenerator output.
+     */
+    struct OccluderSettings {
+        unsigned int resolution;    // Number of voxels along each mesh axis.
+        unsigned int erosionSteps;  // Extra voxel layers peeled off the solid interior.
+        unsigned int maxBoxes;      // Upper bound on boxes kept, largest first.
+        float minVolumeFraction;    // Boxes smaller than this fraction of the mesh
+                                    // bounds volume are discarded.
+
+        OccluderSettings()
+            : resolution(32),
+              erosionSteps(0),
+              maxBoxes(4),
+              minVolumeFraction(0.01f) { }
+    };
+
+    /**
+     * @brief Derives conservative inner occluders from closed triangle meshes.
+     *
+     * Generation runs in three stages:
+     * # The mesh is voxelized.  Voxels touched by any triangle are marked as
+     *   surface, and a flood fill from outside the mesh bounds marks every voxel
+     *   reachable without crossing the surface as exterior.  What remains is the
+     *   solid interior, which never includes a voxel the surface passes through.
+     * # The interior is eroded \c erosionSteps times to trim thin features.
+     * # The largest box that fits in the remaining interior is taken repeatedly,
+     *   up to \c maxBoxes boxes, and each box is triangulated.
+     *
+     * Meshes that are not watertight flood completely and produce an empty
+     * \c Occluder.
+     *
+     * \code{.cpp}
+     *  Mesh wall("../data/meshes/wall.obj");
+     *  Occluder occluder;
+     *  OccluderGenerator::generate(wall, OccluderSettings(), occluder);
+     * \endcode
+     */
+    class OccluderGenerator {
+    public:
+        static void generate(const Mesh & mesh,
+                             const OccluderSettings & settings,
+                             Occluder & occluder);
+
+        static void generate(const std::vector<vec3> & trianglePositions,
+                             const OccluderSettings & settings,
+                             Occluder & occluder);
+
+        static void triangulateBox(const AABB & box, std::vector<vec3> & trianglePositions);
+    };
+
+}
+
+#endif /* RIGID3D_OCCLUDER_GENERATOR_HPP_ */
@@ -44,10 +44,55 @@ void OpenGLContext::init() {
     while(glGetError() != GL_NO_ERROR);
 }
 
+//----------------------------------------------------------------------------------------
+/**
+ * Initializes this \c OpenGLContext so that it shares objects such as buffers and
+ * textures with 'context', which must already be initialized and must outlive
+ * this one.  Leaves 'context' current on the calling thread.
+ *
+ * The shared context is meant to be made current on a different thread than
+ * 'context', for example to upload data in the background.
+ */
+void OpenGLContext::initShared(const OpenGLContext & context) {
+    sharedWith = &context;
+
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, majorVersion);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minorVersion);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+
+    window = glfwCreateWindow(1, 1, "Shared OpenGL Context", NULL, context.window);
+    if (window == NULL) {
+        throw GlfwException("Call to glfwCreateWindow failed.");
+    }
+    glfwMakeContextCurrent(context.window);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Makes this context current on the calling thread.
+ */
+void OpenGLContext::makeCurrent() {
+    glfwMakeContextCurrent(window);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Detaches whichever context is current on the calling thread.
+ */
+void OpenGLContext::releaseCurrent() {
+    glfwMakeContextCurrent(NULL);
+}
+
 //----------------------------------------------------------------------------------------
 OpenGLContext::~OpenGLContext() {
     glfwDestroyWindow(window);
-    glfwTerminate();
+
+    // GLFW is owned by the context that initialized it.
+    if (sharedWith == nullptr) {
+        glfwTerminate();
+    }
 }
 
 } // end namespace Rigid3D
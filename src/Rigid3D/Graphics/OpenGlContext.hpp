@@ -15,14 +15,22 @@ namespace Rigid3D {
     class OpenGLContext {
     public:
         OpenGLContext(unsigned int majorVersion, unsigned int minorVersion)
-                : window(nullptr), majorVersion(majorVersion), minorVersion(minorVersion) { }
+                : window(nullptr), sharedWith(nullptr),
+                  majorVersion(majorVersion), minorVersion(minorVersion) { }
 
         ~OpenGLContext();
 
          void init();
 
+         void initShared(const OpenGLContext & context);
+
+         void makeCurrent();
+
+         static void releaseCurrent();
+
     protected:
         GLFWwindow *window;
+        const OpenGLContext * sharedWith;
         unsigned int majorVersion;
         unsigned int minorVersion;
 
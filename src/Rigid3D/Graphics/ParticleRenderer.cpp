@@ -0,0 +1,183 @@
+#include "ParticleRenderer.hpp"
+
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Particles/ParticleEmitter.hpp>
+
+namespace Rigid3D {
+
+const GLuint ParticleRenderer::PositionLocation;
+const GLuint ParticleRenderer::ColorLocation;
+const uint32 ParticleRenderer::NumRegions;
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param maxInstancesPerFrame - particles drawn per frame, across all emitters.
+ *
+ * @note Requires a current OpenGL context.
+ */
+ParticleRenderer::ParticleRenderer(ShaderProgram & shaderProgram,
+                                   uint32 maxInstancesPerFrame)
+    : shaderProgram(&shaderProgram),
+      maxInstancesPerFrame(maxInstancesPerFrame),
+      vao(0),
+      instanceBuffer(0),
+      mappedBuffer(nullptr),
+      region(0),
+      numInstances(0) {
+
+    for (uint32 i = 0; i < NumRegions; ++i) {
+        fences[i] = 0;
+    }
+
+    const GLsizeiptr numBytes = GLsizeiptr(maxInstancesPerFrame) * NumRegions *
+            ParticleEmitter::BytesPerInstance;
+
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    glGenBuffers(1, &instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+#ifdef GL_VERSION_4_4
+    GLint majorVersion = 0;
+    GLint minorVersion = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+    if ((majorVersion > 4) || (majorVersion == 4 && minorVersion >= 4)) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, numBytes, NULL, flags);
+        mappedBuffer = glMapBufferRange(GL_ARRAY_BUFFER, 0, numBytes, flags);
+    } else
+#endif
+    {
+        glBufferData(GL_ARRAY_BUFFER, numBytes, NULL, GL_STREAM_DRAW);
+    }
+
+    // Pointers are set per draw, at the emitter's offset into the ring.
+    glEnableVertexAttribArray(PositionLocation);
+    glVertexAttribDivisor(PositionLocation, 1);
+    glEnableVertexAttribArray(ColorLocation);
+    glVertexAttribDivisor(ColorLocation, 1);
+
+    glBindVertexArray(GLuint(prevVao));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+ParticleRenderer::~ParticleRenderer() {
+    for (uint32 i = 0; i < NumRegions; ++i) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+        }
+    }
+    if (mappedBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &instanceBuffer);
+    glDeleteVertexArrays(1, &vao);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Waits until the GPU has finished with the region written \c NumRegions frames
+ * ago, which normally has long completed.
+ */
+void ParticleRenderer::beginFrame() {
+    GLsync & fence = fences[region];
+    if (fence) {
+        GLenum result;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(fence);
+        fence = 0;
+    }
+    numInstances = 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Streams the live particles of 'emitter' into this frame's region and draws them
+ * with one instanced draw call.
+ *
+ * @return number of particles drawn, fewer than the emitter has once the frame's
+ * \c maxInstancesPerFrame is reached.
+ */
+uint32 ParticleRenderer::render(const ParticleEmitter & emitter) {
+    const uint32 available = maxInstancesPerFrame - numInstances;
+    const uint32 count = (emitter.getNumParticles() < available) ?
+            emitter.getNumParticles() : available;
+    if (count == 0) {
+        return 0;
+    }
+
+    const GLintptr offset = (GLintptr(region) * maxInstancesPerFrame + numInstances) *
+            ParticleEmitter::BytesPerInstance;
+    const GLsizeiptr numBytes = GLsizeiptr(count) * ParticleEmitter::BytesPerInstance;
+
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+    if (mappedBuffer) {
+        emitter.writeInstances(static_cast<char *>(mappedBuffer) + offset, count);
+    } else {
+        void * destination = glMapBufferRange(GL_ARRAY_BUFFER, offset, numBytes,
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        emitter.writeInstances(destination, count);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    glVertexAttribPointer(PositionLocation, 3, GL_FLOAT, GL_FALSE,
+            ParticleEmitter::BytesPerInstance, reinterpret_cast<const void *>(offset));
+    glVertexAttribPointer(ColorLocation, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+            ParticleEmitter::BytesPerInstance,
+            reinterpret_cast<const void *>(offset + 3 * sizeof(float)));
+
+    shaderProgram->setUniform("particleSize", emitter.getParams().size);
+    shaderProgram->enable();
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GLsizei(count));
+    shaderProgram->disable();
+
+    glBindVertexArray(GLuint(prevVao));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    numInstances += count;
+
+    CHECK_GL_ERRORS;
+
+    return count;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Fences this frame's region and moves on to the next one.
+ */
+void ParticleRenderer::endFrame() {
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    region = (region + 1) % NumRegions;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of particles drawn since \c beginFrame.
+ */
+uint32 ParticleRenderer::getNumInstances() const {
+    return numInstances;
+}
+
+//----------------------------------------------------------------------------------------
+bool ParticleRenderer::isPersistentlyMapped() const {
+    return mappedBuffer != nullptr;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,83 @@
+/**
+ * @brief ParticleRenderer
+ */
+
+#ifndef RIGID3D_PARTICLE_RENDERER_HPP_
+#define RIGID3D_PARTICLE_RENDERER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+// Forward declarations
+namespace Rigid3D {
+    class ParticleEmitter;
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Draws each \c ParticleEmitter as camera facing quads with one
+     * instanced draw call, streaming the particles through a ring buffer.
+     *
+     * The instance buffer is split into \c NumRegions regions, one per frame in
+     * flight, and a fence guards each region until the GPU has finished reading
+     * it.  With OpenGL 4.4 or later the buffer is mapped once, persistently and
+     * coherently, and particles are packed straight into it.  Otherwise each
+     * emitter's range is mapped unsynchronized, relying on the same fences.
+     *
+     * The ShaderProgram is expected to be built from Particle.vert and
+     * Particle.frag, and the caller sets:
+     * # uniform mat4 ModelViewMatrix
+     * # uniform mat4 ProjectionMatrix
+     *
+     * \code{.cpp}
+     *  particleRenderer.beginFrame();
+     *  for (const ParticleEmitter * emitter : emitters) {
+     *      particleRenderer.render(*emitter);
+     *  }
+     *  particleRenderer.endFrame();
+     * \endcode
+     */
+    class ParticleRenderer {
+    public:
+        ParticleRenderer(ShaderProgram & shaderProgram, uint32 maxInstancesPerFrame);
+
+        ~ParticleRenderer();
+
+        void beginFrame();
+
+        uint32 render(const ParticleEmitter & emitter);
+
+        void endFrame();
+
+        uint32 getNumInstances() const;
+
+        bool isPersistentlyMapped() const;
+
+        static const GLuint PositionLocation = 0;
+        static const GLuint ColorLocation = 1;
+
+        static const uint32 NumRegions = 3;
+
+    private:
+        // Non-copyable, owns GL buffer objects.
+        ParticleRenderer(const ParticleRenderer &);
+        ParticleRenderer & operator = (const ParticleRenderer &);
+
+        ShaderProgram * shaderProgram;
+        uint32 maxInstancesPerFrame;
+
+        GLuint vao;
+        GLuint instanceBuffer;
+        void * mappedBuffer;
+
+        GLsync fences[NumRegions];
+        uint32 region;
+        uint32 numInstances;    // Written to the current region.
+    };
+
+}
+
+#endif /* RIGID3D_PARTICLE_RENDERER_HPP_ */
@@ -0,0 +1,29 @@
+/**
+ * @brief PointLight
+ */
+
+#ifndef RIGID3D_POINT_LIGHT_HPP_
+#define RIGID3D_POINT_LIGHT_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+namespace Rigid3D {
+
+    /**
+     * Omnidirectional light casting shadows up to 'radius' world units away.
+     */
+    struct PointLight {
+        unsigned int id;  // Unique identifier used for shadow map caching.
+        vec3 position;    // World space position.
+        float radius;     // Far plane distance of the shadow cube.
+
+        PointLight()
+            : id(0), position(0.0f), radius(1.0f) { }
+
+        PointLight(unsigned int id, const vec3 & position, float radius)
+            : id(id), position(position), radius(radius) { }
+    };
+
+}
+
+#endif /* RIGID3D_POINT_LIGHT_HPP_ */
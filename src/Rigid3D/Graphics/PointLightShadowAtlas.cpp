@@ -0,0 +1,309 @@
+#include "PointLightShadowAtlas.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Collision/FrustumPlanes.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Math/Trigonometry.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <sstream>
+
+namespace Rigid3D {
+
+using std::vector;
+
+namespace {
+
+    const unsigned int numCubeFaces = 6;
+    const unsigned char allFacesMask = 0x3F;
+
+    // Distance of the shadow cube's near plane as a fraction of the light radius.
+    const float nearPlaneFraction = 0.01f;
+
+    //------------------------------------------------------------------------------------
+    // 64 bit FNV-1a hash, accumulated over successive calls.
+    void hashBytes(uint64 & hash, const void * data, size_t numBytes) {
+        const unsigned char * bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < numBytes; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    float squaredDistance(const AABB & box, const vec3 & point) {
+        vec3 closest = glm::clamp(point, box.minBounds, box.maxBounds);
+        vec3 d = closest - point;
+        return glm::dot(d, d);
+    }
+
+    //------------------------------------------------------------------------------------
+    unsigned int countBits(unsigned char mask) {
+        unsigned int count = 0;
+        for (; mask != 0; mask &= (unsigned char)(mask - 1)) {
+            ++count;
+        }
+        return count;
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+/**
+ * @note Requires a current OpenGL 4.0 context.
+ *
+ * @param faceResolution - width and height in texels of each cube face.
+ * @param numSlots - maximum number of point lights with shadows in a frame.
+ * @param depthShader - linked PointShadow ShaderProgram.
+ */
+PointLightShadowAtlas::PointLightShadowAtlas(unsigned int faceResolution,
+                                             unsigned int numSlots,
+                                             ShaderProgram & depthShader)
+    : faceResolution(faceResolution),
+      depthShader(&depthShader),
+      slotCache(numSlots),
+      depthTexture(0),
+      framebuffer(0),
+      location_ModelMatrix(-1),
+      location_faceMask(-1),
+      numFacesRendered(0) {
+
+    if (faceResolution == 0 || numSlots == 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Face resolution and number of slots must be non-zero within method "
+            << "PointLightShadowAtlas::PointLightShadowAtlas";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, depthTexture);
+    glTexImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, 0, GL_DEPTH_COMPONENT24, faceResolution,
+            faceResolution, numSlots * numCubeFaces, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, 0);
+
+    GLint prevFramebuffer;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    CHECK_FRAMEBUFFER_COMPLETENESS;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFramebuffer);
+
+    location_ModelMatrix = depthShader.getUniformLocation("ModelMatrix");
+    location_faceMask = depthShader.getUniformLocation("faceMask");
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+PointLightShadowAtlas::~PointLightShadowAtlas() {
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &depthTexture);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Updates the shadow maps of 'lights', re-rendering only those whose light or
+ * casters in range changed since they were last rendered.
+ *
+ * @param lights - point lights to shadow this frame.
+ * @param casters - shadow casting Renderables.
+ * @param shadowSlots - receives, for each light, its slot in the depth texture or
+ * -1 if all slots are in use.
+ */
+void PointLightShadowAtlas::render(const vector<PointLight> & lights,
+                                   const vector<const Renderable *> & casters,
+                                   vector<int> & shadowSlots) {
+    slotCache.beginFrame();
+    shadowSlots.assign(lights.size(), -1);
+    numFacesRendered = 0;
+
+    GLint prevFramebuffer;
+    GLint prevViewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+
+    vector<unsigned char> faceMasks(casters.size());
+
+    for (size_t l = 0; l < lights.size(); ++l) {
+        const PointLight & light = lights[l];
+
+        FrustumPlanes facePlanes[numCubeFaces];
+        mat4 projectionMatrix = getFaceProjectionMatrix(light.radius);
+        for (unsigned int face = 0; face < numCubeFaces; ++face) {
+            facePlanes[face].set(projectionMatrix * getFaceViewMatrix(light.position, face));
+        }
+
+        // Cull casters per face and hash everything the shadow map depends on.
+        uint64 signature = 14695981039346656037ULL;
+        hashBytes(signature, &light.position, sizeof(vec3));
+        hashBytes(signature, &light.radius, sizeof(float));
+
+        for (size_t i = 0; i < casters.size(); ++i) {
+            const Renderable & caster = *casters[i];
+            unsigned char mask = allFacesMask;
+
+            if (caster.hasBoundingBox()) {
+                AABB bounds = caster.getWorldBoundingBox();
+                mask = 0;
+                if (squaredDistance(bounds, light.position) <= light.radius * light.radius) {
+                    for (unsigned int face = 0; face < numCubeFaces; ++face) {
+                        if (facePlanes[face].intersects(bounds)) {
+                            mask |= (unsigned char)(1 << face);
+                        }
+                    }
+                }
+            }
+
+            faceMasks[i] = mask;
+            if (mask != 0) {
+                mat4 modelMatrix = caster.getModelMatrix();
+                hashBytes(signature, &casters[i], sizeof(const Renderable *));
+                hashBytes(signature, glm::value_ptr(modelMatrix), sizeof(mat4));
+            }
+        }
+
+        bool needsUpdate;
+        int slot = slotCache.acquire(light.id, signature, needsUpdate);
+        shadowSlots[l] = slot;
+
+        if (slot >= 0 && needsUpdate) {
+            renderLight(light, unsigned(slot), casters, faceMasks);
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFramebuffer);
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+void PointLightShadowAtlas::renderLight(const PointLight & light, unsigned int slot,
+                                        const vector<const Renderable *> & casters,
+                                        const vector<unsigned char> & faceMasks) {
+    const GLint firstLayer = GLint(slot * numCubeFaces);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, faceResolution, faceResolution);
+
+    // Clearing a layered attachment clears every layer, so clear this slot's faces
+    // one at a time before attaching the whole array for rendering.
+    for (unsigned int face = 0; face < numCubeFaces; ++face) {
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0,
+                firstLayer + GLint(face));
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0);
+
+    mat4 projectionMatrix = getFaceProjectionMatrix(light.radius);
+    for (unsigned int face = 0; face < numCubeFaces; ++face) {
+        std::stringstream uniformName;
+        uniformName << "faceViewProjection[" << face << "]";
+        depthShader->setUniform(uniformName.str().c_str(),
+                projectionMatrix * getFaceViewMatrix(light.position, face));
+    }
+    depthShader->setUniform("lightPosition", light.position);
+    depthShader->setUniform("lightRadius", light.radius);
+    depthShader->setUniform("layerOffset", int(firstLayer));
+
+    depthShader->enable();
+    for (size_t i = 0; i < casters.size(); ++i) {
+        if (faceMasks[i] == 0) {
+            continue;
+        }
+
+        mat4 modelMatrix = casters[i]->getModelMatrix();
+        glUniformMatrix4fv(location_ModelMatrix, 1, GL_FALSE, glm::value_ptr(modelMatrix));
+        glUniform1i(location_faceMask, GLint(faceMasks[i]));
+        casters[i]->drawGeometry();
+
+        numFacesRendered += countBits(faceMasks[i]);
+    }
+    depthShader->disable();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Forces the shadow map of 'lightId' to be re-rendered the next time it is used.
+ */
+void PointLightShadowAtlas::invalidate(unsigned int lightId) {
+    slotCache.invalidate(lightId);
+}
+
+//----------------------------------------------------------------------------------------
+void PointLightShadowAtlas::invalidateAll() {
+    slotCache.clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the GL_TEXTURE_CUBE_MAP_ARRAY depth texture holding all slots.
+ */
+GLuint PointLightShadowAtlas::getDepthTexture() const {
+    return depthTexture;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int PointLightShadowAtlas::getFaceResolution() const {
+    return faceResolution;
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int PointLightShadowAtlas::getNumSlots() const {
+    return slotCache.getNumSlots();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the number of caster/face pairs drawn by the last call to \c render(),
+ * useful for measuring the effect of caching and per face culling.
+ */
+unsigned int PointLightShadowAtlas::getNumFacesRenderedLastFrame() const {
+    return numFacesRendered;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the view matrix for cube map 'face', ordered +X, -X, +Y, -Y, +Z, -Z
+ * to match the OpenGL cube map layer order.
+ */
+mat4 PointLightShadowAtlas::getFaceViewMatrix(const vec3 & lightPosition, unsigned int face) {
+    static const vec3 directions[numCubeFaces] = {
+        vec3( 1.0f,  0.0f,  0.0f), vec3(-1.0f,  0.0f,  0.0f),
+        vec3( 0.0f,  1.0f,  0.0f), vec3( 0.0f, -1.0f,  0.0f),
+        vec3( 0.0f,  0.0f,  1.0f), vec3( 0.0f,  0.0f, -1.0f)
+    };
+    static const vec3 ups[numCubeFaces] = {
+        vec3(0.0f, -1.0f,  0.0f), vec3(0.0f, -1.0f,  0.0f),
+        vec3(0.0f,  0.0f,  1.0f), vec3(0.0f,  0.0f, -1.0f),
+        vec3(0.0f, -1.0f,  0.0f), vec3(0.0f, -1.0f,  0.0f)
+    };
+
+    return glm::lookAt(lightPosition, lightPosition + directions[face], ups[face]);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the 90 degree projection shared by all cube faces of a light.
+ */
+mat4 PointLightShadowAtlas::getFaceProjectionMatrix(float radius) {
+    return glm::perspective(PI * 0.5f, 1.0f, radius * nearPlaneFraction, radius);
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,102 @@
+/**
+ * @brief PointLightShadowAtlas
+ */
+
+#ifndef RIGID3D_POINT_LIGHT_SHADOW_ATLAS_HPP_
+#define RIGID3D_POINT_LIGHT_SHADOW_ATLAS_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Graphics/PointLight.hpp>
+#include <Rigid3D/Graphics/ShadowSlotCache.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class Renderable;
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Cube shadow maps for point lights, stored as slots of a single depth
+     * cube map array.
+     *
+     * Each shadowed light is rendered in one pass: a geometry shader with six
+     * invocations routes every triangle to the cube faces it can reach via
+     * gl_Layer.  Before drawing, casters are culled on the CPU against the light's
+     * range and each face frustum, and the resulting face mask is passed to the
+     * geometry shader so that invisible faces are skipped.
+     *
+     * Slots are cached between frames.  A light's shadow map is only re-rendered
+     * when the light moves, its radius changes, or a caster within range moves.
+     *
+     * Depth is stored as distance from the light divided by radius, with depth
+     * comparison enabled, so lighting shaders can sample the atlas through a
+     * samplerCubeArrayShadow:
+     * \code{.glsl}
+     *  vec3 toFragment = worldPosition - lightPosition;
+     *  float reference = length(toFragment) / lightRadius - bias;
+     *  float lit = texture(pointShadows, vec4(toFragment, shadowSlot), reference);
+     * \endcode
+     *
+     * The depth ShaderProgram is expected to be built from PointShadow.vert,
+     * PointShadow.geom and PointShadow.frag.  Casters must have their vertex
+     * positions at attribute location 0 and a bounding box set for culling.
+     */
+    class PointLightShadowAtlas {
+    public:
+        PointLightShadowAtlas(unsigned int faceResolution,
+                              unsigned int numSlots,
+                              ShaderProgram & depthShader);
+
+        ~PointLightShadowAtlas();
+
+        void render(const std::vector<PointLight> & lights,
+                    const std::vector<const Renderable *> & casters,
+                    std::vector<int> & shadowSlots);
+
+        void invalidate(unsigned int lightId);
+
+        void invalidateAll();
+
+        GLuint getDepthTexture() const;
+
+        unsigned int getFaceResolution() const;
+
+        unsigned int getNumSlots() const;
+
+        unsigned int getNumFacesRenderedLastFrame() const;
+
+        static mat4 getFaceViewMatrix(const vec3 & lightPosition, unsigned int face);
+
+        static mat4 getFaceProjectionMatrix(float radius);
+
+    private:
+        // Non-copyable, owns GL objects.
+        PointLightShadowAtlas(const PointLightShadowAtlas &);
+        PointLightShadowAtlas & operator = (const PointLightShadowAtlas &);
+
+        void renderLight(const PointLight & light, unsigned int slot,
+                         const std::vector<const Renderable *> & casters,
+                         const std::vector<unsigned char> & faceMasks);
+
+        unsigned int faceResolution;
+        ShaderProgram * depthShader;
+        ShadowSlotCache slotCache;
+
+        GLuint depthTexture;
+        GLuint framebuffer;
+
+        GLint location_ModelMatrix;
+        GLint location_faceMask;
+
+        unsigned int numFacesRendered;
+    };
+
+}
+
+#endif /* RIGID3D_POINT_LIGHT_SHADOW_ATLAS_HPP_ */
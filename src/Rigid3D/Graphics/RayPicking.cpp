@@ -0,0 +1,194 @@
+#include "RayPicking.hpp"
+
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+
+#include <cfloat>
+#include <cmath>
+#include <sstream>
+
+namespace Rigid3D {
+
+using glm::cross;
+using glm::dot;
+using glm::inverse;
+using glm::length;
+using glm::normalize;
+
+//----------------------------------------------------------------------------------------
+/**
+ * Computes the world space ray through a point on the screen, running from the near
+ * plane to the far plane.
+ *
+ * @param ndcPosition - point in normalized device coordinates, with (-1, -1) at the
+ * lower left corner of the viewport and (1, 1) at the upper right.
+ */
+RayCastInput computePickRay(const mat4 & viewMatrix,
+                            const mat4 & projectionMatrix,
+                            const vec2 & ndcPosition) {
+    mat4 inverseViewProjection = inverse(projectionMatrix * viewMatrix);
+
+    vec4 nearPoint = inverseViewProjection * vec4(ndcPosition.x, ndcPosition.y, -1.0f, 1.0f);
+    vec4 farPoint = inverseViewProjection * vec4(ndcPosition.x, ndcPosition.y, 1.0f, 1.0f);
+
+    RayCastInput ray;
+    ray.p1 = vec3(nearPoint) / nearPoint.w;
+    ray.p2 = vec3(farPoint) / farPoint.w;
+    ray.maxLength = length(ray.p2 - ray.p1);
+
+    return ray;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Casts a ray against the triangles of a mesh batch drawn with GL_TRIANGLES,
+ * finding the closest hit.
+ *
+ * @param vertexPositions - packed xyz model space positions, such as
+ * \c MeshConsolidator::getVertexPositionDataPtr().
+ * @param modelMatrix - model to world transform of the mesh.
+ * @param input - world space ray.
+ * @param output - world space hit point, unit normal and distance along the ray,
+ * written only if the ray hits.
+ * @param indices - 32 bit index data that indexed batches refer to, as drawn with
+ * glDrawElementsBaseVertex.  Required if 'batchInfo' is indexed.
+ * @return true if the ray hits a triangle within input.maxLength.
+ */
+bool rayCastTriangles(const float * vertexPositions,
+                      const BatchInfo & batchInfo,
+                      const mat4 & modelMatrix,
+                      const RayCastInput & input,
+                      RayCastOutput * output,
+                      const uint32 * indices) {
+    if (batchInfo.indexed && indices == nullptr) {
+        std::stringstream errorMessage;
+        errorMessage << "Indexed batches need their index data"
+                     << " within method rayCastTriangles";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    // Intersect in model space, so triangles need not be transformed.
+    mat4 worldToModel = inverse(modelMatrix);
+    vec3 worldDirection = normalize(input.p2 - input.p1);
+    vec3 origin = vec3(worldToModel * vec4(input.p1, 1.0f));
+    vec3 direction = vec3(worldToModel * vec4(worldDirection, 0.0f));
+
+    // Model space ray parameter per unit of world space distance is 1, since
+    // 'direction' is the image of a unit world space vector.
+    float closest = input.maxLength;
+    bool hit = false;
+    vec3 hitNormal;
+
+    const vec3 * positions = reinterpret_cast<const vec3 *>(vertexPositions);
+    const unsigned int start = batchInfo.startIndex;
+    const unsigned int end = start + batchInfo.numIndices;
+
+    // Trailing vertices that do not form a whole triangle are ignored.
+    for (unsigned int i = start; i + 2 < end; i += 3) {
+        unsigned int vertex[3] = {i, i + 1, i + 2};
+        if (batchInfo.indexed) {
+            for (int k = 0; k < 3; ++k) {
+                vertex[k] = static_cast<unsigned int>(int(indices[i + k]) + batchInfo.baseVertex);
+            }
+        }
+        const vec3 & a = positions[vertex[0]];
+        const vec3 & b = positions[vertex[1]];
+        const vec3 & c = positions[vertex[2]];
+
+        // Moller-Trumbore, accepting both windings.
+        vec3 edge1 = b - a;
+        vec3 edge2 = c - a;
+        vec3 p = cross(direction, edge2);
+        float determinant = dot(edge1, p);
+        if (std::fabs(determinant) < FLT_EPSILON) {
+            continue;
+        }
+        float inverseDeterminant = 1.0f / determinant;
+
+        vec3 s = origin - a;
+        float u = dot(s, p) * inverseDeterminant;
+        if (u < 0.0f || u > 1.0f) {
+            continue;
+        }
+
+        vec3 q = cross(s, edge1);
+        float v = dot(direction, q) * inverseDeterminant;
+        if (v < 0.0f || u + v > 1.0f) {
+            continue;
+        }
+
+        float t = dot(edge2, q) * inverseDeterminant;
+        if (t >= 0.0f && t < closest) {
+            closest = t;
+            hitNormal = cross(edge1, edge2);
+            hit = true;
+        }
+    }
+
+    if (hit && output) {
+        mat3 normalMatrix = glm::transpose(mat3(worldToModel));
+        vec3 normal = normalize(normalMatrix * hitNormal);
+        if (dot(normal, worldDirection) > 0.0f) {
+            normal = -normal;
+        }
+
+        output->hitPoint = input.p1 + worldDirection * closest;
+        output->normal = normal;
+        output->length = closest;
+    }
+
+    return hit;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Finds the closest of 'renderables' hit by a world space ray.  Renderables with a
+ * bounding box are first tested against it, so only candidates are tested against
+ * their triangles.
+ *
+ * @param vertexPositions - packed xyz model space positions shared by all
+ * renderables, indexed by their BatchInfo.
+ * @param indices - index data shared by the renderables with indexed batches.
+ * @return index into 'renderables' of the closest hit, or -1 if nothing was hit.
+ */
+int rayCastRenderables(const std::vector<const Renderable *> & renderables,
+                       const float * vertexPositions,
+                       const RayCastInput & input,
+                       RayCastOutput * output,
+                       const uint32 * indices) {
+    RayCastInput ray = input;
+    RayCastOutput closestHit;
+    int closestIndex = -1;
+
+    for (size_t i = 0; i < renderables.size(); ++i) {
+        const Renderable * renderable = renderables[i];
+        if (renderable->getBatchInfo() == nullptr) {
+            continue;
+        }
+
+        if (renderable->hasBoundingBox()) {
+            if (!renderable->getWorldBoundingBox().rayCast(ray, nullptr)) {
+                continue;
+            }
+        }
+
+        RayCastOutput hit;
+        if (rayCastTriangles(vertexPositions, *renderable->getBatchInfo(),
+                renderable->getModelMatrix(), ray, &hit, indices)) {
+            // Later hits must be closer than this one.
+            ray.maxLength = hit.length;
+            closestHit = hit;
+            closestIndex = int(i);
+        }
+    }
+
+    if (closestIndex >= 0 && output) {
+        *output = closestHit;
+    }
+
+    return closestIndex;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,44 @@
+/**
+ * @brief RayPicking
+ *
+ * CPU ray casting used for exact picking, either on its own or to find the hit
+ * point on an object identified by an \c ObjectIdPicker.
+ */
+
+#ifndef RIGID3D_RAY_PICKING_HPP_
+#define RIGID3D_RAY_PICKING_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/RayCastInput.hpp>
+#include <Rigid3D/Collision/RayCastOutput.hpp>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    struct BatchInfo;
+    class Renderable;
+}
+
+namespace Rigid3D {
+
+    RayCastInput computePickRay(const mat4 & viewMatrix,
+                                const mat4 & projectionMatrix,
+                                const vec2 & ndcPosition);
+
+    bool rayCastTriangles(const float * vertexPositions,
+                          const BatchInfo & batchInfo,
+                          const mat4 & modelMatrix,
+                          const RayCastInput & input,
+                          RayCastOutput * output,
+                          const uint32 * indices = nullptr);
+
+    int rayCastRenderables(const std::vector<const Renderable *> & renderables,
+                           const float * vertexPositions,
+                           const RayCastInput & input,
+                           RayCastOutput * output,
+                           const uint32 * indices = nullptr);
+
+}
+
+#endif /* RIGID3D_RAY_PICKING_HPP_ */
@@ -0,0 +1,548 @@
+#include "RenderTargetPool.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+RenderTargetDesc::RenderTargetDesc()
+    : width(0),
+      height(0),
+      internalFormat(GL_RGBA8),
+      samples(0),
+      filter(GL_LINEAR),
+      wrap(GL_CLAMP_TO_EDGE),
+      compareMode(GL_NONE) {
+
+}
+
+//----------------------------------------------------------------------------------------
+RenderTargetDesc::RenderTargetDesc(GLsizei width, GLsizei height, GLenum internalFormat,
+                                   GLsizei samples)
+    : width(width),
+      height(height),
+      internalFormat(internalFormat),
+      samples(samples),
+      filter(GL_LINEAR),
+      wrap(GL_CLAMP_TO_EDGE),
+      compareMode(GL_NONE) {
+
+}
+
+//----------------------------------------------------------------------------------------
+bool RenderTargetDesc::isDepthFormat() const {
+    switch (internalFormat) {
+        case GL_DEPTH_COMPONENT:
+        case GL_DEPTH_COMPONENT16:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32:
+        case GL_DEPTH_COMPONENT32F:
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH32F_STENCIL8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+bool RenderTargetDesc::isMultisampled() const {
+    return samples > 0;
+}
+
+//----------------------------------------------------------------------------------------
+GLenum RenderTargetDesc::getTextureTarget() const {
+    return isMultisampled() ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+}
+
+//----------------------------------------------------------------------------------------
+RenderTarget::RenderTarget()
+    : framebuffer(0),
+      depthTexture(0),
+      width(0),
+      height(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+RenderTargetPool::Stats::Stats()
+    : numTextures(0),
+      numTexturesInUse(0),
+      numTexturesPendingRelease(0),
+      numFramebuffers(0),
+      numBytes(0),
+      numTexturesCreated(0),
+      numTexturesReused(0),
+      numTexturesEvicted(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param memoryBudget - bytes of texture memory above which free textures are
+ * evicted, or 0 for no limit.  Textures in use are never evicted, so the pool may
+ * exceed its budget while they are held.
+ * @param maxIdleFrames - frames a free texture is kept without being reused before
+ * it is evicted, or 0 to keep free textures until the budget requires otherwise.
+ */
+RenderTargetPool::RenderTargetPool(uint64 memoryBudget, unsigned int maxIdleFrames)
+    : memoryBudget(memoryBudget),
+      maxIdleFrames(maxIdleFrames),
+      frameIndex(0),
+      numBytes(0),
+      numTexturesCreated(0),
+      numTexturesReused(0),
+      numTexturesEvicted(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+RenderTargetPool::~RenderTargetPool() {
+    clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return a texture matching the size, format and sample count of 'desc', with its
+ * sampling state set from 'desc'.  The most recently used matching free texture is
+ * returned if there is one, otherwise a new texture is created.  The contents of a
+ * reused texture are undefined.
+ *
+ * @note Requires a current OpenGL context.
+ */
+GLuint RenderTargetPool::acquireTexture(const RenderTargetDesc & desc) {
+    if (desc.width <= 0 || desc.height <= 0) {
+        std::stringstream errorMessage;
+        errorMessage << "Invalid render target size " << desc.width << "x" << desc.height
+                     << " within method RenderTargetPool::acquireTexture";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    PooledTexture * match = nullptr;
+    for (PooledTexture & pooled : textures) {
+        if (pooled.state == TextureState::Free &&
+            pooled.desc.width == desc.width &&
+            pooled.desc.height == desc.height &&
+            pooled.desc.internalFormat == desc.internalFormat &&
+            pooled.desc.samples == desc.samples &&
+            (match == nullptr || pooled.lastUsedFrame > match->lastUsedFrame)) {
+            match = &pooled;
+        }
+    }
+
+    if (match != nullptr) {
+        match->state = TextureState::InUse;
+        match->desc = desc;
+        match->lastUsedFrame = frameIndex;
+        ++numTexturesReused;
+        applySamplingState(match->texture, desc);
+        return match->texture;
+    }
+
+    PooledTexture pooled;
+    pooled.desc = desc;
+    pooled.state = TextureState::InUse;
+    pooled.releaseFrame = 0;
+    pooled.lastUsedFrame = frameIndex;
+    pooled.numBytes = uint64(desc.width) * uint64(desc.height) *
+            uint64(getBytesPerPixel(desc.internalFormat)) *
+            uint64(std::max(desc.samples, 1));
+
+    const GLenum target = desc.getTextureTarget();
+    GLint prevTexture;
+    glGetIntegerv(desc.isMultisampled() ? GL_TEXTURE_BINDING_2D_MULTISAMPLE :
+            GL_TEXTURE_BINDING_2D, &prevTexture);
+    glGenTextures(1, &pooled.texture);
+    glBindTexture(target, pooled.texture);
+    if (desc.isMultisampled()) {
+        glTexImage2DMultisample(target, desc.samples, desc.internalFormat, desc.width,
+                desc.height, GL_TRUE);
+    } else {
+        glTexStorage2D(target, 1, desc.internalFormat, desc.width, desc.height);
+    }
+    glBindTexture(target, GLuint(prevTexture));
+    applySamplingState(pooled.texture, desc);
+
+    textures.push_back(pooled);
+    numBytes += pooled.numBytes;
+    ++numTexturesCreated;
+
+    // Make room for the new texture within the budget.
+    evict();
+
+    CHECK_GL_ERRORS;
+
+    return pooled.texture;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Returns 'texture' to the pool.  With a 'delayFrames' of 0 it may be handed out by
+ * the very next acquisition, which suits targets whose last use was recorded
+ * earlier in the same frame.  Otherwise it becomes available once \c nextFrame()
+ * has been called 'delayFrames' times.
+ *
+ * Cached framebuffers that use the texture are kept, since the same combination
+ * of textures tends to be requested again.
+ */
+void RenderTargetPool::releaseTexture(GLuint texture, unsigned int delayFrames) {
+    PooledTexture * pooled = findTexture(texture);
+    if (pooled == nullptr || pooled->state != TextureState::InUse) {
+        std::stringstream errorMessage;
+        errorMessage << "Texture " << texture << " is not acquired from the pool "
+                     << "within method RenderTargetPool::releaseTexture";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    pooled->lastUsedFrame = frameIndex;
+    if (delayFrames == 0) {
+        pooled->state = TextureState::Free;
+    } else {
+        pooled->state = TextureState::PendingRelease;
+        pooled->releaseFrame = frameIndex + delayFrames;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return a framebuffer with 'colorTextures' attached at GL_COLOR_ATTACHMENT0 onwards,
+ * in order and all enabled as draw buffers, and 'depthTexture' attached as depth, or
+ * depth-stencil for packed formats.  Pass 0 for no depth attachment.  All textures
+ * must be owned by the pool.  The framebuffer is created on first request and cached
+ * until one of its textures is evicted.
+ *
+ * @note Requires a current OpenGL context.
+ */
+GLuint RenderTargetPool::getFramebuffer(const std::vector<GLuint> & colorTextures,
+                                        GLuint depthTexture) {
+    std::vector<GLuint> key(colorTextures);
+    key.push_back(depthTexture);
+
+    std::map<std::vector<GLuint>, GLuint>::iterator cached = framebuffers.find(key);
+    if (cached != framebuffers.end()) {
+        return cached->second;
+    }
+
+    for (GLuint texture : key) {
+        if (texture != 0 && findTexture(texture) == nullptr) {
+            std::stringstream errorMessage;
+            errorMessage << "Texture " << texture << " is not owned by the pool "
+                         << "within method RenderTargetPool::getFramebuffer";
+            throw Rigid3DException(errorMessage.str());
+        }
+    }
+
+    GLint prevFramebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevFramebuffer);
+
+    GLuint framebuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+
+    std::vector<GLenum> drawBuffers;
+    for (size_t i = 0; i < colorTextures.size(); ++i) {
+        GLenum attachment = GLenum(GL_COLOR_ATTACHMENT0 + i);
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, attachment,
+                findTexture(colorTextures[i])->desc.getTextureTarget(), colorTextures[i], 0);
+        drawBuffers.push_back(attachment);
+    }
+
+    if (depthTexture != 0) {
+        const RenderTargetDesc & desc = findTexture(depthTexture)->desc;
+        GLenum attachment = GL_DEPTH_ATTACHMENT;
+        if (desc.internalFormat == GL_DEPTH24_STENCIL8 ||
+            desc.internalFormat == GL_DEPTH32F_STENCIL8) {
+            attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+        }
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, attachment, desc.getTextureTarget(),
+                depthTexture, 0);
+    }
+
+    if (drawBuffers.empty()) {
+        glDrawBuffer(GL_NONE);
+    } else {
+        glDrawBuffers(GLsizei(drawBuffers.size()), drawBuffers.data());
+    }
+
+    GLenum status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GLuint(prevFramebuffer));
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        glDeleteFramebuffers(1, &framebuffer);
+        std::stringstream errorMessage;
+        errorMessage << "Framebuffer is incomplete, status 0x" << std::hex << status
+                     << " within method RenderTargetPool::getFramebuffer";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    framebuffers[key] = framebuffer;
+
+    CHECK_GL_ERRORS;
+
+    return framebuffer;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Acquires a texture for each of 'colorDescs' and returns them attached to a cached
+ * framebuffer.  All descriptions should have the same size and sample count.
+ *
+ * @note Requires a current OpenGL context.
+ */
+RenderTarget RenderTargetPool::acquireRenderTarget(
+        const std::vector<RenderTargetDesc> & colorDescs) {
+    return acquireRenderTarget(colorDescs, RenderTargetDesc());
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * As above, with a depth attachment described by 'depthDesc'.  A 'depthDesc' of
+ * zero size means no depth attachment.
+ */
+RenderTarget RenderTargetPool::acquireRenderTarget(
+        const std::vector<RenderTargetDesc> & colorDescs,
+        const RenderTargetDesc & depthDesc) {
+    RenderTarget renderTarget;
+    const RenderTargetDesc & first = colorDescs.empty() ? depthDesc : colorDescs.front();
+    renderTarget.width = first.width;
+    renderTarget.height = first.height;
+
+    try {
+        for (const RenderTargetDesc & desc : colorDescs) {
+            renderTarget.colorTextures.push_back(acquireTexture(desc));
+        }
+        if (depthDesc.width > 0 && depthDesc.height > 0) {
+            renderTarget.depthTexture = acquireTexture(depthDesc);
+        }
+        renderTarget.framebuffer = getFramebuffer(renderTarget.colorTextures,
+                renderTarget.depthTexture);
+    } catch (...) {
+        releaseRenderTarget(renderTarget);
+        throw;
+    }
+
+    return renderTarget;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Releases the textures of 'renderTarget', as with \c releaseTexture(), and resets it.
+ * Its framebuffer stays cached for the next acquisition of the same textures.
+ */
+void RenderTargetPool::releaseRenderTarget(RenderTarget & renderTarget,
+                                           unsigned int delayFrames) {
+    for (GLuint texture : renderTarget.colorTextures) {
+        releaseTexture(texture, delayFrames);
+    }
+    if (renderTarget.depthTexture != 0) {
+        releaseTexture(renderTarget.depthTexture, delayFrames);
+    }
+
+    renderTarget = RenderTarget();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Advances the frame counter, frees textures whose release delay has passed and
+ * evicts free textures beyond the memory budget or idle limit.  Call once per frame.
+ *
+ * @note Requires a current OpenGL context.
+ */
+void RenderTargetPool::nextFrame() {
+    ++frameIndex;
+
+    for (PooledTexture & pooled : textures) {
+        if (pooled.state == TextureState::PendingRelease && pooled.releaseFrame <= frameIndex) {
+            pooled.state = TextureState::Free;
+        }
+    }
+
+    evict();
+}
+
+//----------------------------------------------------------------------------------------
+uint64 RenderTargetPool::getFrameIndex() const {
+    return frameIndex;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Sets the memory budget, in bytes, evicting free textures if it is already
+ * exceeded.  0 means no limit.
+ */
+void RenderTargetPool::setMemoryBudget(uint64 numBytes) {
+    memoryBudget = numBytes;
+    evict();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Deletes every texture and framebuffer owned by the pool, including textures that
+ * are still acquired.
+ */
+void RenderTargetPool::clear() {
+    for (auto & entry : framebuffers) {
+        glDeleteFramebuffers(1, &entry.second);
+    }
+    framebuffers.clear();
+
+    for (PooledTexture & pooled : textures) {
+        glDeleteTextures(1, &pooled.texture);
+    }
+    textures.clear();
+    numBytes = 0;
+}
+
+//----------------------------------------------------------------------------------------
+RenderTargetPool::Stats RenderTargetPool::getStats() const {
+    Stats stats;
+    stats.numTextures = textures.size();
+    stats.numFramebuffers = framebuffers.size();
+    stats.numBytes = numBytes;
+    stats.numTexturesCreated = numTexturesCreated;
+    stats.numTexturesReused = numTexturesReused;
+    stats.numTexturesEvicted = numTexturesEvicted;
+
+    for (const PooledTexture & pooled : textures) {
+        if (pooled.state == TextureState::InUse) {
+            ++stats.numTexturesInUse;
+        } else if (pooled.state == TextureState::PendingRelease) {
+            ++stats.numTexturesPendingRelease;
+        }
+    }
+
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the size of one texel of 'internalFormat' as typically stored by drivers,
+ * used for memory accounting.  Three component formats are counted padded to
+ * four components.
+ */
+GLsizeiptr RenderTargetPool::getBytesPerPixel(GLenum internalFormat) {
+    switch (internalFormat) {
+        case GL_R8:
+        case GL_R8I:
+        case GL_R8UI:
+        case GL_STENCIL_INDEX8:
+            return 1;
+        case GL_RG8:
+        case GL_RG8I:
+        case GL_RG8UI:
+        case GL_R16:
+        case GL_R16F:
+        case GL_R16I:
+        case GL_R16UI:
+        case GL_DEPTH_COMPONENT16:
+            return 2;
+        case GL_RGB16:
+        case GL_RGB16F:
+        case GL_RGBA16:
+        case GL_RGBA16F:
+        case GL_RGBA16I:
+        case GL_RGBA16UI:
+        case GL_RG32F:
+        case GL_RG32I:
+        case GL_RG32UI:
+        case GL_DEPTH32F_STENCIL8:
+            return 8;
+        case GL_RGB32F:
+        case GL_RGB32I:
+        case GL_RGB32UI:
+        case GL_RGBA32F:
+        case GL_RGBA32I:
+        case GL_RGBA32UI:
+            return 16;
+        default:
+            // GL_RGBA8, GL_RGB10_A2, GL_R11F_G11F_B10F, GL_RG16F, GL_R32F,
+            // GL_DEPTH24_STENCIL8, GL_DEPTH_COMPONENT32F and similar, with
+            // three component 8 bit formats padded to four bytes.
+            return 4;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+RenderTargetPool::PooledTexture * RenderTargetPool::findTexture(GLuint texture) {
+    for (PooledTexture & pooled : textures) {
+        if (pooled.texture == texture) {
+            return &pooled;
+        }
+    }
+
+    return nullptr;
+}
+
+//----------------------------------------------------------------------------------------
+// Deletes idle free textures, then least recently used free textures until the pool
+// is within budget.
+void RenderTargetPool::evict() {
+    if (maxIdleFrames > 0) {
+        for (size_t i = textures.size(); i-- > 0; ) {
+            if (textures[i].state == TextureState::Free &&
+                frameIndex - textures[i].lastUsedFrame > maxIdleFrames) {
+                deleteTexture(i);
+            }
+        }
+    }
+
+    while (memoryBudget > 0 && numBytes > memoryBudget) {
+        size_t leastRecent = textures.size();
+        for (size_t i = 0; i < textures.size(); ++i) {
+            if (textures[i].state == TextureState::Free &&
+                (leastRecent == textures.size() ||
+                 textures[i].lastUsedFrame < textures[leastRecent].lastUsedFrame)) {
+                leastRecent = i;
+            }
+        }
+
+        if (leastRecent == textures.size()) {
+            break;   // Everything left is in use.
+        }
+        deleteTexture(leastRecent);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void RenderTargetPool::deleteTexture(size_t index) {
+    GLuint texture = textures[index].texture;
+
+    for (auto entry = framebuffers.begin(); entry != framebuffers.end(); ) {
+        const std::vector<GLuint> & attachments = entry->first;
+        if (std::find(attachments.begin(), attachments.end(), texture) != attachments.end()) {
+            glDeleteFramebuffers(1, &entry->second);
+            entry = framebuffers.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+
+    glDeleteTextures(1, &texture);
+    numBytes -= textures[index].numBytes;
+    textures.erase(textures.begin() + index);
+    ++numTexturesEvicted;
+}
+
+//----------------------------------------------------------------------------------------
+void RenderTargetPool::applySamplingState(GLuint texture, const RenderTargetDesc & desc) {
+    if (desc.isMultisampled()) {
+        return;
+    }
+
+    GLint prevTexture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, desc.filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, desc.filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, desc.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, desc.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, desc.compareMode);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D, GLuint(prevTexture));
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,174 @@
+/**
+ * @brief RenderTargetPool
+ */
+
+#ifndef RIGID3D_RENDER_TARGET_POOL_HPP_
+#define RIGID3D_RENDER_TARGET_POOL_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <map>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * Describes a 2D texture used as a render target.
+     *
+     * Textures are pooled by size, internal format and sample count only.  The
+     * sampling state is applied each time a texture is acquired, so targets that
+     * differ only in how they are sampled can share the same texture.  Sampling
+     * state is ignored for multisampled textures.
+     */
+    struct RenderTargetDesc {
+        GLsizei width;
+        GLsizei height;
+        GLenum internalFormat;
+        GLsizei samples;      // 0 for a regular GL_TEXTURE_2D.
+        GLenum filter;        // Used for both minification and magnification.
+        GLenum wrap;          // Used for both S and T.
+        GLenum compareMode;   // GL_COMPARE_REF_TO_TEXTURE for shadow samplers.
+
+        RenderTargetDesc();
+
+        RenderTargetDesc(GLsizei width, GLsizei height, GLenum internalFormat,
+                         GLsizei samples = 0);
+
+        bool isDepthFormat() const;
+
+        bool isMultisampled() const;
+
+        GLenum getTextureTarget() const;
+    };
+
+    /**
+     * A framebuffer together with the pooled textures attached to it.
+     */
+    struct RenderTarget {
+        GLuint framebuffer;
+        std::vector<GLuint> colorTextures;   // At GL_COLOR_ATTACHMENT0 onwards.
+        GLuint depthTexture;                 // 0 if there is no depth attachment.
+        GLsizei width;
+        GLsizei height;
+
+        RenderTarget();
+    };
+
+    /**
+     * @brief Owns render target textures and the framebuffer objects built from
+     * them, so that passes share memory and reuse framebuffer state instead of each
+     * allocating their own.
+     *
+     * A released texture returns to the pool and is handed out again by the next
+     * \c acquireTexture() call with a matching size and format, so targets whose
+     * lifetimes do not overlap alias the same memory.  Framebuffers are cached by
+     * their attachments, which avoids re-attaching and re-validating a framebuffer
+     * every frame.
+     *
+     * A texture may also be released with a delay of some frames, counted by
+     * \c nextFrame().  Targets that were sampled or read back late in a frame are
+     * then not overwritten by another user while the GPU may still be working on
+     * that frame, which would otherwise force the driver to synchronize or rename
+     * the texture.
+     *
+     * Free textures are kept for reuse, which makes window resizes cheap: the
+     * targets of the old size are released, and if the window returns to that size
+     * they are picked up again.  Memory is capped by evicting free textures least
+     * recently used first once the pool exceeds its memory budget, and free
+     * textures left unused for \c maxIdleFrames frames are evicted as well.
+     * Cached framebuffers referring to an evicted texture are deleted with it.
+     *
+     * Single sampled textures are immutable, created with glTexStorage2D.
+     */
+    class RenderTargetPool {
+    public:
+        struct Stats {
+            size_t numTextures;          // Textures owned, in use, pending or free.
+            size_t numTexturesInUse;
+            size_t numTexturesPendingRelease;
+            size_t numFramebuffers;
+            uint64 numBytes;             // Approximate memory of all textures.
+            uint64 numTexturesCreated;   // Since construction.
+            uint64 numTexturesReused;    // Acquisitions satisfied by a free texture.
+            uint64 numTexturesEvicted;
+
+            Stats();
+        };
+
+        explicit RenderTargetPool(uint64 memoryBudget = 0, unsigned int maxIdleFrames = 0);
+
+        ~RenderTargetPool();
+
+        GLuint acquireTexture(const RenderTargetDesc & desc);
+
+        void releaseTexture(GLuint texture, unsigned int delayFrames = 0);
+
+        GLuint getFramebuffer(const std::vector<GLuint> & colorTextures,
+                              GLuint depthTexture);
+
+        RenderTarget acquireRenderTarget(const std::vector<RenderTargetDesc> & colorDescs);
+
+        RenderTarget acquireRenderTarget(const std::vector<RenderTargetDesc> & colorDescs,
+                                         const RenderTargetDesc & depthDesc);
+
+        void releaseRenderTarget(RenderTarget & renderTarget, unsigned int delayFrames = 0);
+
+        void nextFrame();
+
+        uint64 getFrameIndex() const;
+
+        void setMemoryBudget(uint64 numBytes);
+
+        void clear();
+
+        Stats getStats() const;
+
+        static GLsizeiptr getBytesPerPixel(GLenum internalFormat);
+
+    private:
+        // Non-copyable, owns GL objects.
+        RenderTargetPool(const RenderTargetPool &);
+        RenderTargetPool & operator = (const RenderTargetPool &);
+
+        enum class TextureState {
+            InUse,
+            PendingRelease,
+            Free
+        };
+
+        struct PooledTexture {
+            GLuint texture;
+            RenderTargetDesc desc;
+            TextureState state;
+            uint64 releaseFrame;   // When a pending release becomes free.
+            uint64 lastUsedFrame;
+            uint64 numBytes;
+        };
+
+        PooledTexture * findTexture(GLuint texture);
+
+        void evict();
+
+        void deleteTexture(size_t index);
+
+        static void applySamplingState(GLuint texture, const RenderTargetDesc & desc);
+
+        std::vector<PooledTexture> textures;
+
+        // Keyed by color attachments followed by the depth attachment.
+        std::map<std::vector<GLuint>, GLuint> framebuffers;
+
+        uint64 memoryBudget;          // 0 for unlimited.
+        unsigned int maxIdleFrames;   // 0 to keep idle textures indefinitely.
+        uint64 frameIndex;
+        uint64 numBytes;
+        uint64 numTexturesCreated;
+        uint64 numTexturesReused;
+        uint64 numTexturesEvicted;
+    };
+
+}
+
+#endif /* RIGID3D_RENDER_TARGET_POOL_HPP_ */
@@ -0,0 +1,59 @@
+/**
+ * @brief RenderView
+ */
+
+#ifndef RIGID3D_RENDER_VIEW_HPP_
+#define RIGID3D_RENDER_VIEW_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gltypes.h>
+
+// Forward declarations
+namespace Rigid3D {
+    class Camera;
+}
+
+namespace Rigid3D {
+
+    /**
+     * Rectangle of a render target in pixels, as passed to glViewport.
+     */
+    struct Viewport {
+        int x;
+        int y;
+        int width;
+        int height;
+
+        Viewport()
+            : x(0), y(0), width(0), height(0) { }
+
+        Viewport(int x, int y, int width, int height)
+            : x(x), y(y), width(width), height(height) { }
+    };
+
+    /**
+     * A \c Camera together with the render target and viewport it draws into.
+     * Split screen halves, picture-in-picture minimaps, reflection probes and
+     * shadow views are each a \c RenderView.
+     *
+     * @see MultiViewRenderer
+     */
+    struct RenderView {
+        const Camera * camera;
+        GLuint framebuffer;   // 0 for the default framebuffer.
+        Viewport viewport;
+        bool clear;           // Clear color and depth within the viewport first.
+        vec4 clearColor;
+
+        RenderView()
+            : camera(nullptr), framebuffer(0), clear(false), clearColor(0.0f) { }
+
+        RenderView(const Camera & camera, GLuint framebuffer, const Viewport & viewport)
+            : camera(&camera), framebuffer(framebuffer), viewport(viewport),
+              clear(false), clearColor(0.0f) { }
+    };
+
+}
+
+#endif /* RIGID3D_RENDER_VIEW_HPP_ */
@@ -1,18 +1,51 @@
 #include "Renderable.hpp"
 
+#include <Rigid3D/Graphics/FramePacket.hpp>
 #include <Rigid3D/Graphics/ShaderProgram.hpp>
 #include <Rigid3D/Graphics/MeshConsolidator.hpp>
 #include <Rigid3D/Graphics/GlErrorCheck.hpp>
 
 namespace Rigid3D {
 
+//---------------------------------------------------------------------------------------
+RenderableUniformLocations::RenderableUniformLocations()
+    : modelViewMatrix(-1),
+      projectionMatrix(-1),
+      normalMatrix(-1),
+      emission(-1),
+      Ka(-1),
+      Kd(-1),
+      Ks(-1),
+      shininessFactor(-1) {
+
+}
+
+//---------------------------------------------------------------------------------------
+/**
+ * Queries the uniform locations from 'shaderProgram'.
+ *
+ * @note Requires a current OpenGL context.
+ */
+RenderableUniformLocations::RenderableUniformLocations(const ShaderProgram & shaderProgram)
+    : modelViewMatrix(shaderProgram.getUniformLocation("ModelViewMatrix")),
+      projectionMatrix(shaderProgram.getUniformLocation("ProjectionMatrix")),
+      normalMatrix(shaderProgram.getUniformLocation("NormalMatrix")),
+      emission(shaderProgram.getUniformLocation("material.emission")),
+      Ka(shaderProgram.getUniformLocation("material.Ka")),
+      Kd(shaderProgram.getUniformLocation("material.Kd")),
+      Ks(shaderProgram.getUniformLocation("material.Ks")),
+      shininessFactor(shaderProgram.getUniformLocation("material.shininessFactor")) {
+
+}
+
 //---------------------------------------------------------------------------------------
 Renderable::Renderable(const GLuint * vao,
                        const ShaderProgram * shaderProgram,
                        const BatchInfo * batchInfo)
     : vao(const_cast<GLuint *>(vao)),
       shaderProgram(const_cast<ShaderProgram *>(shaderProgram)),
-      batchInfo(const_cast<BatchInfo *>(batchInfo)) {
+      batchInfo(const_cast<BatchInfo *>(batchInfo)),
+      _hasBoundingBox(false) {
 
 }
 
@@ -20,7 +53,8 @@ Renderable::Renderable(const GLuint * vao,
 Renderable::Renderable()
     : vao(nullptr),
       shaderProgram(nullptr),
-      batchInfo(nullptr) {
+      batchInfo(nullptr),
+      _hasBoundingBox(false) {
 
 }
 
@@ -45,26 +79,48 @@ void Renderable::render(const RenderContext & context) {
         return;
     }
 
-    loadUniformData(context);
+    RenderItem(*this).render(context);
+}
 
-    // 1. Get and save currently bound VAO.
-    // 2. Bind local VAO.
-    // 3. Enable ShaderProgram
-    // 4. Call glDraw*(...)
-    // 5. Disable ShaderProgram
-    // 6. Bind previous VAO.
+//---------------------------------------------------------------------------------------
+/**
+ * Records the commands that draw this Renderable into 'commandList' without
+ * making any OpenGL calls, so it is safe to call from worker threads.
+ *
+ * @param uniformLocations - locations resolved from this Renderable's ShaderProgram.
+ */
+void Renderable::record(CommandList & commandList,
+                        const RenderContext & context,
+                        const RenderableUniformLocations & uniformLocations) const {
+    if (vao == nullptr || shaderProgram == nullptr || batchInfo == nullptr) {
+        return;
+    }
+
+    RenderItem(*this).record(commandList, context, uniformLocations);
+}
+
+//---------------------------------------------------------------------------------------
+/**
+ * Issues the draw call for this Renderable's geometry using whichever ShaderProgram
+ * is currently enabled.  No uniforms are loaded, which lets passes such as shadow
+ * map rendering supply their own shader and transforms.
+ */
+void Renderable::drawGeometry() const {
+    if (vao == nullptr || batchInfo == nullptr) {
+        return;
+    }
 
     GLint prev_vao;
     glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prev_vao);
     glBindVertexArray(*vao);
-
-    shaderProgram->enable();
+    if (batchInfo->indexed) {
+        glDrawElementsBaseVertex(GL_TRIANGLES, batchInfo->numIndices, GL_UNSIGNED_INT,
+                reinterpret_cast<const void *>(batchInfo->startIndex * sizeof(GLuint)),
+                batchInfo->baseVertex);
+    } else {
         glDrawArrays(GL_TRIANGLES, batchInfo->startIndex, batchInfo->numIndices);
-    shaderProgram->disable();
-
+    }
     glBindVertexArray(prev_vao);
-
-    Rigid3D::checkGLErrors(__FILE__, __LINE__);
 }
 
 //---------------------------------------------------------------------------------------
@@ -79,6 +135,25 @@ void Renderable::setShaderProgram(ShaderProgram & shaderProgram) {
     this->shaderProgram = const_cast<ShaderProgram *>(&shaderProgram);
 }
 
+//---------------------------------------------------------------------------------------
+const ShaderProgram * Renderable::getShaderProgram() const {
+    return shaderProgram;
+}
+
+//---------------------------------------------------------------------------------------
+const BatchInfo * Renderable::getBatchInfo() const {
+    return batchInfo;
+}
+
+//---------------------------------------------------------------------------------------
+/**
+ * @return the vertex array object this Renderable is drawn with, or 0 if none is
+ * set.
+ */
+GLuint Renderable::getVao() const {
+    return (vao == nullptr) ? 0 : *vao;
+}
+
 //---------------------------------------------------------------------------------------
 void Renderable::setPosition(const vec3 & position) {
     modelTransform.setPosition(position);
@@ -94,6 +169,50 @@ void Renderable::setScale(const vec3 & scale) {
     modelTransform.setScale(scale);
 }
 
+//---------------------------------------------------------------------------------------
+vec3 Renderable::getPosition() const {
+    return modelTransform.getPosition();
+}
+
+//---------------------------------------------------------------------------------------
+quat Renderable::getPose() const {
+    return modelTransform.getPose();
+}
+
+//---------------------------------------------------------------------------------------
+vec3 Renderable::getScale() const {
+    return modelTransform.getScale();
+}
+
+//---------------------------------------------------------------------------------------
+mat4 Renderable::getModelMatrix() const {
+    return modelTransform.getModelMatrix();
+}
+
+//---------------------------------------------------------------------------------------
+/**
+ * Sets the model space bounds of this Renderable's mesh, such as those returned by
+ * \c MeshConsolidator::getBoundingBoxes().  Renderables without bounds are never
+ * culled.
+ */
+void Renderable::setBoundingBox(const AABB & modelSpaceBounds) {
+    boundingBox = modelSpaceBounds;
+    _hasBoundingBox = true;
+}
+
+//---------------------------------------------------------------------------------------
+bool Renderable::hasBoundingBox() const {
+    return _hasBoundingBox;
+}
+
+//---------------------------------------------------------------------------------------
+/**
+ * @return the world space AABB enclosing this Renderable's model space bounds.
+ */
+AABB Renderable::getWorldBoundingBox() const {
+    return boundingBox.getTransformed(modelTransform.getModelMatrix());
+}
+
 //---------------------------------------------------------------------------------------
 void Renderable::setEmissionLevels(const vec3 & emissionLevels) {
     material.emission = emissionLevels;
@@ -120,18 +239,8 @@ void Renderable::setShininessFactor(float shininessfactor) {
 }
 
 //---------------------------------------------------------------------------------------
-void Renderable::loadUniformData(const RenderContext & context) {
-    mat4 modelView = context.viewMatrix * modelTransform.getModelMatrix();
-
-    shaderProgram->setUniform("ModelViewMatrix", modelView);
-    shaderProgram->setUniform("ProjectionMatrix", context.projectionMatrix);
-    shaderProgram->setUniform("NormalMatrix", glm::transpose(glm::inverse(mat3(modelView))));
-
-    shaderProgram->setUniform("material.emission", material.emission);
-    shaderProgram->setUniform("material.Ka", material.Ka);
-    shaderProgram->setUniform("material.Kd", material.Kd);
-    shaderProgram->setUniform("material.Ks", material.Ks);
-    shaderProgram->setUniform("material.shininessFactor", material.shininessFactor);
+const MaterialProperties & Renderable::getMaterial() const {
+    return material;
 }
 
 
@@ -8,6 +8,7 @@
 #define RIGID3D_RENDERABLE_HPP_
 
 #include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
 #include <Rigid3D/Graphics/MaterialProperties.hpp>
 #include <Rigid3D/Graphics/ModelTransform.hpp>
 
@@ -16,6 +17,7 @@
 // Forward declarations
 namespace Rigid3D {
     struct BatchInfo;
+    class CommandList;
     class ShaderProgram;
 }
 
@@ -30,6 +32,26 @@ namespace Rigid3D {
         mat4 projectionMatrix;
     };
 
+    /**
+     * Locations of the uniforms a \c Renderable loads, resolved once per
+     * ShaderProgram so that commands can be recorded without querying OpenGL.
+     * Uniforms missing from the program have location -1.
+     */
+    struct RenderableUniformLocations {
+        int32 modelViewMatrix;
+        int32 projectionMatrix;
+        int32 normalMatrix;
+        int32 emission;
+        int32 Ka;
+        int32 Kd;
+        int32 Ks;
+        int32 shininessFactor;
+
+        RenderableUniformLocations();
+
+        explicit RenderableUniformLocations(const ShaderProgram & shaderProgram);
+    };
+
     /**
      * @brief Class for encapsulating the data required to render a mesh.
      *
@@ -67,19 +89,42 @@ namespace Rigid3D {
 
         void render(const RenderContext & context);
 
+        void record(CommandList & commandList,
+                    const RenderContext & context,
+                    const RenderableUniformLocations & uniformLocations) const;
+
+        void drawGeometry() const;
+
         void setShaderProgram(ShaderProgram & shaderProgram);
 
+        const ShaderProgram * getShaderProgram() const;
+
+        const BatchInfo * getBatchInfo() const;
+
+        GLuint getVao() const;
+
         // Model Transform Operations
         void setPosition(const vec3 & position);
         void setPose(const quat & pose);
         void setScale(const vec3 & scale);
 
+        vec3 getPosition() const;
+        quat getPose() const;
+        vec3 getScale() const;
+        mat4 getModelMatrix() const;
+
+        // Bounds used for culling
+        void setBoundingBox(const AABB & modelSpaceBounds);
+        bool hasBoundingBox() const;
+        AABB getWorldBoundingBox() const;
+
         // Material Properties
         void setEmissionLevels(const vec3 & emissionLevels);
         void setAmbientLevels(const vec3 & ambientLevels);
         void setDiffuseLevels(const vec3 & diffuseLevels);
         void setSpecularIntensity(float specular);
         void setShininessFactor(float shininessfactor);
+        const MaterialProperties & getMaterial() const;
 
     private:
         GLuint * vao;
@@ -87,9 +132,10 @@ namespace Rigid3D {
         BatchInfo * batchInfo;
         MaterialProperties material;
         ModelTransform modelTransform;
+        AABB boundingBox;
+        bool _hasBoundingBox;
 
         void init();
-        void loadUniformData(const RenderContext & context);
 
     };
 }
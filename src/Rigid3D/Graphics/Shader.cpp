@@ -3,12 +3,12 @@
 #include "GlErrorCheck.hpp"
 #include "glcorearb.h"
 
-#include <fstream>
+#include <Rigid3D/Common/VirtualFileSystem.hpp>
+
 #include <sstream>
 
 namespace Rigid3D {
 
-using std::ifstream;
 using std::stringstream;
 using std::endl;
 
@@ -52,29 +52,25 @@ void Shader::recompile() {
 
 //------------------------------------------------------------------------------------
 void Shader::extractSourceCode(string & shaderSource, const char * filePathName) const {
-    ifstream file;
-
-    file.open(filePathName);
-    if (!file) {
+    std::vector<uint8> file;
+    if (!VirtualFileSystem::getDefault().tryRead(filePathName, file)) {
         stringstream strStream;
         strStream << "Error -- Failed to open file: " << filePathName << endl;
         throw ShaderException(strStream.str());
     }
 
-    stringstream strBuffer;
-    string str;
-
-    while(file.good()) {
-        getline(file, str, '\r');
-        strBuffer << str;
+    // Drop carriage returns.
+    shaderSource.clear();
+    shaderSource.reserve(file.size() + 1);
+    for (uint8 c : file) {
+        if (c != '\r') {
+            shaderSource += char(c);
+        }
     }
-    file.close();
 
     // Append null terminator, so OpenGL can locate the end of string automatically
     // when calling glShaderSource(...).
-    strBuffer << '\0';
-
-    shaderSource = strBuffer.str();
+    shaderSource += '\0';
 }
 
 //------------------------------------------------------------------------------------
@@ -1,12 +1,11 @@
 #include "ShaderProgram.hpp"
 
+#include <Rigid3D/Common/VirtualFileSystem.hpp>
 #include <Rigid3D/Graphics/ShaderException.hpp>
 #include <Rigid3D/Graphics/GlErrorCheck.hpp>
 
 #include <glm/gtc/type_ptr.hpp>
 
-#include <fstream>
-
 #include <iostream>
 
 #include <sstream>
@@ -15,7 +14,6 @@
 namespace Rigid3D {
 
 using glm::value_ptr;
-using std::ifstream;
 using std::cerr;
 using std::endl;
 using std::stringstream;
@@ -67,6 +65,18 @@ void ShaderProgram::attachGeometryShader(const char * filePath) {
     extractSourceCodeAndCompile(geometryShader);
 }
 
+//------------------------------------------------------------------------------------
+/**
+ * @note Compute shaders require an OpenGL 4.3 context, and cannot be linked
+ * together with any other shader stage.
+ */
+void ShaderProgram::attachComputeShader(const char * filePath) {
+    computeShader.shaderObject = createShader(GL_COMPUTE_SHADER);
+    computeShader.filePath = filePath;
+
+    extractSourceCodeAndCompile(computeShader);
+}
+
 //------------------------------------------------------------------------------------
 void ShaderProgram::extractSourceCodeAndCompile(const Shader & shader) {
     string shaderSourceCode;
@@ -80,35 +90,35 @@ void ShaderProgram::recompileShaders() {
     extractSourceCodeAndCompile(vertexShader);
     extractSourceCodeAndCompile(fragmentShader);
     extractSourceCodeAndCompile(geometryShader);
+
+    if (computeShader.shaderObject != 0) {
+        extractSourceCodeAndCompile(computeShader);
+    }
 }
 
 //------------------------------------------------------------------------------------
 /**
 * Extracts source code from file located at 'filePath' and places contents into
-* 'shaderSource'.
+* 'shaderSource'.  The file is read through VirtualFileSystem::getDefault().
 */
 void ShaderProgram::extractSourceCode(string & shaderSource, const string & filePath) {
-    ifstream file;
-
-    file.open(filePath.c_str());
-    if (!file) {
+    std::vector<uint8> file;
+    if (!VirtualFileSystem::getDefault().tryRead(filePath.c_str(), file)) {
         stringstream strStream;
         strStream << "Error -- Failed to open file: " << filePath << endl;
         throw ShaderException(strStream.str());
     }
 
-    stringstream strBuffer;
-    string str;
-
-    while(file.good()) {
-        getline(file, str, '\r');
-        strBuffer << str;
+    // Drop carriage returns.
+    shaderSource.clear();
+    shaderSource.reserve(file.size() + 1);
+    for (uint8 c : file) {
+        if (c != '\r') {
+            shaderSource += char(c);
+        }
     }
-    file.close();
 
-    strBuffer << '\0';  // Append null terminator.
-
-    shaderSource = strBuffer.str();
+    shaderSource += '\0';  // Append null terminator.
 }
 
 //------------------------------------------------------------------------------------
@@ -131,6 +141,10 @@ void ShaderProgram::link() {
         glAttachShader(programObject, geometryShader.shaderObject);
     }
 
+    if(computeShader.shaderObject != 0) {
+        glAttachShader(programObject, computeShader.shaderObject);
+    }
+
     glLinkProgram(programObject);
     checkLinkStatus();
 
@@ -147,6 +161,7 @@ void ShaderProgram::deleteShaders() {
     glDeleteShader(vertexShader.shaderObject);
     glDeleteShader(fragmentShader.shaderObject);
     glDeleteShader(geometryShader.shaderObject);
+    glDeleteShader(computeShader.shaderObject);
     glDeleteProgram(programObject);
 }
 
@@ -21,6 +21,7 @@ namespace Rigid3D {
         void attachVertexShader(const char * filePath);
         void attachFragmentShader(const char * filePath);
         void attachGeometryShader(const char * filePath);
+        void attachComputeShader(const char * filePath);
 
         void link();
 
@@ -76,6 +77,7 @@ namespace Rigid3D {
         Shader vertexShader;
         Shader fragmentShader;
         Shader geometryShader;
+        Shader computeShader;
 
         GLuint programObject;
         GLuint prevProgramObject;
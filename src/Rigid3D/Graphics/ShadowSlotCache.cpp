@@ -0,0 +1,100 @@
+#include "ShadowSlotCache.hpp"
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+ShadowSlotCache::ShadowSlotCache(unsigned int numSlots)
+    : frame(1) {
+
+    Slot emptySlot = {0, 0, 0, false};
+    slots.assign(numSlots, emptySlot);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Starts a new frame.  Slots acquired in previous frames become candidates for
+ * reassignment.
+ */
+void ShadowSlotCache::beginFrame() {
+    ++frame;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Returns the slot assigned to 'lightId', assigning one if needed.
+ *
+ * @param lightId - unique light identifier.
+ * @param signature - hash of the light's shadow casting state.
+ * @param needsUpdate - set to true if the slot contents must be re-rendered.
+ *
+ * @return the slot index, or -1 if every slot is already in use this frame.
+ */
+int ShadowSlotCache::acquire(unsigned int lightId, uint64 signature, bool & needsUpdate) {
+    auto iter = lightToSlot.find(lightId);
+    if (iter != lightToSlot.end()) {
+        Slot & slot = slots[iter->second];
+        needsUpdate = (slot.signature != signature);
+        slot.signature = signature;
+        slot.lastUsedFrame = frame;
+        return int(iter->second);
+    }
+
+    // Prefer an empty slot, otherwise the least recently used one.
+    int best = -1;
+    for (unsigned int i = 0; i < slots.size(); ++i) {
+        const Slot & slot = slots[i];
+        if (!slot.occupied) {
+            best = int(i);
+            break;
+        }
+        if (slot.lastUsedFrame < frame &&
+                (best < 0 || slot.lastUsedFrame < slots[best].lastUsedFrame)) {
+            best = int(i);
+        }
+    }
+
+    needsUpdate = false;
+    if (best < 0) {
+        return -1;
+    }
+
+    Slot & slot = slots[best];
+    if (slot.occupied) {
+        lightToSlot.erase(slot.lightId);
+    }
+    slot.lightId = lightId;
+    slot.signature = signature;
+    slot.lastUsedFrame = frame;
+    slot.occupied = true;
+    lightToSlot[lightId] = unsigned(best);
+
+    needsUpdate = true;
+    return best;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Forces the next \c acquire() for 'lightId' to report that an update is needed.
+ */
+void ShadowSlotCache::invalidate(unsigned int lightId) {
+    auto iter = lightToSlot.find(lightId);
+    if (iter != lightToSlot.end()) {
+        slots[iter->second].occupied = false;
+        lightToSlot.erase(iter);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void ShadowSlotCache::clear() {
+    for (Slot & slot : slots) {
+        slot.occupied = false;
+    }
+    lightToSlot.clear();
+}
+
+//----------------------------------------------------------------------------------------
+unsigned int ShadowSlotCache::getNumSlots() const {
+    return (unsigned int)slots.size();
+}
+
+} // end namespace Rigid3D
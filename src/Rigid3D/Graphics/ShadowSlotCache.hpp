@@ -0,0 +1,63 @@
+/**
+ * @brief ShadowSlotCache
+ */
+
+#ifndef RIGID3D_SHADOW_SLOT_CACHE_HPP_
+#define RIGID3D_SHADOW_SLOT_CACHE_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace Rigid3D {
+
+    /**
+     * @brief Assigns lights to a fixed number of shadow map slots, keeping the
+     * contents of slots whose lights have not changed.
+     *
+     * Each light is identified by an id and described by a signature, a hash of
+     * everything its shadow map depends on.  A light keeps its slot between frames
+     * and only needs re-rendering when its signature changes.  When all slots are
+     * taken, the least recently used slot not requested in the current frame is
+     * reassigned.
+     *
+     * \code{.cpp}
+     *  cache.beginFrame();
+     *  bool needsUpdate;
+     *  int slot = cache.acquire(lightId, signature, needsUpdate);
+     *  if (slot >= 0 && needsUpdate) {
+     *      // Render shadow map for lightId into 'slot'.
+     *  }
+     * \endcode
+     */
+    class ShadowSlotCache {
+    public:
+        explicit ShadowSlotCache(unsigned int numSlots);
+
+        void beginFrame();
+
+        int acquire(unsigned int lightId, uint64 signature, bool & needsUpdate);
+
+        void invalidate(unsigned int lightId);
+
+        void clear();
+
+        unsigned int getNumSlots() const;
+
+    private:
+        struct Slot {
+            unsigned int lightId;
+            uint64 signature;
+            uint64 lastUsedFrame;
+            bool occupied;
+        };
+
+        std::vector<Slot> slots;
+        std::unordered_map<unsigned int, unsigned int> lightToSlot;
+        uint64 frame;
+    };
+
+}
+
+#endif /* RIGID3D_SHADOW_SLOT_CACHE_HPP_ */
@@ -0,0 +1,148 @@
+#include "SkinnedMesh.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <sstream>
+#include <vector>
+
+namespace Rigid3D {
+
+namespace {
+
+    struct Vertex {
+        vec3 position;
+        vec3 normal;
+        uint8 boneIndices[4];
+        uint8 boneWeights[4];
+    };
+
+    //------------------------------------------------------------------------------------
+    // Quantizes 'weights' to bytes that still sum to 255, giving the rounding error
+    // to the largest weight.
+    void quantizeWeights(const vec4 & weights, uint8 * result) {
+        int sum = 0;
+        int largest = 0;
+        for (int i = 0; i < 4; ++i) {
+            int weight = int(std::floor(glm::clamp(weights[i], 0.0f, 1.0f) * 255.0f + 0.5f));
+            result[i] = uint8(weight);
+            sum += weight;
+            if (weights[i] > weights[largest]) {
+                largest = i;
+            }
+        }
+        if (sum > 0) {
+            result[largest] = uint8(glm::clamp(int(result[largest]) + 255 - sum, 0, 255));
+        }
+    }
+
+} // end anonymous namespace
+
+const GLuint SkinnedMesh::PositionLocation;
+const GLuint SkinnedMesh::NormalLocation;
+const GLuint SkinnedMesh::BoneIndexLocation;
+const GLuint SkinnedMesh::BoneWeightLocation;
+const uint32 SkinnedMesh::BytesPerVertex;
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param mesh - triangle list with normals and bone weights.  Only needed during
+ * construction.
+ *
+ * @note Requires a current OpenGL context.
+ */
+SkinnedMesh::SkinnedMesh(const Mesh & mesh)
+    : numVertices(0),
+      vao(0),
+      vertexBuffer(0) {
+
+    if (!mesh.hasBoneWeights() || mesh.getNumVertexNormals() != mesh.getNumVertexPositions()) {
+        std::stringstream errorMessage;
+        errorMessage << "Mesh needs a normal and bone weights per vertex"
+                     << " within method SkinnedMesh::SkinnedMesh";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const std::vector<vec3> & positions = *mesh.getVertexPositionVector();
+    const std::vector<vec3> & normals = *mesh.getVertexNormalVector();
+    const std::vector<uint8> & boneIndices = *mesh.getBoneIndexVector();
+    const std::vector<vec4> & boneWeights = *mesh.getBoneWeightVector();
+
+    numVertices = uint32(positions.size());
+    std::vector<Vertex> vertices(numVertices);
+    for (uint32 i = 0; i < numVertices; ++i) {
+        Vertex & vertex = vertices[i];
+        vertex.position = positions[i];
+        vertex.normal = normals[i];
+        for (int j = 0; j < 4; ++j) {
+            vertex.boneIndices[j] = boneIndices[i * Mesh::MaxBonesPerVertex + j];
+        }
+        quantizeWeights(boneWeights[i], vertex.boneWeights);
+    }
+
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(),
+            GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(PositionLocation);
+    glVertexAttribPointer(PositionLocation, 3, GL_FLOAT, GL_FALSE, BytesPerVertex,
+            reinterpret_cast<const void *>(offsetof(Vertex, position)));
+    glEnableVertexAttribArray(NormalLocation);
+    glVertexAttribPointer(NormalLocation, 3, GL_FLOAT, GL_FALSE, BytesPerVertex,
+            reinterpret_cast<const void *>(offsetof(Vertex, normal)));
+    glEnableVertexAttribArray(BoneIndexLocation);
+    glVertexAttribIPointer(BoneIndexLocation, 4, GL_UNSIGNED_BYTE, BytesPerVertex,
+            reinterpret_cast<const void *>(offsetof(Vertex, boneIndices)));
+    glEnableVertexAttribArray(BoneWeightLocation);
+    glVertexAttribPointer(BoneWeightLocation, 4, GL_UNSIGNED_BYTE, GL_TRUE, BytesPerVertex,
+            reinterpret_cast<const void *>(offsetof(Vertex, boneWeights)));
+
+    glBindVertexArray(GLuint(prevVao));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+SkinnedMesh::~SkinnedMesh() {
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteVertexArrays(1, &vao);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws the mesh with the currently enabled ShaderProgram, skinned by the
+ * \c SkinningPalette range currently bound.
+ */
+void SkinnedMesh::draw() const {
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, GLsizei(numVertices));
+    glBindVertexArray(GLuint(prevVao));
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint SkinnedMesh::getVertexArray() const {
+    return vao;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 SkinnedMesh::getNumVertices() const {
+    return numVertices;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,64 @@
+/**
+ * @brief SkinnedMesh
+ */
+
+#ifndef RIGID3D_SKINNED_MESH_HPP_
+#define RIGID3D_SKINNED_MESH_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+// Forward declarations
+namespace Rigid3D {
+    class Mesh;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Vertex buffer of a \c Mesh with bone weights, skinned on the GPU by
+     * SkinnedMesh.vert.
+     *
+     * Vertices are interleaved in 32 bytes: float position and normal, four 8-bit
+     * joint indices and four 8-bit normalized weights.  The joint matrices come
+     * from the range of a \c SkinningPalette bound before \c draw, so drawing many
+     * characters costs one buffer range bind and one draw call each.
+     *
+     * The caller sets the same matrices as for PerFragLighting.vert:
+     * # uniform mat4 ModelViewMatrix
+     * # uniform mat3 NormalMatrix
+     * # uniform mat4 ProjectionMatrix
+     */
+    class SkinnedMesh {
+    public:
+        explicit SkinnedMesh(const Mesh & mesh);
+
+        ~SkinnedMesh();
+
+        void draw() const;
+
+        GLuint getVertexArray() const;
+
+        uint32 getNumVertices() const;
+
+        static const GLuint PositionLocation = 0;
+        static const GLuint NormalLocation = 1;
+        static const GLuint BoneIndexLocation = 2;
+        static const GLuint BoneWeightLocation = 3;
+
+        static const uint32 BytesPerVertex = 32;
+
+    private:
+        // Non-copyable, owns GL buffer objects.
+        SkinnedMesh(const SkinnedMesh &);
+        SkinnedMesh & operator = (const SkinnedMesh &);
+
+        uint32 numVertices;
+        GLuint vao;
+        GLuint vertexBuffer;
+    };
+
+}
+
+#endif /* RIGID3D_SKINNED_MESH_HPP_ */
@@ -0,0 +1,143 @@
+#include "SkinningPalette.hpp"
+
+#include <Rigid3D/Animation/Skeleton.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace Rigid3D {
+
+const GLuint SkinningPalette::BindingPoint = 0;
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param maxMatrices - matrices the palette holds per frame, counting each range
+ * rounded up to the uniform buffer offset alignment.
+ *
+ * @note Requires a current OpenGL context.
+ */
+SkinningPalette::SkinningPalette(uint32 maxMatrices)
+    : maxMatrices(maxMatrices),
+      buffer(0),
+      alignment(0),
+      capacity(0),
+      numMatrices(0) {
+
+    // The alignment is a power of two, so ranges stay whole matrices apart.
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    alignment = std::max(GLintptr(offsetAlignment), GLintptr(sizeof(mat4)));
+
+    // The block in SkinnedMesh.vert always spans MaxJoints matrices, so binding
+    // the last range may reach that far past the matrices themselves.
+    capacity = GLsizeiptr(maxMatrices + Skeleton::MaxJoints) * sizeof(mat4);
+    staging.reserve(maxMatrices);
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+SkinningPalette::~SkinningPalette() {
+    glDeleteBuffers(1, &buffer);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Appends one character's skinning matrices.
+ *
+ * @return byte offset of the range, to pass to \c bind.
+ */
+GLintptr SkinningPalette::add(const mat4 * matrices, uint32 numMatrices) {
+    const size_t matricesPerAlignment = size_t(alignment) / sizeof(mat4);
+    const size_t first = (staging.size() + matricesPerAlignment - 1) /
+            matricesPerAlignment * matricesPerAlignment;
+
+    if (numMatrices > Skeleton::MaxJoints || first + numMatrices > maxMatrices) {
+        std::stringstream errorMessage;
+        errorMessage << "Cannot add " << numMatrices << " matrices to a palette holding "
+                     << staging.size() << " of " << maxMatrices
+                     << " within method SkinningPalette::add";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    staging.resize(first);
+    staging.insert(staging.end(), matrices, matrices + numMatrices);
+    this->numMatrices += numMatrices;
+
+    return GLintptr(first * sizeof(mat4));
+}
+
+//----------------------------------------------------------------------------------------
+void SkinningPalette::clear() {
+    staging.clear();
+    numMatrices = 0;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies every range added since the last \c clear to the uniform buffer.  The
+ * previous contents are orphaned, so draws still reading last frame's palette do
+ * not stall the upload.
+ */
+void SkinningPalette::upload() {
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+    if (!staging.empty()) {
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, staging.size() * sizeof(mat4),
+                staging.data());
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Binds the range at 'offset', as returned by \c add, to \c BindingPoint.
+ */
+void SkinningPalette::bind(GLintptr offset) const {
+    glBindBufferRange(GL_UNIFORM_BUFFER, BindingPoint, buffer, offset,
+            GLsizeiptr(Skeleton::MaxJoints) * sizeof(mat4));
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of matrices added since the last \c clear, excluding padding.
+ */
+uint32 SkinningPalette::getNumMatrices() const {
+    return numMatrices;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint SkinningPalette::getBuffer() const {
+    return buffer;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Points the JointPalette block of 'shaderProgram' at \c BindingPoint.  Needed
+ * once after linking.
+ */
+void SkinningPalette::bindUniformBlock(const ShaderProgram & shaderProgram) {
+    GLuint program = shaderProgram.getProgramObject();
+    GLuint blockIndex = glGetUniformBlockIndex(program, "JointPalette");
+    if (blockIndex == GL_INVALID_INDEX) {
+        std::stringstream errorMessage;
+        errorMessage << "Shader program has no JointPalette uniform block"
+                     << " within method SkinningPalette::bindUniformBlock";
+        throw Rigid3DException(errorMessage.str());
+    }
+    glUniformBlockBinding(program, blockIndex, BindingPoint);
+
+    CHECK_GL_ERRORS;
+}
+
+} // end namespace Rigid3D
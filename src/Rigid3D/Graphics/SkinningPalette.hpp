@@ -0,0 +1,90 @@
+/**
+ * @brief SkinningPalette
+ */
+
+#ifndef RIGID3D_SKINNING_PALETTE_HPP_
+#define RIGID3D_SKINNING_PALETTE_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Skinning matrices of every character drawn in a frame, packed into one
+     * uniform buffer that is uploaded once per frame.
+     *
+     * Each character reserves a range with \c add, and binds it with \c bind
+     * before its draw call.  Ranges start at multiples of
+     * GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, so binding one only changes an offset
+     * into the same buffer.
+     *
+     * \code{.cpp}
+     *  palette.clear();
+     *  for (Character & character : characters) {
+     *      character.paletteOffset = palette.add(character.matrices.data(),
+     *              skeleton.getNumJoints());
+     *  }
+     *  palette.upload();
+     *
+     *  for (Character & character : characters) {
+     *      palette.bind(character.paletteOffset);
+     *      character.mesh.draw();
+     *  }
+     * \endcode
+     *
+     * Shaders read the palette through the block declared in SkinnedMesh.vert:
+     * # layout (std140) uniform JointPalette { mat4 joints[128]; };
+     *
+     * A uniform buffer is a choice rather than a limit of the GL version, other
+     * parts of the library already use GL 4.3 shader storage buffers.  128 joints
+     * fit the 16 KB minimum uniform block size, and the same few matrices are read
+     * by every vertex of a draw, which suits uniform storage.
+     */
+    class SkinningPalette {
+    public:
+        explicit SkinningPalette(uint32 maxMatrices);
+
+        ~SkinningPalette();
+
+        GLintptr add(const mat4 * matrices, uint32 numMatrices);
+
+        void clear();
+
+        void upload();
+
+        void bind(GLintptr offset) const;
+
+        uint32 getNumMatrices() const;
+
+        GLuint getBuffer() const;
+
+        static void bindUniformBlock(const ShaderProgram & shaderProgram);
+
+        static const GLuint BindingPoint;
+
+    private:
+        // Non-copyable, owns a GL buffer object.
+        SkinningPalette(const SkinningPalette &);
+        SkinningPalette & operator = (const SkinningPalette &);
+
+        uint32 maxMatrices;
+        GLuint buffer;
+        GLintptr alignment;
+        GLsizeiptr capacity;
+        uint32 numMatrices;
+
+        std::vector<mat4> staging;
+    };
+
+}
+
+#endif /* RIGID3D_SKINNING_PALETTE_HPP_ */
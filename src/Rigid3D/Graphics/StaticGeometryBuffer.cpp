@@ -0,0 +1,364 @@
+#include "StaticGeometryBuffer.hpp"
+
+#include <Rigid3D/Common/ContentHash.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace Rigid3D {
+
+namespace {
+
+    struct Vertex {
+        vec3 position;
+        vec3 normal;
+    };
+
+    struct VertexHash {
+        size_t operator () (const Vertex & vertex) const {
+            size_t hash = 0;
+            for (int i = 0; i < 3; ++i) {
+                hash = hash * 31 + std::hash<float>()(vertex.position[i]);
+                hash = hash * 31 + std::hash<float>()(vertex.normal[i]);
+            }
+            return hash;
+        }
+    };
+
+    struct VertexEqual {
+        bool operator () (const Vertex & a, const Vertex & b) const {
+            return a.position == b.position && a.normal == b.normal;
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+    // Merges identical position and normal pairs of a triangle soup into indexed
+    // vertices.
+    void weldVertices(const Mesh & mesh, std::vector<vec3> & positions,
+                      std::vector<vec3> & normals, std::vector<uint32> & indices) {
+        const std::vector<vec3> & meshPositions = *mesh.getVertexPositionVector();
+        const std::vector<vec3> & meshNormals = *mesh.getVertexNormalVector();
+
+        std::unordered_map<Vertex, uint32, VertexHash, VertexEqual> vertexIndices;
+        vertexIndices.reserve(meshPositions.size());
+        indices.reserve(meshPositions.size());
+
+        for (size_t i = 0; i < meshPositions.size(); ++i) {
+            Vertex vertex;
+            vertex.position = meshPositions[i];
+            vertex.normal = (i < meshNormals.size()) ? meshNormals[i] : vec3(0.0f);
+
+            auto inserted = vertexIndices.insert(std::make_pair(vertex,
+                    uint32(positions.size())));
+            if (inserted.second) {
+                positions.push_back(vertex.position);
+                normals.push_back(vertex.normal);
+            }
+            indices.push_back(inserted.first->second);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // True if 'numBytes' of 'buffer' starting at 'offset' equal 'data'.  Reads the
+    // range back, which waits for pending writes to it.
+    bool bufferHolds(GLuint buffer, GLintptr offset, size_t numBytes, const void * data) {
+        std::vector<unsigned char> contents(numBytes);
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, offset, GLsizeiptr(numBytes),
+                contents.data());
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+        return std::memcmp(contents.data(), data, numBytes) == 0;
+    }
+
+} // end anonymous namespace
+
+const GLuint StaticGeometryBuffer::PositionLocation;
+const GLuint StaticGeometryBuffer::NormalLocation;
+const uint32 StaticGeometryBuffer::BytesPerVertex;
+
+//----------------------------------------------------------------------------------------
+StaticGeometryBuffer::Stats::Stats()
+    : numSharedRanges(0),
+      numSharedReferences(0),
+      immutableStorage(false) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param maxVertices - capacity of the vertex buffer, in vertices.
+ * @param maxIndices - capacity of the index buffer, in indices.
+ *
+ * @note Requires a current OpenGL context.
+ */
+StaticGeometryBuffer::StaticGeometryBuffer(uint32 maxVertices, uint32 maxIndices)
+    : vertexAllocator(maxVertices),
+      indexAllocator(maxIndices),
+      vao(0),
+      vertexBuffer(0),
+      indexBuffer(0),
+      immutableStorage(false) {
+
+    const GLsizeiptr numVertexBytes = GLsizeiptr(maxVertices) * BytesPerVertex;
+    const GLsizeiptr numIndexBytes = GLsizeiptr(maxIndices) * sizeof(uint32);
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &indexBuffer);
+
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+#ifdef GL_VERSION_4_4
+    GLint majorVersion = 0;
+    GLint minorVersion = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+    immutableStorage = (majorVersion > 4) || (majorVersion == 4 && minorVersion >= 4);
+
+    if (immutableStorage) {
+        glBufferStorage(GL_ARRAY_BUFFER, numVertexBytes, NULL, GL_DYNAMIC_STORAGE_BIT);
+        glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, numIndexBytes, NULL,
+                GL_DYNAMIC_STORAGE_BIT);
+    } else
+#endif
+    {
+        glBufferData(GL_ARRAY_BUFFER, numVertexBytes, NULL, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndexBytes, NULL, GL_STATIC_DRAW);
+    }
+
+    glEnableVertexAttribArray(PositionLocation);
+    glVertexAttribPointer(PositionLocation, 3, GL_FLOAT, GL_FALSE, BytesPerVertex,
+            reinterpret_cast<const void *>(0));
+    glEnableVertexAttribArray(NormalLocation);
+    glVertexAttribPointer(NormalLocation, 3, GL_FLOAT, GL_FALSE, BytesPerVertex,
+            reinterpret_cast<const void *>(3 * sizeof(float)));
+
+    // The element array binding is part of the vertex array state, so only the
+    // array buffer binding is restored.
+    glBindVertexArray(GLuint(prevVao));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+StaticGeometryBuffer::~StaticGeometryBuffer() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies the triangles of 'mesh' into the shared buffers, merging identical vertices
+ * so that the mesh is drawn indexed.
+ *
+ * @return false if either buffer lacks a large enough free range, in which case
+ * nothing is allocated.
+ */
+bool StaticGeometryBuffer::allocate(const Mesh & mesh, Allocation & allocation) {
+    std::vector<vec3> positions;
+    std::vector<vec3> normals;
+    std::vector<uint32> indices;
+    weldVertices(mesh, positions, normals, indices);
+
+    return allocate(positions.data(), normals.data(), uint32(positions.size()),
+            indices.data(), uint32(indices.size()), allocation);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Copies already indexed geometry into the shared buffers.  Geometry identical to
+ * a live allocation is not copied again, and instead shares its ranges.
+ *
+ * @param normals - per vertex normals, or NULL for zero normals.
+ * @param indices - triangle list indices, relative to the first of 'positions'.
+ *
+ * @return false if either buffer lacks a large enough free range, in which case
+ * nothing is allocated.
+ */
+bool StaticGeometryBuffer::allocate(const vec3 * positions,
+                                    const vec3 * normals,
+                                    uint32 numVertices,
+                                    const uint32 * indices,
+                                    uint32 numIndices,
+                                    Allocation & allocation) {
+    for (uint32 i = 0; i < numIndices; ++i) {
+        if (indices[i] >= numVertices) {
+            std::stringstream errorMessage;
+            errorMessage << "Index " << indices[i] << " out of range of " << numVertices
+                         << " vertices within method StaticGeometryBuffer::allocate";
+            throw Rigid3DException(errorMessage.str());
+        }
+    }
+
+    std::vector<Vertex> vertices(numVertices);
+    for (uint32 i = 0; i < numVertices; ++i) {
+        vertices[i].position = positions[i];
+        vertices[i].normal = (normals != NULL) ? normals[i] : vec3(0.0f);
+    }
+
+    // Candidates are found by content hash, then confirmed against the GPU copy so
+    // that no CPU copy of shared geometry is kept.
+    uint64 hash = ContentHash::hash(positions, size_t(numVertices) * sizeof(vec3));
+    if (normals != NULL) {
+        hash = ContentHash::hash(normals, size_t(numVertices) * sizeof(vec3), hash);
+    }
+    hash = ContentHash::hash(indices, size_t(numIndices) * sizeof(uint32), hash);
+
+    auto shared = sharedRanges.find(hash);
+    if (numIndices > 0 && shared != sharedRanges.end() &&
+            shared->second.numVertices == numVertices &&
+            shared->second.numIndices == numIndices &&
+            bufferHolds(vertexBuffer,
+                    GLintptr(shared->second.vertices.offset) * BytesPerVertex,
+                    size_t(numVertices) * BytesPerVertex, vertices.data()) &&
+            bufferHolds(indexBuffer,
+                    GLintptr(shared->second.indices.offset) * sizeof(uint32),
+                    size_t(numIndices) * sizeof(uint32), indices)) {
+        ++shared->second.refCount;
+        allocation.vertices = shared->second.vertices;
+        allocation.indices = shared->second.indices;
+        allocation.batchInfo = BatchInfo(allocation.indices.offset, numIndices,
+                GLint(allocation.vertices.offset));
+        return true;
+    }
+
+    TlsfAllocator::Allocation vertexRange;
+    TlsfAllocator::Allocation indexRange;
+    if (!vertexAllocator.allocate(numVertices, vertexRange)) {
+        return false;
+    }
+    if (!indexAllocator.allocate(numIndices, indexRange)) {
+        vertexAllocator.free(vertexRange);
+        return false;
+    }
+
+    if (numVertices > 0) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(vertexRange.offset) * BytesPerVertex,
+                GLsizeiptr(numVertices) * BytesPerVertex, vertices.data());
+    }
+    if (numIndices > 0) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, GLintptr(indexRange.offset) * sizeof(uint32),
+                GLsizeiptr(numIndices) * sizeof(uint32), indices);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    allocation.vertices = vertexRange;
+    allocation.indices = indexRange;
+    allocation.batchInfo = BatchInfo(indexRange.offset, numIndices,
+            GLint(vertexRange.offset));
+
+    // On a hash collision with different contents the earlier ranges stay shared.
+    if (numIndices > 0 && shared == sharedRanges.end()) {
+        SharedRange & range = sharedRanges[hash];
+        range.vertices = vertexRange;
+        range.indices = indexRange;
+        range.numVertices = numVertices;
+        range.numIndices = numIndices;
+        range.refCount = 1;
+        hashByIndexOffset[indexRange.offset] = hash;
+    }
+
+    CHECK_GL_ERRORS;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Returns the ranges of 'allocation' for reuse, once every allocation sharing them
+ * has been freed.  The caller must ensure the GPU has finished drawing from them
+ * before they are overwritten by a later allocation.
+ *
+ * 'allocation' is reset to empty, so freeing it again does nothing.
+ */
+void StaticGeometryBuffer::free(Allocation & allocation) {
+    if (allocation.indices.block == TlsfAllocator::InvalidBlock &&
+            allocation.vertices.block == TlsfAllocator::InvalidBlock) {
+        allocation = Allocation();
+        return;
+    }
+
+    auto hash = hashByIndexOffset.find(allocation.indices.offset);
+    if (hash != hashByIndexOffset.end() && allocation.batchInfo.numIndices > 0) {
+        auto shared = sharedRanges.find(hash->second);
+        if (--shared->second.refCount > 0) {
+            allocation = Allocation();
+            return;
+        }
+        sharedRanges.erase(shared);
+        hashByIndexOffset.erase(hash);
+    }
+
+    vertexAllocator.free(allocation.vertices);
+    indexAllocator.free(allocation.indices);
+    allocation = Allocation();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the vertex array object binding the shared buffers, by reference so that
+ * its address may be given to \c Renderable.
+ */
+const GLuint & StaticGeometryBuffer::getVertexArray() const {
+    return vao;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint StaticGeometryBuffer::getVertexBuffer() const {
+    return vertexBuffer;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint StaticGeometryBuffer::getIndexBuffer() const {
+    return indexBuffer;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws 'allocation' with whichever ShaderProgram is currently enabled.
+ */
+void StaticGeometryBuffer::draw(const Allocation & allocation, GLenum mode) const {
+    const BatchInfo & batchInfo = allocation.batchInfo;
+    if (batchInfo.numIndices == 0) {
+        return;
+    }
+
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+    glBindVertexArray(vao);
+    glDrawElementsBaseVertex(mode, batchInfo.numIndices, GL_UNSIGNED_INT,
+            reinterpret_cast<const void *>(batchInfo.startIndex * sizeof(GLuint)),
+            batchInfo.baseVertex);
+    glBindVertexArray(GLuint(prevVao));
+}
+
+//----------------------------------------------------------------------------------------
+StaticGeometryBuffer::Stats StaticGeometryBuffer::getStats() const {
+    Stats stats;
+    stats.vertexStats = vertexAllocator.getStats();
+    stats.indexStats = indexAllocator.getStats();
+    stats.numSharedRanges = uint32(sharedRanges.size());
+    for (const auto & shared : sharedRanges) {
+        stats.numSharedReferences += shared.second.refCount - 1;
+    }
+    stats.immutableStorage = immutableStorage;
+
+    return stats;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,129 @@
+/**
+ * @brief StaticGeometryBuffer
+ */
+
+#ifndef RIGID3D_STATIC_GEOMETRY_BUFFER_HPP_
+#define RIGID3D_STATIC_GEOMETRY_BUFFER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Common/TlsfAllocator.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <unordered_map>
+
+namespace Rigid3D {
+
+    // Forward declaration.
+    class Mesh;
+
+    /**
+     * @brief One vertex buffer and one index buffer shared by all static meshes,
+     * with ranges of each suballocated by a \c TlsfAllocator.
+     *
+     * Each mesh is given a range of vertices and a range of indices, and is drawn
+     * with glDrawElementsBaseVertex using the indexed \c BatchInfo of its
+     * allocation.  Since every mesh lives in the same two buffers, all of them are
+     * drawn with one vertex array object, whatever order they were loaded in, and
+     * switching between meshes never rebinds a buffer.  Freed ranges are merged and
+     * reused by later allocations.
+     *
+     * Allocating geometry identical to a live allocation, such as the same prop
+     * loaded under another name, copies nothing and returns the same ranges with
+     * a reference count.  Candidates are found by content hash and confirmed by
+     * reading the shared ranges back from the GPU, so no CPU copy is kept.  Each
+     * allocation is freed as usual, and the ranges are released with the last of
+     * them.
+     *
+     * Vertices are interleaved positions and normals, bound to attribute locations
+     * \c PositionLocation and \c NormalLocation.  Indices are 32 bit and relative to
+     * the mesh's first vertex.
+     *
+     * Both buffers are allocated once at their full capacity.  With OpenGL 4.4 or
+     * later their storage is immutable, created with glBufferStorage, otherwise it is
+     * created with glBufferData and never respecified.
+     *
+     * \code{.cpp}
+     *  StaticGeometryBuffer geometry(1 << 20, 3 << 20);
+     *  StaticGeometryBuffer::Allocation bunny;
+     *  geometry.allocate(Mesh("../data/meshes/bunny_smooth.obj"), bunny);
+     *
+     *  Renderable renderable(&geometry.getVertexArray(), &shader, &bunny.batchInfo);
+     * \endcode
+     */
+    class StaticGeometryBuffer {
+    public:
+        static const GLuint PositionLocation = 0;
+        static const GLuint NormalLocation = 1;
+        static const uint32 BytesPerVertex = 6 * sizeof(float);
+
+        struct Allocation {
+            BatchInfo batchInfo;                    // Indexed batch for drawing.
+            TlsfAllocator::Allocation vertices;
+            TlsfAllocator::Allocation indices;
+        };
+
+        struct Stats {
+            TlsfAllocator::Stats vertexStats;   // In vertices.
+            TlsfAllocator::Stats indexStats;    // In indices.
+            uint32 numSharedRanges;             // Live, distinct geometry.
+            uint32 numSharedReferences;         // Allocations that copied nothing.
+            bool immutableStorage;
+
+            Stats();
+        };
+
+        StaticGeometryBuffer(uint32 maxVertices, uint32 maxIndices);
+
+        ~StaticGeometryBuffer();
+
+        bool allocate(const Mesh & mesh, Allocation & allocation);
+
+        bool allocate(const vec3 * positions,
+                      const vec3 * normals,
+                      uint32 numVertices,
+                      const uint32 * indices,
+                      uint32 numIndices,
+                      Allocation & allocation);
+
+        void free(Allocation & allocation);
+
+        const GLuint & getVertexArray() const;
+
+        GLuint getVertexBuffer() const;
+
+        GLuint getIndexBuffer() const;
+
+        void draw(const Allocation & allocation, GLenum mode = GL_TRIANGLES) const;
+
+        Stats getStats() const;
+
+    private:
+        // Non-copyable, owns GL objects.
+        StaticGeometryBuffer(const StaticGeometryBuffer &);
+        StaticGeometryBuffer & operator = (const StaticGeometryBuffer &);
+
+        struct SharedRange {
+            TlsfAllocator::Allocation vertices;
+            TlsfAllocator::Allocation indices;
+            uint32 numVertices;
+            uint32 numIndices;
+            uint32 refCount;
+        };
+
+        TlsfAllocator vertexAllocator;
+        TlsfAllocator indexAllocator;
+        GLuint vao;
+        GLuint vertexBuffer;
+        GLuint indexBuffer;
+        bool immutableStorage;
+
+        // Live geometry by content hash, and the hash of each by index offset.
+        std::unordered_map<uint64, SharedRange> sharedRanges;
+        std::unordered_map<uint32, uint64> hashByIndexOffset;
+    };
+
+}
+
+#endif /* RIGID3D_STATIC_GEOMETRY_BUFFER_HPP_ */
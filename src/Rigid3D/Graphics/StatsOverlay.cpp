@@ -0,0 +1,176 @@
+#include "StatsOverlay.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GpuTimer.hpp>
+#include <Rigid3D/Graphics/TextRenderer.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace Rigid3D {
+
+//----------------------------------------------------------------------------------------
+StatsOverlay::Summary::Summary()
+    : average(0.0),
+      minimum(0.0),
+      maximum(0.0),
+      numSamples(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+StatsOverlay::History::History(uint32 capacity)
+    : samples(capacity, 0.0),
+      numSamples(0),
+      next(0) {
+
+}
+
+//----------------------------------------------------------------------------------------
+void StatsOverlay::History::add(double sample) {
+    samples[next] = sample;
+    next = (next + 1) % uint32(samples.size());
+    numSamples = std::min(numSamples + 1, uint32(samples.size()));
+}
+
+//----------------------------------------------------------------------------------------
+StatsOverlay::Summary StatsOverlay::History::summarize() const {
+    Summary summary;
+    if (numSamples == 0) {
+        return summary;
+    }
+
+    // The oldest samples are overwritten first, so the first numSamples entries
+    // are always the live ones.
+    summary.minimum = samples[0];
+    summary.maximum = samples[0];
+    double sum = 0.0;
+    for (uint32 i = 0; i < numSamples; ++i) {
+        summary.minimum = std::min(summary.minimum, samples[i]);
+        summary.maximum = std::max(summary.maximum, samples[i]);
+        sum += samples[i];
+    }
+    summary.average = sum / double(numSamples);
+    summary.numSamples = numSamples;
+
+    return summary;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param numFrames - number of recent frames that times are summarized over.
+ */
+StatsOverlay::StatsOverlay(uint32 numFrames)
+    : frameTimes(numFrames),
+      gpuTimes(numFrames),
+      numDrawCalls(0),
+      memoryBytes(0) {
+
+    if (numFrames == 0) {
+        std::stringstream errorMessage;
+        errorMessage << "numFrames must be greater than zero"
+                     << " within method StatsOverlay::StatsOverlay";
+        throw Rigid3DException(errorMessage.str());
+    }
+    text[0] = '\0';
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Records the statistics of a completed frame.
+ *
+ * @param cpuMilliseconds - time between the starts of consecutive frames.
+ * @param numDrawCalls - draw calls issued during the frame.
+ * @param memoryBytes - memory in use, as counted by the caller.
+ */
+void StatsOverlay::addFrame(double cpuMilliseconds, uint32 numDrawCalls,
+                            uint64 memoryBytes) {
+    frameTimes.add(cpuMilliseconds);
+    this->numDrawCalls = numDrawCalls;
+    this->memoryBytes = memoryBytes;
+}
+
+//----------------------------------------------------------------------------------------
+void StatsOverlay::addGpuTime(double milliseconds) {
+    gpuTimes.add(milliseconds);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Adds every result 'gpuTimer' has available, without waiting for the rest.
+ *
+ * @return number of GPU times added.
+ */
+uint32 StatsOverlay::collectGpuTimes(GpuTimer & gpuTimer) {
+    uint32 numCollected = 0;
+    double milliseconds;
+    while (gpuTimer.getResult(milliseconds)) {
+        gpuTimes.add(milliseconds);
+        ++numCollected;
+    }
+    return numCollected;
+}
+
+//----------------------------------------------------------------------------------------
+StatsOverlay::Summary StatsOverlay::getFrameTimes() const {
+    return frameTimes.summarize();
+}
+
+//----------------------------------------------------------------------------------------
+StatsOverlay::Summary StatsOverlay::getGpuTimes() const {
+    return gpuTimes.summarize();
+}
+
+//----------------------------------------------------------------------------------------
+uint32 StatsOverlay::getNumDrawCalls() const {
+    return numDrawCalls;
+}
+
+//----------------------------------------------------------------------------------------
+uint64 StatsOverlay::getMemoryBytes() const {
+    return memoryBytes;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Formats the overlay's lines into an internal buffer, valid until the next call.
+ */
+const char * StatsOverlay::formatText() {
+    const Summary frame = frameTimes.summarize();
+    const Summary gpu = gpuTimes.summarize();
+    const double fps = (frame.average > 0.0) ? 1000.0 / frame.average : 0.0;
+
+    int length = std::snprintf(text, sizeof(text),
+            "frame  %6.2f ms  %5.1f fps  (min %.2f, max %.2f)\n",
+            frame.average, fps, frame.minimum, frame.maximum);
+
+    if (gpu.numSamples > 0) {
+        length += std::snprintf(text + length, sizeof(text) - size_t(length),
+                "gpu    %6.2f ms             (min %.2f, max %.2f)\n",
+                gpu.average, gpu.minimum, gpu.maximum);
+    } else {
+        length += std::snprintf(text + length, sizeof(text) - size_t(length),
+                "gpu       n/a\n");
+    }
+
+    std::snprintf(text + length, sizeof(text) - size_t(length),
+            "draws  %u\nmemory %.1f MiB",
+            numDrawCalls, double(memoryBytes) / (1024.0 * 1024.0));
+
+    return text;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Lays out the overlay with its top left corner at 'position', in pixels.  It is
+ * drawn with the rest of the frame's text by \c TextRenderer::draw().
+ *
+ * @return number of glyph quads added.
+ */
+uint32 StatsOverlay::render(TextRenderer & textRenderer, const vec2 & position,
+                            const vec4 & color) {
+    return textRenderer.addText(formatText(), position, color);
+}
+
+} // end namespace Rigid3D
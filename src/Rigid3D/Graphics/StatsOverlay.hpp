@@ -0,0 +1,99 @@
+/**
+ * @brief StatsOverlay
+ */
+
+#ifndef RIGID3D_STATS_OVERLAY_HPP_
+#define RIGID3D_STATS_OVERLAY_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class GpuTimer;
+    class TextRenderer;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Live text overlay of frame times, draw calls and memory use.
+     *
+     * Frame times are kept over the last \c numFrames frames and shown as their
+     * average, minimum and maximum.  GPU times are drained from a \c GpuTimer as
+     * they become available, a few frames after they were measured.  The text is
+     * formatted into a fixed buffer and drawn through a \c TextRenderer, so the
+     * overlay adds no allocations and no draw calls of its own.
+     *
+     * \code{.cpp}
+     *  gpuTimer.begin();
+     *  drawScene();
+     *  gpuTimer.end();
+     *
+     *  statsOverlay.addFrame(cpuMilliseconds, numDrawCalls, textureBytes + bufferBytes);
+     *  statsOverlay.collectGpuTimes(gpuTimer);
+     *
+     *  atlas.beginFrame();
+     *  textRenderer.beginFrame();
+     *  statsOverlay.render(textRenderer, vec2(8.0f, 8.0f));
+     *  textRenderer.draw(windowWidth, windowHeight);
+     * \endcode
+     */
+    class StatsOverlay {
+    public:
+        struct Summary {
+            double average;
+            double minimum;
+            double maximum;
+            uint32 numSamples;
+
+            Summary();
+        };
+
+        explicit StatsOverlay(uint32 numFrames = 120);
+
+        void addFrame(double cpuMilliseconds, uint32 numDrawCalls, uint64 memoryBytes);
+
+        void addGpuTime(double milliseconds);
+
+        uint32 collectGpuTimes(GpuTimer & gpuTimer);
+
+        Summary getFrameTimes() const;
+
+        Summary getGpuTimes() const;
+
+        uint32 getNumDrawCalls() const;
+
+        uint64 getMemoryBytes() const;
+
+        const char * formatText();
+
+        uint32 render(TextRenderer & textRenderer, const vec2 & position,
+                      const vec4 & color = vec4(1.0f));
+
+    private:
+        // Ring of the most recent samples.
+        struct History {
+            std::vector<double> samples;
+            uint32 numSamples;
+            uint32 next;
+
+            explicit History(uint32 capacity);
+
+            void add(double sample);
+
+            Summary summarize() const;
+        };
+
+        History frameTimes;
+        History gpuTimes;
+        uint32 numDrawCalls;
+        uint64 memoryBytes;
+
+        char text[512];
+    };
+
+}
+
+#endif /* RIGID3D_STATS_OVERLAY_HPP_ */
@@ -0,0 +1,261 @@
+#include "TextRenderer.hpp"
+
+#include <Rigid3D/Common/PackColor.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/GlyphAtlas.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Rigid3D {
+
+const GLuint TextRenderer::PositionLocation;
+const GLuint TextRenderer::TexCoordLocation;
+const GLuint TextRenderer::ColorLocation;
+const uint32 TextRenderer::BytesPerVertex;
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    // Decodes the UTF-8 sequence at 'text' and advances past it.  Malformed bytes
+    // are returned as Latin-1 code points.
+    uint32 nextCodePoint(const char * & text) {
+        const uint8 * bytes = reinterpret_cast<const uint8 *>(text);
+        uint32 numContinuation = 0;
+        uint32 codePoint = bytes[0];
+        if ((bytes[0] & 0xE0) == 0xC0) {
+            numContinuation = 1;
+            codePoint = bytes[0] & 0x1F;
+        } else if ((bytes[0] & 0xF0) == 0xE0) {
+            numContinuation = 2;
+            codePoint = bytes[0] & 0x0F;
+        } else if ((bytes[0] & 0xF8) == 0xF0) {
+            numContinuation = 3;
+            codePoint = bytes[0] & 0x07;
+        }
+
+        for (uint32 i = 1; i <= numContinuation; ++i) {
+            if ((bytes[i] & 0xC0) != 0x80) {
+                ++text;
+                return bytes[0];
+            }
+            codePoint = (codePoint << 6) | (bytes[i] & 0x3F);
+        }
+
+        text += 1 + numContinuation;
+        return codePoint;
+    }
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param atlas - supplies the glyphs, and may be shared between renderers.  Its
+ * frame is advanced by the caller, once for all of them.
+ * @param maxGlyphsPerFrame - visible glyphs per frame, across all strings.
+ *
+ * @note Requires a current OpenGL context.
+ */
+TextRenderer::TextRenderer(ShaderProgram & shaderProgram, GlyphAtlas & atlas,
+                           uint32 maxGlyphsPerFrame)
+    : shaderProgram(&shaderProgram),
+      atlas(&atlas),
+      maxGlyphsPerFrame(maxGlyphsPerFrame),
+      vao(0),
+      vertexBuffer(0),
+      indexBuffer(0) {
+
+    vertices.reserve(size_t(maxGlyphsPerFrame) * 4);
+
+    // Two triangles per glyph, over corners top left, top right, bottom left and
+    // bottom right.
+    std::vector<GLuint> indices(size_t(maxGlyphsPerFrame) * 6);
+    for (uint32 i = 0; i < maxGlyphsPerFrame; ++i) {
+        const GLuint first = i * 4;
+        GLuint * quad = &indices[size_t(i) * 6];
+        quad[0] = first;
+        quad[1] = first + 2;
+        quad[2] = first + 1;
+        quad[3] = first + 1;
+        quad[4] = first + 2;
+        quad[5] = first + 3;
+    }
+
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &indexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, GLsizeiptr(indices.size() * sizeof(GLuint)),
+            indices.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(maxGlyphsPerFrame) * 4 * BytesPerVertex,
+            NULL, GL_STREAM_DRAW);
+
+    glEnableVertexAttribArray(PositionLocation);
+    glVertexAttribPointer(PositionLocation, 2, GL_FLOAT, GL_FALSE, BytesPerVertex,
+            reinterpret_cast<const void *>(0));
+    glEnableVertexAttribArray(TexCoordLocation);
+    glVertexAttribPointer(TexCoordLocation, 2, GL_FLOAT, GL_FALSE, BytesPerVertex,
+            reinterpret_cast<const void *>(2 * sizeof(float)));
+    glEnableVertexAttribArray(ColorLocation);
+    glVertexAttribPointer(ColorLocation, 4, GL_UNSIGNED_BYTE, GL_TRUE, BytesPerVertex,
+            reinterpret_cast<const void *>(4 * sizeof(float)));
+
+    glBindVertexArray(GLuint(prevVao));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    shaderProgram.setUniform("glyphAtlas", 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+TextRenderer::~TextRenderer() {
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &indexBuffer);
+    glDeleteVertexArrays(1, &vao);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Empties the vertex arena.  The atlas is not advanced here, since other renderers
+ * may share it; call \c GlyphAtlas::beginFrame() once per frame before any of them.
+ */
+void TextRenderer::beginFrame() {
+    vertices.clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Lays out 'text' with the top left of its first line at 'position', in pixels.
+ *
+ * @return number of glyph quads added.  Text beyond \c maxGlyphsPerFrame, or whose
+ * glyphs do not fit in the atlas this frame, is dropped.
+ */
+uint32 TextRenderer::addText(const char * text, const vec2 & position, const vec4 & color) {
+    const uint32 packedColor = packColor(color);
+    const uint32 numGlyphsBefore = getNumGlyphs();
+
+    vec2 pen(position.x, position.y + atlas->getAscender());
+    while (*text != '\0') {
+        const uint32 codePoint = nextCodePoint(text);
+        if (codePoint == '\n') {
+            pen = vec2(position.x, pen.y + atlas->getLineHeight());
+            continue;
+        }
+
+        const GlyphAtlas::Glyph * glyph = atlas->findGlyph(codePoint);
+        if (glyph == nullptr) {
+            continue;
+        }
+
+        if (glyph->size.x > 0.0f && glyph->size.y > 0.0f) {
+            if (getNumGlyphs() == maxGlyphsPerFrame) {
+                break;
+            }
+
+            // Whole pixels, so that glyph texels map one to one onto the screen.
+            const float left = std::floor(pen.x + 0.5f) + glyph->offset.x;
+            const float top = std::floor(pen.y + 0.5f) + glyph->offset.y;
+            const float right = left + glyph->size.x;
+            const float bottom = top + glyph->size.y;
+            const vec2 & t0 = glyph->texCoordMin;
+            const vec2 & t1 = glyph->texCoordMax;
+
+            const Vertex quad[4] = {
+                {left,  top,    t0.x, t0.y, packedColor},
+                {right, top,    t1.x, t0.y, packedColor},
+                {left,  bottom, t0.x, t1.y, packedColor},
+                {right, bottom, t1.x, t1.y, packedColor}
+            };
+            vertices.insert(vertices.end(), quad, quad + 4);
+        }
+
+        pen.x += glyph->advance;
+    }
+
+    return getNumGlyphs() - numGlyphsBefore;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws all text added since \c beginFrame() with one draw call, blended over the
+ * framebuffer without depth testing.
+ */
+void TextRenderer::draw(uint32 viewportWidth, uint32 viewportHeight) {
+    if (vertices.empty()) {
+        return;
+    }
+
+    // The atlas is bound to unit 0, so that unit's binding is the one restored.
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+    GLint prevActiveTexture;
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &prevActiveTexture);
+    glActiveTexture(GL_TEXTURE0);
+    GLint prevTexture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+    GLint prevBlend[4];
+    glGetIntegerv(GL_BLEND_SRC_RGB, &prevBlend[0]);
+    glGetIntegerv(GL_BLEND_DST_RGB, &prevBlend[1]);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &prevBlend[2]);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &prevBlend[3]);
+    const GLboolean blendEnabled = glIsEnabled(GL_BLEND);
+    const GLboolean depthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
+
+    // Orphan last frame's storage, so the upload does not wait on its draw.
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(maxGlyphsPerFrame) * 4 * BytesPerVertex,
+            NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, GLsizeiptr(vertices.size() * sizeof(Vertex)),
+            vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+
+    glBindVertexArray(vao);
+    glBindTexture(GL_TEXTURE_2D, atlas->getTexture());
+
+    shaderProgram->setUniform("viewportSize", float(viewportWidth), float(viewportHeight));
+    shaderProgram->enable();
+        glDrawElements(GL_TRIANGLES, GLsizei(getNumGlyphs() * 6), GL_UNSIGNED_INT, 0);
+    shaderProgram->disable();
+
+    glBindTexture(GL_TEXTURE_2D, GLuint(prevTexture));
+    glActiveTexture(GLenum(prevActiveTexture));
+    glBindVertexArray(GLuint(prevVao));
+    glBlendFuncSeparate(GLenum(prevBlend[0]), GLenum(prevBlend[1]), GLenum(prevBlend[2]),
+            GLenum(prevBlend[3]));
+    if (!blendEnabled) {
+        glDisable(GL_BLEND);
+    }
+    if (depthTestEnabled) {
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return number of glyph quads added since \c beginFrame().
+ */
+uint32 TextRenderer::getNumGlyphs() const {
+    return uint32(vertices.size() / 4);
+}
+
+//----------------------------------------------------------------------------------------
+GlyphAtlas & TextRenderer::getGlyphAtlas() const {
+    return *atlas;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,101 @@
+/**
+ * @brief TextRenderer
+ */
+
+#ifndef RIGID3D_TEXT_RENDERER_HPP_
+#define RIGID3D_TEXT_RENDERER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class GlyphAtlas;
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Draws all of a frame's text with one draw call.
+     *
+     * Strings are laid out on the CPU as they are added, one quad per glyph, into
+     * a vertex arena that is reset by \c beginFrame() and never reallocated.
+     * Glyphs come from a shared \c GlyphAtlas, so each is rasterized once and
+     * then only costs four vertices.  \c draw() uploads the arena and draws every
+     * string at once, alpha blended over the framebuffer.
+     *
+     * The atlas may serve several renderers, so they leave advancing its frame to
+     * the caller: call \c GlyphAtlas::beginFrame() once per frame, before any of
+     * them lays out text, so that no renderer's glyphs are replaced before it draws.
+     *
+     * Positions are in pixels, with the origin at the top left of the viewport.
+     * UTF-8 text is supported and '\n' starts a new line.
+     *
+     * The ShaderProgram is expected to be built from Text.vert and Text.frag.
+     *
+     * \code{.cpp}
+     *  GlyphAtlas atlas("data/fonts/DroidSansMono.ttf", 16);
+     *  TextRenderer textRenderer(textShader, atlas, 4096);
+     *
+     *  // Each frame.
+     *  atlas.beginFrame();
+     *  textRenderer.beginFrame();
+     *  textRenderer.addText("Hello", vec2(8.0f, 8.0f));
+     *  textRenderer.addText(statusLine, vec2(8.0f, 32.0f), vec4(1.0f, 1.0f, 0.0f, 1.0f));
+     *  textRenderer.draw(windowWidth, windowHeight);
+     * \endcode
+     */
+    class TextRenderer {
+    public:
+        TextRenderer(ShaderProgram & shaderProgram, GlyphAtlas & atlas,
+                     uint32 maxGlyphsPerFrame);
+
+        ~TextRenderer();
+
+        void beginFrame();
+
+        uint32 addText(const char * text, const vec2 & position,
+                       const vec4 & color = vec4(1.0f));
+
+        void draw(uint32 viewportWidth, uint32 viewportHeight);
+
+        uint32 getNumGlyphs() const;
+
+        GlyphAtlas & getGlyphAtlas() const;
+
+        static const GLuint PositionLocation = 0;
+        static const GLuint TexCoordLocation = 1;
+        static const GLuint ColorLocation = 2;
+
+        static const uint32 BytesPerVertex = 5 * sizeof(float);
+
+    private:
+        // Non-copyable, owns GL buffer objects.
+        TextRenderer(const TextRenderer &);
+        TextRenderer & operator = (const TextRenderer &);
+
+        struct Vertex {
+            float x, y;
+            float u, v;
+            uint32 color;   // RGBA8, red in the lowest byte.
+        };
+
+        ShaderProgram * shaderProgram;
+        GlyphAtlas * atlas;
+        uint32 maxGlyphsPerFrame;
+
+        // Four vertices per glyph, reserved for maxGlyphsPerFrame.
+        std::vector<Vertex> vertices;
+
+        GLuint vao;
+        GLuint vertexBuffer;
+        GLuint indexBuffer;
+    };
+
+}
+
+#endif /* RIGID3D_TEXT_RENDERER_HPP_ */
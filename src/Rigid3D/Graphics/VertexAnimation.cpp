@@ -0,0 +1,298 @@
+#include "VertexAnimation.hpp"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Math/Octahedral.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <sstream>
+
+namespace Rigid3D {
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    int16 quantize(float value) {
+        return int16(glm::clamp(std::floor(value + 0.5f), -32767.0f, 32767.0f));
+    }
+
+    //------------------------------------------------------------------------------------
+    // Octahedral normal with 8 bits per coordinate, x in the low byte.
+    int16 packNormal(const vec3 & normal) {
+        vec2 uv = octahedralEncode(glm::normalize(normal));
+        uint32 x = uint32(std::floor(glm::clamp(uv.x, 0.0f, 1.0f) * 255.0f + 0.5f));
+        uint32 y = uint32(std::floor(glm::clamp(uv.y, 0.0f, 1.0f) * 255.0f + 0.5f));
+        return int16(uint16(x | (y << 8)));
+    }
+
+} // end anonymous namespace
+
+const GLuint VertexAnimation::PositionLocation;
+const GLuint VertexAnimation::KeyframeTextureUnit;
+
+//----------------------------------------------------------------------------------------
+/**
+ * Loads each OBJ file of 'objFramePaths' as one keyframe.
+ *
+ * @note Requires a current OpenGL context.
+ */
+VertexAnimation::VertexAnimation(const std::vector<std::string> & objFramePaths,
+                                 float framesPerSecond)
+    : numFrames(0),
+      numVertices(0),
+      framesPerSecond(framesPerSecond),
+      positionScale(0.0f),
+      vao(0),
+      positionBuffer(0),
+      keyframeBuffer(0),
+      keyframeTexture(0) {
+
+    std::vector<std::unique_ptr<Mesh>> meshes;
+    std::vector<const Mesh *> frames;
+    for (const std::string & objFramePath : objFramePaths) {
+        meshes.emplace_back(new Mesh(objFramePath.c_str()));
+        frames.push_back(meshes.back().get());
+    }
+
+    build(frames);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @note Requires a current OpenGL context.
+ *
+ * @param frames - keyframe meshes, with equal numbers of vertices and normals.
+ * Only needed during construction.
+ */
+VertexAnimation::VertexAnimation(const std::vector<const Mesh *> & frames,
+                                 float framesPerSecond)
+    : numFrames(0),
+      numVertices(0),
+      framesPerSecond(framesPerSecond),
+      positionScale(0.0f),
+      vao(0),
+      positionBuffer(0),
+      keyframeBuffer(0),
+      keyframeTexture(0) {
+    build(frames);
+}
+
+//----------------------------------------------------------------------------------------
+VertexAnimation::~VertexAnimation() {
+    glDeleteTextures(1, &keyframeTexture);
+    glDeleteBuffers(1, &keyframeBuffer);
+    glDeleteBuffers(1, &positionBuffer);
+    glDeleteVertexArrays(1, &vao);
+}
+
+//----------------------------------------------------------------------------------------
+void VertexAnimation::build(const std::vector<const Mesh *> & frames) {
+    if (frames.empty() || framesPerSecond <= 0.0f) {
+        std::stringstream errorMessage;
+        errorMessage << "A vertex animation needs at least one frame and a positive"
+                     << " frame rate within method VertexAnimation::VertexAnimation";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    const std::vector<vec3> & basePositions = *frames[0]->getVertexPositionVector();
+    const uint32 frameVertices = uint32(basePositions.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (frames[i]->getNumVertexPositions() != frameVertices ||
+                frames[i]->getNumVertexNormals() != frameVertices) {
+            std::stringstream errorMessage;
+            errorMessage << "Frame " << i << " has " << frames[i]->getNumVertexPositions()
+                         << " positions and " << frames[i]->getNumVertexNormals()
+                         << " normals, expected " << frameVertices << " of each"
+                         << " within method VertexAnimation::VertexAnimation";
+            throw Rigid3DException(errorMessage.str());
+        }
+    }
+
+    const uint64 numTexels = uint64(frames.size()) * frameVertices;
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    if (numTexels > uint64(maxTexels)) {
+        std::stringstream errorMessage;
+        errorMessage << "Vertex animation of " << numTexels << " keyframe vertices"
+                     << " exceeds the texture buffer limit of " << maxTexels
+                     << " within method VertexAnimation::VertexAnimation";
+        throw Rigid3DException(errorMessage.str());
+    }
+
+    // Quantization grid, per axis over the largest offset from the base pose.
+    vec3 maxOffset(0.0f);
+    for (const Mesh * frame : frames) {
+        const std::vector<vec3> & positions = *frame->getVertexPositionVector();
+        for (uint32 v = 0; v < frameVertices; ++v) {
+            maxOffset = glm::max(maxOffset, glm::abs(positions[v] - basePositions[v]));
+        }
+    }
+    positionScale = maxOffset / 32767.0f;
+    const vec3 inverseScale(
+            maxOffset.x > 0.0f ? 32767.0f / maxOffset.x : 0.0f,
+            maxOffset.y > 0.0f ? 32767.0f / maxOffset.y : 0.0f,
+            maxOffset.z > 0.0f ? 32767.0f / maxOffset.z : 0.0f);
+
+    std::vector<int16> texels(size_t(numTexels) * 4);
+    int16 * texel = texels.data();
+    for (const Mesh * frame : frames) {
+        const std::vector<vec3> & positions = *frame->getVertexPositionVector();
+        const std::vector<vec3> & normals = *frame->getVertexNormalVector();
+        for (uint32 v = 0; v < frameVertices; ++v, texel += 4) {
+            vec3 offset = (positions[v] - basePositions[v]) * inverseScale;
+            texel[0] = quantize(offset.x);
+            texel[1] = quantize(offset.y);
+            texel[2] = quantize(offset.z);
+            texel[3] = packNormal(normals[v]);
+        }
+    }
+
+    numFrames = uint32(frames.size());
+    numVertices = frameVertices;
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glGenBuffers(1, &positionBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, positionBuffer);
+    glBufferData(GL_ARRAY_BUFFER, basePositions.size() * sizeof(vec3),
+            basePositions.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(PositionLocation);
+    glVertexAttribPointer(PositionLocation, 3, GL_FLOAT, GL_FALSE, 0,
+            reinterpret_cast<void *>(0));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &keyframeBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, keyframeBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, texels.size() * sizeof(int16), texels.data(),
+            GL_STATIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenTextures(1, &keyframeTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, keyframeTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA16I, keyframeBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 VertexAnimation::getNumFrames() const {
+    return numFrames;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 VertexAnimation::getNumVertices() const {
+    return numVertices;
+}
+
+//----------------------------------------------------------------------------------------
+float VertexAnimation::getFramesPerSecond() const {
+    return framesPerSecond;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return length of one loop in seconds, including the blend from the last frame
+ * back to the first.
+ */
+float VertexAnimation::getDuration() const {
+    return float(numFrames) / framesPerSecond;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return size of the keyframe texture buffer in bytes.
+ */
+size_t VertexAnimation::getNumKeyframeBytes() const {
+    return size_t(numFrames) * numVertices * 4 * sizeof(int16);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Finds the keyframes surrounding 'time', as blended by the vertex shader.
+ *
+ * @param time - seconds since the start of the animation.
+ * @param loop - wrap around after the last frame, otherwise hold the last frame.
+ * @param blend - weight of 'frameB', in [0, 1).
+ */
+void VertexAnimation::sampleKeyframes(float time, bool loop,
+                                      uint32 & frameA, uint32 & frameB,
+                                      float & blend) const {
+    float frameTime = time * framesPerSecond;
+    if (loop) {
+        frameTime = std::fmod(frameTime, float(numFrames));
+        if (frameTime < 0.0f) {
+            frameTime += float(numFrames);
+        }
+    } else {
+        frameTime = glm::clamp(frameTime, 0.0f, float(numFrames - 1));
+    }
+
+    frameA = std::min(uint32(frameTime), numFrames - 1);
+    blend = frameTime - float(frameA);
+    if (loop) {
+        frameB = (frameA + 1) % numFrames;
+    } else {
+        frameB = std::min(frameA + 1, numFrames - 1);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Draws the mesh posed at 'time' with a single draw call.
+ *
+ * @param shaderProgram - linked VertexAnimation ShaderProgram, with its matrices
+ * already set.
+ */
+void VertexAnimation::render(ShaderProgram & shaderProgram, float time, bool loop) const {
+    uint32 frameA, frameB;
+    float blend;
+    sampleKeyframes(time, loop, frameA, frameB, blend);
+
+    shaderProgram.setUniform("keyframes", int(KeyframeTextureUnit));
+    shaderProgram.setUniform("numVertices", int(numVertices));
+    shaderProgram.setUniform("frameA", int(frameA));
+    shaderProgram.setUniform("frameB", int(frameB));
+    shaderProgram.setUniform("blend", blend);
+    shaderProgram.setUniform("positionScale", positionScale);
+
+    GLint prevVao;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prevVao);
+
+    glActiveTexture(GL_TEXTURE0 + KeyframeTextureUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, keyframeTexture);
+
+    glBindVertexArray(vao);
+    shaderProgram.enable();
+        glDrawArrays(GL_TRIANGLES, 0, GLsizei(numVertices));
+    shaderProgram.disable();
+    glBindVertexArray(prevVao);
+
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    CHECK_GL_ERRORS;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return vertex array with the base pose positions at \c PositionLocation, for
+ * drawing with custom state.
+ */
+GLuint VertexAnimation::getVertexArray() const {
+    return vao;
+}
+
+//----------------------------------------------------------------------------------------
+GLuint VertexAnimation::getKeyframeTexture() const {
+    return keyframeTexture;
+}
+
+} // end namespace Rigid3D
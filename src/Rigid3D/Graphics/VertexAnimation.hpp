@@ -0,0 +1,109 @@
+/**
+ * @brief VertexAnimation
+ */
+
+#ifndef RIGID3D_VERTEX_ANIMATION_HPP_
+#define RIGID3D_VERTEX_ANIMATION_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <OpenGL/gl3.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class Mesh;
+    class ShaderProgram;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Mesh animated by a sequence of keyframe meshes with the same topology,
+     * such as OBJ files exported frame by frame, interpolated on the GPU.
+     *
+     * The first frame is the base pose, kept as float positions in a vertex buffer.
+     * Every frame is stored in one texture buffer as a GL_RGBA16I texel per vertex:
+     * # xyz - offset of the position from the base pose, quantized over the largest
+     *   offset of each axis across the sequence.
+     * # w - the normal, octahedral mapped with 8 bits per coordinate.
+     *
+     * That is 8 bytes per vertex per frame, a third of float positions and normals.
+     * The vertex shader fetches the two keyframes surrounding the current time by
+     * gl_VertexID and blends them, so drawing an animated object is one draw call
+     * and no per frame upload or CPU work.
+     *
+     * The ShaderProgram is expected to be built from VertexAnimation.vert and a
+     * fragment shader taking eye space 'position' and 'normal', such as
+     * PerFragLighting.frag.  The caller sets the same matrices as for
+     * PerFragLighting.vert:
+     * # uniform mat4 ModelViewMatrix
+     * # uniform mat3 NormalMatrix
+     * # uniform mat4 ProjectionMatrix
+     *
+     * \code{.cpp}
+     *  std::vector<std::string> frames;
+     *  for (int i = 0; i < 24; ++i) {
+     *      frames.push_back("meshes/flag_" + std::to_string(i) + ".obj");
+     *  }
+     *  VertexAnimation flag(frames, 24.0f);
+     *  ...
+     *  flag.render(shader, elapsedSeconds);
+     * \endcode
+     */
+    class VertexAnimation {
+    public:
+        VertexAnimation(const std::vector<std::string> & objFramePaths,
+                        float framesPerSecond);
+
+        VertexAnimation(const std::vector<const Mesh *> & frames, float framesPerSecond);
+
+        ~VertexAnimation();
+
+        uint32 getNumFrames() const;
+
+        uint32 getNumVertices() const;
+
+        float getFramesPerSecond() const;
+
+        float getDuration() const;
+
+        size_t getNumKeyframeBytes() const;
+
+        void sampleKeyframes(float time, bool loop,
+                             uint32 & frameA, uint32 & frameB, float & blend) const;
+
+        void render(ShaderProgram & shaderProgram, float time, bool loop = true) const;
+
+        GLuint getVertexArray() const;
+
+        GLuint getKeyframeTexture() const;
+
+        static const GLuint PositionLocation = 0;
+
+        static const GLuint KeyframeTextureUnit = 0;
+
+    private:
+        // Non-copyable, owns GL objects.
+        VertexAnimation(const VertexAnimation &);
+        VertexAnimation & operator = (const VertexAnimation &);
+
+        void build(const std::vector<const Mesh *> & frames);
+
+        uint32 numFrames;
+        uint32 numVertices;
+        float framesPerSecond;
+        vec3 positionScale;
+
+        GLuint vao;
+        GLuint positionBuffer;
+        GLuint keyframeBuffer;
+        GLuint keyframeTexture;
+    };
+
+}
+
+#endif /* RIGID3D_VERTEX_ANIMATION_HPP_ */
@@ -0,0 +1,61 @@
+/**
+ * @brief Octahedral.hpp
+ *
+ * Octahedral mapping between unit directions and the unit square.  The sphere is
+ * projected onto an octahedron which is then unfolded so that the upper (+z)
+ * hemisphere fills the center diamond and the lower hemisphere fills the corners.
+ */
+
+#ifndef RIGID3D_OCTAHEDRAL_HPP_
+#define RIGID3D_OCTAHEDRAL_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <cmath>
+
+namespace Rigid3D {
+
+    //-----------------------------------------------------------------------------------
+    inline float signNotZero(float x) {
+        return (x >= 0.0f) ? 1.0f : -1.0f;
+    }
+
+    //-----------------------------------------------------------------------------------
+    /**
+     * Maps the unit vector 'direction' to a point in [0,1] x [0,1].
+     */
+    inline vec2 octahedralEncode(const vec3 & direction) {
+        float l1Norm = std::fabs(direction.x) + std::fabs(direction.y) +
+            std::fabs(direction.z);
+        vec2 p(direction.x / l1Norm, direction.y / l1Norm);
+
+        if (direction.z < 0.0f) {
+            vec2 folded((1.0f - std::fabs(p.y)) * signNotZero(p.x),
+                        (1.0f - std::fabs(p.x)) * signNotZero(p.y));
+            p = folded;
+        }
+
+        return p * 0.5f + vec2(0.5f);
+    }
+
+    //-----------------------------------------------------------------------------------
+    /**
+     * Inverse of \c octahedralEncode.  Returns a unit vector.
+     */
+    inline vec3 octahedralDecode(const vec2 & uv) {
+        vec2 p = uv * 2.0f - vec2(1.0f);
+        vec3 direction(p.x, p.y, 1.0f - std::fabs(p.x) - std::fabs(p.y));
+
+        if (direction.z < 0.0f) {
+            float x = (1.0f - std::fabs(p.y)) * signNotZero(p.x);
+            float y = (1.0f - std::fabs(p.x)) * signNotZero(p.y);
+            direction.x = x;
+            direction.y = y;
+        }
+
+        return glm::normalize(direction);
+    }
+
+}
+
+#endif /* RIGID3D_OCTAHEDRAL_HPP_ */
@@ -0,0 +1,51 @@
+/**
+ * @brief SimdMatrix.hpp
+ *
+ * 4x4 matrix products on SSE registers, one column per register, for inner loops
+ * such as joint hierarchies and skinning.  Builds without SSE2 fall back to GLM.
+ */
+
+#ifndef RIGID3D_SIMD_MATRIX_HPP_
+#define RIGID3D_SIMD_MATRIX_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Rigid3D {
+
+    //-----------------------------------------------------------------------------------
+    /**
+     * Computes 'a' * 'b' into 'result', which may alias either operand.
+     */
+    inline void multiplyMatrices(const mat4 & a, const mat4 & b, mat4 & result) {
+#if defined(__SSE2__)
+        const float * pa = glm::value_ptr(a);
+        const float * pb = glm::value_ptr(b);
+        float * pr = glm::value_ptr(result);
+
+        const __m128 a0 = _mm_loadu_ps(pa);
+        const __m128 a1 = _mm_loadu_ps(pa + 4);
+        const __m128 a2 = _mm_loadu_ps(pa + 8);
+        const __m128 a3 = _mm_loadu_ps(pa + 12);
+
+        // Column j of 'b' is only read before column j of 'result' is written.
+        for (int j = 0; j < 16; j += 4) {
+            __m128 column = _mm_mul_ps(a0, _mm_set1_ps(pb[j]));
+            column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(pb[j + 1])));
+            column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(pb[j + 2])));
+            column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(pb[j + 3])));
+            _mm_storeu_ps(pr + j, column);
+        }
+#else
+        result = a * b;
+#endif
+    }
+
+}
+
+#endif /* RIGID3D_SIMD_MATRIX_HPP_ */
@@ -0,0 +1,465 @@
+#include "ParticleEmitter.hpp"
+
+#include <Rigid3D/Common/PackColor.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Rigid3D {
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    // Pushes particles out of the region where the signed distance 'distance' is
+    // negative, along the unit gradient 'normal', and reflects the velocity into
+    // that region with 'bounce' = 1 + restitution.
+#if defined(__SSE2__)
+    inline void resolveContact(__m128 distance, __m128 nx, __m128 ny, __m128 nz,
+                               __m128 bounce, float * x, float * y, float * z,
+                               float * vx, float * vy, float * vz) {
+        const __m128 zero = _mm_setzero_ps();
+        __m128 push = _mm_min_ps(distance, zero);
+        __m128 px = _mm_sub_ps(_mm_loadu_ps(x), _mm_mul_ps(nx, push));
+        __m128 py = _mm_sub_ps(_mm_loadu_ps(y), _mm_mul_ps(ny, push));
+        __m128 pz = _mm_sub_ps(_mm_loadu_ps(z), _mm_mul_ps(nz, push));
+        _mm_storeu_ps(x, px);
+        _mm_storeu_ps(y, py);
+        _mm_storeu_ps(z, pz);
+
+        __m128 velX = _mm_loadu_ps(vx);
+        __m128 velY = _mm_loadu_ps(vy);
+        __m128 velZ = _mm_loadu_ps(vz);
+        __m128 normalVelocity = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(velX, nx), _mm_mul_ps(velY, ny)), _mm_mul_ps(velZ, nz));
+        __m128 approaching = _mm_and_ps(_mm_cmplt_ps(distance, zero),
+                                        _mm_cmplt_ps(normalVelocity, zero));
+        __m128 impulse = _mm_and_ps(approaching, _mm_mul_ps(normalVelocity, bounce));
+        _mm_storeu_ps(vx, _mm_sub_ps(velX, _mm_mul_ps(nx, impulse)));
+        _mm_storeu_ps(vy, _mm_sub_ps(velY, _mm_mul_ps(ny, impulse)));
+        _mm_storeu_ps(vz, _mm_sub_ps(velZ, _mm_mul_ps(nz, impulse)));
+    }
+#else
+    inline void resolveContact(float distance, const vec3 & normal, float bounce,
+                               float & x, float & y, float & z,
+                               float & vx, float & vy, float & vz) {
+        if (distance >= 0.0f) {
+            return;
+        }
+        x -= normal.x * distance;
+        y -= normal.y * distance;
+        z -= normal.z * distance;
+        float normalVelocity = vx * normal.x + vy * normal.y + vz * normal.z;
+        if (normalVelocity < 0.0f) {
+            float impulse = normalVelocity * bounce;
+            vx -= normal.x * impulse;
+            vy -= normal.y * impulse;
+            vz -= normal.z * impulse;
+        }
+    }
+#endif
+
+} // end anonymous namespace
+
+const uint32 ParticleEmitter::BytesPerInstance;
+
+//----------------------------------------------------------------------------------------
+ParticleEmitter::Params::Params()
+    : position(0.0f),
+      positionSpread(0.0f),
+      velocity(0.0f, 1.0f, 0.0f),
+      velocitySpread(0.0f),
+      acceleration(0.0f),
+      drag(0.0f),
+      restitution(0.5f),
+      emissionRate(0.0f),
+      lifetime(1.0f),
+      lifetimeSpread(0.0f),
+      color(1.0f),
+      size(0.05f) {
+
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @param maxParticles - capacity.  All storage is allocated up front.
+ * @param seed - seed of the emitter's random number generator, so that effects
+ * replay identically.
+ */
+ParticleEmitter::ParticleEmitter(uint32 maxParticles, const Params & params, uint32 seed)
+    : params(params),
+      maxParticles(maxParticles),
+      paddedMaxParticles((maxParticles + 3) & ~3u),
+      numParticles(0),
+      emissionDebt(0.0f),
+      components(size_t(NumComponents) * paddedMaxParticles, 0.0f),
+      colors(paddedMaxParticles, 0),
+      random(seed == 0 ? 1 : seed) {
+
+}
+
+//----------------------------------------------------------------------------------------
+const ParticleEmitter::Params & ParticleEmitter::getParams() const {
+    return params;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Changes how new particles are spawned and how all particles move.  Existing
+ * particles keep their color and remaining life.
+ */
+void ParticleEmitter::setParams(const Params & params) {
+    this->params = params;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Keeps particles on the positive side of 'plane', (normal, distance) with
+ * dot(normal, p) + distance = 0 on the plane.
+ */
+void ParticleEmitter::addCollisionPlane(const vec4 & plane) {
+    float length = glm::length(vec3(plane));
+    if (length <= 0.0f) {
+        std::stringstream errorMessage;
+        errorMessage << "Collision plane needs a non zero normal"
+                     << " within method ParticleEmitter::addCollisionPlane";
+        throw Rigid3DException(errorMessage.str());
+    }
+    planes.push_back(plane / length);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Keeps particles outside of the sphere at 'center'.
+ */
+void ParticleEmitter::addCollisionSphere(const vec3 & center, float radius) {
+    spheres.push_back(vec4(center, radius));
+}
+
+//----------------------------------------------------------------------------------------
+void ParticleEmitter::clearColliders() {
+    planes.clear();
+    spheres.clear();
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Spawns up to 'count' particles at once, in addition to those spawned at
+ * \c Params::emissionRate.
+ *
+ * @return number of particles spawned, less than 'count' if the emitter is full.
+ */
+uint32 ParticleEmitter::emit(uint32 count) {
+    count = std::min(count, maxParticles - numParticles);
+
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const uint32 color = packColor(params.color);
+
+    float * x = component(PositionX);
+    float * y = component(PositionY);
+    float * z = component(PositionZ);
+    float * vx = component(VelocityX);
+    float * vy = component(VelocityY);
+    float * vz = component(VelocityZ);
+    float * life = component(Life);
+
+    const uint32 end = numParticles + count;
+    for (uint32 i = numParticles; i < end; ++i) {
+        x[i] = params.position.x + params.positionSpread.x * unit(random);
+        y[i] = params.position.y + params.positionSpread.y * unit(random);
+        z[i] = params.position.z + params.positionSpread.z * unit(random);
+        vx[i] = params.velocity.x + params.velocitySpread.x * unit(random);
+        vy[i] = params.velocity.y + params.velocitySpread.y * unit(random);
+        vz[i] = params.velocity.z + params.velocitySpread.z * unit(random);
+        life[i] = std::max(params.lifetime + params.lifetimeSpread * unit(random), 0.0f);
+        colors[i] = color;
+    }
+    numParticles = end;
+
+    return count;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Advances the simulation by 'seconds': moves and collides every particle, removes
+ * the expired ones, then spawns new ones at the emission rate.
+ */
+void ParticleEmitter::update(float seconds) {
+    if (numParticles > 0) {
+        integrate(seconds);
+        collide();
+        compact();
+    }
+
+    emissionDebt += params.emissionRate * seconds;
+    uint32 count = uint32(emissionDebt);
+    emissionDebt -= float(count);
+    emit(count);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Updates every emitter in 'emitters', in parallel when 'threadPool' is given.
+ */
+void ParticleEmitter::updateAll(const std::vector<ParticleEmitter *> & emitters,
+                                float seconds, ThreadPool * threadPool) {
+    if (threadPool) {
+        threadPool->parallelFor(emitters.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                emitters[i]->update(seconds);
+            }
+        });
+    } else {
+        for (ParticleEmitter * emitter : emitters) {
+            emitter->update(seconds);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void ParticleEmitter::integrate(float seconds) {
+    float * x = component(PositionX);
+    float * y = component(PositionY);
+    float * z = component(PositionZ);
+    float * vx = component(VelocityX);
+    float * vy = component(VelocityY);
+    float * vz = component(VelocityZ);
+    float * life = component(Life);
+
+    const float damping = std::max(0.0f, 1.0f - params.drag * seconds);
+    const vec3 deltaVelocity = params.acceleration * seconds;
+
+#if defined(__SSE2__)
+    const __m128 dt = _mm_set1_ps(seconds);
+    const __m128 damp = _mm_set1_ps(damping);
+    const __m128 dvx = _mm_set1_ps(deltaVelocity.x);
+    const __m128 dvy = _mm_set1_ps(deltaVelocity.y);
+    const __m128 dvz = _mm_set1_ps(deltaVelocity.z);
+
+    for (uint32 i = 0; i < numParticles; i += 4) {
+        __m128 velX = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vx + i), damp), dvx);
+        __m128 velY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vy + i), damp), dvy);
+        __m128 velZ = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vz + i), damp), dvz);
+        _mm_storeu_ps(vx + i, velX);
+        _mm_storeu_ps(vy + i, velY);
+        _mm_storeu_ps(vz + i, velZ);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(velX, dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(velY, dt)));
+        _mm_storeu_ps(z + i, _mm_add_ps(_mm_loadu_ps(z + i), _mm_mul_ps(velZ, dt)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt));
+    }
+#else
+    for (uint32 i = 0; i < numParticles; ++i) {
+        vx[i] = vx[i] * damping + deltaVelocity.x;
+        vy[i] = vy[i] * damping + deltaVelocity.y;
+        vz[i] = vz[i] * damping + deltaVelocity.z;
+        x[i] += vx[i] * seconds;
+        y[i] += vy[i] * seconds;
+        z[i] += vz[i] * seconds;
+        life[i] -= seconds;
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+void ParticleEmitter::collide() {
+    if (planes.empty() && spheres.empty()) {
+        return;
+    }
+
+    float * x = component(PositionX);
+    float * y = component(PositionY);
+    float * z = component(PositionZ);
+    float * vx = component(VelocityX);
+    float * vy = component(VelocityY);
+    float * vz = component(VelocityZ);
+
+#if defined(__SSE2__)
+    const __m128 bounce = _mm_set1_ps(1.0f + params.restitution);
+    const __m128 minLengthSquared = _mm_set1_ps(1.0e-12f);
+
+    for (const vec4 & plane : planes) {
+        const __m128 nx = _mm_set1_ps(plane.x);
+        const __m128 ny = _mm_set1_ps(plane.y);
+        const __m128 nz = _mm_set1_ps(plane.z);
+        const __m128 d = _mm_set1_ps(plane.w);
+        for (uint32 i = 0; i < numParticles; i += 4) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(_mm_loadu_ps(x + i), nx), _mm_mul_ps(_mm_loadu_ps(y + i), ny)),
+                    _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(z + i), nz), d));
+            resolveContact(distance, nx, ny, nz, bounce,
+                    x + i, y + i, z + i, vx + i, vy + i, vz + i);
+        }
+    }
+
+    for (const vec4 & sphere : spheres) {
+        const __m128 cx = _mm_set1_ps(sphere.x);
+        const __m128 cy = _mm_set1_ps(sphere.y);
+        const __m128 cz = _mm_set1_ps(sphere.z);
+        const __m128 radius = _mm_set1_ps(sphere.w);
+        for (uint32 i = 0; i < numParticles; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), cx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), cy);
+            __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), cz);
+            __m128 lengthSquared = _mm_max_ps(minLengthSquared, _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+            __m128 length = _mm_sqrt_ps(lengthSquared);
+            __m128 inverseLength = _mm_div_ps(_mm_set1_ps(1.0f), length);
+            resolveContact(_mm_sub_ps(length, radius), _mm_mul_ps(dx, inverseLength),
+                    _mm_mul_ps(dy, inverseLength), _mm_mul_ps(dz, inverseLength), bounce,
+                    x + i, y + i, z + i, vx + i, vy + i, vz + i);
+        }
+    }
+#else
+    const float bounce = 1.0f + params.restitution;
+
+    for (const vec4 & plane : planes) {
+        const vec3 normal(plane);
+        for (uint32 i = 0; i < numParticles; ++i) {
+            float distance = x[i] * normal.x + y[i] * normal.y + z[i] * normal.z + plane.w;
+            resolveContact(distance, normal, bounce, x[i], y[i], z[i], vx[i], vy[i], vz[i]);
+        }
+    }
+
+    for (const vec4 & sphere : spheres) {
+        for (uint32 i = 0; i < numParticles; ++i) {
+            vec3 offset(x[i] - sphere.x, y[i] - sphere.y, z[i] - sphere.z);
+            float length = std::sqrt(std::max(glm::dot(offset, offset), 1.0e-12f));
+            resolveContact(length - sphere.w, offset / length, bounce,
+                    x[i], y[i], z[i], vx[i], vy[i], vz[i]);
+        }
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Moves live particles down over expired ones, preserving their order.  Groups of
+ * four live particles that have not moved yet are skipped without copying.
+ */
+void ParticleEmitter::compact() {
+    float * arrays[NumComponents];
+    for (int c = 0; c < NumComponents; ++c) {
+        arrays[c] = component(Component(c));
+    }
+    const float * life = arrays[Life];
+
+    uint32 write = 0;
+    for (uint32 read = 0; read < numParticles; read += 4) {
+        const uint32 numInGroup = std::min(numParticles - read, 4u);
+#if defined(__SSE2__)
+        uint32 alive = uint32(_mm_movemask_ps(
+                _mm_cmpgt_ps(_mm_loadu_ps(life + read), _mm_setzero_ps())));
+#else
+        uint32 alive = 0;
+        for (uint32 lane = 0; lane < 4; ++lane) {
+            alive |= (life[read + lane] > 0.0f ? 1u : 0u) << lane;
+        }
+#endif
+        alive &= (1u << numInGroup) - 1;
+
+        if (alive == 0xF && write == read) {
+            write += 4;
+            continue;
+        }
+
+        for (uint32 lane = 0; lane < numInGroup; ++lane) {
+            if (alive & (1u << lane)) {
+                for (int c = 0; c < NumComponents; ++c) {
+                    arrays[c][write] = arrays[c][read + lane];
+                }
+                colors[write] = colors[read + lane];
+                ++write;
+            }
+        }
+    }
+    numParticles = write;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 ParticleEmitter::getNumParticles() const {
+    return numParticles;
+}
+
+//----------------------------------------------------------------------------------------
+uint32 ParticleEmitter::getMaxParticles() const {
+    return maxParticles;
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * @return the first of \c getNumParticles() values of component 'c'.
+ */
+const float * ParticleEmitter::getComponentArray(Component c) const {
+    return component(c);
+}
+
+//----------------------------------------------------------------------------------------
+const uint32 * ParticleEmitter::getColorArray() const {
+    return colors.data();
+}
+
+//----------------------------------------------------------------------------------------
+vec3 ParticleEmitter::getPosition(uint32 particle) const {
+    return vec3(component(PositionX)[particle], component(PositionY)[particle],
+                component(PositionZ)[particle]);
+}
+
+//----------------------------------------------------------------------------------------
+/**
+ * Writes \c BytesPerInstance bytes per live particle to 'destination': float
+ * position, then the RGBA8 color.  Stores are sequential, so 'destination' may be
+ * write combined mapped buffer memory.
+ *
+ * @return number of instances written, at most 'maxInstances'.
+ */
+uint32 ParticleEmitter::writeInstances(void * destination, uint32 maxInstances) const {
+    const uint32 count = std::min(numParticles, maxInstances);
+    const float * x = component(PositionX);
+    const float * y = component(PositionY);
+    const float * z = component(PositionZ);
+    float * out = static_cast<float *>(destination);
+
+    uint32 i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= count; i += 4, out += 16) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 pz = _mm_loadu_ps(z + i);
+        __m128 color = _mm_castsi128_ps(_mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(colors.data() + i)));
+        _MM_TRANSPOSE4_PS(px, py, pz, color);
+        _mm_storeu_ps(out, px);
+        _mm_storeu_ps(out + 4, py);
+        _mm_storeu_ps(out + 8, pz);
+        _mm_storeu_ps(out + 12, color);
+    }
+#endif
+    for (; i < count; ++i, out += 4) {
+        out[0] = x[i];
+        out[1] = y[i];
+        out[2] = z[i];
+        std::memcpy(out + 3, &colors[i], sizeof(uint32));
+    }
+
+    return count;
+}
+
+//----------------------------------------------------------------------------------------
+float * ParticleEmitter::component(Component c) {
+    return components.data() + size_t(c) * paddedMaxParticles;
+}
+
+//----------------------------------------------------------------------------------------
+const float * ParticleEmitter::component(Component c) const {
+    return components.data() + size_t(c) * paddedMaxParticles;
+}
+
+} // end namespace Rigid3D
@@ -0,0 +1,134 @@
+/**
+ * @brief ParticleEmitter
+ */
+
+#ifndef RIGID3D_PARTICLE_EMITTER_HPP_
+#define RIGID3D_PARTICLE_EMITTER_HPP_
+
+#include <Rigid3D/Common/Settings.hpp>
+
+#include <random>
+#include <vector>
+
+// Forward declarations
+namespace Rigid3D {
+    class ThreadPool;
+}
+
+namespace Rigid3D {
+
+    /**
+     * @brief Spawns and simulates the particles of one effect on the CPU.
+     *
+     * Particles are stored as structure of arrays, one array per component, so
+     * that each simulation step is a kernel over four particles per SSE
+     * instruction:
+     * # integration of velocity under a constant acceleration and linear drag,
+     * # collision against planes and spheres, both as signed distance functions,
+     * # removal of expired particles, keeping the survivors in order.
+     *
+     * There is no per particle object.  \c writeInstances packs the live particles
+     * into the instance layout read by Particle.vert, for \c ParticleRenderer to
+     * draw with one instanced draw call.
+     *
+     * Emitters are independent, so \c updateAll spreads a frame's emitters across a
+     * \c ThreadPool.
+     *
+     * \code{.cpp}
+     *  ParticleEmitter::Params sparks;
+     *  sparks.emissionRate = 50000.0f;
+     *  sparks.acceleration = vec3(0.0f, -9.8f, 0.0f);
+     *  ParticleEmitter emitter(1 << 20, sparks);
+     *  emitter.addCollisionPlane(vec4(0.0f, 1.0f, 0.0f, 0.0f));
+     *
+     *  ParticleEmitter::updateAll(emitters, frameSeconds, &threadPool);
+     * \endcode
+     */
+    class ParticleEmitter {
+    public:
+        struct Params {
+            vec3 position;
+            vec3 positionSpread;    // Half extents of the spawn box.
+            vec3 velocity;
+            vec3 velocitySpread;    // Half extents of the random velocity offset.
+            vec3 acceleration;
+            float drag;             // Fraction of velocity lost per second.
+            float restitution;      // Fraction of normal velocity kept on collision.
+            float emissionRate;     // Particles per second.
+            float lifetime;         // Seconds.
+            float lifetimeSpread;   // Seconds, either side of 'lifetime'.
+            vec4 color;
+            float size;             // Billboard half width, in world units.
+
+            Params();
+        };
+
+        enum Component {
+            PositionX, PositionY, PositionZ,
+            VelocityX, VelocityY, VelocityZ,
+            Life,
+            NumComponents
+        };
+
+        ParticleEmitter(uint32 maxParticles, const Params & params, uint32 seed = 1);
+
+        const Params & getParams() const;
+
+        void setParams(const Params & params);
+
+        void addCollisionPlane(const vec4 & plane);
+
+        void addCollisionSphere(const vec3 & center, float radius);
+
+        void clearColliders();
+
+        uint32 emit(uint32 count);
+
+        void update(float seconds);
+
+        static void updateAll(const std::vector<ParticleEmitter *> & emitters,
+                              float seconds, ThreadPool * threadPool = nullptr);
+
+        uint32 getNumParticles() const;
+
+        uint32 getMaxParticles() const;
+
+        const float * getComponentArray(Component c) const;
+
+        const uint32 * getColorArray() const;
+
+        vec3 getPosition(uint32 particle) const;
+
+        uint32 writeInstances(void * destination, uint32 maxInstances) const;
+
+        static const uint32 BytesPerInstance = 4 * sizeof(float);
+
+    private:
+        float * component(Component c);
+        const float * component(Component c) const;
+
+        void integrate(float seconds);
+        void collide();
+        void compact();
+
+        Params params;
+        uint32 maxParticles;
+        uint32 paddedMaxParticles;
+        uint32 numParticles;
+        float emissionDebt;
+
+        // NumComponents arrays of paddedMaxParticles floats.
+        std::vector<float> components;
+
+        // RGBA8, red in the lowest byte.
+        std::vector<uint32> colors;
+
+        std::vector<vec4> planes;
+        std::vector<vec4> spheres;   // Center and radius.
+
+        std::minstd_rand random;
+    };
+
+}
+
+#endif /* RIGID3D_PARTICLE_EMITTER_HPP_ */
@@ -9,25 +9,82 @@
 #define RIGID3D_HPP_
 
 #include <Rigid3D/Common/Settings.hpp>
+#include <Rigid3D/Common/AssetPack.hpp>
+#include <Rigid3D/Common/AssetPackWriter.hpp>
+#include <Rigid3D/Common/BlockCompression.hpp>
+#include <Rigid3D/Common/ContentHash.hpp>
 #include <Rigid3D/Common/GlmOutStream.hpp>
+#include <Rigid3D/Common/Lz4.hpp>
 #include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+#include <Rigid3D/Common/TlsfAllocator.hpp>
+#include <Rigid3D/Common/TripleBuffer.hpp>
+#include <Rigid3D/Common/VirtualFileSystem.hpp>
+
+#include <Rigid3D/Animation/AnimationClip.hpp>
+#include <Rigid3D/Animation/AnimationEvaluator.hpp>
+#include <Rigid3D/Animation/LocalPose.hpp>
+#include <Rigid3D/Animation/Skeleton.hpp>
 
 #include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Collision/FrustumPlanes.hpp>
 
+#include <Rigid3D/Graphics/AsyncUploader.hpp>
 #include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Graphics/CommandList.hpp>
+#include <Rigid3D/Graphics/CommandRecorder.hpp>
+#include <Rigid3D/Graphics/CookedMesh.hpp>
+#include <Rigid3D/Graphics/CookedTexture.hpp>
+#include <Rigid3D/Graphics/CpuSkinningBatch.hpp>
+#include <Rigid3D/Graphics/DynamicResolution.hpp>
+#include <Rigid3D/Graphics/FrameCapture.hpp>
+#include <Rigid3D/Graphics/FrameGraph.hpp>
+#include <Rigid3D/Graphics/FramePacket.hpp>
+#include <Rigid3D/Graphics/FramePipeline.hpp>
 #include <Rigid3D/Graphics/Frustum.hpp>
+#include <Rigid3D/Graphics/GlCommandExecutor.hpp>
 #include <Rigid3D/Graphics/GlErrorCheck.hpp>
+#include <Rigid3D/Graphics/GlyphAtlas.hpp>
+#include <Rigid3D/Graphics/GpuCuller.hpp>
+#include <Rigid3D/Graphics/GpuParticleEmitter.hpp>
+#include <Rigid3D/Graphics/GpuTimer.hpp>
+#include <Rigid3D/Graphics/HiZPyramid.hpp>
+#include <Rigid3D/Graphics/ImpostorAtlas.hpp>
+#include <Rigid3D/Graphics/ImpostorRenderer.hpp>
+#include <Rigid3D/Graphics/MaterialLibrary.hpp>
 #include <Rigid3D/Graphics/MaterialProperties.hpp>
 #include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/MeshCodec.hpp>
 #include <Rigid3D/Graphics/MeshConsolidator.hpp>
 #include <Rigid3D/Graphics/ModelTransform.hpp>
+#include <Rigid3D/Graphics/MultiDrawBatch.hpp>
+#include <Rigid3D/Graphics/MultiViewRenderer.hpp>
+#include <Rigid3D/Graphics/ObjectIdPicker.hpp>
+#include <Rigid3D/Graphics/OccluderGenerator.hpp>
 #include "OpenGLContext.hpp"
+#include <Rigid3D/Graphics/ParticleRenderer.hpp>
+#include <Rigid3D/Graphics/PointLight.hpp>
+#include <Rigid3D/Graphics/PointLightShadowAtlas.hpp>
+#include <Rigid3D/Graphics/RayPicking.hpp>
+#include <Rigid3D/Graphics/RenderTargetPool.hpp>
 #include <Rigid3D/Graphics/RenderableFrustum.hpp>
 #include <Rigid3D/Graphics/Renderable.hpp>
+#include <Rigid3D/Graphics/RenderView.hpp>
 #include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Graphics/StaticGeometryBuffer.hpp>
 #include <Rigid3D/Graphics/Shader.hpp>
 #include <Rigid3D/Graphics/ShaderException.hpp>
+#include <Rigid3D/Graphics/ShadowSlotCache.hpp>
+#include <Rigid3D/Graphics/SkinnedMesh.hpp>
+#include <Rigid3D/Graphics/SkinningPalette.hpp>
+#include <Rigid3D/Graphics/StatsOverlay.hpp>
+#include <Rigid3D/Graphics/TextRenderer.hpp>
+#include <Rigid3D/Graphics/VertexAnimation.hpp>
 
+#include <Rigid3D/Math/Octahedral.hpp>
+#include <Rigid3D/Math/SimdMatrix.hpp>
 #include <Rigid3D/Math/Trigonometry.hpp>
 
+#include <Rigid3D/Particles/ParticleEmitter.hpp>
+
 #endif /* RIGID3D_HPP_ */
@@ -0,0 +1,96 @@
+// LocalPose_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Animation/LocalPose.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    void expectMatrixNear(const mat4 & expected, const mat4 & actual) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                EXPECT_NEAR(expected[c][r], actual[c][r], 1.0e-5f)
+                        << "column " << c << ", row " << r;
+            }
+        }
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST(LocalPose_Test, new_joints_are_identity) {
+    LocalPose pose(3);
+
+    EXPECT_EQ(3u, pose.getNumJoints());
+    EXPECT_EQ(vec3(0.0f), pose.getTranslation(2));
+    EXPECT_EQ(quat(), pose.getRotation(2));
+    EXPECT_EQ(vec3(1.0f), pose.getScale(2));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(LocalPose_Test, to_matrices_matches_translate_rotate_scale) {
+    // Five joints, so the last group of four is partially filled.
+    LocalPose pose(5);
+    mat4 expected[5];
+    for (uint32 i = 0; i < 5; ++i) {
+        vec3 translation(float(i), -2.0f * float(i), 0.5f);
+        quat rotation = glm::angleAxis(0.3f * float(i + 1),
+                glm::normalize(vec3(1.0f, float(i), 2.0f)));
+        vec3 scale(1.0f + float(i), 2.0f, 0.5f);
+        pose.setJoint(i, translation, rotation, scale);
+
+        expected[i] = glm::translate(mat4(), translation) * glm::mat4_cast(rotation) *
+                glm::scale(mat4(), scale);
+    }
+
+    mat4 matrices[6];
+    matrices[5] = mat4(7.0f);
+    pose.toMatrices(matrices);
+
+    for (uint32 i = 0; i < 5; ++i) {
+        expectMatrixNear(expected[i], matrices[i]);
+    }
+
+    // Nothing is written past the last joint.
+    EXPECT_EQ(mat4(7.0f), matrices[5]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(LocalPose_Test, blend_interpolates_along_the_shorter_arc) {
+    LocalPose a(1);
+    LocalPose b(1);
+    a.setJoint(0, vec3(0.0f), glm::angleAxis(0.0f, vec3(0.0f, 0.0f, 1.0f)), vec3(1.0f));
+    // The same rotation as pi/2 about z, from the opposite hemisphere.
+    quat quarterTurn = glm::angleAxis(1.5707963f, vec3(0.0f, 0.0f, 1.0f));
+    b.setJoint(0, vec3(2.0f, 4.0f, 6.0f), -quarterTurn, vec3(3.0f));
+
+    LocalPose result;
+    LocalPose::blend(a, b, 0.5f, result);
+
+    EXPECT_EQ(1u, result.getNumJoints());
+    EXPECT_EQ(vec3(1.0f, 2.0f, 3.0f), result.getTranslation(0));
+    EXPECT_EQ(vec3(2.0f), result.getScale(0));
+
+    quat expected = glm::angleAxis(0.7853982f, vec3(0.0f, 0.0f, 1.0f));
+    quat rotation = result.getRotation(0);
+    EXPECT_NEAR(1.0f, glm::abs(glm::dot(expected, rotation)), 1.0e-5f);
+    EXPECT_GT(rotation.w, 0.0f);
+
+    // In place into 'a'.
+    LocalPose::blend(a, b, 1.0f, a);
+    EXPECT_EQ(vec3(2.0f, 4.0f, 6.0f), a.getTranslation(0));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(LocalPose_Test, blend_of_mismatched_poses_throws) {
+    LocalPose a(2);
+    LocalPose b(3);
+    LocalPose result;
+
+    EXPECT_THROW(LocalPose::blend(a, b, 0.5f, result), Rigid3DException);
+}
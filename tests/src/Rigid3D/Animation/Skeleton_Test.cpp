@@ -0,0 +1,175 @@
+// Skeleton_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Animation/AnimationClip.hpp>
+#include <Rigid3D/Animation/AnimationEvaluator.hpp>
+#include <Rigid3D/Animation/LocalPose.hpp>
+#include <Rigid3D/Animation/Skeleton.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+using namespace Rigid3D;
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+using namespace std;
+
+namespace {
+
+    //------------------------------------------------------------------------------------
+    // Chain of three joints along +x, one unit apart in the bind pose.
+    Skeleton createChain() {
+        Skeleton skeleton;
+        skeleton.addJoint("root", Skeleton::NoParent, mat4());
+        skeleton.addJoint("middle", 0,
+                glm::inverse(glm::translate(mat4(), vec3(1.0f, 0.0f, 0.0f))));
+        skeleton.addJoint("tip", 1,
+                glm::inverse(glm::translate(mat4(), vec3(2.0f, 0.0f, 0.0f))));
+        return skeleton;
+    }
+
+    //------------------------------------------------------------------------------------
+    LocalPose createBindPose() {
+        LocalPose pose(3);
+        pose.setJoint(1, vec3(1.0f, 0.0f, 0.0f), quat());
+        pose.setJoint(2, vec3(1.0f, 0.0f, 0.0f), quat());
+        return pose;
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Skeleton_Test, joints_must_follow_their_parents) {
+    Skeleton skeleton = createChain();
+
+    EXPECT_EQ(3u, skeleton.getNumJoints());
+    EXPECT_EQ(1, skeleton.getParent(2));
+    EXPECT_EQ(2, skeleton.findJoint("tip"));
+    EXPECT_EQ(-1, skeleton.findJoint("tail"));
+
+    EXPECT_THROW(skeleton.addJoint("loop", 3, mat4()), Rigid3DException);
+    EXPECT_THROW(skeleton.addJoint("bad", -2, mat4()), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Skeleton_Test, bind_pose_gives_identity_skinning_matrices) {
+    Skeleton skeleton = createChain();
+    LocalPose pose = createBindPose();
+
+    mat4 palette[3];
+    skeleton.computeSkinningMatrices(pose, palette);
+
+    for (const mat4 & matrix : palette) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                EXPECT_NEAR(mat4()[c][r], matrix[c][r], 1.0e-5f);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Skeleton_Test, rotating_the_root_moves_the_whole_chain) {
+    Skeleton skeleton = createChain();
+    LocalPose pose = createBindPose();
+    pose.setJoint(0, vec3(0.0f), glm::angleAxis(1.5707963f, vec3(0.0f, 0.0f, 1.0f)));
+
+    mat4 palette[3];
+    skeleton.computeSkinningMatrices(pose, palette);
+
+    // The bind pose tip at x = 2 now points along +y.
+    vec4 tip = palette[2] * vec4(2.0f, 0.0f, 0.0f, 1.0f);
+    EXPECT_NEAR(0.0f, tip.x, 1.0e-5f);
+    EXPECT_NEAR(2.0f, tip.y, 1.0e-5f);
+
+    LocalPose wrongSize(2);
+    EXPECT_THROW(skeleton.computeSkinningMatrices(wrongSize, palette), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Skeleton_Test, clip_blends_between_samples) {
+    AnimationClip clip(1, 3, 2.0f);
+    clip.getSample(0).setJoint(0, vec3(0.0f), quat());
+    clip.getSample(1).setJoint(0, vec3(2.0f, 0.0f, 0.0f), quat());
+    clip.getSample(2).setJoint(0, vec3(0.0f), quat());
+
+    EXPECT_FLOAT_EQ(1.0f, clip.getDuration());
+
+    LocalPose pose;
+    clip.sample(0.25f, false, pose);
+    EXPECT_NEAR(1.0f, pose.getTranslation(0).x, 1.0e-5f);
+
+    // Wraps around when looping, holds the last sample otherwise.
+    clip.sample(1.25f, true, pose);
+    EXPECT_NEAR(1.0f, pose.getTranslation(0).x, 1.0e-5f);
+    clip.sample(5.0f, false, pose);
+    EXPECT_NEAR(0.0f, pose.getTranslation(0).x, 1.0e-5f);
+
+    EXPECT_THROW(AnimationClip(1, 0, 30.0f), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Skeleton_Test, parallel_evaluation_matches_serial) {
+    Skeleton skeleton = createChain();
+
+    AnimationClip walk(3, 4, 4.0f);
+    AnimationClip wave(3, 2, 1.0f);
+    for (uint32 s = 0; s < 4; ++s) {
+        walk.getSample(s) = createBindPose();
+        walk.getSample(s).setJoint(1, vec3(1.0f, 0.0f, 0.0f),
+                glm::angleAxis(0.2f * float(s), vec3(0.0f, 1.0f, 0.0f)));
+    }
+    wave.getSample(1).setJoint(2, vec3(0.0f, 1.0f, 0.0f), quat());
+
+    const size_t numCharacters = 100;
+    vector<mat4> serialPalettes(numCharacters * 3);
+    vector<mat4> parallelPalettes(numCharacters * 3);
+
+    vector<AnimationEvaluator::Job> serialJobs(numCharacters);
+    for (size_t i = 0; i < numCharacters; ++i) {
+        AnimationEvaluator::Job & job = serialJobs[i];
+        job.skeleton = &skeleton;
+        job.clip = &walk;
+        job.time = 0.01f * float(i);
+        if (i % 2 == 0) {
+            job.blendClip = &wave;
+            job.blendTime = 0.5f;
+            job.blendWeight = 0.25f;
+        }
+        job.palette = &serialPalettes[i * 3];
+    }
+    vector<AnimationEvaluator::Job> parallelJobs = serialJobs;
+    for (size_t i = 0; i < numCharacters; ++i) {
+        parallelJobs[i].palette = &parallelPalettes[i * 3];
+    }
+
+    ThreadPool threadPool(4);
+    AnimationEvaluator::evaluate(serialJobs);
+    AnimationEvaluator::evaluate(parallelJobs, &threadPool);
+
+    for (size_t i = 0; i < serialPalettes.size(); ++i) {
+        ASSERT_EQ(serialPalettes[i], parallelPalettes[i]) << "matrix " << i;
+    }
+
+    // Blended characters differ from unblended ones at the same time.
+    LocalPose pose;
+    walk.sample(0.0f, true, pose);
+    mat4 unblended[3];
+    skeleton.computeSkinningMatrices(pose, unblended);
+    EXPECT_NE(unblended[2], serialPalettes[2]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Skeleton_Test, evaluating_a_mismatched_clip_throws) {
+    Skeleton skeleton = createChain();
+    AnimationClip clip(2, 2, 30.0f);
+    mat4 palette[3];
+
+    vector<AnimationEvaluator::Job> jobs(1);
+    jobs[0].skeleton = &skeleton;
+    jobs[0].clip = &clip;
+    jobs[0].palette = palette;
+
+    EXPECT_THROW(AnimationEvaluator::evaluate(jobs), Rigid3DException);
+}
@@ -13,6 +13,10 @@ using Rigid3D::RayCastOutput;
 #include "TestUtils.hpp"
 using namespace TestUtils::predicates;
 
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+
 namespace {  // limit class visibility to this file.
 
     class AABB_Test : public ::testing::Test {
@@ -258,3 +262,20 @@ TEST_F(AABB_Test, ray_cast_miss_y_hit_x_z) {
 
     EXPECT_FALSE(aabb.rayCast(rayCastIn, &rayCastOut));
 }
+
+//----------------------------------------------------------------------------------------
+TEST_F(AABB_Test, transformed_box_encloses_rotated_box) {
+    // Rotate 45 degrees about z, then translate.
+    mat4 transform = glm::translate(mat4(), vec3(5.0f, 0.0f, 0.0f)) *
+        glm::rotate(mat4(), 0.785398163f, vec3(0.0f, 0.0f, 1.0f));
+
+    AABB result = aabb.getTransformed(transform);
+
+    const float halfDiagonal = std::sqrt(2.0f);
+    EXPECT_NEAR(5.0f - halfDiagonal, result.minBounds.x, 1e-5f);
+    EXPECT_NEAR(5.0f + halfDiagonal, result.maxBounds.x, 1e-5f);
+    EXPECT_NEAR(-halfDiagonal, result.minBounds.y, 1e-5f);
+    EXPECT_NEAR(halfDiagonal, result.maxBounds.y, 1e-5f);
+    EXPECT_NEAR(-1.0f, result.minBounds.z, 1e-5f);
+    EXPECT_NEAR(1.0f, result.maxBounds.z, 1e-5f);
+}
@@ -0,0 +1,78 @@
+// FrustumPlanes_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Collision/FrustumPlanes.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+using Rigid3D::FrustumPlanes;
+using Rigid3D::AABB;
+using Rigid3D::vec3;
+using Rigid3D::mat4;
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {  // limit class visibility to this file.
+
+    class FrustumPlanes_Test : public ::testing::Test {
+    protected:
+        FrustumPlanes frustum;
+
+        // Ran before each test.
+        virtual void SetUp() {
+            // Camera at the origin looking down -z, seeing from z = -1 to z = -100.
+            mat4 projection = glm::perspective(1.0f, 1.0f, 1.0f, 100.0f);
+            mat4 view = glm::lookAt(vec3(0.0f), vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+            frustum.set(projection * view);
+        }
+
+        static AABB makeBox(const vec3 & center, float halfSize) {
+            AABB box;
+            box.minBounds = center - vec3(halfSize);
+            box.maxBounds = center + vec3(halfSize);
+            return box;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FrustumPlanes_Test, box_in_front_of_camera_intersects) {
+    EXPECT_TRUE(frustum.intersects(makeBox(vec3(0.0f, 0.0f, -10.0f), 1.0f)));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FrustumPlanes_Test, box_behind_camera_is_culled) {
+    EXPECT_FALSE(frustum.intersects(makeBox(vec3(0.0f, 0.0f, 10.0f), 1.0f)));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FrustumPlanes_Test, box_beyond_far_plane_is_culled) {
+    EXPECT_FALSE(frustum.intersects(makeBox(vec3(0.0f, 0.0f, -200.0f), 1.0f)));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FrustumPlanes_Test, box_off_to_the_side_is_culled) {
+    EXPECT_FALSE(frustum.intersects(makeBox(vec3(50.0f, 0.0f, -10.0f), 1.0f)));
+    EXPECT_FALSE(frustum.intersects(makeBox(vec3(0.0f, -50.0f, -10.0f), 1.0f)));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FrustumPlanes_Test, box_straddling_plane_intersects) {
+    EXPECT_TRUE(frustum.intersects(makeBox(vec3(0.0f, 0.0f, -100.0f), 1.0f)));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FrustumPlanes_Test, sphere_tests_match_boxes) {
+    EXPECT_TRUE(frustum.intersectsSphere(vec3(0.0f, 0.0f, -10.0f), 1.0f));
+    EXPECT_FALSE(frustum.intersectsSphere(vec3(0.0f, 0.0f, 10.0f), 1.0f));
+    EXPECT_TRUE(frustum.intersectsSphere(vec3(0.0f, 0.0f, 1.5f), 3.0f));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(FrustumPlanes_Default_Test, default_planes_accept_everything) {
+    FrustumPlanes frustum;
+    AABB box;
+    box.minBounds = vec3(1000.0f);
+    box.maxBounds = vec3(1001.0f);
+    EXPECT_TRUE(frustum.intersects(box));
+}
@@ -0,0 +1,173 @@
+// AssetPack_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/AssetPack.hpp>
+#include <Rigid3D/Common/AssetPackWriter.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using namespace Rigid3D;
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {  // limit class visibility to this file.
+
+    const char * packFile = "AssetPack_Test.pack";
+
+    class AssetPack_Test : public ::testing::Test {
+    protected:
+        // Ran after each test.
+        virtual void TearDown() {
+            std::remove(packFile);
+        }
+
+        static std::vector<uint8> bytes(const std::string & text) {
+            return std::vector<uint8>(text.begin(), text.end());
+        }
+    };
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetPack_Test, raw_entries_are_page_aligned_and_read_in_place) {
+    const std::string shader = "#version 410\nvoid main() { }\n";
+    std::vector<uint8> mesh(10000);
+    for (size_t i = 0; i < mesh.size(); ++i) {
+        mesh[i] = uint8(i * 31);
+    }
+
+    AssetPackWriter writer;
+    EXPECT_FALSE(writer.add("shaders/Empty.vert", shader.data(), shader.size()));
+    EXPECT_FALSE(writer.add("meshes/noise.mesh", mesh.data(), mesh.size()));
+    writer.write(packFile);
+
+    AssetPack pack(packFile);
+    ASSERT_EQ(2u, pack.getNumEntries());
+
+    AssetPack::Entry entry;
+    ASSERT_TRUE(pack.find("shaders/Empty.vert", entry));
+    EXPECT_FALSE(entry.compressed);
+    EXPECT_EQ(shader.size(), entry.size);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(entry.data) % AssetPack::Alignment);
+    EXPECT_EQ(shader, std::string(reinterpret_cast<const char *>(entry.data),
+            size_t(entry.size)));
+    EXPECT_EQ("shaders/Empty.vert", std::string(entry.path, entry.pathLength));
+
+    std::vector<uint8> data;
+    pack.read("meshes/noise.mesh", data);
+    EXPECT_EQ(mesh, data);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetPack_Test, compressed_entries_are_decompressed_on_read) {
+    std::string text;
+    for (int i = 0; i < 500; ++i) {
+        text += "f 1//1 2//2 3//3\n";
+    }
+
+    std::vector<uint8> incompressible(64);
+    for (size_t i = 0; i < incompressible.size(); ++i) {
+        incompressible[i] = uint8(i * 97 + 13);
+    }
+
+    AssetPackWriter writer;
+    EXPECT_TRUE(writer.add("meshes/faces.obj", text.data(), text.size(), true));
+    EXPECT_FALSE(writer.add("textures/noise.png", incompressible.data(),
+            incompressible.size(), true));
+    EXPECT_LT(writer.getStoredSize(), writer.getSize());
+    writer.write(packFile);
+
+    AssetPack pack(packFile);
+    AssetPack::Entry entry;
+    ASSERT_TRUE(pack.find("meshes/faces.obj", entry));
+    EXPECT_TRUE(entry.compressed);
+    EXPECT_LT(entry.storedSize, entry.size);
+
+    std::vector<uint8> data;
+    pack.read("meshes/faces.obj", data);
+    EXPECT_EQ(bytes(text), data);
+
+    pack.read("textures/noise.png", data);
+    EXPECT_EQ(incompressible, data);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetPack_Test, lookups_normalize_paths_and_miss_cleanly) {
+    AssetPackWriter writer;
+    for (int i = 0; i < 200; ++i) {
+        std::string path = "dir" + std::to_string(i % 7) + "/file" + std::to_string(i);
+        std::string contents = std::to_string(i);
+        writer.add(path.c_str(), contents.data(), contents.size());
+    }
+    writer.add("empty.txt", NULL, 0);
+    writer.write(packFile);
+
+    AssetPack pack(packFile);
+    EXPECT_EQ(201u, pack.getNumEntries());
+
+    for (int i = 0; i < 200; ++i) {
+        std::string path = "dir" + std::to_string(i % 7) + "/file" + std::to_string(i);
+        std::vector<uint8> data;
+        pack.read(path.c_str(), data);
+        ASSERT_EQ(bytes(std::to_string(i)), data);
+    }
+
+    EXPECT_TRUE(pack.contains("./dir3/file3"));
+    EXPECT_TRUE(pack.contains("dir3\\file3"));
+    EXPECT_FALSE(pack.contains("dir3/file"));
+    EXPECT_FALSE(pack.contains("dir3/file33"));
+
+    std::vector<uint8> data(3);
+    pack.read("empty.txt", data);
+    EXPECT_TRUE(data.empty());
+    EXPECT_THROW(pack.read("missing.txt", data), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetPack_Test, duplicate_paths_throw_on_write) {
+    AssetPackWriter writer;
+    writer.add("a.txt", "a", 1);
+    writer.add("./a.txt", "b", 1);
+    EXPECT_THROW(writer.write(packFile), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(AssetPack_Test, corrupt_files_throw_on_open) {
+    {
+        std::ofstream out(packFile, std::ios::binary);
+        out << "R3DM not a pack file, but long enough for a header";
+    }
+    AssetPack pack;
+    EXPECT_THROW(pack.open(packFile), Rigid3DException);
+    EXPECT_FALSE(pack.isOpen());
+    EXPECT_THROW(pack.open("missing.pack"), Rigid3DException);
+
+    // Truncating the data of a valid pack leaves its entries out of range.
+    AssetPackWriter writer;
+    std::vector<uint8> data(100, 1);
+    writer.add("data.bin", data.data(), data.size());
+    writer.write(packFile);
+    pack.open(packFile);
+    pack.close();
+    {
+        // Version 0 was never written.
+        std::fstream file(packFile, std::ios::binary | std::ios::in | std::ios::out);
+        const uint32 zero = 0;
+        file.seekp(4);
+        file.write(reinterpret_cast<const char *>(&zero), sizeof(zero));
+    }
+    EXPECT_THROW(pack.open(packFile), Rigid3DException);
+    writer.write(packFile);
+    {
+        std::ifstream in(packFile, std::ios::binary);
+        std::vector<char> contents((std::istreambuf_iterator<char>(in)),
+                std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream out(packFile, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), contents.size() - 50);
+    }
+    EXPECT_THROW(pack.open(packFile), Rigid3DException);
+}
@@ -0,0 +1,111 @@
+// BlockCompression_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/BlockCompression.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+using Rigid3D::BlockCompression;
+using Rigid3D::Rigid3DException;
+using Rigid3D::ThreadPool;
+using Rigid3D::uint8;
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::vector<uint8> makeText(size_t size) {
+        std::string text;
+        for (int i = 0; text.size() < size; ++i) {
+            text += "vn 0.577350 -0.577350 " + std::to_string(i % 53) + ".250000\n";
+        }
+        return std::vector<uint8>(text.begin(), text.begin() + size);
+    }
+
+    std::vector<uint8> decompress(const std::vector<uint8> & stream,
+                                  ThreadPool * threadPool = nullptr) {
+        std::vector<uint8> output(size_t(BlockCompression::getDecompressedSize(
+                stream.data(), stream.size())));
+        BlockCompression::decompress(stream.data(), stream.size(), output.data(),
+                output.size(), threadPool);
+        return output;
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST(BlockCompression_Test, text_round_trips_smaller) {
+    const std::vector<uint8> data = makeText(1000000);
+
+    std::vector<uint8> stream;
+    BlockCompression::compress(data.data(), data.size(), stream);
+
+    EXPECT_TRUE(BlockCompression::isCompressedStream(stream.data(), stream.size()));
+    EXPECT_EQ(data.size(), BlockCompression::getDecompressedSize(stream.data(), stream.size()));
+    EXPECT_LT(stream.size(), data.size() / 4);
+    EXPECT_EQ(data, decompress(stream));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(BlockCompression_Test, thread_pool_matches_serial) {
+    ThreadPool threadPool(4);
+    const std::vector<uint8> data = makeText(300000);
+
+    std::vector<uint8> serialStream;
+    std::vector<uint8> parallelStream;
+    BlockCompression::compress(data.data(), data.size(), serialStream, 4096);
+    BlockCompression::compress(data.data(), data.size(), parallelStream, 4096, &threadPool);
+
+    EXPECT_EQ(serialStream, parallelStream);
+    EXPECT_EQ(data, decompress(parallelStream, &threadPool));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(BlockCompression_Test, random_blocks_are_stored_raw) {
+    std::mt19937 random(5);
+    std::vector<uint8> data(70000);
+    for (uint8 & byte : data) {
+        byte = uint8(random());
+    }
+
+    std::vector<uint8> stream;
+    BlockCompression::compress(data.data(), data.size(), stream, 16384);
+
+    // Header and block table only: raw blocks never grow.
+    EXPECT_EQ(24 + 5 * 4 + data.size(), stream.size());
+    EXPECT_EQ(data, decompress(stream));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(BlockCompression_Test, empty_input_round_trips) {
+    std::vector<uint8> stream;
+    BlockCompression::compress(nullptr, 0, stream);
+
+    EXPECT_EQ(0u, BlockCompression::getDecompressedSize(stream.data(), stream.size()));
+    EXPECT_TRUE(decompress(stream).empty());
+}
+
+//----------------------------------------------------------------------------------------
+TEST(BlockCompression_Test, malformed_streams_throw) {
+    const std::vector<uint8> data = makeText(10000);
+    std::vector<uint8> stream;
+    BlockCompression::compress(data.data(), data.size(), stream, 1024);
+
+    std::vector<uint8> output(data.size());
+    EXPECT_THROW(BlockCompression::decompress(stream.data(), stream.size(), output.data(),
+            output.size() - 1), Rigid3DException);
+
+    EXPECT_THROW(BlockCompression::decompress(stream.data(), stream.size() - 10,
+            output.data(), output.size()), Rigid3DException);
+
+    std::vector<uint8> badMagic = stream;
+    badMagic[0] = 'X';
+    EXPECT_FALSE(BlockCompression::isCompressedStream(badMagic.data(), badMagic.size()));
+    EXPECT_THROW(BlockCompression::getDecompressedSize(badMagic.data(), badMagic.size()),
+            Rigid3DException);
+
+    EXPECT_THROW(BlockCompression::compress(data.data(), data.size(), stream, 0),
+            Rigid3DException);
+}
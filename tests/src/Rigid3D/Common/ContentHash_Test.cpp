@@ -0,0 +1,48 @@
+// ContentHash_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/ContentHash.hpp>
+using Rigid3D::ContentHash;
+using Rigid3D::uint8;
+using Rigid3D::uint64;
+
+#include <set>
+#include <vector>
+
+//----------------------------------------------------------------------------------------
+TEST(ContentHash_Test, equal_contents_hash_equal) {
+    std::vector<uint8> a(1000);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = uint8(i * 7);
+    }
+    std::vector<uint8> b = a;
+
+    EXPECT_EQ(ContentHash::hash(a.data(), a.size()), ContentHash::hash(b.data(), b.size()));
+
+    b[999] ^= 1;
+    EXPECT_NE(ContentHash::hash(a.data(), a.size()), ContentHash::hash(b.data(), b.size()));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ContentHash_Test, every_length_and_seed_hashes_differently) {
+    const std::vector<uint8> zeros(32, 0);
+
+    std::set<uint64> hashes;
+    for (size_t size = 0; size <= zeros.size(); ++size) {
+        hashes.insert(ContentHash::hash(zeros.data(), size));
+        hashes.insert(ContentHash::hash(zeros.data(), size, 1));
+    }
+    EXPECT_EQ(2 * (zeros.size() + 1), hashes.size());
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ContentHash_Test, chained_hashes_depend_on_order) {
+    const uint8 a[3] = {1, 2, 3};
+    const uint8 b[3] = {4, 5, 6};
+
+    const uint64 ab = ContentHash::hash(b, 3, ContentHash::hash(a, 3));
+    const uint64 ba = ContentHash::hash(a, 3, ContentHash::hash(b, 3));
+    EXPECT_NE(ab, ba);
+    EXPECT_EQ(ab, ContentHash::hash(b, 3, ContentHash::hash(a, 3)));
+}
@@ -0,0 +1,98 @@
+// Lz4_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Lz4.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+using Rigid3D::Lz4;
+using Rigid3D::Rigid3DException;
+using Rigid3D::uint8;
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::vector<uint8> roundTrip(const std::vector<uint8> & data, size_t & compressedSize) {
+        std::vector<uint8> compressed(Lz4::compressBound(data.size()));
+        compressedSize = Lz4::compress(data.data(), data.size(), compressed.data(),
+                compressed.size());
+
+        std::vector<uint8> decompressed(data.size());
+        Lz4::decompress(compressed.data(), compressedSize, decompressed.data(),
+                decompressed.size());
+        return decompressed;
+    }
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Lz4_Test, repetitive_data_round_trips_smaller) {
+    std::string text;
+    for (int i = 0; i < 2000; ++i) {
+        text += "v 1.000000 -1.000000 " + std::to_string(i % 37) + ".500000\n";
+    }
+    std::vector<uint8> data(text.begin(), text.end());
+
+    size_t compressedSize;
+    EXPECT_EQ(data, roundTrip(data, compressedSize));
+    EXPECT_LT(compressedSize, data.size() / 4);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Lz4_Test, random_data_round_trips) {
+    std::mt19937 random(11);
+    std::vector<uint8> data(100000);
+    for (uint8 & byte : data) {
+        byte = uint8(random());
+    }
+
+    size_t compressedSize;
+    EXPECT_EQ(data, roundTrip(data, compressedSize));
+    EXPECT_LE(compressedSize, Lz4::compressBound(data.size()));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Lz4_Test, tiny_and_empty_inputs_round_trip) {
+    for (size_t size = 0; size < 20; ++size) {
+        std::vector<uint8> data(size, 7);
+        size_t compressedSize;
+        EXPECT_EQ(data, roundTrip(data, compressedSize));
+        EXPECT_GT(compressedSize, 0u);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Lz4_Test, insufficient_output_capacity_returns_zero) {
+    std::vector<uint8> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = uint8(i * 7919 >> 3);
+    }
+    std::vector<uint8> compressed(10);
+    EXPECT_EQ(0u, Lz4::compress(data.data(), data.size(), compressed.data(),
+            compressed.size()));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Lz4_Test, malformed_blocks_throw) {
+    std::vector<uint8> data(4096, 'a');
+    std::vector<uint8> compressed(Lz4::compressBound(data.size()));
+    size_t compressedSize = Lz4::compress(data.data(), data.size(), compressed.data(),
+            compressed.size());
+
+    std::vector<uint8> output(data.size());
+
+    // Truncated block.
+    EXPECT_THROW(Lz4::decompress(compressed.data(), compressedSize - 3, output.data(),
+            output.size()), Rigid3DException);
+
+    // Wrong decompressed size.
+    EXPECT_THROW(Lz4::decompress(compressed.data(), compressedSize, output.data(),
+            output.size() - 1), Rigid3DException);
+
+    // Match offset before the start of the output.
+    const uint8 badOffset[] = { 0x10, 'x', 0x05, 0x00, 0x00 };
+    EXPECT_THROW(Lz4::decompress(badOffset, sizeof(badOffset), output.data(),
+            output.size()), Rigid3DException);
+}
@@ -0,0 +1,74 @@
+// ThreadPool_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/ThreadPool.hpp>
+using Rigid3D::ThreadPool;
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+//----------------------------------------------------------------------------------------
+TEST(ThreadPool_Test, parallel_for_visits_every_index_once) {
+    ThreadPool threadPool(4);
+    std::vector<int> visits(10000, 0);
+
+    threadPool.parallelFor(visits.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+
+    for (int count : visits) {
+        ASSERT_EQ(1, count);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ThreadPool_Test, parallel_for_with_empty_range_does_nothing) {
+    ThreadPool threadPool(2);
+    bool called = false;
+
+    threadPool.parallelFor(0, 16, [&](size_t, size_t) { called = true; });
+
+    EXPECT_FALSE(called);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ThreadPool_Test, nested_parallel_for_completes) {
+    ThreadPool threadPool(2);
+    std::atomic<int> sum(0);
+
+    threadPool.parallelFor(8, 1, [&](size_t, size_t) {
+        threadPool.parallelFor(8, 1, [&](size_t, size_t) {
+            ++sum;
+        });
+    });
+
+    EXPECT_EQ(64, sum.load());
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ThreadPool_Test, parallel_for_rethrows_exceptions) {
+    ThreadPool threadPool(2);
+
+    EXPECT_THROW(threadPool.parallelFor(100, 1, [](size_t begin, size_t) {
+        if (begin == 50) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ThreadPool_Test, wait_blocks_until_submitted_tasks_finish) {
+    ThreadPool threadPool(3);
+    std::atomic<int> count(0);
+
+    for (int i = 0; i < 100; ++i) {
+        threadPool.submit([&count] { ++count; });
+    }
+    threadPool.wait();
+
+    EXPECT_EQ(100, count.load());
+}
@@ -0,0 +1,148 @@
+// TlsfAllocator_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/TlsfAllocator.hpp>
+using Rigid3D::Rigid3DException;
+using Rigid3D::TlsfAllocator;
+using Rigid3D::uint32;
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+//----------------------------------------------------------------------------------------
+TEST(TlsfAllocator_Test, allocations_are_disjoint_and_within_capacity) {
+    TlsfAllocator allocator(1000);
+
+    TlsfAllocator::Allocation a;
+    TlsfAllocator::Allocation b;
+    ASSERT_TRUE(allocator.allocate(100, a));
+    ASSERT_TRUE(allocator.allocate(250, b));
+
+    EXPECT_EQ(100u, a.size);
+    EXPECT_EQ(250u, b.size);
+    EXPECT_TRUE(a.offset + a.size <= b.offset || b.offset + b.size <= a.offset);
+    EXPECT_LE(b.offset + b.size, 1000u);
+
+    TlsfAllocator::Stats stats = allocator.getStats();
+    EXPECT_EQ(350u, stats.numUnitsAllocated);
+    EXPECT_EQ(650u, stats.numUnitsFree);
+    EXPECT_EQ(2u, stats.numAllocations);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(TlsfAllocator_Test, allocation_fails_when_no_block_fits) {
+    TlsfAllocator allocator(64);
+
+    TlsfAllocator::Allocation a;
+    EXPECT_FALSE(allocator.allocate(65, a));
+    EXPECT_EQ(TlsfAllocator::InvalidBlock, a.block);
+
+    ASSERT_TRUE(allocator.allocate(64, a));
+    TlsfAllocator::Allocation b;
+    EXPECT_FALSE(allocator.allocate(1, b));
+
+    // Empty allocations always succeed and take no space.
+    EXPECT_TRUE(allocator.allocate(0, b));
+    EXPECT_EQ(0u, b.size);
+    allocator.free(b);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(TlsfAllocator_Test, freed_neighbours_are_merged) {
+    TlsfAllocator allocator(300);
+
+    TlsfAllocator::Allocation a;
+    TlsfAllocator::Allocation b;
+    TlsfAllocator::Allocation c;
+    ASSERT_TRUE(allocator.allocate(100, a));
+    ASSERT_TRUE(allocator.allocate(100, b));
+    ASSERT_TRUE(allocator.allocate(100, c));
+
+    allocator.free(a);
+    allocator.free(c);
+    EXPECT_EQ(2u, allocator.getStats().numFreeBlocks);
+    EXPECT_EQ(100u, allocator.getStats().largestFreeBlock);
+
+    // Freeing the middle block joins all three.
+    allocator.free(b);
+    EXPECT_EQ(1u, allocator.getStats().numFreeBlocks);
+    EXPECT_EQ(300u, allocator.getStats().largestFreeBlock);
+    EXPECT_EQ(TlsfAllocator::InvalidBlock, b.block);
+
+    TlsfAllocator::Allocation all;
+    EXPECT_TRUE(allocator.allocate(300, all));
+}
+
+//----------------------------------------------------------------------------------------
+TEST(TlsfAllocator_Test, freed_range_is_reused) {
+    TlsfAllocator allocator(1024);
+
+    TlsfAllocator::Allocation a;
+    TlsfAllocator::Allocation b;
+    ASSERT_TRUE(allocator.allocate(512, a));
+    ASSERT_TRUE(allocator.allocate(512, b));
+    const uint32 offset = a.offset;
+
+    allocator.free(a);
+    TlsfAllocator::Allocation c;
+    ASSERT_TRUE(allocator.allocate(300, c));
+    EXPECT_EQ(offset, c.offset);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(TlsfAllocator_Test, invalid_free_throws) {
+    TlsfAllocator allocator(100);
+
+    TlsfAllocator::Allocation a;
+    ASSERT_TRUE(allocator.allocate(10, a));
+    TlsfAllocator::Allocation copy = a;
+    allocator.free(a);
+
+    EXPECT_THROW(allocator.free(copy), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(TlsfAllocator_Test, random_allocations_never_overlap) {
+    const uint32 capacity = 1 << 16;
+    TlsfAllocator allocator(capacity);
+    std::vector<TlsfAllocator::Allocation> live;
+    std::mt19937 random(7);
+
+    for (int step = 0; step < 5000; ++step) {
+        if (live.empty() || random() % 3 != 0) {
+            TlsfAllocator::Allocation allocation;
+            if (allocator.allocate(1 + random() % 700, allocation)) {
+                live.push_back(allocation);
+            }
+        } else {
+            size_t index = random() % live.size();
+            allocator.free(live[index]);
+            live.erase(live.begin() + index);
+        }
+    }
+
+    std::vector<TlsfAllocator::Allocation> sorted = live;
+    std::sort(sorted.begin(), sorted.end(),
+            [](const TlsfAllocator::Allocation & a, const TlsfAllocator::Allocation & b) {
+                return a.offset < b.offset;
+            });
+
+    uint32 numUnits = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        numUnits += sorted[i].size;
+        ASSERT_LE(sorted[i].offset + sorted[i].size, capacity);
+        if (i > 0) {
+            ASSERT_LE(sorted[i - 1].offset + sorted[i - 1].size, sorted[i].offset);
+        }
+    }
+    EXPECT_EQ(numUnits, allocator.getStats().numUnitsAllocated);
+
+    for (TlsfAllocator::Allocation & allocation : live) {
+        allocator.free(allocation);
+    }
+    EXPECT_EQ(1u, allocator.getStats().numFreeBlocks);
+    EXPECT_EQ(capacity, allocator.getStats().largestFreeBlock);
+}
@@ -0,0 +1,83 @@
+// TripleBuffer_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/TripleBuffer.hpp>
+using Rigid3D::TripleBuffer;
+
+#include <thread>
+#include <vector>
+
+//----------------------------------------------------------------------------------------
+TEST(TripleBuffer_Test, acquire_fails_until_a_value_is_published) {
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.acquire());
+
+    buffer.getWriteBuffer() = 7;
+    buffer.publish();
+
+    EXPECT_TRUE(buffer.acquire());
+    EXPECT_EQ(7, buffer.getReadBuffer());
+    EXPECT_FALSE(buffer.acquire());
+    EXPECT_EQ(7, buffer.getReadBuffer());
+}
+
+//----------------------------------------------------------------------------------------
+TEST(TripleBuffer_Test, consumer_sees_latest_published_value) {
+    TripleBuffer<int> buffer;
+    for (int i = 1; i <= 3; ++i) {
+        buffer.getWriteBuffer() = i;
+        buffer.publish();
+    }
+
+    EXPECT_TRUE(buffer.acquire());
+    EXPECT_EQ(3, buffer.getReadBuffer());
+}
+
+//----------------------------------------------------------------------------------------
+TEST(TripleBuffer_Test, read_buffer_is_not_overwritten_by_producer) {
+    TripleBuffer<int> buffer;
+    buffer.getWriteBuffer() = 1;
+    buffer.publish();
+    ASSERT_TRUE(buffer.acquire());
+
+    // Two more publishes cycle through both slots not held by the consumer.
+    for (int i = 2; i <= 5; ++i) {
+        buffer.getWriteBuffer() = i;
+        buffer.publish();
+        EXPECT_EQ(1, buffer.getReadBuffer());
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST(TripleBuffer_Test, values_arrive_complete_and_in_order_across_threads) {
+    // Each value is a vector filled with a single number, so a torn handover shows
+    // up as a mix of numbers.
+    TripleBuffer<std::vector<int> > buffer;
+    const int numValues = 20000;
+
+    std::thread producer([&]() {
+        for (int i = 1; i <= numValues; ++i) {
+            buffer.getWriteBuffer().assign(64, i);
+            buffer.publish();
+        }
+    });
+
+    int last = 0;
+    while (last < numValues) {
+        if (!buffer.acquire()) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const std::vector<int> & value = buffer.getReadBuffer();
+        ASSERT_EQ(64u, value.size());
+        for (int element : value) {
+            ASSERT_EQ(value[0], element);
+        }
+        ASSERT_GT(value[0], last);
+        last = value[0];
+    }
+
+    producer.join();
+}
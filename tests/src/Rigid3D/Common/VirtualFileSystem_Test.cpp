@@ -0,0 +1,196 @@
+// VirtualFileSystem_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/AssetPackWriter.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/VirtualFileSystem.hpp>
+using namespace Rigid3D;
+
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {  // limit class visibility to this file.
+
+    const char * textFile = "VirtualFileSystem_Test.txt";
+    const char * otherTextFile = "VirtualFileSystem_Test_Other.txt";
+    const char * packFile = "VirtualFileSystem_Test.pack";
+    const char * logFile = "VirtualFileSystem_Test.log";
+
+    // Serves every path as its own contents, holding the first read until released.
+    class GatedBackend : public VirtualFileSystem::Backend {
+    public:
+        GatedBackend()
+            : started(false),
+              released(false) {
+
+        }
+
+        virtual bool exists(const char * path) const {
+            return std::string(path) != "missing";
+        }
+
+        virtual bool read(const char * path, std::vector<uint8> & data) const {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!exists(path)) {
+                return false;
+            }
+            started = true;
+            changed.notify_all();
+            changed.wait(lock, [this] { return released; });
+
+            data.assign(path, path + std::string(path).size());
+            order.push_back(path);
+            return true;
+        }
+
+        virtual bool prefetch(const char * path) const {
+            return exists(path);
+        }
+
+        void waitUntilStarted() {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return started; });
+        }
+
+        void release() {
+            std::lock_guard<std::mutex> lock(mutex);
+            released = true;
+            changed.notify_all();
+        }
+
+        mutable std::vector<std::string> order;
+
+    private:
+        mutable std::mutex mutex;
+        mutable std::condition_variable changed;
+        mutable bool started;
+        bool released;
+    };
+
+    class VirtualFileSystem_Test : public ::testing::Test {
+    protected:
+        // Ran before each test.
+        virtual void SetUp() {
+            writeText(textFile, "from directory");
+            writeText(otherTextFile, "only in directory");
+        }
+
+        // Ran after each test.
+        virtual void TearDown() {
+            std::remove(textFile);
+            std::remove(otherTextFile);
+            std::remove(packFile);
+            std::remove(logFile);
+        }
+
+        static void writeText(const char * filePath, const std::string & text) {
+            std::ofstream out(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+            out << text;
+        }
+
+        static std::string readText(VirtualFileSystem & files, const char * path) {
+            std::vector<uint8> data;
+            files.read(path, data);
+            return std::string(data.begin(), data.end());
+        }
+    };
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VirtualFileSystem_Test, directory_backend_reads_whole_files) {
+    VirtualFileSystem files(false);
+    files.mountDirectory(".");
+
+    EXPECT_TRUE(files.exists(textFile));
+    EXPECT_EQ("from directory", readText(files, textFile));
+
+    std::vector<uint8> data;
+    EXPECT_FALSE(files.exists("no/such/file.txt"));
+    EXPECT_FALSE(files.tryRead("no/such/file.txt", data));
+    EXPECT_THROW(files.read("no/such/file.txt", data), Rigid3DException);
+
+    files.unmountAll();
+    EXPECT_FALSE(files.exists(textFile));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VirtualFileSystem_Test, later_mounts_override_earlier_ones) {
+    const std::string packed = "from pack";
+    AssetPackWriter writer;
+    writer.add(textFile, packed.data(), packed.size(), true);
+    writer.write(packFile);
+
+    VirtualFileSystem files;
+    files.mountPack(packFile);
+
+    EXPECT_EQ(packed, readText(files, textFile));
+    EXPECT_EQ("only in directory", readText(files, otherTextFile));
+
+    EXPECT_THROW(files.mountPack("no_such.pack"), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VirtualFileSystem_Test, async_reads_are_served_by_priority) {
+    std::shared_ptr<GatedBackend> backend = std::make_shared<GatedBackend>();
+    VirtualFileSystem files(false);
+    files.mount(backend);
+
+    // Occupy the I/O thread while the rest are queued.
+    std::future<std::vector<uint8>> first = files.readAsync("first");
+    backend->waitUntilStarted();
+
+    std::future<std::vector<uint8>> background = files.readAsync("background", -1);
+    std::future<std::vector<uint8>> normal = files.readAsync("normal");
+    std::future<std::vector<uint8>> urgent = files.readAsync("urgent", 10);
+    std::future<std::vector<uint8>> normalAgain = files.readAsync("normal again");
+    std::future<std::vector<uint8>> missing = files.readAsync("missing");
+    backend->release();
+
+    std::vector<uint8> data = normalAgain.get();
+    EXPECT_EQ("normal again", std::string(data.begin(), data.end()));
+    background.get();
+    EXPECT_THROW(missing.get(), Rigid3DException);
+
+    std::vector<std::string> expectedOrder = {
+        "first", "urgent", "normal", "normal again", "background"
+    };
+    EXPECT_EQ(expectedOrder, backend->order);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(VirtualFileSystem_Test, access_log_replays_as_prefetch_hints) {
+    const std::string packed = "from pack";
+    AssetPackWriter writer;
+    writer.add("meshes/packed.obj", packed.data(), packed.size());
+    writer.write(packFile);
+
+    VirtualFileSystem files;
+    files.mountPack(packFile);
+    EXPECT_EQ(0u, files.prefetch(logFile));
+
+    std::vector<uint8> data;
+    files.read("./meshes/packed.obj", data);
+    files.read(textFile, data);
+    files.read("meshes/packed.obj", data);
+
+    std::vector<std::string> expectedLog = { "meshes/packed.obj", textFile };
+    EXPECT_EQ(expectedLog, files.getAccessLog());
+    files.saveAccessLog(logFile);
+
+    // Next launch.
+    VirtualFileSystem nextFiles;
+    nextFiles.mountPack(packFile);
+    std::remove(textFile);
+    EXPECT_EQ(1u, nextFiles.prefetch(logFile));
+
+    files.clearAccessLog();
+    files.setRecordAccesses(false);
+    files.read("meshes/packed.obj", data);
+    EXPECT_TRUE(files.getAccessLog().empty());
+}
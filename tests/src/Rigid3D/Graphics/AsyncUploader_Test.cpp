@@ -0,0 +1,222 @@
+// AsyncUploader_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/AsyncUploader.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class AsyncUploader_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<OpenGLContext> uploadContext;
+
+        AsyncUploader uploader;
+        GLuint buffer;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+
+            uploadContext = make_shared<OpenGLContext>(4, 1);
+            uploadContext->initShared(*glContext);
+        }
+
+        static void TearDownTestCase() {
+            uploadContext.reset();
+            glContext.reset();
+        }
+
+        // Ran before each test.
+        virtual void SetUp() {
+            glGenBuffers(1, &buffer);
+        }
+
+        // Ran after each test.
+        virtual void TearDown() {
+            uploader.stop();
+            glDeleteBuffers(1, &buffer);
+        }
+
+        void startUploader() {
+            OpenGLContext * context = uploadContext.get();
+            uploader.start([context] { context->makeCurrent(); },
+                           [] { OpenGLContext::releaseCurrent(); });
+        }
+
+        // Polls as a render loop would, giving up after a few seconds.
+        bool pollUntilComplete(AsyncUploader::UploadId id) {
+            for (int i = 0; i < 500; ++i) {
+                uploader.processCompleted();
+                if (uploader.isComplete(id)) {
+                    return true;
+                }
+                this_thread::sleep_for(chrono::milliseconds(10));
+            }
+            return false;
+        }
+
+        static vector<unsigned char> filledBytes(size_t count, unsigned char value) {
+            return vector<unsigned char>(count, value);
+        }
+
+        vector<unsigned char> readBuffer(size_t numBytes) {
+            vector<unsigned char> result(numBytes);
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            glGetBufferSubData(GL_COPY_READ_BUFFER, 0, GLsizeiptr(numBytes), result.data());
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            return result;
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> AsyncUploader_Test::glContext;
+    shared_ptr<OpenGLContext> AsyncUploader_Test::uploadContext;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(AsyncUploader_Test, test_buffer_upload_visible_on_render_context) {
+    startUploader();
+
+    vector<unsigned char> data(1 << 20);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (unsigned char)(i * 7);
+    }
+    vector<unsigned char> expected = data;
+
+    AsyncUploader::UploadId id = uploader.uploadBufferData(buffer, move(data), GL_STATIC_DRAW);
+    uploader.waitForCompletion(id);
+
+    EXPECT_TRUE(uploader.isComplete(id));
+    EXPECT_TRUE(expected == readBuffer(expected.size()));
+
+    AsyncUploader::Stats stats = uploader.getStats();
+    EXPECT_EQ(uint64(1), stats.numUploadsCompleted);
+    EXPECT_EQ(uint64(expected.size()), stats.numBytesUploaded);
+    EXPECT_EQ(size_t(0), stats.numPending);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(AsyncUploader_Test, test_texture_upload_through_staging_buffer) {
+    GLuint texture;
+    glGenTextures(1, &texture);
+
+    startUploader();
+
+    const int size = 8;
+    vector<unsigned char> pixels(size * size * 4);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = (unsigned char)i;
+    }
+    vector<unsigned char> expected = pixels;
+
+    TextureUpload destination;
+    destination.texture = texture;
+    destination.internalFormat = GL_RGBA8;
+    destination.width = size;
+    destination.height = size;
+
+    AsyncUploader::UploadId id = uploader.uploadTexture(destination, move(pixels));
+    ASSERT_TRUE(pollUntilComplete(id));
+
+    vector<unsigned char> result(expected.size());
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, result.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    EXPECT_TRUE(expected == result);
+
+    glDeleteTextures(1, &texture);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(AsyncUploader_Test, test_higher_priority_uploads_first) {
+    uploader.uploadBufferData(buffer, filledBytes(16, 0), GL_DYNAMIC_DRAW, 10);
+
+    // Queued before the worker starts, so only priority decides the order.
+    uploader.uploadBufferSubData(buffer, 0, filledBytes(16, 1), 0);
+    uploader.uploadBufferSubData(buffer, 0, filledBytes(16, 2), 5);
+    AsyncUploader::UploadId last = uploader.uploadBufferSubData(buffer, 0, filledBytes(8, 3), 0);
+
+    startUploader();
+    uploader.waitForCompletion(last);
+    for (AsyncUploader::UploadId id = 1; id <= last; ++id) {
+        uploader.waitForCompletion(id);
+    }
+
+    // Order run: 0 (priority 10), 2 (priority 5), 1 then 3 (priority 0, FIFO).
+    vector<unsigned char> result = readBuffer(16);
+    EXPECT_EQ(3, result[0]);
+    EXPECT_EQ(1, result[15]);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(AsyncUploader_Test, test_incomplete_until_fence_retired) {
+    AsyncUploader::UploadId id = uploader.uploadBufferData(buffer, filledBytes(64, 9),
+            GL_STATIC_DRAW);
+    EXPECT_FALSE(uploader.isComplete(id));
+    EXPECT_EQ(size_t(1), uploader.getStats().numPending);
+
+    startUploader();
+    ASSERT_TRUE(pollUntilComplete(id));
+
+    EXPECT_EQ(9, readBuffer(64)[63]);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(AsyncUploader_Test, test_stop_cancels_queued_uploads) {
+    AsyncUploader::UploadId issued = uploader.uploadBufferData(buffer, filledBytes(16, 1),
+            GL_STATIC_DRAW);
+    startUploader();
+    ASSERT_TRUE(pollUntilComplete(issued));
+
+    // Hold the worker before its loop, so that the next request is still queued
+    // when stop() is called.
+    promise<void> release;
+    shared_future<void> released = release.get_future().share();
+    uploader.stop();
+    OpenGLContext * context = uploadContext.get();
+    uploader.start([context, released] { released.wait(); context->makeCurrent(); },
+                   [] { OpenGLContext::releaseCurrent(); });
+
+    AsyncUploader::UploadId queued = uploader.uploadBufferData(buffer, filledBytes(16, 2),
+            GL_STATIC_DRAW);
+    thread releaser([&release] {
+        this_thread::sleep_for(chrono::milliseconds(100));
+        release.set_value();
+    });
+    uploader.stop();
+    releaser.join();
+
+    EXPECT_EQ(AsyncUploader::Status::Complete, uploader.getStatus(issued));
+    EXPECT_EQ(AsyncUploader::Status::Cancelled, uploader.getStatus(queued));
+    EXPECT_FALSE(uploader.isComplete(queued));
+    EXPECT_THROW(uploader.waitForCompletion(queued), Rigid3DException);
+    EXPECT_EQ(1, readBuffer(16)[0]);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(AsyncUploader_Test, test_wait_throws_after_worker_failure) {
+    AsyncUploader::UploadId id = uploader.uploadBufferData(buffer, filledBytes(16, 1),
+            GL_STATIC_DRAW);
+    uploader.start([] { throw Rigid3DException("No upload context"); },
+                   [] { });
+
+    // The first call rethrows the worker's exception, later calls must not block.
+    EXPECT_THROW(uploader.waitForCompletion(id), Rigid3DException);
+    EXPECT_THROW(uploader.waitForCompletion(id), Rigid3DException);
+    EXPECT_EQ(AsyncUploader::Status::Pending, uploader.getStatus(id));
+}
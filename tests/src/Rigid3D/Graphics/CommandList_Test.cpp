@@ -0,0 +1,144 @@
+// CommandList_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Graphics/CommandList.hpp>
+using namespace Rigid3D;
+
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class CommandList_Test : public ::testing::Test {
+    protected:
+        CommandList commandList;
+    };
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandList_Test, test_empty_list) {
+    EXPECT_TRUE(commandList.isEmpty());
+    EXPECT_EQ(size_t(0), commandList.getNumCommands());
+    EXPECT_EQ(size_t(0), commandList.getNumBytes());
+
+    CommandList::Reader reader(commandList);
+    EXPECT_FALSE(reader.next());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandList_Test, test_commands_read_back_in_order) {
+    mat4 modelView(2.0f);
+    modelView[3] = vec4(1.0f, 2.0f, 3.0f, 1.0f);
+
+    commandList.useProgram(7);
+    commandList.bindVertexArray(3);
+    commandList.bindTexture(1, TextureTarget::Texture2DArray, 12);
+    commandList.setUniform(4, modelView);
+    commandList.setUniform(5, vec3(0.5f, 0.25f, 0.125f));
+    commandList.setUniform(6, 0.75f);
+    commandList.setUniform(8, int32(-2));
+    commandList.draw(PrimitiveType::Triangles, 30, 36);
+    commandList.drawInstanced(PrimitiveType::TriangleStrip, 0, 4, 100);
+    commandList.drawIndexed(PrimitiveType::Triangles, 60, 24, -5);
+
+    EXPECT_EQ(size_t(10), commandList.getNumCommands());
+    EXPECT_EQ(size_t(0), commandList.getNumBytes() % 4);
+
+    CommandList::Reader reader(commandList);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::UseProgram, reader.getType());
+    EXPECT_EQ(uint32(7), reader.get<Commands::UseProgram>().program);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::BindVertexArray, reader.getType());
+    EXPECT_EQ(uint32(3), reader.get<Commands::BindVertexArray>().vertexArray);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::BindTexture, reader.getType());
+    EXPECT_EQ(uint32(1), reader.get<Commands::BindTexture>().unit);
+    EXPECT_EQ(TextureTarget::Texture2DArray, reader.get<Commands::BindTexture>().target);
+    EXPECT_EQ(uint32(12), reader.get<Commands::BindTexture>().texture);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::SetUniformMat4, reader.getType());
+    EXPECT_EQ(int32(4), reader.get<Commands::SetUniformMat4>().location);
+    EXPECT_TRUE(modelView == reader.get<Commands::SetUniformMat4>().value);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::SetUniformVec3, reader.getType());
+    EXPECT_TRUE(vec3(0.5f, 0.25f, 0.125f) == reader.get<Commands::SetUniformVec3>().value);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::SetUniformFloat, reader.getType());
+    EXPECT_EQ(0.75f, reader.get<Commands::SetUniformFloat>().value);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::SetUniformInt, reader.getType());
+    EXPECT_EQ(int32(8), reader.get<Commands::SetUniformInt>().location);
+    EXPECT_EQ(int32(-2), reader.get<Commands::SetUniformInt>().value);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::Draw, reader.getType());
+    EXPECT_EQ(PrimitiveType::Triangles, reader.get<Commands::Draw>().primitive);
+    EXPECT_EQ(uint32(30), reader.get<Commands::Draw>().first);
+    EXPECT_EQ(uint32(36), reader.get<Commands::Draw>().count);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::DrawInstanced, reader.getType());
+    EXPECT_EQ(uint32(100), reader.get<Commands::DrawInstanced>().instanceCount);
+
+    ASSERT_TRUE(reader.next());
+    ASSERT_EQ(CommandType::DrawIndexed, reader.getType());
+    EXPECT_EQ(uint32(60), reader.get<Commands::DrawIndexed>().firstIndex);
+    EXPECT_EQ(uint32(24), reader.get<Commands::DrawIndexed>().count);
+    EXPECT_EQ(int32(-5), reader.get<Commands::DrawIndexed>().baseVertex);
+
+    EXPECT_FALSE(reader.next());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandList_Test, test_append_concatenates_lists) {
+    CommandList first;
+    first.useProgram(1);
+    first.draw(PrimitiveType::Triangles, 0, 3);
+
+    CommandList second;
+    second.useProgram(2);
+    second.draw(PrimitiveType::Lines, 3, 2);
+
+    commandList.append(first);
+    commandList.append(second);
+
+    EXPECT_EQ(size_t(4), commandList.getNumCommands());
+    EXPECT_EQ(first.getNumBytes() + second.getNumBytes(), commandList.getNumBytes());
+
+    vector<uint32> programs;
+    for (CommandList::Reader reader(commandList); reader.next(); ) {
+        if (reader.getType() == CommandType::UseProgram) {
+            programs.push_back(reader.get<Commands::UseProgram>().program);
+        }
+    }
+    ASSERT_EQ(size_t(2), programs.size());
+    EXPECT_EQ(uint32(1), programs[0]);
+    EXPECT_EQ(uint32(2), programs[1]);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandList_Test, test_clear_keeps_buffer) {
+    for (int i = 0; i < 100; ++i) {
+        commandList.setUniform(0, mat4());
+    }
+    const unsigned char * data = commandList.getData();
+
+    commandList.clear();
+    EXPECT_TRUE(commandList.isEmpty());
+    EXPECT_EQ(size_t(0), commandList.getNumBytes());
+
+    for (int i = 0; i < 100; ++i) {
+        commandList.setUniform(0, mat4());
+    }
+    EXPECT_EQ(data, commandList.getData());
+}
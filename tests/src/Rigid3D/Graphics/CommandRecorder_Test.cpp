@@ -0,0 +1,265 @@
+// CommandRecorder_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+#include <Rigid3D/Graphics/CommandList.hpp>
+#include <Rigid3D/Graphics/CommandRecorder.hpp>
+#include <Rigid3D/Graphics/FramePacket.hpp>
+#include <Rigid3D/Graphics/GlCommandExecutor.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class CommandRecorder_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> shaderProgram;
+        static GLuint vao;
+        static GLuint framebuffer;
+        static GLuint colorBuffer;
+
+        BatchInfo batchInfo;
+        RenderContext renderContext;
+        vector<Renderable> objects;
+        vector<Renderable *> renderables;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+
+            shaderProgram = make_shared<ShaderProgram>();
+            shaderProgram->generateProgramObject();
+            shaderProgram->attachVertexShader("../../data/shaders/PerFragLighting.vert");
+            shaderProgram->attachFragmentShader("../../data/shaders/PerFragLighting.frag");
+            shaderProgram->link();
+
+            glGenVertexArrays(1, &vao);
+
+            // Draw into an offscreen target so tests do not depend on a window.
+            glGenRenderbuffers(1, &colorBuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 16, 16);
+            glGenFramebuffers(1, &framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                    GL_RENDERBUFFER, colorBuffer);
+        }
+
+        static void TearDownTestCase() {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &framebuffer);
+            glDeleteRenderbuffers(1, &colorBuffer);
+            glDeleteVertexArrays(1, &vao);
+            shaderProgram.reset();
+            glContext.reset();
+        }
+
+        // Ran before each test.
+        virtual void SetUp() {
+            batchInfo.startIndex = 0;
+            batchInfo.numIndices = 3;
+
+            renderContext.viewMatrix = glm::translate(mat4(), vec3(0.0f, 0.0f, -10.0f));
+            renderContext.projectionMatrix = glm::perspective(glm::radians(60.0f), 1.0f, 1.0f, 100.0f);
+        }
+
+        void createRenderables(size_t count) {
+            objects.assign(count, Renderable(&vao, shaderProgram.get(), &batchInfo));
+            renderables.clear();
+            for (size_t i = 0; i < count; ++i) {
+                objects[i].setPosition(vec3(float(i), 0.0f, 0.0f));
+                objects[i].setDiffuseLevels(vec3(float(i) / count));
+                renderables.push_back(&objects[i]);
+            }
+        }
+
+        static CommandList concatenate(const vector<CommandList> & commandLists) {
+            CommandList result;
+            for (const CommandList & commandList : commandLists) {
+                result.append(commandList);
+            }
+            return result;
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> CommandRecorder_Test::glContext;
+    shared_ptr<ShaderProgram> CommandRecorder_Test::shaderProgram;
+    GLuint CommandRecorder_Test::vao = 0;
+    GLuint CommandRecorder_Test::framebuffer = 0;
+    GLuint CommandRecorder_Test::colorBuffer = 0;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandRecorder_Test, test_parallel_recording_matches_serial) {
+    createRenderables(1000);
+
+    CommandRecorder serialRecorder(nullptr, 64);
+    serialRecorder.prepare(renderables);
+    CommandList serial = concatenate(serialRecorder.record(renderables, renderContext));
+
+    ThreadPool threadPool(4);
+    CommandRecorder parallelRecorder(&threadPool, 64);
+    parallelRecorder.prepare(renderables);
+    const vector<CommandList> & lists = parallelRecorder.record(renderables, renderContext);
+    CommandList parallel = concatenate(lists);
+
+    EXPECT_EQ(size_t(16), lists.size());
+    EXPECT_EQ(serial.getNumCommands(), parallel.getNumCommands());
+    ASSERT_EQ(serial.getNumBytes(), parallel.getNumBytes());
+    EXPECT_EQ(0, memcmp(serial.getData(), parallel.getData(), serial.getNumBytes()));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandRecorder_Test, test_unprepared_program_throws) {
+    createRenderables(10);
+
+    ThreadPool threadPool(2);
+    CommandRecorder recorder(&threadPool, 2);
+    EXPECT_FALSE(recorder.hasUniformLocations(shaderProgram.get()));
+    EXPECT_THROW(recorder.record(renderables, renderContext), Rigid3DException);
+
+    recorder.prepare(renderables);
+    EXPECT_TRUE(recorder.hasUniformLocations(shaderProgram.get()));
+    EXPECT_NO_THROW(recorder.record(renderables, renderContext));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandRecorder_Test, test_lists_are_reused_between_frames) {
+    createRenderables(100);
+
+    CommandRecorder recorder(nullptr, 10);
+    recorder.prepare(renderables);
+    recorder.record(renderables, renderContext);
+    const unsigned char * data = recorder.getCommandLists()[0].getData();
+
+    // Fewer renderables leave trailing lists empty rather than freeing them.
+    renderables.resize(35);
+    const vector<CommandList> & lists = recorder.record(renderables, renderContext);
+
+    ASSERT_EQ(size_t(10), lists.size());
+    EXPECT_EQ(data, lists[0].getData());
+    EXPECT_FALSE(lists[3].isEmpty());
+    EXPECT_TRUE(lists[4].isEmpty());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandRecorder_Test, test_executed_uniforms_match_renderable) {
+    createRenderables(2);
+
+    CommandRecorder recorder(nullptr, 1);
+    recorder.prepare(renderables);
+    recorder.record(renderables, renderContext);
+
+    GlCommandExecutor executor;
+    executor.execute(recorder.getCommandLists());
+
+    // Program and vertex array binds for the second list are redundant.
+    EXPECT_EQ(size_t(2), executor.getStats().numDrawCalls);
+    EXPECT_EQ(size_t(2), executor.getStats().numSkippedBinds);
+
+    GLint program;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    EXPECT_EQ(0, program);
+
+    // Uniforms hold the values of the last Renderable drawn.
+    mat4 expected = renderContext.viewMatrix * objects[1].getModelMatrix();
+    mat4 modelView;
+    glGetUniformfv(shaderProgram->getProgramObject(),
+            shaderProgram->getUniformLocation("ModelViewMatrix"), &modelView[0][0]);
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            EXPECT_FLOAT_EQ(expected[i][j], modelView[i][j]);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandRecorder_Test, test_executor_restores_program_and_active_texture) {
+    GLuint texture;
+    glGenTextures(1, &texture);
+
+    CommandList commandList;
+    commandList.useProgram(shaderProgram->getProgramObject());
+    commandList.bindTexture(3, TextureTarget::Texture2D, texture);
+
+    glUseProgram(0);
+    glActiveTexture(GL_TEXTURE1);
+
+    GlCommandExecutor executor;
+    executor.execute(commandList);
+
+    GLint program, activeTexture;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+    EXPECT_EQ(0, program);
+    EXPECT_EQ(GL_TEXTURE1, activeTexture);
+
+    // A program bound by the caller is kept, rather than reset to zero.
+    shaderProgram->enable();
+    executor.execute(commandList);
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    EXPECT_EQ(GLint(shaderProgram->getProgramObject()), program);
+    EXPECT_EQ(size_t(1), executor.getStats().numSkippedBinds);
+
+    glUseProgram(0);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glDeleteTextures(1, &texture);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CommandRecorder_Test, test_frame_packet_records_one_list_per_view) {
+    createRenderables(3);
+
+    FramePacket packet;
+    packet.renderContext = renderContext;
+    for (const Renderable & object : objects) {
+        packet.addRenderable(object);
+    }
+
+    packet.render();
+    const unsigned char * data = packet.commandList.getData();
+
+    // Every item is in the one list, and one set of uniform locations serves them.
+    size_t numPrograms = 0;
+    size_t numDraws = 0;
+    for (CommandList::Reader reader(packet.commandList); reader.next(); ) {
+        numPrograms += (reader.getType() == CommandType::UseProgram) ? 1 : 0;
+        numDraws += (reader.getType() == CommandType::Draw) ? 1 : 0;
+    }
+    EXPECT_EQ(size_t(3), numPrograms);
+    EXPECT_EQ(size_t(3), numDraws);
+    EXPECT_EQ(size_t(1), packet.uniformLocations.size());
+
+    mat4 expected = renderContext.viewMatrix * objects[2].getModelMatrix();
+    mat4 modelView;
+    glGetUniformfv(shaderProgram->getProgramObject(),
+            shaderProgram->getUniformLocation("ModelViewMatrix"), &modelView[0][0]);
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            EXPECT_FLOAT_EQ(expected[i][j], modelView[i][j]);
+        }
+    }
+
+    // The list is reused by the next frame.
+    packet.render();
+    EXPECT_EQ(data, packet.commandList.getData());
+}
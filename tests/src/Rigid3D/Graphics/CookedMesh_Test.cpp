@@ -0,0 +1,137 @@
+/**
+ * @brief CookedMesh_Test
+ */
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/CookedMesh.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/OccluderGenerator.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+using namespace Rigid3D;
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {  // limit class visibility to this file.
+
+    const char * cookedFile = "CookedMesh_Test.mesh";
+
+    class CookedMesh_Test : public ::testing::Test {
+    protected:
+        // Ran after each test.
+        virtual void TearDown() {
+            std::remove(cookedFile);
+        }
+    };
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CookedMesh_Test, round_trip_preserves_mesh_and_occluder) {
+    Mesh mesh("../data/meshes/cube_textured.obj");
+
+    OccluderSettings settings;
+    settings.resolution = 8;
+    Occluder occluder;
+    OccluderGenerator::generate(mesh, settings, occluder);
+
+    CookedMesh::write(cookedFile, mesh, occluder);
+
+    Mesh cooked;
+    Occluder cookedOccluder;
+    CookedMesh::read(cookedFile, cooked, cookedOccluder);
+
+    ASSERT_EQ(mesh.getNumVertexPositions(), cooked.getNumVertexPositions());
+    ASSERT_EQ(mesh.getNumVertexNormals(), cooked.getNumVertexNormals());
+    ASSERT_EQ(mesh.getNumTextureCoords(), cooked.getNumTextureCoords());
+    EXPECT_EQ(0, std::memcmp(mesh.getVertexPositionDataPtr(), cooked.getVertexPositionDataPtr(),
+            mesh.getNumVertexPositionBytes()));
+    EXPECT_EQ(0, std::memcmp(mesh.getVertexNormalDataPtr(), cooked.getVertexNormalDataPtr(),
+            mesh.getNumVertexNormalBytes()));
+    EXPECT_EQ(0, std::memcmp(mesh.getTextureCoordDataPtr(), cooked.getTextureCoordDataPtr(),
+            mesh.getNumTextureCoordBytes()));
+
+    EXPECT_EQ(occluder.boxes.size(), cookedOccluder.boxes.size());
+    EXPECT_EQ(occluder.getNumTriangles(), cookedOccluder.getNumTriangles());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CookedMesh_Test, compressed_round_trip_preserves_mesh_and_occluder) {
+    ThreadPool threadPool(4);
+    Mesh mesh("../data/meshes/cube_smooth.obj");
+
+    OccluderSettings settings;
+    settings.resolution = 8;
+    Occluder occluder;
+    OccluderGenerator::generate(mesh, settings, occluder);
+
+    CookedMesh::write(cookedFile, mesh, occluder, CookedMesh::CompressedChunks, &threadPool);
+
+    Mesh cooked;
+    Occluder cookedOccluder;
+    CookedMesh::read(cookedFile, cooked, cookedOccluder, &threadPool);
+
+    ASSERT_EQ(mesh.getNumVertexPositions(), cooked.getNumVertexPositions());
+    ASSERT_EQ(mesh.getNumVertexNormals(), cooked.getNumVertexNormals());
+    EXPECT_EQ(0, std::memcmp(mesh.getVertexPositionDataPtr(), cooked.getVertexPositionDataPtr(),
+            mesh.getNumVertexPositionBytes()));
+    EXPECT_EQ(0, std::memcmp(mesh.getVertexNormalDataPtr(), cooked.getVertexNormalDataPtr(),
+            mesh.getNumVertexNormalBytes()));
+
+    EXPECT_EQ(occluder.boxes.size(), cookedOccluder.boxes.size());
+    EXPECT_EQ(occluder.getNumTriangles(), cookedOccluder.getNumTriangles());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CookedMesh_Test, bool_compress_sets_only_compressed_chunks_flag) {
+    Mesh mesh("../data/meshes/cube_smooth.obj");
+    Occluder occluder;
+
+    CookedMesh::write(cookedFile, mesh, occluder, true);
+
+    // Magic, version and chunk count precede the flags.
+    uint32 header[4];
+    std::ifstream in(cookedFile, std::ios::in | std::ios::binary);
+    ASSERT_TRUE(in.read(reinterpret_cast<char *>(header), sizeof(header)).good());
+    EXPECT_EQ(CookedMesh::CompressedChunks, header[3]);
+    in.close();
+
+    Mesh cooked;
+    CookedMesh::read(cookedFile, cooked);
+    ASSERT_EQ(mesh.getNumVertexPositions(), cooked.getNumVertexPositions());
+    EXPECT_EQ(0, std::memcmp(mesh.getVertexPositionDataPtr(), cooked.getVertexPositionDataPtr(),
+            mesh.getNumVertexPositionBytes()));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CookedMesh_Test, encoded_vertices_round_trip_within_quantization_error) {
+    Mesh mesh("../data/meshes/cube_smooth.obj");
+    Occluder occluder;
+
+    CookedMesh::write(cookedFile, mesh, occluder, CookedMesh::EncodedVertices);
+
+    Mesh cooked;
+    CookedMesh::read(cookedFile, cooked);
+
+    ASSERT_EQ(mesh.getNumVertexPositions(), cooked.getNumVertexPositions());
+    ASSERT_EQ(mesh.getNumVertexNormals(), cooked.getNumVertexNormals());
+
+    // Triangles may be reordered, so compare bounds.
+    vec3 minimum(1e9f);
+    vec3 cookedMinimum(1e9f);
+    for (unsigned int i = 0; i < mesh.getNumVertexPositions(); ++i) {
+        minimum = glm::min(minimum, (*mesh.getVertexPositionVector())[i]);
+        cookedMinimum = glm::min(cookedMinimum, (*cooked.getVertexPositionVector())[i]);
+    }
+    EXPECT_NEAR(minimum.x, cookedMinimum.x, 1e-4f);
+    EXPECT_NEAR(minimum.y, cookedMinimum.y, 1e-4f);
+    EXPECT_NEAR(minimum.z, cookedMinimum.z, 1e-4f);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CookedMesh_Test, reading_obj_file_throws) {
+    Mesh mesh;
+    EXPECT_THROW(CookedMesh::read("../data/meshes/cube.obj", mesh), Rigid3DException);
+}
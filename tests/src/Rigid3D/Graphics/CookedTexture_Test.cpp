@@ -0,0 +1,78 @@
+/**
+ * @brief CookedTexture_Test
+ */
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/CookedTexture.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+using namespace Rigid3D;
+
+#include <cstdio>
+#include <vector>
+
+namespace {  // limit class visibility to this file.
+
+    const char * cookedFile = "CookedTexture_Test.tex";
+
+    class CookedTexture_Test : public ::testing::Test {
+    protected:
+        // Ran after each test.
+        virtual void TearDown() {
+            std::remove(cookedFile);
+        }
+    };
+
+    std::vector<uint8> makeCheckerboard(uint32 width, uint32 height) {
+        std::vector<uint8> pixels(size_t(width) * height * 4);
+        for (uint32 y = 0; y < height; ++y) {
+            for (uint32 x = 0; x < width; ++x) {
+                const uint8 value = ((x / 8 + y / 8) % 2 == 0) ? 255 : 0;
+                uint8 * pixel = &pixels[(size_t(y) * width + x) * 4];
+                pixel[0] = value;
+                pixel[1] = uint8(x);
+                pixel[2] = uint8(y);
+                pixel[3] = 255;
+            }
+        }
+        return pixels;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CookedTexture_Test, uncompressed_round_trip) {
+    const std::vector<uint8> pixels = makeCheckerboard(64, 32);
+    CookedTexture::write(cookedFile, 64, 32, pixels.data());
+
+    CookedTexture texture(cookedFile);
+    EXPECT_EQ(64u, texture.getWidth());
+    EXPECT_EQ(32u, texture.getHeight());
+    EXPECT_EQ(pixels.size(), texture.getNumBytes());
+    EXPECT_FALSE(texture.isCompressed());
+
+    std::vector<uint8> cooked;
+    texture.decompress(cooked);
+    EXPECT_EQ(pixels, cooked);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CookedTexture_Test, compressed_round_trip_decompresses_in_place) {
+    ThreadPool threadPool(4);
+    const std::vector<uint8> pixels = makeCheckerboard(512, 512);
+    CookedTexture::write(cookedFile, 512, 512, pixels.data(), true, &threadPool);
+
+    CookedTexture texture(cookedFile);
+    EXPECT_TRUE(texture.isCompressed());
+
+    std::vector<uint8> destination(texture.getNumBytes());
+    texture.decompress(destination.data(), &threadPool);
+    EXPECT_EQ(pixels, destination);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(CookedTexture_Test, reading_other_files_throws) {
+    CookedTexture texture;
+    EXPECT_THROW(texture.read("../data/meshes/cube.obj"), Rigid3DException);
+    EXPECT_THROW(texture.read("missing.tex"), Rigid3DException);
+}
@@ -0,0 +1,250 @@
+// DynamicResolution_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/DynamicResolution.hpp>
+#include <Rigid3D/Graphics/GpuTimer.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <cmath>
+#include <memory>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class ResolutionController_Test : public ::testing::Test {
+    protected:
+        // Fill-bound load taking 'fullResolutionMilliseconds' at a scale of 1.
+        static double gpuTime(double fullResolutionMilliseconds, float scale) {
+            return fullResolutionMilliseconds * scale * scale;
+        }
+    };
+
+    class DynamicResolution_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+        }
+
+        static void TearDownTestCase() {
+            glContext.reset();
+        }
+    };
+
+}
+
+shared_ptr<OpenGLContext> DynamicResolution_Test::glContext = nullptr;
+
+//---------------------------------------------------------------------------------------
+TEST_F(ResolutionController_Test, test_starts_at_max_scale) {
+    DynamicResolutionSettings settings;
+    settings.maxScale = 0.9f;
+    ResolutionController controller(settings);
+
+    EXPECT_FLOAT_EQ(0.9f, controller.getScale());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ResolutionController_Test, test_error_within_hysteresis_keeps_scale) {
+    DynamicResolutionSettings settings;
+    settings.targetMilliseconds = 10.0;
+    settings.hysteresis = 0.1f;
+    ResolutionController controller(settings);
+
+    for (int i = 0; i < 20; ++i) {
+        controller.update(10.9);
+        controller.update(9.1);
+    }
+    EXPECT_FLOAT_EQ(1.0f, controller.getScale());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ResolutionController_Test, test_change_per_update_is_limited_and_rounded) {
+    DynamicResolutionSettings settings;
+    settings.targetMilliseconds = 10.0;
+    settings.maxScaleChange = 0.1f;
+    settings.scaleGranularity = 0.05f;
+    ResolutionController controller(settings);
+
+    float previousScale = controller.getScale();
+    for (int i = 0; i < 3; ++i) {
+        float scale = controller.update(40.0);
+        EXPECT_LE(previousScale - scale, 0.1f + 1.0e-5f);
+        EXPECT_LT(scale, previousScale);
+
+        float steps = scale / settings.scaleGranularity;
+        EXPECT_NEAR(std::floor(steps + 0.5f), steps, 1.0e-4f);
+        previousScale = scale;
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ResolutionController_Test, test_granularity_coarser_than_max_change_still_moves) {
+    DynamicResolutionSettings settings;
+    settings.targetMilliseconds = 10.0;
+    settings.maxScaleChange = 0.02f;
+    settings.scaleGranularity = 0.1f;
+    ResolutionController controller(settings);
+
+    EXPECT_FLOAT_EQ(0.9f, controller.update(gpuTime(40.0, controller.getScale())));
+    EXPECT_FLOAT_EQ(0.8f, controller.update(gpuTime(40.0, controller.getScale())));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ResolutionController_Test, test_sustained_overload_stops_at_min_scale) {
+    DynamicResolutionSettings settings;
+    settings.targetMilliseconds = 10.0;
+    settings.minScale = 0.6f;
+    ResolutionController controller(settings);
+
+    for (int i = 0; i < 100; ++i) {
+        controller.update(gpuTime(100.0, controller.getScale()));
+    }
+    EXPECT_FLOAT_EQ(0.6f, controller.getScale());
+
+    // Nothing winds up while limited, so recovery is immediate.
+    controller.update(gpuTime(5.0, controller.getScale()));
+    EXPECT_GT(controller.getScale(), 0.6f);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ResolutionController_Test, test_converges_to_scale_meeting_target) {
+    DynamicResolutionSettings settings;
+    settings.targetMilliseconds = 10.0;
+    ResolutionController controller(settings);
+
+    // Twice the budget at full resolution, met at a scale of sqrt(1/2).
+    for (int i = 0; i < 100; ++i) {
+        controller.update(gpuTime(20.0, controller.getScale()));
+    }
+    const float settledScale = controller.getScale();
+    EXPECT_NEAR(std::sqrt(0.5f), settledScale, 0.05f);
+
+    // Settled, rather than oscillating.
+    for (int i = 0; i < 20; ++i) {
+        controller.update(gpuTime(20.0, controller.getScale()));
+        EXPECT_FLOAT_EQ(settledScale, controller.getScale());
+    }
+
+    // Load drops, resolution returns to full.
+    for (int i = 0; i < 100; ++i) {
+        controller.update(gpuTime(5.0, controller.getScale()));
+    }
+    EXPECT_FLOAT_EQ(1.0f, controller.getScale());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ResolutionController_Test, test_invalid_settings_throw) {
+    ResolutionController controller;
+    DynamicResolutionSettings settings;
+    settings.minScale = 0.8f;
+    settings.maxScale = 0.5f;
+
+    EXPECT_THROW(controller.setSettings(settings), Rigid3DException);
+    EXPECT_THROW(ResolutionController invalid(settings), Rigid3DException);
+
+    settings.minScale = 0.5f;
+    settings.maxScaleChange = 0.0f;
+    EXPECT_THROW(ResolutionController invalid(settings), Rigid3DException);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(DynamicResolution_Test, test_gpu_timer_results_arrive_in_order) {
+    GpuTimer timer(2);
+
+    EXPECT_TRUE(timer.begin());
+    timer.end();
+    EXPECT_TRUE(timer.begin());
+    timer.end();
+
+    // Both queries are in flight.
+    EXPECT_FALSE(timer.begin());
+    timer.end();
+    EXPECT_EQ(2u, timer.getNumPendingQueries());
+
+    glFinish();
+    double milliseconds = -1.0;
+    EXPECT_TRUE(timer.getResult(milliseconds));
+    EXPECT_GE(milliseconds, 0.0);
+    EXPECT_TRUE(timer.getResult(milliseconds));
+    EXPECT_FALSE(timer.getResult(milliseconds));
+    EXPECT_EQ(0u, timer.getNumPendingQueries());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(DynamicResolution_Test, test_begin_frame_before_resize_throws) {
+    RenderTargetPool pool;
+    DynamicResolution dynamicResolution(pool);
+
+    EXPECT_THROW(dynamicResolution.beginFrame(), Rigid3DException);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(DynamicResolution_Test, test_render_size_follows_scale_bounds) {
+    RenderTargetPool pool;
+    DynamicResolutionSettings settings;
+    settings.minScale = 0.5f;
+    settings.maxScale = 0.5f;
+    DynamicResolution dynamicResolution(pool, settings);
+
+    dynamicResolution.resize(64, 32);
+    EXPECT_EQ(32, dynamicResolution.getRenderWidth());
+    EXPECT_EQ(16, dynamicResolution.getRenderHeight());
+    EXPECT_EQ(32, dynamicResolution.getRenderTarget().width);
+
+    // A larger maximum reallocates the target, the render size follows the scale.
+    settings.maxScale = 1.0f;
+    dynamicResolution.setSettings(settings);
+    EXPECT_EQ(64, dynamicResolution.getRenderTarget().width);
+    EXPECT_EQ(32, dynamicResolution.getRenderWidth());
+    // The old color and depth textures may still be in use by the GPU.
+    EXPECT_EQ(2u, pool.getStats().numTexturesPendingRelease);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(DynamicResolution_Test, test_end_frame_upsamples_to_output) {
+    RenderTargetPool pool;
+    RenderTarget output = pool.acquireRenderTarget({ RenderTargetDesc(64, 64, GL_RGBA8) });
+
+    DynamicResolutionSettings settings;
+    settings.minScale = 0.5f;
+    settings.maxScale = 0.5f;
+    DynamicResolution dynamicResolution(pool, settings);
+    dynamicResolution.resize(64, 64);
+
+    dynamicResolution.beginFrame();
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    EXPECT_EQ(32, viewport[2]);
+    EXPECT_EQ(32, viewport[3]);
+
+    glClearColor(0.0f, 1.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    dynamicResolution.endFrame(output.framebuffer);
+
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    EXPECT_EQ(64, viewport[2]);
+    EXPECT_EQ(64, viewport[3]);
+
+    GLubyte pixel[4] = { 0, 0, 0, 0 };
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, output.framebuffer);
+    glReadPixels(63, 63, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    EXPECT_EQ(0, pixel[0]);
+    EXPECT_EQ(255, pixel[1]);
+    EXPECT_EQ(0, pixel[2]);
+
+    glFinish();
+    dynamicResolution.beginFrame();
+    dynamicResolution.endFrame(output.framebuffer);
+    EXPECT_GE(dynamicResolution.getGpuMilliseconds(), 0.0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    pool.releaseRenderTarget(output);
+}
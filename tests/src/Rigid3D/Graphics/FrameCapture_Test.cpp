@@ -0,0 +1,161 @@
+// FrameCapture_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/FrameCapture.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <LoadPNG/lodepng.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    const int width = 16;
+    const int height = 8;
+
+    class FrameCapture_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static GLuint framebuffer;
+        static GLuint colorBuffer;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+
+            glGenRenderbuffers(1, &colorBuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+            glGenFramebuffers(1, &framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                    GL_RENDERBUFFER, colorBuffer);
+        }
+
+        static void TearDownTestCase() {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &framebuffer);
+            glDeleteRenderbuffers(1, &colorBuffer);
+            glContext.reset();
+        }
+
+        // Renders a frame whose top row is white and remaining rows have a red
+        // channel of 'frameIndex'.
+        static void renderFrame(int frameIndex) {
+            glDisable(GL_SCISSOR_TEST);
+            glClearColor(frameIndex / 255.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(0, height - 1, width, 1);
+            glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glDisable(GL_SCISSOR_TEST);
+        }
+
+        static vector<unsigned char> readFile(const char * fileName) {
+            ifstream file(fileName, ios::binary);
+            return vector<unsigned char>(istreambuf_iterator<char>(file),
+                                         istreambuf_iterator<char>());
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> FrameCapture_Test::glContext;
+    GLuint FrameCapture_Test::framebuffer = 0;
+    GLuint FrameCapture_Test::colorBuffer = 0;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(FrameCapture_Test, test_raw_frames_written_in_order) {
+    const int numFrames = 10;
+    const char * fileName = "FrameCapture_Test.rgba";
+
+    // Fewer frame buffers than frames, so encoding has to keep up.
+    FrameCapture capture(3, 3, 2);
+    capture.begin(width, height, fileName, FrameCapture::Format::Raw);
+    for (int i = 0; i < numFrames; ++i) {
+        renderFrame(i + 1);
+        capture.captureFrame();
+    }
+    capture.end();
+
+    FrameCapture::Stats stats = capture.getStats();
+    EXPECT_EQ(uint64(numFrames), stats.numFramesCaptured);
+    EXPECT_EQ(uint64(numFrames), stats.numFramesWritten);
+
+    vector<unsigned char> data = readFile(fileName);
+    const size_t frameSize = width * height * 4;
+    ASSERT_EQ(frameSize * numFrames, data.size());
+
+    for (int i = 0; i < numFrames; ++i) {
+        const unsigned char * frame = &data[i * frameSize];
+
+        // Rows are stored top-down.
+        EXPECT_EQ(255, frame[0]);
+        EXPECT_EQ(255, frame[1]);
+        EXPECT_EQ(i + 1, frame[width * 4]);
+        EXPECT_EQ(0, frame[width * 4 + 1]);
+        EXPECT_EQ(i + 1, frame[frameSize - 4]);
+    }
+
+    remove(fileName);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(FrameCapture_Test, test_png_frames_decode) {
+    FrameCapture capture;
+    capture.begin(width, height, "FrameCapture_Test", FrameCapture::Format::Png);
+    renderFrame(40);
+    capture.captureFrame();
+    renderFrame(80);
+    capture.captureFrame();
+    capture.end();
+
+    const char * fileNames[] = { "FrameCapture_Test_000000.png",
+                                 "FrameCapture_Test_000001.png" };
+    const int expectedRed[] = { 40, 80 };
+
+    for (int i = 0; i < 2; ++i) {
+        vector<unsigned char> pixels;
+        unsigned decodedWidth, decodedHeight;
+        ASSERT_EQ(0u, lodepng::decode(pixels, decodedWidth, decodedHeight, fileNames[i]));
+        EXPECT_EQ(unsigned(width), decodedWidth);
+        EXPECT_EQ(unsigned(height), decodedHeight);
+        EXPECT_EQ(255, pixels[0]);
+        EXPECT_EQ(expectedRed[i], pixels[pixels.size() - 4]);
+
+        remove(fileNames[i]);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(FrameCapture_Test, test_unwritable_output_throws) {
+    FrameCapture capture;
+    EXPECT_THROW(capture.begin(width, height, "no/such/directory/capture.rgba",
+            FrameCapture::Format::Raw), Rigid3DException);
+    EXPECT_FALSE(capture.isCapturing());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(FrameCapture_Test, test_failed_writes_are_not_counted) {
+    FrameCapture capture;
+    capture.begin(width, height, "no/such/directory/capture", FrameCapture::Format::Png);
+    renderFrame(40);
+    capture.captureFrame();
+    EXPECT_THROW(capture.end(), Rigid3DException);
+
+    FrameCapture::Stats stats = capture.getStats();
+    EXPECT_EQ(uint64(1), stats.numFramesCaptured);
+    EXPECT_EQ(uint64(0), stats.numFramesWritten);
+}
@@ -0,0 +1,219 @@
+// FrameGraph_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/FrameGraph.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    typedef FrameGraph::ResourceId ResourceId;
+
+    class FrameGraph_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+
+        RenderTargetPool pool;
+        FrameGraph graph;
+        vector<string> executed;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+        }
+
+        static void TearDownTestCase() {
+            glContext.reset();
+        }
+
+        FrameGraph_Test()
+            : graph(pool) {
+
+        }
+
+        // Execute function that records the pass name.
+        FrameGraph::ExecuteFunction record(const string & name) {
+            return [this, name](const FrameGraph::PassResources &) {
+                executed.push_back(name);
+            };
+        }
+    };
+
+}
+
+shared_ptr<OpenGLContext> FrameGraph_Test::glContext = nullptr;
+
+//---------------------------------------------------------------------------------------
+TEST_F(FrameGraph_Test, test_unused_passes_are_culled) {
+    GLuint output = pool.acquireTexture(RenderTargetDesc(8, 8, GL_RGBA8));
+    ResourceId target = graph.importTexture("output", output, RenderTargetDesc(8, 8, GL_RGBA8));
+    ResourceId shadow = FrameGraph::InvalidResource;
+    ResourceId debug = FrameGraph::InvalidResource;
+
+    graph.addPass("shadow", [&](FrameGraph::PassBuilder & builder) {
+        shadow = builder.create("shadowMap", RenderTargetDesc(8, 8, GL_DEPTH_COMPONENT24));
+    }, record("shadow"));
+
+    graph.addPass("debug", [&](FrameGraph::PassBuilder & builder) {
+        builder.read(shadow);
+        debug = builder.create("debugView", RenderTargetDesc(8, 8, GL_RGBA8));
+    }, record("debug"));
+
+    graph.addPass("main", [&](FrameGraph::PassBuilder & builder) {
+        builder.read(shadow);
+        builder.write(target);
+    }, record("main"));
+
+    graph.addPass("readback", [&](FrameGraph::PassBuilder & builder) {
+        builder.setSideEffect();
+    }, record("readback"));
+
+    graph.execute();
+
+    EXPECT_EQ(vector<string>({ "shadow", "main", "readback" }), executed);
+    EXPECT_EQ(executed, graph.getExecutionOrder());
+
+    FrameGraph::Stats stats = graph.getStats();
+    EXPECT_EQ(4u, stats.numPasses);
+    EXPECT_EQ(1u, stats.numPassesCulled);
+    EXPECT_EQ(1u, stats.numTransientResources);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(FrameGraph_Test, test_disjoint_lifetimes_alias_textures) {
+    const RenderTargetDesc desc(16, 16, GL_RGBA8);
+    ResourceId a, b, c;
+    GLuint textureA = 0, textureC = 0;
+
+    graph.addPass("a", [&](FrameGraph::PassBuilder & builder) {
+        a = builder.create("a", desc);
+    }, [&](const FrameGraph::PassResources & resources) {
+        textureA = resources.getTexture(a);
+    });
+
+    graph.addPass("b", [&](FrameGraph::PassBuilder & builder) {
+        builder.read(a);
+        b = builder.create("b", desc);
+    }, record("b"));
+
+    graph.addPass("c", [&](FrameGraph::PassBuilder & builder) {
+        builder.read(b);
+        c = builder.create("c", desc);
+    }, [&](const FrameGraph::PassResources & resources) {
+        textureC = resources.getTexture(c);
+    });
+
+    graph.addPass("present", [&](FrameGraph::PassBuilder & builder) {
+        builder.read(c);
+        builder.setSideEffect();
+    }, record("present"));
+
+    graph.execute();
+
+    // 'a' is released after 'b' runs, so 'c' takes over its texture.
+    EXPECT_NE(0u, textureA);
+    EXPECT_EQ(textureA, textureC);
+    EXPECT_EQ(3u, graph.getStats().numTransientResources);
+    EXPECT_EQ(2u, graph.getStats().numTransientTextures);
+    EXPECT_EQ(2u, pool.getStats().numTextures);
+    EXPECT_EQ(0u, pool.getStats().numTexturesInUse);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(FrameGraph_Test, test_passes_render_into_bound_targets) {
+    const int size = 4;
+    ResourceId color;
+    GLsizei passWidth = 0;
+    vector<unsigned char> pixels(size * size * 4);
+
+    graph.addPass("fill", [&](FrameGraph::PassBuilder & builder) {
+        color = builder.create("color", RenderTargetDesc(size, size, GL_RGBA8));
+    }, [&](const FrameGraph::PassResources & resources) {
+        passWidth = resources.getWidth();
+        glClearColor(1.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    });
+
+    graph.addPass("tint", [&](FrameGraph::PassBuilder & builder) {
+        color = builder.write(color);
+    }, [&](const FrameGraph::PassResources &) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(0, 0, 1, 1);
+        glClearColor(0.0f, 0.0f, 1.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glDisable(GL_SCISSOR_TEST);
+    });
+
+    graph.addPass("readback", [&](FrameGraph::PassBuilder & builder) {
+        builder.read(color);
+        builder.setSideEffect();
+    }, [&](const FrameGraph::PassResources & resources) {
+        glBindTexture(GL_TEXTURE_2D, resources.getTexture(color));
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+    });
+
+    graph.execute();
+
+    EXPECT_EQ(size, passWidth);
+    EXPECT_EQ(0, pixels[0]);
+    EXPECT_EQ(255, pixels[2]);
+    EXPECT_EQ(255, pixels[4]);
+    EXPECT_EQ(0, pixels[6]);
+
+    GLint framebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+    EXPECT_EQ(0, framebuffer);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(FrameGraph_Test, test_rebuilt_frames_reuse_pool) {
+    for (int frame = 0; frame < 3; ++frame) {
+        graph.reset();
+        ResourceId depth;
+        graph.addPass("depth", [&](FrameGraph::PassBuilder & builder) {
+            depth = builder.create("depth", RenderTargetDesc(8, 8, GL_DEPTH_COMPONENT24));
+        }, record("depth"));
+        graph.addPass("use", [&](FrameGraph::PassBuilder & builder) {
+            builder.read(depth);
+            builder.setSideEffect();
+        }, record("use"));
+        graph.execute();
+    }
+
+    RenderTargetPool::Stats stats = pool.getStats();
+    EXPECT_EQ(1u, stats.numTexturesCreated);
+    EXPECT_EQ(1u, stats.numFramebuffers);
+    EXPECT_EQ(6u, executed.size());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(FrameGraph_Test, test_invalid_graphs_throw) {
+    EXPECT_THROW(graph.addPass("bad", [](FrameGraph::PassBuilder & builder) {
+        builder.read(42);
+    }, record("bad")), Rigid3DException);
+
+    graph.reset();
+    ResourceId backbuffer = graph.importFramebuffer("backbuffer", 0, 8, 8);
+    graph.addPass("mixed", [&](FrameGraph::PassBuilder & builder) {
+        builder.write(backbuffer);
+        builder.create("color", RenderTargetDesc(8, 8, GL_RGBA8));
+    }, record("mixed"));
+    EXPECT_THROW(graph.compile(), Rigid3DException);
+
+    graph.reset();
+    graph.addPass("first", [](FrameGraph::PassBuilder & builder) {
+        builder.setSideEffect();
+    }, record("first"));
+    graph.compile();
+    EXPECT_THROW(graph.addPass("late", [](FrameGraph::PassBuilder &) { }, record("late")),
+            Rigid3DException);
+}
@@ -0,0 +1,99 @@
+// FramePipeline_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Graphics/FramePipeline.hpp>
+using namespace Rigid3D;
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {  // limit class visibility to this file.
+
+    class FramePipeline_Test : public ::testing::Test {
+    protected:
+        FramePipeline framePipeline;
+        std::thread::id renderThreadId;
+        std::vector<uint64> renderedFrames;
+        bool threadEnded;
+
+        FramePipeline_Test()
+            : threadEnded(false) { }
+
+        void startRecording() {
+            framePipeline.start(
+                [this]() { renderThreadId = std::this_thread::get_id(); },
+                [this](const FramePacket & packet) {
+                    renderedFrames.push_back(packet.frameNumber);
+                },
+                [this]() { threadEnded = true; });
+        }
+
+        void submitFrames(unsigned int numFrames) {
+            for (unsigned int i = 0; i < numFrames; ++i) {
+                FramePacket & packet = framePipeline.beginFrame();
+                packet.clear();
+                packet.viewportWidth = 640;
+                framePipeline.submitFrame();
+            }
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FramePipeline_Test, packets_are_rendered_on_a_separate_thread) {
+    startRecording();
+    submitFrames(1);
+    framePipeline.stop();
+
+    EXPECT_NE(std::this_thread::get_id(), renderThreadId);
+    EXPECT_TRUE(threadEnded);
+    EXPECT_FALSE(framePipeline.isRunning());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FramePipeline_Test, frames_render_in_order_and_last_frame_is_not_dropped) {
+    startRecording();
+    submitFrames(500);
+    framePipeline.stop();
+
+    ASSERT_FALSE(renderedFrames.empty());
+    for (size_t i = 1; i < renderedFrames.size(); ++i) {
+        EXPECT_LT(renderedFrames[i - 1], renderedFrames[i]);
+    }
+
+    uint64 lastFrame = 499;
+    EXPECT_EQ(lastFrame, renderedFrames.back());
+    EXPECT_EQ(renderedFrames.size(), framePipeline.getNumFramesRendered());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FramePipeline_Test, render_thread_exception_is_rethrown_on_stop) {
+    framePipeline.start(
+        []() { },
+        [](const FramePacket &) { throw std::runtime_error("lost context"); },
+        []() { });
+
+    submitFrames(1);
+
+    EXPECT_THROW(framePipeline.stop(), std::runtime_error);
+    EXPECT_FALSE(framePipeline.isRunning());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(FramePipeline_Test, pipeline_can_be_restarted) {
+    startRecording();
+    submitFrames(3);
+    framePipeline.stop();
+
+    renderedFrames.clear();
+    startRecording();
+    submitFrames(1);
+    framePipeline.stop();
+
+    uint64 expectedFrame = 3;
+    ASSERT_EQ(1u, renderedFrames.size());
+    EXPECT_EQ(expectedFrame, renderedFrames[0]);
+}
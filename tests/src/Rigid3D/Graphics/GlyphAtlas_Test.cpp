@@ -0,0 +1,109 @@
+// GlyphAtlas_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GlyphAtlas.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    const char * fontFile = "../../data/fonts/DroidSansMono.ttf";
+
+    class GlyphAtlas_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+        }
+
+        static void TearDownTestCase() {
+            glContext.reset();
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> GlyphAtlas_Test::glContext;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(GlyphAtlas_Test, test_glyphs_are_rasterized_once) {
+    GlyphAtlas atlas(fontFile, 16);
+    EXPECT_GT(atlas.getCapacity(), 100u);
+    EXPECT_GT(atlas.getLineHeight(), 16.0f);
+    EXPECT_GT(atlas.getAscender(), 0.0f);
+
+    const GlyphAtlas::Glyph * a = atlas.findGlyph('A');
+    ASSERT_TRUE(a != nullptr);
+    EXPECT_GT(a->size.x, 0.0f);
+    EXPECT_GT(a->size.y, 0.0f);
+    EXPECT_LT(a->offset.y, 0.0f);
+    EXPECT_LT(a->texCoordMin.x, a->texCoordMax.x);
+    EXPECT_LT(a->texCoordMin.y, a->texCoordMax.y);
+
+    atlas.beginFrame();
+    EXPECT_EQ(a, atlas.findGlyph('A'));
+    EXPECT_EQ(1u, atlas.getNumRasterized());
+
+    // Monospaced, and spaces are blank.
+    const GlyphAtlas::Glyph * space = atlas.findGlyph(' ');
+    ASSERT_TRUE(space != nullptr);
+    EXPECT_FLOAT_EQ(a->advance, space->advance);
+    EXPECT_EQ(0.0f, space->size.x * space->size.y);
+    EXPECT_EQ(2u, atlas.getNumGlyphs());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(GlyphAtlas_Test, test_least_recently_used_glyph_is_replaced) {
+    GlyphAtlas atlas(fontFile, 16, 64, 64);
+    const uint32 capacity = atlas.getCapacity();
+    ASSERT_GT(capacity, 2u);
+
+    for (uint32 i = 0; i < capacity; ++i) {
+        atlas.beginFrame();
+        ASSERT_TRUE(atlas.findGlyph('A' + i) != nullptr);
+    }
+    EXPECT_EQ(capacity, atlas.getNumGlyphs());
+
+    // 'A' is used again, so 'B' is now least recently used.
+    atlas.beginFrame();
+    atlas.findGlyph('A');
+    atlas.beginFrame();
+    ASSERT_TRUE(atlas.findGlyph('a') != nullptr);
+    EXPECT_EQ(capacity, atlas.getNumGlyphs());
+    EXPECT_EQ(capacity + 1, atlas.getNumRasterized());
+
+    atlas.findGlyph('A');
+    EXPECT_EQ(capacity + 1, atlas.getNumRasterized());
+    atlas.findGlyph('B');
+    EXPECT_EQ(capacity + 2, atlas.getNumRasterized());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(GlyphAtlas_Test, test_glyphs_used_this_frame_are_kept) {
+    GlyphAtlas atlas(fontFile, 16, 64, 64);
+    const uint32 capacity = atlas.getCapacity();
+
+    atlas.beginFrame();
+    for (uint32 i = 0; i < capacity; ++i) {
+        ASSERT_TRUE(atlas.findGlyph('A' + i) != nullptr);
+    }
+    EXPECT_TRUE(atlas.findGlyph('a') == nullptr);
+    EXPECT_TRUE(atlas.findGlyph('A') != nullptr);
+
+    atlas.beginFrame();
+    EXPECT_TRUE(atlas.findGlyph('a') != nullptr);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(GlyphAtlas_Test, test_missing_font_throws) {
+    EXPECT_THROW(GlyphAtlas("../../data/fonts/Missing.ttf", 16), Rigid3DException);
+}
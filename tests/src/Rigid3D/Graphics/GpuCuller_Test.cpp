@@ -0,0 +1,273 @@
+// GpuCuller_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Graphics/GpuCuller.hpp>
+#include <Rigid3D/Graphics/HiZPyramid.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class GpuCuller_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> cullShader;
+        static shared_ptr<ShaderProgram> buildCommandsShader;
+        static shared_ptr<ShaderProgram> hiZShader;
+
+        mat4 viewProjection;
+        AABB unitBox;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+
+            cullShader = make_shared<ShaderProgram>();
+            cullShader->generateProgramObject();
+            cullShader->attachComputeShader("../../data/shaders/CullInstances.comp");
+            cullShader->link();
+
+            buildCommandsShader = make_shared<ShaderProgram>();
+            buildCommandsShader->generateProgramObject();
+            buildCommandsShader->attachComputeShader("../../data/shaders/BuildDrawCommands.comp");
+            buildCommandsShader->link();
+
+            hiZShader = make_shared<ShaderProgram>();
+            hiZShader->generateProgramObject();
+            hiZShader->attachComputeShader("../../data/shaders/HiZDownsample.comp");
+            hiZShader->link();
+        }
+
+        static void TearDownTestCase() {
+            hiZShader.reset();
+            buildCommandsShader.reset();
+            cullShader.reset();
+            glContext.reset();
+        }
+
+        // Ran before each test.
+        virtual void SetUp() {
+            // Camera at the origin looking down -z, seeing from z = -1 to z = -100.
+            mat4 projection = glm::perspective(1.0f, 1.0f, 1.0f, 100.0f);
+            mat4 view = glm::lookAt(vec3(0.0f), vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+            viewProjection = projection * view;
+
+            unitBox.minBounds = vec3(-0.1f);
+            unitBox.maxBounds = vec3(0.1f);
+        }
+
+        static mat4 translation(float x, float y, float z) {
+            return glm::translate(mat4(), vec3(x, y, z));
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> GpuCuller_Test::glContext;
+    shared_ptr<ShaderProgram> GpuCuller_Test::cullShader;
+    shared_ptr<ShaderProgram> GpuCuller_Test::buildCommandsShader;
+    shared_ptr<ShaderProgram> GpuCuller_Test::hiZShader;
+
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint first;
+        GLuint baseInstance;
+    };
+
+    bool byFirstVertex(const DrawCommand & a, const DrawCommand & b) {
+        return a.first < b.first;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(GpuCuller_Test, instances_outside_frustum_are_culled) {
+    GpuCuller culler(*cullShader, *buildCommandsShader);
+    unsigned int cubes = culler.addBatch(BatchInfo(0, 36));
+    unsigned int spheres = culler.addBatch(BatchInfo(36, 240));
+    unsigned int hidden = culler.addBatch(BatchInfo(276, 12));
+
+    culler.addInstance(cubes, translation(0.0f, 0.0f, -10.0f), unitBox);
+    culler.addInstance(cubes, translation(0.0f, 0.0f, 10.0f), unitBox);     // Behind.
+    culler.addInstance(spheres, translation(0.0f, 0.0f, -20.0f), unitBox);
+    culler.addInstance(spheres, translation(0.0f, 0.0f, -200.0f), unitBox); // Too far.
+    culler.addInstance(spheres, translation(0.0f, 0.0f, -30.0f), unitBox);
+    culler.addInstance(hidden, translation(0.0f, 0.0f, 10.0f), unitBox);
+
+    culler.cull(viewProjection);
+
+    EXPECT_EQ(3u, culler.readNumVisibleInstances());
+    EXPECT_EQ(2u, culler.readNumDrawCommands());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(GpuCuller_Test, draw_commands_are_compacted) {
+    GpuCuller culler(*cullShader, *buildCommandsShader);
+    unsigned int hidden = culler.addBatch(BatchInfo(0, 36));
+    unsigned int cubes = culler.addBatch(BatchInfo(36, 36));
+    unsigned int spheres = culler.addBatch(BatchInfo(72, 240));
+
+    culler.addInstance(hidden, translation(0.0f, 0.0f, 10.0f), unitBox);
+    culler.addInstance(spheres, translation(0.0f, 0.0f, -20.0f), unitBox);
+    culler.addInstance(cubes, translation(0.0f, 0.0f, -10.0f), unitBox);
+    culler.addInstance(cubes, translation(0.0f, 0.0f, -15.0f), unitBox);
+
+    culler.cull(viewProjection);
+
+    vector<DrawCommand> commands(culler.getNumBatches());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, culler.getDrawCommandBuffer());
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, commands.size() * sizeof(DrawCommand),
+            commands.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    // Order of commands between batches is not defined.
+    sort(commands.begin(), commands.begin() + 2, byFirstVertex);
+
+    EXPECT_EQ(36u, commands[0].first);
+    EXPECT_EQ(36u, commands[0].count);
+    EXPECT_EQ(2u, commands[0].instanceCount);
+    EXPECT_EQ(1u, commands[0].baseInstance);  // After the hidden batch's one instance.
+
+    EXPECT_EQ(72u, commands[1].first);
+    EXPECT_EQ(240u, commands[1].count);
+    EXPECT_EQ(1u, commands[1].instanceCount);
+    EXPECT_EQ(3u, commands[1].baseInstance);
+
+    // Unused trailing commands must draw nothing for the non count fallback.
+    EXPECT_EQ(0u, commands[2].instanceCount);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(GpuCuller_Test, moved_instances_are_reculled) {
+    GpuCuller culler(*cullShader, *buildCommandsShader);
+    unsigned int cubes = culler.addBatch(BatchInfo(0, 36));
+    culler.addInstance(cubes, translation(0.0f, 0.0f, -10.0f), unitBox);
+    unsigned int moving = culler.addInstance(cubes, translation(0.0f, 0.0f, -20.0f), unitBox);
+
+    culler.cull(viewProjection);
+    EXPECT_EQ(2u, culler.readNumVisibleInstances());
+
+    culler.setModelMatrix(moving, translation(0.0f, 0.0f, 20.0f));
+    culler.cull(viewProjection);
+    EXPECT_EQ(1u, culler.readNumVisibleInstances());
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(GpuCuller_Test, hiz_pyramid_levels_store_farthest_depth) {
+    const unsigned int width = 37;
+    const unsigned int height = 20;
+    vector<float> depth(width * height, 0.25f);
+    depth[(height - 1) * width + (width - 1)] = 0.75f;  // Farthest in the odd corner.
+
+    GLuint depthTexture;
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0,
+            GL_DEPTH_COMPONENT, GL_FLOAT, depth.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    HiZPyramid pyramid(*hiZShader);
+    pyramid.build(depthTexture, width, height);
+
+    unsigned int expectedLevels = 6;
+    EXPECT_EQ(expectedLevels, pyramid.getNumLevels());
+
+    float topLevel = 0.0f;
+    glBindTexture(GL_TEXTURE_2D, pyramid.getTexture());
+    glGetTexImage(GL_TEXTURE_2D, GLint(pyramid.getNumLevels() - 1), GL_RED, GL_FLOAT, &topLevel);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDeleteTextures(1, &depthTexture);
+
+    EXPECT_FLOAT_EQ(0.75f, topLevel);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(GpuCuller_Test, instances_behind_hiz_depth_are_culled) {
+    // Depth buffer covered by a surface half way into the depth range.
+    const unsigned int size = 64;
+    vector<float> depth(size * size, 0.5f);
+
+    GLuint depthTexture;
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, size, size, 0,
+            GL_DEPTH_COMPONENT, GL_FLOAT, depth.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    HiZPyramid pyramid(*hiZShader);
+    pyramid.build(depthTexture, size, size);
+
+    GpuCuller culler(*cullShader, *buildCommandsShader);
+    unsigned int cubes = culler.addBatch(BatchInfo(0, 36));
+    culler.addInstance(cubes, translation(0.0f, 0.0f, -1.5f), unitBox);   // Depth ~0.3.
+    culler.addInstance(cubes, translation(0.0f, 0.0f, -50.0f), unitBox);  // Depth ~0.99.
+
+    culler.cull(viewProjection);
+    EXPECT_EQ(2u, culler.readNumVisibleInstances());
+
+    culler.setOcclusionCulling(&pyramid, viewProjection);
+    culler.cull(viewProjection);
+    EXPECT_EQ(1u, culler.readNumVisibleInstances());
+
+    culler.disableOcclusionCulling();
+    glDeleteTextures(1, &depthTexture);
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(GpuCuller_Test, hiz_footprint_is_exact_for_odd_sizes) {
+    // Near occluder over the left half of a 1023 pixel wide depth buffer, nothing
+    // over the right half.  Level 8 is 3 texels wide and its last texel covers
+    // pixels 512 to 1022, so normalized uv would wrongly map pixels 532 to 675 to
+    // texel 1, over the occluder.
+    const unsigned int size = 1023;
+    vector<float> depth(size * size, 1.0f);
+    for (unsigned int y = 0; y < size; ++y) {
+        for (unsigned int x = 0; x < 512; ++x) {
+            depth[y * size + x] = 0.1f;
+        }
+    }
+
+    GLuint depthTexture;
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, size, size, 0,
+            GL_DEPTH_COMPONENT, GL_FLOAT, depth.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    HiZPyramid pyramid(*hiZShader);
+    pyramid.build(depthTexture, size, size);
+
+    // Normalized device coordinates are world coordinates, and depth 0.5 is z = 0.
+    mat4 identity;
+    AABB box;
+    box.minBounds = vec3(0.04f, -0.1f, -0.05f);    // uv 0.52 to 0.66.
+    box.maxBounds = vec3(0.32f, 0.1f, 0.05f);
+
+    GpuCuller culler(*cullShader, *buildCommandsShader);
+    unsigned int cubes = culler.addBatch(BatchInfo(0, 36));
+    culler.addInstance(cubes, identity, box);
+    culler.addInstance(cubes, translation(-0.7f, 0.0f, 0.0f), box);   // Over the occluder.
+
+    culler.setOcclusionCulling(&pyramid, identity);
+    culler.cull(identity);
+    EXPECT_EQ(1u, culler.readNumVisibleInstances());
+
+    culler.disableOcclusionCulling();
+    glDeleteTextures(1, &depthTexture);
+}
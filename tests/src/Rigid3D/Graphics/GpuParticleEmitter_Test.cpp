@@ -0,0 +1,213 @@
+// GpuParticleEmitter_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/GpuParticleEmitter.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class GpuParticleEmitter_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> emitShader;
+        static shared_ptr<ShaderProgram> simulateShader;
+        static shared_ptr<ShaderProgram> drawArgsShader;
+
+        ParticleEmitter::Params params;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+
+            emitShader = make_shared<ShaderProgram>();
+            emitShader->generateProgramObject();
+            emitShader->attachComputeShader("../../data/shaders/GpuParticleEmit.comp");
+            emitShader->link();
+
+            simulateShader = make_shared<ShaderProgram>();
+            simulateShader->generateProgramObject();
+            simulateShader->attachComputeShader("../../data/shaders/GpuParticleSimulate.comp");
+            simulateShader->link();
+
+            drawArgsShader = make_shared<ShaderProgram>();
+            drawArgsShader->generateProgramObject();
+            drawArgsShader->attachComputeShader("../../data/shaders/GpuParticleDrawArgs.comp");
+            drawArgsShader->link();
+        }
+
+        static void TearDownTestCase() {
+            emitShader.reset();
+            simulateShader.reset();
+            drawArgsShader.reset();
+            glContext.reset();
+        }
+
+        // Code here will be called immediately after the constructor (right
+        // before each test).
+        virtual void SetUp() {
+            params.velocity = vec3(0.0f);
+            params.emissionRate = 0.0f;
+            params.lifetime = 1.0f;
+        }
+
+        vector<float> readParticles(const GpuParticleEmitter & emitter, uint32 count) {
+            vector<float> data(count * GpuParticleEmitter::BytesPerParticle / sizeof(float));
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, emitter.getParticleBuffer());
+            glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0,
+                    GLsizeiptr(count * GpuParticleEmitter::BytesPerParticle), data.data());
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            return data;
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> GpuParticleEmitter_Test::glContext;
+    shared_ptr<ShaderProgram> GpuParticleEmitter_Test::emitShader;
+    shared_ptr<ShaderProgram> GpuParticleEmitter_Test::simulateShader;
+    shared_ptr<ShaderProgram> GpuParticleEmitter_Test::drawArgsShader;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(GpuParticleEmitter_Test, test_emission_rate_and_burst) {
+    params.emissionRate = 1000.0f;
+    GpuParticleEmitter emitter(*emitShader, *simulateShader, *drawArgsShader, 1000, params);
+    EXPECT_EQ(0u, emitter.readNumParticles());
+
+    emitter.update(0.1f);
+    EXPECT_EQ(100u, emitter.readNumParticles());
+
+    emitter.emit(150);
+    emitter.update(0.1f);
+    EXPECT_EQ(350u, emitter.readNumParticles());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(GpuParticleEmitter_Test, test_expired_particles_are_compacted) {
+    GpuParticleEmitter emitter(*emitShader, *simulateShader, *drawArgsShader, 256, params);
+
+    params.lifetime = 0.25f;
+    emitter.setParams(params);
+    emitter.emit(70);
+    emitter.update(0.0f);
+
+    params.lifetime = 10.0f;
+    emitter.setParams(params);
+    emitter.emit(30);
+    emitter.update(0.0f);
+    EXPECT_EQ(100u, emitter.readNumParticles());
+
+    emitter.update(0.5f);
+    ASSERT_EQ(30u, emitter.readNumParticles());
+
+    vector<float> particles = readParticles(emitter, 30);
+    for (uint32 i = 0; i < 30; ++i) {
+        EXPECT_FLOAT_EQ(9.5f, particles[i * 8 + 3]);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(GpuParticleEmitter_Test, test_count_is_clamped_to_capacity) {
+    GpuParticleEmitter emitter(*emitShader, *simulateShader, *drawArgsShader, 100, params);
+
+    emitter.emit(80);
+    emitter.update(0.0f);
+    emitter.emit(80);
+    emitter.update(0.0f);
+    EXPECT_EQ(100u, emitter.readNumParticles());
+
+    // Draw and next dispatch arguments.
+    uint32 args[7];
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, emitter.getIndirectBuffer());
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(args), args);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    EXPECT_EQ(100u, args[0]);
+    EXPECT_EQ(1u, args[1]);
+    EXPECT_EQ(0u, args[2]);
+    EXPECT_EQ(2u, args[4]);
+    EXPECT_EQ(1u, args[5]);
+    EXPECT_EQ(1u, args[6]);
+
+    emitter.update(0.1f);
+    EXPECT_EQ(100u, emitter.readNumParticles());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(GpuParticleEmitter_Test, test_particles_bounce_off_plane) {
+    params.position = vec3(0.0f, 0.05f, 0.0f);
+    params.velocity = vec3(0.0f, -1.0f, 0.0f);
+    params.restitution = 1.0f;
+    GpuParticleEmitter emitter(*emitShader, *simulateShader, *drawArgsShader, 16, params);
+    emitter.addCollisionPlane(vec4(0.0f, 2.0f, 0.0f, 0.0f));
+    EXPECT_THROW(emitter.addCollisionPlane(vec4(0.0f)), Rigid3DException);
+
+    emitter.emit(16);
+    emitter.update(0.0f);
+    emitter.update(0.1f);
+    ASSERT_EQ(16u, emitter.readNumParticles());
+
+    vector<float> particles = readParticles(emitter, 16);
+    for (uint32 i = 0; i < 16; ++i) {
+        EXPECT_GE(particles[i * 8 + 1], 0.0f);
+        EXPECT_FLOAT_EQ(1.0f, particles[i * 8 + 5]);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(GpuParticleEmitter_Test, test_draw_expands_points_to_round_sprites) {
+    ShaderProgram particleShader;
+    particleShader.generateProgramObject();
+    particleShader.attachVertexShader("../../data/shaders/GpuParticle.vert");
+    particleShader.attachGeometryShader("../../data/shaders/GpuParticle.geom");
+    particleShader.attachFragmentShader("../../data/shaders/Particle.frag");
+    particleShader.link();
+    particleShader.setUniform("ModelViewMatrix", mat4());
+    particleShader.setUniform("ProjectionMatrix", mat4());
+    particleShader.setUniform("particleSize", 1.0f);
+
+    params.color = vec4(0.0f, 1.0f, 0.0f, 1.0f);
+    GpuParticleEmitter emitter(*emitShader, *simulateShader, *drawArgsShader, 4, params);
+    emitter.emit(1);
+    emitter.update(0.0f);
+
+    GLuint framebuffer, colorBuffer;
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 4, 4);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+            colorBuffer);
+    glViewport(0, 0, 4, 4);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    particleShader.enable();
+    emitter.draw();
+    particleShader.disable();
+
+    vector<unsigned char> pixels(4 * 4 * 4);
+    glReadPixels(0, 0, 4, 4, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    // Pixel (1, 1) is near the center of the sprite, pixel (0, 0) outside its
+    // circle.
+    const unsigned char * center = &pixels[(1 * 4 + 1) * 4];
+    const unsigned char * corner = &pixels[0];
+    EXPECT_EQ(0, center[0]);
+    EXPECT_EQ(255, center[1]);
+    EXPECT_GT(center[3], 128);
+    EXPECT_EQ(0, corner[3]);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+}
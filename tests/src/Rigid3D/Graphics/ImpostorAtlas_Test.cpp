@@ -0,0 +1,163 @@
+// ImpostorAtlas_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Graphics/ImpostorAtlas.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include "OpenGLContext.hpp"
+using Rigid3D::ImpostorAtlas;
+using Rigid3D::Mesh;
+using Rigid3D::OpenGLContext;
+using Rigid3D::ShaderProgram;
+using Rigid3D::vec2;
+using Rigid3D::vec3;
+
+#include <cmath>
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    const float tolerance = 1e-5f;
+
+    class ImpostorAtlas_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> bakeShader;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+
+            bakeShader = make_shared<ShaderProgram>();
+            bakeShader->generateProgramObject();
+            bakeShader->attachVertexShader("../../data/shaders/ImpostorBake.vert");
+            bakeShader->attachFragmentShader("../../data/shaders/ImpostorBake.frag");
+            bakeShader->link();
+        }
+
+        static void TearDownTestCase() {
+            bakeShader.reset();
+            glContext.reset();
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> ImpostorAtlas_Test::glContext;
+    shared_ptr<ShaderProgram> ImpostorAtlas_Test::bakeShader;
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ImpostorAtlas_Test, frame_basis_is_orthonormal) {
+    const unsigned int framesPerSide = 8;
+
+    for (unsigned int j = 0; j < framesPerSide; ++j) {
+        for (unsigned int i = 0; i < framesPerSide; ++i) {
+            vec3 direction = ImpostorAtlas::getFrameDirection(i, j, framesPerSide);
+            vec3 right, up;
+            ImpostorAtlas::getFrameBasis(direction, right, up);
+
+            EXPECT_NEAR(1.0f, glm::length(direction), tolerance);
+            EXPECT_NEAR(1.0f, glm::length(right), tolerance);
+            EXPECT_NEAR(1.0f, glm::length(up), tolerance);
+            EXPECT_NEAR(0.0f, glm::dot(direction, right), tolerance);
+            EXPECT_NEAR(0.0f, glm::dot(direction, up), tolerance);
+            EXPECT_NEAR(0.0f, glm::dot(right, up), tolerance);
+
+            // Right handed, with 'direction' pointing towards the viewer.
+            vec3 c = glm::cross(right, up);
+            EXPECT_NEAR(direction.x, c.x, tolerance);
+            EXPECT_NEAR(direction.y, c.y, tolerance);
+            EXPECT_NEAR(direction.z, c.z, tolerance);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(ImpostorAtlas_Test, frames_cover_both_hemispheres) {
+    const unsigned int framesPerSide = 4;
+    int upper = 0;
+    int lower = 0;
+
+    for (unsigned int j = 0; j < framesPerSide; ++j) {
+        for (unsigned int i = 0; i < framesPerSide; ++i) {
+            vec3 direction = ImpostorAtlas::getFrameDirection(i, j, framesPerSide);
+            if (direction.z > 1e-4f) { ++upper; }
+            if (direction.z < -1e-4f) { ++lower; }
+        }
+    }
+
+    EXPECT_GT(upper, 0);
+    EXPECT_EQ(upper, lower);
+}
+
+//----------------------------------------------------------------------------------------
+/*
+ * A square facing +z, baked into a 4x4 atlas.  Every frame not seeing the square
+ * edge on should hold it at the center of its own rectangle, with the baked color,
+ * the +z normal and the depth of the bounding sphere center, and be empty at its
+ * corners, which lie outside the bounding sphere.
+ */
+TEST_F(ImpostorAtlas_Test, bake_renders_each_view_into_its_frame) {
+    vector<vec3> positions = {
+        vec3(-1.0f, -1.0f, 0.0f), vec3(1.0f, -1.0f, 0.0f), vec3(1.0f, 1.0f, 0.0f),
+        vec3(-1.0f, -1.0f, 0.0f), vec3(1.0f, 1.0f, 0.0f), vec3(-1.0f, 1.0f, 0.0f)
+    };
+    vector<vec3> normals(6, vec3(0.0f, 0.0f, 1.0f));
+    vector<vec2> textureCoords;
+    Mesh square(std::move(positions), std::move(normals), std::move(textureCoords));
+
+    const unsigned int framesPerSide = 4;
+    const unsigned int frameResolution = 16;
+    const vec3 diffuseColor(1.0f, 0.5f, 0.0f);
+
+    ImpostorAtlas atlas;
+    atlas.bake(square, diffuseColor, *bakeShader, framesPerSide, frameResolution);
+    EXPECT_EQ(framesPerSide, atlas.getFramesPerSide());
+    EXPECT_EQ(frameResolution, atlas.getFrameResolution());
+    EXPECT_NEAR(0.0f, glm::length(atlas.getBoundingSphereCenter()), tolerance);
+    EXPECT_NEAR(std::sqrt(2.0f), atlas.getBoundingSphereRadius(), tolerance);
+
+    const unsigned int atlasSize = framesPerSide * frameResolution;
+    vector<unsigned char> color(atlasSize * atlasSize * 4);
+    vector<float> normalDepth(atlasSize * atlasSize * 4);
+    glBindTexture(GL_TEXTURE_2D, atlas.getColorTexture());
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, color.data());
+    glBindTexture(GL_TEXTURE_2D, atlas.getNormalDepthTexture());
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, normalDepth.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    int numFramesChecked = 0;
+    for (unsigned int j = 0; j < framesPerSide; ++j) {
+        for (unsigned int i = 0; i < framesPerSide; ++i) {
+            const unsigned int x0 = i * frameResolution;
+            const unsigned int y0 = j * frameResolution;
+
+            const size_t corner = (y0 * atlasSize + x0) * 4;
+            EXPECT_EQ(0, color[corner + 3]);
+
+            vec3 direction = ImpostorAtlas::getFrameDirection(i, j, framesPerSide);
+            if (std::fabs(direction.z) < 0.1f) {
+                continue;
+            }
+
+            const size_t center = ((y0 + frameResolution / 2) * atlasSize +
+                    x0 + frameResolution / 2) * 4;
+            EXPECT_EQ(255, color[center + 0]);
+            EXPECT_NEAR(128, color[center + 1], 1);
+            EXPECT_EQ(0, color[center + 2]);
+            EXPECT_EQ(255, color[center + 3]);
+
+            EXPECT_NEAR(0.5f, normalDepth[center + 0], 1e-2f);
+            EXPECT_NEAR(0.5f, normalDepth[center + 1], 1e-2f);
+            EXPECT_NEAR(1.0f, normalDepth[center + 2], 1e-2f);
+            EXPECT_NEAR(0.5f, normalDepth[center + 3], 0.1f);
+            ++numFramesChecked;
+        }
+    }
+    EXPECT_GT(numFramesChecked, 0);
+}
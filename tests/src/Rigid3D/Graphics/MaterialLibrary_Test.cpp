@@ -0,0 +1,178 @@
+// MaterialLibrary_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/MaterialLibrary.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class MaterialLibrary_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+        }
+
+        static void TearDownTestCase() {
+            glContext.reset();
+        }
+
+        static vector<unsigned char> solidImage(GLsizei width, GLsizei height,
+                                                unsigned char r, unsigned char g,
+                                                unsigned char b) {
+            vector<unsigned char> pixels;
+            for (GLsizei i = 0; i < width * height; ++i) {
+                pixels.push_back(r);
+                pixels.push_back(g);
+                pixels.push_back(b);
+                pixels.push_back(255);
+            }
+            return pixels;
+        }
+
+        static MaterialProperties emissive(const vec3 & color) {
+            MaterialProperties properties;
+            properties.emission = color;
+            properties.Ka = vec3(0.0f);
+            properties.Kd = vec3(0.0f);
+            properties.Ks = 0.0f;
+            properties.shininessFactor = 1.0f;
+            return properties;
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> MaterialLibrary_Test::glContext;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MaterialLibrary_Test, test_textures_are_grouped_by_size) {
+    MaterialLibrary materials(false);
+    vector<unsigned char> small = solidImage(2, 2, 255, 0, 0);
+    vector<unsigned char> large = solidImage(4, 4, 0, 255, 0);
+    vector<unsigned char> otherSmall = solidImage(2, 2, 0, 0, 255);
+
+    uint32 a = materials.addTexture(2, 2, small.data());
+    uint32 b = materials.addTexture(4, 4, large.data());
+    uint32 c = materials.addTexture(2, 2, otherSmall.data());
+
+    uint32 slot, layer;
+    materials.getTextureLocation(a, slot, layer);
+    EXPECT_EQ(0u, slot);
+    EXPECT_EQ(0u, layer);
+    materials.getTextureLocation(b, slot, layer);
+    EXPECT_EQ(1u, slot);
+    EXPECT_EQ(0u, layer);
+    materials.getTextureLocation(c, slot, layer);
+    EXPECT_EQ(0u, slot);
+    EXPECT_EQ(1u, layer);
+
+    EXPECT_EQ(2u, materials.getStats().numTextureArrays);
+    EXPECT_FALSE(materials.isBindless());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MaterialLibrary_Test, test_unpack_alignment_is_restored) {
+    MaterialLibrary materials(false);
+    vector<unsigned char> image = solidImage(2, 2, 255, 0, 0);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
+    materials.addTexture(2, 2, image.data());
+
+    GLint alignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    EXPECT_EQ(8, alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MaterialLibrary_Test, test_identical_textures_are_shared) {
+    MaterialLibrary materials(false);
+    vector<unsigned char> red = solidImage(2, 2, 255, 0, 0);
+
+    uint32 a = materials.addTexture(2, 2, red.data());
+    uint32 b = materials.addTexture(2, 2, red.data());
+    uint32 c = materials.addTexture(2, 2, red.data(), GL_SRGB8_ALPHA8);
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+
+    MaterialLibrary::Stats stats = materials.getStats();
+    EXPECT_EQ(2u, stats.numTextures);
+    EXPECT_EQ(1u, stats.numSharedTextures);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MaterialLibrary_Test, test_released_texture_frees_its_layer) {
+    MaterialLibrary materials(false);
+    vector<unsigned char> red = solidImage(2, 2, 255, 0, 0);
+    vector<unsigned char> green = solidImage(2, 2, 0, 255, 0);
+
+    uint32 a = materials.addTexture(2, 2, red.data());
+    uint32 b = materials.addTexture(2, 2, red.data());
+    ASSERT_EQ(a, b);
+
+    // Still referenced by the second addition.
+    uint32 slot, layer;
+    materials.releaseTexture(a);
+    materials.getTextureLocation(a, slot, layer);
+    EXPECT_EQ(1u, materials.getStats().numTextures);
+
+    materials.releaseTexture(b);
+    EXPECT_THROW(materials.getTextureLocation(a, slot, layer), Rigid3DException);
+    EXPECT_THROW(materials.releaseTexture(a), Rigid3DException);
+    EXPECT_THROW(materials.addMaterial(emissive(vec3(1.0f)), a), Rigid3DException);
+    EXPECT_EQ(0u, materials.getStats().numTextures);
+
+    // The freed layer is reused, and the released image is no longer shared.
+    uint32 c = materials.addTexture(2, 2, green.data());
+    materials.getTextureLocation(c, slot, layer);
+    EXPECT_EQ(0u, layer);
+    uint32 d = materials.addTexture(2, 2, red.data());
+    EXPECT_NE(a, d);
+    materials.getTextureLocation(d, slot, layer);
+    EXPECT_EQ(1u, layer);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MaterialLibrary_Test, test_texture_array_grows_and_keeps_layers) {
+    MaterialLibrary materials(false);
+    for (unsigned char i = 0; i < 6; ++i) {
+        vector<unsigned char> pixels = solidImage(2, 2, i * 40, 0, 0);
+        materials.addTexture(2, 2, pixels.data());
+    }
+    EXPECT_EQ(8u, materials.getStats().numTextureLayers);
+
+    vector<unsigned char> texels(2 * 2 * 4 * 8);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, materials.getTextureArray(0));
+    glGetTexImage(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // First texel of each layer, including those copied from the smaller array.
+    for (int layer = 0; layer < 6; ++layer) {
+        EXPECT_EQ(layer * 40, texels[layer * 16]);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MaterialLibrary_Test, test_too_many_texture_sizes_throws) {
+    MaterialLibrary materials(false);
+    vector<unsigned char> pixels = solidImage(8, 8, 0, 0, 0);
+    for (GLsizei size = 1; size <= GLsizei(MaterialLibrary::MaxTextureArrays); ++size) {
+        materials.addTexture(size, size, pixels.data());
+    }
+
+    EXPECT_THROW(materials.addTexture(8, 8, pixels.data()), Rigid3DException);
+    EXPECT_THROW(materials.addMaterial(emissive(vec3(1.0f)), 99), Rigid3DException);
+}
@@ -0,0 +1,243 @@
+/**
+ * @brief MeshCodec_Test
+ */
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/MeshCodec.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+using namespace Rigid3D;
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {  // limit class visibility to this file.
+
+    // Triangle soup of a bumpy height field over an n x n grid of quads.
+    std::shared_ptr<Mesh> createGrid(unsigned n) {
+        std::vector<vec3> positions;
+        std::vector<vec3> normals;
+        std::vector<vec2> textureCoords;
+
+        auto vertex = [&](unsigned x, unsigned y) {
+            const float fx = float(x) / n;
+            const float fy = float(y) / n;
+            positions.push_back(vec3(fx, 0.1f * std::sin(fx * 12.0f) * std::cos(fy * 9.0f), fy));
+            normals.push_back(glm::normalize(vec3(std::sin(fx * 3.0f), 1.0f, std::cos(fy * 5.0f))));
+            textureCoords.push_back(vec2(fx, fy));
+        };
+
+        for (unsigned y = 0; y < n; ++y) {
+            for (unsigned x = 0; x < n; ++x) {
+                vertex(x, y); vertex(x, y + 1); vertex(x + 1, y);
+                vertex(x + 1, y); vertex(x, y + 1); vertex(x + 1, y + 1);
+            }
+        }
+
+        return std::make_shared<Mesh>(std::move(positions), std::move(normals),
+                std::move(textureCoords));
+    }
+
+    void expectNear(const Mesh & expected, const Mesh & actual, float positionError) {
+        ASSERT_EQ(expected.getNumVertexPositions(), actual.getNumVertexPositions());
+        ASSERT_EQ(expected.getNumVertexNormals(), actual.getNumVertexNormals());
+        ASSERT_EQ(expected.getNumTextureCoords(), actual.getNumTextureCoords());
+
+        // Triangles are reordered, so compare them as sets of first vertices.
+        std::vector<vec3> expectedFirst;
+        std::vector<vec3> actualFirst;
+        for (unsigned i = 0; i < expected.getNumVertexPositions(); i += 3) {
+            expectedFirst.push_back((*expected.getVertexPositionVector())[i]);
+            actualFirst.push_back((*actual.getVertexPositionVector())[i]);
+        }
+
+        for (const vec3 & p : actualFirst) {
+            bool found = false;
+            for (const vec3 & q : expectedFirst) {
+                const vec3 error = glm::abs(p - q);
+                if (std::max(error.x, std::max(error.y, error.z)) <= positionError) {
+                    found = true;
+                    break;
+                }
+            }
+            EXPECT_TRUE(found);
+        }
+
+        for (const vec3 & n : *actual.getVertexNormalVector()) {
+            EXPECT_NEAR(1.0f, glm::length(n), 1e-4f);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(MeshCodec_Test, obj_mesh_round_trips_within_quantization_error) {
+    Mesh mesh("../data/meshes/cube_smooth.obj");
+
+    std::vector<uint8> encoded;
+    MeshCodec::encode(mesh, encoded);
+    EXPECT_TRUE(MeshCodec::isEncodedMesh(encoded.data(), encoded.size()));
+    EXPECT_EQ(mesh.getNumVertexPositions(),
+            MeshCodec::getNumTriangleVertices(encoded.data(), encoded.size()));
+    EXPECT_TRUE(MeshCodec::hasNormals(encoded.data(), encoded.size()));
+
+    Mesh decoded;
+    MeshCodec::decode(encoded.data(), encoded.size(), decoded);
+
+    // Cube spans [-1, 1], quantized to 16 bits.
+    expectNear(mesh, decoded, 2.0f / 65535.0f);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(MeshCodec_Test, grid_is_several_times_smaller_than_raw_floats) {
+    std::shared_ptr<Mesh> grid = createGrid(64);
+    const Mesh & mesh = *grid;
+
+    std::vector<uint8> encoded;
+    MeshCodec::encode(mesh, encoded);
+
+    const size_t rawBytes = mesh.getNumVertexPositionBytes() +
+            mesh.getNumVertexNormalBytes() + mesh.getNumTextureCoordBytes();
+    EXPECT_LT(encoded.size() * 8, rawBytes);
+
+    Mesh decoded;
+    MeshCodec::decode(encoded.data(), encoded.size(), decoded);
+    expectNear(mesh, decoded, 1.0f / 65535.0f);
+
+    std::vector<vec2> textureCoords(decoded.getNumTextureCoords());
+    MeshCodec::decode(encoded.data(), encoded.size(), nullptr, nullptr,
+            textureCoords.data());
+    for (const vec2 & uv : textureCoords) {
+        EXPECT_GE(uv.x, 0.0f);
+        EXPECT_LE(uv.y, 1.0f);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(MeshCodec_Test, cache_optimization_lowers_miss_ratio) {
+    // A grid with its triangles shuffled.
+    const uint32 n = 32;
+    std::vector<uint32> indices;
+    for (uint32 y = 0; y < n; ++y) {
+        for (uint32 x = 0; x < n; ++x) {
+            const uint32 v = y * (n + 1) + x;
+            uint32 quad[6] = {v, v + n + 1, v + 1, v + 1, v + n + 1, v + n + 2};
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+    std::vector<uint32> order(indices.size() / 3);
+    for (uint32 i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(3));
+    std::vector<uint32> shuffled;
+    for (uint32 t : order) {
+        shuffled.insert(shuffled.end(), &indices[t * 3], &indices[t * 3] + 3);
+    }
+
+    std::vector<uint32> optimized = shuffled;
+    MeshCodec::optimizeVertexCache(optimized.data(), optimized.size(), (n + 1) * (n + 1));
+
+    const float before = MeshCodec::getAverageCacheMissRatio(shuffled.data(), shuffled.size());
+    const float after = MeshCodec::getAverageCacheMissRatio(optimized.data(), optimized.size());
+    EXPECT_GT(before, 2.0f);
+    EXPECT_LT(after, 0.9f);
+
+    // Same triangles, reordered.
+    std::sort(shuffled.begin(), shuffled.end());
+    std::sort(optimized.begin(), optimized.end());
+    EXPECT_EQ(shuffled, optimized);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(MeshCodec_Test, indexed_decode_matches_triangle_soup) {
+    ThreadPool threadPool(2);
+    std::shared_ptr<Mesh> grid = createGrid(16);
+    const Mesh & mesh = *grid;
+    std::vector<uint8> encoded;
+    MeshCodec::encode(mesh, encoded, MeshCodecSettings(), &threadPool);
+
+    const uint32 numVertices = MeshCodec::getNumVertices(encoded.data(), encoded.size());
+    const uint32 numIndices = MeshCodec::getNumIndices(encoded.data(), encoded.size());
+    EXPECT_EQ(17u * 17u, numVertices);
+
+    std::vector<vec3> positions(numVertices);
+    std::vector<uint32> indices(numIndices);
+    MeshCodec::decodeIndexed(encoded.data(), encoded.size(), positions.data(), nullptr,
+            nullptr, indices.data(), &threadPool);
+
+    std::vector<vec3> soup(numIndices);
+    MeshCodec::decode(encoded.data(), encoded.size(), soup.data(), nullptr);
+    for (uint32 i = 0; i < numIndices; ++i) {
+        EXPECT_EQ(positions[indices[i]], soup[i]);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+TEST(MeshCodec_Test, mesh_consolidator_decodes_in_place) {
+    std::shared_ptr<Mesh> grid = createGrid(8);
+    Mesh cube("../data/meshes/cube.obj");
+    std::vector<uint8> encodedGrid;
+    std::vector<uint8> encodedCube;
+    MeshCodec::encode(*grid, encodedGrid);
+    MeshCodec::encode(cube, encodedCube);
+
+    MeshConsolidator consolidator = {{"grid", &encodedGrid}, {"cube", &encodedCube}};
+
+    std::unordered_map<const char *, BatchInfo> batchInfoMap;
+    consolidator.getBatchInfo(batchInfoMap);
+    EXPECT_EQ(grid->getNumVertexPositions(), batchInfoMap["grid"].numIndices);
+    EXPECT_EQ(cube.getNumVertexPositions(), batchInfoMap["cube"].numIndices);
+    EXPECT_EQ((grid->getNumVertexPositions() + cube.getNumVertexPositions()) * sizeof(vec3),
+            consolidator.getNumVertexPositionBytes());
+
+    std::vector<vec3> positions(cube.getNumVertexPositions());
+    std::vector<vec3> normals(cube.getNumVertexPositions());
+    MeshCodec::decode(encodedCube.data(), encodedCube.size(), positions.data(),
+            normals.data());
+    const vec3 * consolidated = reinterpret_cast<const vec3 *>(
+            consolidator.getVertexPositionDataPtr()) + batchInfoMap["cube"].startIndex;
+    EXPECT_TRUE(std::equal(positions.begin(), positions.end(), consolidated));
+}
+
+//---------------------------------------------------------------------------------------
+TEST(MeshCodec_Test, malformed_data_throws) {
+    std::shared_ptr<Mesh> grid = createGrid(4);
+    const Mesh & mesh = *grid;
+    std::vector<uint8> encoded;
+    MeshCodec::encode(mesh, encoded);
+
+    std::vector<vec3> positions(MeshCodec::getNumTriangleVertices(encoded.data(),
+            encoded.size()));
+    EXPECT_THROW(MeshCodec::decode(encoded.data(), encoded.size() - 8, positions.data(),
+            nullptr), Rigid3DException);
+
+    std::vector<uint8> badMagic = encoded;
+    badMagic[1] = 'X';
+    EXPECT_FALSE(MeshCodec::isEncodedMesh(badMagic.data(), badMagic.size()));
+    EXPECT_THROW(MeshCodec::getNumVertices(badMagic.data(), badMagic.size()),
+            Rigid3DException);
+
+    // Counts that disagree with the compressed payload are rejected before anything
+    // is sized from them.
+    std::vector<uint8> badCounts = encoded;
+    const uint32 hugeCount = 0xFFFFFFF0u;
+    std::memcpy(&badCounts[8], &hugeCount, sizeof(hugeCount));
+    EXPECT_THROW(MeshCodec::getNumVertices(badCounts.data(), badCounts.size()),
+            Rigid3DException);
+    badCounts = encoded;
+    std::memcpy(&badCounts[12], &hugeCount, sizeof(hugeCount));
+    EXPECT_THROW(MeshCodec::decode(badCounts.data(), badCounts.size(), positions.data(),
+            nullptr), Rigid3DException);
+
+    MeshCodecSettings settings;
+    settings.positionBits = 17;
+    EXPECT_THROW(MeshCodec::encode(mesh, encoded, settings), Rigid3DException);
+}
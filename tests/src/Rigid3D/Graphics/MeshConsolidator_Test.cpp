@@ -37,6 +37,8 @@ namespace {  // limit class visibility to this file.
     class MeshConsolidator_Test : public ::testing::Test {
     protected:
         static const unsigned numberOfCubes = 9;
+        // cube.obj and cube_smooth.obj, each stored once however many ids load it.
+        static const unsigned numberOfUniqueCubes = 2;
         static const unsigned sidesPerCube = 6;
         static const unsigned trianglesPerSide = 2;
         static const unsigned verticesPerTriangle = 3;
@@ -179,7 +181,7 @@ bool containsValue(const unordered_map<const char *, BatchInfo> batchInfoMap,
 //---------------------------------------------------------------------------------------
 TEST_F(MeshConsolidator_WithObjFiles_Test, test_numVertexBytes){
 
-    unsigned expectedBytes = numberOfCubes * sidesPerCube * trianglesPerSide * verticesPerTriangle
+    unsigned expectedBytes = numberOfUniqueCubes * sidesPerCube * trianglesPerSide * verticesPerTriangle
                              * floatsPerVertex * sizeof(float);
 
     EXPECT_EQ(expectedBytes, meshConsolidator.getNumVertexPositionBytes());
@@ -187,7 +189,7 @@ TEST_F(MeshConsolidator_WithObjFiles_Test, test_numVertexBytes){
 
 //---------------------------------------------------------------------------------------
 TEST_F(MeshConsolidator_WithObjFiles_Test, test_numNormalBytes){
-    unsigned expectedBytes = numberOfCubes * sidesPerCube * trianglesPerSide * normalsPerTriangle
+    unsigned expectedBytes = numberOfUniqueCubes * sidesPerCube * trianglesPerSide * normalsPerTriangle
                              * floatsPerNormal * sizeof(float);
 
     EXPECT_EQ(expectedBytes, meshConsolidator.getNumVertexNormalBytes());
@@ -214,8 +216,8 @@ TEST_F(MeshConsolidator_WithObjFiles_Test, test_batchInfoMap) {
     EXPECT_PRED_FORMAT2(assertContainsKey, batchInfoMap, "mesh9");
 
     vector<BatchInfo> batchInfoVec;
-    batchInfoVec.reserve(9);
-    for(int i = 0; i < 9; i++) {
+    batchInfoVec.reserve(numberOfUniqueCubes);
+    for(unsigned i = 0; i < numberOfUniqueCubes; i++) {
         BatchInfo b;
         b.startIndex = i*36;
         b.numIndices = 36;
@@ -227,6 +229,18 @@ TEST_F(MeshConsolidator_WithObjFiles_Test, test_batchInfoMap) {
     }
 }
 
+//---------------------------------------------------------------------------------------
+TEST_F(MeshConsolidator_WithObjFiles_Test, test_identicalMeshesShareBatchInfo) {
+    unsigned expected = numberOfUniqueCubes;
+    EXPECT_EQ(expected, meshConsolidator.getNumUniqueMeshes());
+
+    // mesh1, mesh3, mesh5, mesh6 and mesh9 all load cube.obj.
+    EXPECT_TRUE(batchInfoMap["mesh1"] == batchInfoMap["mesh3"]);
+    EXPECT_TRUE(batchInfoMap["mesh1"] == batchInfoMap["mesh9"]);
+    EXPECT_TRUE(batchInfoMap["mesh2"] == batchInfoMap["mesh8"]);
+    EXPECT_NE(batchInfoMap["mesh1"].startIndex, batchInfoMap["mesh2"].startIndex);
+}
+
 //---------------------------------------------------------------------------------------
 TEST_F(MeshConsolidator_WithObjFiles_Test, test_vertexDataPtr) {
     float * vertexDataPtr = const_cast<float *>(meshConsolidator.getVertexPositionDataPtr());
@@ -264,7 +278,7 @@ TEST_F(MeshConsolidator_WithObjFiles_Test, test_normalDataPtr) {
 //---------------------------------------------------------------------------------------
 TEST_F(MeshConsolidator_WithMeshes_Test, test_numVertexBytes){
 
-    unsigned expectedBytes = numberOfCubes * sidesPerCube * trianglesPerSide * verticesPerTriangle
+    unsigned expectedBytes = numberOfUniqueCubes * sidesPerCube * trianglesPerSide * verticesPerTriangle
                              * floatsPerVertex * sizeof(float);
 
     EXPECT_EQ(expectedBytes, meshConsolidator.getNumVertexPositionBytes());
@@ -272,7 +286,7 @@ TEST_F(MeshConsolidator_WithMeshes_Test, test_numVertexBytes){
 
 //---------------------------------------------------------------------------------------
 TEST_F(MeshConsolidator_WithMeshes_Test, test_numNormalBytes){
-    unsigned expectedBytes = numberOfCubes * sidesPerCube * trianglesPerSide * normalsPerTriangle
+    unsigned expectedBytes = numberOfUniqueCubes * sidesPerCube * trianglesPerSide * normalsPerTriangle
                              * floatsPerNormal * sizeof(float);
 
     EXPECT_EQ(expectedBytes, meshConsolidator.getNumVertexNormalBytes());
@@ -293,8 +307,8 @@ TEST_F(MeshConsolidator_WithMeshes_Test, test_batchInfoMap) {
     EXPECT_PRED_FORMAT2(assertContainsKey, batchInfoMap, "mesh9");
 
     vector<BatchInfo> batchInfoVec;
-    batchInfoVec.reserve(9);
-    for(int i = 0; i < 9; i++) {
+    batchInfoVec.reserve(numberOfUniqueCubes);
+    for(unsigned i = 0; i < numberOfUniqueCubes; i++) {
         BatchInfo b;
         b.startIndex = i*36;
         b.numIndices = 36;
@@ -306,6 +320,16 @@ TEST_F(MeshConsolidator_WithMeshes_Test, test_batchInfoMap) {
     }
 }
 
+//---------------------------------------------------------------------------------------
+TEST_F(MeshConsolidator_WithMeshes_Test, test_identicalMeshesShareBatchInfo) {
+    // Separately loaded Mesh objects with identical contents are stored once.
+    unsigned expected = numberOfUniqueCubes;
+    EXPECT_EQ(expected, meshConsolidator.getNumUniqueMeshes());
+    EXPECT_TRUE(batchInfoMap["mesh1"] == batchInfoMap["mesh2"]);
+    EXPECT_TRUE(batchInfoMap["mesh3"] == batchInfoMap["mesh9"]);
+    EXPECT_NE(batchInfoMap["mesh1"].startIndex, batchInfoMap["mesh3"].startIndex);
+}
+
 //---------------------------------------------------------------------------------------
 TEST_F(MeshConsolidator_WithMeshes_Test, test_vertexDataPtr) {
     float * vertexDataPtr = const_cast<float *>(meshConsolidator.getVertexPositionDataPtr());
@@ -335,3 +359,22 @@ TEST_F(MeshConsolidator_WithMeshes_Test, test_normalDataPtr) {
 
     ASSERT_TRUE(true);
 }
+
+//---------------------------------------------------------------------------------------
+TEST_F(MeshConsolidator_WithObjFiles_Test, test_boundingBoxes) {
+    unordered_map<const char *, AABB> boundingBoxMap;
+    meshConsolidator.getBoundingBoxes(boundingBoxMap);
+
+    unsigned expected = numberOfCubes;
+    EXPECT_EQ(expected, boundingBoxMap.size());
+
+    // cube.obj spans [-1, 1] and cube_smooth.obj spans [-0.5, 0.5] along each axis.
+    const AABB & cube = boundingBoxMap["mesh1"];
+    const AABB & cubeSmooth = boundingBoxMap["mesh2"];
+    for(int i = 0; i < 3; ++i) {
+        EXPECT_FLOAT_EQ(-1.0f, cube.minBounds[i]);
+        EXPECT_FLOAT_EQ(1.0f, cube.maxBounds[i]);
+        EXPECT_FLOAT_EQ(-0.5f, cubeSmooth.minBounds[i]);
+        EXPECT_FLOAT_EQ(0.5f, cubeSmooth.maxBounds[i]);
+    }
+}
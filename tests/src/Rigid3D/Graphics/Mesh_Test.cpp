@@ -205,3 +205,21 @@ TEST_F(Mesh_Textured_Cube_Test, test_number_of_textureCoords){
 TEST_F(Mesh_Textured_Cube_Test, test_textureCoord_data_bytes){
     EXPECT_EQ(expectedTextureCoordDataBytesSize, texturedMesh->getNumTextureCoordBytes());
 }
+
+//---------------------------------------------------------------------------------------
+TEST_F(Mesh_Cube_Test, test_bone_weights){
+    Mesh skinned("../data/meshes/cube.obj");
+    EXPECT_FALSE(skinned.hasBoneWeights());
+
+    vector<Rigid3D::uint8> boneIndices(expectedTotalVertices * Mesh::MaxBonesPerVertex, 0);
+    vector<glm::vec4> boneWeights(expectedTotalVertices, glm::vec4(1.0f, 0.0f, 0.0f, 0.0f));
+    skinned.setBoneWeights(std::move(boneIndices), std::move(boneWeights));
+
+    EXPECT_TRUE(skinned.hasBoneWeights());
+    EXPECT_EQ(expectedTotalVertices, skinned.getBoneWeightVector()->size());
+
+    // One weight short.
+    vector<Rigid3D::uint8> tooFewIndices((expectedTotalVertices - 1) * Mesh::MaxBonesPerVertex);
+    vector<glm::vec4> tooFewWeights(expectedTotalVertices - 1);
+    EXPECT_ANY_THROW(skinned.setBoneWeights(std::move(tooFewIndices), std::move(tooFewWeights)));
+}
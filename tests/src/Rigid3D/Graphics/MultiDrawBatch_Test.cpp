@@ -0,0 +1,158 @@
+// MultiDrawBatch_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/MaterialLibrary.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/MultiDrawBatch.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class MultiDrawBatch_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> shader;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+
+            shader = make_shared<ShaderProgram>();
+            shader->generateProgramObject();
+            shader->attachVertexShader("../../data/shaders/MaterialBatched.vert");
+            shader->attachFragmentShader("../../data/shaders/MaterialBatched.frag");
+            shader->link();
+        }
+
+        static void TearDownTestCase() {
+            shader.reset();
+            glContext.reset();
+        }
+
+        static vector<unsigned char> solidImage(GLsizei width, GLsizei height,
+                                                unsigned char r, unsigned char g,
+                                                unsigned char b) {
+            vector<unsigned char> pixels;
+            for (GLsizei i = 0; i < width * height; ++i) {
+                pixels.push_back(r);
+                pixels.push_back(g);
+                pixels.push_back(b);
+                pixels.push_back(255);
+            }
+            return pixels;
+        }
+
+        static MaterialProperties emissive(const vec3 & color) {
+            MaterialProperties properties;
+            properties.emission = color;
+            properties.Ka = vec3(0.0f);
+            properties.Kd = vec3(0.0f);
+            properties.Ks = 0.0f;
+            properties.shininessFactor = 1.0f;
+            return properties;
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> MultiDrawBatch_Test::glContext;
+    shared_ptr<ShaderProgram> MultiDrawBatch_Test::shader;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MultiDrawBatch_Test, test_mixed_indexed_batches_throw) {
+    MultiDrawBatch batch;
+    batch.addDraw(BatchInfo(0, 3), mat4(), 0);
+
+    EXPECT_THROW(batch.addDraw(BatchInfo(0, 3, 0), mat4(), 0), Rigid3DException);
+    EXPECT_THROW(batch.setMaterial(1, 0), Rigid3DException);
+
+    batch.clear();
+    batch.addDraw(BatchInfo(0, 3, 0), mat4(), 0);
+    EXPECT_TRUE(batch.isIndexed());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(MultiDrawBatch_Test, test_one_multi_draw_uses_per_draw_materials) {
+    // Red untextured on the left, green texture modulating white on the right.
+    // Uses bindless textures if the driver supports them.
+    MaterialLibrary materials;
+    vector<unsigned char> green = solidImage(2, 2, 0, 255, 0);
+    uint32 red = materials.addMaterial(emissive(vec3(1.0f, 0.0f, 0.0f)));
+    uint32 textured = materials.addMaterial(emissive(vec3(1.0f)),
+            materials.addTexture(2, 2, green.data()));
+
+    // Quad covering the left half of clip space.
+    vector<vec3> positions = {
+        vec3(-1.0f, -1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f),
+        vec3(-1.0f, -1.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f), vec3(-1.0f, 1.0f, 0.0f)
+    };
+
+    GLuint vao, vbo;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(vec3), positions.data(),
+            GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+    MultiDrawBatch batch;
+    batch.addDraw(BatchInfo(0, 6), mat4(), red);
+    batch.addDraw(BatchInfo(0, 6), glm::translate(mat4(), vec3(1.0f, 0.0f, 0.0f)),
+            textured);
+    batch.bindDrawIdAttribute(3);
+
+    GLuint framebuffer, colorBuffer;
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 4, 4);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+            colorBuffer);
+    glViewport(0, 0, 4, 4);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    shader->setUniform("ViewMatrix", mat4());
+    shader->setUniform("ProjectionMatrix", mat4());
+    shader->setUniform("ambientIntensity", vec3(0.0f));
+    shader->setUniform("lightSource.position", vec3(0.0f, 0.0f, 1.0f));
+    shader->setUniform("lightSource.rgbIntensity", vec3(0.0f));
+
+    materials.bind();
+    shader->enable();
+    batch.draw(GL_TRIANGLES);
+    shader->disable();
+
+    vector<unsigned char> pixels(4 * 4 * 4);
+    glReadPixels(0, 0, 4, 4, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    // Row 1, columns 0 and 3.
+    const unsigned char * left = &pixels[(4 + 0) * 4];
+    const unsigned char * right = &pixels[(4 + 3) * 4];
+    EXPECT_EQ(255, left[0]);
+    EXPECT_EQ(0, left[1]);
+    EXPECT_EQ(0, right[0]);
+    EXPECT_EQ(255, right[1]);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+    glBindVertexArray(0);
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+}
@@ -0,0 +1,126 @@
+// MultiViewRenderer_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/ThreadPool.hpp>
+#include <Rigid3D/Graphics/Camera.hpp>
+#include <Rigid3D/Graphics/MultiViewRenderer.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+using namespace Rigid3D;
+
+#include <algorithm>
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class MultiViewRenderer_Test : public ::testing::Test {
+    protected:
+        Camera leftCamera;
+        Camera rightCamera;
+        vector<RenderView> views;
+
+        Renderable leftObject;
+        Renderable rightObject;
+        Renderable behindObject;
+        Renderable unboundedObject;
+        vector<Renderable *> renderables;
+
+        MultiViewRenderer_Test()
+            : leftCamera(1.0f, 1.0f, 1.0f, 100.0f),
+              rightCamera(1.0f, 1.0f, 1.0f, 100.0f) { }
+
+        // Ran before each test.
+        virtual void SetUp() {
+            // Two cameras at x = -50 and x = 50, both looking down -z.
+            leftCamera.setPosition(-50.0f, 0.0f, 0.0f);
+            rightCamera.setPosition(50.0f, 0.0f, 0.0f);
+
+            views.push_back(RenderView(leftCamera, 0, Viewport(0, 0, 400, 600)));
+            views.push_back(RenderView(rightCamera, 0, Viewport(400, 0, 400, 600)));
+
+            AABB unitBox;
+            unitBox.minBounds = vec3(-1.0f);
+            unitBox.maxBounds = vec3(1.0f);
+
+            leftObject.setBoundingBox(unitBox);
+            leftObject.setPosition(vec3(-50.0f, 0.0f, -10.0f));
+
+            rightObject.setBoundingBox(unitBox);
+            rightObject.setPosition(vec3(50.0f, 0.0f, -10.0f));
+
+            behindObject.setBoundingBox(unitBox);
+            behindObject.setPosition(vec3(0.0f, 0.0f, 50.0f));
+
+            renderables.push_back(&leftObject);
+            renderables.push_back(&rightObject);
+            renderables.push_back(&behindObject);
+            renderables.push_back(&unboundedObject);
+        }
+
+        static bool contains(const vector<Renderable *> & list, const Renderable * r) {
+            return std::find(list.begin(), list.end(), r) != list.end();
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MultiViewRenderer_Test, objects_only_appear_in_views_that_see_them) {
+    MultiViewRenderer renderer;
+    renderer.buildCommandLists(views, renderables);
+
+    const vector<Renderable *> & leftList = renderer.getCommandList(0);
+    const vector<Renderable *> & rightList = renderer.getCommandList(1);
+
+    EXPECT_TRUE(contains(leftList, &leftObject));
+    EXPECT_FALSE(contains(leftList, &rightObject));
+    EXPECT_TRUE(contains(rightList, &rightObject));
+    EXPECT_FALSE(contains(rightList, &leftObject));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MultiViewRenderer_Test, union_pre_cull_rejects_objects_outside_all_views) {
+    MultiViewRenderer renderer;
+    renderer.buildCommandLists(views, renderables);
+
+    EXPECT_EQ(3u, renderer.getNumSharedCandidates());
+    EXPECT_FALSE(contains(renderer.getCommandList(0), &behindObject));
+    EXPECT_FALSE(contains(renderer.getCommandList(1), &behindObject));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MultiViewRenderer_Test, objects_without_bounds_are_never_culled) {
+    MultiViewRenderer renderer;
+    renderer.buildCommandLists(views, renderables);
+
+    EXPECT_TRUE(contains(renderer.getCommandList(0), &unboundedObject));
+    EXPECT_TRUE(contains(renderer.getCommandList(1), &unboundedObject));
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(MultiViewRenderer_Test, parallel_build_matches_serial_build) {
+    // Many objects spread across both views.
+    vector<Renderable> grid(2000);
+    vector<Renderable *> gridPointers;
+    AABB unitBox;
+    unitBox.minBounds = vec3(-1.0f);
+    unitBox.maxBounds = vec3(1.0f);
+    for (size_t i = 0; i < grid.size(); ++i) {
+        grid[i].setBoundingBox(unitBox);
+        grid[i].setPosition(vec3(float(i % 100) * 2.0f - 100.0f, 0.0f, -float(i / 100) * 5.0f));
+        gridPointers.push_back(&grid[i]);
+    }
+
+    MultiViewRenderer serialRenderer;
+    serialRenderer.buildCommandLists(views, gridPointers);
+
+    ThreadPool threadPool(4);
+    MultiViewRenderer parallelRenderer(&threadPool);
+    parallelRenderer.buildCommandLists(views, gridPointers);
+
+    for (size_t v = 0; v < views.size(); ++v) {
+        EXPECT_EQ(serialRenderer.getCommandList(v), parallelRenderer.getCommandList(v));
+        EXPECT_FALSE(serialRenderer.getCommandList(v).empty());
+    }
+}
@@ -0,0 +1,183 @@
+// ObjectIdPicker_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/ObjectIdPicker.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    const int width = 32;
+    const int height = 16;
+
+    class ObjectIdPicker_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static GLuint framebuffer;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+            glGenFramebuffers(1, &framebuffer);
+        }
+
+        static void TearDownTestCase() {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &framebuffer);
+            glContext.reset();
+        }
+
+        // Attaches the picker's ID texture as the framebuffer's only draw buffer.
+        static void attach(ObjectIdPicker & picker) {
+            picker.resize(width, height);
+            picker.attachToFramebuffer(framebuffer, GL_COLOR_ATTACHMENT0);
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            const GLenum drawBuffer = GL_COLOR_ATTACHMENT0;
+            glDrawBuffers(1, &drawBuffer);
+            ASSERT_EQ(GLenum(GL_FRAMEBUFFER_COMPLETE), glCheckFramebufferStatus(GL_FRAMEBUFFER));
+        }
+
+        // Writes 'id' to a rectangle of the ID buffer, standing in for the scene pass.
+        static void fillRect(uint32 id, int x, int y, int rectWidth, int rectHeight) {
+            const GLuint value[4] = { id, 0, 0, 0 };
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(x, y, rectWidth, rectHeight);
+            glClearBufferuiv(GL_COLOR, 0, value);
+            glDisable(GL_SCISSOR_TEST);
+        }
+
+        static bool waitForResult(ObjectIdPicker & picker, ObjectIdPicker::PickResult & result) {
+            for (int i = 0; i < 1000; ++i) {
+                if (picker.getResult(result)) {
+                    return true;
+                }
+                glFlush();
+            }
+            return false;
+        }
+    };
+
+}
+
+shared_ptr<OpenGLContext> ObjectIdPicker_Test::glContext = nullptr;
+GLuint ObjectIdPicker_Test::framebuffer = 0;
+
+//---------------------------------------------------------------------------------------
+TEST_F(ObjectIdPicker_Test, test_findNearestId) {
+    const uint32 ids[] = {
+        0, 0, 0, 0, 0,
+        0, 0, 0, 0, 7,
+        0, 0, 0, 0, 0,
+        0, 3, 0, 0, 0,
+        0, 0, 0, 0, 0,
+    };
+
+    EXPECT_EQ(3u, ObjectIdPicker::findNearestId(ids, 5, 5, 2, 2));
+    EXPECT_EQ(7u, ObjectIdPicker::findNearestId(ids, 5, 5, 4, 2));
+    EXPECT_EQ(3u, ObjectIdPicker::findNearestId(ids, 5, 5, 1, 3));
+
+    const uint32 background[9] = { 0 };
+    EXPECT_EQ(0u, ObjectIdPicker::findNearestId(background, 3, 3, 1, 1));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ObjectIdPicker_Test, test_attach_before_resize_throws) {
+    ObjectIdPicker picker;
+    EXPECT_THROW(picker.attachToFramebuffer(framebuffer, GL_COLOR_ATTACHMENT0),
+            Rigid3DException);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ObjectIdPicker_Test, test_pick_resolves_objects_and_background) {
+    ObjectIdPicker picker(2);
+    attach(picker);
+
+    picker.clear(0);
+    fillRect(42, 4, 4, 4, 4);
+    fillRect(9, 20, 10, 1, 1);
+
+    EXPECT_TRUE(picker.requestPick(5, 5));      // Inside object 42.
+    EXPECT_TRUE(picker.requestPick(21, 11));    // Beside object 9, within the radius.
+    EXPECT_TRUE(picker.requestPick(14, 2));     // Background.
+    EXPECT_EQ(3u, picker.getNumPendingPicks());
+
+    // Results come back in request order.
+    ObjectIdPicker::PickResult result;
+    ASSERT_TRUE(waitForResult(picker, result));
+    EXPECT_EQ(42u, result.objectId);
+    EXPECT_EQ(5, result.x);
+    EXPECT_EQ(5, result.y);
+
+    ASSERT_TRUE(waitForResult(picker, result));
+    EXPECT_EQ(9u, result.objectId);
+
+    ASSERT_TRUE(waitForResult(picker, result));
+    EXPECT_EQ(0u, result.objectId);
+
+    EXPECT_EQ(0u, picker.getNumPendingPicks());
+    EXPECT_FALSE(picker.getResult(result));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ObjectIdPicker_Test, test_requestPick_rejects_out_of_bounds_and_full_ring) {
+    ObjectIdPicker picker(1, 2);
+    attach(picker);
+    picker.clear(0);
+    fillRect(5, width - 1, height - 1, 1, 1);
+
+    EXPECT_FALSE(picker.requestPick(-1, 0));
+    EXPECT_FALSE(picker.requestPick(width, 0));
+    EXPECT_FALSE(picker.requestPick(0, height));
+
+    // The corner pick is clamped to the framebuffer.
+    EXPECT_TRUE(picker.requestPick(width - 1, height - 1));
+    EXPECT_TRUE(picker.requestPick(0, 0));
+    EXPECT_FALSE(picker.requestPick(1, 1));
+
+    ObjectIdPicker::PickResult result;
+    ASSERT_TRUE(waitForResult(picker, result));
+    EXPECT_EQ(5u, result.objectId);
+    EXPECT_TRUE(picker.requestPick(1, 1));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ObjectIdPicker_Test, test_setSource_reads_external_attachment) {
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32UI, width, height);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLuint external;
+    glGenFramebuffers(1, &external);
+    glBindFramebuffer(GL_FRAMEBUFFER, external);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, texture, 0);
+    const GLenum drawBuffers[] = { GL_NONE, GL_NONE, GL_COLOR_ATTACHMENT2 };
+    glDrawBuffers(3, drawBuffers);
+
+    ObjectIdPicker picker(0);
+    picker.setSource(external, GL_COLOR_ATTACHMENT2, width, height);
+    EXPECT_EQ(0u, picker.getIdTexture());
+
+    picker.clear(2);
+    const GLuint value[4] = { 77, 0, 0, 0 };
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(3, 3, 1, 1);
+    glClearBufferuiv(GL_COLOR, 2, value);
+    glDisable(GL_SCISSOR_TEST);
+
+    EXPECT_TRUE(picker.requestPick(3, 3));
+    ObjectIdPicker::PickResult result;
+    ASSERT_TRUE(waitForResult(picker, result));
+    EXPECT_EQ(77u, result.objectId);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &external);
+    glDeleteTextures(1, &texture);
+}
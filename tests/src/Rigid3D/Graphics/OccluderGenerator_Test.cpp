@@ -0,0 +1,113 @@
+/**
+ * @brief OccluderGenerator_Test
+ */
+
+#include <gtest/gtest.h>
+
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/OccluderGenerator.hpp>
+using namespace Rigid3D;
+
+#include <glm/glm.hpp>
+using glm::cross;
+using glm::dot;
+
+#include <vector>
+using std::vector;
+
+namespace {  // limit class visibility to this file.
+
+    class OccluderGenerator_Test : public ::testing::Test {
+    protected:
+        static Mesh * cube;
+
+        // Ran once before all tests.
+        static void SetUpTestCase() {
+            cube = new Mesh("../data/meshes/cube.obj");
+        }
+
+        // Ran once after all tests have finished.
+        static void TearDownTestCase() {
+            delete cube;
+            cube = nullptr;
+        }
+
+        static bool contains(const AABB & outer, const AABB & inner) {
+            for (int i = 0; i < 3; ++i) {
+                if (inner.minBounds[i] < outer.minBounds[i] || inner.maxBounds[i] > outer.maxBounds[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    Mesh * OccluderGenerator_Test::cube = nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(OccluderGenerator_Test, cube_produces_single_inner_box) {
+    OccluderSettings settings;
+    settings.resolution = 16;
+
+    Occluder occluder;
+    OccluderGenerator::generate(*cube, settings, occluder);
+
+    ASSERT_EQ(1u, occluder.boxes.size());
+    EXPECT_EQ(12u, occluder.getNumTriangles());
+
+    // Box must be strictly within the cube, and cover most of it.
+    AABB unitCube;
+    unitCube.minBounds = vec3(-1.0f);
+    unitCube.maxBounds = vec3(1.0f);
+    EXPECT_TRUE(contains(unitCube, occluder.boxes[0]));
+
+    vec3 extent = occluder.boxes[0].maxBounds - occluder.boxes[0].minBounds;
+    EXPECT_GT(extent.x * extent.y * extent.z, 0.5f * 8.0f);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(OccluderGenerator_Test, erosion_shrinks_occluder) {
+    OccluderSettings settings;
+    settings.resolution = 16;
+
+    Occluder occluder;
+    OccluderGenerator::generate(*cube, settings, occluder);
+
+    settings.erosionSteps = 2;
+    Occluder eroded;
+    OccluderGenerator::generate(*cube, settings, eroded);
+
+    ASSERT_EQ(1u, occluder.boxes.size());
+    ASSERT_EQ(1u, eroded.boxes.size());
+    EXPECT_TRUE(contains(occluder.boxes[0], eroded.boxes[0]));
+    EXPECT_LT(eroded.boxes[0].maxBounds.x, occluder.boxes[0].maxBounds.x);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(OccluderGenerator_Test, open_mesh_produces_empty_occluder) {
+    vector<vec3> triangle = {vec3(0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f)};
+
+    Occluder occluder;
+    OccluderGenerator::generate(triangle, OccluderSettings(), occluder);
+
+    EXPECT_TRUE(occluder.boxes.empty());
+    EXPECT_TRUE(occluder.trianglePositions.empty());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(OccluderGenerator_Test, box_triangles_face_outward) {
+    AABB box;
+    box.minBounds = vec3(-1.0f, -2.0f, -3.0f);
+    box.maxBounds = vec3(1.0f, 2.0f, 3.0f);
+
+    vector<vec3> positions;
+    OccluderGenerator::triangulateBox(box, positions);
+    ASSERT_EQ(36u, positions.size());
+
+    for (size_t i = 0; i < positions.size(); i += 3) {
+        vec3 normal = cross(positions[i + 1] - positions[i], positions[i + 2] - positions[i]);
+        vec3 centroid = (positions[i] + positions[i + 1] + positions[i + 2]) / 3.0f;
+        EXPECT_GT(dot(normal, centroid - box.getCenter()), 0.0f);
+    }
+}
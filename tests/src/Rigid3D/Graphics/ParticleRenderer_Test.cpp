@@ -0,0 +1,104 @@
+// ParticleRenderer_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Graphics/ParticleRenderer.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Particles/ParticleEmitter.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class ParticleRenderer_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> shader;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+
+            shader = make_shared<ShaderProgram>();
+            shader->generateProgramObject();
+            shader->attachVertexShader("../../data/shaders/Particle.vert");
+            shader->attachFragmentShader("../../data/shaders/Particle.frag");
+            shader->link();
+        }
+
+        static void TearDownTestCase() {
+            shader.reset();
+            glContext.reset();
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> ParticleRenderer_Test::glContext;
+    shared_ptr<ShaderProgram> ParticleRenderer_Test::shader;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(ParticleRenderer_Test, test_each_emitter_is_one_round_sprite_draw) {
+    // One particle filling the viewport, and one off screen.
+    ParticleEmitter::Params params;
+    params.velocity = vec3(0.0f);
+    params.color = vec4(0.0f, 1.0f, 0.0f, 1.0f);
+    params.size = 1.0f;
+    ParticleEmitter visible(4, params);
+    visible.emit(1);
+
+    params.position = vec3(10.0f, 0.0f, 0.0f);
+    ParticleEmitter hidden(4, params);
+    hidden.emit(3);
+
+    ParticleRenderer renderer(*shader, 3);
+
+    GLuint framebuffer, colorBuffer;
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 4, 4);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+            colorBuffer);
+    glViewport(0, 0, 4, 4);
+
+    shader->setUniform("ModelViewMatrix", mat4());
+    shader->setUniform("ProjectionMatrix", mat4());
+
+    vector<unsigned char> pixels(4 * 4 * 4);
+
+    // More frames than ring regions, so every region is reused.
+    for (uint32 frame = 0; frame < 2 * ParticleRenderer::NumRegions; ++frame) {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        renderer.beginFrame();
+        EXPECT_EQ(1u, renderer.render(visible));
+        // Only two instances are left this frame.
+        EXPECT_EQ(2u, renderer.render(hidden));
+        EXPECT_EQ(3u, renderer.getNumInstances());
+        renderer.endFrame();
+
+        glReadPixels(0, 0, 4, 4, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        // Pixel (1, 1) is near the center of the sprite, pixel (0, 0) outside its
+        // circle.
+        const unsigned char * center = &pixels[(1 * 4 + 1) * 4];
+        const unsigned char * corner = &pixels[0];
+        EXPECT_EQ(0, center[0]);
+        EXPECT_EQ(255, center[1]);
+        EXPECT_GT(center[3], 128);
+        EXPECT_EQ(0, corner[3]);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+}
@@ -0,0 +1,150 @@
+// PointLightShadowAtlas_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Graphics/PointLightShadowAtlas.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Graphics/StaticGeometryBuffer.hpp>
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Collision/FrustumPlanes.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class PointLightShadowAtlas_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> depthShader;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 3);
+            glContext->init();
+
+            depthShader = make_shared<ShaderProgram>();
+            depthShader->generateProgramObject();
+            depthShader->attachVertexShader("../../data/shaders/PointShadow.vert");
+            depthShader->attachGeometryShader("../../data/shaders/PointShadow.geom");
+            depthShader->attachFragmentShader("../../data/shaders/PointShadow.frag");
+            depthShader->link();
+        }
+
+        static void TearDownTestCase() {
+            depthShader.reset();
+            glContext.reset();
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> PointLightShadowAtlas_Test::glContext;
+    shared_ptr<ShaderProgram> PointLightShadowAtlas_Test::depthShader;
+
+}
+
+//----------------------------------------------------------------------------------------
+/*
+ * A point on each axis should lie inside the face looking down that axis and
+ * outside the face looking the opposite way.
+ */
+TEST_F(PointLightShadowAtlas_Test, faces_look_down_cube_map_axes) {
+    const vec3 lightPosition(1.0f, 2.0f, 3.0f);
+    const float radius = 10.0f;
+    const vec3 axes[6] = {
+        vec3( 1.0f,  0.0f,  0.0f), vec3(-1.0f,  0.0f,  0.0f),
+        vec3( 0.0f,  1.0f,  0.0f), vec3( 0.0f, -1.0f,  0.0f),
+        vec3( 0.0f,  0.0f,  1.0f), vec3( 0.0f,  0.0f, -1.0f)
+    };
+
+    mat4 projection = PointLightShadowAtlas::getFaceProjectionMatrix(radius);
+    for (unsigned int face = 0; face < 6; ++face) {
+        FrustumPlanes planes(projection *
+                PointLightShadowAtlas::getFaceViewMatrix(lightPosition, face));
+
+        EXPECT_TRUE(planes.intersectsSphere(lightPosition + axes[face] * 5.0f, 0.01f));
+        EXPECT_FALSE(planes.intersectsSphere(lightPosition - axes[face] * 5.0f, 0.01f));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST_F(PointLightShadowAtlas_Test, faces_end_at_light_radius) {
+    const vec3 lightPosition(0.0f);
+    const float radius = 10.0f;
+
+    FrustumPlanes planes(PointLightShadowAtlas::getFaceProjectionMatrix(radius) *
+            PointLightShadowAtlas::getFaceViewMatrix(lightPosition, 0));
+
+    EXPECT_TRUE(planes.intersectsSphere(vec3(9.9f, 0.0f, 0.0f), 0.01f));
+    EXPECT_FALSE(planes.intersectsSphere(vec3(10.5f, 0.0f, 0.0f), 0.01f));
+}
+
+//----------------------------------------------------------------------------------------
+/*
+ * Each light has one small caster three units down its +X axis, so rendering a
+ * light's slot draws exactly one caster/face pair.  Only lights whose signature
+ * changed since the previous frame are rendered again.
+ */
+TEST_F(PointLightShadowAtlas_Test, only_changed_lights_are_rendered_again) {
+    StaticGeometryBuffer geometry(16, 16);
+    const vec3 positions[3] = {
+        vec3(0.0f, -0.1f, -0.1f), vec3(0.0f, 0.1f, -0.1f), vec3(0.0f, 0.0f, 0.1f)
+    };
+    const uint32 indices[3] = {0, 1, 2};
+    StaticGeometryBuffer::Allocation triangle;
+    ASSERT_TRUE(geometry.allocate(positions, NULL, 3, indices, 3, triangle));
+
+    AABB bounds;
+    bounds.minBounds = vec3(-0.1f);
+    bounds.maxBounds = vec3(0.1f);
+
+    Renderable near(&geometry.getVertexArray(), nullptr, &triangle.batchInfo);
+    Renderable far(&geometry.getVertexArray(), nullptr, &triangle.batchInfo);
+    near.setBoundingBox(bounds);
+    far.setBoundingBox(bounds);
+    near.setPosition(vec3(3.0f, 0.0f, 0.0f));
+    far.setPosition(vec3(103.0f, 0.0f, 0.0f));
+
+    vector<PointLight> lights;
+    lights.push_back(PointLight(1, vec3(0.0f), 10.0f));
+    lights.push_back(PointLight(2, vec3(100.0f, 0.0f, 0.0f), 10.0f));
+    vector<const Renderable *> casters;
+    casters.push_back(&near);
+    casters.push_back(&far);
+
+    PointLightShadowAtlas atlas(16, 2, *depthShader);
+    vector<int> shadowSlots;
+
+    atlas.render(lights, casters, shadowSlots);
+    EXPECT_EQ(2u, atlas.getNumFacesRenderedLastFrame());
+    ASSERT_EQ(2u, shadowSlots.size());
+    EXPECT_GE(shadowSlots[0], 0);
+    EXPECT_GE(shadowSlots[1], 0);
+    EXPECT_NE(shadowSlots[0], shadowSlots[1]);
+
+    // Nothing changed.
+    const vector<int> firstSlots = shadowSlots;
+    atlas.render(lights, casters, shadowSlots);
+    EXPECT_EQ(0u, atlas.getNumFacesRenderedLastFrame());
+    EXPECT_EQ(firstSlots, shadowSlots);
+
+    // A moved light is rendered again, into the same slot.
+    lights[1].position.z += 0.5f;
+    atlas.render(lights, casters, shadowSlots);
+    EXPECT_EQ(1u, atlas.getNumFacesRenderedLastFrame());
+    EXPECT_EQ(firstSlots, shadowSlots);
+
+    // As is a light whose caster moved.
+    near.setPosition(vec3(4.0f, 0.0f, 0.0f));
+    atlas.render(lights, casters, shadowSlots);
+    EXPECT_EQ(1u, atlas.getNumFacesRenderedLastFrame());
+
+    atlas.render(lights, casters, shadowSlots);
+    EXPECT_EQ(0u, atlas.getNumFacesRenderedLastFrame());
+
+    geometry.free(triangle);
+}
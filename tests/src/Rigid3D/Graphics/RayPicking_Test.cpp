@@ -0,0 +1,154 @@
+// RayPicking_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Collision/AABB.hpp>
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/MeshConsolidator.hpp>
+#include <Rigid3D/Graphics/RayPicking.hpp>
+#include <Rigid3D/Graphics/Renderable.hpp>
+using namespace Rigid3D;
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class RayPicking_Test : public ::testing::Test {
+    protected:
+        // Two triangles forming a unit square centered on the origin in the xy-plane.
+        vector<float> positions;
+        BatchInfo square;
+
+        RayPicking_Test() {
+            positions = {
+                -0.5f, -0.5f, 0.0f,   0.5f, -0.5f, 0.0f,   0.5f, 0.5f, 0.0f,
+                -0.5f, -0.5f, 0.0f,   0.5f,  0.5f, 0.0f,  -0.5f, 0.5f, 0.0f,
+            };
+            square.startIndex = 0;
+            square.numIndices = 6;
+        }
+
+        static RayCastInput ray(const vec3 & p1, const vec3 & p2) {
+            RayCastInput input;
+            input.p1 = p1;
+            input.p2 = p2;
+            input.maxLength = glm::length(p2 - p1);
+            return input;
+        }
+    };
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RayPicking_Test, test_computePickRay_through_screen_center) {
+    mat4 view = glm::lookAt(vec3(0.0f, 0.0f, 5.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f));
+    mat4 projection = glm::perspective(glm::radians(60.0f), 1.0f, 1.0f, 100.0f);
+
+    RayCastInput input = computePickRay(view, projection, vec2(0.0f));
+
+    EXPECT_NEAR(0.0f, input.p1.x, 1e-4f);
+    EXPECT_NEAR(0.0f, input.p1.y, 1e-4f);
+    EXPECT_NEAR(4.0f, input.p1.z, 1e-3f);
+    EXPECT_NEAR(-95.0f, input.p2.z, 1e-1f);
+    EXPECT_NEAR(99.0f, input.maxLength, 1e-1f);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RayPicking_Test, test_rayCastTriangles_hit_in_world_space) {
+    mat4 model = glm::translate(mat4(), vec3(0.0f, 0.0f, -2.0f));
+    model = glm::scale(model, vec3(2.0f));
+
+    RayCastOutput output;
+    RayCastInput input = ray(vec3(0.5f, 0.25f, 3.0f), vec3(0.5f, 0.25f, -10.0f));
+    ASSERT_TRUE(rayCastTriangles(positions.data(), square, model, input, &output));
+
+    EXPECT_NEAR(0.5f, output.hitPoint.x, 1e-5f);
+    EXPECT_NEAR(0.25f, output.hitPoint.y, 1e-5f);
+    EXPECT_NEAR(-2.0f, output.hitPoint.z, 1e-5f);
+    EXPECT_NEAR(5.0f, output.length, 1e-5f);
+
+    // Normal faces back along the ray.
+    EXPECT_NEAR(1.0f, output.normal.z, 1e-5f);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RayPicking_Test, test_rayCastTriangles_misses) {
+    mat4 model;
+    RayCastOutput output;
+
+    // Passes beside the square.
+    EXPECT_FALSE(rayCastTriangles(positions.data(), square, model,
+            ray(vec3(0.6f, 0.0f, 1.0f), vec3(0.6f, 0.0f, -1.0f)), &output));
+
+    // Stops short of the square.
+    EXPECT_FALSE(rayCastTriangles(positions.data(), square, model,
+            ray(vec3(0.0f, 0.0f, 2.0f), vec3(0.0f, 0.0f, 1.0f)), &output));
+
+    // Points away from the square.
+    EXPECT_FALSE(rayCastTriangles(positions.data(), square, model,
+            ray(vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, 2.0f)), &output));
+
+    // Too few vertices for a triangle.
+    BatchInfo degenerate(0, 1);
+    EXPECT_FALSE(rayCastTriangles(positions.data(), degenerate, model,
+            ray(vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f)), &output));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RayPicking_Test, test_rayCastTriangles_indexed_batch) {
+    // The same square from four shared corners, after an unused vertex far away
+    // that baseVertex skips.  The first index range is padding.
+    vector<float> corners = {
+        100.0f, 100.0f, 100.0f,
+        -0.5f, -0.5f, 0.0f,   0.5f, -0.5f, 0.0f,   0.5f, 0.5f, 0.0f,   -0.5f, 0.5f, 0.0f,
+    };
+    vector<uint32> indices = {0, 0, 0,   0, 1, 2,   0, 2, 3};
+    BatchInfo indexedSquare(3, 6, 1);
+
+    mat4 model;
+    RayCastOutput output;
+    RayCastInput input = ray(vec3(-0.25f, 0.25f, 1.0f), vec3(-0.25f, 0.25f, -1.0f));
+    ASSERT_TRUE(rayCastTriangles(corners.data(), indexedSquare, model, input, &output,
+            indices.data()));
+    EXPECT_NEAR(1.0f, output.length, 1e-5f);
+
+    EXPECT_FALSE(rayCastTriangles(corners.data(), indexedSquare, model,
+            ray(vec3(0.6f, 0.0f, 1.0f), vec3(0.6f, 0.0f, -1.0f)), &output, indices.data()));
+
+    EXPECT_THROW(rayCastTriangles(corners.data(), indexedSquare, model, input, &output),
+            Rigid3DException);
+
+    Renderable renderable(nullptr, nullptr, &indexedSquare);
+    vector<const Renderable *> renderables = {&renderable};
+    EXPECT_EQ(0, rayCastRenderables(renderables, corners.data(), input, &output,
+            indices.data()));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RayPicking_Test, test_rayCastRenderables_returns_closest) {
+    Renderable farSquare(nullptr, nullptr, &square);
+    farSquare.setPosition(vec3(0.0f, 0.0f, -4.0f));
+
+    Renderable nearSquare(nullptr, nullptr, &square);
+    nearSquare.setPosition(vec3(0.0f, 0.0f, -1.0f));
+    AABB bounds;
+    bounds.minBounds = vec3(-0.5f, -0.5f, 0.0f);
+    bounds.maxBounds = vec3(0.5f, 0.5f, 0.0f);
+    nearSquare.setBoundingBox(bounds);
+
+    Renderable offsetSquare(nullptr, nullptr, &square);
+    offsetSquare.setPosition(vec3(3.0f, 0.0f, -0.5f));
+
+    vector<const Renderable *> renderables = { &farSquare, &offsetSquare, &nearSquare };
+
+    RayCastOutput output;
+    RayCastInput input = ray(vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -10.0f));
+    EXPECT_EQ(2, rayCastRenderables(renderables, positions.data(), input, &output));
+    EXPECT_NEAR(-1.0f, output.hitPoint.z, 1e-5f);
+
+    input = ray(vec3(5.0f, 5.0f, 1.0f), vec3(5.0f, 5.0f, -10.0f));
+    EXPECT_EQ(-1, rayCastRenderables(renderables, positions.data(), input, &output));
+}
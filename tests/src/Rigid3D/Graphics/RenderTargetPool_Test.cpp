@@ -0,0 +1,253 @@
+// RenderTargetPool_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/RenderTargetPool.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class RenderTargetPool_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+        }
+
+        static void TearDownTestCase() {
+            glContext.reset();
+        }
+    };
+
+}
+
+shared_ptr<OpenGLContext> RenderTargetPool_Test::glContext = nullptr;
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_released_texture_is_reused) {
+    RenderTargetPool pool;
+    RenderTargetDesc desc(64, 32, GL_RGBA8);
+
+    GLuint first = pool.acquireTexture(desc);
+    GLuint second = pool.acquireTexture(desc);
+    EXPECT_NE(first, second);
+
+    pool.releaseTexture(first);
+    EXPECT_EQ(first, pool.acquireTexture(desc));
+
+    RenderTargetPool::Stats stats = pool.getStats();
+    EXPECT_EQ(2u, stats.numTextures);
+    EXPECT_EQ(2u, stats.numTexturesInUse);
+    EXPECT_EQ(2u, stats.numTexturesCreated);
+    EXPECT_EQ(1u, stats.numTexturesReused);
+    EXPECT_EQ(2u * 64 * 32 * 4, stats.numBytes);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_acquire_keeps_bound_texture) {
+    GLuint bound;
+    glGenTextures(1, &bound);
+    glBindTexture(GL_TEXTURE_2D, bound);
+
+    RenderTargetPool pool;
+    RenderTargetDesc desc(16, 16, GL_RGBA8);
+    GLuint texture = pool.acquireTexture(desc);
+    pool.releaseTexture(texture);
+    pool.acquireTexture(desc);
+
+    GLint binding = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &binding);
+    EXPECT_EQ(bound, GLuint(binding));
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    pool.clear();
+    glDeleteTextures(1, &bound);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_bytes_per_pixel_of_wide_formats) {
+    EXPECT_EQ(8, RenderTargetPool::getBytesPerPixel(GL_RGBA16));
+    EXPECT_EQ(8, RenderTargetPool::getBytesPerPixel(GL_RGBA16F));
+    EXPECT_EQ(8, RenderTargetPool::getBytesPerPixel(GL_RGBA16UI));
+    EXPECT_EQ(16, RenderTargetPool::getBytesPerPixel(GL_RGBA32UI));
+    EXPECT_EQ(4, RenderTargetPool::getBytesPerPixel(GL_RGBA8));
+    EXPECT_EQ(2, RenderTargetPool::getBytesPerPixel(GL_R16));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_mismatched_size_or_format_is_not_reused) {
+    RenderTargetPool pool;
+
+    GLuint texture = pool.acquireTexture(RenderTargetDesc(64, 32, GL_RGBA8));
+    pool.releaseTexture(texture);
+
+    EXPECT_NE(texture, pool.acquireTexture(RenderTargetDesc(64, 32, GL_RGBA16F)));
+    EXPECT_NE(texture, pool.acquireTexture(RenderTargetDesc(32, 32, GL_RGBA8)));
+
+    // Sampling state alone does not prevent reuse.
+    RenderTargetDesc nearest(64, 32, GL_RGBA8);
+    nearest.filter = GL_NEAREST;
+    EXPECT_EQ(texture, pool.acquireTexture(nearest));
+
+    GLint filter;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &filter);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    EXPECT_EQ(GL_NEAREST, filter);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_framebuffers_are_cached_by_attachments) {
+    RenderTargetPool pool;
+    GLuint color0 = pool.acquireTexture(RenderTargetDesc(16, 16, GL_RGBA8));
+    GLuint color1 = pool.acquireTexture(RenderTargetDesc(16, 16, GL_R32F));
+    GLuint depth = pool.acquireTexture(RenderTargetDesc(16, 16, GL_DEPTH_COMPONENT24));
+
+    GLuint framebuffer = pool.getFramebuffer({ color0, color1 }, depth);
+    EXPECT_NE(0u, framebuffer);
+    EXPECT_EQ(framebuffer, pool.getFramebuffer({ color0, color1 }, depth));
+
+    GLuint depthOnly = pool.getFramebuffer({}, depth);
+    EXPECT_NE(framebuffer, depthOnly);
+    EXPECT_NE(framebuffer, pool.getFramebuffer({ color1, color0 }, depth));
+    EXPECT_EQ(3u, pool.getStats().numFramebuffers);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    EXPECT_EQ(GLenum(GL_FRAMEBUFFER_COMPLETE), glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    GLint drawBuffer;
+    glGetIntegerv(GL_DRAW_BUFFER1, &drawBuffer);
+    EXPECT_EQ(GL_COLOR_ATTACHMENT1, drawBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_invalid_requests_throw) {
+    RenderTargetPool pool;
+    EXPECT_THROW(pool.acquireTexture(RenderTargetDesc(0, 16, GL_RGBA8)), Rigid3DException);
+    EXPECT_THROW(pool.releaseTexture(12345), Rigid3DException);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_delayed_release_waits_for_frames) {
+    RenderTargetPool pool;
+    RenderTargetDesc desc(16, 16, GL_RGBA8);
+
+    GLuint texture = pool.acquireTexture(desc);
+    pool.releaseTexture(texture, 2);
+    EXPECT_EQ(1u, pool.getStats().numTexturesPendingRelease);
+
+    pool.nextFrame();
+    GLuint other = pool.acquireTexture(desc);
+    EXPECT_NE(texture, other);
+    pool.releaseTexture(other);
+
+    pool.nextFrame();
+    EXPECT_EQ(0u, pool.getStats().numTexturesPendingRelease);
+
+    // Both are free, the most recently used one is handed out first.
+    EXPECT_EQ(other, pool.acquireTexture(desc));
+    EXPECT_EQ(texture, pool.acquireTexture(desc));
+    EXPECT_EQ(2u, pool.getFrameIndex());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_memory_budget_evicts_least_recently_used) {
+    const uint64 textureBytes = 16 * 16 * 4;
+    RenderTargetPool pool(2 * textureBytes);
+
+    GLuint oldest = pool.acquireTexture(RenderTargetDesc(16, 16, GL_RGBA8));
+    pool.releaseTexture(oldest);
+    pool.nextFrame();
+    GLuint newer = pool.acquireTexture(RenderTargetDesc(16, 16, GL_R32F));
+    pool.releaseTexture(newer);
+    pool.nextFrame();
+
+    GLuint framebuffer = pool.getFramebuffer({ oldest }, 0);
+    EXPECT_NE(0u, framebuffer);
+    EXPECT_EQ(1u, pool.getStats().numFramebuffers);
+
+    // A third texture exceeds the budget, so the least recently used one goes,
+    // taking its cached framebuffer with it.
+    GLuint inUse = pool.acquireTexture(RenderTargetDesc(16, 16, GL_RG16F));
+    RenderTargetPool::Stats stats = pool.getStats();
+    EXPECT_EQ(2u, stats.numTextures);
+    EXPECT_EQ(1u, stats.numTexturesEvicted);
+    EXPECT_EQ(0u, stats.numFramebuffers);
+    EXPECT_EQ(2 * textureBytes, stats.numBytes);
+    EXPECT_EQ(GL_FALSE, glIsTexture(oldest));
+
+    // Textures in use are never evicted, even over budget.
+    pool.setMemoryBudget(1);
+    EXPECT_EQ(1u, pool.getStats().numTextures);
+    EXPECT_EQ(GL_TRUE, glIsTexture(inUse));
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_idle_textures_are_evicted) {
+    RenderTargetPool pool(0, 2);
+
+    GLuint texture = pool.acquireTexture(RenderTargetDesc(16, 16, GL_RGBA8));
+    pool.releaseTexture(texture);
+    pool.nextFrame();
+    pool.nextFrame();
+    EXPECT_EQ(1u, pool.getStats().numTextures);
+
+    pool.nextFrame();
+    EXPECT_EQ(0u, pool.getStats().numTextures);
+    EXPECT_EQ(0u, pool.getStats().numBytes);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_render_targets_are_reused_across_resizes) {
+    RenderTargetPool pool;
+    vector<RenderTargetDesc> colors = { RenderTargetDesc(64, 48, GL_RGBA8) };
+    RenderTargetDesc depth(64, 48, GL_DEPTH24_STENCIL8);
+
+    RenderTarget original = pool.acquireRenderTarget(colors, depth);
+    EXPECT_EQ(64, original.width);
+    EXPECT_NE(0u, original.depthTexture);
+    GLuint originalFramebuffer = original.framebuffer;
+    GLuint originalColor = original.colorTextures[0];
+
+    // Resize, then return to the original size.
+    pool.releaseRenderTarget(original, 1);
+    EXPECT_EQ(0u, original.framebuffer);
+    RenderTarget resized = pool.acquireRenderTarget(
+            { RenderTargetDesc(32, 24, GL_RGBA8) }, RenderTargetDesc(32, 24, GL_DEPTH24_STENCIL8));
+    pool.nextFrame();
+    pool.releaseRenderTarget(resized, 1);
+    pool.nextFrame();
+
+    RenderTarget restored = pool.acquireRenderTarget(colors, depth);
+    EXPECT_EQ(originalColor, restored.colorTextures[0]);
+    EXPECT_EQ(originalFramebuffer, restored.framebuffer);
+    EXPECT_EQ(4u, pool.getStats().numTexturesCreated);
+    EXPECT_EQ(2u, pool.getStats().numFramebuffers);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(RenderTargetPool_Test, test_multisampled_render_target) {
+    RenderTargetPool pool;
+    RenderTarget target = pool.acquireRenderTarget(
+            { RenderTargetDesc(16, 16, GL_RGBA8, 4) },
+            RenderTargetDesc(16, 16, GL_DEPTH_COMPONENT24, 4));
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    EXPECT_EQ(GLenum(GL_FRAMEBUFFER_COMPLETE), glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Sample count is part of the key.
+    GLuint multisampled = target.colorTextures[0];
+    pool.releaseRenderTarget(target);
+    EXPECT_NE(multisampled, pool.acquireTexture(RenderTargetDesc(16, 16, GL_RGBA8)));
+    EXPECT_EQ(16u * 16 * 4 * 4 * 2 + 16 * 16 * 4, pool.getStats().numBytes);
+}
@@ -0,0 +1,100 @@
+// ShadowSlotCache_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Graphics/ShadowSlotCache.hpp>
+using Rigid3D::ShadowSlotCache;
+
+//----------------------------------------------------------------------------------------
+TEST(ShadowSlotCache_Test, new_light_needs_update) {
+    ShadowSlotCache cache(2);
+    cache.beginFrame();
+
+    bool needsUpdate = false;
+    int slot = cache.acquire(7, 100, needsUpdate);
+
+    EXPECT_GE(slot, 0);
+    EXPECT_TRUE(needsUpdate);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ShadowSlotCache_Test, unchanged_light_is_reused_without_update) {
+    ShadowSlotCache cache(2);
+    bool needsUpdate;
+
+    cache.beginFrame();
+    int first = cache.acquire(7, 100, needsUpdate);
+
+    cache.beginFrame();
+    int second = cache.acquire(7, 100, needsUpdate);
+
+    EXPECT_EQ(first, second);
+    EXPECT_FALSE(needsUpdate);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ShadowSlotCache_Test, changed_signature_needs_update) {
+    ShadowSlotCache cache(2);
+    bool needsUpdate;
+
+    cache.beginFrame();
+    int first = cache.acquire(7, 100, needsUpdate);
+
+    cache.beginFrame();
+    int second = cache.acquire(7, 101, needsUpdate);
+
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(needsUpdate);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ShadowSlotCache_Test, least_recently_used_slot_is_evicted) {
+    ShadowSlotCache cache(2);
+    bool needsUpdate;
+
+    cache.beginFrame();
+    int slotA = cache.acquire(1, 10, needsUpdate);
+    int slotB = cache.acquire(2, 20, needsUpdate);
+
+    cache.beginFrame();
+    cache.acquire(2, 20, needsUpdate);  // Light 1 is now least recently used.
+
+    cache.beginFrame();
+    int slotC = cache.acquire(3, 30, needsUpdate);
+    EXPECT_EQ(slotA, slotC);
+    EXPECT_TRUE(needsUpdate);
+
+    // Light 2 keeps its cached slot, light 1 must be re-rendered.
+    cache.acquire(2, 20, needsUpdate);
+    EXPECT_FALSE(needsUpdate);
+
+    cache.beginFrame();
+    int slotA2 = cache.acquire(1, 10, needsUpdate);
+    EXPECT_TRUE(needsUpdate);
+    EXPECT_NE(slotB, slotA2);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ShadowSlotCache_Test, slots_in_use_this_frame_are_not_evicted) {
+    ShadowSlotCache cache(1);
+    bool needsUpdate;
+
+    cache.beginFrame();
+    EXPECT_EQ(0, cache.acquire(1, 10, needsUpdate));
+    EXPECT_EQ(-1, cache.acquire(2, 20, needsUpdate));
+    EXPECT_FALSE(needsUpdate);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ShadowSlotCache_Test, invalidate_forces_update) {
+    ShadowSlotCache cache(2);
+    bool needsUpdate;
+
+    cache.beginFrame();
+    cache.acquire(1, 10, needsUpdate);
+    cache.invalidate(1);
+
+    cache.beginFrame();
+    cache.acquire(1, 10, needsUpdate);
+    EXPECT_TRUE(needsUpdate);
+}
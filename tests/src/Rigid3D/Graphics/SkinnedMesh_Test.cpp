@@ -0,0 +1,193 @@
+// SkinnedMesh_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+#include <Rigid3D/Graphics/CpuSkinningBatch.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Graphics/SkinnedMesh.hpp>
+#include <Rigid3D/Graphics/SkinningPalette.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class SkinnedMesh_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> shader;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+
+            shader = make_shared<ShaderProgram>();
+            shader->generateProgramObject();
+            shader->attachVertexShader("../../data/shaders/SkinnedMesh.vert");
+            shader->attachFragmentShader("../../data/shaders/TestNormals.frag");
+            shader->link();
+            SkinningPalette::bindUniformBlock(*shader);
+        }
+
+        static void TearDownTestCase() {
+            shader.reset();
+            glContext.reset();
+        }
+
+        // Right triangle covering the lower left quarter of clip space, facing +z,
+        // bound entirely to joint 1.
+        static shared_ptr<Mesh> createTriangle() {
+            vector<vec3> positions = {
+                vec3(-1.0f, -1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f), vec3(-1.0f, 1.0f, 0.0f)
+            };
+            vector<vec3> normals(3, vec3(0.0f, 0.0f, 1.0f));
+            vector<vec2> textureCoords;
+            shared_ptr<Mesh> mesh = make_shared<Mesh>(std::move(positions),
+                    std::move(normals), std::move(textureCoords));
+
+            vector<uint8> boneIndices = { 1, 0, 0, 0,  1, 0, 0, 0,  1, 0, 0, 0 };
+            vector<vec4> boneWeights(3, vec4(1.0f, 0.0f, 0.0f, 0.0f));
+            mesh->setBoneWeights(std::move(boneIndices), std::move(boneWeights));
+            return mesh;
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> SkinnedMesh_Test::glContext;
+    shared_ptr<ShaderProgram> SkinnedMesh_Test::shader;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(SkinnedMesh_Test, test_mesh_without_bone_weights_throws) {
+    Mesh cube("../data/meshes/cube.obj");
+
+    EXPECT_THROW(SkinnedMesh mesh(cube), Rigid3DException);
+
+    CpuSkinningBatch batch(1024);
+    mat4 palette[1];
+    EXPECT_THROW(batch.add(cube, palette, 1), Rigid3DException);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(SkinnedMesh_Test, test_cpu_batch_rejects_bones_outside_palette) {
+    shared_ptr<Mesh> triangle = createTriangle();
+    mat4 palette[2];
+
+    // The triangle is bound to joint 1.
+    CpuSkinningBatch batch(6);
+    EXPECT_THROW(batch.add(*triangle, palette, 1), Rigid3DException);
+    EXPECT_EQ(0u, batch.getNumVertices());
+    batch.add(*triangle, palette, 2);
+    EXPECT_EQ(3u, batch.getNumVertices());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(SkinnedMesh_Test, test_cpu_batch_skins_into_one_buffer) {
+    shared_ptr<Mesh> triangle = createTriangle();
+
+    // Joint 1 moves right by one in the first palette, up by one in the second.
+    mat4 right[2] = { mat4(), glm::translate(mat4(), vec3(1.0f, 0.0f, 0.0f)) };
+    mat4 up[2] = { mat4(), glm::translate(mat4(), vec3(0.0f, 1.0f, 0.0f)) };
+
+    CpuSkinningBatch batch(6);
+    CpuSkinningBatch::Range first = batch.add(*triangle, right, 2);
+    CpuSkinningBatch::Range second = batch.add(*triangle, up, 2);
+    EXPECT_EQ(0u, first.firstVertex);
+    EXPECT_EQ(3u, second.firstVertex);
+    EXPECT_EQ(6u, batch.getNumVertices());
+    EXPECT_THROW(batch.add(*triangle, up, 2), Rigid3DException);
+
+    ThreadPool threadPool(2);
+    batch.skin(&threadPool);
+
+    vector<float> uploaded(6 * 6);
+    glBindBuffer(GL_ARRAY_BUFFER, batch.getVertexBuffer());
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, uploaded.size() * sizeof(float), uploaded.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    const float * skinned = batch.getSkinnedVertexDataPtr();
+    for (size_t i = 0; i < uploaded.size(); ++i) {
+        EXPECT_EQ(skinned[i], uploaded[i]);
+    }
+
+    // First vertex of each copy, position then normal.
+    EXPECT_FLOAT_EQ(0.0f, skinned[0]);
+    EXPECT_FLOAT_EQ(-1.0f, skinned[1]);
+    EXPECT_FLOAT_EQ(1.0f, skinned[5]);
+    EXPECT_FLOAT_EQ(-1.0f, skinned[18]);
+    EXPECT_FLOAT_EQ(0.0f, skinned[19]);
+
+    batch.clear();
+    EXPECT_EQ(0u, batch.getNumVertices());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(SkinnedMesh_Test, test_vertex_shader_reads_bound_palette_range) {
+    shared_ptr<Mesh> triangle = createTriangle();
+    SkinnedMesh skinnedMesh(*triangle);
+    EXPECT_EQ(3u, skinnedMesh.getNumVertices());
+
+    // The first character leaves the triangle in place, the second moves joint 1
+    // to the right half of the viewport.
+    mat4 still[2] = { mat4(), mat4() };
+    mat4 moved[2] = { mat4(), glm::translate(mat4(), vec3(1.0f, 0.0f, 0.0f)) };
+
+    SkinningPalette palette(64);
+    GLintptr stillOffset = palette.add(still, 2);
+    GLintptr movedOffset = palette.add(moved, 2);
+    EXPECT_EQ(0, stillOffset);
+    EXPECT_GT(movedOffset, stillOffset);
+    EXPECT_EQ(4u, palette.getNumMatrices());
+    palette.upload();
+
+    GLuint framebuffer, colorBuffer;
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 4, 4);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+            colorBuffer);
+    glViewport(0, 0, 4, 4);
+
+    shader->setUniform("ModelViewMatrix", mat4());
+    shader->setUniform("NormalMatrix", mat3());
+    shader->setUniform("ProjectionMatrix", mat4());
+
+    vector<unsigned char> pixels(4 * 4 * 4);
+    const GLintptr offsets[] = { stillOffset, movedOffset };
+    for (GLintptr offset : offsets) {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        palette.bind(offset);
+        shader->enable();
+            skinnedMesh.draw();
+        shader->disable();
+        glReadPixels(0, 0, 4, 4, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        // Bottom row, columns 0 and 2.
+        const unsigned char * leftPixel = &pixels[0];
+        const unsigned char * rightPixel = &pixels[2 * 4];
+        if (offset == stillOffset) {
+            EXPECT_EQ(255, leftPixel[2]);
+            EXPECT_EQ(0, rightPixel[3]);
+        } else {
+            EXPECT_EQ(0, leftPixel[3]);
+            EXPECT_EQ(255, rightPixel[2]);
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+}
@@ -0,0 +1,197 @@
+// StaticGeometryBuffer_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/StaticGeometryBuffer.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class StaticGeometryBuffer_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+        }
+
+        static void TearDownTestCase() {
+            glContext.reset();
+        }
+
+        // Unit square in the xy plane as a soup of two triangles sharing an edge.
+        static shared_ptr<Mesh> createQuad(float z) {
+            vector<vec3> positions = {
+                vec3(0.0f, 0.0f, z), vec3(1.0f, 0.0f, z), vec3(1.0f, 1.0f, z),
+                vec3(0.0f, 0.0f, z), vec3(1.0f, 1.0f, z), vec3(0.0f, 1.0f, z)
+            };
+            vector<vec3> normals(6, vec3(0.0f, 0.0f, 1.0f));
+            vector<vec2> textureCoords;
+            return make_shared<Mesh>(std::move(positions), std::move(normals),
+                    std::move(textureCoords));
+        }
+
+        static vector<float> readVertices(const StaticGeometryBuffer & geometry,
+                                          const StaticGeometryBuffer::Allocation & allocation) {
+            vector<float> values(allocation.vertices.size * 6);
+            glBindBuffer(GL_COPY_READ_BUFFER, geometry.getVertexBuffer());
+            glGetBufferSubData(GL_COPY_READ_BUFFER,
+                    allocation.vertices.offset * StaticGeometryBuffer::BytesPerVertex,
+                    values.size() * sizeof(float), values.data());
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            return values;
+        }
+
+        static vector<uint32> readIndices(const StaticGeometryBuffer & geometry,
+                                          const StaticGeometryBuffer::Allocation & allocation) {
+            vector<uint32> indices(allocation.indices.size);
+            glBindBuffer(GL_COPY_READ_BUFFER, geometry.getIndexBuffer());
+            glGetBufferSubData(GL_COPY_READ_BUFFER,
+                    allocation.indices.offset * sizeof(uint32),
+                    indices.size() * sizeof(uint32), indices.data());
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            return indices;
+        }
+    };
+
+}
+
+shared_ptr<OpenGLContext> StaticGeometryBuffer_Test::glContext = nullptr;
+
+//---------------------------------------------------------------------------------------
+TEST_F(StaticGeometryBuffer_Test, test_mesh_is_welded_into_indexed_batch) {
+    StaticGeometryBuffer geometry(64, 64);
+
+    StaticGeometryBuffer::Allocation quad;
+    ASSERT_TRUE(geometry.allocate(*createQuad(0.0f), quad));
+
+    // Two shared corners are merged.
+    EXPECT_EQ(4u, quad.vertices.size);
+    EXPECT_EQ(6u, quad.indices.size);
+    EXPECT_TRUE(quad.batchInfo.indexed);
+    EXPECT_EQ(6u, quad.batchInfo.numIndices);
+    EXPECT_EQ(int(quad.vertices.offset), quad.batchInfo.baseVertex);
+    EXPECT_EQ(quad.indices.offset, quad.batchInfo.startIndex);
+
+    vector<uint32> indices = readIndices(geometry, quad);
+    vector<uint32> expectedIndices = { 0, 1, 2, 0, 2, 3 };
+    EXPECT_EQ(expectedIndices, indices);
+
+    // Interleaved position and normal of the last vertex.
+    vector<float> vertices = readVertices(geometry, quad);
+    EXPECT_EQ(0.0f, vertices[18]);
+    EXPECT_EQ(1.0f, vertices[19]);
+    EXPECT_EQ(1.0f, vertices[23]);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(StaticGeometryBuffer_Test, test_meshes_share_buffers_at_distinct_ranges) {
+    StaticGeometryBuffer geometry(64, 64);
+
+    StaticGeometryBuffer::Allocation first;
+    StaticGeometryBuffer::Allocation second;
+    ASSERT_TRUE(geometry.allocate(*createQuad(1.0f), first));
+    ASSERT_TRUE(geometry.allocate(*createQuad(2.0f), second));
+
+    EXPECT_NE(first.batchInfo.baseVertex, second.batchInfo.baseVertex);
+    EXPECT_NE(first.batchInfo.startIndex, second.batchInfo.startIndex);
+
+    // Indices stay relative to each mesh's base vertex.
+    EXPECT_EQ(readIndices(geometry, first), readIndices(geometry, second));
+    EXPECT_EQ(2.0f, readVertices(geometry, second)[2]);
+
+    StaticGeometryBuffer::Stats stats = geometry.getStats();
+    EXPECT_EQ(8u, stats.vertexStats.numUnitsAllocated);
+    EXPECT_EQ(12u, stats.indexStats.numUnitsAllocated);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(StaticGeometryBuffer_Test, test_freed_ranges_are_reused) {
+    StaticGeometryBuffer geometry(8, 12);
+
+    StaticGeometryBuffer::Allocation first;
+    StaticGeometryBuffer::Allocation second;
+    StaticGeometryBuffer::Allocation third;
+    ASSERT_TRUE(geometry.allocate(*createQuad(1.0f), first));
+    ASSERT_TRUE(geometry.allocate(*createQuad(2.0f), second));
+
+    // Full, until a mesh is freed.
+    EXPECT_FALSE(geometry.allocate(*createQuad(3.0f), third));
+    EXPECT_EQ(2u, geometry.getStats().indexStats.numAllocations);
+
+    const int baseVertex = first.batchInfo.baseVertex;
+    geometry.free(first);
+    EXPECT_EQ(0u, first.batchInfo.numIndices);
+
+    ASSERT_TRUE(geometry.allocate(*createQuad(3.0f), third));
+    EXPECT_EQ(baseVertex, third.batchInfo.baseVertex);
+    EXPECT_EQ(3.0f, readVertices(geometry, third)[2]);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(StaticGeometryBuffer_Test, test_identical_meshes_share_ranges) {
+    StaticGeometryBuffer geometry(64, 64);
+
+    StaticGeometryBuffer::Allocation first;
+    StaticGeometryBuffer::Allocation second;
+    ASSERT_TRUE(geometry.allocate(*createQuad(1.0f), first));
+    ASSERT_TRUE(geometry.allocate(*createQuad(1.0f), second));
+
+    EXPECT_EQ(first.batchInfo.baseVertex, second.batchInfo.baseVertex);
+    EXPECT_EQ(first.batchInfo.startIndex, second.batchInfo.startIndex);
+
+    StaticGeometryBuffer::Stats stats = geometry.getStats();
+    EXPECT_EQ(1u, stats.numSharedRanges);
+    EXPECT_EQ(1u, stats.numSharedReferences);
+    EXPECT_EQ(4u, stats.vertexStats.numUnitsAllocated);
+
+    // Ranges are released with the last reference.
+    geometry.free(first);
+    EXPECT_EQ(4u, geometry.getStats().vertexStats.numUnitsAllocated);
+    geometry.free(second);
+    EXPECT_EQ(0u, geometry.getStats().vertexStats.numUnitsAllocated);
+    EXPECT_EQ(0u, geometry.getStats().numSharedRanges);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(StaticGeometryBuffer_Test, test_freeing_shared_reference_twice_keeps_ranges) {
+    StaticGeometryBuffer geometry(64, 64);
+
+    StaticGeometryBuffer::Allocation first;
+    StaticGeometryBuffer::Allocation second;
+    ASSERT_TRUE(geometry.allocate(*createQuad(1.0f), first));
+    ASSERT_TRUE(geometry.allocate(*createQuad(1.0f), second));
+
+    geometry.free(first);
+    EXPECT_EQ(TlsfAllocator::InvalidBlock, first.vertices.block);
+    EXPECT_EQ(TlsfAllocator::InvalidBlock, first.indices.block);
+
+    // The second free is of an empty allocation, the ranges stay with 'second'.
+    geometry.free(first);
+    EXPECT_EQ(4u, geometry.getStats().vertexStats.numUnitsAllocated);
+    EXPECT_EQ(1u, geometry.getStats().numSharedRanges);
+
+    geometry.free(second);
+    EXPECT_EQ(0u, geometry.getStats().vertexStats.numUnitsAllocated);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(StaticGeometryBuffer_Test, test_out_of_range_index_throws) {
+    StaticGeometryBuffer geometry(16, 16);
+    vector<vec3> positions(3, vec3(0.0f));
+    vector<uint32> indices = { 0, 1, 3 };
+
+    StaticGeometryBuffer::Allocation allocation;
+    EXPECT_THROW(geometry.allocate(positions.data(), NULL, 3, indices.data(), 3, allocation),
+            Rigid3DException);
+    EXPECT_EQ(0u, geometry.getStats().vertexStats.numAllocations);
+}
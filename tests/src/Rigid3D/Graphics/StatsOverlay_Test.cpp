@@ -0,0 +1,58 @@
+// StatsOverlay_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/StatsOverlay.hpp>
+using namespace Rigid3D;
+
+#include <string>
+using namespace std;
+
+//---------------------------------------------------------------------------------------
+TEST(StatsOverlay_Test, test_frame_times_summarize_recent_frames) {
+    StatsOverlay overlay(4);
+    EXPECT_EQ(0u, overlay.getFrameTimes().numSamples);
+
+    overlay.addFrame(100.0, 1, 0);
+    overlay.addFrame(10.0, 1, 0);
+    overlay.addFrame(20.0, 1, 0);
+    overlay.addFrame(30.0, 1, 0);
+
+    StatsOverlay::Summary summary = overlay.getFrameTimes();
+    EXPECT_EQ(4u, summary.numSamples);
+    EXPECT_DOUBLE_EQ(40.0, summary.average);
+    EXPECT_DOUBLE_EQ(10.0, summary.minimum);
+    EXPECT_DOUBLE_EQ(100.0, summary.maximum);
+
+    // Replaces the oldest frame.
+    overlay.addFrame(40.0, 7, 1024);
+    summary = overlay.getFrameTimes();
+    EXPECT_EQ(4u, summary.numSamples);
+    EXPECT_DOUBLE_EQ(25.0, summary.average);
+    EXPECT_DOUBLE_EQ(40.0, summary.maximum);
+
+    EXPECT_EQ(7u, overlay.getNumDrawCalls());
+    EXPECT_EQ(1024u, overlay.getMemoryBytes());
+
+    EXPECT_THROW(StatsOverlay(0), Rigid3DException);
+}
+
+//---------------------------------------------------------------------------------------
+TEST(StatsOverlay_Test, test_format_text) {
+    StatsOverlay overlay;
+    overlay.addFrame(20.0, 1234, 512ull * 1024 * 1024);
+
+    string text = overlay.formatText();
+    EXPECT_NE(string::npos, text.find("20.00 ms"));
+    EXPECT_NE(string::npos, text.find("50.0 fps"));
+    EXPECT_NE(string::npos, text.find("gpu       n/a"));
+    EXPECT_NE(string::npos, text.find("draws  1234"));
+    EXPECT_NE(string::npos, text.find("memory 512.0 MiB"));
+
+    overlay.addGpuTime(2.0);
+    overlay.addGpuTime(4.0);
+    text = overlay.formatText();
+    EXPECT_NE(string::npos, text.find("gpu      3.00 ms"));
+    EXPECT_EQ(2u, overlay.getGpuTimes().numSamples);
+}
@@ -0,0 +1,166 @@
+// TextRenderer_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Graphics/GlyphAtlas.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Graphics/TextRenderer.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class TextRenderer_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> shader;
+        static shared_ptr<GlyphAtlas> atlas;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+
+            shader = make_shared<ShaderProgram>();
+            shader->generateProgramObject();
+            shader->attachVertexShader("../../data/shaders/Text.vert");
+            shader->attachFragmentShader("../../data/shaders/Text.frag");
+            shader->link();
+
+            atlas = make_shared<GlyphAtlas>("../../data/fonts/DroidSansMono.ttf", 24);
+        }
+
+        static void TearDownTestCase() {
+            atlas.reset();
+            shader.reset();
+            glContext.reset();
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> TextRenderer_Test::glContext;
+    shared_ptr<ShaderProgram> TextRenderer_Test::shader;
+    shared_ptr<GlyphAtlas> TextRenderer_Test::atlas;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(TextRenderer_Test, test_one_quad_per_visible_glyph) {
+    TextRenderer textRenderer(*shader, *atlas, 16);
+
+    textRenderer.beginFrame();
+    EXPECT_EQ(7u, textRenderer.addText("Hi there", vec2(0.0f)));
+    EXPECT_EQ(4u, textRenderer.addText("ab\ncd", vec2(0.0f, 100.0f)));
+    // UTF-8, two bytes each.
+    EXPECT_EQ(2u, textRenderer.addText("\xC3\xA9\xC3\xA8", vec2(0.0f)));
+    EXPECT_EQ(13u, textRenderer.getNumGlyphs());
+
+    // The arena is full after three more.
+    EXPECT_EQ(3u, textRenderer.addText("0123456789", vec2(0.0f)));
+    EXPECT_EQ(16u, textRenderer.getNumGlyphs());
+
+    textRenderer.beginFrame();
+    EXPECT_EQ(0u, textRenderer.getNumGlyphs());
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(TextRenderer_Test, test_all_text_drawn_at_its_position) {
+    TextRenderer textRenderer(*shader, *atlas, 64);
+
+    const int width = 64;
+    const int height = 64;
+    GLuint framebuffer, colorBuffer;
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+            colorBuffer);
+    glViewport(0, 0, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // The caller's active unit, and the bindings of it and of unit 0, are kept.
+    GLuint callerTextures[2];
+    glGenTextures(2, callerTextures);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, callerTextures[0]);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, callerTextures[1]);
+
+    // Green in the top half of the viewport, red in the bottom half.
+    textRenderer.beginFrame();
+    textRenderer.addText("##", vec2(0.0f, 0.0f), vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    textRenderer.addText("##", vec2(0.0f, 32.0f), vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    textRenderer.draw(width, height);
+    EXPECT_FALSE(glIsEnabled(GL_BLEND));
+
+    GLint activeTexture, binding;
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+    EXPECT_EQ(GL_TEXTURE3, activeTexture);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &binding);
+    EXPECT_EQ(GLint(callerTextures[1]), binding);
+    glActiveTexture(GL_TEXTURE0);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &binding);
+    EXPECT_EQ(GLint(callerTextures[0]), binding);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDeleteTextures(2, callerTextures);
+
+    vector<unsigned char> pixels(width * height * 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    // glReadPixels rows start at the bottom of the viewport.
+    int numGreen = 0;
+    int numRed = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const unsigned char * pixel = &pixels[(y * width + x) * 4];
+            const bool top = y >= height / 2;
+            if (pixel[1] > 128) {
+                ++numGreen;
+                EXPECT_TRUE(top);
+            }
+            if (pixel[0] > 128) {
+                ++numRed;
+                EXPECT_FALSE(top);
+            }
+        }
+    }
+    EXPECT_GT(numGreen, 20);
+    EXPECT_GT(numRed, 20);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(TextRenderer_Test, test_renderers_sharing_an_atlas_keep_each_others_glyphs) {
+    GlyphAtlas smallAtlas("../../data/fonts/DroidSansMono.ttf", 16, 64, 64);
+    TextRenderer first(*shader, smallAtlas, 64);
+    TextRenderer second(*shader, smallAtlas, 64);
+
+    string text;
+    for (uint32 i = 0; i < smallAtlas.getCapacity(); ++i) {
+        text += char('A' + i);
+    }
+
+    // The first renderer fills the atlas.  Beginning the second renderer's frame
+    // must not let it replace those glyphs before the first one draws.
+    smallAtlas.beginFrame();
+    first.beginFrame();
+    EXPECT_EQ(smallAtlas.getCapacity(), first.addText(text.c_str(), vec2(0.0f)));
+    second.beginFrame();
+    EXPECT_EQ(0u, second.addText("a", vec2(0.0f)));
+    EXPECT_EQ(smallAtlas.getCapacity(), smallAtlas.getNumRasterized());
+
+    smallAtlas.beginFrame();
+    second.beginFrame();
+    EXPECT_EQ(1u, second.addText("a", vec2(0.0f)));
+}
@@ -0,0 +1,148 @@
+// VertexAnimation_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/ShaderProgram.hpp>
+#include <Rigid3D/Graphics/VertexAnimation.hpp>
+#include "OpenGLContext.hpp"
+using namespace Rigid3D;
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace {  // limit class visibility to this file.
+
+    class VertexAnimation_Test : public ::testing::Test {
+    protected:
+        static shared_ptr<OpenGLContext> glContext;
+        static shared_ptr<ShaderProgram> shader;
+
+        // Code here will be ran once before all tests.
+        static void SetUpTestCase() {
+            glContext = make_shared<OpenGLContext>(4, 1);
+            glContext->init();
+
+            shader = make_shared<ShaderProgram>();
+            shader->generateProgramObject();
+            shader->attachVertexShader("../../data/shaders/VertexAnimation.vert");
+            shader->attachFragmentShader("../../data/shaders/TestNormals.frag");
+            shader->link();
+        }
+
+        static void TearDownTestCase() {
+            shader.reset();
+            glContext.reset();
+        }
+
+        // Right triangle covering the lower left half of the clip space square
+        // [x, x + 1] x [-1, 1], all normals equal to 'normal'.
+        static shared_ptr<Mesh> createTriangle(float x, const vec3 & normal) {
+            vector<vec3> positions = {
+                vec3(x, -1.0f, 0.0f), vec3(x + 1.0f, -1.0f, 0.0f), vec3(x, 1.0f, 0.0f)
+            };
+            vector<vec3> normals(3, normal);
+            vector<vec2> textureCoords;
+            return make_shared<Mesh>(std::move(positions), std::move(normals),
+                    std::move(textureCoords));
+        }
+    };
+
+    // Define static class variables.
+    shared_ptr<OpenGLContext> VertexAnimation_Test::glContext;
+    shared_ptr<ShaderProgram> VertexAnimation_Test::shader;
+
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(VertexAnimation_Test, test_keyframes_are_sampled_by_time) {
+    shared_ptr<Mesh> a = createTriangle(-1.0f, vec3(0.0f, 0.0f, 1.0f));
+    shared_ptr<Mesh> b = createTriangle(-0.5f, vec3(0.0f, 0.0f, 1.0f));
+    shared_ptr<Mesh> c = createTriangle(0.0f, vec3(0.0f, 0.0f, 1.0f));
+    vector<const Mesh *> frames = { a.get(), b.get(), c.get() };
+    VertexAnimation animation(frames, 2.0f);
+
+    EXPECT_EQ(3u, animation.getNumFrames());
+    EXPECT_EQ(3u, animation.getNumVertices());
+    EXPECT_FLOAT_EQ(1.5f, animation.getDuration());
+    EXPECT_EQ(3u * 3u * 8u, animation.getNumKeyframeBytes());
+
+    uint32 frameA, frameB;
+    float blend;
+    animation.sampleKeyframes(0.75f, true, frameA, frameB, blend);
+    EXPECT_EQ(1u, frameA);
+    EXPECT_EQ(2u, frameB);
+    EXPECT_FLOAT_EQ(0.5f, blend);
+
+    // Wraps from the last frame back to the first.
+    animation.sampleKeyframes(1.25f + 1.5f, true, frameA, frameB, blend);
+    EXPECT_EQ(2u, frameA);
+    EXPECT_EQ(0u, frameB);
+    EXPECT_NEAR(0.5f, blend, 1.0e-5f);
+
+    // Holds the last frame.
+    animation.sampleKeyframes(10.0f, false, frameA, frameB, blend);
+    EXPECT_EQ(2u, frameA);
+    EXPECT_EQ(2u, frameB);
+    EXPECT_FLOAT_EQ(0.0f, blend);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(VertexAnimation_Test, test_mismatched_topology_throws) {
+    shared_ptr<Mesh> triangle = createTriangle(0.0f, vec3(0.0f, 0.0f, 1.0f));
+    Mesh cube("../data/meshes/cube.obj");
+
+    vector<const Mesh *> frames = { triangle.get(), &cube };
+    EXPECT_THROW(VertexAnimation(frames, 30.0f), Rigid3DException);
+    EXPECT_THROW(VertexAnimation(vector<const Mesh *>(), 30.0f), Rigid3DException);
+}
+
+//---------------------------------------------------------------------------------------
+TEST_F(VertexAnimation_Test, test_vertex_shader_blends_positions_and_normals) {
+    // Moves from the left half of the viewport facing +z to the right half facing +x.
+    shared_ptr<Mesh> left = createTriangle(-1.0f, vec3(0.0f, 0.0f, 1.0f));
+    shared_ptr<Mesh> right = createTriangle(0.0f, vec3(1.0f, 0.0f, 0.0f));
+    vector<const Mesh *> frames = { left.get(), right.get() };
+    VertexAnimation animation(frames, 1.0f);
+
+    GLuint framebuffer, colorBuffer;
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 4, 4);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+            colorBuffer);
+    glViewport(0, 0, 4, 4);
+
+    shader->setUniform("ModelViewMatrix", mat4());
+    shader->setUniform("NormalMatrix", mat3());
+    shader->setUniform("ProjectionMatrix", mat4());
+
+    vector<unsigned char> pixels(4 * 4 * 4);
+    const float times[] = { 0.0f, 1.0f };
+    for (float time : times) {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        animation.render(*shader, time, false);
+        glReadPixels(0, 0, 4, 4, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        // Bottom row, columns 0 and 2.
+        const unsigned char * leftPixel = &pixels[0];
+        const unsigned char * rightPixel = &pixels[2 * 4];
+        if (time == 0.0f) {
+            EXPECT_EQ(255, leftPixel[2]);
+            EXPECT_EQ(0, rightPixel[3]);
+        } else {
+            EXPECT_EQ(0, leftPixel[3]);
+            EXPECT_EQ(255, rightPixel[0]);
+            EXPECT_EQ(0, rightPixel[2]);
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &colorBuffer);
+}
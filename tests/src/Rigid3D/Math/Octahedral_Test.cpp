@@ -0,0 +1,60 @@
+// Octahedral_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Math/Octahedral.hpp>
+using Rigid3D::octahedralEncode;
+using Rigid3D::octahedralDecode;
+using Rigid3D::vec2;
+using Rigid3D::vec3;
+
+#include <cmath>
+
+namespace {  // limit class visibility to this file.
+
+    const float tolerance = 1e-5f;
+
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Octahedral_Test, decode_inverts_encode) {
+    const vec3 directions[] = {
+        vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f),
+        vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f),
+        vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f),
+        glm::normalize(vec3(1.0f, 2.0f, 3.0f)),
+        glm::normalize(vec3(-3.0f, 1.0f, -2.0f)),
+        glm::normalize(vec3(0.5f, -4.0f, -1.0f))
+    };
+
+    for (const vec3 & d : directions) {
+        vec3 result = octahedralDecode(octahedralEncode(d));
+        EXPECT_NEAR(d.x, result.x, tolerance);
+        EXPECT_NEAR(d.y, result.y, tolerance);
+        EXPECT_NEAR(d.z, result.z, tolerance);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Octahedral_Test, encode_maps_into_unit_square) {
+    for (int i = 0; i < 100; ++i) {
+        float theta = 0.37f * float(i);
+        float phi = 0.11f * float(i);
+        vec3 d(std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi));
+
+        vec2 uv = octahedralEncode(d);
+        EXPECT_GE(uv.x, 0.0f);
+        EXPECT_LE(uv.x, 1.0f);
+        EXPECT_GE(uv.y, 0.0f);
+        EXPECT_LE(uv.y, 1.0f);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST(Octahedral_Test, center_maps_to_positive_z) {
+    vec3 d = octahedralDecode(vec2(0.5f, 0.5f));
+    EXPECT_NEAR(1.0f, d.z, tolerance);
+
+    vec3 corner = octahedralDecode(vec2(0.0f, 0.0f));
+    EXPECT_NEAR(-1.0f, corner.z, tolerance);
+}
@@ -0,0 +1,170 @@
+// ParticleEmitter_Test.cpp
+
+#include "gtest/gtest.h"
+
+#include <Rigid3D/Common/Rigid3DException.hpp>
+#include <Rigid3D/Common/ThreadPool.hpp>
+#include <Rigid3D/Particles/ParticleEmitter.hpp>
+using namespace Rigid3D;
+
+#include <cstring>
+#include <memory>
+#include <vector>
+using namespace std;
+
+//----------------------------------------------------------------------------------------
+TEST(ParticleEmitter_Test, emission_rate_accumulates_across_updates) {
+    ParticleEmitter::Params params;
+    params.emissionRate = 10.0f;
+    params.lifetime = 100.0f;
+    ParticleEmitter emitter(1000, params);
+
+    // 0.25 particles per update, so one every fourth update.
+    for (int i = 0; i < 8; ++i) {
+        emitter.update(0.025f);
+    }
+    EXPECT_EQ(2u, emitter.getNumParticles());
+
+    // Bursts stop at capacity.
+    EXPECT_EQ(998u, emitter.emit(5000));
+    EXPECT_EQ(1000u, emitter.getNumParticles());
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ParticleEmitter_Test, particles_fall_under_acceleration) {
+    ParticleEmitter::Params params;
+    params.velocity = vec3(1.0f, 0.0f, 0.0f);
+    params.acceleration = vec3(0.0f, -10.0f, 0.0f);
+    params.lifetime = 10.0f;
+    ParticleEmitter emitter(7, params);
+    emitter.emit(7);
+
+    emitter.update(0.5f);
+
+    // Semi-implicit Euler: velocity first, then position.
+    for (uint32 i = 0; i < 7; ++i) {
+        vec3 position = emitter.getPosition(i);
+        EXPECT_FLOAT_EQ(0.5f, position.x);
+        EXPECT_FLOAT_EQ(-2.5f, position.y);
+        EXPECT_FLOAT_EQ(-5.0f, emitter.getComponentArray(ParticleEmitter::VelocityY)[i]);
+        EXPECT_FLOAT_EQ(9.5f, emitter.getComponentArray(ParticleEmitter::Life)[i]);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ParticleEmitter_Test, expired_particles_are_removed_in_order) {
+    ParticleEmitter::Params params;
+    params.velocity = vec3(0.0f);
+    params.lifetime = 1.0f;
+    ParticleEmitter emitter(16, params);
+
+    // Ten particles that expire, interleaved with short lived ones by position.
+    for (int i = 0; i < 10; ++i) {
+        params.position = vec3(float(i), 0.0f, 0.0f);
+        params.lifetime = (i % 3 == 0) ? 0.1f : 1.0f;
+        emitter.setParams(params);
+        emitter.emit(1);
+    }
+
+    emitter.update(0.5f);
+
+    const float expected[] = { 1.0f, 2.0f, 4.0f, 5.0f, 7.0f, 8.0f };
+    ASSERT_EQ(6u, emitter.getNumParticles());
+    for (uint32 i = 0; i < 6; ++i) {
+        EXPECT_EQ(expected[i], emitter.getPosition(i).x);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ParticleEmitter_Test, particles_bounce_off_planes_and_spheres) {
+    ParticleEmitter::Params params;
+    params.lifetime = 10.0f;
+    params.restitution = 0.5f;
+
+    // Falling onto the ground plane y = 0.
+    params.position = vec3(0.0f, 0.1f, 0.0f);
+    params.velocity = vec3(0.0f, -1.0f, 0.0f);
+    ParticleEmitter ground(4, params);
+    ground.addCollisionPlane(vec4(0.0f, 2.0f, 0.0f, 0.0f));
+    ground.emit(1);
+    ground.update(0.2f);
+
+    EXPECT_NEAR(0.0f, ground.getPosition(0).y, 1.0e-6f);
+    EXPECT_FLOAT_EQ(0.5f, ground.getComponentArray(ParticleEmitter::VelocityY)[0]);
+
+    // Moving into a unit sphere at the origin along -x.
+    params.position = vec3(1.1f, 0.0f, 0.0f);
+    params.velocity = vec3(-1.0f, 0.0f, 0.0f);
+    ParticleEmitter ball(4, params);
+    ball.addCollisionSphere(vec3(0.0f), 1.0f);
+    ball.emit(1);
+    ball.update(0.2f);
+
+    EXPECT_NEAR(1.0f, ball.getPosition(0).x, 1.0e-6f);
+    EXPECT_FLOAT_EQ(0.5f, ball.getComponentArray(ParticleEmitter::VelocityX)[0]);
+
+    EXPECT_THROW(ball.addCollisionPlane(vec4(0.0f, 0.0f, 0.0f, 1.0f)), Rigid3DException);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ParticleEmitter_Test, instances_are_packed_position_then_color) {
+    ParticleEmitter::Params params;
+    params.color = vec4(1.0f, 0.0f, 0.0f, 1.0f);
+    ParticleEmitter emitter(8, params);
+    for (int i = 0; i < 6; ++i) {
+        params.position = vec3(float(i), 2.0f * float(i), 3.0f * float(i));
+        emitter.setParams(params);
+        emitter.emit(1);
+    }
+
+    vector<float> instances(8 * 4, -1.0f);
+    EXPECT_EQ(5u, emitter.writeInstances(instances.data(), 5));
+
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(float(i), instances[i * 4]);
+        EXPECT_EQ(2.0f * float(i), instances[i * 4 + 1]);
+        EXPECT_EQ(3.0f * float(i), instances[i * 4 + 2]);
+        uint32 color;
+        memcpy(&color, &instances[i * 4 + 3], sizeof(color));
+        EXPECT_EQ(0xFF0000FFu, color);
+    }
+    EXPECT_EQ(-1.0f, instances[5 * 4]);
+}
+
+//----------------------------------------------------------------------------------------
+TEST(ParticleEmitter_Test, parallel_update_matches_serial) {
+    ParticleEmitter::Params params;
+    params.emissionRate = 20000.0f;
+    params.velocitySpread = vec3(1.0f);
+    params.acceleration = vec3(0.0f, -9.8f, 0.0f);
+    params.lifetime = 0.5f;
+    params.lifetimeSpread = 0.4f;
+
+    vector<unique_ptr<ParticleEmitter>> serial;
+    vector<unique_ptr<ParticleEmitter>> parallel;
+    vector<ParticleEmitter *> serialEmitters;
+    vector<ParticleEmitter *> parallelEmitters;
+    for (uint32 i = 0; i < 8; ++i) {
+        serial.emplace_back(new ParticleEmitter(10000, params, i + 1));
+        parallel.emplace_back(new ParticleEmitter(10000, params, i + 1));
+        serial.back()->addCollisionPlane(vec4(0.0f, 1.0f, 0.0f, 0.5f));
+        parallel.back()->addCollisionPlane(vec4(0.0f, 1.0f, 0.0f, 0.5f));
+        serialEmitters.push_back(serial.back().get());
+        parallelEmitters.push_back(parallel.back().get());
+    }
+
+    ThreadPool threadPool(4);
+    for (int frame = 0; frame < 30; ++frame) {
+        ParticleEmitter::updateAll(serialEmitters, 1.0f / 60.0f);
+        ParticleEmitter::updateAll(parallelEmitters, 1.0f / 60.0f, &threadPool);
+    }
+
+    for (size_t e = 0; e < serial.size(); ++e) {
+        ASSERT_EQ(serial[e]->getNumParticles(), parallel[e]->getNumParticles());
+        EXPECT_GT(serial[e]->getNumParticles(), 0u);
+        for (uint32 i = 0; i < serial[e]->getNumParticles(); ++i) {
+            ASSERT_EQ(serial[e]->getPosition(i), parallel[e]->getPosition(i));
+            ASSERT_GE(serial[e]->getPosition(i).y, -0.5f);
+        }
+    }
+}
@@ -44,3 +44,45 @@ SetupTest("GlmOutStream_Test", "src/Rigid3D/Graphics/GlmOutStream_Test.cpp")
 SetupTest("Camera_Test", "src/Rigid3D/Graphics/Camera_Test.cpp")
 SetupTest("TestUtils_Predicates_Test", "src/Utils/TestUtils_Predicates_Test.cpp")
 SetupTest("AABB_Test", "src/Rigid3D/Collision/AABB_Test.cpp")
+SetupTest("OccluderGenerator_Test", "src/Rigid3D/Graphics/OccluderGenerator_Test.cpp")
+SetupTest("CookedMesh_Test", "src/Rigid3D/Graphics/CookedMesh_Test.cpp")
+SetupTest("Octahedral_Test", "src/Rigid3D/Math/Octahedral_Test.cpp")
+SetupTest("ImpostorAtlas_Test", "src/Rigid3D/Graphics/ImpostorAtlas_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("FrustumPlanes_Test", "src/Rigid3D/Collision/FrustumPlanes_Test.cpp")
+SetupTest("ShadowSlotCache_Test", "src/Rigid3D/Graphics/ShadowSlotCache_Test.cpp")
+SetupTest("PointLightShadowAtlas_Test", "src/Rigid3D/Graphics/PointLightShadowAtlas_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("ThreadPool_Test", "src/Rigid3D/Common/ThreadPool_Test.cpp")
+SetupTest("MultiViewRenderer_Test", "src/Rigid3D/Graphics/MultiViewRenderer_Test.cpp")
+SetupTest("GpuCuller_Test", "src/Rigid3D/Graphics/GpuCuller_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("TripleBuffer_Test", "src/Rigid3D/Common/TripleBuffer_Test.cpp")
+SetupTest("FramePipeline_Test", "src/Rigid3D/Graphics/FramePipeline_Test.cpp")
+SetupTest("CommandList_Test", "src/Rigid3D/Graphics/CommandList_Test.cpp")
+SetupTest("CommandRecorder_Test", "src/Rigid3D/Graphics/CommandRecorder_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("AsyncUploader_Test", "src/Rigid3D/Graphics/AsyncUploader_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("FrameCapture_Test", "src/Rigid3D/Graphics/FrameCapture_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("ObjectIdPicker_Test", "src/Rigid3D/Graphics/ObjectIdPicker_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("RayPicking_Test", "src/Rigid3D/Graphics/RayPicking_Test.cpp")
+SetupTest("RenderTargetPool_Test", "src/Rigid3D/Graphics/RenderTargetPool_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("FrameGraph_Test", "src/Rigid3D/Graphics/FrameGraph_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("DynamicResolution_Test", "src/Rigid3D/Graphics/DynamicResolution_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("TlsfAllocator_Test", "src/Rigid3D/Common/TlsfAllocator_Test.cpp")
+SetupTest("StaticGeometryBuffer_Test", "src/Rigid3D/Graphics/StaticGeometryBuffer_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("MaterialLibrary_Test", "src/Rigid3D/Graphics/MaterialLibrary_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("MultiDrawBatch_Test", "src/Rigid3D/Graphics/MultiDrawBatch_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("Lz4_Test", "src/Rigid3D/Common/Lz4_Test.cpp")
+SetupTest("AssetPack_Test", "src/Rigid3D/Common/AssetPack_Test.cpp")
+SetupTest("BlockCompression_Test", "src/Rigid3D/Common/BlockCompression_Test.cpp")
+SetupTest("CookedTexture_Test", "src/Rigid3D/Graphics/CookedTexture_Test.cpp")
+SetupTest("MeshCodec_Test", "src/Rigid3D/Graphics/MeshCodec_Test.cpp")
+SetupTest("ContentHash_Test", "src/Rigid3D/Common/ContentHash_Test.cpp")
+SetupTest("VirtualFileSystem_Test", "src/Rigid3D/Common/VirtualFileSystem_Test.cpp")
+SetupTest("VertexAnimation_Test", "src/Rigid3D/Graphics/VertexAnimation_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("LocalPose_Test", "src/Rigid3D/Animation/LocalPose_Test.cpp")
+SetupTest("Skeleton_Test", "src/Rigid3D/Animation/Skeleton_Test.cpp")
+SetupTest("SkinnedMesh_Test", "src/Rigid3D/Graphics/SkinnedMesh_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("ParticleEmitter_Test", "src/Rigid3D/Particles/ParticleEmitter_Test.cpp")
+SetupTest("ParticleRenderer_Test", "src/Rigid3D/Graphics/ParticleRenderer_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("GpuParticleEmitter_Test", "src/Rigid3D/Graphics/GpuParticleEmitter_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("GlyphAtlas_Test", "src/Rigid3D/Graphics/GlyphAtlas_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("TextRenderer_Test", "src/Rigid3D/Graphics/TextRenderer_Test.cpp", "../src/Rigid3D/Graphics/OpenGLContext.cpp")
+SetupTest("StatsOverlay_Test", "src/Rigid3D/Graphics/StatsOverlay_Test.cpp")
@@ -0,0 +1,99 @@
+/**
+ * @brief AssetPacker
+ *
+ * Command line tool that packs every file below a directory, such as data/, into a
+ * single asset pack.  Paths within the pack are relative to that directory.
+ *
+ * Usage:
+ * \code
+ * AssetPacker <inputDirectory> <output.pack> [--compress]
+ * \endcode
+ *
+ * With --compress each file is stored LZ4 compressed if that shrinks it by at
+ * least an eighth.  Hidden files and directories are skipped.
+ */
+
+#include <Rigid3D/Common/AssetPackWriter.hpp>
+using namespace Rigid3D;
+
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+//---------------------------------------------------------------------------------------
+// Appends the paths of all regular files below 'directory', relative to it.
+static void listFiles(const string & root, const string & directory,
+                      std::vector<string> & files) {
+    const string directoryPath = directory.empty() ? root : root + "/" + directory;
+    DIR * dir = opendir(directoryPath.c_str());
+    if (dir == NULL) {
+        cerr << "Unable to read directory " << directoryPath << endl;
+        return;
+    }
+
+    while (dirent * entry = readdir(dir)) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        const string path = directory.empty() ? entry->d_name
+                                              : directory + "/" + entry->d_name;
+        struct stat fileStatus;
+        if (stat((root + "/" + path).c_str(), &fileStatus) != 0) {
+            continue;
+        }
+
+        if (S_ISDIR(fileStatus.st_mode)) {
+            listFiles(root, path, files);
+        } else if (S_ISREG(fileStatus.st_mode)) {
+            files.push_back(path);
+        }
+    }
+    closedir(dir);
+}
+
+//---------------------------------------------------------------------------------------
+int main(int argc, char ** argv) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <inputDirectory> <output.pack> [--compress]"
+             << endl;
+        return 1;
+    }
+
+    const string root = argv[1];
+    const bool compress = (argc > 3) && std::strcmp(argv[3], "--compress") == 0;
+
+    try {
+        std::vector<string> files;
+        listFiles(root, "", files);
+
+        AssetPackWriter writer;
+        size_t numCompressed = 0;
+        for (const string & path : files) {
+            if (writer.addFile(path.c_str(), (root + "/" + path).c_str(), compress)) {
+                ++numCompressed;
+            }
+        }
+
+        writer.write(argv[2]);
+
+        cout << argv[2] << ": " << writer.getNumEntries() << " files ("
+             << numCompressed << " compressed), " << writer.getSize() << " bytes stored in "
+             << writer.getStoredSize() << endl;
+
+    } catch (const std::exception & e) {
+        cerr << "Exception Thrown: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
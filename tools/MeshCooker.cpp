@@ -0,0 +1,72 @@
+/**
+ * @brief MeshCooker
+ *
+ * Command line tool that converts a Wavefront .obj file into a cooked mesh file,
+ * generating a conservative inner occluder along the way.
+ *
+ * Usage:
+ * \code
+ * MeshCooker <input.obj> <output.mesh> [resolution] [maxBoxes] [erosionSteps]
+ *            [--compress] [--encode]
+ * \endcode
+ *
+ * With --compress every chunk is stored as a block compressed stream, which loads
+ * with parallel decompression.  With --encode vertex data is stored by
+ * \c MeshCodec, quantized and several times smaller.
+ */
+
+#include <Rigid3D/Graphics/CookedMesh.hpp>
+#include <Rigid3D/Graphics/Mesh.hpp>
+#include <Rigid3D/Graphics/OccluderGenerator.hpp>
+using namespace Rigid3D;
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+//---------------------------------------------------------------------------------------
+int main(int argc, char ** argv) {
+    uint32 flags = 0;
+    while (argc > 3 && std::strncmp(argv[argc - 1], "--", 2) == 0) {
+        if (std::strcmp(argv[argc - 1], "--compress") == 0) {
+            flags |= CookedMesh::CompressedChunks;
+        } else if (std::strcmp(argv[argc - 1], "--encode") == 0) {
+            flags |= CookedMesh::EncodedVertices;
+        }
+        --argc;
+    }
+
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <input.obj> <output.mesh>"
+             << " [resolution] [maxBoxes] [erosionSteps] [--compress] [--encode]" << endl;
+        return 1;
+    }
+
+    OccluderSettings settings;
+    if (argc > 3) { settings.resolution = (unsigned int)std::atoi(argv[3]); }
+    if (argc > 4) { settings.maxBoxes = (unsigned int)std::atoi(argv[4]); }
+    if (argc > 5) { settings.erosionSteps = (unsigned int)std::atoi(argv[5]); }
+
+    try {
+        Mesh mesh(argv[1]);
+
+        Occluder occluder;
+        OccluderGenerator::generate(mesh, settings, occluder);
+
+        CookedMesh::write(argv[2], mesh, occluder, flags);
+
+        cout << argv[1] << ": " << mesh.getNumVertexPositions() / 3 << " triangles, occluder "
+             << occluder.boxes.size() << " boxes / " << occluder.getNumTriangles()
+             << " triangles" << endl;
+
+    } catch (const std::exception & e) {
+        cerr << "Exception Thrown: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
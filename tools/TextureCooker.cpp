@@ -0,0 +1,68 @@
+/**
+ * @brief TextureCooker
+ *
+ * Command line tool that converts a PNG image into a cooked texture file, with
+ * rows flipped bottom first so the pixels upload to OpenGL as they are.
+ *
+ * Usage:
+ * \code
+ * TextureCooker <input.png> <output.tex> [--compress]
+ * \endcode
+ *
+ * With --compress the pixels are stored as a block compressed stream, which loads
+ * with parallel decompression.
+ */
+
+#include <Rigid3D/Graphics/CookedTexture.hpp>
+using namespace Rigid3D;
+
+#include <LoadPNG/lodepng.h>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <vector>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+//---------------------------------------------------------------------------------------
+int main(int argc, char ** argv) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <input.png> <output.tex> [--compress]" << endl;
+        return 1;
+    }
+
+    const bool compress = (argc > 3) && std::strcmp(argv[3], "--compress") == 0;
+
+    std::vector<unsigned char> pixels;
+    unsigned width;
+    unsigned height;
+    unsigned error = lodepng::decode(pixels, width, height, argv[1]);
+    if (error) {
+        cerr << "Unable to decode " << argv[1] << ": " << lodepng_error_text(error) << endl;
+        return 1;
+    }
+
+    // PNG rows run top to bottom, OpenGL expects the bottom row first.
+    const size_t rowBytes = size_t(width) * 4;
+    for (unsigned row = 0; row < height / 2; ++row) {
+        std::swap_ranges(pixels.begin() + row * rowBytes,
+                         pixels.begin() + (row + 1) * rowBytes,
+                         pixels.begin() + (height - 1 - row) * rowBytes);
+    }
+
+    try {
+        CookedTexture::write(argv[2], width, height, pixels.data(), compress);
+
+        cout << argv[1] << ": " << width << "x" << height << ", " << pixels.size()
+             << " bytes" << (compress ? " compressed" : "") << endl;
+
+    } catch (const std::exception & e) {
+        cerr << "Exception Thrown: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}